@@ -223,6 +223,8 @@ static int full_config_vga_plb(igd_context_t *context,
 		PLB_MMIO_SIZE/1024,
 		context->device_context.mmadr,
 		context->device_context.virt_mmadr);
+	EMGD_MMIO_REGION(EMGD_MMIO_REGION_D2, context->device_context.virt_mmadr,
+		PLB_MMIO_SIZE);
 
 	/* PCI Interrupt Line */
 	if(OS_PCI_READ_CONFIG_8(platform_context->pcidev0,
@@ -217,6 +217,8 @@ static int full_config_vga_tnc(igd_context_t *context,
 		TNC_D2_MMIO_SIZE/1024,
 		context->device_context.mmadr,
 		context->device_context.virt_mmadr);
+	EMGD_MMIO_REGION(EMGD_MMIO_REGION_D2, context->device_context.virt_mmadr,
+		TNC_D2_MMIO_SIZE);
 
 
 	/*
@@ -244,6 +246,8 @@ static int full_config_vga_tnc(igd_context_t *context,
 		TNC_D3_MMIO_SIZE/1024,
 		context->device_context.mmadr_sdvo,
 		context->device_context.virt_mmadr_sdvo);
+	EMGD_MMIO_REGION(EMGD_MMIO_REGION_D3,
+		context->device_context.virt_mmadr_sdvo, TNC_D3_MMIO_SIZE);
 
 	/* Map the STMicro SDVO registers. */
 	if(platform_context->stbridgedev) {
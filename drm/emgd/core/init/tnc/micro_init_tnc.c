@@ -52,6 +52,8 @@
 #include <tnc/regs.h>
 #include <tnc/context.h>
 #include <linux/pci_ids.h>
+#include <emgd_vtnc.h>
+#include <gtt_shadow.h>
 
 #include "../cmn/init_dispatch.h"
 
@@ -200,7 +202,21 @@ static unsigned short tnc_core_freq_list[SKU_NO] =
  */
 static void gtt_shutdown_tnc(igd_context_t *context)
 {
-	if (context->device_context.virt_gttadr) {
+	unsigned long i;
+
+	if (context->device_context.gtt_alloc_pages) {
+		/* The table was allocated by gtt_init_tnc(), not mapped */
+		for (i = 0; i < context->device_context.gtt_alloc_pages; i++) {
+			clear_bit(PG_reserved, &virt_to_page(
+				(char *)context->device_context.virt_gttadr +
+				(PAGE_SIZE * i))->flags);
+		}
+		free_pages((unsigned long)context->device_context.virt_gttadr,
+			get_order(context->device_context.gtt_alloc_pages << PAGE_SHIFT));
+
+		context->device_context.gtt_alloc_pages = 0;
+		context->device_context.virt_gttadr = NULL;
+	} else if (context->device_context.virt_gttadr) {
 		iounmap(context->device_context.virt_gttadr);
 
 		context->device_context.virt_gttadr = NULL;
@@ -209,6 +225,8 @@ static void gtt_shutdown_tnc(igd_context_t *context)
 		__free_page(context->device_context.scratch_page);
 		context->device_context.scratch_page = NULL;
 	}
+	emgd_gtt_shadow_free(context->device_context.gtt_shadow);
+	context->device_context.gtt_shadow = NULL;
 }
 
 
@@ -239,14 +257,23 @@ static void gtt_init_tnc(igd_context_t *context)
 	unsigned long stolen_mem_base;
 	unsigned long *gtt_table;
 	struct page *gtt_table_page;
+	os_pci_dev_t gmch_dev;
+	unsigned long gtt_len;
 	int i;
 
 	dev = (struct drm_device *)context->drm_dev;
+	gmch_dev = (os_pci_dev_t)dev->pdev;
+#ifdef EMGD_VIRTUAL_TNC
+	/* The bound pci_dev is only a stand-in for the virtual 0:2:0 */
+	if (emgd_vtnc) {
+		gmch_dev = ((platform_context_tnc_t *)
+			context->platform_context)->pcidev0;
+	}
+#endif
 
 	/* Enable the GMCH */
-	OS_PCI_READ_CONFIG_16((os_pci_dev_t)dev->pdev, PSB_GMCH_CTRL,
-			&gmch_ctl);
-	OS_PCI_WRITE_CONFIG_16((os_pci_dev_t)dev->pdev, PSB_GMCH_CTRL,
+	OS_PCI_READ_CONFIG_16(gmch_dev, PSB_GMCH_CTRL, &gmch_ctl);
+	OS_PCI_WRITE_CONFIG_16(gmch_dev, PSB_GMCH_CTRL,
 			(gmch_ctl | PSB_GMCH_ENABLED));
 	context->device_context.gmch_ctl = gmch_ctl;
 
@@ -268,15 +295,37 @@ static void gtt_init_tnc(igd_context_t *context)
 	*/
 	gatt_start = pci_resource_start(dev->pdev, PSB_GATT_RESOURCE);
 	gatt_pages = (pci_resource_len(dev->pdev, PSB_GATT_RESOURCE) >> PAGE_SHIFT);
+	gtt_len = pci_resource_len(dev->pdev, PSB_GTT_RESOURCE);
+#ifdef EMGD_VIRTUAL_TNC
+	if (emgd_vtnc) {
+		emgd_vtnc_resource(EMGD_VTNC_GATT_RESOURCE, &gatt_start, &gatt_pages);
+		gatt_pages >>= PAGE_SHIFT;
+		emgd_vtnc_resource(EMGD_VTNC_GTT_RESOURCE, &gtt_start, &gtt_len);
+	}
+#endif
 	context->device_context.gatt_pages = gatt_pages;
 
+	/*
+	 * Shadow the GTT so suspend doesn't have to read it back.  Without
+	 * the shadow the register save code falls back to reading the table.
+	 */
+	if (!context->device_context.gtt_shadow &&
+		context->device_context.scratch_page) {
+		context->device_context.gtt_shadow = emgd_gtt_shadow_alloc(gatt_pages,
+			page_to_phys((struct page *)context->device_context.scratch_page) |
+			PSB_PTE_VALID);
+		if (!context->device_context.gtt_shadow) {
+			EMGD_ERROR("Failed to allocate the GTT shadow");
+		}
+	}
+
 	/*
 	 * The GTT wasn't set up by the vBios
 	 */
 	if (!pge_ctl) {
 		context->device_context.stolen_pages = 0;
 
-		gtt_pages = pci_resource_len(dev->pdev, PSB_GTT_RESOURCE) >> PAGE_SHIFT;
+		gtt_pages = gtt_len >> PAGE_SHIFT;
 		gtt_order = get_order(gtt_pages << PAGE_SHIFT);
 		gtt_table = (unsigned long *)__get_free_pages(GFP_KERNEL, gtt_order);
 		/* Make sure allocation was successful */
@@ -285,9 +334,10 @@ static void gtt_init_tnc(igd_context_t *context)
 			return;
 		}
 		context->device_context.virt_gttadr = gtt_table;
+		context->device_context.gtt_alloc_pages = 1 << gtt_order;
 
 		for (i=0; i < (1 << gtt_order); i++) {
-			gtt_table_page = virt_to_page(gtt_table + (PAGE_SIZE * i));
+			gtt_table_page = virt_to_page((char *)gtt_table + (PAGE_SIZE * i));
 			EMGD_DEBUG("Setting reserved bit on %p", gtt_table_page);
 			set_bit(PG_reserved, &gtt_table_page->flags);
 		}
@@ -367,6 +417,9 @@ static void gtt_init_tnc(igd_context_t *context)
 		for (i = 0; i < context->device_context.stolen_pages; i++) {
 			pte = ((base + i) << PAGE_SHIFT) | PSB_PTE_VALID;
 			writel(pte, context->device_context.virt_gttadr + i);
+			if (context->device_context.gtt_shadow) {
+				emgd_gtt_shadow_set(context->device_context.gtt_shadow, i, pte);
+			}
 		}
 
 	}
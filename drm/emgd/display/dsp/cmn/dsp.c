@@ -350,8 +350,13 @@ static igd_display_port_t *dsp_get_next_port(igd_context_t *context,
 {
 	/*EMGD_DEBUG("Entry, dsp_get_next_port");*/
 
-	return (igd_display_port_t *)dsp_get_next(
-		(void **)dsp_context.dispatch->ports, (void *)last, reverse);
+	/* Ports still being probed at load are not there yet */
+	do {
+		last = (igd_display_port_t *)dsp_get_next(
+			(void **)dsp_context.dispatch->ports, (void *)last, reverse);
+	} while (last && last->probing);
+
+	return last;
 }
 
 static igd_plane_t *dsp_get_next_plane(igd_context_t *context,
@@ -1415,6 +1420,9 @@ void free_plane(igd_context_t *context, igd_plane_t *plane)
 			context->dispatch.gmm_free(ci->xor_offset);
 			EMGD_DEBUG("Freeing cursor image @ 0x%08lx", ci->argb_offset);
 			context->dispatch.gmm_free(ci->argb_offset);
+			if (CURSOR_PRIV(ci)->argb_back_offset) {
+				context->dispatch.gmm_free(CURSOR_PRIV(ci)->argb_back_offset);
+			}
 			/* Free plane info */
 			OS_FREE(plane->plane_info);
 			plane->plane_info = NULL;
@@ -1605,7 +1613,7 @@ int dsp_alloc(igd_context_t *context,
 			pipe->cursor = cursor;
 			cursor->inuse = 1;
 			if (cursor->cursor_info == NULL) {
-				cursor->cursor_info = OS_ALLOC(sizeof(igd_cursor_info_t));
+				cursor->cursor_info = OS_ALLOC(sizeof(igd_cursor_priv_t));
 				if(!cursor->cursor_info) {
 					EMGD_ERROR("Error, memory allocation for cursor_info "
 							"failed.");
@@ -1762,7 +1770,7 @@ int dsp_alloc(igd_context_t *context,
 					cursor2->inuse = 1;
 					if (cursor2->cursor_info == NULL) {
 						cursor2->cursor_info =
-							OS_ALLOC(sizeof(igd_cursor_info_t));
+							OS_ALLOC(sizeof(igd_cursor_priv_t));
 						if(!cursor2->cursor_info) {
 							EMGD_ERROR("Error, memory allocation for cursor_info "
 									"failed.");
@@ -2121,7 +2129,7 @@ static int dsp_init_cursor(igd_context_t *context, igd_cursor_t *cursor)
 		tmp++;
 	}
 
-	OS_MEMSET(cursor->cursor_info, 0, sizeof(igd_cursor_info_t));
+	OS_MEMSET(cursor->cursor_info, 0, sizeof(igd_cursor_priv_t));
 
 	if (has_rgb32) {
 		/* ARGB32 is used for any 32bit format. */
@@ -2150,6 +2158,27 @@ printk(KERN_ALERT "[EGD]     dsp_init_cursor(): Virtual to Physical Address "
 		EMGD_DEBUG("Allocating cursor surface @ 0x%08lx", buffer);
 		cursor->cursor_info->argb_offset = buffer;
 		cursor->cursor_info->argb_pitch = pitch;
+
+		/*
+		 * A second ARGB image lets alter_cursor() load new images off
+		 * screen and switch to them at the next vblank.  Without it the
+		 * visible image is rewritten in place.
+		 */
+		flags = IGD_SURFACE_CURSOR;
+		GMM_SET_DEBUG_NAME("ARGB Cursor (back)");
+		ret = context->dispatch.gmm_alloc_surface(&buffer,
+				IGD_PF_ARGB32,
+				&width, &height, &pitch, &size,
+				IGD_GMM_ALLOC_TYPE_NORMAL, &flags);
+		if (ret) {
+			EMGD_DEBUG("No memory for a second ARGB cursor image");
+		} else if (context->dispatch.gmm_virt_to_phys(buffer, &buffer_phys) ||
+			!(cursor_mem = phys_to_virt(buffer_phys))) {
+			context->dispatch.gmm_free(buffer);
+		} else {
+			OS_MEMSET(cursor_mem, 0, size);
+			CURSOR_PRIV(cursor->cursor_info)->argb_back_offset = buffer;
+		}
 	}
 	flags = IGD_SURFACE_CURSOR;
 
@@ -2162,6 +2191,11 @@ printk(KERN_ALERT "[EGD]     dsp_init_cursor(): Virtual to Physical Address "
 		if(has_rgb32) {
 			context->dispatch.gmm_free(cursor->cursor_info->argb_offset);
 			cursor->cursor_info->argb_offset = 0;
+			if (CURSOR_PRIV(cursor->cursor_info)->argb_back_offset) {
+				context->dispatch.gmm_free(
+					CURSOR_PRIV(cursor->cursor_info)->argb_back_offset);
+				CURSOR_PRIV(cursor->cursor_info)->argb_back_offset = 0;
+			}
 		}
 		EMGD_ERROR("ERROR: No memory for XOR cursor!");
 		return -IGD_ERROR_NOMEM;
@@ -0,0 +1,262 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: cursor.c
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Cursor image loading for igd_alter_cursor().  Each of the 8 rotate/flip
+ *  combinations maps a source row onto a destination row, a reversed row
+ *  or a column of the 64x64 cursor, so images are copied a row at a time
+ *  instead of transforming every pixel's coordinates.
+ *-----------------------------------------------------------------------------
+ */
+
+#define MODULE_NAME hal.mode
+
+#include <memory.h>
+
+#include "cursor.h"
+
+/*
+ * Where source pixel (x, y) lands in the 64x64 cursor, as the index
+ * origin + x * x_step + y * y_step.  These are the igd_fb_to_screen()
+ * mappings for a 64x64 front buffer, indexed by [rotation / 90][flip].
+ */
+typedef struct _cursor_xform {
+	short origin;
+	short x_step;
+	short y_step;
+} cursor_xform_t;
+
+static const cursor_xform_t cursor_xform[4][2] = {
+	{ {    0,   1,  64 }, {   63,  -1,  64 } },	/* 0 */
+	{ { 4032, -64,   1 }, {    0,  64,   1 } },	/* 90 */
+	{ { 4095,  -1, -64 }, { 4032,   1, -64 } },	/* 180 */
+	{ {   63,  64,  -1 }, { 4095, -64,  -1 } },	/* 270 */
+};
+
+static const cursor_xform_t *get_xform(int rotate, int flip)
+{
+	/* igd_fb_to_screen() treats anything else as no rotation */
+	switch (rotate) {
+	case 90:
+	case 180:
+	case 270:
+		return &cursor_xform[rotate / 90][flip ? 1 : 0];
+	default:
+		return &cursor_xform[0][flip ? 1 : 0];
+	}
+}
+
+/* 64-bit FNV-1a, seeded with everything that changes the loaded image */
+#define CURSOR_HASH_BASIS	0xcbf29ce484222325ULL
+#define CURSOR_HASH_PRIME	0x100000001b3ULL
+
+static unsigned long long hash_seed(int rotate, int flip, int width,
+	int height)
+{
+	unsigned long long h = CURSOR_HASH_BASIS;
+
+	h = (h ^ (unsigned int)(get_xform(rotate, flip) - &cursor_xform[0][0])) *
+		CURSOR_HASH_PRIME;
+	h = (h ^ (unsigned int)width) * CURSOR_HASH_PRIME;
+	h = (h ^ (unsigned int)height) * CURSOR_HASH_PRIME;
+	return h;
+}
+
+/*!
+ * Hashes the part of an ARGB image cursor_load_argb() reads.  0 is never
+ * returned so callers can use it for "unknown".
+ *
+ * @param image width x height 32bpp source image
+ * @param rotate 0, 90, 180 or 270
+ * @param flip
+ * @param width
+ * @param height
+ *
+ * @return hash of the image as it would be loaded
+ */
+unsigned long long cursor_argb_hash(unsigned int *image,
+	int rotate, int flip, int width, int height)
+{
+	unsigned long long h0 = hash_seed(rotate, flip, width, height);
+	unsigned long long h1 = CURSOR_HASH_BASIS;
+	int w = (width > 64) ? 64 : width;
+	int h = (height > 64) ? 64 : height;
+	int x, y;
+
+	/*
+	 * Two pixels per step into two independent lanes; a single FNV
+	 * chain is bound by multiply latency.
+	 */
+	for (y = 0; y < h; y++) {
+		for (x = 0; x + 4 <= w; x += 4) {
+			h0 = (h0 ^ (image[x] |
+				(unsigned long long)image[x + 1] << 32)) * CURSOR_HASH_PRIME;
+			h1 = (h1 ^ (image[x + 2] |
+				(unsigned long long)image[x + 3] << 32)) * CURSOR_HASH_PRIME;
+		}
+		for (; x < w; x++) {
+			h0 = (h0 ^ image[x]) * CURSOR_HASH_PRIME;
+		}
+		image += width;
+	}
+
+	h0 = (h0 ^ h1) * CURSOR_HASH_PRIME;
+	return h0 ? h0 : 1;
+}
+
+/*!
+ * Hashes a 2bpp AND/XOR cursor image.  0 is never returned.
+ *
+ * @param image 64 lines of 16 bytes
+ * @param rotate 0, 90, 180 or 270
+ * @param flip
+ *
+ * @return hash of the image as it would be loaded
+ */
+unsigned long long cursor_xor_hash(unsigned char *image,
+	int rotate, int flip)
+{
+	unsigned long long h = hash_seed(rotate, flip, 64, 64);
+	unsigned int word;
+	int i;
+
+	for (i = 0; i < CURSOR_XOR_SIZE; i += 4) {
+		OS_MEMCPY(&word, image + i, 4);
+		h = (h ^ word) * CURSOR_HASH_PRIME;
+	}
+
+	return h ? h : 1;
+}
+
+/*!
+ * Loads an ARGB image into a 64x64 ARGB cursor, rotated and flipped.
+ * Images larger than 64x64 are clipped; the rest of a smaller image's
+ * cursor is cleared.
+ *
+ * @param cursor 64x64 32bpp cursor memory
+ * @param image width x height 32bpp source image
+ * @param rotate 0, 90, 180 or 270
+ * @param flip
+ * @param width
+ * @param height
+ *
+ * @return void
+ */
+void cursor_load_argb(unsigned int *cursor, unsigned int *image,
+	int rotate, int flip, int width, int height)
+{
+	const cursor_xform_t *xf = get_xform(rotate, flip);
+	int w = (width > 64) ? 64 : width;
+	int h = (height > 64) ? 64 : height;
+	unsigned int *dst;
+	int x, y;
+
+	if (w < 64 || h < 64) {
+		OS_MEMSET(cursor, 0, CURSOR_ARGB_SIZE);
+	}
+
+	for (y = 0; y < h; y++) {
+		dst = cursor + xf->origin + y * xf->y_step;
+		switch (xf->x_step) {
+		case 1:
+			OS_MEMCPY(dst, image, w * 4);
+			break;
+		case -1:
+			for (x = 0; x < w; x++) {
+				dst[-x] = image[x];
+			}
+			break;
+		default:
+			for (x = 0; x < w; x++) {
+				*dst = image[x];
+				dst += xf->x_step;
+			}
+			break;
+		}
+		image += width;
+	}
+}
+
+/* Reverses the bit order of a byte */
+static unsigned char bit_reverse(unsigned char b)
+{
+	b = (unsigned char)((b & 0xf0) >> 4 | (b & 0x0f) << 4);
+	b = (unsigned char)((b & 0xcc) >> 2 | (b & 0x33) << 2);
+	b = (unsigned char)((b & 0xaa) >> 1 | (b & 0x55) << 1);
+	return b;
+}
+
+/*!
+ * Loads a 2bpp image into the cursor, rotated and flipped.  Each line is
+ * 16 bytes: 64 pixels of the AND plane, MSB first, then 64 of the XOR
+ * plane.
+ *
+ * @param cursor 64 lines of 16 bytes of cursor memory
+ * @param image 64 lines of 16 bytes
+ * @param rotate 0, 90, 180 or 270
+ * @param flip
+ *
+ * @return void
+ */
+void cursor_load_xor(unsigned char *cursor, unsigned char *image,
+	int rotate, int flip)
+{
+	const cursor_xform_t *xf = get_xform(rotate, flip);
+	unsigned char *src, *dst;
+	int d, j, x, y;
+
+	if (xf->x_step != 1 && xf->x_step != -1) {
+		/* Rows become columns: every bit moves on its own */
+		OS_MEMSET(cursor, 0, CURSOR_XOR_SIZE);
+	}
+
+	for (y = 0; y < 64; y++) {
+		d = xf->origin + y * xf->y_step;
+		for (j = 0; j < 2; j++) {
+			src = image + 16 * y + 8 * j;
+			switch (xf->x_step) {
+			case 1:
+				OS_MEMCPY(cursor + 16 * (d >> 6) + 8 * j, src, 8);
+				break;
+			case -1:
+				dst = cursor + 16 * (d >> 6) + 8 * j;
+				for (x = 0; x < 8; x++) {
+					dst[7 - x] = bit_reverse(src[x]);
+				}
+				break;
+			default:
+				for (x = 0; x < 64; x++) {
+					if (src[x >> 3] & (0x80 >> (x & 7))) {
+						int n = d + x * xf->x_step;
+						cursor[16 * (n >> 6) + 8 * j + ((n & 63) >> 3)] |=
+							(unsigned char)(0x80 >> (n & 7));
+					}
+				}
+				break;
+			}
+		}
+	}
+}
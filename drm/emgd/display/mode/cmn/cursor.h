@@ -0,0 +1,53 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: cursor.h
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Cursor image loading: the rotate/flip transforms from the image an IAL
+ *  hands to alter_cursor() to the 64x64 layout the cursor plane scans out,
+ *  and the content hash used to skip loading an image that is already
+ *  there.
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef _CURSOR_H
+#define _CURSOR_H
+
+#define CURSOR_ARGB_SIZE	(64 * 64 * 4)
+#define CURSOR_XOR_SIZE		(64 * 16)
+
+unsigned long long cursor_argb_hash(unsigned int *image,
+	int rotate, int flip, int width, int height);
+
+unsigned long long cursor_xor_hash(unsigned char *image,
+	int rotate, int flip);
+
+void cursor_load_argb(unsigned int *cursor, unsigned int *image,
+	int rotate, int flip, int width, int height);
+
+void cursor_load_xor(unsigned char *cursor, unsigned char *image,
+	int rotate, int flip);
+
+#endif
@@ -64,6 +64,7 @@
 #include "emgd_drv.h"
 #include "drm_emgd_private.h"
 #include "match.h"
+#include "cursor.h"
 #include "mode_dispatch.h"
 
 #include "ovl_dispatch.h"
@@ -391,104 +392,28 @@ int mode_restore(igd_context_t *context, module_state_h *state,
 } /* end mode_restore() */
 
 /*!
+ * Returns the kernel virtual address of a cursor image.
  *
- * @param cursor
- * @param image
- * @param rotate
- * @param flip
- * @param width
- * @param height
+ * @param display
+ * @param offset GMM offset of the image
  *
- * @return void
+ * @return NULL on failure
  */
-static void load_argb_cursor_image(unsigned long *cursor,
-		unsigned long *image,
-		int rotate, int flip,
-		int width, int height)
+static void *cursor_image_virt(igd_display_context_t *display,
+	unsigned long offset)
 {
-	int w, h, x, y;
-	unsigned short nx, ny;
-	unsigned long *i;
-
-	w = width;
-	h = height;
-
-	/* make sure size is constrained to 64x64 */
-	if (w > 64) {
-		w = 64;
-	}
-	if (h > 64) {
-		h = 64;
-	}
-
-	/* Copy image */
-	for (y = 0; y < h; y++) {
-		i = image;
-		image += width;
-		for (x = 0; x < w; x++) {
-			/* rotate, flip  x,y here. No scaling!  */
-			nx = (unsigned short) x;
-			ny = (unsigned short) y;
-			igd_fb_to_screen((unsigned short) rotate, (unsigned char) flip,
-				0, 0, 0, 64, 64, &nx, &ny, 0, 0);
-			cursor[nx + (64 * ny)] = *i++;
-		}
-	}
-}
+	unsigned long buffer_phys = 0;
 
-/*!
- *
- * @param cursor
- * @param image
- * @param rotate
- * @param flip
- * @param width
- * @param height
- *
- * @return void
- */
-static void load_xor_cursor_image(unsigned char *cursor,
-		unsigned char *image,
-		int rotate, int flip,
-		int width, int height)
-{
-	int j, x, y;
-	int pixel_num, byte_num, line_num;
-	int npixel_num, nbyte_num, nline_num, nbit_num;
-	unsigned short nx, ny;
-	unsigned char b_val, sbit, mask, pixel;
-
-	for (j = 0; j < 2; j++) {
-		cursor += (j * 8);
-		image += (j * 8);
-		for (y = 0; y < 64; y++) {
-			for (x = 0; x < 64; x++) {
-				pixel_num = x + (y * 64);
-				line_num = pixel_num / 64;
-				byte_num = (pixel_num & 63) / 8;
-				b_val = *(image + (16 * line_num) + byte_num);
-				pixel = (b_val >> ( 7 - (pixel_num & 7))) & 0x01;
-
-				nx = (unsigned short) x;
-				ny = (unsigned short) y;
-				igd_fb_to_screen((unsigned short) rotate, (unsigned char) flip,
-					0, 0, 0, (unsigned short) width, (unsigned short) height,
-					&nx, &ny, 0 , 0);
-				npixel_num = nx + (ny * 64);
-				nline_num = npixel_num / 64;
-				nbyte_num = (npixel_num & 63) / 8;
-				nbit_num = 7 - (npixel_num & 7);
-				b_val = *(cursor + (16 * nline_num) + nbyte_num);
-
-				sbit = pixel << nbit_num;
-				mask = 0x01 << nbit_num;
-				b_val = (b_val & ~mask) | sbit;
-				*(cursor + (16 * nline_num) + nbyte_num) = b_val;
-
-				/*(cursor + (16 * line_num) + byte_num) = b_val; */
-			}
-		}
+	if (display->context->dispatch.gmm_virt_to_phys(offset, &buffer_phys)) {
+		EMGD_ERROR("GMM Virtual to Physical Address translation failed");
+		return NULL;
 	}
+
+	/*
+	 * TODO: Verify that phys_to_virt returns a valid address for
+	 * agp memory
+	 */
+	return phys_to_virt(buffer_phys);
 }
 
 /*!
@@ -652,10 +577,14 @@ int igd_alter_cursor(igd_display_h display_handle,
 	igd_display_context_t *display2;
 	igd_display_context_t *primary;
 	igd_cursor_info_t *internal_ci;
+	igd_cursor_priv_t *priv;
 	unsigned short rotation, flip;
 	unsigned long cursor_state;
 	unsigned long cursor_state2;
-	unsigned long *cursora = NULL;
+	unsigned long long hash;
+	unsigned long offset;
+	int back;
+	unsigned int *cursora = NULL;
 	unsigned char *cursorx = NULL;
 //	unsigned long in_dihclone=0;
 
@@ -671,9 +600,7 @@ int igd_alter_cursor(igd_display_h display_handle,
 	}
 
 	internal_ci = PIPE(display)->cursor->cursor_info;
-
-	cursor_info->argb_offset = internal_ci->argb_offset;
-	cursor_info->xor_offset = internal_ci->xor_offset;
+	priv = CURSOR_PRIV(internal_ci);
 
 	rotation = (unsigned short) ((cursor_info->rotation &
 		IGD_RENDER_OP_ROT_MASK) >> 8) * 90;
@@ -694,65 +621,80 @@ int igd_alter_cursor(igd_display_h display_handle,
 
 	/*
 	 * Loading new cursor (for both primary and clone):
-	 * 1. Blank cursor image: This can be avoided if new hotspot and
-	 *    new bitmap size are same as existing hotspot and image size.
-	 * 2. Move cursor to new location accounting for new hotspot
-	 * 3. Wait for vblank to load the new cursor to avoid flashing/tearing.
-	 *    This impacts performace tests as cursor shape changes several times
-	 *    while running/loading tests and this wait for vblank counts against
-	 *    test times. So going without a wait for vblank. If flashing/tearing
-	 *    becomes a must fix issue, then uncomment below wait_vblank().
-	 * 4. Load new image
+	 * 1. Skip the load if the image, rotation and flip are the ones
+	 *    already loaded.  The DRM cursor_set() passes the whole image on
+	 *    every call.
+	 * 2. Load ARGB images into the back image, which program_cursor()
+	 *    makes visible at the next vblank.  Until the previous base write
+	 *    has latched, the back image may still be the one scanned out;
+	 *    the front image is not shown yet then, so load it in place.
+	 *    Without a back image, and for 2bpp images, the visible image is
+	 *    rewritten in place.
+	 * 3. Move cursor to new location accounting for new hotspot
 	 */
-
 	if ((image != NULL) && (cursor_info->flags & IGD_CURSOR_LOAD_ARGB_IMAGE)) {
-		unsigned long buffer_phys = 0;
+		hash = cursor_argb_hash((unsigned int *)image, rotation, flip,
+			cursor_info->width, cursor_info->height);
 
-		/* Calculate the cursor's address in kernel-space: */
-		if (display->context->dispatch.gmm_virt_to_phys(internal_ci->argb_offset,
-				&buffer_phys)) {
-			EMGD_ERROR_EXIT("GMM Virtual to Physical Address translation failed");
-			return -IGD_ERROR_INVAL;
+		if (!mode_context->dispatch->full->cursor_latched ||
+			mode_context->dispatch->full->cursor_latched(display)) {
+			priv->argb_shown_offset = internal_ci->argb_offset;
 		}
+		back = priv->argb_back_offset &&
+			priv->argb_back_offset != priv->argb_shown_offset;
+
+		if (hash != priv->argb_hash && hash != priv->argb_back_hash) {
+			offset = back ? priv->argb_back_offset : internal_ci->argb_offset;
+			cursora = cursor_image_virt(display, offset);
+			EMGD_DEBUG("ARGB cursor virtual address is 0x%p", cursora);
+			if (cursora == NULL) {
+				EMGD_ERROR_EXIT("Physical to Virtual Address translation failed");
+				return -IGD_ERROR_INVAL;
+			}
 
-		/*
-		 * TODO: Verify that phys_to_virt returns a valid address for
-		 * agp memory
-		 */
-		cursora = phys_to_virt(buffer_phys);
-		EMGD_DEBUG("ARGB cursor virtual address is 0x%p", cursora);
-		if (cursora == NULL) {
-			EMGD_ERROR_EXIT("Physical to Virtual Address translation failed");
-			return -IGD_ERROR_INVAL;
+			cursor_load_argb(cursora, (unsigned int *)image, rotation, flip,
+				cursor_info->width, cursor_info->height);
+			if (back) {
+				priv->argb_back_hash = hash;
+			} else {
+				priv->argb_hash = hash;
+			}
 		}
 
-		/* Clear cursor plane */
-		OS_MEMSET(cursora, 0, 64*64*4);
+		if (hash == priv->argb_back_hash) {
+			offset = internal_ci->argb_offset;
+			internal_ci->argb_offset = priv->argb_back_offset;
+			priv->argb_back_offset = offset;
+			priv->argb_back_hash = priv->argb_hash;
+			priv->argb_hash = hash;
+		}
 
 	} else if ((image != NULL) &&
 		(cursor_info->flags & IGD_CURSOR_LOAD_XOR_IMAGE)) {
+		hash = cursor_xor_hash(image, rotation, flip);
 
-		unsigned long buffer_phys = 0;
+		if (hash != priv->xor_hash) {
+			cursorx = cursor_image_virt(display, internal_ci->xor_offset);
+			EMGD_DEBUG("XOR cursor virtual address is 0x%p", cursorx);
+			if (cursorx == NULL) {
+				EMGD_ERROR_EXIT("Physical to Virtual Address translation failed");
+				return -IGD_ERROR_INVAL;
+			}
 
-		/* Calculate the cursor's address in kernel-space: */
-		if (display->context->dispatch.gmm_virt_to_phys(internal_ci->xor_offset,
-				&buffer_phys)) {
-			EMGD_ERROR_EXIT("GMM Virtual to Physical Address translation failed");
-			return -IGD_ERROR_INVAL;
+			cursor_load_xor(cursorx, image, rotation, flip);
+			priv->xor_hash = hash;
 		}
 
-		/*
-		 * TODO: Verify that phys_to_virt returns a valid address for
-		 * agp memory
-		 */
-		cursorx = phys_to_virt(buffer_phys);
-		EMGD_DEBUG("XOR cursor virtual address is 0x%p", cursorx);
-		if (cursorx == NULL) {
-			EMGD_ERROR_EXIT("Physical to Virtual Address translation failed");
-			return -IGD_ERROR_INVAL;
-		}
+	} else {
+		/* The caller may have drawn into the cursor memory itself */
+		priv->argb_hash = 0;
+		priv->argb_back_hash = 0;
+		priv->xor_hash = 0;
 	}
 
+	cursor_info->argb_offset = internal_ci->argb_offset;
+	cursor_info->xor_offset = internal_ci->xor_offset;
+
 	/* calculate the cursor position adjusting to new hotspot */
 	igd_set_cursor_pos(display,
 		(unsigned short)cursor_info->x_offset,
@@ -806,20 +748,6 @@ int igd_alter_cursor(igd_display_h display_handle,
 	cursor_info->xor_pitch = internal_ci->xor_pitch;
 	cursor_info->argb_pitch = internal_ci->argb_pitch;
 
-	/* wait for VBLANK */
-	/* mode_context->dispatch->wait_vblank(display); */
-
-	if ((image != NULL) &&
-			(cursor_info->flags & IGD_CURSOR_LOAD_ARGB_IMAGE)) {
-		load_argb_cursor_image(cursora, (unsigned long *)image, rotation, flip,
-				cursor_info->width, cursor_info->height);
-
-	} else if ((image != NULL) &&
-			(cursor_info->flags & IGD_CURSOR_LOAD_XOR_IMAGE)) {
-		load_xor_cursor_image(cursorx, image, rotation, flip,
-				cursor_info->width, cursor_info->height);
-	}
-
 	EMGD_TRACE_EXIT;
 	return 0;
 }
@@ -1136,9 +1064,11 @@ int igd_get_attrs(
 
 	/* Get PD attributes */
 	pd_attr_num = *num_attrs;
+	port->pd_i2c_flags = IGD_I2C_CAN_SLEEP;
 	ret = port->pd_driver->get_attrs( port->pd_context,
 									&pd_attr_num,
 									&pd_attr_list );
+	port->pd_i2c_flags = 0;
 
 	if (ret) {
 		pd_attr_num  = 0;
@@ -1244,7 +1174,9 @@ int igd_set_attrs(
 	/* Pass the attribute list down to the port driver for futher processing
 	 * if necessary */
 	if (num_attrs > num_attrs_set) {
+		port->pd_i2c_flags = IGD_I2C_CAN_SLEEP;
 		ret = port->pd_driver->set_attrs(port->pd_context, num_attrs, attr_list);
+		port->pd_i2c_flags = 0;
 
 		if (ret) {
 			return -IGD_INVAL;
@@ -1277,6 +1209,7 @@ int igd_set_attrs(
 		port->num_timing = get_native_dtd(pd_timing_table,
 				PI_SUPPORTED_TIMINGS, &port->fp_native_dtd,
 				PD_MODE_DTD_FP_NATIVE);
+		pi_index_timings(port);
 		ret = IGD_DO_QRY_SETMODE;
 	}
 
@@ -1436,7 +1369,7 @@ int igd_access_i2c(
 				i2c_reg->i2c_speed,
 				i2c_reg->dab,
 				temp_reg,
-				0);
+				IGD_I2C_CAN_SLEEP);
 			if (ret) {
 				EMGD_DEBUG("i2c write error.");
 				break;
@@ -1452,7 +1385,7 @@ int igd_access_i2c(
 			i2c_reg->reg,
 			i2c_reg->buffer,
 			i2c_reg->num_bytes,
-			0);
+			IGD_I2C_CAN_SLEEP);
 		if (ret) {
 			EMGD_DEBUG("i2c read error.");
 		}
@@ -1508,7 +1441,7 @@ static int igd_get_EDID_info(igd_driver_h driver_handle,
 		0x00,             /* DDC Address */
 		temp_buf,         /* Read 20 bytes into temp_buf */
 		20,
-		0);
+		IGD_I2C_CAN_SLEEP);
 	if (ret) {
 		return -IGD_ERROR_EDID;
 	}
@@ -1529,7 +1462,7 @@ static int igd_get_EDID_info(igd_driver_h driver_handle,
 			0x7E,             /* DDC Address */
 			&temp_buf[0],     /* Read 1 byte into temp_buf */
 			1,
-			0);
+			IGD_I2C_CAN_SLEEP);
 		if (ret) {
 			return -IGD_ERROR_EDID;
 		}
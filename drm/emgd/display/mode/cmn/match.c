@@ -215,6 +215,17 @@ igd_timing_info_t *kms_match_resolution(
 		}
 	}
 
+#ifndef CONFIG_MICRO
+	/* Exact matches in the port's own table come from its sorted index */
+	if((type == MATCH_EXACT) && !(pt_info->flags & IGD_MODE_VESA) &&
+		port->timing_index && (timing_table == port->index_table)) {
+		match = pi_find_timing(port, pt_info->width, pt_info->height,
+			pt_info->refresh, pt_info->flags);
+		EMGD_DEBUG("Returning with %s indexed match", match ? "an" : "no");
+		return match;
+	}
+#endif
+
 	while (timing->width != IGD_TIMING_TABLE_END) {
 		if(!(timing->mode_info_flags & IGD_MODE_SUPPORTED)) {
 			timing++;
@@ -812,6 +823,17 @@ static igd_timing_info_t *match_resolution(
 		}
 	}
 
+#ifndef CONFIG_MICRO
+	/* Exact matches in the port's own table come from its sorted index */
+	if((type == MATCH_EXACT) && !(pt_info->flags & IGD_MODE_VESA) &&
+		port->timing_index && (timing_table == port->index_table)) {
+		match = pi_find_timing(port, pt_info->width, pt_info->height,
+			pt_info->refresh, pt_info->flags);
+		EMGD_DEBUG("Returning with %s indexed match", match ? "an" : "no");
+		return match;
+	}
+#endif
+
 	while (timing->width != IGD_TIMING_TABLE_END) {
 		if(!(timing->mode_info_flags & IGD_MODE_SUPPORTED)) {
 			timing++;
@@ -1539,7 +1539,7 @@ static int igd_get_EDID_block(igd_driver_h driver_handle,
 		128*block_number,
 		edid_ptr,
 		128,
-		0);
+		IGD_I2C_CAN_SLEEP);
 
 	if (ret) {
 		EMGD_TRACE_EXIT;
@@ -50,6 +50,8 @@ typedef struct _mode_kms_dispatch {
 	u32  (*kms_get_vblank_counter)(emgd_crtc_t *emgd_crtc);
 	int (*kms_match_mode)(emgd_encoder_t *emgd_encoder,
 		igd_framebuffer_info_t *fb_info, igd_timing_info_t **timing);
+	int  (*kms_flip_plane)(emgd_crtc_t *emgd_crtc,
+		igd_framebuffer_info_t *fb_info);
 } mode_kms_dispatch_t;
 
 
@@ -142,6 +144,9 @@ typedef struct _mode_full_dispatch {
 	unsigned long (*get_port_control)(unsigned long port_num, unsigned long port_reg);
 	void (*lock_planes)(igd_display_h display_handle);
 	int (*unlock_planes)(igd_display_h display_handle, unsigned int scrn_num);
+	/* Non-zero once the last cursor base write has latched (a vblank
+	 * has passed since it) */
+	int (*cursor_latched)(igd_display_context_t *display);
 } mode_full_dispatch_t;
 
 typedef struct _mode_dispatch {
@@ -87,6 +87,7 @@ mode_kms_dispatch_t mode_kms_dispatch_plb = {
 	NULL,
 	NULL,                       /* kms_get_vblank_counter */
 	kms_match_mode,
+	NULL,                       /* kms_flip_plane */
 };
 
 
@@ -94,6 +94,7 @@ unsigned long get_port_control_plb(unsigned long port_num, unsigned long port_re
  */
 int wait_for_vblank_plb(unsigned char *mmio, unsigned long pipe_reg);
 
+int crtc_pageflip_handler(struct drm_device *dev, int port);
 void notify_userspace_vblank(struct drm_device *dev, int port);
 
 /*!
@@ -585,6 +586,61 @@ static int igd_query_in_vblank_plb(igd_display_h display_handle)
 	}
 }
 
+/*!
+ * Reads the frame counter of the display's pipe.
+ *
+ * @param display
+ *
+ * @return the 24 bit frame count
+ */
+static unsigned long pipe_frame_plb(igd_display_context_t *display)
+{
+	unsigned long high_reg, low_reg;
+	unsigned long high1, high2, low;
+
+	if (PIPE(display)->pipe_num) {
+		high_reg = PIPEB_FRAME_HIGH;
+		low_reg = PIPEB_FRAME_PIXEL;
+	} else {
+		high_reg = PIPEA_FRAME_HIGH;
+		low_reg = PIPEA_FRAME_PIXEL;
+	}
+
+	/* The two halves are not latched together; reread across a carry */
+	do {
+		high1 = READ_MMIO_REG(display, high_reg) & PIPE_FRAME_HIGH_MASK;
+		low = READ_MMIO_REG(display, low_reg) & PIPE_FRAME_LOW_MASK;
+		high2 = READ_MMIO_REG(display, high_reg) & PIPE_FRAME_HIGH_MASK;
+	} while (high1 != high2);
+
+	return (high1 << 8) | (low >> PIPE_FRAME_LOW_SHIFT);
+}
+
+/*!
+ * Checks whether the last cursor base written by program_cursor_plb()
+ * has latched, which it does at the first vblank after the write.
+ *
+ * @param display
+ *
+ * @return 1 if the hardware scans out the last base written
+ * @return 0 if it may still scan out the one before
+ */
+static int cursor_latched_plb(igd_display_context_t *display)
+{
+	igd_cursor_priv_t *priv;
+
+	if (!(PIPE(display)->cursor)) {
+		return 1;
+	}
+	priv = CURSOR_PRIV(PIPE(display)->cursor->cursor_info);
+
+	if (priv->base_pending && pipe_frame_plb(display) != priv->base_frame) {
+		priv->base_pending = 0;
+	}
+
+	return !priv->base_pending;
+}
+
 /*!
  * This function programs the cursor registers for Grantsdale
  *
@@ -689,6 +745,10 @@ static void program_cursor_plb(igd_display_context_t *display,
 	WRITE_MMIO_REG(display, cursor_reg,
 		cursor_control | (PIPE(display)->pipe_num<<28));
 	WRITE_MMIO_REG(display, cursor_reg + CUR_BASE_OFFSET, cursor_base);
+
+	/* The old image stays on screen until this write latches */
+	CURSOR_PRIV(cursor_info)->base_frame = pipe_frame_plb(display);
+	CURSOR_PRIV(cursor_info)->base_pending = 1;
 }
 
 /*!
@@ -1454,13 +1514,23 @@ static irqreturn_t interrupt_handler_plb(int irq, void* mmio)
 	spin_unlock_irqrestore(&vblank_lock_plb, lock_flags);
 
 
+	/*
+	 * Call the KMS vblank handler, which writes queued palette entries
+	 * and completes pending flips, as on the other platforms.
+	 */
 	if (port4_interrupt) {
+		crtc_pageflip_handler(mode_context->context->drm_dev,
+			IGD_PORT_TYPE_LVDS);
+
 		if (mode_context->batch_blits[IGD_PORT_TYPE_LVDS - 1]) {
 			notify_userspace_vblank(mode_context->context->drm_dev,
 				IGD_PORT_TYPE_LVDS);
 		}
 	}
 	else if (port2_interrupt) {
+		crtc_pageflip_handler(mode_context->context->drm_dev,
+			IGD_PORT_TYPE_SDVOB);
+
 		if (mode_context->batch_blits[IGD_PORT_TYPE_SDVOB - 1]) {
 			notify_userspace_vblank(mode_context->context->drm_dev,
 				IGD_PORT_TYPE_SDVOB);
@@ -1959,5 +2029,8 @@ mode_full_dispatch_t mode_full_dispatch_plb = {
 	end_request_plb,
 	vblank_occured_plb,
 	get_port_control_plb,
+	NULL, /* lock_planes */
+	NULL, /* unlock_planes */
+	cursor_latched_plb,
 };
 
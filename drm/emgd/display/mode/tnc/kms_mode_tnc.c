@@ -62,6 +62,8 @@ static void kms_program_pipe_tnc(emgd_crtc_t *emgd_crtc);
 static void kms_set_pipe_pwr_tnc(emgd_crtc_t *emgd_crtc, unsigned long enable);
 static void kms_program_plane_tnc(emgd_crtc_t *emgd_crtc, unsigned long status);
 static void kms_set_plane_pwr_tnc(emgd_crtc_t *emgd_crtc, unsigned long enable);
+static int  kms_flip_plane_tnc(emgd_crtc_t *emgd_crtc,
+	igd_framebuffer_info_t *fb_info);
 static int  kms_program_port_tnc(emgd_encoder_t *emgd_encoder,
 	unsigned long status);
 static int  kms_program_port_lvds_tnc(emgd_encoder_t *emgd_encoder,
@@ -111,6 +113,7 @@ mode_kms_dispatch_t mode_kms_dispatch_tnc = {
 	kms_post_program_port_tnc,
 	kms_get_vblank_counter_tnc,
 	kms_match_mode,
+	kms_flip_plane_tnc,
 };
 
 
@@ -442,6 +445,9 @@ static int set_color_correct_tnc(emgd_crtc_t *emgd_crtc)
 			pipe->palette_reg + i*4);
 	}
 
+	/* The next emgd_crtc_load_lut() has to rewrite the whole palette */
+	emgd_crtc->lut_valid = 0;
+
 	OS_FREE(palette);
 
 	EMGD_TRACE_EXIT;
@@ -569,6 +575,41 @@ void kms_program_pipe_vga_tnc(
 
 
 
+/**
+ * kms_update_pipe_on_tnc
+ *
+ * Records in emgd_crtc->lut_pipe_on whether the pipe is enabled with a
+ * source size set, which is what reg_crtc_lut_set_tnc() checks before
+ * writing the palette.  Called whenever the pipe is programmed or powered.
+ *
+ * @param emgd_crtc (IN) the pipe just changed
+ *
+ * @return
+ */
+static void kms_update_pipe_on_tnc(emgd_crtc_t *emgd_crtc)
+{
+	struct drm_device  *dev;
+	unsigned char      *mmio;
+
+	dev  = ((struct drm_crtc *)(&emgd_crtc->base))->dev;
+	mmio = ((drm_emgd_priv_t *)dev->dev_private)->context->
+		device_context.virt_mmadr;
+
+	if (emgd_crtc->crtc_id == IGD_KMS_PIPEA) {
+		emgd_crtc->lut_pipe_on =
+			(EMGD_READ32(mmio + PIPEA_CONF) & PIPE_ENABLE) &&
+			EMGD_READ32(mmio + PIPEASRC);
+	} else if (emgd_crtc->crtc_id == IGD_KMS_PIPEB) {
+		emgd_crtc->lut_pipe_on =
+			(EMGD_READ32(mmio + PIPEB_CONF) & PIPE_ENABLE) &&
+			EMGD_READ32(mmio + PIPEBSRC);
+	} else {
+		emgd_crtc->lut_pipe_on = 0;
+	}
+}
+
+
+
 /**
  * kms_set_pipe_pwr_tnc
  *
@@ -604,6 +645,7 @@ static void kms_set_pipe_pwr_tnc(emgd_crtc_t *emgd_crtc, unsigned long enable)
 	/* The PIPE_ENABLE bit is at bit-position 31 */
 	if ( (enable << 31) == (pipe_conf & PIPE_ENABLE) ){
 
+		kms_update_pipe_on_tnc(emgd_crtc);
 		EMGD_TRACE_EXIT;
 		return;
 	}
@@ -649,6 +691,7 @@ static void kms_set_pipe_pwr_tnc(emgd_crtc_t *emgd_crtc, unsigned long enable)
 		EMGD_DEBUG("Set Pipe Power: ON");
 	}
 
+	kms_update_pipe_on_tnc(emgd_crtc);
 
 	EMGD_TRACE_EXIT;
 	return;
@@ -791,6 +834,7 @@ static void kms_program_pipe_tnc(emgd_crtc_t *emgd_crtc)
 		if (current_timings->mode_number <= VGA_MODE_NUM_MAX) {
 			EMGD_DEBUG("current_timings->mode_number <= VGA_MODE_NUM_MAX");
 			kms_program_pipe_vga_tnc(emgd_crtc);
+			kms_update_pipe_on_tnc(emgd_crtc);
 
 			EMGD_TRACE_EXIT;
 			return;
@@ -1018,6 +1062,8 @@ static void kms_program_pipe_tnc(emgd_crtc_t *emgd_crtc)
 		WRITE_MMIO_REG_TNC(IGD_PORT_LVDS, DSP_CHICKENBITS, temp | BIT6);
 	}
 
+	kms_update_pipe_on_tnc(emgd_crtc);
+
 	EMGD_TRACE_EXIT;
 	return;
 }
@@ -1081,6 +1127,9 @@ static void kms_set_plane_pwr_tnc(emgd_crtc_t *emgd_crtc, unsigned long enable)
 		 */
 		plane_control &= ~BIT31;
 
+		/* Force the next base change through a full reprogram */
+		plane->programmed = 0;
+
 		EMGD_WRITE32(plane_control,
 						context->device_context.virt_mmadr + plane_reg);
 
@@ -1165,6 +1214,7 @@ static void kms_program_plane_tnc(emgd_crtc_t *emgd_crtc, unsigned long status)
 		timing = (igd_timing_info_t *)timing->extn_ptr;
 	}
 	if(MODE_IS_VGA(timing) && CHECK_VGA(pipe_timing)) {
+		plane->programmed = 0;
 		kms_program_plane_vga(context->device_context.virt_mmadr, timing);
 		EMGD_TRACE_EXIT;
 		return;
@@ -1339,6 +1389,7 @@ static void kms_program_plane_tnc(emgd_crtc_t *emgd_crtc, unsigned long status)
 	EMGD_WRITE32(0, context->device_context.virt_mmadr + plane_reg + 0x24);
 	EMGD_WRITE32(fb_info->fb_base_offset,
 		context->device_context.virt_mmadr + plane_reg + DSP_START_OFFSET);
+	plane->programmed = 1;
 
 	wait_for_vblank_tnc(pipe->pipe_reg);
 
@@ -1346,6 +1397,68 @@ static void kms_program_plane_tnc(emgd_crtc_t *emgd_crtc, unsigned long status)
 }
 
 
+/*!
+ * Points an already programmed plane at a new buffer.  When the new
+ * buffer has the same size, stride, pixel format and tiling as the one
+ * the plane scans out, only the linear offset and surface registers
+ * change; the write to DSPxSURF latches both at the next vblank, so no
+ * vblank wait or read is needed.
+ *
+ * @param emgd_crtc
+ * @param fb_info New buffer.  On success its base, visible offset and
+ *   flags are copied to the plane's fb_info.
+ *
+ * @return 0 on success
+ * @return -IGD_ERROR_INVAL if the plane needs a full reprogram
+ */
+static int kms_flip_plane_tnc(emgd_crtc_t *emgd_crtc,
+	igd_framebuffer_info_t *fb_info)
+{
+	struct drm_device      *dev;
+	igd_context_t          *context;
+	igd_display_plane_t    *plane;
+	igd_display_pipe_t     *pipe;
+	igd_framebuffer_info_t *cur;
+	unsigned char          *mmio;
+
+	pipe  = emgd_crtc->igd_pipe;
+	plane = PLANE(pipe->owner);
+
+	if (!plane || !plane->programmed || !pipe->timing) {
+		return -IGD_ERROR_INVAL;
+	}
+
+	cur = plane->fb_info;
+	if (cur->lock || (pipe->timing->mode_info_flags & IGD_SCAN_INTERLACE)) {
+		return -IGD_ERROR_INVAL;
+	}
+
+	if (fb_info->width != cur->width ||
+		fb_info->height != cur->height ||
+		fb_info->screen_pitch != cur->screen_pitch ||
+		fb_info->pixel_format != cur->pixel_format ||
+		((fb_info->flags ^ cur->flags) &
+			(IGD_SURFACE_TILED | IGD_ENABLE_DISPLAY_GAMMA))) {
+		return -IGD_ERROR_INVAL;
+	}
+
+	dev     = ((struct drm_crtc *)(&emgd_crtc->base))->dev;
+	context = ((drm_emgd_priv_t *)dev->dev_private)->context;
+	mmio    = context->device_context.virt_mmadr;
+
+	cur->fb_base_offset = fb_info->fb_base_offset;
+	cur->visible_offset = fb_info->visible_offset;
+	cur->flags          = fb_info->flags;
+
+	EMGD_WRITE32(cur->visible_offset,
+		mmio + plane->plane_reg + DSP_LINEAR_OFFSET);
+	EMGD_WRITE32(cur->fb_base_offset,
+		mmio + plane->plane_reg + DSP_START_OFFSET);
+
+	return 0;
+}
+
+
 /*!
  *
  * @param emgd_encoder
@@ -64,6 +64,7 @@
 #include "../cmn/match.h"
 #include "../cmn/mode_dispatch.h"
 #include "mode_tnc.h"
+#include <emgd_vtnc.h>
 
 /*
 	Turning on FIB part workaround for all IALs, for vBIOS this will limit
@@ -2616,6 +2617,12 @@ unsigned long read_mmio_reg_tnc(unsigned long port_type, unsigned long reg)
 	}
 	OPT_MICRO_CALL_RET(mmio, get_mmio_tnc(port_type));
 	if (port_type == IGD_PORT_LPC) {
+#ifdef EMGD_VIRTUAL_TNC
+		if (emgd_vtnc) {
+			io_base = io_base_lvds;
+			return emgd_vtnc_lpc_read(reg);
+		}
+#endif
 		value = EMGD_READ_PORT32(io_base_lpc + reg);
 	} else {
 		value = EMGD_READ32(EMGD_MMIO(mmio) + reg);
@@ -2648,6 +2655,11 @@ void write_mmio_reg_tnc(unsigned long port_type, unsigned long reg,
 
 	OPT_MICRO_CALL_RET(mmio, get_mmio_tnc(port_type));
 	if (port_type == IGD_PORT_LPC) {
+#ifdef EMGD_VIRTUAL_TNC
+		if (emgd_vtnc) {
+			emgd_vtnc_lpc_write(reg, value);
+		} else
+#endif
 		EMGD_WRITE_PORT32(io_base_lpc + reg, value);
 	} else {
 		EMGD_WRITE32(value, EMGD_MMIO(mmio) + reg);
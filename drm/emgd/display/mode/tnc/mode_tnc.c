@@ -62,6 +62,7 @@
 #include <drm/drmP.h>
 
 #include <emgd_drm.h>
+#include <emgd_vtnc.h>
 
 /* Get this table from clocks_tnc.c, use this in get_pipe_info */
 extern unsigned long lvds_m_converts[];
@@ -640,6 +641,61 @@ static int igd_query_in_vblank_tnc(igd_display_h display_handle)
 	}
 }
 
+/*!
+ * Reads the frame counter of the display's pipe.
+ *
+ * @param display
+ *
+ * @return the 24 bit frame count
+ */
+static unsigned long pipe_frame_tnc(igd_display_context_t *display)
+{
+	unsigned long high_reg, low_reg;
+	unsigned long high1, high2, low;
+
+	if (PIPE(display)->pipe_num) {
+		high_reg = PIPEB_FRAME_HIGH;
+		low_reg = PIPEB_FRAME_PIXEL;
+	} else {
+		high_reg = PIPEA_FRAME_HIGH;
+		low_reg = PIPEA_FRAME_PIXEL;
+	}
+
+	/* The two halves are not latched together; reread across a carry */
+	do {
+		high1 = READ_MMIO_REG(display, high_reg) & PIPE_FRAME_HIGH_MASK;
+		low = READ_MMIO_REG(display, low_reg) & PIPE_FRAME_LOW_MASK;
+		high2 = READ_MMIO_REG(display, high_reg) & PIPE_FRAME_HIGH_MASK;
+	} while (high1 != high2);
+
+	return (high1 << 8) | (low >> PIPE_FRAME_LOW_SHIFT);
+}
+
+/*!
+ * Checks whether the last cursor base written by program_cursor_tnc()
+ * has latched, which it does at the first vblank after the write.
+ *
+ * @param display
+ *
+ * @return 1 if the hardware scans out the last base written
+ * @return 0 if it may still scan out the one before
+ */
+static int cursor_latched_tnc(igd_display_context_t *display)
+{
+	igd_cursor_priv_t *priv;
+
+	if (!(PIPE(display)->cursor)) {
+		return 1;
+	}
+	priv = CURSOR_PRIV(PIPE(display)->cursor->cursor_info);
+
+	if (priv->base_pending && pipe_frame_tnc(display) != priv->base_frame) {
+		priv->base_pending = 0;
+	}
+
+	return !priv->base_pending;
+}
+
 /*!
  * This function programs the cursor registers for Grantsdale
  *
@@ -737,6 +793,10 @@ static void program_cursor_tnc(igd_display_context_t *display,
 	WRITE_MMIO_REG(display, cursor_reg, cursor_control);
 	WRITE_MMIO_REG(display, cursor_reg + CUR_BASE_OFFSET, cursor_base);
 
+	/* The old image stays on screen until this write latches */
+	CURSOR_PRIV(cursor_info)->base_frame = pipe_frame_tnc(display);
+	CURSOR_PRIV(cursor_info)->base_pending = 1;
+
 	EMGD_TRACE_EXIT;
 }
 
@@ -1679,6 +1739,14 @@ int request_vblanks_tnc(unsigned long request_for, unsigned char *mmio)
 		struct drm_device *drm_device = mode_context->context->drm_dev;
 
 		EMGD_DEBUG("Registering interrupt_handler_tnc()");
+#ifdef EMGD_VIRTUAL_TNC
+		if (emgd_vtnc) {
+			if (emgd_vtnc_request_irq(interrupt_handler_tnc, mmio)) {
+				EMGD_ERROR_EXIT("Failed to register interrupt_handler_tnc()");
+				return -1;
+			}
+		} else
+#endif
 		if (request_irq(drm_device->pdev->irq, interrupt_handler_tnc,
 			IRQF_SHARED, EMGD_DRIVER_NAME, mmio)) {
 			EMGD_ERROR_EXIT("Failed to register interrupt_handler_tnc()");
@@ -1944,6 +2012,11 @@ int end_request_tnc(unsigned long request_for, unsigned char *mmio)
 		struct drm_device *drm_device = mode_context->context->drm_dev;
 
 		EMGD_DEBUG("Unregistering interrupt_handler_tnc()");
+#ifdef EMGD_VIRTUAL_TNC
+		if (emgd_vtnc) {
+			emgd_vtnc_free_irq(mmio);
+		} else
+#endif
 		free_irq(drm_device->pdev->irq, mmio);
 		EMGD_DEBUG("Successfully unregistered interrupt_handler_tnc()");
 	}
@@ -2215,5 +2288,6 @@ mode_full_dispatch_t mode_full_dispatch_tnc = {
 	get_port_control_tnc,
 	lock_planes,
 	unlock_planes,
+	cursor_latched_tnc,
 };
 
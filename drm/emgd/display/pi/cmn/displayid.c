@@ -851,7 +851,7 @@ int displayid_parse(
 	 *       payload
 	 *       display product type identifier
 	 *       number of extensions */
-	*(unsigned long *) did = *(unsigned long *)buffer;
+	*(unsigned int *) did = *(unsigned int *)buffer;
 
 	/* Check for version and revision */
 	if (did->version != 1 && did->revision != 0) {
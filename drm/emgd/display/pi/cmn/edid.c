@@ -167,8 +167,8 @@ void firmware_dump(unsigned char *buffer, unsigned short size)
 {
 	unsigned short i;
 	EMGD_DEBUG("---------------------------------------------------------");
-	if (*(unsigned long *) &buffer[0] == 0xFFFFFF00 &&
-		*(unsigned long *) &buffer[4] == 0x00FFFFFF) {
+	if (*(unsigned int *) &buffer[0] == 0xFFFFFF00 &&
+		*(unsigned int *) &buffer[4] == 0x00FFFFFF) {
 		size = 128;
 		EMGD_DEBUG("EDID DUMP (size = %u):", size);
 	} else {
@@ -384,7 +384,7 @@ int edid_parse(
 
 	/* Vendor Name */
 	vendor = (buffer[0]<<8) | buffer[1];
-	*(unsigned long *)edid->vendor = ((vendor>>10) + 0x40) +
+	*(unsigned int *)edid->vendor = ((vendor>>10) + 0x40) +
 		((((vendor>>5) & 0x1f) + 0x40)<<8) +
 		((unsigned long)((vendor & 0x1f) + 0x40)<<16);
 	buffer+=2;
@@ -541,13 +541,13 @@ int edid_parse(
 	/* BLOCKS: */
 	/* Blocks of Data */
 	for (i=0; i<4; i++) {
-		if (*(unsigned long *)buffer == *(unsigned long *)name_blockid) {
+		if (*(unsigned int *)buffer == *(unsigned int *)name_blockid) {
 			/* Monitor Name */
 			edid_parse_monitor_name(&buffer[5], edid->name);
 			buffer+=18;
 			continue;
 		}
-		if (*(unsigned long *)buffer == *(unsigned long *)range_blockid) {
+		if (*(unsigned int *)buffer == *(unsigned int *)range_blockid) {
 			/* Monitor Limits */
 			edid->range_set = 1;
 			edid->range.min_vrate = buffer[5];      /* Hz */
@@ -569,7 +569,7 @@ int edid_parse(
 			buffer+=18;
 			continue;
 		}
-		if (*(unsigned long *)buffer == *(unsigned long *)st_blockid) {
+		if (*(unsigned int *)buffer == *(unsigned int *)st_blockid) {
 			/* Additional 6 Standard Timings */
 			buffer+=5;
 			for (j=0; j<12; j+=2) {
@@ -578,7 +578,7 @@ int edid_parse(
 			buffer+=13;
 			continue;
 		}
-		if (*(unsigned long *)buffer & *(unsigned long *)timings_mask) {
+		if (*(unsigned int *)buffer & *(unsigned int *)timings_mask) {
 			/* Detailed Timings */
 			if (edid->num_timings >= NUM_TIMINGS-1) {
 				continue;
@@ -876,8 +876,11 @@ int read_data_block_collection(unsigned char *buffer,
 	}
 
 	*list = OS_ALLOC((sizeof(char)*total_bytes));
+	if(*list == NULL){
+		return 0;
+	}
 	for(i=0;i<total_blocks;i++){
-		OS_MEMCPY(*list+i, buffer, block_size);
+		OS_MEMCPY(*list+(i*block_size), buffer, block_size);
 		buffer+=block_size;
 	}
 
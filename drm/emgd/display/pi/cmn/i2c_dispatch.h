@@ -54,6 +54,10 @@
  */
 #define IGD_I2C_SERIAL_WRITE 0x1
 #define IGD_I2C_WRITE_FW 0x2
+/* 0x4 is IGD_I2C_CAN_SLEEP, in context.h */
+
+/* Longest run of consecutive registers moved in one transfer */
+#define IGD_I2C_BURST_MAX 16
 
 typedef struct _i2c_dispatch {
 	int (*i2c_read_regs)(
@@ -72,6 +76,18 @@ typedef struct _i2c_dispatch {
 		unsigned long dab,
 		pd_reg_t *reg_list,
 		unsigned long flags);
+	/*
+	 * Non-zero if requests on different i2c_bus values may be made at the
+	 * same time from different threads. Requests on one bus are always
+	 * serialized by the caller.
+	 */
+	int independent_buses;
+	/*
+	 * Non-zero if i2c_read_regs and i2c_write_reg_list can move a run of
+	 * consecutive encoder registers in one transfer. Port drivers only get
+	 * burst transfers (PD_FLAG_I2C_BURST) on a transport that sets this.
+	 */
+	int burst;
 } i2c_dispatch_t;
 
 #endif
@@ -39,6 +39,11 @@
 #include <igd_init.h>
 #include <igd_pwr.h>
 
+#ifndef CONFIG_MICRO
+#include <linux/workqueue.h>
+#include <linux/ktime.h>
+#endif
+
 #include <io.h>
 #include <pci.h>
 #include <sched.h>
@@ -80,6 +85,9 @@ int get_firmware_timings(igd_display_port_t *port,
 
 int pi_pd_init(igd_display_port_t *port, unsigned long port_feature,
 	unsigned long second_port_feature, int drm_load_time);
+static int pi_pd_init_device(igd_display_port_t *port);
+static void pi_release_port(igd_display_port_t *port, unsigned long prev_dab,
+	unsigned long prev_i2c_speed);
 #ifndef CONFIG_MICRO
 unsigned long get_magic_cookie(pd_driver_t *pd_driver);
 #endif
@@ -119,14 +127,402 @@ static dispatch_table_t i2c_dispatch_list[] = {
 	{0, NULL}
 };
 
+#ifndef CONFIG_MICRO
+/* One buffer per port, since ports are probed in parallel at load time */
+static unsigned char firmware_data[IGD_MAX_PORTS][256];
+#define PORT_FIRMWARE_DATA(port) firmware_data[(port)->port_number - 1]
+#else
 static unsigned char firmware_data[256];
+#define PORT_FIRMWARE_DATA(port) firmware_data
+#endif
 
 static pi_context_t pi_context[1];
 
+#ifndef CONFIG_MICRO
+/*
+ * Parsed firmware cache.  When a port sees a base block it has seen before
+ * (the same monitor coming back through a KVM switch or a loose cable),
+ * get_firmware_timings() restores the parse result from here instead of
+ * reading the rest of the EDID/DisplayID and parsing it again.  An entry
+ * also holds the mode_info_flags the parse left on the timing table it was
+ * given, and is only used for an identical table.
+ */
+#define PI_FIRMWARE_CACHE_SIZE 4
+
+typedef struct _pi_firmware_cache {
+	unsigned long long block_hash;    /* Hash of block */
+	unsigned long long table_hash;    /* Hash of the table before parsing */
+	unsigned char      block[128];    /* Base EDID/DisplayID block */
+	unsigned char      upscale;
+	unsigned char      firmware_type;
+	unsigned char      has_cea;
+	unsigned long      last_use;
+	displayid_t        parsed;        /* port->displayid after parsing */
+	cea_extension_t    cea;           /* *edid->cea after parsing */
+	unsigned long      num_flags;
+	unsigned long     *flags;         /* Table mode_info_flags after parsing */
+} pi_firmware_cache_t;
+
+static pi_firmware_cache_t *firmware_cache[IGD_MAX_PORTS][PI_FIRMWARE_CACHE_SIZE];
+static unsigned long firmware_cache_uses; /* Only orders entries for LRU */
+
+/*
+ * Port probes deferred by pi_pd_register() while pi_init_all() runs.  The
+ * encoder has been found by then; reading its EDID and building the timing
+ * list is left to pi_probe_ports(), which probes ports on different I2C
+ * buses at the same time.  Only the primary display's bus is waited for
+ * there; the other ports are finished by pi_probe_finish().
+ */
+typedef struct _pi_probe {
+	igd_display_port_t *port;
+	unsigned long      port_feature;
+	unsigned long      prev_dab;       /* Restored if the probe fails */
+	unsigned long      prev_i2c_speed;
+	int                ret;
+	int                late;           /* Left for pi_probe_finish() */
+	unsigned long      usecs;          /* Time the probe took */
+	struct _pi_probe   *next;          /* Next probe on the same bus */
+} pi_probe_t;
+
+typedef struct _pi_probe_bus {
+	struct work_struct work;
+	pi_probe_t         *first;
+} pi_probe_bus_t;
+
+static pi_probe_t pi_probes[IGD_MAX_PORTS];
+static pi_probe_bus_t pi_probe_buses[IGD_MAX_PORTS];
+static unsigned long pi_num_probes;
+static unsigned long pi_num_probe_buses;
+static int pi_probe_deferred;
+
+static int pi_probe_finish(igd_context_t *context);
+#endif
+
 /*----------------------------------------------------------------------
  *                        FUNCTION DEFINITIONS
  *----------------------------------------------------------------------*/
 #ifndef CONFIG_MICRO
+/*!
+ * FNV-1a hash of a byte range, continuing from hash.
+ *
+ * @param hash
+ * @param data
+ * @param size
+ *
+ * @return the new hash
+ */
+static unsigned long long firmware_hash(unsigned long long hash,
+	const void *data, unsigned long size)
+{
+	const unsigned char *p = data;
+
+	while (size--) {
+		hash = (hash ^ *p++) * 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+/*!
+ * Hashes everything in a timing table chain that the firmware parsers
+ * look at or change.
+ *
+ * @param timing
+ * @param count returns the number of timings in the chain
+ *
+ * @return the hash
+ */
+static unsigned long long firmware_table_hash(pd_timing_t *timing,
+	unsigned long *count)
+{
+	unsigned long long hash = 0xcbf29ce484222325ULL;
+
+	*count = 0;
+	while (timing && timing->width != IGD_TIMING_TABLE_END) {
+		/* Whole fields at a time: this runs over every built-in mode */
+		hash = (hash ^ timing->width) * 0x100000001b3ULL;
+		hash = (hash ^ timing->height) * 0x100000001b3ULL;
+		hash = (hash ^ timing->refresh) * 0x100000001b3ULL;
+		hash = (hash ^ timing->dclk) * 0x100000001b3ULL;
+		hash = (hash ^ timing->mode_info_flags) * 0x100000001b3ULL;
+		(*count)++;
+
+		timing++;
+		if (timing->width == IGD_TIMING_TABLE_END && timing->extn_ptr) {
+			timing = timing->extn_ptr;
+		}
+	}
+	return hash;
+}
+
+/*!
+ * Frees the data block lists of a CEA extension copied by
+ * firmware_cea_copy().
+ *
+ * @param cea
+ *
+ * @return void
+ */
+static void firmware_cea_release(cea_extension_t *cea)
+{
+	if (cea->short_video_desc) {
+		OS_FREE(cea->short_video_desc);
+		cea->short_video_desc = NULL;
+	}
+	if (cea->short_audio_desc) {
+		OS_FREE(cea->short_audio_desc);
+		cea->short_audio_desc = NULL;
+	}
+	if (cea->vendor_data_block) {
+		OS_FREE(cea->vendor_data_block);
+		cea->vendor_data_block = NULL;
+	}
+}
+
+/*!
+ * Copies a parsed CEA extension, giving the copy its own data block
+ * lists the way edid_parse_cea() allocates them.
+ *
+ * @param dst
+ * @param src
+ *
+ * @return 0 on success
+ * @return -IGD_ERROR_NOMEM on failure, with dst holding no lists
+ */
+static int firmware_cea_copy(cea_extension_t *dst, cea_extension_t *src)
+{
+	unsigned long size;
+
+	OS_MEMCPY(dst, src, sizeof(cea_extension_t));
+	dst->short_video_desc = NULL;
+	dst->short_audio_desc = NULL;
+	dst->vendor_data_block = NULL;
+
+	if (src->short_video_desc && src->total_short_video_desc) {
+		size = src->total_short_video_desc;
+		dst->short_video_desc = OS_ALLOC(size);
+		if (!dst->short_video_desc) {
+			goto nomem;
+		}
+		OS_MEMCPY(dst->short_video_desc, src->short_video_desc, size);
+	}
+	if (src->short_audio_desc && src->total_short_audio_desc) {
+		size = src->total_short_audio_desc * 3;
+		dst->short_audio_desc = OS_ALLOC(size);
+		if (!dst->short_audio_desc) {
+			goto nomem;
+		}
+		OS_MEMCPY(dst->short_audio_desc, src->short_audio_desc, size);
+	}
+	if (src->vendor_data_block && src->vendor_block.vendor_block_size) {
+		size = src->vendor_block.vendor_block_size;
+		dst->vendor_data_block = OS_ALLOC(size);
+		if (!dst->vendor_data_block) {
+			goto nomem;
+		}
+		OS_MEMCPY(dst->vendor_data_block, src->vendor_data_block, size);
+	}
+	return 0;
+
+nomem:
+	firmware_cea_release(dst);
+	return -IGD_ERROR_NOMEM;
+}
+
+/*!
+ * Looks up the port's firmware cache and, on a hit, restores the parse
+ * result into displayid and the timing table.
+ *
+ * @param port
+ * @param block base block read from the display
+ * @param timing_table
+ * @param upscale
+ * @param displayid zeroed port->displayid to restore into
+ * @param block_hash returns the hash of block
+ * @param table_hash returns the hash of timing_table
+ *
+ * @return 1 on a hit, 0 on a miss
+ */
+static int firmware_cache_load(igd_display_port_t *port,
+	unsigned char *block, pd_timing_t *timing_table, unsigned char upscale,
+	displayid_t *displayid, unsigned long long *block_hash,
+	unsigned long long *table_hash)
+{
+	pi_firmware_cache_t *entry;
+	edid_t *edid = (edid_t *)displayid;
+	unsigned long count, i;
+
+	*block_hash = firmware_hash(0xcbf29ce484222325ULL, block, 128);
+	*table_hash = firmware_table_hash(timing_table, &count);
+
+	if (port->port_number < 1 || port->port_number > IGD_MAX_PORTS) {
+		return 0;
+	}
+
+	for (i = 0; i < PI_FIRMWARE_CACHE_SIZE; i++) {
+		entry = firmware_cache[port->port_number - 1][i];
+		if (entry && entry->block_hash == *block_hash &&
+			entry->table_hash == *table_hash &&
+			entry->upscale == upscale && entry->num_flags == count &&
+			!OS_MEMCMP(entry->block, block, 128)) {
+			break;
+		}
+	}
+	if (i == PI_FIRMWARE_CACHE_SIZE) {
+		return 0;
+	}
+
+	OS_MEMCPY(displayid, &entry->parsed, sizeof(displayid_t));
+	if (entry->firmware_type == PI_FIRMWARE_EDID) {
+		edid->cea = NULL;
+		if (entry->has_cea) {
+			/* Like the parser, give the port a CEA block of its own */
+			edid->cea = (cea_extension_t *) OS_ALLOC(sizeof(cea_extension_t));
+			if (!edid->cea) {
+				OS_MEMSET(displayid, 0, sizeof(displayid_t));
+				return 0;
+			}
+			if (firmware_cea_copy(edid->cea, &entry->cea)) {
+				OS_FREE(edid->cea);
+				OS_MEMSET(displayid, 0, sizeof(displayid_t));
+				return 0;
+			}
+		}
+	}
+
+	for (i = 0; i < count; i++) {
+		timing_table->mode_info_flags = entry->flags[i];
+		timing_table++;
+		if (timing_table->width == IGD_TIMING_TABLE_END &&
+			timing_table->extn_ptr) {
+			timing_table = timing_table->extn_ptr;
+		}
+	}
+
+	port->firmware_type = entry->firmware_type;
+	entry->last_use = ++firmware_cache_uses;
+
+	EMGD_DEBUG("Port %lu: firmware parse result reused", port->port_number);
+	return 1;
+}
+
+/*!
+ * Remembers a successful parse in the port's firmware cache, replacing
+ * the least recently used entry if the cache is full.
+ *
+ * @param port
+ * @param block base block read from the display
+ * @param timing_table the table after parsing
+ * @param upscale
+ * @param block_hash
+ * @param table_hash hash of timing_table before parsing
+ *
+ * @return void
+ */
+static void firmware_cache_store(igd_display_port_t *port,
+	unsigned char *block, pd_timing_t *timing_table, unsigned char upscale,
+	unsigned long long block_hash, unsigned long long table_hash)
+{
+	pi_firmware_cache_t *entry, **slot;
+	edid_t *edid = port->edid;
+	unsigned long count, i;
+
+	if (port->port_number < 1 || port->port_number > IGD_MAX_PORTS) {
+		return;
+	}
+
+	slot = &firmware_cache[port->port_number - 1][0];
+	for (i = 1; i < PI_FIRMWARE_CACHE_SIZE && *slot; i++) {
+		if (!firmware_cache[port->port_number - 1][i] ||
+			firmware_cache[port->port_number - 1][i]->last_use <
+			(*slot)->last_use) {
+			slot = &firmware_cache[port->port_number - 1][i];
+		}
+	}
+
+	entry = *slot;
+	if (!entry) {
+		entry = (pi_firmware_cache_t *) OS_ALLOC(sizeof(pi_firmware_cache_t));
+		if (!entry) {
+			return;
+		}
+		entry->flags = NULL;
+		entry->has_cea = 0;
+		*slot = entry;
+	}
+	if (entry->has_cea) {
+		firmware_cea_release(&entry->cea);
+		entry->has_cea = 0;
+	}
+
+	firmware_table_hash(timing_table, &count);
+	if (entry->flags) {
+		OS_FREE(entry->flags);
+	}
+	entry->flags = NULL;
+	if (count) {
+		entry->flags = OS_ALLOC(count * sizeof(unsigned long));
+		if (!entry->flags) {
+			OS_FREE(entry);
+			*slot = NULL;
+			return;
+		}
+	}
+	for (i = 0; i < count; i++) {
+		entry->flags[i] = timing_table->mode_info_flags;
+		timing_table++;
+		if (timing_table->width == IGD_TIMING_TABLE_END &&
+			timing_table->extn_ptr) {
+			timing_table = timing_table->extn_ptr;
+		}
+	}
+	entry->num_flags = count;
+
+	entry->block_hash = block_hash;
+	entry->table_hash = table_hash;
+	OS_MEMCPY(entry->block, block, 128);
+	entry->upscale = upscale;
+	entry->firmware_type = port->firmware_type;
+	OS_MEMCPY(&entry->parsed, port->displayid, sizeof(displayid_t));
+	entry->has_cea = 0;
+	if (port->firmware_type == PI_FIRMWARE_EDID && edid->cea) {
+		if (firmware_cea_copy(&entry->cea, edid->cea)) {
+			if (entry->flags) {
+				OS_FREE(entry->flags);
+			}
+			OS_FREE(entry);
+			*slot = NULL;
+			return;
+		}
+		entry->has_cea = 1;
+	}
+	entry->last_use = ++firmware_cache_uses;
+}
+
+/*!
+ * Frees every port's firmware cache.
+ *
+ * @return void
+ */
+static void firmware_cache_free(void)
+{
+	int i, j;
+
+	for (i = 0; i < IGD_MAX_PORTS; i++) {
+		for (j = 0; j < PI_FIRMWARE_CACHE_SIZE; j++) {
+			if (firmware_cache[i][j]) {
+				if (firmware_cache[i][j]->has_cea) {
+					firmware_cea_release(&firmware_cache[i][j]->cea);
+				}
+				if (firmware_cache[i][j]->flags) {
+					OS_FREE(firmware_cache[i][j]->flags);
+				}
+				OS_FREE(firmware_cache[i][j]);
+				firmware_cache[i][j] = NULL;
+			}
+		}
+	}
+}
+
 /*!
  *
  * @param context
@@ -143,6 +539,8 @@ static void pi_shutdown(igd_context_t *context)
 		return;
 	}
 
+	firmware_cache_free();
+
 	/* Close the port drivers */
 	port = NULL;
 	while ((port = context->mod_dispatch.dsp_get_next_port(context, port, 0)) != NULL) {
@@ -152,6 +550,9 @@ static void pi_shutdown(igd_context_t *context)
 			/* pd_context is freed by port driver */
 			port->pd_context = NULL;
 			/* timing_table is freed by port driver */
+#ifndef CONFIG_MICRO
+			pi_free_timing_index(port);
+#endif
 			port->timing_table = NULL;
 			port->num_timing = 0;
 			if (port->fp_info) {
@@ -241,6 +642,231 @@ static int pi_get_config_info(igd_context_t *context,
 	return 0;
 }
 
+#ifndef CONFIG_MICRO
+/*!
+ * Makes pi_pd_register() queue the ports it finds for pi_probe_ports()
+ * instead of probing them one after another.  Only done when the I2C
+ * code can drive different buses at the same time.
+ *
+ * @return void
+ */
+static void pi_probe_begin(void)
+{
+	pi_num_probes = 0;
+	pi_probe_deferred = pi_context->i2c_dispatch &&
+		pi_context->i2c_dispatch->independent_buses;
+}
+
+/*!
+ * Queues a port whose encoder pi_pd_register() has just found.
+ *
+ * @param port
+ * @param port_feature
+ * @param prev_dab
+ * @param prev_i2c_speed
+ *
+ * @return 0 if the port was queued
+ * @return 1 if it has to be probed now
+ */
+static int pi_probe_queue(igd_display_port_t *port, unsigned long port_feature,
+	unsigned long prev_dab, unsigned long prev_i2c_speed)
+{
+	pi_probe_t *probe;
+
+	if (!pi_probe_deferred || pi_num_probes == IGD_MAX_PORTS) {
+		return 1;
+	}
+
+	probe = &pi_probes[pi_num_probes++];
+	OS_MEMSET(probe, 0, sizeof(pi_probe_t));
+	probe->port = port;
+	probe->port_feature = port_feature;
+	probe->prev_dab = prev_dab;
+	probe->prev_i2c_speed = prev_i2c_speed;
+	return 0;
+}
+
+/*!
+ * Tells whether two ports have an I2C or DDC bus in common.
+ *
+ * @param a
+ * @param b
+ *
+ * @return 1 if they do
+ */
+static int pi_probe_same_bus(igd_display_port_t *a, igd_display_port_t *b)
+{
+	if (a->i2c_reg && (a->i2c_reg == b->i2c_reg || a->i2c_reg == b->ddc_reg)) {
+		return 1;
+	}
+	if (a->ddc_reg && (a->ddc_reg == b->ddc_reg || a->ddc_reg == b->i2c_reg)) {
+		return 1;
+	}
+	return 0;
+}
+
+/*!
+ * Work item probing the ports of one bus, in order.
+ *
+ * @param work
+ *
+ * @return void
+ */
+static void pi_probe_bus(struct work_struct *work)
+{
+	pi_probe_bus_t *bus = container_of(work, pi_probe_bus_t, work);
+	pi_probe_t *probe;
+	ktime_t start;
+
+	for (probe = bus->first; probe; probe = probe->next) {
+		start = ktime_get();
+		/* Everything up to the port driver's init_device() */
+		probe->ret = pi_pd_init(probe->port, probe->port_feature, 0, FALSE);
+		probe->usecs = (unsigned long)ktime_us_delta(ktime_get(), start);
+	}
+}
+
+/*!
+ * Completes one probe in the calling thread: the port driver's
+ * init_device(), or giving the port up if the probe failed.
+ *
+ * @param probe
+ *
+ * @return 1 if the port is usable
+ */
+static int pi_probe_complete(pi_probe_t *probe)
+{
+	printk(KERN_INFO "[EMGD] %s port probed in %lu us\n",
+		probe->port->port_name, probe->usecs);
+
+	if (!probe->ret) {
+		probe->ret = pi_pd_init_device(probe->port);
+	}
+	if (probe->ret) {
+		EMGD_DEBUG("Probe of %s port failed, ret = %d",
+			probe->port->port_name, probe->ret);
+		pi_release_port(probe->port, probe->prev_dab,
+			probe->prev_i2c_speed);
+	}
+	return !probe->ret;
+}
+
+/*!
+ * Runs the probes queued while pi_init_all() registered the port drivers.
+ *
+ * Ports sharing a bus are probed by one work item, one after another;
+ * the work items for different buses run at the same time.  Each probe's
+ * EDID read, timing list and mode filtering happen in the work item.
+ *
+ * Only the first bus in port order (the port_order parameter), which
+ * carries the primary display, is waited for here, and its ports'
+ * init_device() calls made, so the primary can be set up and show the
+ * splash screen while the other buses are still being probed.  Until
+ * pi_probe_finish() completes them, the other ports are marked probing,
+ * which hides them from dsp_get_next_port() and so from the rest of the
+ * driver.
+ *
+ * @return void
+ */
+static void pi_probe_ports(void)
+{
+	igd_context_t *context = pi_context->igd_context;
+	igd_display_port_t *port = NULL;
+	pi_probe_t *probe, *last;
+	unsigned long num_buses = 0, i, j;
+	int shared;
+
+	pi_probe_deferred = 0;
+	if (!pi_num_probes) {
+		return;
+	}
+
+	while ((port = context->mod_dispatch.dsp_get_next_port(context,
+				port, 0)) != NULL) {
+		for (i = 0; i < pi_num_probes; i++) {
+			probe = &pi_probes[i];
+			if (probe->port != port) {
+				continue;
+			}
+			/* Join the bus of any earlier port sharing an I2C/DDC bus */
+			for (j = 0; j < num_buses; j++) {
+				shared = 0;
+				for (last = pi_probe_buses[j].first; ; last = last->next) {
+					shared |= pi_probe_same_bus(last->port, port);
+					if (!last->next) {
+						break;
+					}
+				}
+				if (shared) {
+					last->next = probe;
+					break;
+				}
+			}
+			if (j == num_buses) {
+				pi_probe_buses[num_buses].first = probe;
+				INIT_WORK(&pi_probe_buses[num_buses].work, pi_probe_bus);
+				num_buses++;
+			}
+			if (j) {
+				probe->late = 1;
+				port->probing = 1;
+			}
+		}
+	}
+
+	/* Only start the buses once their lists stop growing */
+	for (j = 0; j < num_buses; j++) {
+		schedule_work(&pi_probe_buses[j].work);
+	}
+	pi_num_probe_buses = num_buses;
+
+	flush_work(&pi_probe_buses[0].work);
+	EMGD_DEBUG("%lu ports queued on %lu buses", pi_num_probes, num_buses);
+
+	/* The port drivers' init_device() calls go in the order the ports
+	 * were found, because they share the saved mode state */
+	for (i = 0; i < pi_num_probes; i++) {
+		if (!pi_probes[i].late) {
+			pi_probe_complete(&pi_probes[i]);
+		}
+	}
+}
+
+/*!
+ * Waits for the ports pi_probe_ports() left probing in the background,
+ * completes them and rebuilds the display configuration list with the
+ * ones that turned out usable.  Called at driver load once the primary
+ * display is up; returns at once if nothing is left.
+ *
+ * @param context
+ *
+ * @return the number of ports added
+ */
+static int pi_probe_finish(igd_context_t *context)
+{
+	unsigned long i, j;
+	int added = 0;
+
+	for (j = 1; j < pi_num_probe_buses; j++) {
+		flush_work(&pi_probe_buses[j].work);
+	}
+
+	for (i = 0; i < pi_num_probes; i++) {
+		if (pi_probes[i].late) {
+			added += pi_probe_complete(&pi_probes[i]);
+			pi_probes[i].port->probing = 0;
+		}
+	}
+	pi_num_probes = 0;
+	pi_num_probe_buses = 0;
+
+	if (added) {
+		dsp_dc_init(context);
+	}
+	return added;
+}
+#endif
+
 /*!
  *
  * @param context
@@ -274,7 +900,9 @@ int pi_init(igd_context_t *context)
 	{
 		void *handle = NULL;
 		int ret;
+		OPT_MICRO_VOID_CALL(pi_probe_begin());
 		ret = pi_init_all(handle);
+		OPT_MICRO_VOID_CALL(pi_probe_ports());
 	}
 #endif
 
@@ -283,6 +911,9 @@ int pi_init(igd_context_t *context)
 	context->mod_dispatch.i2c_write_reg_list =
 		i2c_dispatch->i2c_write_reg_list;
 	context->mod_dispatch.pi_get_config_info = pi_get_config_info;
+#ifndef CONFIG_MICRO
+	context->mod_dispatch.pi_probe_finish = pi_probe_finish;
+#endif
 
 	OPT_MICRO_CALL(pi_full_init(context));
 
@@ -472,6 +1103,9 @@ int pi_pd_register(pd_driver_t *pd_driver)
 				I2C_DEFAULT_SPEED;
 		}
 
+		/* Probing runs in process context */
+		port->pd_i2c_flags = IGD_I2C_CAN_SLEEP;
+
 		/* Try detecting the encoder by calling port driver open() */
 		if (port->dab ||
 			((port->dab == 0) && (pd_driver->dab_list[0] == PD_DAB_LIST_END))) {
@@ -545,6 +1179,7 @@ int pi_pd_register(pd_driver_t *pd_driver)
 				}
 			}
 		}
+		port->pd_i2c_flags = 0;
 #ifndef CONFIG_MICRO
 		if(pi_context->igd_context->mod_dispatch.check_port_supported && ret == 0){
 			ret = pi_context->igd_context->mod_dispatch.check_port_supported(port);
@@ -553,19 +1188,16 @@ int pi_pd_register(pd_driver_t *pd_driver)
 		if (ret == 0) {
 
 			/* Initialize our port entry */
+#ifndef CONFIG_MICRO
+			/* Ganged ports need their second port checked right away */
+			if (!second_port_feature && !pi_probe_queue(port, port_feature,
+					prev_dab, prev_i2c_speed)) {
+				ret = 0;
+			} else
+#endif
 			ret = pi_pd_init(port, port_feature, second_port_feature, TRUE);
 			if (ret) {
-				port->pd_driver = NULL;
-				port->pd_context = NULL;
-				port->dab = prev_dab;
-				port->i2c_speed = prev_i2c_speed;
-				port->mult_port = NULL;
-				port->timing_table = NULL;
-				port->num_timing = 0;
-				if (port->callback) {
-					OS_FREE(port->callback);
-					port->callback = NULL;
-				}
+				pi_release_port(port, prev_dab, prev_i2c_speed);
 			} else {
 				EMGD_DEBUG("Device found on %s port for \"%s\"", port->port_name,
 					pd_driver->name);
@@ -604,6 +1236,35 @@ int pi_pd_register(pd_driver_t *pd_driver)
 	return PD_SUCCESS;
 } /* end pi_pd_register() */
 
+/*!
+ * Gives up a port whose pi_pd_init() failed, undoing what pi_pd_register()
+ * set up for it.
+ *
+ * @param port
+ * @param prev_dab
+ * @param prev_i2c_speed
+ *
+ * @return void
+ */
+static void pi_release_port(igd_display_port_t *port, unsigned long prev_dab,
+	unsigned long prev_i2c_speed)
+{
+	port->pd_driver = NULL;
+	port->pd_context = NULL;
+	port->dab = prev_dab;
+	port->i2c_speed = prev_i2c_speed;
+	port->mult_port = NULL;
+#ifndef CONFIG_MICRO
+	pi_free_timing_index(port);
+#endif
+	port->timing_table = NULL;
+	port->num_timing = 0;
+	if (port->callback) {
+		OS_FREE(port->callback);
+		port->callback = NULL;
+	}
+}
+
 /* Function to replace common timings in 1st list with 2nd list, 2nd list
  * is unchanged. */
 void replace_common_dtds(igd_timing_info_t *dtds1,
@@ -701,7 +1362,6 @@ int pi_pd_init(igd_display_port_t *port,
 	pd_timing_t        *firmware_timings = NULL;
 	pd_timing_t        *final_timings = NULL;
 	pd_timing_t        *pd_timing_table = NULL;
-	mode_state_t       *mstate;
 	int                i, ret = PD_SUCCESS;
 	unsigned long      edid_flags;
 	unsigned char      num_firmware_timings = 0;
@@ -710,8 +1370,6 @@ int pi_pd_init(igd_display_port_t *port,
 
 	EMGD_TRACE_ENTER;
 
-	mstate = NULL;
-
 	/* If the display device is a ganged mode device or RGBA mode, then hook
 	 * up second port pointer in first port */
 	if (second_port_feature) {
@@ -761,9 +1419,9 @@ int pi_pd_init(igd_display_port_t *port,
 			port->ddc_speed,    /* DDC speed */
 			port->ddc_dab,      /* Data Addr Byte*/
 			0,                  /* Register */
-			firmware_data,      /* Values */
+			PORT_FIRMWARE_DATA(port), /* Values */
 			128,               /* Num bytes to read */
-			0);
+			IGD_I2C_CAN_SLEEP);
 
 		/* If EDID is present then use EDID.
 		 * edid_flags will be corrected later if display_params are present */
@@ -818,7 +1476,8 @@ int pi_pd_init(igd_display_port_t *port,
 	/* Include EDID timings and filter modes */
 	if (edid_flags & IGD_DISPLAY_USE_EDID) {
 		EMGD_DEBUG("Using EDID-DTDs ");
-		ret = get_firmware_timings(port, firmware_data, final_timings);
+		ret = get_firmware_timings(port, PORT_FIRMWARE_DATA(port),
+			final_timings);
 		if (port->firmware_type == PI_FIRMWARE_EDID) {
 			firmware_timings = port->edid->timings;
 			num_firmware_timings = port->edid->num_timings;
@@ -878,6 +1537,9 @@ int pi_pd_init(igd_display_port_t *port,
 			PI_SUPPORTED_TIMINGS, &port->fp_native_dtd, PD_MODE_DTD_FP_NATIVE);
 
 	assign_dynamic_numbers(port->timing_table);
+#ifndef CONFIG_MICRO
+	pi_index_timings(port);
+#endif
 
 #ifdef DEBUG_FIRMWARE
 	{
@@ -915,6 +1577,29 @@ int pi_pd_init(igd_display_port_t *port,
 		return PD_SUCCESS;
 	}
 
+	ret = pi_pd_init_device(port);
+	EMGD_TRACE_EXIT;
+	return ret;
+} /* end pi_pd_init */
+
+/*!
+ * Second half of pi_pd_init() at load time: saves the port driver's
+ * state and initializes the device.
+ *
+ * @param port
+ *
+ * @return PD_SUCCESS on success
+ * @return port driver error on failure
+ */
+static int pi_pd_init_device(igd_display_port_t *port)
+{
+	mode_state_t *mstate = NULL;
+	int ret;
+
+	EMGD_TRACE_ENTER;
+
+	/* Driver load runs in process context */
+	port->pd_i2c_flags = IGD_I2C_CAN_SLEEP;
 
 #ifndef CONFIG_MICRO
 	/*
@@ -943,6 +1628,7 @@ int pi_pd_init(igd_display_port_t *port,
 		}
 	}
 	ret = port->pd_driver->init_device(port->pd_context);
+	port->pd_i2c_flags = 0;
 	if (ret) {
 #ifndef CONFIG_MICRO
 		/* TODO: Restore the pd state? */
@@ -965,7 +1651,58 @@ int pi_pd_init(igd_display_port_t *port,
 
 	EMGD_TRACE_EXIT;
 	return PD_SUCCESS;
-} /* end pi_pd_init */
+} /* end pi_pd_init_device */
+
+/*!
+ * Reads a list of encoder registers over I2C.  For encoders that set
+ * PD_FLAG_I2C_BURST, on a transport that supports it, each run of
+ * consecutive registers is read in one transfer.
+ *
+ * @param port
+ * @param list
+ * @param i2c_bus
+ * @param i2c_speed
+ * @param dab
+ * @param flags
+ *
+ * @return PD_SUCCESS on success
+ * @return PD_ERR_I2C_READ on failure
+ */
+static int pi_read_i2c_regs(igd_display_port_t *port, pd_reg_t *list,
+	unsigned long i2c_bus, unsigned long i2c_speed, unsigned long dab,
+	unsigned long flags)
+{
+	unsigned char buffer[IGD_I2C_BURST_MAX];
+	unsigned long num, i;
+	int burst = (port->pd_driver->flags & PD_FLAG_I2C_BURST) &&
+		pi_context->i2c_dispatch->burst;
+
+	while (list->reg != PD_REG_LIST_END) {
+		num = 1;
+		while (burst && num < IGD_I2C_BURST_MAX &&
+			list[num].reg == list->reg + num) {
+			num++;
+		}
+
+		if (pi_context->i2c_dispatch->i2c_read_regs(
+				pi_context->igd_context,
+				i2c_bus,
+				i2c_speed,
+				dab,
+				(unsigned char)list->reg,
+				buffer, num, flags)) {
+			EMGD_DEBUG("i2c_read_reg: 0x%lx (%lu) failed.", list->reg, num);
+			return PD_ERR_I2C_READ;
+		}
+
+		for (i = 0; i < num; i++) {
+			list[i].value = buffer[i];
+		}
+		list += num;
+	}
+
+	return PD_SUCCESS;
+}
 
 /*!
  * Function to read registers
@@ -979,7 +1716,6 @@ int pi_pd_init(igd_display_port_t *port,
  */
 int pi_read_regs(void *callback_context, pd_reg_t *list, unsigned long type)
 {
-	int ret;
 	igd_display_port_t *port = callback_context;
 	unsigned char      *mmio;
 
@@ -997,70 +1733,23 @@ int pi_read_regs(void *callback_context, pd_reg_t *list, unsigned long type)
 
 	mmio = EMGD_MMIO(pi_context->igd_context->device_context.virt_mmadr);
 
+	/*
+	 * Port drivers can get here in atomic context (e.g. the panic mode
+	 * set), so only callers that set port->pd_i2c_flags let the I2C code
+	 * sleep.  The same holds for pi_write_regs().
+	 */
+
 	/* Based on the port type either read GMCH registers or I2C registers */
 	switch (type) {
 	case PD_REG_I2C:
-		ret = 0;
-		while (list->reg != PD_REG_LIST_END) {
-			ret = pi_context->i2c_dispatch->i2c_read_regs(
-				pi_context->igd_context,
-				port->i2c_reg,
-				port->i2c_speed,
-				port->dab,
-				(unsigned char)list->reg,
-				(unsigned char *)&list->value, 1, 0);
-			if (ret) {
-				EMGD_DEBUG("i2c_read_reg: 0x%lx failed.", list->reg);
-				break;
-			}
-			list++;
-		}
-		if (ret) {
-			return PD_ERR_I2C_READ;
-		}
-		break;
+		return pi_read_i2c_regs(port, list, port->i2c_reg, port->i2c_speed,
+			port->dab, port->pd_i2c_flags);
 	case PD_REG_DDC_FW:
-		ret = 0;
-		while (list->reg != PD_REG_LIST_END) {
-			ret = pi_context->i2c_dispatch->i2c_read_regs(
-				pi_context->igd_context,
-				port->ddc_reg,
-				port->ddc_speed,
-				port->ddc_dab,
-				(unsigned char)list->reg,
-				(unsigned char *)&list->value, 1,
-				IGD_I2C_WRITE_FW);
-			if (ret) {
-				EMGD_DEBUG("i2c_read_reg: 0x%lx failed.", list->reg);
-				break;
-			}
-			list++;
-		}
-		if (ret) {
-			return PD_ERR_I2C_READ;
-		}
-		break;
+		return pi_read_i2c_regs(port, list, port->ddc_reg, port->ddc_speed,
+			port->ddc_dab, port->pd_i2c_flags | IGD_I2C_WRITE_FW);
 	case PD_REG_DDC:
-		ret = 0;
-		while (list->reg != PD_REG_LIST_END) {
-			ret = pi_context->i2c_dispatch->i2c_read_regs(
-				pi_context->igd_context,
-				port->ddc_reg,
-				port->ddc_speed,
-				port->ddc_dab,
-				(unsigned char)list->reg,
-				(unsigned char *)&list->value, 1,
-				0);
-			if (ret) {
-				EMGD_DEBUG("i2c_read_reg: 0x%lx failed.", list->reg);
-				break;
-			}
-			list++;
-		}
-		if (ret) {
-			return PD_ERR_I2C_READ;
-		}
-		break;
+		return pi_read_i2c_regs(port, list, port->ddc_reg, port->ddc_speed,
+			port->ddc_dab, port->pd_i2c_flags);
 	case PD_REG_PIO8:
 		while (list->reg != PD_REG_LIST_END) {
 			list->value = EMGD_READ_PORT8(list->reg);
@@ -1171,6 +1860,7 @@ int pi_write_regs(void *callback_context, pd_reg_t *list, unsigned long type)
 {
 	igd_display_port_t *port = callback_context;
 	int           ret;
+	unsigned long i2c_flags = 0;
 	unsigned char *mmio;
 
 	EMGD_TRACE_ENTER;
@@ -1189,6 +1879,14 @@ int pi_write_regs(void *callback_context, pd_reg_t *list, unsigned long type)
 	mmio = EMGD_MMIO(pi_context->igd_context->device_context.virt_mmadr);
 	EMGD_DEBUG("mmio = 0x%lx", (unsigned long)mmio);
 
+	i2c_flags = port->pd_i2c_flags;
+
+	/* Let the I2C code merge consecutive registers into one write */
+	if ((port->pd_driver->flags & PD_FLAG_I2C_BURST) &&
+		pi_context->i2c_dispatch->burst) {
+		i2c_flags |= IGD_I2C_SERIAL_WRITE;
+	}
+
 	/* Based on the port type either write GMCH registers or I2C registers */
 	switch (type) {
 	case PD_REG_DDC_FW:
@@ -1199,7 +1897,7 @@ int pi_write_regs(void *callback_context, pd_reg_t *list, unsigned long type)
 			port->ddc_speed,
 			port->ddc_dab,
 			list,
-			IGD_I2C_WRITE_FW);
+			i2c_flags | IGD_I2C_WRITE_FW);
 		if (ret) {
         	EMGD_DEBUG("i2c_write_reg: 0x%lx = 0x%lx failed.",
        		list->reg, list->value);
@@ -1213,7 +1911,7 @@ int pi_write_regs(void *callback_context, pd_reg_t *list, unsigned long type)
 			port->ddc_speed,
 			port->ddc_dab,
 			list,
-			0);
+			i2c_flags);
 		if (ret) {
         	EMGD_DEBUG("i2c_write_reg: 0x%lx = 0x%lx failed.",
        		list->reg, list->value);
@@ -1227,7 +1925,7 @@ int pi_write_regs(void *callback_context, pd_reg_t *list, unsigned long type)
 			port->i2c_speed,
 			port->dab,
 			list,
-			0);
+			i2c_flags);
 		if (ret) {
 			EMGD_DEBUG("i2c_write_reg: 0x%lx = 0x%lx failed.",
 				list->reg, list->value);
@@ -1365,6 +2063,183 @@ unsigned long get_native_dtd(igd_timing_info_t *timing,
 }
 
 #ifndef CONFIG_MICRO
+/* Mode flags an exact match has to agree on */
+#define PI_INDEX_FLAGS (IGD_SCAN_INTERLACE|IGD_PIXEL_DOUBLE|IGD_LINE_DOUBLE)
+
+/*!
+ * Orders timings by width, height, refresh and PI_INDEX_FLAGS.
+ *
+ * @param a
+ * @param b
+ *
+ * @return <0, 0 or >0 like memcmp()
+ */
+static int timing_mode_cmp(igd_timing_info_t *a, igd_timing_info_t *b)
+{
+	if (a->width != b->width) {
+		return (a->width < b->width) ? -1 : 1;
+	}
+	if (a->height != b->height) {
+		return (a->height < b->height) ? -1 : 1;
+	}
+	if (a->refresh != b->refresh) {
+		return (a->refresh < b->refresh) ? -1 : 1;
+	}
+	if ((a->mode_info_flags & PI_INDEX_FLAGS) !=
+		(b->mode_info_flags & PI_INDEX_FLAGS)) {
+		return ((a->mode_info_flags & PI_INDEX_FLAGS) <
+			(b->mode_info_flags & PI_INDEX_FLAGS)) ? -1 : 1;
+	}
+	return 0;
+}
+
+/*!
+ * Index order: timing_mode_cmp(), with equal timings in table order.
+ *
+ * @param a
+ * @param b
+ *
+ * @return <0, 0 or >0 like memcmp()
+ */
+static int timing_index_cmp(igd_timing_info_t *a, igd_timing_info_t *b)
+{
+	int ret = timing_mode_cmp(a, b);
+
+	if (ret || a == b) {
+		return ret;
+	}
+	return (a < b) ? -1 : 1;
+}
+
+/*!
+ * Frees the sorted index of the port's timing table.  Must be called
+ * whenever port->timing_table is freed or replaced.
+ *
+ * @param port
+ *
+ * @return void
+ */
+void pi_free_timing_index(igd_display_port_t *port)
+{
+	if (port->timing_index) {
+		OS_FREE(port->timing_index);
+	}
+	port->timing_index = NULL;
+	port->index_table = NULL;
+	port->num_index = 0;
+}
+
+/*!
+ * Builds a sorted index of port->timing_table so the mode match code can
+ * find an exact match with a binary search instead of walking the table
+ * on every mode set.  The index covers every entry, supported or not,
+ * since the supported flag is checked at lookup time.
+ *
+ * Without memory the port simply has no index and matching falls back to
+ * walking the table.
+ *
+ * @param port
+ *
+ * @return void
+ */
+void pi_index_timings(igd_display_port_t *port)
+{
+	igd_timing_info_t *timing, **index, *tmp;
+	unsigned long count = 0, gap, i, j;
+
+	pi_free_timing_index(port);
+
+	if (!port->timing_table) {
+		return;
+	}
+	for (timing = port->timing_table; timing->width != IGD_TIMING_TABLE_END;
+		timing++) {
+		count++;
+	}
+	if (!count) {
+		return;
+	}
+
+	index = (igd_timing_info_t **)
+		OS_ALLOC(count * sizeof(igd_timing_info_t *));
+	if (!index) {
+		return;
+	}
+	for (i = 0; i < count; i++) {
+		index[i] = &port->timing_table[i];
+	}
+
+	/* Shell sort: no recursion and no scratch buffer */
+	for (gap = count / 2; gap > 0; gap /= 2) {
+		for (i = gap; i < count; i++) {
+			tmp = index[i];
+			for (j = i; j >= gap && timing_index_cmp(index[j - gap], tmp) > 0;
+				j -= gap) {
+				index[j] = index[j - gap];
+			}
+			index[j] = tmp;
+		}
+	}
+
+	port->timing_index = index;
+	port->index_table = port->timing_table;
+	port->num_index = count;
+}
+
+/*!
+ * Looks up an exact match in the port's timing index.  Gives the same
+ * answer as walking the table: the first supported DTD with the given
+ * width, height, refresh and mode flags, or else the last supported
+ * timing that has them.
+ *
+ * @param port
+ * @param width
+ * @param height
+ * @param refresh
+ * @param flags only PI_INDEX_FLAGS are compared
+ *
+ * @return NULL if there is no match
+ * @return timing on success
+ */
+igd_timing_info_t *pi_find_timing(igd_display_port_t *port,
+	unsigned short width, unsigned short height, unsigned short refresh,
+	unsigned long flags)
+{
+	igd_timing_info_t key, *timing, *match = NULL;
+	unsigned long lo = 0, hi = port->num_index, mid;
+
+	OS_MEMSET(&key, 0, sizeof(key));
+	key.width = width;
+	key.height = height;
+	key.refresh = refresh;
+	key.mode_info_flags = flags & PI_INDEX_FLAGS;
+
+	/* First index entry that is not smaller than the key */
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (timing_mode_cmp(port->timing_index[mid], &key) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	for (; lo < port->num_index; lo++) {
+		timing = port->timing_index[lo];
+		if (timing_mode_cmp(timing, &key)) {
+			break;
+		}
+		if (!(timing->mode_info_flags & IGD_MODE_SUPPORTED)) {
+			continue;
+		}
+		match = timing;
+		if (timing->mode_info_flags & (PD_MODE_DTD_USER|PD_MODE_DTD)) {
+			break;
+		}
+	}
+	return match;
+}
+
 unsigned long get_magic_cookie(pd_driver_t *pd_driver)
 {
 	/* FIXME: Implement cookie checking */
@@ -1388,6 +2263,9 @@ int get_firmware_timings(igd_display_port_t *port,
 	edid_t         *edid;
 	displayid_t    *displayid;
 	int            ret = -1;
+#ifndef CONFIG_MICRO
+	unsigned long long block_hash, table_hash;
+#endif
 
 	EMGD_TRACE_ENTER;
 
@@ -1408,13 +2286,24 @@ int get_firmware_timings(igd_display_port_t *port,
 	}
 	OS_MEMSET(displayid, 0, sizeof(displayid_t));
 
+#ifndef CONFIG_MICRO
+	/* Seen this display before?  Then skip the rest of the read and parse */
+	if (firmware_cache_load(port, firmware_data, timing_table,
+			(unsigned char)(port->pd_driver->flags&PD_FLAG_UP_SCALING?1:0),
+			displayid, &block_hash, &table_hash)) {
+		port->edid = edid;
+		EMGD_TRACE_EXIT;
+		return 0;
+	}
+#endif
+
 	/* Now parse the EDID or DisplayID */
 	/* Check the header to determine whether the data is EDID or DisplayID */
 	/* EDID header first 8 bytes =
-	 *     byte 0, 1, 2, 3: 00 ff ff ff = unsigned long 0xFFFFFF00
-	 *     byte 4, 5, 6, 7: ff ff ff 00 = unsigned long 0x00FFFFFF */
-	if (*(unsigned long *) &firmware_data[0] == 0xFFFFFF00 &&
-		*(unsigned long *) &firmware_data[4] == 0x00FFFFFF) {
+	 *     byte 0, 1, 2, 3: 00 ff ff ff = unsigned int 0xFFFFFF00
+	 *     byte 4, 5, 6, 7: ff ff ff 00 = unsigned int 0x00FFFFFF */
+	if (*(unsigned int *) &firmware_data[0] == 0xFFFFFF00 &&
+		*(unsigned int *) &firmware_data[4] == 0x00FFFFFF) {
 #ifdef DEBUG_FIRMWARE
 		firmware_dump(firmware_data, 256);
 #endif
@@ -1432,7 +2321,7 @@ int get_firmware_timings(igd_display_port_t *port,
 					0x80,                /* Register */
 					&firmware_data[128], /* Values */
 					128,
-					0);				 /* next 128 bytes include extension */
+					IGD_I2C_CAN_SLEEP);	 /* next 128 bytes include extension */
 				ret = edid_ext_parse(&firmware_data[128], edid, timing_table,0,
 					(unsigned char)(port->pd_driver->flags&
 					PD_FLAG_UP_SCALING?1:0));
@@ -1441,7 +2330,9 @@ int get_firmware_timings(igd_display_port_t *port,
 				ret = 0;
 			}
 		} else if (ret) {
+			/* edid may be the reused port->displayid; don't leave it dangling */
 			OS_FREE(edid);
+			port->edid = NULL;
 			return -IGD_ERROR_EDID;
 		}
 
@@ -1471,7 +2362,7 @@ int get_firmware_timings(igd_display_port_t *port,
 				0,                  /* Register */
 				firmware_data,      /* Values */
 				displayid_size,    /* Num bytes to read */
-				0);
+				IGD_I2C_CAN_SLEEP);
 		}
 
 #ifdef DEBUG_FIRMWARE
@@ -1484,6 +2375,7 @@ int get_firmware_timings(igd_display_port_t *port,
 			port->firmware_type = PI_FIRMWARE_DISPLAYID;
 		} else {
 			OS_FREE(displayid);
+			edid = NULL;
 		}
 #ifdef DEBUG_FIRMWARE
 		displayid_print(firmware_data, displayid);
@@ -1498,6 +2390,14 @@ int get_firmware_timings(igd_display_port_t *port,
 
 	port->edid = edid;
 
+#ifndef CONFIG_MICRO
+	if (!ret && edid) {
+		firmware_cache_store(port, firmware_data, timing_table,
+			(unsigned char)(port->pd_driver->flags&PD_FLAG_UP_SCALING?1:0),
+			block_hash, table_hash);
+	}
+#endif
+
 	EMGD_TRACE_EXIT;
 	return ret;
 } /* end get_firmware_timings() */
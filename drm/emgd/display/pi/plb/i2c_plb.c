@@ -76,6 +76,8 @@ static int i2c_write_reg_list_plb(
 i2c_dispatch_t i2c_dispatch_plb = {
 	i2c_read_regs_plb,
 	i2c_write_reg_list_plb,
+	0, /* All buses share the one GMBUS controller */
+	0, /* GMBUS_DVO_REG reads return a single register */
 };
 
 
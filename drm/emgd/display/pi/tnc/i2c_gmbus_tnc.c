@@ -34,6 +34,8 @@
 #include <io.h>
 #include <memory.h>
 #include <sched.h>
+#include <linux/bitops.h>
+#include <linux/wait.h>
 
 #include <igd_pwr.h>
 
@@ -43,6 +45,7 @@
 #include <utils.h>
 
 #include <tnc/regs.h>
+#include <emgd_vtnc.h>
 
 #include "../cmn/i2c_dispatch.h"
 
@@ -73,9 +76,29 @@ static int i2c_write_reg_list_tnc(
 	pd_reg_t *reg_list,
 	unsigned long flags);
 
+static int _i2c_read_regs_tnc(
+	igd_context_t *context,
+	unsigned long i2c_bus,
+	unsigned long i2c_speed,
+	unsigned long dab,
+	unsigned char reg,
+	unsigned char FAR *buffer,
+	unsigned long num_bytes,
+	unsigned long flags);
+
+static int _i2c_write_reg_list_tnc(
+	igd_context_t *context,
+	unsigned long i2c_bus,
+	unsigned long i2c_speed,
+	unsigned long dab,
+	pd_reg_t *reg_list,
+	unsigned long flags);
+
 i2c_dispatch_t i2c_dispatch_tnc = {
 	i2c_read_regs_tnc,
 	i2c_write_reg_list_tnc,
+	1, /* LVDS DDC and GMBUS have separate locks */
+	1, /* gmbus_read_regs() and gmbus_write_regs() */
 };
 
 
@@ -165,13 +188,61 @@ static int gmbus_write_reg(unsigned long slave_addr,
 	unsigned long index,
 	unsigned char data);
 
+static int gmbus_read_regs(unsigned long slave_addr,
+	unsigned long index,
+	unsigned long num_bytes,
+	unsigned char FAR *buffer);
+
+static int gmbus_write_regs(unsigned long slave_addr,
+	pd_reg_t *reg_list,
+	unsigned long num_regs);
+
 static int gmbus_set_control_bus_switch(unsigned long slave_addr,
 	gmbus_ddc_addr_t ddc_addr);
 
-static int gmbus_wait_event_one(unsigned long bit);
-static int gmbus_wait_event_zero(unsigned long bit);
+static int gmbus_lock(unsigned long i2c_bus, unsigned long flags);
+static void gmbus_unlock(unsigned long i2c_bus);
+static int gmbus_wait_event_one(unsigned long bit, unsigned long bytes);
+static int gmbus_wait_event_zero(unsigned long bit, unsigned long bytes);
 static int gmbus_error_handler(void);
 
+/*
+ * GMBUS2 reads before a wait starts sleeping. Status that is already there
+ * (bus idle, the HW_WAIT after a completed read) costs no more than it did.
+ */
+#define GMBUS_SPIN_READS		4
+
+/* How long a GMBUS2 bit may take to change before the transfer fails */
+#define GMBUS_TIMEOUT_ONE_US	50000
+#define GMBUS_TIMEOUT_ZERO_US	10000
+
+/*
+ * Time one byte (8 bits and the ACK) takes on the bus at the speed set by
+ * gmbus_init(). Waits sleep for the bytes in flight before looking at
+ * GMBUS2 again, instead of reading it back to back.
+ */
+static unsigned long gmbus_byte_us = 90;
+
+/*
+ * Serializes i2c requests, one bit per bus. A bit lock rather than a mutex,
+ * so requests that cannot sleep are serialized too: they poll for the bit
+ * for at most GMBUS_SPIN_LOCK_US, about one short register transfer, and
+ * fail rather than spin through a long one such as an EDID read. Requests
+ * passing IGD_I2C_CAN_SLEEP queue on gmbus_wait_tnc.
+ *
+ * The LVDS DDC is bit-bashed on the LPC GPIOs and shares nothing with
+ * GMBUS, so it has its own bit and both buses can be busy at once.
+ */
+#define GMBUS_BUSY_GMBUS	0
+#define GMBUS_BUSY_GPIO		1
+#define GMBUS_SPIN_LOCK_US	1000
+
+static unsigned long gmbus_busy_tnc;
+static DECLARE_WAIT_QUEUE_HEAD(gmbus_wait_tnc);
+
+/* Whether the request that owns GMBUS may sleep; only the owner uses it */
+static int gmbus_owner_can_sleep;
+
 /*.......................................................................... */
 extern int i2c_read_regs_gpio(
 	igd_context_t *context,
@@ -214,9 +285,37 @@ static int i2c_read_regs_tnc(igd_context_t *context,
 	unsigned char FAR *buffer,
 	unsigned long num_bytes,
 	unsigned long flags)
+{
+	int ret;
+
+	if (! gmbus_lock(i2c_bus, flags)) {
+		return 1;
+	}
+	ret = _i2c_read_regs_tnc(context, i2c_bus, i2c_speed, dab, reg, buffer,
+		num_bytes, flags);
+	gmbus_unlock(i2c_bus);
+
+	return ret;
+}
+
+static int _i2c_read_regs_tnc(igd_context_t *context,
+	unsigned long i2c_bus,
+	unsigned long i2c_speed,
+	unsigned long dab,
+	unsigned char reg,
+	unsigned char FAR *buffer,
+	unsigned long num_bytes,
+	unsigned long flags)
 {
 	unsigned long slave_addr = 0;
 
+#ifdef EMGD_VIRTUAL_TNC
+	/* Only the virtual panel's DDC answers; there is no sDVO device */
+	if (emgd_vtnc) {
+		return emgd_vtnc_i2c_read(dab, reg, buffer, num_bytes);
+	}
+#endif
+
 	if(i2c_bus == I2C_INT_LVDS_DDC){
 		/*
 		 * Atom E6xx LVDS does not have GMBUS support. To read DDC register, we bit bash.
@@ -249,7 +348,13 @@ static int i2c_read_regs_tnc(igd_context_t *context,
 			break;
 
 		case GMBUS_DVO_REG :
-			if (! gmbus_read_reg(dab, reg, buffer)) {
+			if (num_bytes > 1) {
+				if (! gmbus_read_regs(dab, reg, num_bytes, buffer)) {
+
+					EMGD_DEBUG("Error ! i2c_read_regs_tnc : gmbus_read_regs() failed");
+					return 1;
+				}
+			} else if (! gmbus_read_reg(dab, reg, buffer)) {
 
 				EMGD_DEBUG("Error ! i2c_read_regs_tnc : gmbus_read_reg() failed");
 				return 1;
@@ -286,8 +391,34 @@ static int i2c_write_reg_list_tnc(igd_context_t *context,
 	unsigned long dab,
 	pd_reg_t *reg_list,
 	unsigned long flags)
+{
+	int ret;
+
+	if (! gmbus_lock(i2c_bus, flags)) {
+		return 1;
+	}
+	ret = _i2c_write_reg_list_tnc(context, i2c_bus, i2c_speed, dab, reg_list,
+		flags);
+	gmbus_unlock(i2c_bus);
+
+	return ret;
+}
+
+static int _i2c_write_reg_list_tnc(igd_context_t *context,
+	unsigned long i2c_bus,
+	unsigned long i2c_speed,
+	unsigned long dab,
+	pd_reg_t *reg_list,
+	unsigned long flags)
 {
 	unsigned long reg_num = 0, ddc_addr = 0, slave_addr = 0;
+	unsigned long num_regs;
+
+#ifdef EMGD_VIRTUAL_TNC
+	if (emgd_vtnc) {
+		return 1;
+	}
+#endif
 
 	if(i2c_bus == I2C_INT_LVDS_DDC){
 		/* There are no GMBUS pins for internal LVDS on Atom E6xx.
@@ -329,10 +460,10 @@ static int i2c_write_reg_list_tnc(igd_context_t *context,
 			}
 			/*...................................................................... */
 			/* Issue a Stop Command */
-			gmbus_wait_event_one(HW_WAIT);
+			gmbus_wait_event_one(HW_WAIT, 1);
 			WRITE_GMCH_REG(GMBUS1, STO | SW_RDY | ddc_addr);
-			gmbus_wait_event_one(HW_RDY);
-			gmbus_wait_event_zero(GA);
+			gmbus_wait_event_one(HW_RDY, 1);
+			gmbus_wait_event_zero(GA, 1);
 			gmbus_error_handler();
 			WRITE_GMCH_REG(GMBUS1, SW_RDY);
 			WRITE_GMCH_REG(GMBUS1, SW_CLR_INT);
@@ -344,7 +475,24 @@ static int i2c_write_reg_list_tnc(igd_context_t *context,
 		}
 		while (reg_list[reg_num].reg != PD_REG_LIST_END) {
 
-			if (! gmbus_write_reg(dab, reg_list[reg_num].reg,
+			/* Count the consecutive registers that can go in one burst */
+			num_regs = 1;
+			while ((flags & IGD_I2C_SERIAL_WRITE) &&
+				(num_regs < IGD_I2C_BURST_MAX) &&
+				(reg_list[reg_num + num_regs].reg ==
+					reg_list[reg_num].reg + num_regs)) {
+				num_regs++;
+			}
+
+			if (num_regs > 1) {
+				if (! gmbus_write_regs(dab, &reg_list[reg_num], num_regs)) {
+
+					EMGD_DEBUG("Error ! i2c_write_reg_list_tnc : gmbus_write_regs() failed, reg_num=%lu",
+						reg_num);
+
+					return 1;
+				}
+			} else if (! gmbus_write_reg(dab, reg_list[reg_num].reg,
 					(unsigned char)reg_list[reg_num].value)) {
 
 				EMGD_DEBUG("Error ! i2c_write_reg_list_tnc : gmbus_write_reg() failed, reg_num=%lu",
@@ -353,7 +501,7 @@ static int i2c_write_reg_list_tnc(igd_context_t *context,
 				return 1;
 			}
 
-			reg_num++;
+			reg_num += num_regs;
 		}
 	}
 
@@ -408,6 +556,21 @@ static int gmbus_init(unsigned long i2c_bus,
 		break;
 	}
 
+	switch (bus_speed) {
+	case GMBUS_SPEED_50K :
+		gmbus_byte_us = 180;
+		break;
+	case GMBUS_SPEED_400K :
+		gmbus_byte_us = 23;
+		break;
+	case GMBUS_SPEED_1000K :
+		gmbus_byte_us = 9;
+		break;
+	default :
+		gmbus_byte_us = 90;
+		break;
+	}
+
 	WRITE_GMCH_REG(GMBUS5, 0);   /* Clear the word index reg */
 	WRITE_GMCH_REG(GMBUS0, pin_pair | bus_speed);
 
@@ -415,62 +578,136 @@ static int gmbus_init(unsigned long i2c_bus,
 }
 
 /*!
- * gmbus_wait_event_zero waits for specified GMBUS2 register bit to be deasserted
+ * gmbus_lock takes the bus for one i2c request. With IGD_I2C_CAN_SLEEP the
+ * caller sleeps while another request owns the bus; otherwise it polls,
+ * and it then also polls rather than sleeps for the bus itself.
  *
- * @param bit
+ * @param i2c_bus
+ * @param flags IGD_I2C_CAN_SLEEP if the caller may sleep
  *
- * @return TRUE(1) on success. The bit was deasserted in the specified timeout period
- * @return FALSE(0) on failure
+ * @return TRUE(1) if the bus was taken and must be passed to gmbus_unlock()
+ * @return FALSE(0) if the caller cannot sleep and the bus stayed busy for
+ *  GMBUS_SPIN_LOCK_US
  */
-static int gmbus_wait_event_zero(unsigned long bit)
+static int gmbus_lock(unsigned long i2c_bus, unsigned long flags)
 {
-	unsigned long i;
-	unsigned long status;
-
-	for (i = 0; i < 0x1000; i++) {
+	int bit = (i2c_bus == I2C_INT_LVDS_DDC) ? GMBUS_BUSY_GPIO : GMBUS_BUSY_GMBUS;
+	unsigned long waited_us = 0;
 
-		status = READ_GMCH_REG(GMBUS2);
-
-		if ((status & bit) == 0) {
-
-			return 1;
+	if (flags & IGD_I2C_CAN_SLEEP) {
+		wait_event(gmbus_wait_tnc,
+			!test_and_set_bit_lock(bit, &gmbus_busy_tnc));
+	} else {
+		while (test_and_set_bit_lock(bit, &gmbus_busy_tnc)) {
+			if (waited_us >= GMBUS_SPIN_LOCK_US) {
+				EMGD_ERROR("Error ! gmbus_lock : bus 0x%lx stayed busy",
+					i2c_bus);
+				return 0;
+			}
+			udelay(gmbus_byte_us);
+			waited_us += gmbus_byte_us;
 		}
 	}
 
-	EMGD_DEBUG("Error ! gmbus_wait_event_zero : Failed : bit=0x%lx, status=0x%lx",
-		bit, status);
+	if (bit == GMBUS_BUSY_GMBUS) {
+		gmbus_owner_can_sleep = (flags & IGD_I2C_CAN_SLEEP) != 0;
+	}
+	return 1;
+}
 
-	return 0;
+static void gmbus_unlock(unsigned long i2c_bus)
+{
+	clear_bit_unlock((i2c_bus == I2C_INT_LVDS_DDC) ?
+		GMBUS_BUSY_GPIO : GMBUS_BUSY_GMBUS, &gmbus_busy_tnc);
+	wake_up(&gmbus_wait_tnc);
 }
 
 /*!
- * gmbus_wait_event_one wait for specified GMBUS2 register bits to be asserted
+ * gmbus_wait_event waits for a GMBUS2 bit to reach the specified state.
+ *
+ * A few back to back reads catch status that is already there. After that
+ * the wait sleeps for the bytes still on the wire, then polls once per
+ * byte time until the bit changes or timeout_us has passed.
  *
  * @param bit
+ * @param set TRUE(1) to wait for the bit to be asserted, FALSE(0) to wait for
+ *  it to be deasserted
+ * @param bytes Bytes the controller transfers before the bit changes
+ * @param timeout_us
  *
- * @return TRUE(1) on success. The bit was asserted in the specified timeout period
+ * @return TRUE(1) on success. The bit reached the state in time
  * @return FALSE(0) on failure
  */
-static int gmbus_wait_event_one(unsigned long bit)
+static int gmbus_wait_event(unsigned long bit, int set, unsigned long bytes,
+	unsigned long timeout_us)
 {
 	unsigned long i;
 	unsigned long status;
+	unsigned long delay_us;
+	unsigned long waited_us = 0;
+
+	for (i = 0; i < GMBUS_SPIN_READS; i++) {
+
+		status = READ_GMCH_REG(GMBUS2);
+		if (((status & bit) != 0) == set) {
+
+			return 1;
+		}
+	}
+
+	delay_us = (bytes ? bytes : 1) * gmbus_byte_us;
 
-	for (i = 0; i < 0x10000; i++) {
+	while (waited_us < timeout_us) {
+
+		if (gmbus_owner_can_sleep) {
+			usleep_range(delay_us, delay_us + gmbus_byte_us);
+		} else {
+			udelay(delay_us);
+		}
+		waited_us += delay_us;
+		delay_us = gmbus_byte_us;
 
 		status = READ_GMCH_REG(GMBUS2);
-		if ((status & bit) != 0) {
+		if (((status & bit) != 0) == set) {
 
 			return 1;
 		}
 	}
 
-	EMGD_DEBUG("Error ! gmbus_wait_event_one : Failed : bit=0x%lx, status=0x%lx",
-		bit, status);
+	EMGD_DEBUG("Error ! gmbus_wait_event : Failed : bit=0x%lx, set=%d, "
+		"status=0x%lx", bit, set, status);
 
 	return 0;
 }
 
+/*!
+ * gmbus_wait_event_zero waits for specified GMBUS2 register bit to be deasserted
+ *
+ * @param bit
+ * @param bytes Bytes the controller transfers before the bit changes
+ *
+ * @return TRUE(1) on success. The bit was deasserted in the specified timeout period
+ * @return FALSE(0) on failure
+ */
+static int gmbus_wait_event_zero(unsigned long bit, unsigned long bytes)
+{
+	return gmbus_wait_event(bit, 0, bytes, GMBUS_TIMEOUT_ZERO_US);
+}
+
+/*!
+ * gmbus_wait_event_one wait for specified GMBUS2 register bits to be asserted
+ *
+ * @param bit
+ * @param bytes Bytes the controller transfers before the bit changes
+ *
+ * @return TRUE(1) on success. The bit was asserted in the specified timeout period
+ * @return FALSE(0) on failure
+ */
+static int gmbus_wait_event_one(unsigned long bit, unsigned long bytes)
+{
+	return gmbus_wait_event(bit, 1, bytes, GMBUS_TIMEOUT_ONE_US);
+}
+
 /*!
  * gmbus_error_handler attempts to recover from timeout error
  *
@@ -492,7 +729,7 @@ static int gmbus_error_handler(void)
 		WRITE_GMCH_REG(GMBUS1, SW_CLR_INT);
 		WRITE_GMCH_REG(GMBUS1, 0);
 
-		gmbus_wait_event_zero(GA);
+		gmbus_wait_event_zero(GA, 1);
 
 		return 1;	/* Handled the error */
 	}
@@ -537,24 +774,22 @@ static int gmbus_send_pkt(unsigned long slave_addr, unsigned long index,
 {
 	unsigned long gmbus1_cmd;
 	unsigned long bytes_sent;
-	unsigned long *data;
+	unsigned long chunk;
+	unsigned int *data;
 
 	if ((pkt_size == 0) || (pkt == NULL) || (pkt_size > 508)) {
 
 		return 0;
 	}
 
-	data = (unsigned long *)pkt;
+	data = (unsigned int *)pkt;
 
 	/*...................................................................... */
 	gmbus_error_handler();
 
+	/* The controller only starts once SW_RDY is set, whatever the size */
 	gmbus1_cmd = gmbus_assemble_command(slave_addr, index, pkt_size,
-										STA, I2C_WRITE);
-	if (pkt_size <= 4) {
-
-		gmbus1_cmd |= SW_RDY;
-	}
+										STA | SW_RDY, I2C_WRITE);
 
 	/*...................................................................... */
 	bytes_sent = 0;
@@ -563,12 +798,15 @@ static int gmbus_send_pkt(unsigned long slave_addr, unsigned long index,
 
 		WRITE_GMCH_REG(GMBUS3, *data);
 
+		chunk = (pkt_size - bytes_sent > 4) ? 4 : pkt_size - bytes_sent;
 		if (bytes_sent == 0) {
 
 			WRITE_GMCH_REG(GMBUS1, gmbus1_cmd);
 		}
 
-		if (! gmbus_wait_event_one(HW_RDY)) {
+		/* The first chunk also carries the address and index bytes */
+		if (! gmbus_wait_event_one(HW_RDY,
+				(bytes_sent == 0) ? chunk + 2 : chunk)) {
 
 			EMGD_DEBUG("Error ! gmbus_send_pkt : Failed to get HW_RDY, bytes_sent=%ld",
 				bytes_sent);
@@ -585,13 +823,7 @@ static int gmbus_send_pkt(unsigned long slave_addr, unsigned long index,
 		}
 
 		data++;
-
-		if (pkt_size >= 4) {
-			bytes_sent += 4;
-
-		} else {
-			bytes_sent += pkt_size;
-		}
+		bytes_sent += chunk;
 
 	} while (bytes_sent < pkt_size);
 
@@ -622,14 +854,14 @@ static int gmbus_recv_pkt(unsigned long slave_addr, unsigned long index,
 {
 	unsigned long gmbus1_cmd;
 	unsigned long bytes_rcvd;
-	unsigned long FAR *data;
+	unsigned int FAR *data;
 
 	if ((pkt_size == 0) || (pkt == NULL) || (pkt_size > 508)) {
 
 		return 0;
 	}
 
-	data = (unsigned long FAR *)pkt;
+	data = (unsigned int FAR *)pkt;
 
 	/*...................................................................... */
 	gmbus_error_handler();
@@ -645,8 +877,14 @@ static int gmbus_recv_pkt(unsigned long slave_addr, unsigned long index,
 
 		unsigned long gmbus3_data;
 		unsigned long bytes_left = pkt_size - bytes_rcvd;
+		unsigned long chunk = (bytes_left > 4) ? 4 : bytes_left;
+
+		/* Address, index and the repeated address precede the first chunk */
+		if (bytes_rcvd == 0) {
+			chunk += 3;
+		}
 
-		if (! gmbus_wait_event_one(HW_RDY)) {
+		if (! gmbus_wait_event_one(HW_RDY, chunk)) {
 
 			EMGD_DEBUG("Error ! gmbus_recv_pkt : Failed to get HW_RDY, "
 				"bytes_rcvd=%ld", bytes_rcvd);
@@ -684,7 +922,7 @@ static int gmbus_recv_pkt(unsigned long slave_addr, unsigned long index,
 		}
 
 		default :	/* >= 4 */
-			*data = gmbus3_data;
+			*data = (unsigned int)gmbus3_data;
 			break;
 		}
 
@@ -738,10 +976,10 @@ static int gmbus_set_control_bus_switch(unsigned long slave_addr,
 
 	/*...................................................................... */
 	/* Generate I2C stop cycle */
-	gmbus_wait_event_one(HW_WAIT);
+	gmbus_wait_event_one(HW_WAIT, 1);
 	WRITE_GMCH_REG(GMBUS1, STO | SW_RDY | slave_addr);
-	gmbus_wait_event_one(HW_RDY);
-	gmbus_wait_event_zero(GA);
+	gmbus_wait_event_one(HW_RDY, 1);
+	gmbus_wait_event_zero(GA, 1);
 
 	/*...................................................................... */
 	/* Transmit the Opcode */
@@ -770,10 +1008,10 @@ static int gmbus_set_control_bus_switch(unsigned long slave_addr,
 
 	/*...................................................................... */
 	/* Send Stop */
-	gmbus_wait_event_one(HW_WAIT);
+	gmbus_wait_event_one(HW_WAIT, 1);
 	WRITE_GMCH_REG(GMBUS1, STO | SW_RDY | slave_addr);
-	gmbus_wait_event_one(HW_RDY);
-	gmbus_wait_event_zero(GA);
+	gmbus_wait_event_one(HW_RDY, 1);
+	gmbus_wait_event_zero(GA, 1);
 
 	/*...................................................................... */
 	if (data != SDVO_STATUS_SUCCESS) {
@@ -829,11 +1067,11 @@ static int gmbus_read_edid(unsigned long ddc_addr,
 	/*...................................................................... */
 	/* Issue a Stop Command */
 
-	gmbus_wait_event_one(HW_WAIT);
+	gmbus_wait_event_one(HW_WAIT, 1);
 	WRITE_GMCH_REG(GMBUS1, STO | SW_RDY | ddc_addr);
-	gmbus_wait_event_one(HW_RDY);
+	gmbus_wait_event_one(HW_RDY, 1);
 
-	gmbus_wait_event_zero(GA);
+	gmbus_wait_event_zero(GA, 1);
 
 	gmbus_error_handler();
 	WRITE_GMCH_REG(GMBUS1, SW_RDY);
@@ -864,7 +1102,7 @@ static int gmbus_read_reg(unsigned long slave_addr,
 
 	WRITE_GMCH_REG(GMBUS5, 0x0);		/* Clear Word Index register */
 
-	if (! gmbus_wait_event_zero(GA)) {
+	if (! gmbus_wait_event_zero(GA, 1)) {
 
 		EMGD_DEBUG("Error ! gmbus_read_reg : Failed to get GA(1)");
 
@@ -875,7 +1113,7 @@ static int gmbus_read_reg(unsigned long slave_addr,
 										STO | STA, I2C_READ);
 	WRITE_GMCH_REG(GMBUS1, gmbus1_cmd);
 
-	if (! gmbus_wait_event_zero(GA)) {
+	if (! gmbus_wait_event_zero(GA, 4)) {
 
 		EMGD_DEBUG("Error ! gmbus_read_reg : Failed to get GA(2)");
 
@@ -905,7 +1143,7 @@ static int gmbus_write_reg(unsigned long slave_addr,
 
 	WRITE_GMCH_REG(GMBUS5, 0x0);		/* Clear Word Index register */
 
-	if (! gmbus_wait_event_zero(GA)) {
+	if (! gmbus_wait_event_zero(GA, 1)) {
 
 		EMGD_DEBUG("Error ! gmbus_write_reg : Failed to get GA(1)");
 
@@ -918,7 +1156,7 @@ static int gmbus_write_reg(unsigned long slave_addr,
 										STO | STA, I2C_WRITE);
 	WRITE_GMCH_REG(GMBUS1, gmbus1_cmd);
 
-	if (! gmbus_wait_event_zero(GA)) {
+	if (! gmbus_wait_event_zero(GA, 3)) {
 
 		EMGD_DEBUG("Error ! gmbus_write_reg : Failed to get GA(2)");
 		return 0;
@@ -927,3 +1165,115 @@ static int gmbus_write_reg(unsigned long slave_addr,
 	return 1;
 }
 
+/*!
+ * gmbus_read_regs reads consecutive i2c registers in one transfer
+ *
+ * @param slave_addr 0x70/0x72 (sDVOB, sDVOC)
+ * @param index First i2c register index
+ * @param num_bytes 1 - IGD_I2C_BURST_MAX
+ * @param buffer register data
+ *
+ * @return TRUE(1) if successful in reading the i2c registers
+ * @return FALSE(0) on failure
+ */
+static int gmbus_read_regs(unsigned long slave_addr,
+	unsigned long index,
+	unsigned long num_bytes,
+	unsigned char FAR *buffer)
+{
+	unsigned int pkt[(IGD_I2C_BURST_MAX + 3) / 4];
+	unsigned char *data = (unsigned char *)pkt;
+	unsigned long i;
+	int status;
+
+	if (num_bytes > IGD_I2C_BURST_MAX) {
+
+		return 0;
+	}
+
+	WRITE_GMCH_REG(GMBUS5, 0x0);		/* Clear Word Index register */
+
+	if (! gmbus_wait_event_zero(GA, 1)) {
+
+		EMGD_DEBUG("Error ! gmbus_read_regs : Failed to get GA");
+
+		return 0;
+	}
+
+	status = gmbus_recv_pkt(slave_addr, index, num_bytes, pkt);
+
+	/* Send Stop */
+	gmbus_wait_event_one(HW_WAIT, 1);
+	WRITE_GMCH_REG(GMBUS1, STO | SW_RDY | slave_addr);
+	gmbus_wait_event_one(HW_RDY, 1);
+	gmbus_wait_event_zero(GA, 1);
+	gmbus_error_handler();
+
+	if (! status) {
+
+		EMGD_DEBUG("Error ! gmbus_read_regs : gmbus_recv_pkt() failed");
+
+		return 0;
+	}
+
+	for (i = 0; i < num_bytes; i++) {
+		buffer[i] = data[i];
+	}
+
+	return 1;
+}
+
+/*!
+ * gmbus_write_regs writes consecutive i2c registers in one transfer
+ *
+ * @param slave_addr 0x70/0x72 (sDVOB, sDVOC)
+ * @param reg_list Registers to write, reg_list[i].reg == reg_list[0].reg + i
+ * @param num_regs 1 - IGD_I2C_BURST_MAX
+ *
+ * @return TRUE(1) if successful in updating the i2c registers
+ * @return FALSE(0) on failure
+ */
+static int gmbus_write_regs(unsigned long slave_addr,
+	pd_reg_t *reg_list,
+	unsigned long num_regs)
+{
+	unsigned int pkt[(IGD_I2C_BURST_MAX + 3) / 4];
+	unsigned char *data = (unsigned char *)pkt;
+	unsigned long i;
+	int status;
+
+	if (num_regs > IGD_I2C_BURST_MAX) {
+
+		return 0;
+	}
+
+	for (i = 0; i < num_regs; i++) {
+		data[i] = (unsigned char)reg_list[i].value;
+	}
+
+	WRITE_GMCH_REG(GMBUS5, 0x0);		/* Clear Word Index register */
+
+	if (! gmbus_wait_event_zero(GA, 1)) {
+
+		EMGD_DEBUG("Error ! gmbus_write_regs : Failed to get GA");
+
+		return 0;
+	}
+
+	status = gmbus_send_pkt(slave_addr, reg_list[0].reg, num_regs, pkt);
+
+	/* Send Stop */
+	gmbus_wait_event_one(HW_WAIT, 1);
+	WRITE_GMCH_REG(GMBUS1, STO | SW_RDY | slave_addr);
+	gmbus_wait_event_one(HW_RDY, 1);
+	gmbus_wait_event_zero(GA, 1);
+	gmbus_error_handler();
+
+	if (! status) {
+
+		EMGD_DEBUG("Error ! gmbus_write_regs : gmbus_send_pkt() failed");
+	}
+
+	return status;
+}
+
@@ -45,6 +45,10 @@
 /* Necessary to cursor memory from PVR buffer */
 #include "pvr_bridge_km.h"
 
+/* Render completion notification for page flips */
+#include "event.h"
+#include <sysconfig.h>
+
 /* Maximum cursor size supported by our HAL: 64x64 in ARGB */
 #define MAX_CURSOR_SIZE (64*64*4)
 
@@ -65,6 +69,8 @@ static int emgd_crtc_mode_set(struct drm_crtc *crtc,
 			      struct drm_framebuffer *old_fb);
 static int emgd_crtc_mode_set_base(struct drm_crtc *crtc, int x, int y,
 		struct drm_framebuffer *old_fb);
+static int emgd_crtc_program_base(struct drm_crtc *crtc, int x, int y,
+		int full);
 static void emgd_crtc_prepare(struct drm_crtc *crtc);
 static void emgd_crtc_commit(struct drm_crtc *crtc);
 
@@ -81,6 +87,7 @@ static void emgd_crtc_gamma_set(struct drm_crtc *crtc,
 #endif
 		uint32_t size);
 static void emgd_crtc_destroy(struct drm_crtc *crtc);
+static IMG_HANDLE emgd_flip_event_list(void);
 static void emgd_crtc_load_lut(struct drm_crtc *crtc);
 static int emgd_crtc_page_flip(struct drm_crtc *crtc,
 			       struct drm_framebuffer *fb,
@@ -165,6 +172,9 @@ static void emgd_crtc_dpms(struct drm_crtc *crtc, int mode)
 {
 	emgd_crtc_t           *emgd_crtc = NULL;
 	igd_display_pipe_t    *pipe = NULL;
+	drm_emgd_priv_t       *devpriv = crtc->dev->dev_private;
+	igd_context_t         *context = devpriv->context;
+	unsigned long          flags;
 
 	EMGD_TRACE_ENTER;
 
@@ -194,6 +204,15 @@ static void emgd_crtc_dpms(struct drm_crtc *crtc, int mode)
 				} else {
 					EMGD_DEBUG("Calling program pipe");
 					mode_context->kms_dispatch->kms_program_pipe(emgd_crtc);
+
+					/* Palette entries queued while the pipe was off */
+					spin_lock_irqsave(&emgd_crtc->crtc_lock, flags);
+					if (!bitmap_empty(emgd_crtc->lut_dirty, 256)) {
+						context->mod_dispatch.reg_crtc_lut_set(context,
+							emgd_crtc);
+					}
+					spin_unlock_irqrestore(&emgd_crtc->crtc_lock, flags);
+
 					EMGD_DEBUG("Calling program plane");
 					mode_context->kms_dispatch->
 						kms_set_plane_pwr(emgd_crtc, TRUE);
@@ -206,6 +225,17 @@ static void emgd_crtc_dpms(struct drm_crtc *crtc, int mode)
 			case DRM_MODE_DPMS_SUSPEND:
 			case DRM_MODE_DPMS_OFF:
 				if (emgd_crtc->igd_pipe->inuse && crtc->enabled) {
+					/* No vblank will come to write queued palette entries */
+					spin_lock_irqsave(&emgd_crtc->crtc_lock, flags);
+					if (emgd_crtc->lut_pending) {
+						context->mod_dispatch.reg_crtc_lut_set(context,
+							emgd_crtc);
+						emgd_crtc->lut_pending = 0;
+						drm_vblank_put(crtc->dev,
+							(emgd_crtc == devpriv->crtcs[0]) ? 0 : 1);
+					}
+					spin_unlock_irqrestore(&emgd_crtc->crtc_lock, flags);
+
 					EMGD_DEBUG("Calling program plane");
 					mode_context->kms_dispatch->
 						kms_set_plane_pwr(emgd_crtc, FALSE);
@@ -288,6 +318,10 @@ static int emgd_crtc_mode_set(struct drm_crtc *crtc,
 
 	pipe  = emgd_crtc->igd_pipe;
 
+	trace_emgd_mode_set(emgd_crtc->crtc_id, adjusted_mode->crtc_hdisplay,
+		adjusted_mode->crtc_vdisplay, adjusted_mode->vrefresh);
+	EMGD_MMIO_MARK(EMGD_MMIO_MARK_MODE_SET);
+
 
 	if (old_fb) {
 		EMGD_DEBUG("Handling old framebuffer?");
@@ -334,7 +368,7 @@ static int emgd_crtc_mode_set(struct drm_crtc *crtc,
 	}
 
 	/* The code above only sets the CRTC timing, not the plane */
-	emgd_crtc_mode_set_base(crtc, x, y, old_fb);
+	emgd_crtc_program_base(crtc, x, y, TRUE);
 
 
 	EMGD_TRACE_EXIT;
@@ -357,11 +391,37 @@ static int emgd_crtc_mode_set(struct drm_crtc *crtc,
  */
 static int emgd_crtc_mode_set_base(struct drm_crtc *crtc, int x, int y,
 		struct drm_framebuffer *old_fb)
+{
+	EMGD_MMIO_MARK(EMGD_MMIO_MARK_PAN);
+
+	return emgd_crtc_program_base(crtc, x, y, FALSE);
+}
+
+
+
+/**
+ * emgd_crtc_program_base
+ *
+ * Points the CRTC's plane at its framebuffer, starting at (x, y).
+ *
+ * @param crtc (IN) CRTC to configure
+ * @param x    (IN) starting X position in the frame buffer
+ * @param y    (IN) starting Y position in the frame buffer
+ * @param full (IN) TRUE to reprogram the whole plane, as after a mode
+ *                  set; FALSE lets a pan or same-layout buffer change
+ *                  update only the plane's offsets (waiting for them to
+ *                  latch before returning)
+ *
+ * @return 0
+ */
+static int emgd_crtc_program_base(struct drm_crtc *crtc, int x, int y,
+		int full)
 {
 	emgd_crtc_t *emgd_crtc = NULL;
 	igd_display_context_t *display = NULL;
 	emgd_framebuffer_t *emgd_fb;
 	igd_framebuffer_info_t *plane_fb_info;
+	igd_framebuffer_info_t fb_info;
 	struct drm_framebuffer *fb = NULL;
 	int ret = 0;
 
@@ -380,27 +440,24 @@ static int emgd_crtc_mode_set_base(struct drm_crtc *crtc, int x, int y,
 	display   = emgd_crtc->igd_pipe->owner;
 
 
-	if (old_fb) {
-		/* We should not need to do anything here. */
-	}
-
 	plane_fb_info = PLANE(display)->fb_info;
+	fb_info       = *plane_fb_info;
 
-	plane_fb_info->width          = fb->width;
-	plane_fb_info->height         = fb->height;
+	fb_info.width          = fb->width;
+	fb_info.height         = fb->height;
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(3,1,0) //TODO: PATCH_PITCHES
-	plane_fb_info->screen_pitch   = fb->DRMFB_PITCH;
+	fb_info.screen_pitch   = fb->DRMFB_PITCH;
 #else
-	plane_fb_info->screen_pitch   = fb->pitches[0];
+	fb_info.screen_pitch   = fb->pitches[0];
 #endif
-	plane_fb_info->flags          = 0;
-	plane_fb_info->allocated      = 1;
-	plane_fb_info->fb_base_offset = emgd_fb->gtt_offset;
+	fb_info.flags          = 0;
+	fb_info.allocated      = 1;
+	fb_info.fb_base_offset = emgd_fb->gtt_offset;
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(3,1,0) //TODO: PATCH_PITCHES
-	plane_fb_info->visible_offset = (y * fb->DRMFB_PITCH) +
+	fb_info.visible_offset = (y * fb->DRMFB_PITCH) +
 		(x * (fb->bits_per_pixel / 8));
 #else
-    plane_fb_info->visible_offset = (y * fb->pitches[0]) +
+	fb_info.visible_offset = (y * fb->pitches[0]) +
 		(x * (fb->bits_per_pixel / 8));
 #endif
 
@@ -408,7 +465,22 @@ static int emgd_crtc_mode_set_base(struct drm_crtc *crtc, int x, int y,
 	PLANE(display)->inuse = 1;
 	PLANE(display)->ref_cnt++;
 
-	mode_context->kms_dispatch->kms_program_plane(emgd_crtc, TRUE);
+	/*
+	 * A pan, or a new buffer laid out like the current one, only needs
+	 * the plane's offset registers; anything else reprograms the plane.
+	 */
+	if (full || !mode_context->kms_dispatch->kms_flip_plane ||
+		mode_context->kms_dispatch->kms_flip_plane(emgd_crtc, &fb_info)) {
+		*plane_fb_info = fb_info;
+		mode_context->kms_dispatch->kms_program_plane(emgd_crtc, TRUE);
+	} else {
+		/*
+		 * The offset write only latches at the next vblank, and the
+		 * caller unpins the old framebuffer as soon as we return, so
+		 * keep scanning it out safely until the new base is live.
+		 */
+		mode_context->dispatch->wait_vblank((igd_display_h)display);
+	}
 
 
 	EMGD_TRACE_EXIT;
@@ -639,6 +711,7 @@ static void emgd_crtc_destroy(struct drm_crtc *crtc)
 	emgd_crtc_t *emgd_crtc = NULL;
 	igd_context_t *context = NULL;
 	igd_display_pipe_t *igd_pipe = NULL;
+	IMG_HANDLE event_list;
 
 	EMGD_TRACE_ENTER;
 
@@ -652,6 +725,27 @@ static void emgd_crtc_destroy(struct drm_crtc *crtc)
 
 	EMGD_DEBUG("\t\tpipe=%d", emgd_crtc->crtc_id);
 
+	/*
+	 * Stop the flip work task before its CRTC goes away.  The task is
+	 * cancelled first so it can't re-arm the waiter once it is disarmed;
+	 * a callback that fired in between may have requeued the task, so
+	 * it is cancelled again.
+	 */
+	cancel_work_sync(&emgd_crtc->flip_work);
+	event_list = emgd_flip_event_list();
+	if (emgd_crtc->flip_waiter && event_list) {
+		LinuxSyncWaiterRemove(event_list, emgd_crtc->flip_waiter);
+		cancel_work_sync(&emgd_crtc->flip_work);
+	}
+	kfree(emgd_crtc->flip_waiter);
+
+	/* Drop the vblank reference held for palette entries still queued */
+	if (emgd_crtc->lut_pending) {
+		emgd_crtc->lut_pending = 0;
+		drm_vblank_put(crtc->dev,
+			(emgd_crtc == ((drm_emgd_priv_t *)crtc->dev->dev_private)->crtcs[0]) ? 0 : 1);
+	}
+
 	drm_crtc_cleanup(crtc);
 
 	/* Free our private crtc structure */
@@ -669,6 +763,9 @@ static void emgd_crtc_load_lut(struct drm_crtc *crtc)
 {
 	emgd_crtc_t *emgd_crtc = NULL;
 	igd_context_t *context = NULL;
+	drm_emgd_priv_t *devpriv = NULL;
+	unsigned long value, flags;
+	int i, changed = 0;
 
 	EMGD_TRACE_ENTER;
 
@@ -677,39 +774,89 @@ static void emgd_crtc_load_lut(struct drm_crtc *crtc)
 		EMGD_ERROR("\t\tpipe %d is not available", emgd_crtc->crtc_id);
 		return;
 	}
-	context = ((drm_emgd_priv_t *)crtc->dev->dev_private)->context;
+	devpriv = (drm_emgd_priv_t *)crtc->dev->dev_private;
+	context = devpriv->context;
 	EMGD_DEBUG("\t\tpipe=%d", emgd_crtc->crtc_id);
-	/* Call into hal function to set color map. */
-	context->mod_dispatch.reg_crtc_lut_set(context, emgd_crtc);
+
+	spin_lock_irqsave(&emgd_crtc->crtc_lock, flags);
+
+	/* Queue only the entries that differ from what the palette holds */
+	for (i = 0; i < 256; i++) {
+		value = (emgd_crtc->lut_r[i] << 16) | (emgd_crtc->lut_g[i] << 8) |
+			emgd_crtc->lut_b[i];
+		if (!emgd_crtc->lut_valid || value != emgd_crtc->lut_hw[i]) {
+			emgd_crtc->lut_hw[i] = value;
+			__set_bit(i, emgd_crtc->lut_dirty);
+			changed = 1;
+		}
+	}
+	emgd_crtc->lut_valid = 1;
+
+	/*
+	 * Leave the writes to the vblank handler, so the palette doesn't
+	 * change mid-frame and several updates in one frame are written
+	 * once.  If vblank interrupts can't be had, write them now; the hal
+	 * function skips a disabled pipe and the entries stay queued for
+	 * when it is enabled.
+	 */
+	if (changed && !emgd_crtc->lut_pending) {
+		if (crtc->enabled && !drm_vblank_get(crtc->dev,
+				(emgd_crtc == devpriv->crtcs[0]) ? 0 : 1)) {
+			emgd_crtc->lut_pending = 1;
+		} else {
+			context->mod_dispatch.reg_crtc_lut_set(context, emgd_crtc);
+		}
+	}
+
+	spin_unlock_irqrestore(&emgd_crtc->crtc_lock, flags);
 
 	EMGD_TRACE_EXIT;
 }
 
 
+/*
+ * emgd_flip_send_event()
+ *
+ * Sends a flip's completion event to userspace.  sequence is the vblank
+ * at which the flip reached the screen (or, for a flip that was dropped,
+ * the last vblank before it was).  Called with crtc_lock held.
+ */
+static void emgd_flip_send_event(struct drm_device *dev,
+		struct drm_pending_vblank_event *e, unsigned int sequence)
+{
+	struct timeval now;
+
+	do_gettimeofday(&now);
+	e->event.sequence = sequence;
+	e->event.tv_sec = now.tv_sec;
+	e->event.tv_usec = now.tv_usec;
+
+	spin_lock(&dev->event_lock);
+	list_add_tail(&e->base.link, &e->base.file_priv->event_list);
+	wake_up_interruptible(&e->base.file_priv->event_wait);
+	spin_unlock(&dev->event_lock);
+}
+
+
 /*
  * crtc_pageflip_handler()
  *
  * VBlank handler to be called when a pageflip is complete.  This will send
- * the vblank event to userspace.
+ * the vblank event to userspace and, if more flips are queued, wake the
+ * work task to program the next one.
  *
  * State upon entry (assuming vblank_expected is set):
- *  * newfb is non-NULL
- *  * flip_event is non-NULL
- *  * flip_work_queued is FALSE
+ *  * flip_latched holds the flip that just reached the screen
  *  * vblank_expected is TRUE (based on assumption)
  *
  * State upon exit (assuming entered with vblank_expected):
- *  * newfb is NULL
- *  * flip_event is NULL
- *  * flip_work_queued is FALSE
+ *  * flip_latched is empty
  *  * vblank_expected is FALSE
  */
 int crtc_pageflip_handler(struct drm_device *dev, int port_num)
 {
 	drm_emgd_priv_t *devpriv = dev->dev_private;
 	emgd_crtc_t *emgd_crtc;
-	struct drm_pending_vblank_event *e;
-	struct timeval now;
 	igd_context_t *context = NULL;
 	int crtcnum;
 	unsigned long flags;
@@ -753,6 +900,13 @@ int crtc_pageflip_handler(struct drm_device *dev, int port_num)
 	/* Protect access to CRTC */
 	spin_lock_irqsave(&emgd_crtc->crtc_lock, flags);
 
+	/* Write the palette entries queued by emgd_crtc_load_lut() */
+	if (emgd_crtc->lut_pending) {
+		context->mod_dispatch.reg_crtc_lut_set(context, emgd_crtc);
+		emgd_crtc->lut_pending = 0;
+		drm_vblank_put(dev, crtcnum);
+	}
+
 	/*
 	 * Were we waiting for a vblank to do flip cleanup?  If not, we
 	 * should just bail out.
@@ -762,42 +916,26 @@ int crtc_pageflip_handler(struct drm_device *dev, int port_num)
 		return 1;
 	}
 
-	/* Sanity check: shouldn't be here if we still have flip work queued */
-	if (emgd_crtc->flip_work_queued) {
-		EMGD_ERROR("Flip vblank handler while work queued!");
-		spin_unlock_irqrestore(&emgd_crtc->crtc_lock, flags);
-		return 0;
-	}
-
 	/*
-	 * Sanity check: shouldn't be possible to get to this point without a
-	 * userspace event to send.
+	 * Flip is now complete; send userspace event, if requested.  This
+	 * runs before drm_handle_vblank() counts the vblank, so the vblank
+	 * the flip completed on is the next count.
 	 */
-	if (!emgd_crtc->flip_event) {
-		EMGD_ERROR("Pageflip vblank handler has no userspace event");
-		spin_unlock_irqrestore(&emgd_crtc->crtc_lock, flags);
-		return 1;
+	if (emgd_crtc->flip_latched.event) {
+		emgd_flip_send_event(dev, emgd_crtc->flip_latched.event,
+			drm_vblank_count(dev, crtcnum) + 1);
 	}
 
 	/* Release vblank refcount */
 	drm_vblank_put(dev, crtcnum);
 	emgd_crtc->vblank_expected = 0;
+	emgd_crtc->flip_latched.fb = NULL;
+	emgd_crtc->flip_latched.event = NULL;
 
-	/* Flip is now complete; send userspace event, if requested */
-	e = emgd_crtc->flip_event;
-	do_gettimeofday(&now);
-	e->event.sequence = 0;
-	e->event.tv_sec = now.tv_sec;
-	e->event.tv_usec = now.tv_usec;
-	list_add_tail(&e->base.link, &e->base.file_priv->event_list);
-	wake_up_interruptible(&e->base.file_priv->event_wait);
-
-	/*
-	 * Cleanup; not in process of switching to new FB, no outstanding
-	 * userspace event awaiting our attention.
-	 */
-	emgd_crtc->newfb = NULL;
-	emgd_crtc->flip_event = NULL;
+	/* The next queued flip can be programmed now */
+	if (emgd_crtc->flip_count) {
+		schedule_work(&emgd_crtc->flip_work);
+	}
 
 	spin_unlock_irqrestore(&emgd_crtc->crtc_lock, flags);
 
@@ -806,142 +944,195 @@ int crtc_pageflip_handler(struct drm_device *dev, int port_num)
 }
 
 
+/*
+ * emgd_flip_render_done()
+ *
+ * Sync waiter callback, called from the PVR MISR once the rendering the
+ * head flip waits for has completed.
+ */
+static void emgd_flip_render_done(PVRSRV_LINUX_SYNC_WAITER *waiter)
+{
+	emgd_crtc_t *crtc = (emgd_crtc_t *)waiter->pvData;
+
+	schedule_work(&crtc->flip_work);
+}
+
+
+/*
+ * emgd_flip_event_list()
+ *
+ * Returns the PVR global event object list, which the PVR MISR signals
+ * whenever sync operations complete, or NULL if services isn't up.
+ */
+static IMG_HANDLE emgd_flip_event_list(void)
+{
+	SYS_DATA *sys_data;
+
+	if (SysAcquireData(&sys_data) != PVRSRV_OK ||
+		!sys_data->psGlobalEventObject) {
+		return NULL;
+	}
+
+	return sys_data->psGlobalEventObject->hOSEventKM;
+}
+
+
 /**
  * emgd_flip_worker
  *
- * Workqueue task to schedule a flip when rendering to the new framebuffer
- * is complete.  Should check the "cancel" flag and just give up,
- * regardless of whether rendering is complete or not if set.
+ * Workqueue task to program the flip at the head of the CRTC's flip queue
+ * when rendering to its framebuffer is complete.  Nothing is programmed
+ * while a previous flip is still waiting for its vblank, since it would
+ * then never reach the screen; the vblank handler requeues this task.
+ * If rendering isn't complete, a sync waiter is armed to requeue it.
  *
  * State upon entry:
- *  * newfb is non-NULL
- *  * no constraint on flip_event
- *  * flip_work_queued is TRUE
- *  * vblank_expected is FALSE
+ *  * no constraint on flip_count
+ *  * no constraint on vblank_expected
  *
  * State upon exit:
- *  * no constraint on newfb
- *  * no constraint on flip_event
- *  * no constraint on flip_work_queued
- *  * no constraint on vblank_expected
+ *  * if a flip was programmed, flip_latched holds it, it is gone from
+ *    flip_queue and vblank_expected is TRUE
  */
 void emgd_flip_worker(struct work_struct *w)
 {
 	drm_emgd_priv_t *dev_priv;
 	igd_context_t *igd_context;
 	PVRSRV_KERNEL_MEM_INFO *meminfo;
-	PVRSRV_SYNC_DATA *syncdata = NULL;
+	PVRSRV_LINUX_SYNC_WAITER *waiter;
+	IMG_HANDLE event_list;
 	emgd_crtc_t *crtc;
+	emgd_flip_t *flip;
 	igd_surface_t igd_surface = { 0 };
+	igd_framebuffer_info_t fb_info;
+	igd_display_context_t *display;
 	unsigned long flags;
 	unsigned int crtcnum;
-	int ret;
 
 	/* Which CRTC does this work task belong to? */
 	crtc = container_of(w, emgd_crtc_t, flip_work);
+	dev_priv = (drm_emgd_priv_t *) crtc->base.dev->dev_private;
+	igd_context = dev_priv->context;
+	crtcnum = (crtc == dev_priv->crtcs[0]) ? 0 : 1;
+	event_list = emgd_flip_event_list();
+
+	/* Only this task sets up the waiter; it is freed with the CRTC */
+	if (!crtc->flip_waiter) {
+		waiter = kzalloc(sizeof(*waiter), GFP_KERNEL);
+		if (waiter) {
+			LinuxSyncWaiterInit(waiter);
+			waiter->pfnCallback = emgd_flip_render_done;
+			waiter->pvData = crtc;
+			crtc->flip_waiter = waiter;
+		}
+	}
+	waiter = crtc->flip_waiter;
 
 	/* Protect updates to the CRTC structure */
 	spin_lock_irqsave(&crtc->crtc_lock, flags);
 
-	/* Sanity check:  flip_work_queued must be TRUE */
-	if (!crtc->flip_work_queued) {
-		EMGD_ERROR("Flip worker running without being queued");
-		spin_unlock_irqrestore(&crtc->crtc_lock, flags);
-		return;
-	}
-
-	/* Sanity check:  newfb must not be NULL */
-	if (!crtc->newfb) {
-		EMGD_ERROR("No newfb in flip worker");
-		spin_unlock_irqrestore(&crtc->crtc_lock, flags);
-		return;
-	}
-
 	/*
-	 * Sanity check: we shouldn't be expecting vblank/cleanup while we're
-	 * still doing flip work (prior flips that may have scheduled a vblank
-	 * were cancelled already.
+	 * Nothing queued, or the previous flip hasn't reached the screen yet
+	 * (the vblank handler requeues us once it has).
 	 */
-	if (crtc->vblank_expected) {
-		EMGD_ERROR("Expecting vblank cleanup while flip work in progress");
+	if (!crtc->flip_count || crtc->vblank_expected) {
 		spin_unlock_irqrestore(&crtc->crtc_lock, flags);
 		return;
 	}
 
-	/*
-	 * Grab the PVR meminfo and syncinfo for the surface we're waiting for
-	 * rendering completion on.
-	 */
-	if (crtc->newfb->type == PVR_FRAMEBUFFER) {
-		meminfo = (PVRSRV_KERNEL_MEM_INFO *)crtc->newfb->pvr_meminfo;
-		syncdata = meminfo->psKernelSyncInfo->psSyncData;
-	}
+	flip = &crtc->flip_queue[crtc->flip_head];
 
 	/*
 	 * Have we completed all the operations that were pending when the flip
-	 * ioctl was called?  If so, proceed with issuing the actual flip.  If
-	 * we're flipping to a GMM framebuffer (i.e., the initial system fb),
-	 * then we don't need to wait for any kind of rendering).
-	 *
-	 * It seems like we should test for wraparound here, but I don't see
-	 * anywhere in PVR's code where they handle wraparound.  It's probably safe
-	 * to ignore for now since even if we perform 60 ops per second against the
-	 * framebuffer, it would still take over two years to overflow the 32-bit
-	 * unsigned int for the operation counter.
+	 * ioctl was called?  If not, wait for the PVR MISR to tell us they
+	 * have.  The head may have been replaced since the waiter was armed,
+	 * so it is always re-armed for the current one.  If we're flipping to
+	 * a GMM framebuffer (i.e., the initial system fb), then we don't need
+	 * to wait for any kind of rendering.
 	 */
-	if (crtc->newfb->type == GMM_FRAMEBUFFER ||
-		syncdata->ui32WriteOpsComplete >= crtc->render_complete_at)
-	{
-		dev_priv = (drm_emgd_priv_t *) crtc->base.dev->dev_private;
-		igd_context = dev_priv->context;
-		crtcnum = (crtc == dev_priv->crtcs[0]) ? 0 : 1;
-
-		/* Rendering complete; program the plane registers */
-		igd_surface.flags        = IGD_SURFACE_DISPLAY;
-		igd_surface.offset       = crtc->newfb->gtt_offset;
+	if (flip->fb->type == PVR_FRAMEBUFFER) {
+		meminfo = (PVRSRV_KERNEL_MEM_INFO *)flip->fb->pvr_meminfo;
+
+		if (!waiter || !event_list) {
+			/* No way to be told; poll as a last resort */
+			if ((int)(meminfo->psKernelSyncInfo->psSyncData->
+				ui32WriteOpsComplete - flip->render_complete_at) < 0) {
+				schedule_work(w);
+				spin_unlock_irqrestore(&crtc->crtc_lock, flags);
+				return;
+			}
+		} else {
+			LinuxSyncWaiterRemove(event_list, waiter);
+			waiter->psSyncInfo = meminfo->psKernelSyncInfo;
+			waiter->ui32WriteOpsTarget = flip->render_complete_at;
+			if (LinuxSyncWaiterAdd(event_list, waiter)) {
+				spin_unlock_irqrestore(&crtc->crtc_lock, flags);
+				return;
+			}
+		}
+	}
+
+	/* Rendering complete; program the plane registers */
+	EMGD_MMIO_MARK(EMGD_MMIO_MARK_FLIP);
+	igd_surface.flags        = IGD_SURFACE_DISPLAY;
+	igd_surface.offset       = flip->fb->gtt_offset;
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(3,1,0) //TODO: PATCH_PITCHES
-		igd_surface.pitch        = crtc->newfb->base.DRMFB_PITCH;
+	igd_surface.pitch        = flip->fb->base.DRMFB_PITCH;
 #else
-		igd_surface.pitch        = crtc->newfb->base.pitches[0];
+	igd_surface.pitch        = flip->fb->base.pitches[0];
 #endif
-		igd_surface.width        = crtc->newfb->base.width;
-		igd_surface.height       = crtc->newfb->base.height;
-		igd_surface.pixel_format = IGD_PF_ARGB32;
-
+	igd_surface.width        = flip->fb->base.width;
+	igd_surface.height       = flip->fb->base.height;
+	igd_surface.pixel_format = IGD_PF_ARGB32;
+
+	/* Same buffer layout as on screen: just retarget the plane */
+	display = crtc->igd_pipe->owner;
+	fb_info = *PLANE(display)->fb_info;
+	fb_info.fb_base_offset = igd_surface.offset;
+	fb_info.screen_pitch   = igd_surface.pitch;
+	fb_info.width          = igd_surface.width;
+	fb_info.height         = igd_surface.height;
+	fb_info.pixel_format   = igd_surface.pixel_format;
+	fb_info.flags          = igd_surface.flags;
+	fb_info.visible_offset =
+		(PORT_OWNER(display)->pt_info->y_offset * igd_surface.pitch) +
+		(PORT_OWNER(display)->pt_info->x_offset *
+			IGD_PF_BYPP(igd_surface.pixel_format));
+
+	if (!mode_context->kms_dispatch->kms_flip_plane ||
+		mode_context->kms_dispatch->kms_flip_plane(crtc, &fb_info)) {
 		igd_context->dispatch.set_surface(
-			crtc->igd_pipe->owner,
+			display,
 			IGD_PRIORITY_NORMAL,
 			IGD_BUFFER_DISPLAY,
 			&igd_surface,
 			NULL, /* Not used */
 			0);
+	}
 
-		/* Flip issued.  No need to requeue the work. */
-		crtc->flip_work_queued = 0;
-
-		/*
-		 * If a userspace event was requested for this flip, request vblank
-		 * interrupts if they aren't already on.
-		 */
-		if (crtc->flip_event) {
-			/* Request vblank events (or inc the refcount if they're already on) */
-			ret = drm_vblank_get(crtc->base.dev, crtcnum);
-			if (ret) {
-				EMGD_ERROR("Failed enable vblanks");
-				return;
-			}
-			crtc->vblank_expected = 1;
-		} else {
-			/*
-			 * No userspace event; the flip is complete as far as we're
-			 * concerned.  Clear the "in progress of switching to fb" field.
-			 */
-			crtc->newfb = NULL;
-		}
+	/* Flip issued; move it from the queue to the latched slot */
+	crtc->flip_latched = *flip;
+	crtc->flip_head = (crtc->flip_head + 1) % EMGD_FLIP_QUEUE_MAX;
+	crtc->flip_count--;
 
+	/*
+	 * Request vblank events (or inc the refcount if they're already on) so
+	 * the vblank handler completes the flip.  Without them the flip is
+	 * completed now and the next one may follow immediately.
+	 */
+	if (drm_vblank_get(crtc->base.dev, crtcnum) == 0) {
+		crtc->vblank_expected = 1;
 	} else {
-		/* Rendering not complete.  Requeue the work task. */
-		schedule_work(w);
+		EMGD_ERROR("Failed enable vblanks");
+		if (crtc->flip_latched.event) {
+			emgd_flip_send_event(crtc->base.dev, crtc->flip_latched.event,
+				drm_vblank_count(crtc->base.dev, crtcnum));
+		}
+		crtc->flip_latched.fb = NULL;
+		crtc->flip_latched.event = NULL;
+		if (crtc->flip_count) {
+			schedule_work(w);
+		}
 	}
 
 	spin_unlock_irqrestore(&crtc->crtc_lock, flags);
@@ -951,29 +1142,31 @@ void emgd_flip_worker(struct work_struct *w)
 /**
  * emgd_crtc_page_flip
  *
- * Page flip ioctl handler.  The ioctl simply dispatches a workqueue task
- * which will wait until current rendering against the new framebuffer
- * is complete, then issue the actual flip.  This ioctl should return
- * immediately, allowing pipelining of subsequent CPU execution with
+ * Page flip ioctl handler.  The ioctl queues the flip and dispatches a
+ * workqueue task which will wait until current rendering against the new
+ * framebuffer is complete, then issue the actual flip.  This ioctl should
+ * return immediately, allowing pipelining of subsequent CPU execution with
  * the outstanding rendering happening against this framebuffer.
  *
+ * Flips are queued in order, up to the flip_queue_depth module parameter;
+ * once that many are waiting, further flips fail with -EBUSY.  On a CRTC
+ * set in the flip_mailbox module parameter, a flip instead replaces the
+ * newest queued flip, whose event is sent back right away since it will
+ * never be displayed.  Flips still only happen at vblank either way.
+ *
  * @param crtc  (INOUT) The pipe to put the new framebuffer on
  * @param fb    (IN)    Framebuffer to flip to
  * @param event (IN)    Event to signal when flip has been completed
  *
- * @return
+ * @return 0 on success, -EBUSY if the flip queue is full
  *
  * State upon entry:
- *  * No constraint on newfb
- *  * No constraint on flip_event
- *  * No constraint on flip_work_queued
+ *  * No constraint on flip_count
  *  * No constraint on vblank_expected
  *
  * State upon exit:
- *  * newfb is non-NULL
- *  * no constraint on flip_event
- *  * flip_work_queued is TRUE
- *  * vblank_expected is FALSE
+ *  * flip_count is non-zero
+ *  * no constraint on vblank_expected
  */
 static int emgd_crtc_page_flip(struct drm_crtc *crtc,
 			       struct drm_framebuffer *fb,
@@ -987,83 +1180,97 @@ static int emgd_crtc_page_flip(struct drm_crtc *crtc,
 	emgd_crtc_t        *emgd_crtc;
 	emgd_framebuffer_t *emgd_fb;
 	drm_emgd_priv_t    *dev_priv;
-	igd_context_t      *igd_context;
+	emgd_flip_t        *flip;
 	unsigned int crtcnum;
+	unsigned int depth;
 	unsigned long flags;
-	struct drm_pending_vblank_event *e;
-	struct timeval now;
+	int latest_wins;
 	PVRSRV_KERNEL_MEM_INFO *meminfo;
 	PVRSRV_SYNC_DATA *syncdata;
+	IMG_HANDLE event_list;
 
 	EMGD_TRACE_ENTER;
 
 	emgd_crtc   = container_of(crtc, emgd_crtc_t, base);
 	dev_priv    = (drm_emgd_priv_t *) crtc->dev->dev_private;
-	igd_context = dev_priv->context;
 	emgd_fb     = container_of(fb, emgd_framebuffer_t, base);
 	crtcnum = (emgd_crtc == dev_priv->crtcs[0]) ? 0 : 1;
 
+	latest_wins = drm_emgd_flip_mailbox[crtcnum] != 0;
+
+	depth = drm_emgd_flip_queue_depth;
+	if (depth < 1) {
+		depth = 1;
+	} else if (depth > EMGD_FLIP_QUEUE_MAX) {
+		depth = EMGD_FLIP_QUEUE_MAX;
+	}
+
+	trace_emgd_flip(crtcnum, emgd_fb->gtt_offset);
+
 	/*
 	 * Protect updates to the CRTC structure. We don't want this code to
 	 * overlap with either the workqueue task or the vblank handler.
 	 */
 	spin_lock_irqsave(&emgd_crtc->crtc_lock, flags);
 
-	/*
-	 * Was there a pending userspace event for a previous flip request?  If
-	 * so, just send the completion back now.  We're essentially cancelling
-	 * the previous flip (it will never show up on the display), but we don't
-	 * want userspace to get confused by not receiving notification.  We'll
-	 * also decrement our vblank request if we'd already scheduled on for
-	 * cleanup.
-	 */
-	if ((e = emgd_crtc->flip_event) != NULL) {
-		do_gettimeofday(&now);
-		e->event.sequence = 0;
-		e->event.tv_sec = now.tv_sec;
-		e->event.tv_usec = now.tv_usec;
-		list_add_tail(&e->base.link, &e->base.file_priv->event_list);
-		wake_up_interruptible(&e->base.file_priv->event_wait);
-		emgd_crtc->flip_event = NULL;
+	if (latest_wins && emgd_crtc->flip_count) {
+		/*
+		 * Take the place of the newest queued flip.  It will never show
+		 * up on the display, but we don't want userspace to get confused
+		 * by not receiving notification.
+		 */
+		flip = &emgd_crtc->flip_queue[(emgd_crtc->flip_head +
+			emgd_crtc->flip_count - 1) % EMGD_FLIP_QUEUE_MAX];
 
 		/*
-		 * If the work task had completed and actually programmed the
-		 * registers, it had also requested a vblank callback.  Cancel
-		 * that as well since we've already taken care of the necessary
-		 * cleanup.  Note that vblanks are only requested when we actually
-		 * have a userspace event to send back.
+		 * The waiter may be armed on the replaced flip's framebuffer.
+		 * Disarm it before the flip's event releases that framebuffer
+		 * to userspace; the work task scheduled below re-arms it for
+		 * the new head.
 		 */
-		if (emgd_crtc->vblank_expected) {
-			drm_vblank_put(crtc->dev, crtcnum);
-			emgd_crtc->vblank_expected = 0;
+		event_list = emgd_flip_event_list();
+		if (emgd_crtc->flip_waiter && event_list) {
+			LinuxSyncWaiterRemove(event_list, emgd_crtc->flip_waiter);
+		}
+
+		if (flip->event) {
+			emgd_flip_send_event(crtc->dev, flip->event,
+				drm_vblank_count(crtc->dev, crtcnum));
 		}
+	} else if (emgd_crtc->flip_count >= depth) {
+		spin_unlock_irqrestore(&emgd_crtc->crtc_lock, flags);
+		EMGD_DEBUG("Flip queue full");
+		return -EBUSY;
+	} else {
+		flip = &emgd_crtc->flip_queue[(emgd_crtc->flip_head +
+			emgd_crtc->flip_count) % EMGD_FLIP_QUEUE_MAX];
+		emgd_crtc->flip_count++;
 	}
 
-	/* Update the CRTC's "target framebuffer" field. */
-	emgd_crtc->newfb = emgd_fb;
-	emgd_crtc->flip_event = event;
+	flip->fb = emgd_fb;
+	flip->event = event;
 
 	/*
 	 * Set the number of rendering operations that need to complete before we
 	 * can flip to this buffer.  I.e., we don't need render to completely
 	 * quiesce, we can flip as soon as any operations that are outstanding
 	 * right now complete, even if more rendering ops get added to the pipeline
-	 * after we return.
+	 * after we return.  GMM framebuffers (the initial system fb) have no
+	 * PVR sync data and never wait.
 	 */
-	meminfo = (PVRSRV_KERNEL_MEM_INFO *)emgd_fb->pvr_meminfo;
-	syncdata = meminfo->psKernelSyncInfo->psSyncData;
-	emgd_crtc->render_complete_at = syncdata->ui32WriteOpsPending;
+	if (emgd_fb->type == PVR_FRAMEBUFFER) {
+		meminfo = (PVRSRV_KERNEL_MEM_INFO *)emgd_fb->pvr_meminfo;
+		syncdata = meminfo->psKernelSyncInfo->psSyncData;
+		flip->render_complete_at = syncdata->ui32WriteOpsPending;
+	} else {
+		flip->render_complete_at = 0;
+	}
 
 	/*
-	 * If work is already scheduled, nothing more to do here; the
-	 * already-scheduled work will see the new values we set next time it wakes
-	 * up and will act upon them.  However if work is not scheduled, then
-	 * we need to schedule it now.
+	 * Let the work task look at the head of the queue.  If it is already
+	 * scheduled this does nothing; it will see the new entry when it runs.
 	 */
-	if (!emgd_crtc->flip_work_queued) {
-		schedule_work(&emgd_crtc->flip_work);
-		emgd_crtc->flip_work_queued = 1;
-	}
+	schedule_work(&emgd_crtc->flip_work);
 
 	/* Move the FB currently associated with the CRTC to the new FB */
 
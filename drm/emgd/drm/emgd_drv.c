@@ -50,6 +50,7 @@
 #include "igd_debug.h"
 #include "splash_screen.h"
 #include "msvdx.h"
+#include "emgd_vtnc.h"
 /*
  * Imagination includes.
  */
@@ -77,6 +78,7 @@ extern int emgd_bc_ts_uninit(void);
 extern void emgd_set_real_handle(igd_driver_h drm_handle);
 extern void emgd_set_real_dispatch(igd_dispatch_t *drm_dispatch);
 extern void emgd_modeset_init(struct drm_device *dev);
+extern void emgd_modeset_late_outputs(struct drm_device *dev);
 extern void emgd_modeset_destroy(struct drm_device *dev);
 extern int  msvdx_pre_init_plb(struct drm_device *dev);
 extern int msvdx_shutdown_plb(igd_context_t *context);
@@ -212,6 +214,16 @@ module_param_named(width, drm_emgd_width, int, 0600);
 module_param_named(height, drm_emgd_height, int, 0600);
 module_param_named(refresh, drm_emgd_refresh, int, 0600);
 
+int drm_emgd_flip_queue_depth = 2;
+MODULE_PARM_DESC(flip_queue_depth, "Page flips each CRTC queues behind the one "
+	"being displayed before further flips fail with EBUSY (1-4)");
+module_param_named(flip_queue_depth, drm_emgd_flip_queue_depth, int, 0600);
+
+int drm_emgd_flip_mailbox[2] = { 0, 0 };
+MODULE_PARM_DESC(flip_mailbox, "Per CRTC: 0 queues page flips in order, 1 lets "
+	"each flip replace the newest queued one (e.g. \"0,1\")");
+module_param_array_named(flip_mailbox, drm_emgd_flip_mailbox, int, NULL, 0600);
+
 
 /** The DC to use when the DRM module [re-]initializes the display. */
 static unsigned long *desired_dc = NULL;
@@ -262,7 +274,16 @@ os_allocd_mem *list_tail = NULL;
     {0x8086, 0x4108, PCI_ANY_ID, PCI_ANY_ID, 0, 0, CHIP_TC_4108}, \
     {0, 0, 0}
 
+#ifdef EMGD_VIRTUAL_TNC
+#define emgd_VTNC_PCI_IDS \
+	{EMGD_VTNC_PCI_VENDOR, EMGD_VTNC_PCI_DEVICE, PCI_ANY_ID, PCI_ANY_ID, \
+		0, 0, EMGD_VTNC_CHIP},
+#else
+#define emgd_VTNC_PCI_IDS
+#endif
+
 static struct pci_device_id pciidlist[] = {
+	    emgd_VTNC_PCI_IDS
 	    emgd_PCI_IDS
 };
 
@@ -1412,6 +1433,20 @@ int emgd_driver_load(struct drm_device *dev, unsigned long flags)
 
 	mutex_lock(&dev->struct_mutex);
 
+#ifdef EMGD_MMIO_RECORD
+	/* Start recording before the HAL touches any registers */
+	emgd_mmio_init();
+#endif
+#ifdef EMGD_VIRTUAL_TNC
+	if (emgd_vtnc) {
+		err = emgd_vtnc_init(dev->pdev);
+		if (err) {
+			mutex_unlock(&dev->struct_mutex);
+			return err;
+		}
+	}
+#endif
+
 	/**************************************************************************
 	 *
 	 * Get the compile-time/module-parameter "params" before initializing the
@@ -1584,12 +1619,15 @@ int emgd_driver_load(struct drm_device *dev, unsigned long flags)
 	// PVRSRVDrmLoad() sets up an ISR routine with a pointer to drm_device to be passed every time.  This variable (gpDrmDevice) is initialized in msvdx_pre_init_plb only.    
 	// Due to this reason, msvdx_pre_init_plb() is moved before PVRSRVDrmLoad().
 
-	/* Init MSVDX and load firmware */
-	msvdx_pre_init_plb(dev);
+	/* The virtual device has no SGX or MSVDX to run the services on */
+	if (!EMGD_VTNC_ACTIVE) {
+		/* Init MSVDX and load firmware */
+		msvdx_pre_init_plb(dev);
 
-	/* Initialize the PVR services if not already initialized */
-	printk(KERN_INFO "Initializing PVR Services.\n");
-	PVRSRVDrmLoad(dev, 0);
+		/* Initialize the PVR services if not already initialized */
+		printk(KERN_INFO "Initializing PVR Services.\n");
+		PVRSRVDrmLoad(dev, 0);
+	}
 
 	/* Decide if we can defer the rest of the initialization */
 	if (config_drm.init) {
@@ -1615,8 +1653,21 @@ int emgd_driver_load(struct drm_device *dev, unsigned long flags)
 		 */
 		get_pre_driver_info(mode_context);
 
+		/* Without KMS the display configuration has to know every port
+		 * before the display is set up */
+		if (!config_drm.kms) {
+			drm_HAL_context->mod_dispatch.pi_probe_finish(drm_HAL_context);
+		}
+
 		/* Per the user's request, initialize the display: */
 		emgd_init_display(TRUE, priv);
+
+		/* With KMS only the primary port is needed for the splash screen;
+		 * the others are added once their probes finish */
+		if (config_drm.kms &&
+			drm_HAL_context->mod_dispatch.pi_probe_finish(drm_HAL_context)) {
+			emgd_modeset_late_outputs(dev);
+		}
 	}
 
 
@@ -1643,7 +1694,9 @@ int emgd_driver_load(struct drm_device *dev, unsigned long flags)
 #endif	
 	/* can not work out how to start PVRSRV */
 	/* Load Buffer Class Module*/
-	emgd_bc_ts_init();
+	if (!EMGD_VTNC_ACTIVE) {
+		emgd_bc_ts_init();
+	}
 
 	mutex_unlock(&dev->struct_mutex);
 	EMGD_TRACE_EXIT;
@@ -1671,10 +1724,12 @@ int emgd_driver_unload(struct drm_device *dev)
 
 	mutex_lock(&dev->struct_mutex);
 
-	/* Unload Buffer Class Module*/
-	emgd_bc_ts_uninit();
+	if (!EMGD_VTNC_ACTIVE) {
+		/* Unload Buffer Class Module*/
+		emgd_bc_ts_uninit();
 
-	PVRSRVDrmUnload(dev);
+		PVRSRVDrmUnload(dev);
+	}
 
 	/* KMS cleanup */
 	if (config_drm.init && config_drm.kms) {
@@ -1720,6 +1775,13 @@ int emgd_driver_unload(struct drm_device *dev)
 	emgd_report_unfreed_memory();
 #endif
 
+#ifdef EMGD_MMIO_RECORD
+	emgd_mmio_cleanup();
+#endif
+#ifdef EMGD_VIRTUAL_TNC
+	emgd_vtnc_cleanup();
+#endif
+
 	mutex_unlock(&dev->struct_mutex);
 
 	EMGD_TRACE_EXIT;
@@ -1766,6 +1828,9 @@ int emgd_driver_open(struct drm_device *dev, struct drm_file *priv)
 	}
 
 	ret = PVRSRVOpen(dev, priv);
+	if (!ret) {
+		emgd_ioctl_stats_open(priv);
+	}
 
 	mutex_unlock(&dev->struct_mutex);
 
@@ -2010,6 +2075,8 @@ void emgd_driver_preclose(struct drm_device *dev, struct drm_file *priv)
 	 */
 
 	EMGD_TRACE_ENTER;
+	emgd_ioctl_stats_close(priv);
+
 	mutex_lock(&dev->struct_mutex);
 	if ((emgd_priv->hal_running) && priv->is_master && drm_HAL_dispatch) {
 		/* The X server can't call gmm_cache_flush() nor igd_driver_shutdown()
@@ -2544,6 +2611,12 @@ static int __devinit emgd_pci_probe(struct pci_dev *pdev,
 	if (PCI_FUNC(pdev->devfn)) {
 		return -ENODEV;
 	}
+#ifdef EMGD_VIRTUAL_TNC
+	/* Leave the stand-in alone unless the virtual device was asked for */
+	if (ent->driver_data == EMGD_VTNC_CHIP && !emgd_vtnc) {
+		return -ENODEV;
+	}
+#endif
 
 	/*
 	 * Name changed at some point in time.  2.6.35 uses drm_get_dev
@@ -2630,8 +2703,11 @@ static struct pci_driver emgd_pci_driver = EMGD_PCI_DRIVER;
 
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,32)
 #define IOCTL unlocked_ioctl
+/* Count and time every ioctl, see emgd_ioctl_stats.c */
+#define EMGD_IOCTL_ENTRY emgd_ioctl_stats_ioctl
 #else
 #define IOCTL ioctl
+#define EMGD_IOCTL_ENTRY drm_ioctl
 #endif
 
 #if (LINUX_VERSION_CODE < KERNEL_VERSION(3,12,0))
@@ -2639,7 +2715,7 @@ static struct pci_driver emgd_pci_driver = EMGD_PCI_DRIVER;
     .owner   = THIS_MODULE,        \
     .open    = drm_open,           \
     .release = drm_release,        \
-	.IOCTL   = drm_ioctl,		   \
+	.IOCTL   = EMGD_IOCTL_ENTRY,	   \
     .mmap    = emgd_mmap,          \
     .poll    = drm_poll,           \
     .fasync  = drm_fasync,         \
@@ -2650,7 +2726,7 @@ static struct pci_driver emgd_pci_driver = EMGD_PCI_DRIVER;
     .owner   = THIS_MODULE,        \
     .open    = drm_open,           \
     .release = drm_release,        \
-	.IOCTL   = drm_ioctl,		   \
+	.IOCTL   = EMGD_IOCTL_ENTRY,	   \
     .mmap    = emgd_mmap,          \
     .poll    = drm_poll,           \
     .read    = drm_read,           \
@@ -2744,10 +2820,20 @@ static int __init emgd_init(void) {
 
 	PVRDPFInit();
 
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,32)
+	/* Failure only loses the statistics */
+	emgd_ioctl_stats_init(emgd_ioctl, emgd_max_ioctl);
+#endif
+
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,38)
 	ret = drm_pci_init(&driver, &emgd_pci_driver);
 #else
 	ret = drm_init(&driver);
+#endif
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,32)
+	if (ret) {
+		emgd_ioctl_stats_cleanup();
+	}
 #endif
 	printk(KERN_INFO "[EMGD] Driver Initialized.\n");
 	EMGD_TRACE_EXIT;
@@ -2763,6 +2849,9 @@ static void __exit emgd_exit(void) {
 	drm_pci_exit(&driver, &emgd_pci_driver);
 #else
 	drm_exit(&driver);
+#endif
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,32)
+	emgd_ioctl_stats_cleanup();
 #endif
 	EMGD_TRACE_EXIT;
 }
@@ -89,9 +89,20 @@ extern int emgd_driver_suspend(struct drm_device *dev, pm_message_t state);
 extern int emgd_driver_resume(struct drm_device *dev);
 extern int emgd_mmap(struct file *filp, struct vm_area_struct *vma);
 
+/* Ioctl statistics, see emgd_ioctl_stats.c */
+extern int emgd_ioctl_stats_init(struct drm_ioctl_desc *ioctls,
+	unsigned int num_ioctls);
+extern void emgd_ioctl_stats_cleanup(void);
+extern void emgd_ioctl_stats_open(struct drm_file *file);
+extern void emgd_ioctl_stats_close(struct drm_file *file);
+extern long emgd_ioctl_stats_ioctl(struct file *filp, unsigned int cmd,
+	unsigned long arg);
+
 
 /* Module parameters: */
 extern int drm_emgd_configid;
+extern int drm_emgd_flip_queue_depth;
+extern int drm_emgd_flip_mailbox[2];
 
 
 
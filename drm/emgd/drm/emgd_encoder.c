@@ -98,8 +98,7 @@ static void emgd_encoder_dpms(struct drm_encoder *encoder, int mode)
 {
 	emgd_crtc_t *emgd_crtc = container_of(encoder->crtc, emgd_crtc_t, base);
 	emgd_encoder_t *emgd_encoder = container_of(encoder, emgd_encoder_t, base);
-	// TODO: Compiler says it is unused but it is above in EMGD_DEBUG!
-	__attribute__((unused)) igd_display_port_t *igd_port = emgd_encoder->igd_port;
+	igd_display_port_t *igd_port = emgd_encoder->igd_port;
 
 	EMGD_TRACE_ENTER;
 
@@ -114,6 +113,13 @@ static void emgd_encoder_dpms(struct drm_encoder *encoder, int mode)
 		EMGD_DEBUG("Setting port %lx power to %d",
 					igd_port->port_number, mode);
 
+		/*
+		 * Mode sets and DPMS run in process context, so the port driver's
+		 * I2C traffic may sleep.  The exception is the mode set from the
+		 * panic notifier and the console unblank of an oops.
+		 */
+		igd_port->pd_i2c_flags = oops_in_progress ? 0 : IGD_I2C_CAN_SLEEP;
+
 		switch(mode) {
 
 			case DRM_MODE_DPMS_ON:
@@ -131,9 +137,12 @@ static void emgd_encoder_dpms(struct drm_encoder *encoder, int mode)
 				break;
 
 			default:
+			igd_port->pd_i2c_flags = 0;
 			EMGD_ERROR_EXIT("Unsupported DPMS mode");
 			return;
 		}
+
+		igd_port->pd_i2c_flags = 0;
 	}else {
 		EMGD_DEBUG("Owner is null for this pipe");
 	}
@@ -307,13 +307,11 @@ void create_crtcs(struct drm_device *dev)
 
 		/* Initialize workqueue task to wait for render completion on flips */
 		INIT_WORK(&emgd_crtc->flip_work, emgd_flip_worker);
-		emgd_crtc->flip_work_queued = 0;
+		emgd_crtc->flip_waiter = NULL;
 
-		/* Target FB that we're in the process of changing to */
-		emgd_crtc->newfb = NULL;
-
-		/* Target "ops complete" watermark to allow flip to proceed */
-		emgd_crtc->render_complete_at = 0;
+		/* No flips queued */
+		emgd_crtc->flip_head  = 0;
+		emgd_crtc->flip_count = 0;
 
 		/*
 		 * Are we expected to perform flip cleanup (sending userspace event
@@ -321,9 +319,6 @@ void create_crtcs(struct drm_device *dev)
 		 */
 		emgd_crtc->vblank_expected = 0;
 
-		/* Userspace 'flip done' event */
-		emgd_crtc->flip_event = NULL;
-
 		/* TODO: Create connector list */
 		emgd_crtc->mode_set.crtc       = &emgd_crtc->base;
 		emgd_crtc->mode_set.connectors =
@@ -713,10 +708,16 @@ void emgd_setup_outputs(struct drm_device *dev)
 	igd_context_t           *igd_context     = priv->context;
 	inter_module_dispatch_t *module_dispatch = &igd_context->mod_dispatch;
 	igd_display_port_t      *port            = NULL;
-	struct drm_encoder      *encoder;
+	struct drm_encoder      *encoder, *last;
+	int                     found;
 
 	EMGD_TRACE_ENTER;
 
+	/* Encoders from an earlier call are at the head of the list; new ones
+	 * are added after this one */
+	last = list_entry(dev->mode_config.encoder_list.prev,
+		struct drm_encoder, head);
+
 	/* Loop through all available ports.  What KMS calls "encoder" is a
      * subset of what EMGD calls "port."
      */
@@ -724,13 +725,26 @@ void emgd_setup_outputs(struct drm_device *dev)
 
 		/* If there is a port driver, then there's an encoder */
 		if (port->pd_driver) {
-			create_encoder(dev, port);
+			found = 0;
+			list_for_each_entry(encoder, &dev->mode_config.encoder_list,
+				head) {
+				if (container_of(encoder, emgd_encoder_t, base)->igd_port ==
+					port) {
+					found = 1;
+					break;
+				}
+			}
+			if (!found) {
+				create_encoder(dev, port);
+			}
 		}
 	}
 
 
-	/* For each encoder, create the connectors on the encoder */
-	list_for_each_entry(encoder, &dev->mode_config.encoder_list, head) {
+	/* For each new encoder, create the connectors on the encoder */
+	encoder = last;
+	list_for_each_entry_continue(encoder, &dev->mode_config.encoder_list,
+		head) {
 		emgd_encoder_t *emgd_encoder;
 
 		emgd_encoder = container_of(encoder, emgd_encoder_t, base);
@@ -809,6 +823,45 @@ void emgd_modeset_init(struct drm_device *dev)
 
 
 
+/**
+ * emgd_modeset_late_outputs
+ *
+ * Adds the encoders and connectors for ports whose probe finished after
+ * emgd_modeset_init() (see pi_probe_finish()), and tells userspace about
+ * them with a hotplug event.
+ *
+ * @param dev (IN) DRM per-device (e.g. one GMA) struct (in "drmP.h")
+ *
+ * @return None
+ */
+void emgd_modeset_late_outputs(struct drm_device *dev)
+{
+	struct drm_encoder *encoder, *last;
+
+	EMGD_TRACE_ENTER;
+
+	last = list_entry(dev->mode_config.encoder_list.prev,
+		struct drm_encoder, head);
+
+	mutex_lock(&dev->mode_config.mutex);
+	emgd_setup_outputs(dev);
+
+	/* Same as emgd_modeset_init(): off until the first modeset */
+	encoder = last;
+	list_for_each_entry_continue(encoder, &dev->mode_config.encoder_list,
+		head) {
+		struct drm_encoder_helper_funcs *e_funcs = encoder->helper_private;
+		(*e_funcs->dpms)(encoder, DRM_MODE_DPMS_OFF);
+	}
+	mutex_unlock(&dev->mode_config.mutex);
+
+	drm_sysfs_hotplug_event(dev);
+
+	EMGD_TRACE_EXIT;
+}
+
+
+
 /**
  * emgd_modeset_destroy
  *
@@ -551,6 +551,7 @@ static int emgd_fbcon_set_par(struct fb_info *info)
 	struct drm_device *dev;
 	emgd_fbdev_t *emgd_fbdev;
 	emgd_crtc_t *emgd_crtc;
+	emgd_framebuffer_t *emgd_fb;
 	igd_context_t *context;
 	drm_emgd_priv_t *priv;
 	igd_display_pipe_t *pipe;
@@ -588,17 +589,17 @@ static int emgd_fbcon_set_par(struct fb_info *info)
      * and flipping it onto the screen using set_surface.
      * FIXME: Should we also do a modeset to be safe?
      */
-	emgd_crtc->newfb = emgd_fbdev->emgd_fb;
+	emgd_fb = emgd_fbdev->emgd_fb;
 
 	surface.flags        = IGD_SURFACE_DISPLAY;
-    surface.offset       = emgd_crtc->newfb->gtt_offset;
+    surface.offset       = emgd_fb->gtt_offset;
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(3,1,0) //TODO: PATCH_PITCHES
-    surface.pitch        = emgd_crtc->newfb->base.DRMFB_PITCH;
+    surface.pitch        = emgd_fb->base.DRMFB_PITCH;
 #else
-    surface.pitch        = emgd_crtc->newfb->base.pitches[0];
+    surface.pitch        = emgd_fb->base.pitches[0];
 #endif
-    surface.width        = emgd_crtc->newfb->base.width;
-    surface.height       = emgd_crtc->newfb->base.height;
+    surface.width        = emgd_fb->base.width;
+    surface.height       = emgd_fb->base.height;
     surface.pixel_format = IGD_PF_ARGB32;
 
     ret = context->dispatch.set_surface(pipe->owner, IGD_PRIORITY_NORMAL,
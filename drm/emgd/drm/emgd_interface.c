@@ -1965,6 +1965,9 @@ int emgd_driver_pre_init(struct drm_device *dev, void *arg,
 	context = (igd_context_t *) handle;
 	context->mod_dispatch.init_params = x_params;
 
+	/* X is given every port, so wait for any still being probed */
+	context->mod_dispatch.pi_probe_finish(context);
+
 	if (config_drm.init) {
 		if (config_drm.kms) {
 			save_flags = (IGD_REG_SAVE_ALL & ~IGD_REG_SAVE_GTT)| IGD_REG_SAVE_TYPE_REG;
@@ -0,0 +1,424 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: emgd_ioctl_stats.c
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Call counts, error counts and latency histograms for the EMGD DRM
+ *  ioctls. The DRM file's ioctl entry point is wrapped, so the time
+ *  measured is what the caller sees, including argument copies. Driver
+ *  ioctls are counted per ioctl and per process; core DRM ioctls are
+ *  only counted per process. A call is counted against the process that
+ *  opened the DRM file, which differs from the caller only after a
+ *  fork(). An error is a negative return code; HAL status reported
+ *  through an argument's rtn field is not counted.
+ *
+ *  The per ioctl counters are per-CPU, so this stays enabled in
+ *  production. Everything is exported through debugfs:
+ *
+ *   emgd_ioctl/enable  - 0/1, collection on or off (on by default)
+ *   emgd_ioctl/stats   - per ioctl counters and latency histogram
+ *   emgd_ioctl/procs   - per process counters; (others) also holds the
+ *                        counts of processes that have closed the device
+ *   emgd_ioctl/reset   - any write zeroes all counters
+ *
+ *  Histogram bucket n counts calls that took under 2^n us (bucket 0 is
+ *  under 1us); the last bucket also holds anything slower. A microsecond
+ *  here is 1024ns.
+ *-----------------------------------------------------------------------------
+ */
+
+#define MODULE_NAME hal.oal
+
+#include <drm/drmP.h>
+#include <linux/version.h>
+#include <linux/module.h>
+#include <linux/percpu.h>
+#include <linux/sched.h>
+#include <linux/spinlock.h>
+#include <linux/ktime.h>
+#include <linux/bitops.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/err.h>
+#include "emgd_drv.h"
+#include "igd_debug.h"
+
+#include <img_types.h>
+#include <private_data.h>
+
+#define EMGD_IOCTL_HIST_BUCKETS	24
+#define EMGD_IOCTL_MAX_PROCS	64
+
+typedef struct _emgd_ioctl_stat {
+	u64 calls;
+	u64 errors;
+	u64 total_ns;
+	u64 max_ns;
+	u32 hist[EMGD_IOCTL_HIST_BUCKETS];
+} emgd_ioctl_stat_t;
+
+/*
+ * A process claims a slot when it opens its first DRM file, and the slot
+ * is kept in the pPriv extension of each file's PVR private data. When
+ * its last file is closed the counts move to the last slot, which is
+ * never claimed and also counts processes that find the table full.
+ */
+typedef struct _emgd_ioctl_proc {
+	pid_t tgid;
+	int files;		/* open DRM files, under stats_procs_lock */
+	char comm[TASK_COMM_LEN];
+	atomic64_t calls;
+	atomic64_t errors;
+	atomic64_t total_ns;
+} emgd_ioctl_proc_t;
+
+static struct drm_ioctl_desc *stats_ioctls;
+static unsigned int stats_num_ioctls;
+static emgd_ioctl_stat_t *stats_percpu;		/* stats_num_ioctls per CPU */
+static emgd_ioctl_proc_t stats_procs[EMGD_IOCTL_MAX_PROCS];
+static DEFINE_SPINLOCK(stats_procs_lock);
+static u32 stats_enable = 1;
+
+static struct dentry *stats_debugfs_dir;
+
+
+#define STATS_OTHERS (&stats_procs[EMGD_IOCTL_MAX_PROCS - 1])
+
+/*
+ * Called from the DRM open hook once PVRSRVOpen has set up driver_priv.
+ */
+void emgd_ioctl_stats_open(struct drm_file *file)
+{
+	PVRSRV_FILE_PRIVATE_DATA *file_priv = file->driver_priv;
+	emgd_ioctl_proc_t *proc = STATS_OTHERS;
+	emgd_ioctl_proc_t *unused = NULL;
+	pid_t tgid = current->tgid;
+	int i;
+
+	if (!file_priv) {
+		return;
+	}
+
+	spin_lock(&stats_procs_lock);
+	for (i = 0; i < EMGD_IOCTL_MAX_PROCS - 1; i++) {
+		if (stats_procs[i].files && stats_procs[i].tgid == tgid) {
+			proc = &stats_procs[i];
+			break;
+		}
+		if (!stats_procs[i].files && !unused) {
+			unused = &stats_procs[i];
+		}
+	}
+	if (proc == STATS_OTHERS && unused) {
+		proc = unused;
+		proc->tgid = tgid;
+		get_task_comm(proc->comm, current);
+	}
+	proc->files++;
+	spin_unlock(&stats_procs_lock);
+
+	file_priv->pPriv = proc;
+}
+
+/*
+ * Called from the DRM preclose hook, before PVRSRVRelease frees
+ * driver_priv. No ioctl can be running on the file by then.
+ */
+void emgd_ioctl_stats_close(struct drm_file *file)
+{
+	PVRSRV_FILE_PRIVATE_DATA *file_priv = file->driver_priv;
+	emgd_ioctl_proc_t *proc;
+
+	if (!file_priv || !file_priv->pPriv) {
+		return;
+	}
+	proc = file_priv->pPriv;
+	file_priv->pPriv = NULL;
+
+	spin_lock(&stats_procs_lock);
+	if (--proc->files == 0 && proc != STATS_OTHERS) {
+		atomic64_add(atomic64_xchg(&proc->calls, 0), &STATS_OTHERS->calls);
+		atomic64_add(atomic64_xchg(&proc->errors, 0), &STATS_OTHERS->errors);
+		atomic64_add(atomic64_xchg(&proc->total_ns, 0),
+			&STATS_OTHERS->total_ns);
+		proc->tgid = 0;
+	}
+	spin_unlock(&stats_procs_lock);
+}
+
+static emgd_ioctl_proc_t *stats_file_proc(struct file *filp)
+{
+	struct drm_file *file = filp->private_data;
+	PVRSRV_FILE_PRIVATE_DATA *file_priv = file ? file->driver_priv : NULL;
+
+	if (file_priv && file_priv->pPriv) {
+		return file_priv->pPriv;
+	}
+
+	return STATS_OTHERS;
+}
+
+static void stats_record(struct file *filp, unsigned int cmd, long ret,
+	u64 ns)
+{
+	unsigned int nr = DRM_IOCTL_NR(cmd);
+	emgd_ioctl_proc_t *proc;
+	emgd_ioctl_stat_t *stat;
+	int bucket;
+
+	proc = stats_file_proc(filp);
+	atomic64_inc(&proc->calls);
+	atomic64_add(ns, &proc->total_ns);
+	if (ret < 0) {
+		atomic64_inc(&proc->errors);
+	}
+
+	if (!stats_percpu || nr < DRM_COMMAND_BASE ||
+			nr - DRM_COMMAND_BASE >= stats_num_ioctls) {
+		return;
+	}
+
+	bucket = fls64(ns >> 10);
+	if (bucket >= EMGD_IOCTL_HIST_BUCKETS) {
+		bucket = EMGD_IOCTL_HIST_BUCKETS - 1;
+	}
+
+	stat = per_cpu_ptr(stats_percpu, get_cpu()) + (nr - DRM_COMMAND_BASE);
+	stat->calls++;
+	if (ret < 0) {
+		stat->errors++;
+	}
+	stat->total_ns += ns;
+	if (ns > stat->max_ns) {
+		stat->max_ns = ns;
+	}
+	stat->hist[bucket]++;
+	put_cpu();
+}
+
+/*
+ * Replaces drm_ioctl in the DRM file operations.
+ */
+long emgd_ioctl_stats_ioctl(struct file *filp, unsigned int cmd,
+	unsigned long arg)
+{
+	ktime_t start;
+	long ret;
+
+	if (!stats_enable) {
+		return drm_ioctl(filp, cmd, arg);
+	}
+
+	start = ktime_get();
+	ret = drm_ioctl(filp, cmd, arg);
+	stats_record(filp, cmd, ret, ktime_to_ns(ktime_sub(ktime_get(), start)));
+
+	return ret;
+}
+
+
+static void stats_sum(unsigned int index, emgd_ioctl_stat_t *sum)
+{
+	emgd_ioctl_stat_t *stat;
+	int cpu, i;
+
+	memset(sum, 0, sizeof(*sum));
+	for_each_possible_cpu(cpu) {
+		stat = per_cpu_ptr(stats_percpu, cpu) + index;
+		sum->calls += stat->calls;
+		sum->errors += stat->errors;
+		sum->total_ns += stat->total_ns;
+		if (stat->max_ns > sum->max_ns) {
+			sum->max_ns = stat->max_ns;
+		}
+		for (i = 0; i < EMGD_IOCTL_HIST_BUCKETS; i++) {
+			sum->hist[i] += stat->hist[i];
+		}
+	}
+}
+
+static int stats_show(struct seq_file *m, void *v)
+{
+	emgd_ioctl_stat_t sum;
+	unsigned int index;
+	int i;
+
+	if (!stats_percpu) {
+		return 0;
+	}
+
+	seq_printf(m, "%-32s %10s %8s %12s %10s  histogram (2^n us: count)\n",
+		"ioctl", "calls", "errors", "total_us", "max_us");
+
+	for (index = 0; index < stats_num_ioctls; index++) {
+		if (!stats_ioctls[index].func) {
+			continue;
+		}
+		stats_sum(index, &sum);
+		if (!sum.calls) {
+			continue;
+		}
+
+		seq_printf(m, "%-32pf %10llu %8llu %12llu %10llu ",
+			stats_ioctls[index].func, sum.calls, sum.errors,
+			sum.total_ns >> 10, sum.max_ns >> 10);
+		for (i = 0; i < EMGD_IOCTL_HIST_BUCKETS; i++) {
+			if (sum.hist[i]) {
+				seq_printf(m, " %d:%u", i, sum.hist[i]);
+			}
+		}
+		seq_putc(m, '\n');
+	}
+
+	return 0;
+}
+
+static int procs_show(struct seq_file *m, void *v)
+{
+	emgd_ioctl_proc_t *proc;
+	int i;
+
+	seq_printf(m, "%8s %-16s %10s %8s %12s\n",
+		"pid", "comm", "calls", "errors", "total_us");
+
+	for (i = 0; i < EMGD_IOCTL_MAX_PROCS; i++) {
+		proc = &stats_procs[i];
+		if (!atomic64_read(&proc->calls)) {
+			continue;
+		}
+		if (i == EMGD_IOCTL_MAX_PROCS - 1) {
+			seq_printf(m, "%8s %-16s", "-", "(others)");
+		} else {
+			seq_printf(m, "%8d %-16s", proc->tgid, proc->comm);
+		}
+		seq_printf(m, " %10llu %8llu %12llu\n",
+			(unsigned long long)atomic64_read(&proc->calls),
+			(unsigned long long)atomic64_read(&proc->errors),
+			(unsigned long long)atomic64_read(&proc->total_ns) >> 10);
+	}
+
+	return 0;
+}
+
+static int stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, stats_show, NULL);
+}
+
+static int procs_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, procs_show, NULL);
+}
+
+/*
+ * Calls in flight during a reset may land in the old or new counts.
+ * Slots stay with the processes that hold them.
+ */
+static ssize_t reset_write(struct file *file, const char __user *buf,
+	size_t count, loff_t *ppos)
+{
+	emgd_ioctl_proc_t *proc;
+	int cpu, i;
+
+	if (stats_percpu) {
+		for_each_possible_cpu(cpu) {
+			memset(per_cpu_ptr(stats_percpu, cpu), 0,
+				stats_num_ioctls * sizeof(emgd_ioctl_stat_t));
+		}
+	}
+
+	for (i = 0; i < EMGD_IOCTL_MAX_PROCS; i++) {
+		proc = &stats_procs[i];
+		atomic64_set(&proc->calls, 0);
+		atomic64_set(&proc->errors, 0);
+		atomic64_set(&proc->total_ns, 0);
+	}
+
+	return count;
+}
+
+static const struct file_operations stats_fops = {
+	.owner = THIS_MODULE,
+	.open = stats_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static const struct file_operations procs_fops = {
+	.owner = THIS_MODULE,
+	.open = procs_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static const struct file_operations reset_fops = {
+	.owner = THIS_MODULE,
+	.write = reset_write,
+};
+
+
+int emgd_ioctl_stats_init(struct drm_ioctl_desc *ioctls,
+	unsigned int num_ioctls)
+{
+	stats_ioctls = ioctls;
+	stats_num_ioctls = num_ioctls;
+
+	stats_percpu = __alloc_percpu(num_ioctls * sizeof(emgd_ioctl_stat_t),
+		__alignof__(emgd_ioctl_stat_t));
+	if (!stats_percpu) {
+		/* Per process counts still work */
+		EMGD_ERROR("Cannot allocate the ioctl statistics");
+	}
+
+	stats_debugfs_dir = debugfs_create_dir("emgd_ioctl", NULL);
+	if (!stats_debugfs_dir || IS_ERR(stats_debugfs_dir)) {
+		stats_debugfs_dir = NULL;
+		EMGD_ERROR("Cannot create the emgd_ioctl debugfs directory");
+		return 0;
+	}
+
+	debugfs_create_u32("enable", S_IRUGO | S_IWUSR, stats_debugfs_dir,
+		&stats_enable);
+	debugfs_create_file("stats", S_IRUGO, stats_debugfs_dir, NULL,
+		&stats_fops);
+	debugfs_create_file("procs", S_IRUGO, stats_debugfs_dir, NULL,
+		&procs_fops);
+	debugfs_create_file("reset", S_IWUSR, stats_debugfs_dir, NULL,
+		&reset_fops);
+
+	return 0;
+}
+
+void emgd_ioctl_stats_cleanup(void)
+{
+	debugfs_remove_recursive(stats_debugfs_dir);
+	stats_debugfs_dir = NULL;
+
+	/* The DRM device, and with it every caller, is gone by now */
+	free_percpu(stats_percpu);
+	stats_percpu = NULL;
+}
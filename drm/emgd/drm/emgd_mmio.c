@@ -0,0 +1,282 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: emgd_mmio.c
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  MMIO access recorder, built only with MMIO_RECORD=1. Every
+ *  EMGD_READ32/EMGD_WRITE32 lands here and is logged, with a timestamp,
+ *  into a fixed-size ring that overwrites the oldest entries. The ring is
+ *  exported through debugfs:
+ *
+ *   emgd_mmio/enable  - 0/1, recording on or off (on by default)
+ *   emgd_mmio/log     - the recorded entries, oldest first, as an array
+ *                       of emgd_mmio_log_entry_t
+ *   emgd_mmio/clear   - any write empties the ring
+ *
+ *  Stop recording before reading the log; entries added during a read
+ *  may be skipped or duplicated.
+ *-----------------------------------------------------------------------------
+ */
+
+#define MODULE_NAME hal.oal
+
+#include <linux/module.h>
+#include <linux/version.h>
+#include <linux/vmalloc.h>
+#include <linux/spinlock.h>
+#include <linux/ktime.h>
+#include <linux/debugfs.h>
+#include <linux/err.h>
+#include <linux/uaccess.h>
+#include <io.h>
+#include <emgd_mmio_log.h>
+
+#define EMGD_MMIO_LOG_ENTRIES	(64 * 1024)
+#define EMGD_MMIO_MAX_REGIONS	4
+
+typedef struct _emgd_mmio_region {
+	unsigned long base;
+	unsigned long size;
+} emgd_mmio_region_t;
+
+static emgd_mmio_region_t regions[EMGD_MMIO_MAX_REGIONS];
+static emgd_mmio_backend_t *mmio_backend;
+
+static emgd_mmio_log_entry_t *mmio_log;
+static unsigned long mmio_log_head;		/* Total entries ever written */
+static DEFINE_SPINLOCK(mmio_log_lock);
+static u32 mmio_log_enable = 1;
+
+static struct dentry *mmio_debugfs_dir;
+
+
+static void mmio_log_add(unsigned char type, unsigned char region,
+	unsigned int offset, unsigned int value)
+{
+	emgd_mmio_log_entry_t *entry;
+	unsigned long flags;
+
+	if (!mmio_log_enable) {
+		return;
+	}
+
+	spin_lock_irqsave(&mmio_log_lock, flags);
+	if (!mmio_log) {
+		spin_unlock_irqrestore(&mmio_log_lock, flags);
+		return;
+	}
+	entry = &mmio_log[mmio_log_head % EMGD_MMIO_LOG_ENTRIES];
+	entry->timestamp = ktime_to_ns(ktime_get());
+	entry->offset = offset;
+	entry->value = value;
+	entry->type = type;
+	entry->region = region;
+	mmio_log_head++;
+	spin_unlock_irqrestore(&mmio_log_lock, flags);
+}
+
+/*
+ * Map a register address back to (region, offset) so the log does not
+ * depend on where the kernel happened to map the BARs.
+ */
+static unsigned char mmio_region(volatile void *addr, unsigned int *offset)
+{
+	unsigned long a = (unsigned long)addr;
+	int i;
+
+	for (i = 0; i < EMGD_MMIO_MAX_REGIONS; i++) {
+		if (regions[i].size && a >= regions[i].base &&
+				a - regions[i].base < regions[i].size) {
+			*offset = (unsigned int)(a - regions[i].base);
+			return (unsigned char)i;
+		}
+	}
+
+	*offset = (unsigned int)a;
+	return EMGD_MMIO_LOG_NO_REGION;
+}
+
+
+unsigned int emgd_mmio_read32(volatile void *addr)
+{
+	unsigned int value, offset;
+	unsigned char region;
+
+	if (mmio_backend) {
+		value = mmio_backend->read32(addr);
+	} else {
+		value = *(volatile unsigned int *)addr;
+	}
+
+	region = mmio_region(addr, &offset);
+	mmio_log_add(EMGD_MMIO_LOG_READ, region, offset, value);
+
+	return value;
+}
+
+void emgd_mmio_write32(unsigned long value, volatile void *addr)
+{
+	unsigned int offset;
+	unsigned char region;
+
+	region = mmio_region(addr, &offset);
+	mmio_log_add(EMGD_MMIO_LOG_WRITE, region, offset, (unsigned int)value);
+
+	if (mmio_backend) {
+		mmio_backend->write32(value, addr);
+	} else {
+		*(volatile unsigned int *)addr = (unsigned int)value;
+	}
+}
+
+void emgd_mmio_mark(unsigned int what)
+{
+	mmio_log_add(EMGD_MMIO_LOG_MARK, EMGD_MMIO_LOG_NO_REGION, what, 0);
+}
+
+void emgd_mmio_add_region(unsigned int id, void *base, unsigned long size)
+{
+	if (id < EMGD_MMIO_MAX_REGIONS) {
+		regions[id].base = (unsigned long)base;
+		regions[id].size = size;
+	}
+}
+
+/*
+ * Install a backend that services the accesses instead of the hardware,
+ * e.g. a simulated register file. NULL restores hardware access.
+ */
+void emgd_mmio_set_backend(emgd_mmio_backend_t *backend)
+{
+	mmio_backend = backend;
+}
+EXPORT_SYMBOL(emgd_mmio_set_backend);
+
+
+static ssize_t mmio_log_read(struct file *file, char __user *buf,
+	size_t count, loff_t *ppos)
+{
+	emgd_mmio_log_entry_t entry;
+	unsigned long head, first, index;
+	unsigned long flags;
+	size_t done = 0;
+
+	spin_lock_irqsave(&mmio_log_lock, flags);
+	head = mmio_log_head;
+	spin_unlock_irqrestore(&mmio_log_lock, flags);
+
+	first = (head > EMGD_MMIO_LOG_ENTRIES) ? head - EMGD_MMIO_LOG_ENTRIES : 0;
+	index = first + (unsigned long)(*ppos / sizeof(entry));
+
+	while (index < head && count - done >= sizeof(entry)) {
+		spin_lock_irqsave(&mmio_log_lock, flags);
+		if (!mmio_log) {
+			spin_unlock_irqrestore(&mmio_log_lock, flags);
+			break;
+		}
+		entry = mmio_log[index % EMGD_MMIO_LOG_ENTRIES];
+		spin_unlock_irqrestore(&mmio_log_lock, flags);
+
+		if (copy_to_user(buf + done, &entry, sizeof(entry))) {
+			return done ? done : -EFAULT;
+		}
+		done += sizeof(entry);
+		index++;
+	}
+
+	*ppos += done;
+	return done;
+}
+
+static ssize_t mmio_clear_write(struct file *file, const char __user *buf,
+	size_t count, loff_t *ppos)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&mmio_log_lock, flags);
+	mmio_log_head = 0;
+	spin_unlock_irqrestore(&mmio_log_lock, flags);
+
+	return count;
+}
+
+static const struct file_operations mmio_log_fops = {
+	.owner = THIS_MODULE,
+	.read = mmio_log_read,
+};
+
+static const struct file_operations mmio_clear_fops = {
+	.owner = THIS_MODULE,
+	.write = mmio_clear_write,
+};
+
+
+int emgd_mmio_init(void)
+{
+	/* A failed driver load does not unload, so a retry may land here */
+	if (mmio_log) {
+		return 0;
+	}
+
+	mmio_log = vmalloc(EMGD_MMIO_LOG_ENTRIES * sizeof(emgd_mmio_log_entry_t));
+	if (!mmio_log) {
+		EMGD_ERROR("Cannot allocate the MMIO log");
+		return -ENOMEM;
+	}
+	memset(mmio_log, 0, EMGD_MMIO_LOG_ENTRIES * sizeof(emgd_mmio_log_entry_t));
+
+	mmio_debugfs_dir = debugfs_create_dir("emgd_mmio", NULL);
+	if (!mmio_debugfs_dir || IS_ERR(mmio_debugfs_dir)) {
+		mmio_debugfs_dir = NULL;
+		/* Recording still works; the log just cannot be read */
+		EMGD_ERROR("Cannot create the emgd_mmio debugfs directory");
+		return 0;
+	}
+
+	debugfs_create_u32("enable", S_IRUGO | S_IWUSR, mmio_debugfs_dir,
+		&mmio_log_enable);
+	debugfs_create_file("log", S_IRUSR, mmio_debugfs_dir, NULL,
+		&mmio_log_fops);
+	debugfs_create_file("clear", S_IWUSR, mmio_debugfs_dir, NULL,
+		&mmio_clear_fops);
+
+	return 0;
+}
+
+void emgd_mmio_cleanup(void)
+{
+	unsigned long flags;
+	emgd_mmio_log_entry_t *log;
+
+	debugfs_remove_recursive(mmio_debugfs_dir);
+	mmio_debugfs_dir = NULL;
+
+	spin_lock_irqsave(&mmio_log_lock, flags);
+	log = mmio_log;
+	mmio_log = NULL;
+	spin_unlock_irqrestore(&mmio_log_lock, flags);
+
+	vfree(log);
+}
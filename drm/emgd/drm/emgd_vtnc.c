@@ -0,0 +1,588 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: emgd_vtnc.c
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Virtual Atom E6xx display device, built only with VIRTUAL_TNC=1 and
+ *  enabled with the "vtnc=1" module parameter. It lets the KMS mode set,
+ *  flip, cursor and overlay code run unmodified on machines without the
+ *  silicon, e.g. a CI virtual machine:
+ *
+ *   - The driver binds to the QEMU/Bochs standard VGA function, which
+ *     gives the DRM core a real PCI device. Its BARs are not used.
+ *   - The HAL's PCI lookups find a virtual bridge, 0:2:0, 0:3:0 and LPC
+ *     function with their configuration space in RAM.
+ *   - The 0:2:0 and 0:3:0 register files and the GPIO_BAR are RAM, so
+ *     EMGD_READ32/EMGD_WRITE32 cost what a memory access costs.
+ *   - An hrtimer at vtnc_refresh Hz plays the part of the display engine:
+ *     every enabled pipe latches its vblank status and frame counter, the
+ *     pipe state, panel power and overlay status bits follow what the
+ *     driver asked for, and the vblank interrupt is delivered to the
+ *     handler the mode code registered.
+ *   - DDC reads return the EDID in the firmware file named by vtnc_edid,
+ *     or a built-in 1024x768 panel. Nothing answers at the sDVO address,
+ *     so only the Int-LVDS port is detected.
+ *
+ *  The SGX, MSVDX and Topaz cores are not modelled; the PVR services are
+ *  not started. Use tools/emgd_flip_bench to measure flip rate and
+ *  submit-to-vblank latency against this device.
+ *-----------------------------------------------------------------------------
+ */
+
+#define MODULE_NAME hal.oal
+
+#include <linux/module.h>
+#include <linux/version.h>
+#include <linux/pci.h>
+#include <linux/vmalloc.h>
+#include <linux/slab.h>
+#include <linux/hrtimer.h>
+#include <linux/ktime.h>
+#include <linux/firmware.h>
+#include <linux/spinlock.h>
+#include <io.h>
+#include <general.h>
+#include <intelpci.h>
+#include <tnc/regs.h>
+#include <emgd_vtnc.h>
+
+int emgd_vtnc = 0;
+static int vtnc_refresh = 60;
+static char *vtnc_edid = NULL;
+
+MODULE_PARM_DESC(vtnc, "Run on a virtual Atom E6xx bound to the QEMU "
+	"standard VGA function (1=yes, 0=no)");
+MODULE_PARM_DESC(vtnc_refresh, "Vblank rate of the virtual Atom E6xx in Hz "
+	"(e.g. 60)");
+MODULE_PARM_DESC(vtnc_edid, "Firmware file holding the EDID returned by the "
+	"virtual panel (e.g. \"edid/1024x768.bin\")");
+module_param_named(vtnc, emgd_vtnc, int, 0400);
+module_param_named(vtnc_refresh, vtnc_refresh, int, 0400);
+module_param_named(vtnc_edid, vtnc_edid, charp, 0400);
+
+/*
+ * Addresses the virtual BARs report. They are only ever compared against,
+ * never mapped.
+ */
+#define VTNC_D2_MMADR		0xd0000000
+#define VTNC_D3_MMADR		0xd0100000
+#define VTNC_GTTADR			0xd0200000
+#define VTNC_GMADR			0xc0000000
+#define VTNC_GMADR_SIZE		(256 * 1024 * 1024)
+#define VTNC_GTT_SIZE		((VTNC_GMADR_SIZE >> PAGE_SHIFT) * 4)
+#define VTNC_GPIO_BAR		0x1000
+#define VTNC_GPIO_SIZE		64
+
+#define VTNC_DDC_ADDR		0xA0
+#define VTNC_EDID_MAX		256
+
+#define VTNC_OVL_STATUS		0x30008
+#define VTNC_DPLL_STATUS	0x606C
+#define VTNC_CDVO_CTRL		0x7000
+
+typedef struct _vtnc_pci_function {
+	unsigned int slot;
+	unsigned short device_id;
+	unsigned char config[256];
+} vtnc_pci_function_t;
+
+static vtnc_pci_function_t vtnc_pci[] = {
+	{ 0, PCI_DEVICE_ID_BRIDGE_TNC },
+	{ 2, PCI_DEVICE_ID_VGA_TNC },
+	{ 3, PCI_DEVICE_ID_SDVO_TNC },
+	{ 31, PCI_DEVICE_ID_LPC_TNC },
+};
+#define VTNC_PCI_FUNCTIONS (sizeof(vtnc_pci) / sizeof(vtnc_pci[0]))
+
+static unsigned char *vtnc_d2;
+static unsigned char *vtnc_d3;
+static unsigned char vtnc_gpio[VTNC_GPIO_SIZE];
+
+static unsigned char *vtnc_edid_data;
+static unsigned long vtnc_edid_size;
+
+static struct hrtimer vtnc_timer;
+static ktime_t vtnc_period;
+static irq_handler_t vtnc_handler;
+static void *vtnc_handler_arg;
+static DEFINE_SPINLOCK(vtnc_irq_lock);
+
+/*
+ * 1024x768@60 digital panel. The checksum byte is filled in by
+ * vtnc_edid_load().
+ */
+static unsigned char vtnc_default_edid[128] = {
+	/* Header, "EMG" product 1, week 1 of 2010, EDID 1.3 */
+	0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00,
+	0x15, 0xa7, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x01, 0x14, 0x01, 0x03,
+	/* Digital input, 26x20cm, gamma 2.2, preferred timing in DTD 1 */
+	0x80, 0x1a, 0x14, 0x78, 0x0a,
+	/* Chromaticity */
+	0xee, 0x91, 0xa3, 0x54, 0x4c, 0x99, 0x26, 0x0f, 0x50, 0x54,
+	/* Established timings: 1024x768@60 */
+	0x00, 0x08, 0x00,
+	/* No standard timings */
+	0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+	0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+	/* DTD: 65MHz, 1024+24+136+160 x 768+3+6+29, 260x200mm, -h -v */
+	0x64, 0x19, 0x00, 0x40, 0x41, 0x00, 0x26, 0x30, 0x18,
+	0x88, 0x36, 0x00, 0x04, 0xc8, 0x10, 0x00, 0x00, 0x18,
+	/* Monitor name */
+	0x00, 0x00, 0x00, 0xfc, 0x00, 'E', 'M', 'G', 'D', ' ',
+	'v', 'T', 'N', 'C', 0x0a, 0x20, 0x20, 0x20,
+	/* Range limits: 56-76Hz, 30-83kHz, 140MHz */
+	0x00, 0x00, 0x00, 0xfd, 0x00, 0x38, 0x4c, 0x1e, 0x53,
+	0x0e, 0x00, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+	/* Dummy descriptor */
+	0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	/* No extensions, checksum */
+	0x00, 0x00,
+};
+
+
+static inline unsigned int vtnc_read(unsigned char *mmio, unsigned long reg)
+{
+	return *(volatile unsigned int *)(mmio + reg);
+}
+
+static inline void vtnc_write(unsigned char *mmio, unsigned long reg,
+	unsigned int value)
+{
+	*(volatile unsigned int *)(mmio + reg) = value;
+}
+
+static vtnc_pci_function_t *vtnc_pci_function(unsigned int slot)
+{
+	unsigned int i;
+
+	for (i = 0; i < VTNC_PCI_FUNCTIONS; i++) {
+		if (vtnc_pci[i].slot == slot) {
+			return &vtnc_pci[i];
+		}
+	}
+	return NULL;
+}
+
+static void vtnc_config32(unsigned int slot, unsigned long offset,
+	unsigned int value)
+{
+	vtnc_pci_function_t *fn = vtnc_pci_function(slot);
+
+	memcpy(&fn->config[offset], &value, sizeof(value));
+}
+
+static void vtnc_pci_reset(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < VTNC_PCI_FUNCTIONS; i++) {
+		memset(vtnc_pci[i].config, 0, sizeof(vtnc_pci[i].config));
+		vtnc_config32(vtnc_pci[i].slot, PCI_VENDOR_ID,
+			((unsigned int)vtnc_pci[i].device_id << 16) | PCI_VENDOR_ID_INTEL);
+	}
+
+	/* 0:2:0: registers, GMADR and GTTADR; no stolen memory, no vBIOS */
+	vtnc_config32(2, PCI_BASE_ADDRESS_0, VTNC_D2_MMADR);
+	vtnc_config32(2, PCI_BASE_ADDRESS_2,
+		VTNC_GMADR | PCI_BASE_ADDRESS_MEM_PREFETCH);
+	vtnc_config32(2, PCI_BASE_ADDRESS_3, VTNC_GTTADR);
+
+	/* 0:3:0: sDVO and overlay registers */
+	vtnc_config32(3, PCI_BASE_ADDRESS_0, VTNC_D3_MMADR);
+
+	/* LPC: GPIO_BAR */
+	vtnc_config32(31, TNC_PCI_GBA, VTNC_GPIO_BAR);
+}
+
+/*
+ * Load the EDID named by the vtnc_edid parameter. Anything that is not a
+ * whole number of 128 byte blocks falls back to the built-in panel.
+ */
+static void vtnc_edid_load(struct pci_dev *pdev)
+{
+	const struct firmware *fw;
+	unsigned char sum = 0;
+	unsigned int i;
+
+	for (i = 0; i < sizeof(vtnc_default_edid) - 1; i++) {
+		sum += vtnc_default_edid[i];
+	}
+	vtnc_default_edid[sizeof(vtnc_default_edid) - 1] = (unsigned char)-sum;
+
+	vtnc_edid_data = vtnc_default_edid;
+	vtnc_edid_size = sizeof(vtnc_default_edid);
+
+	if (!vtnc_edid || !vtnc_edid[0]) {
+		return;
+	}
+
+	if (request_firmware(&fw, vtnc_edid, &pdev->dev)) {
+		EMGD_ERROR("Cannot load EDID \"%s\", using the built-in panel",
+			vtnc_edid);
+		return;
+	}
+
+	if (fw->size < 128 || (fw->size % 128) || fw->size > VTNC_EDID_MAX) {
+		EMGD_ERROR("EDID \"%s\" is %lu bytes, using the built-in panel",
+			vtnc_edid, (unsigned long)fw->size);
+	} else {
+		vtnc_edid_data = kmalloc(fw->size, GFP_KERNEL);
+		if (vtnc_edid_data) {
+			memcpy(vtnc_edid_data, fw->data, fw->size);
+			vtnc_edid_size = fw->size;
+		} else {
+			vtnc_edid_data = vtnc_default_edid;
+		}
+	}
+
+	release_firmware(fw);
+}
+
+/*
+ * One frame of a pipe. Returns non-zero if the pipe is running and so
+ * raised a vblank.
+ */
+static int vtnc_pipe_vblank(unsigned char *mmio, unsigned long conf_reg,
+	unsigned long stat_reg, unsigned long high_reg, unsigned long low_reg)
+{
+	unsigned int conf, stat, count;
+
+	/* The state bit follows the enable bit within a frame */
+	conf = vtnc_read(mmio, conf_reg);
+	if (conf & PIPE_ENABLE) {
+		conf |= BIT30;
+	} else {
+		conf &= ~BIT30;
+	}
+	vtnc_write(mmio, conf_reg, conf);
+
+	if (!(conf & PIPE_ENABLE)) {
+		return 0;
+	}
+
+	stat = vtnc_read(mmio, stat_reg) & ~PIPESTAT_STS_BITS;
+	vtnc_write(mmio, stat_reg, stat | VBLANK_STS | VSYNC_STS);
+
+	count = ((vtnc_read(mmio, high_reg) & PIPE_FRAME_HIGH_MASK) << 8) |
+		(vtnc_read(mmio, low_reg) >> PIPE_FRAME_LOW_SHIFT);
+	count++;
+
+	/*
+	 * Low byte first: a reader that sees the new low byte then sees a
+	 * changed high word and retries (see kms_get_vblank_counter_tnc()).
+	 */
+	vtnc_write(mmio, low_reg, (vtnc_read(mmio, low_reg) & ~PIPE_FRAME_LOW_MASK) |
+		((count & 0xff) << PIPE_FRAME_LOW_SHIFT));
+	vtnc_write(mmio, high_reg, (count >> 8) & PIPE_FRAME_HIGH_MASK);
+
+	return 1;
+}
+
+static int vtnc_irq_enabled(unsigned char *mmio, unsigned int bit)
+{
+	return (vtnc_read(mmio, IER) & bit) && !(vtnc_read(mmio, IMR) & bit);
+}
+
+static enum hrtimer_restart vtnc_vblank(struct hrtimer *timer)
+{
+	unsigned int lvds, sdvo, tmp;
+	unsigned int iir_d2 = 0, iir_d3 = 0;
+	irq_handler_t handler;
+	void *arg;
+	unsigned long flags;
+
+	/* Int-LVDS is pipe A of 0:2:0, sDVO is pipe B mirrored in 0:3:0 */
+	lvds = vtnc_pipe_vblank(vtnc_d2, PIPEA_CONF, PIPEA_STAT,
+		PIPEA_FRAME_HIGH, PIPEA_FRAME_PIXEL);
+	sdvo = vtnc_pipe_vblank(vtnc_d2, PIPEB_CONF, PIPEB_STAT,
+		PIPEB_FRAME_HIGH, PIPEB_FRAME_PIXEL);
+	sdvo |= vtnc_pipe_vblank(vtnc_d3, PIPEB_CONF, PIPEB_STAT,
+		PIPEB_FRAME_HIGH, PIPEB_FRAME_PIXEL);
+
+	/* Panel power sequencing completes within a frame */
+	tmp = vtnc_read(vtnc_d2, LVDS_PNL_PWR_STS) & ~(BIT31 | BIT29 | BIT28);
+	if (vtnc_read(vtnc_d2, LVDS_PNL_PWR_CTL) & BIT0) {
+		tmp |= BIT31;
+	}
+	vtnc_write(vtnc_d2, LVDS_PNL_PWR_STS, tmp);
+
+	/* Overlay register update done, DPLL locked */
+	vtnc_write(vtnc_d2, VTNC_OVL_STATUS,
+		vtnc_read(vtnc_d2, VTNC_OVL_STATUS) | BIT31);
+	vtnc_write(vtnc_d3, VTNC_OVL_STATUS,
+		vtnc_read(vtnc_d3, VTNC_OVL_STATUS) | BIT31);
+	vtnc_write(vtnc_d3, VTNC_DPLL_STATUS,
+		vtnc_read(vtnc_d3, VTNC_DPLL_STATUS) | BIT16);
+
+	/*
+	 * The handler acknowledges by writing the bits back, which in RAM
+	 * sets rather than clears them, so IIR is rewritten every frame.
+	 */
+	if (lvds && vtnc_irq_enabled(vtnc_d2, BIT7)) {
+		iir_d2 |= BIT7;
+	}
+	if (sdvo && vtnc_irq_enabled(vtnc_d3, BIT5)) {
+		iir_d3 |= BIT5;
+	}
+	vtnc_write(vtnc_d2, IIR, iir_d2);
+	vtnc_write(vtnc_d3, IIR, iir_d3);
+
+	spin_lock_irqsave(&vtnc_irq_lock, flags);
+	handler = vtnc_handler;
+	arg = vtnc_handler_arg;
+	spin_unlock_irqrestore(&vtnc_irq_lock, flags);
+
+	if (handler && (iir_d2 || iir_d3)) {
+		handler(0, arg);
+	}
+
+	hrtimer_forward_now(timer, vtnc_period);
+	return HRTIMER_RESTART;
+}
+
+
+int emgd_vtnc_init(struct pci_dev *pdev)
+{
+	/* A failed driver load does not unload, so a retry may land here */
+	if (vtnc_d2) {
+		return 0;
+	}
+
+	if (vtnc_refresh <= 0 || vtnc_refresh > 1000) {
+		EMGD_ERROR("Module parameter \"vtnc_refresh\" contains invalid "
+			"value %d, using 60Hz", vtnc_refresh);
+		vtnc_refresh = 60;
+	}
+
+	vtnc_d2 = vmalloc(TNC_D2_MMIO_SIZE);
+	vtnc_d3 = vmalloc(TNC_D3_MMIO_SIZE);
+	if (!vtnc_d2 || !vtnc_d3) {
+		EMGD_ERROR("Cannot allocate the virtual Atom E6xx registers");
+		vfree(vtnc_d2);
+		vfree(vtnc_d3);
+		vtnc_d2 = vtnc_d3 = NULL;
+		return -ENOMEM;
+	}
+	memset(vtnc_d2, 0, TNC_D2_MMIO_SIZE);
+	memset(vtnc_d3, 0, TNC_D3_MMIO_SIZE);
+	memset(vtnc_gpio, 0, sizeof(vtnc_gpio));
+	vtnc_pci_reset();
+
+	/* Registers the clock code polls, in their "done" state */
+	vtnc_write(vtnc_d3, VTNC_DPLL_STATUS, BIT16);
+	vtnc_write(vtnc_d3, VTNC_CDVO_CTRL, 0x50);
+
+	vtnc_edid_load(pdev);
+
+	vtnc_period = ktime_set(0, NSEC_PER_SEC / vtnc_refresh);
+	hrtimer_init(&vtnc_timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	vtnc_timer.function = vtnc_vblank;
+	hrtimer_start(&vtnc_timer, vtnc_period, HRTIMER_MODE_REL);
+
+	printk(KERN_INFO "[EMGD] Virtual Atom E6xx on %s: %dHz, %lu byte EDID\n",
+		pci_name(pdev), vtnc_refresh, vtnc_edid_size);
+
+	return 0;
+}
+
+void emgd_vtnc_cleanup(void)
+{
+	if (!vtnc_d2) {
+		return;
+	}
+
+	hrtimer_cancel(&vtnc_timer);
+	vtnc_handler = NULL;
+
+	if (vtnc_edid_data != vtnc_default_edid) {
+		kfree(vtnc_edid_data);
+	}
+	vtnc_edid_data = NULL;
+	vtnc_edid_size = 0;
+
+	vfree(vtnc_d2);
+	vfree(vtnc_d3);
+	vtnc_d2 = vtnc_d3 = NULL;
+}
+
+
+/*
+ * Returns the slot of the virtual function with the given IDs, or -1.
+ * Everything but the four Atom E6xx functions is absent.
+ */
+int emgd_vtnc_pci_find(unsigned short vendor_id, unsigned short device_id)
+{
+	unsigned int i;
+
+	if (vendor_id != PCI_VENDOR_ID_INTEL) {
+		return -1;
+	}
+	for (i = 0; i < VTNC_PCI_FUNCTIONS; i++) {
+		if (vtnc_pci[i].device_id == device_id) {
+			return (int)vtnc_pci[i].slot;
+		}
+	}
+	return -1;
+}
+
+int emgd_vtnc_pci_read(unsigned int slot, unsigned long offset,
+	void *val, unsigned int size)
+{
+	vtnc_pci_function_t *fn = vtnc_pci_function(slot);
+
+	if (!fn || offset + size > sizeof(fn->config)) {
+		return -1;
+	}
+	memcpy(val, &fn->config[offset], size);
+	return 0;
+}
+
+int emgd_vtnc_pci_write(unsigned int slot, unsigned long offset,
+	unsigned long val, unsigned int size)
+{
+	vtnc_pci_function_t *fn = vtnc_pci_function(slot);
+	unsigned int value = (unsigned int)val;
+
+	if (!fn || offset + size > sizeof(fn->config)) {
+		return -1;
+	}
+
+	/* IDs and BARs are read-only, so the register files cannot move */
+	if (offset < PCI_COMMAND ||
+		(offset >= PCI_BASE_ADDRESS_0 && offset <= PCI_BASE_ADDRESS_5)) {
+		return 0;
+	}
+	memcpy(&fn->config[offset], &value, size);
+	return 0;
+}
+
+void emgd_vtnc_resource(int bar, unsigned long *start, unsigned long *len)
+{
+	switch (bar) {
+	case EMGD_VTNC_GATT_RESOURCE:
+		*start = VTNC_GMADR;
+		*len = VTNC_GMADR_SIZE;
+		break;
+	case EMGD_VTNC_GTT_RESOURCE:
+		*start = VTNC_GTTADR;
+		*len = VTNC_GTT_SIZE;
+		break;
+	default:
+		*start = 0;
+		*len = 0;
+		break;
+	}
+}
+
+
+void *emgd_vtnc_map(unsigned long base, unsigned long size)
+{
+	if (base == VTNC_D2_MMADR && size <= TNC_D2_MMIO_SIZE) {
+		return vtnc_d2;
+	}
+	if (base == VTNC_D3_MMADR && size <= TNC_D3_MMIO_SIZE) {
+		return vtnc_d3;
+	}
+	if (base == VTNC_GPIO_BAR && size <= VTNC_GPIO_SIZE) {
+		return vtnc_gpio;
+	}
+
+	EMGD_ERROR("No virtual Atom E6xx BAR at 0x%lx", base);
+	return NULL;
+}
+
+int emgd_vtnc_unmap(void *virt)
+{
+	return virt && (virt == vtnc_d2 || virt == vtnc_d3 ||
+		virt == (void *)vtnc_gpio);
+}
+
+unsigned long emgd_vtnc_lpc_read(unsigned long reg)
+{
+	unsigned int value;
+
+	if (reg + sizeof(value) > VTNC_GPIO_SIZE) {
+		return 0xffffffff;
+	}
+	memcpy(&value, &vtnc_gpio[reg], sizeof(value));
+	return value;
+}
+
+void emgd_vtnc_lpc_write(unsigned long reg, unsigned long value)
+{
+	unsigned int v = (unsigned int)value;
+
+	if (reg + sizeof(v) <= VTNC_GPIO_SIZE) {
+		memcpy(&vtnc_gpio[reg], &v, sizeof(v));
+	}
+}
+
+
+int emgd_vtnc_i2c_read(unsigned long dab, unsigned char reg,
+	unsigned char *buffer, unsigned long num_bytes)
+{
+	if (dab != VTNC_DDC_ADDR || !vtnc_edid_data ||
+		(unsigned long)reg + num_bytes > vtnc_edid_size) {
+		return 1;
+	}
+
+	memcpy(buffer, vtnc_edid_data + reg, num_bytes);
+	return 0;
+}
+
+
+int emgd_vtnc_request_irq(irq_handler_t handler, void *arg)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&vtnc_irq_lock, flags);
+	if (vtnc_handler) {
+		spin_unlock_irqrestore(&vtnc_irq_lock, flags);
+		return -EBUSY;
+	}
+	vtnc_handler = handler;
+	vtnc_handler_arg = arg;
+	spin_unlock_irqrestore(&vtnc_irq_lock, flags);
+
+	return 0;
+}
+
+/*
+ * Unlike free_irq() this does not wait for a running handler; the
+ * register files and the handler outlive it, so one late call is harmless.
+ */
+void emgd_vtnc_free_irq(void *arg)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&vtnc_irq_lock, flags);
+	if (vtnc_handler_arg == arg) {
+		vtnc_handler = NULL;
+		vtnc_handler_arg = NULL;
+	}
+	spin_unlock_irqrestore(&vtnc_irq_lock, flags);
+}
@@ -360,6 +360,7 @@ static int gmm_alloc_surface(unsigned long *offset,
 	ret = gmm_alloc_linear_surface(offset, pixel_format, width, height, pitch,
 			size, type, *flags, phys);
 
+	trace_emgd_gmm_alloc(*offset, *size, ret);
 	EMGD_DEBUG("EXIT  Returning %d", ret);
 	return ret;
 }
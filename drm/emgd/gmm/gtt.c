@@ -35,6 +35,8 @@
 #include <memory.h>
 #include <asm/cacheflush.h>
 #include <linux/version.h>
+#include "services_headers.h"
+#include <gtt_shadow.h>
 
 #define PFX "EMGD: "
 
@@ -57,14 +59,44 @@ struct client_list_struct {
 
 static LIST_HEAD(client_list);
 
-static void ipi_handler(void *null) {
-	//flush_agp_cache(); /* from agp.h */
-	wbinvd();
-}
+#define EMGD_FLUSH_BATCH 16
+
+/*
+ * Flush only the pages of the buffer, batching physically adjacent pages
+ * into a single range.  Large buffers fall back to a full flush inside
+ * the cache maintenance service.
+ */
+static void emgd_cache_flush(gmm_mem_buffer_t *mem) {
+	PVRSRV_CACHE_RANGE ranges[EMGD_FLUSH_BATCH];
+	unsigned long next = 0;
+	int count = 0;
+	int i;
+
+	if ((mem->page_count << PAGE_SHIFT) >= PVR_CACHE_FLUSH_RANGE_THRESHOLD) {
+		OSFlushCPUCacheKM();
+		return;
+	}
+
+	for (i = 0; i < mem->page_count; i++) {
+		unsigned long addr = (unsigned long)page_address(mem->pages[i]);
 
-static void emgd_cache_flush(void) {
-	if (on_each_cpu(ipi_handler, NULL, 1) != 0)
-		panic(PFX "timed out waiting for the other CPUs!\n");
+		if (count && addr == next) {
+			ranges[count - 1].pvEnd = (void *)(addr + PAGE_SIZE);
+		} else {
+			if (count == EMGD_FLUSH_BATCH) {
+				OSFlushCPUCacheRangesKM(ranges, count);
+				count = 0;
+			}
+			ranges[count].pvStart = (void *)addr;
+			ranges[count].pvEnd = (void *)(addr + PAGE_SIZE);
+			count++;
+		}
+		next = addr + PAGE_SIZE;
+	}
+
+	if (count) {
+		OSFlushCPUCacheRangesKM(ranges, count);
+	}
 }
 
 static void tlb_flush(void) {
@@ -353,7 +385,7 @@ void emgd_gtt_insert(igd_context_t *context,
 	}
 
 	/* Flush before inserting pages into the GTT */
-	emgd_cache_flush();
+	emgd_cache_flush(mem);
 	tlb_flush();
 
 
@@ -366,6 +398,9 @@ void emgd_gtt_insert(igd_context_t *context,
 		pte = page_to_phys(page) | PSB_PTE_VALID;
 		writel(pte, (context->device_context.virt_gttadr + j));
 		readl(context->device_context.virt_gttadr + j);
+		if (context->device_context.gtt_shadow) {
+			emgd_gtt_shadow_set(context->device_context.gtt_shadow, j, pte);
+		}
 
 	}
 
@@ -378,7 +413,7 @@ void emgd_gtt_insert(igd_context_t *context,
 		(context->device_context.gmch_ctl | PCI_BASE_ADDRESS_MEM_MASK));
 
 	/* Flush */
-	emgd_cache_flush();
+	emgd_cache_flush(mem);
 	tlb_flush();
 
 	return;
@@ -401,7 +436,7 @@ void emgd_gtt_remove(igd_context_t *context,
 	pg_start = offset >> PAGE_SHIFT;
 
 	/* Flush before inserting pages into the GTT */
-	emgd_cache_flush();
+	emgd_cache_flush(mem);
 	tlb_flush();
 
 	mutex_lock(&gtt_sem);
@@ -420,6 +455,9 @@ void emgd_gtt_remove(igd_context_t *context,
 		} else {
 			writel(pte, context->device_context.virt_gttadr + i);
 			(void)readl(context->device_context.virt_gttadr + i);
+			if (context->device_context.gtt_shadow) {
+				emgd_gtt_shadow_set(context->device_context.gtt_shadow, i, pte);
+			}
 		}
 
 	}
@@ -431,6 +469,61 @@ void emgd_gtt_remove(igd_context_t *context,
 			(context->device_context.gmch_ctl | PCI_BASE_ADDRESS_MEM_MASK));
 
 	/* Flush */
-	emgd_cache_flush();
+	emgd_cache_flush(mem);
+	tlb_flush();
+}
+
+/*
+ * Snapshot the GTT shadow into *saved, allocating it on first use, so the
+ * table can be restored to its current state later without reading it
+ * back.  Returns 0 if there is no shadow or no memory for the snapshot,
+ * in which case the caller has to save the table itself.
+ */
+int emgd_gtt_save(igd_context_t *context, gtt_shadow_t **saved)
+{
+	gtt_shadow_t *shadow = context->device_context.gtt_shadow;
+
+	if (!shadow) {
+		return 0;
+	}
+
+	if (!*saved) {
+		*saved = emgd_gtt_shadow_alloc(shadow->entries, shadow->scratch_pte);
+		if (!*saved) {
+			return 0;
+		}
+	}
+
+	mutex_lock(&gtt_sem);
+	emgd_gtt_shadow_copy(*saved, shadow);
+	mutex_unlock(&gtt_sem);
+
+	return 1;
+}
+
+/*
+ * Rewrite the GTT from a snapshot taken by emgd_gtt_save().  Only the
+ * entries the driver had written at save time are restored.  Returns 0 if
+ * there is no snapshot, in which case the caller has to restore the table
+ * from its own copy.
+ */
+int emgd_gtt_restore(igd_context_t *context, gtt_shadow_t *saved)
+{
+	unsigned long count;
+
+	if (!saved) {
+		return 0;
+	}
+
+	mutex_lock(&gtt_sem);
+	count = emgd_gtt_shadow_restore(saved,
+		context->device_context.virt_gttadr);
+	mutex_unlock(&gtt_sem);
+
+	EMGD_DEBUG("Restored %lu of %lu GTT entries", count,
+		context->device_context.gatt_pages);
+
 	tlb_flush();
+
+	return 1;
 }
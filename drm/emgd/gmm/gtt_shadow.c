@@ -0,0 +1,168 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: gtt_shadow.c
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Shadow copy of the GTT.  Every PTE the driver writes is also recorded
+ *  here, so suspend can skip reading the table back and resume rewrites
+ *  only the entries the driver has touched.  Entries never written keep
+ *  whatever the firmware put there, which it puts there again on resume.
+ *-----------------------------------------------------------------------------
+ */
+
+#include <linux/kernel.h>
+#include <linux/slab.h>
+#include <linux/vmalloc.h>
+#include <linux/bitops.h>
+#include <linux/string.h>
+#include <asm/io.h>
+#include <gtt_shadow.h>
+
+/*
+ * Allocate a shadow for a GTT of the given number of entries.  The PTE
+ * array and the two bitmaps come from one vmalloc() since a 512MB aperture
+ * needs 512K of PTEs.
+ */
+gtt_shadow_t *emgd_gtt_shadow_alloc(unsigned long entries,
+	unsigned int scratch_pte)
+{
+	gtt_shadow_t *shadow;
+	unsigned long map_size;
+	unsigned long size;
+
+	shadow = kzalloc(sizeof(gtt_shadow_t), GFP_KERNEL);
+	if (!shadow) {
+		return NULL;
+	}
+
+	map_size = BITS_TO_LONGS(entries) * sizeof(unsigned long);
+	size = 2 * map_size + entries * sizeof(unsigned int);
+
+	shadow->written = vmalloc(size);
+	if (!shadow->written) {
+		kfree(shadow);
+		return NULL;
+	}
+	memset(shadow->written, 0, size);
+
+	shadow->mapped = shadow->written + BITS_TO_LONGS(entries);
+	shadow->pte = (unsigned int *)(shadow->mapped + BITS_TO_LONGS(entries));
+	shadow->entries = entries;
+	shadow->scratch_pte = scratch_pte;
+
+	return shadow;
+}
+
+void emgd_gtt_shadow_free(gtt_shadow_t *shadow)
+{
+	if (shadow) {
+		vfree(shadow->written);
+		kfree(shadow);
+	}
+}
+
+/*
+ * Record a PTE written to the GTT.  Entries pointing at the scratch page
+ * are tracked separately so resume can write them without touching the
+ * PTE array.
+ */
+void emgd_gtt_shadow_set(gtt_shadow_t *shadow, unsigned long entry,
+	unsigned int pte)
+{
+	if (entry >= shadow->entries) {
+		return;
+	}
+
+	shadow->pte[entry] = pte;
+	__set_bit(entry, shadow->written);
+	if (pte == shadow->scratch_pte) {
+		__clear_bit(entry, shadow->mapped);
+	} else {
+		__set_bit(entry, shadow->mapped);
+	}
+}
+
+/*
+ * Copy src into dst, which must shadow a GTT of the same size.  Used to
+ * snapshot the table at save time so a later restore puts back that
+ * state rather than whatever the shadow holds by then.
+ */
+void emgd_gtt_shadow_copy(gtt_shadow_t *dst, gtt_shadow_t *src)
+{
+	unsigned long map_size;
+
+	if (dst->entries != src->entries) {
+		return;
+	}
+
+	map_size = BITS_TO_LONGS(src->entries) * sizeof(unsigned long);
+	memcpy(dst->written, src->written,
+		2 * map_size + src->entries * sizeof(unsigned int));
+	dst->scratch_pte = src->scratch_pte;
+}
+
+/*
+ * Rewrite every entry recorded in the shadow to the GTT at gtt.  Runs of
+ * scratch entries are filled with a single value; the writes are posted
+ * with one read at the end instead of one per entry.
+ *
+ * Returns the number of entries written.
+ */
+unsigned long emgd_gtt_shadow_restore(gtt_shadow_t *shadow,
+	unsigned long *gtt)
+{
+	unsigned long entries = shadow->entries;
+	unsigned long scratch = shadow->scratch_pte;
+	unsigned long count = 0;
+	unsigned long start, end, run_end;
+
+	start = find_next_bit(shadow->written, entries, 0);
+	while (start < entries) {
+		end = find_next_zero_bit(shadow->written, entries, start);
+		count += end - start;
+
+		while (start < end) {
+			if (test_bit(start, shadow->mapped)) {
+				run_end = find_next_zero_bit(shadow->mapped, end, start);
+				for (; start < run_end; start++) {
+					writel(shadow->pte[start], gtt + start);
+				}
+			} else {
+				run_end = find_next_bit(shadow->mapped, end, start);
+				for (; start < run_end; start++) {
+					writel(scratch, gtt + start);
+				}
+			}
+		}
+
+		start = find_next_bit(shadow->written, entries, end);
+	}
+
+	if (count) {
+		(void)readl(gtt);
+	}
+
+	return count;
+}
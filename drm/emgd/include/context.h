@@ -50,6 +50,13 @@ struct _igd_display_port;
 struct _pd_timing;
 struct _cmd_queue;
 
+/*
+ * Flag for i2c_read_regs and i2c_write_reg_list: the caller may sleep, so
+ * the request can wait for the bus without busy polling. Leave it clear on
+ * paths that can run in atomic context.
+ */
+#define IGD_I2C_CAN_SLEEP 0x4
+
 /*
  * Flags for reg_set_mod_state and reg_get_mode_state
  */
@@ -92,6 +99,9 @@ typedef struct _inter_module_dispatch {
 		igd_config_info_t *config_info);
 	int (*pi_get_config_info)(igd_context_t *context,
 		igd_config_info_t *config_info);
+	/* Completes the port probes left running by pi_init(), returning
+	 * the number of ports that became usable */
+	int (*pi_probe_finish)(igd_context_t *context);
 
 	/* Widely used DSP interfaces */
 	struct _igd_display_port *(*dsp_get_next_port)(igd_context_t *context,
@@ -216,10 +226,12 @@ typedef struct _device_context {
 	unsigned char *virt_mmadr_sdvo_st_gpio;
 	unsigned char *virt_gpio_bar;
 	unsigned long *virt_gttadr; /* was gtt_mmap */
+	unsigned long gtt_alloc_pages; /* Pages of a driver allocated GTT */
 	unsigned long gatt_pages;   /* Number of pages addressable by GTT */
 	unsigned long stolen_pages; /* Number of pages of stolen memory */
 	unsigned long gmch_ctl;     /* GMCH control value */
 	void *scratch_page;         /* Empty page to fill unused GTT entries */
+	struct _gtt_shadow *gtt_shadow; /* Copy of the PTEs the driver wrote */
 	unsigned long fb_adr;       /* Video Memory address */
 	unsigned short did;         /* Device ID for main video device */
 	unsigned long rid;          /* Device revision ID for main video device */
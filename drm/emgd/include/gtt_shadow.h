@@ -0,0 +1,60 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: gtt_shadow.h
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Kernel memory copy of the GTT entries the driver has written.  The GTT
+ *  writers record every PTE here so that suspend never has to read the
+ *  table back over MMIO and resume only rewrites the entries the driver
+ *  actually touched.
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef _GTT_SHADOW_H
+#define _GTT_SHADOW_H
+
+typedef struct _gtt_shadow {
+	unsigned long entries;       /* Number of GTT entries shadowed */
+	unsigned int scratch_pte;    /* PTE of the scratch page */
+	unsigned int *pte;           /* Last value written to each entry */
+	unsigned long *written;      /* Bitmap of entries written by the driver */
+	unsigned long *mapped;       /* Written entries not holding scratch_pte */
+} gtt_shadow_t;
+
+extern gtt_shadow_t *emgd_gtt_shadow_alloc(unsigned long entries,
+	unsigned int scratch_pte);
+extern void emgd_gtt_shadow_free(gtt_shadow_t *shadow);
+
+/*
+ * The caller serializes these against each other, the same way it
+ * serializes its own writes to the GTT.
+ */
+extern void emgd_gtt_shadow_set(gtt_shadow_t *shadow, unsigned long entry,
+	unsigned int pte);
+extern void emgd_gtt_shadow_copy(gtt_shadow_t *dst, gtt_shadow_t *src);
+extern unsigned long emgd_gtt_shadow_restore(gtt_shadow_t *shadow,
+	unsigned long *gtt);
+
+#endif
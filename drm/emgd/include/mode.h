@@ -201,6 +201,7 @@ typedef struct _igd_plane {
 	unsigned long *pixel_formats;  /* supported pixel formats */
 	void *plane_info;              /* ptr to plane_info */
 	struct _igd_plane *mirror;     /* pointer to mirror plane */
+	int           programmed;      /* registers hold plane_info */
 } igd_plane_t;
 
 typedef struct _igd_display_plane {
@@ -211,6 +212,7 @@ typedef struct _igd_display_plane {
 	unsigned long *pixel_formats;    /* list of pixel formats supported */
 	igd_framebuffer_info_t *fb_info; /* attached fb to this plane */
 	struct _igd_display_plane *mirror;  /* pointer to mirror plane */
+	int           programmed;        /* registers hold fb_info */
 } igd_display_plane_t, *pigd_display_plane_t;
 
 typedef struct _igd_cursor {
@@ -221,8 +223,27 @@ typedef struct _igd_cursor {
 	unsigned long *pixel_formats;    /* list of pixel_formats supported */
 	igd_cursor_info_t *cursor_info;
 	struct _igd_cursor *mirror;  /* pointer to mirror plane */
+	int           programmed;        /* unused, see igd_plane_t */
 } igd_cursor_t;
 
+/*
+ * Driver state kept behind a cursor's cursor_info.  igd_cursor_info_t is
+ * passed through the alter_cursor ioctl, so it can't grow; the cursor_info
+ * dsp allocates is one of these instead.
+ */
+typedef struct _igd_cursor_priv {
+	igd_cursor_info_t cursor_info;  /* must be first */
+	unsigned long argb_back_offset; /* ARGB image shown next, 0 if none */
+	unsigned long long argb_hash;   /* image at argb_offset, 0 if unknown */
+	unsigned long long argb_back_hash; /* image at argb_back_offset */
+	unsigned long long xor_hash;    /* image at xor_offset */
+	unsigned long argb_shown_offset; /* ARGB image being scanned out */
+	unsigned long base_frame;       /* pipe frame of the last base write */
+	int           base_pending;     /* base write may not have latched yet */
+} igd_cursor_priv_t;
+
+#define CURSOR_PRIV(ci) ((igd_cursor_priv_t *)(ci))
+
 typedef struct _igd_clock {
 	unsigned long dpll_control;     /* DPLL control register */
 	unsigned long mnp;              /* FPx0 register */
@@ -297,6 +318,19 @@ typedef struct _igd_display_port {
 	unsigned long         mult_preserve;
 	unsigned long         vga_sync;
 
+	/* Sorted index of timing_table, see pi_index_timings() */
+	igd_timing_info_t     **timing_index;
+	igd_timing_info_t     *index_table; /* timing_table the index is for */
+	unsigned long         num_index;    /* number of entries in timing_index */
+
+	/* IGD_I2C_CAN_SLEEP while a process context caller is in the port
+	 * driver, passed on by pi_read_regs() and pi_write_regs() */
+	unsigned long         pd_i2c_flags;
+
+	/* Set while the port's load time probe still runs in the background;
+	 * dsp_get_next_port() skips the port until then */
+	int                   probing;
+
 }igd_display_port_t, *pigd_display_port_t;
 
 /* This structure is used to save mode state.
@@ -338,6 +372,28 @@ typedef struct _emgdfb_par {
 } emgdfb_par_t;
 
 
+/* Most page flips a CRTC can hold that haven't been programmed yet */
+#define EMGD_FLIP_QUEUE_MAX 4
+
+/**
+ * A page flip request.
+ */
+typedef struct _emgd_flip {
+	emgd_framebuffer_t *fb;
+
+	/*
+	 * Rendering operations may continue to be dispatched against the FB
+	 * after the flip ioctl is called, so this is the number of write
+	 * operations that were pending at that point; the flip proceeds once
+	 * they have completed.
+	 */
+	unsigned long render_complete_at;
+
+	/* Userspace event to send back upon flip completion (may be NULL) */
+	struct drm_pending_vblank_event *event;
+} emgd_flip_t;
+
+
 /**
  * This holds information about a CRTC.
  */
@@ -358,35 +414,44 @@ typedef struct _emgd_crtc {
         unsigned char           lut_b[256];
         unsigned char           lut_a[256];
 
-		/* Flip request work task */
-		struct work_struct      flip_work;
-		unsigned char           flip_work_queued;
-
 		/*
-		 * Framebuffer that we're in the process of flipping to (may not
-		 * actually show up until rendering is complete, the actual
-		 * registers are programmed, and a vblank happens).
+		 * Palette shadow.  lut_hw holds the values reg_crtc_lut_set()
+		 * writes, lut_dirty the entries it still has to write.  While
+		 * lut_pending is set a vblank reference is held and the vblank
+		 * handler writes them.  lut_valid is cleared when the palette is
+		 * rewritten from elsewhere, so the next load_lut writes it all.
+		 * lut_pipe_on says whether the pipe is enabled with a source
+		 * size.  The Atom E6xx kms pipe functions set it when they
+		 * program or power the pipe, so reg_crtc_lut_set_tnc() doesn't
+		 * read the pipe registers from the vblank handler.
 		 */
-		emgd_framebuffer_t *newfb;
+		unsigned long           lut_hw[256];
+		DECLARE_BITMAP(lut_dirty, 256);
+		unsigned char           lut_valid;
+		unsigned char           lut_pending;
+		unsigned char           lut_pipe_on;
 
 		/*
-		 * Target for rendering completion to allow flip to proceed.
-		 * Rendering operations may continue to be dispatched against this
-		 * FB after the flip ioctl is called, so we need to track the
-		 * number of pending operations at the point the ioctl was called
-		 * and use that as our target to flip on.
+		 * Flip request work task.  It programs the flip at the head of
+		 * flip_queue once its rendering is complete and the previous flip
+		 * has reached the screen.  flip_waiter (a PVR sync waiter, set up
+		 * by the task itself) requeues it when rendering completes.
 		 */
-		unsigned long render_complete_at;
+		struct work_struct      flip_work;
+		void                   *flip_waiter;
+
+		/* Flips not yet programmed, oldest first (a ring) */
+		emgd_flip_t             flip_queue[EMGD_FLIP_QUEUE_MAX];
+		unsigned int            flip_head;
+		unsigned int            flip_count;
 
 		/*
-		 * Are we waiting for the next vblank event to perform flip cleanup
-		 * on this CRTC?  Flip cleanup primarily involves sending a
-		 * notification event back to userspace.
+		 * Flip programmed into the plane registers and waiting for the
+		 * next vblank, which completes it.  A vblank reference is held
+		 * while vblank_expected is set.
 		 */
-		unsigned char vblank_expected;
-
-		/* Userspace event to send back upon flip completion. */
-		struct drm_pending_vblank_event *flip_event;
+		emgd_flip_t             flip_latched;
+		unsigned char           vblank_expected;
 } emgd_crtc_t;
 
 
@@ -487,6 +487,10 @@ typedef struct _pd_timing {
 #define PD_FLAG_GANG_MODE_DVOCLKINV 0x00000400 /* GangMode DVO Clk inversion */
 #define PD_FLAG_NO_VGA_2X_IMAGE     0x00000800 /* Gang Mode operation might
 												* request this flag */
+#define PD_FLAG_I2C_BURST           0x00001000 /* Device auto-increments its
+												* I2C register index, so runs
+												* of consecutive registers
+												* may share one transfer */
 
 /* Flag for set_mode function */
 /* Though these are bit fields, both cannot be used at same time */
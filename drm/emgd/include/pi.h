@@ -83,4 +83,13 @@ extern int pi_get_port_init_attr(igd_display_port_t *port,
 		unsigned long *value);
 extern int pi_save_mode_state(igd_display_port_t *port,
 		reg_state_id_t reg_state_id);
+
+#ifndef CONFIG_MICRO
+/* Sorted index of port->timing_table used by the mode match code */
+extern void pi_index_timings(igd_display_port_t *port);
+extern void pi_free_timing_index(igd_display_port_t *port);
+extern igd_timing_info_t *pi_find_timing(igd_display_port_t *port,
+		unsigned short width, unsigned short height, unsigned short refresh,
+		unsigned long flags);
+#endif
 #endif /* _PI_H_ */
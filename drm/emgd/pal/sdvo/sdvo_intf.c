@@ -58,6 +58,10 @@ void sdvo_convert_dtd_to_parm(
 					The opcode is then transferred to the opcode I2C register
 					It then waits for the command to complete by reading the
 					status I2C register up to 3 times
+					Arguments the device already holds are not written
+					again, and the status and return registers are read
+					together, so a command is usually one write and one
+					read burst
 
 	Returns 	:	sdvo_status_t : Status of command execution
 	------------------------------------------------------------------------- */
@@ -66,7 +70,9 @@ sdvo_status_t sdvo_execute_command(sdvo_device_context_t *p_ctx,
 	i2c_reg_t num_args,	   i2c_reg_t *p_arg,
 	i2c_reg_t num_returns, i2c_reg_t *p_ret_value)
 {
-	i2c_reg_t status, i;
+	pd_reg_t reg_list[SDVO_MAX_ARGS + 2];
+	i2c_reg_t reply[1 + SDVO_MAX_RETURNS];
+	i2c_reg_t status = SS_PENDING, i, first;
 
 	/*	..................................................................... */
 	/*	Error checking */
@@ -87,47 +93,70 @@ sdvo_status_t sdvo_execute_command(sdvo_device_context_t *p_ctx,
 
 	/*	..................................................................... */
 	/*	Write the arguments and the opcode */
-	for (i = 0; i < num_args; i++) {
+	/*	Argument i sits in register 7 - i, just below the opcode register, */
+	/*	so the registers from the last changed argument up to the opcode */
+	/*	go out in one burst */
+	for (first = num_args; first > 0; first--) {
 
-		if (! sdvo_write_i2c_reg(p_ctx, (i2c_reg_t)(SDVO_REG_ARG_START - i),
-				p_arg[i])) {
+		if (!(p_ctx->arg_valid & (1 << (first - 1))) ||
+			(p_ctx->arg_shadow[first - 1] != p_arg[first - 1])) {
 
-			return SS_WRITE_FAILED;
+			break;
 		}
 	}
 
-	if (! sdvo_write_i2c_reg(p_ctx, (i2c_reg_t)SDVO_REG_OPCODE,
-			(i2c_reg_t)opcode)) {
+	for (i = 0; i < first; i++) {
+
+		reg_list[i].reg = SDVO_REG_ARG_START - (first - 1 - i);
+		reg_list[i].value = p_arg[first - 1 - i];
+	}
+	reg_list[first].reg = SDVO_REG_OPCODE;
+	reg_list[first].value = (i2c_reg_t)opcode;
+	reg_list[first + 1].reg = PD_REG_LIST_END;
+
+	if (p_ctx->p_callback->write_regs(p_ctx->p_callback->callback_context,
+			reg_list, PD_REG_I2C)) {
 
+		p_ctx->arg_valid = 0;
 		return SS_WRITE_FAILED;
 	}
 
+	for (i = 0; i < num_args; i++) {
+
+		p_ctx->arg_shadow[i] = p_arg[i];
+		p_ctx->arg_valid |= (1 << i);
+	}
+
 	/*	..................................................................... */
-	/*	Wait for command to complete */
+	/*	Wait for command to complete, reading the returns with the status */
 	for (i = 0; i < SDVO_MAX_RETRIES; i++) {
 
-		if (! sdvo_read_i2c_reg(p_ctx, SDVO_REG_STATUS, &status)) {
+		if (! sdvo_read_i2c_regs(p_ctx, SDVO_REG_STATUS, 1 + num_returns,
+				reply)) {
 
 			return SS_READ_FAILED;
 		}
 
+		status = reply[0];
 		if (status != SS_PENDING) {
 
 			break;
 		}
 	}
 
+	/*	A reset or power cycle leaves the argument registers unknown */
+	if ((opcode == RESET) || (status == SS_POWER_ON_STATE)) {
+
+		p_ctx->arg_valid = 0;
+	}
+
 	/*	..................................................................... */
-	/*	Read the return parameters if command succeeded */
+	/*	Return the return parameters if command succeeded */
 	if (status == SS_SUCCESS) {
 
 		for (i = 0; i < num_returns; i++) {
 
-			if (! sdvo_read_i2c_reg(p_ctx, SDVO_REG_RETURN_START + i,
-					&p_ret_value[i])) {
-
-				 return SS_READ_FAILED;
-			}
+			p_ret_value[i] = reply[1 + i];
 		}
 	}
 
@@ -137,25 +166,29 @@ sdvo_status_t sdvo_execute_command(sdvo_device_context_t *p_ctx,
 sdvo_status_t sdvo_execute_command_read (sdvo_device_context_t *p_ctx,
 	i2c_reg_t num_returns, i2c_reg_t *p_ret_value)
 {
-	i2c_reg_t status, i;
+	i2c_reg_t reply[1 + SDVO_MAX_RETURNS];
+	i2c_reg_t status = SS_PENDING, i;
+
+	if (num_returns > SDVO_MAX_RETURNS) {
+		return SS_UNSUCCESSFUL;
+	}
 
 	for (i = 0; i < SDVO_MAX_RETRIES; i++) {
-		if (!sdvo_read_i2c_reg(p_ctx, SDVO_REG_STATUS, &status)) {
+		if (!sdvo_read_i2c_regs(p_ctx, SDVO_REG_STATUS, 1 + num_returns,
+				reply)) {
 			return SS_READ_FAILED;
 		}
 
+		status = reply[0];
 		if (status != SS_PENDING) {
 			break;
 		}
 	}
 
-	/*	Read the return parameters if command succeeded */
+	/*	Return the return parameters if command succeeded */
 	if (status == SS_SUCCESS) {
 		for (i = 0; i < num_returns; i++) {
-			if (! sdvo_read_i2c_reg(p_ctx, SDVO_REG_RETURN_START + i,
-					&p_ret_value[i])) {
-				 return SS_READ_FAILED;
-			}
+			p_ret_value[i] = reply[1 + i];
 		}
 	}
 	return status;
@@ -723,3 +756,35 @@ unsigned char sdvo_read_i2c_reg(sdvo_device_context_t *p_ctx, unsigned char offs
 		return TRUE;
 	}
 }
+
+/* Reads num_regs consecutive registers; the port layer makes it one burst */
+unsigned char sdvo_read_i2c_regs(sdvo_device_context_t *p_ctx,
+	unsigned char offset, i2c_reg_t num_regs, i2c_reg_t *p_value)
+{
+	pd_reg_t reg_list[1 + SDVO_MAX_RETURNS + 1];
+	i2c_reg_t i;
+
+	if (num_regs > 1 + SDVO_MAX_RETURNS) {
+
+		return FALSE;
+	}
+
+	for (i = 0; i < num_regs; i++) {
+
+		reg_list[i].reg = offset + i;
+	}
+	reg_list[num_regs].reg = PD_REG_LIST_END;
+
+	if (p_ctx->p_callback->read_regs(p_ctx->p_callback->callback_context, reg_list,
+								   PD_REG_I2C)) {
+
+		return FALSE;
+	}
+
+	for (i = 0; i < num_regs; i++) {
+
+		p_value[i] = (i2c_reg_t)reg_list[i].value;
+	}
+
+	return TRUE;
+}
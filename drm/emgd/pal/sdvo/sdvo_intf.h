@@ -384,6 +384,9 @@ typedef struct _sdvo_device_context {
 	unsigned short             text_tune;
 	sdvo_hdmi_context_t		   hdmi;
 	unsigned short             st_sdvo;
+	/* Argument registers as last written; bit i of arg_valid covers arg i */
+	i2c_reg_t                  arg_shadow[SDVO_MAX_ARGS];
+	unsigned char              arg_valid;
 } sdvo_device_context_t;
 
 typedef struct sdvo_state {
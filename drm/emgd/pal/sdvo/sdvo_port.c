@@ -83,7 +83,7 @@ static pd_driver_t	 g_sdvo_drv = {
 	0,
 	&g_sdvo_version,
 	PD_DISPLAY_FP,
-	PD_FLAG_CLOCK_MASTER,
+	PD_FLAG_CLOCK_MASTER | PD_FLAG_I2C_BURST,
 	g_sdvo_dab_list,
 	1000,
 	sdvo_validate,
@@ -3308,6 +3308,9 @@ int sdvo_restore(void *p_context, void *p_state, unsigned long flags)
 		return PD_ERR_NULL_STATE;
 	}
 
+	/* The encoder may have lost power since the arguments were written */
+	pd_context->arg_valid = 0;
+
 	sdvo_reset_encoder(p_context);    /* Reset the sdvo device to known state for good
 							   * start. */
 	/* Add the code to process the CH7022 card */
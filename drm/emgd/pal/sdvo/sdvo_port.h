@@ -60,6 +60,8 @@ unsigned char sdvo_write_i2c_reg(sdvo_device_context_t *p_Ctx, i2c_reg_t offset,
 	i2c_reg_t value);
 unsigned char sdvo_read_i2c_reg(sdvo_device_context_t *p_Ctx, unsigned char offset,
 	i2c_reg_t *p_Value);
+unsigned char sdvo_read_i2c_regs(sdvo_device_context_t *p_ctx,
+	unsigned char offset, i2c_reg_t num_regs, i2c_reg_t *p_value);
 
 
 int sdvo_is_multi_display_device(sdvo_device_context_t *p_ctx);
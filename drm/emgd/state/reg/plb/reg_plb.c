@@ -629,12 +629,14 @@ static void reg_crtc_lut_set_plb(
                 (emgd_crtc->crtc_id * (DPALETTE_B - DPALETTE_A)));
 
             /* Restore Pipe A Palette */
-            for (i=0; i<DAC_DATA_COUNT; i++)  {
-                EMGD_WRITE32((emgd_crtc->lut_r[i] << 16) |
-                    (emgd_crtc->lut_g[i] << 8) |
-                    emgd_crtc->lut_b[i],
-                    pal_reg + i*4);
+            /* Only the entries emgd_crtc_load_lut() queued */
+            for (i = find_first_bit(emgd_crtc->lut_dirty, DAC_DATA_COUNT);
+                i < DAC_DATA_COUNT;
+                i = find_next_bit(emgd_crtc->lut_dirty, DAC_DATA_COUNT,
+                    i + 1)) {
+                EMGD_WRITE32(emgd_crtc->lut_hw[i], pal_reg + i*4);
             }
+            bitmap_zero(emgd_crtc->lut_dirty, DAC_DATA_COUNT);
         }
     }
 
@@ -52,6 +52,7 @@
 
 #include <tnc/regs.h>
 #include <plb/context.h>
+#include <gtt_shadow.h>
 
 #include "../cmn/reg_dispatch.h"
 
@@ -308,6 +309,7 @@ typedef struct _reg_buffer_tnc {
 	d3d_state_tnc_t d3d_state;
 	void *rb_state;
 	unsigned long pci_lbb;
+	struct _gtt_shadow *gtt_saved; /* GTT shadow snapshot, if shadowed */
 } reg_buffer_tnc_t;
 
 static reg_platform_context_tnc_t reg_platform_context_tnc = {
@@ -338,6 +340,10 @@ static int reg_save_gtt_tnc(igd_context_t *context, unsigned char *mmio,
 static int reg_restore_gtt_tnc(igd_context_t *context,
 	reg_buffer_tnc_t *reg_args);
 
+/* gmm/gtt.c */
+extern int emgd_gtt_save(igd_context_t *context, gtt_shadow_t **saved);
+extern int emgd_gtt_restore(igd_context_t *context, gtt_shadow_t *saved);
+
 /*!
  * This procedure simply waits for the next vertical syncing (vertical retrace)
  * period. If the display is already in a vertical syncing period, this
@@ -654,23 +660,23 @@ static void reg_crtc_lut_set_tnc(
 
 	mmio = context->device_context.virt_mmadr;
 
-    /* Check if the pipe is enabled */
-    if ((emgd_crtc->crtc_id == IGD_KMS_PIPEA &&
-		((EMGD_READ32(mmio + PIPEA_CONF) & PIPE_ENABLE) &&
-        (EMGD_READ32(mmio + PIPEASRC)))) ||
-		(emgd_crtc->crtc_id == IGD_KMS_PIPEB &&
-		((EMGD_READ32(mmio + PIPEB_CONF) & PIPE_ENABLE) &&
-        (EMGD_READ32(mmio + PIPEBSRC))))) {
+	/*
+	 * Check if the pipe is enabled.  This runs from the vblank handler,
+	 * so use the state kms_update_pipe_on_tnc() cached at mode set
+	 * rather than reading the pipe registers.
+	 */
+	if (emgd_crtc->lut_pipe_on) {
 
 		pal_reg = (unsigned long)(mmio + DPALETTE_A +
 			(emgd_crtc->crtc_id * (DPALETTE_B - DPALETTE_A)));
 
-        for (i=0; i<DAC_DATA_COUNT; i++)  {
-            EMGD_WRITE32((emgd_crtc->lut_r[i] << 16) |
-				(emgd_crtc->lut_g[i] << 8) |
-				emgd_crtc->lut_b[i],
-				pal_reg + i*4);
-        }
+		/* Only the entries emgd_crtc_load_lut() queued */
+		for (i = find_first_bit(emgd_crtc->lut_dirty, DAC_DATA_COUNT);
+			i < DAC_DATA_COUNT;
+			i = find_next_bit(emgd_crtc->lut_dirty, DAC_DATA_COUNT, i + 1)) {
+			EMGD_WRITE32(emgd_crtc->lut_hw[i], pal_reg + i*4);
+		}
+		bitmap_zero(emgd_crtc->lut_dirty, DAC_DATA_COUNT);
     }
 
 	EMGD_TRACE_EXIT;
@@ -877,6 +883,8 @@ static void reg_free_tnc(igd_context_t *context,
 			if (NULL != reg_args->rb_state) {
 				OS_FREE(reg_args->rb_state);
 			}
+
+			emgd_gtt_shadow_free(reg_args->gtt_saved);
 			OS_FREE(reg_args);
 		}
 		OS_FREE(reg_buffer);
@@ -1153,7 +1161,9 @@ int reg_restore_tnc(igd_context_t *context,
 
 /*!
  * This function saves the GTT table entries into a buffer so that the GTT
- * can be restored later.
+ * can be restored later.  When the GTT writers keep a shadow of the table
+ * the shadow is snapshotted instead of reading the table back, so restore
+ * still puts back the state at save time.
  *
  * @param context needs this to get the GTT table size and to get the
  * 	virtual address to the GTT table
@@ -1168,6 +1178,10 @@ static int reg_save_gtt_tnc(igd_context_t *context, unsigned char *mmio,
 {
 	unsigned int  i;
 
+	if (emgd_gtt_save(context, &reg_args->gtt_saved)) {
+		return 0;
+	}
+
 	/* Read the GTT entries from GTT ADR and save it in the array. */
 	for (i = 0; i < (context->device_context.gatt_pages); i++) {
 		reg_args->gtt[i] = EMGD_READ32(
@@ -1191,6 +1205,11 @@ static int reg_restore_gtt_tnc(igd_context_t *context,
 {
 	unsigned int i;
 
+	/* Rewrite only the entries the driver populated */
+	if (emgd_gtt_restore(context, reg_args->gtt_saved)) {
+		return 0;
+	}
+
 	/* If the first element is 0, then nothing was saved */
 	if (0 == reg_args->gtt[0]) {
 		return 0;
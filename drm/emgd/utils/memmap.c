@@ -30,6 +30,7 @@
  *-----------------------------------------------------------------------------
  */
 #include <io.h>
+#include <emgd_vtnc.h>
 
 #ifndef _OAL_LINUX_KERNEL_IO_MEMMAP_H
 #define _OAL_LINUX_KERNEL_IO_MEMMAP_H
@@ -40,6 +41,11 @@ void * os_map_io_to_mem_nocache(
 				unsigned long size
 				)
 {
+#ifdef EMGD_VIRTUAL_TNC
+  if (emgd_vtnc) {
+    return emgd_vtnc_map(base_address, size);
+  }
+#endif
   return ioremap(base_address, size);
 }
 
@@ -48,6 +54,11 @@ void os_unmap_io_from_mem(
 			  unsigned long size
 			  )
 {
+#ifdef EMGD_VIRTUAL_TNC
+  if (emgd_vtnc && emgd_vtnc_unmap(virt_addr)) {
+    return;
+  }
+#endif
   iounmap(virt_addr);
 }
 
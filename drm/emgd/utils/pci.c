@@ -33,6 +33,7 @@
 #include <pci.h>
 #include <linux/pci.h>
 #include <io.h>
+#include <emgd_vtnc.h>
 
 #if defined(CONFIG_VGA_ARB)
 #include <linux/vgaarb.h>
@@ -78,6 +79,28 @@ static os_pci_dev_t pci_find_device_generic(
   struct pci_dev *our_device; // Kernel struct for a PCI device
   linuxkernel_pci_t *pdev; // Our struct for a PCI device.
 
+#ifdef EMGD_VIRTUAL_TNC
+    // The virtual device has no pci_dev; its functions are told apart
+    // by slot alone.
+    if (emgd_vtnc) {
+      int slot = emgd_vtnc_pci_find(vendor_id, device_id);
+
+      if (slot < 0) {
+        return (os_pci_dev_t)NULL;
+      }
+      pdev = (linuxkernel_pci_t *)pci_dev_handle;
+      if(!pdev) {
+        pdev = (linuxkernel_pci_t *)OS_ALLOC(sizeof(linuxkernel_pci_t));
+        if(!pdev) {
+          return (os_pci_dev_t)NULL;
+        }
+      }
+      memset(pdev, 0, sizeof(linuxkernel_pci_t));
+      pdev->slot = slot;
+      return (os_pci_dev_t)pdev;
+    }
+#endif
+
     // Locate the device, and lock it. Start search at the start of the list.
     our_device = pci_get_device(vendor_id, device_id, NULL);
     // If we didn't find it, return an error.
@@ -183,6 +206,11 @@ int os_pci_read_config_8(
   linuxkernel_pci_t *pdev = (linuxkernel_pci_t *)pci_dev;
   EMGD_ASSERT(pdev, "Invalid pci device", 0);
   EMGD_ASSERT(val, "Invalid pointer", 0);
+#ifdef EMGD_VIRTUAL_TNC
+  if (!pdev->dev) {
+    return emgd_vtnc_pci_read(pdev->slot, offset, val, 1);
+  }
+#endif
   return pci_read_config_byte(pdev->dev, offset, val);
 }
 
@@ -195,6 +223,11 @@ int os_pci_read_config_16(
   linuxkernel_pci_t *pdev = (linuxkernel_pci_t *)pci_dev;
   EMGD_ASSERT(pdev, "Invalid pci device", 0);
   EMGD_ASSERT(val, "Invalid pointer", 0);
+#ifdef EMGD_VIRTUAL_TNC
+  if (!pdev->dev) {
+    return emgd_vtnc_pci_read(pdev->slot, offset, val, 2);
+  }
+#endif
   return pci_read_config_word(pdev->dev, offset,val);
 }
 
@@ -207,6 +240,15 @@ int os_pci_read_config_32(
   linuxkernel_pci_t *pdev = (linuxkernel_pci_t *)pci_dev;
   EMGD_ASSERT(pdev, "Invalid pci device", 0);
   EMGD_ASSERT(val, "Invalid pointer", 0);
+#ifdef EMGD_VIRTUAL_TNC
+  if (!pdev->dev) {
+    u32 val32;
+    int ret = emgd_vtnc_pci_read(pdev->slot, offset, &val32, 4);
+
+    *val = val32;
+    return ret;
+  }
+#endif
   return pci_read_config_dword(pdev->dev, offset, (u32*)val);
 }
 
@@ -218,6 +260,11 @@ int os_pci_write_config_8(
 {
   linuxkernel_pci_t *pdev = (linuxkernel_pci_t *)pci_dev;
   EMGD_ASSERT(pdev, "Invalid pci device", 0);
+#ifdef EMGD_VIRTUAL_TNC
+  if (!pdev->dev) {
+    return emgd_vtnc_pci_write(pdev->slot, offset, val, 1);
+  }
+#endif
   return pci_write_config_byte(pdev->dev, offset, val);
 }
 
@@ -229,6 +276,11 @@ int os_pci_write_config_16(
 {
   linuxkernel_pci_t *pdev = (linuxkernel_pci_t *)pci_dev;
   EMGD_ASSERT(pdev, "Invalid pci device", 0);
+#ifdef EMGD_VIRTUAL_TNC
+  if (!pdev->dev) {
+    return emgd_vtnc_pci_write(pdev->slot, offset, val, 2);
+  }
+#endif
   return pci_write_config_word(pdev->dev, offset, val);
 }
 
@@ -240,6 +292,11 @@ int os_pci_write_config_32(
 {
   linuxkernel_pci_t *pdev = (linuxkernel_pci_t *)pci_dev;
   EMGD_ASSERT(pdev, "Invalid pci device", 0);
+#ifdef EMGD_VIRTUAL_TNC
+  if (!pdev->dev) {
+    return emgd_vtnc_pci_write(pdev->slot, offset, val, 4);
+  }
+#endif
   return pci_write_config_dword(pdev->dev, offset, val);
 }
 
@@ -251,7 +308,9 @@ int os_pci_disable_legacy_vga_decoding(
 	linuxkernel_pci_t *pdev = (linuxkernel_pci_t *)pci_dev;
 	EMGD_ASSERT(pdev, "Invalid pci device", 0);
 
-	vga_set_legacy_decoding(pdev->dev, VGA_RSRC_NONE);
+	if (pdev->dev) {
+		vga_set_legacy_decoding(pdev->dev, VGA_RSRC_NONE);
+	}
 #else
 	/* Noop if the VGA arbiter isn't compiled into the kernel */
 #endif
@@ -1461,6 +1461,8 @@ int process_video_decode_plb(igd_context_t *context, unsigned long offset,
 		return -EINVAL;
 	}
 
+	trace_emgd_video_submit(EMGD_TRACE_ENGINE_MSVDX, offset, mtx_msg_cnt);
+
 	if (mtx_msg_cnt > 0) {
 	//if ((mtx_buf[0] != 0x8) || (mtx_buf[2] != 0x8504)) {
 
@@ -1960,6 +1960,7 @@ static int alter_ovl_plb(igd_display_context_t *display,
 	int ret;
 
 	EMGD_TRACE_ENTER;
+	trace_emgd_ovl_update(src_surf ? src_surf->offset : 0, flags);
 	/* Dump overlay parameters for debugging */
 	/*
 	printk (KERN_ERR " alter_ovl_plb  Entry."
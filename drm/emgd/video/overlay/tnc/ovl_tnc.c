@@ -2058,6 +2058,7 @@ static int alter_ovl_tnc(igd_display_context_t *display,
 	int ret;
 
 	EMGD_TRACE_ENTER;
+	trace_emgd_ovl_update(src_surf ? src_surf->offset : 0, flags);
 
 	/* Check to ensure the overlay can be used given the current mode as
 	 * well as what the IAL is asking for.  If not return an error. */
@@ -259,6 +259,8 @@ int process_encode_mtx_messages(igd_context_t *context,
 		return -IGD_ERROR_INVAL;
 	}
 
+	trace_emgd_video_submit(EMGD_TRACE_ENGINE_TOPAZ, 0, size);
+
 	while (cur_cmd_id != MTX_CMDID_NULL) {
 
 		switch (cur_cmd_id) {
@@ -0,0 +1,63 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: emgd_flip_log.h
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Per flip records kept by the display class driver (emgd_dc) and
+ *  streamed through debugfs (emgd_flip/events). Shared with userspace
+ *  readers, so it must not depend on kernel headers.
+ *
+ *  Vblank numbers count the vblanks the display class driver has seen on
+ *  that display; it only sees them while a flip-able swap chain exists.
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef _EMGD_FLIP_LOG_H
+#define _EMGD_FLIP_LOG_H
+
+/* Flipped and completed at submit time (swap interval 0 or flushing) */
+#define EMGD_FLIP_LOG_IMMEDIATE		0x01
+/* Landed after both the previous frame's swap interval and the first
+ * vblank after submission */
+#define EMGD_FLIP_LOG_MISSED		0x02
+/* Completed early because the queue was flushed (e.g. mode change) */
+#define EMGD_FLIP_LOG_FLUSHED		0x04
+
+typedef struct _emgd_flip_log_entry {
+	unsigned long long submit_ns;	/* flip command received, monotonic */
+	unsigned long long flip_ns;		/* surface programmed */
+	unsigned long long landed_ns;	/* flip completed at a vblank */
+	unsigned int swap_chain;		/* swap chain ID */
+	unsigned int submit_vblank;
+	unsigned int landed_vblank;
+	unsigned short queue_depth;		/* flips queued ahead at submit */
+	unsigned short swap_interval;	/* requested vblanks per frame */
+	unsigned short prev_shown;		/* vblanks the previous frame was up */
+	unsigned char flags;			/* EMGD_FLIP_LOG_* */
+	unsigned char display;			/* 0 primary, 1 secondary */
+	unsigned int reserved;
+} emgd_flip_log_entry_t;
+
+#endif
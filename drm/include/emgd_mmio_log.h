@@ -0,0 +1,54 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: emgd_mmio_log.h
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Layout of the MMIO access log exported by emgd_mmio.c through
+ *  debugfs (emgd_mmio/log). Shared with tools/emgd_mmio_replay, so it
+ *  must not depend on kernel headers.
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef _EMGD_MMIO_LOG_H
+#define _EMGD_MMIO_LOG_H
+
+#define EMGD_MMIO_LOG_READ		0
+#define EMGD_MMIO_LOG_WRITE		1
+#define EMGD_MMIO_LOG_MARK		2
+
+/* Region for addresses outside every registered MMIO window */
+#define EMGD_MMIO_LOG_NO_REGION	0xff
+
+typedef struct _emgd_mmio_log_entry {
+	unsigned long long timestamp;	/* ns, monotonic */
+	unsigned int offset;			/* offset in region, or mark type */
+	unsigned int value;
+	unsigned char type;				/* EMGD_MMIO_LOG_* */
+	unsigned char region;			/* EMGD_MMIO_REGION_* */
+	unsigned short reserved;
+	unsigned int reserved2;
+} emgd_mmio_log_entry_t;
+
+#endif
@@ -0,0 +1,167 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: emgd_trace.h
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Kernel tracepoints for the EMGD driver. These are present in production
+ *  drivers; when disabled each call site costs a single patched branch.
+ *  Enable them through the "emgd" system in the kernel's tracing directory
+ *  (events/emgd/) and post-process the output with tools/emgd_trace_hist.
+ *
+ *  The tracepoint definitions are instantiated in emgd_trace.c.
+ *-----------------------------------------------------------------------------
+ */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM emgd
+
+#if !defined(_EMGD_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _EMGD_TRACE_H
+
+#include <linux/tracepoint.h>
+
+/*
+ * Function entry and exit, generated by EMGD_TRACE_ENTER/EMGD_TRACE_EXIT
+ * and EMGD_ERROR_EXIT.
+ */
+DECLARE_EVENT_CLASS(emgd_func,
+	TP_PROTO(const char *func),
+	TP_ARGS(func),
+	TP_STRUCT__entry(
+		__string(func, func)
+	),
+	TP_fast_assign(
+		__assign_str(func, func);
+	),
+	TP_printk("%s", __get_str(func))
+);
+
+DEFINE_EVENT(emgd_func, emgd_func_enter,
+	TP_PROTO(const char *func),
+	TP_ARGS(func)
+);
+
+DEFINE_EVENT(emgd_func, emgd_func_exit,
+	TP_PROTO(const char *func),
+	TP_ARGS(func)
+);
+
+TRACE_EVENT(emgd_mode_set,
+	TP_PROTO(int crtc, int width, int height, int refresh),
+	TP_ARGS(crtc, width, height, refresh),
+	TP_STRUCT__entry(
+		__field(int, crtc)
+		__field(int, width)
+		__field(int, height)
+		__field(int, refresh)
+	),
+	TP_fast_assign(
+		__entry->crtc = crtc;
+		__entry->width = width;
+		__entry->height = height;
+		__entry->refresh = refresh;
+	),
+	TP_printk("crtc=%d %dx%d@%d", __entry->crtc, __entry->width,
+		__entry->height, __entry->refresh)
+);
+
+TRACE_EVENT(emgd_flip,
+	TP_PROTO(int crtc, unsigned long offset),
+	TP_ARGS(crtc, offset),
+	TP_STRUCT__entry(
+		__field(int, crtc)
+		__field(unsigned long, offset)
+	),
+	TP_fast_assign(
+		__entry->crtc = crtc;
+		__entry->offset = offset;
+	),
+	TP_printk("crtc=%d offset=0x%lx", __entry->crtc, __entry->offset)
+);
+
+TRACE_EVENT(emgd_ovl_update,
+	TP_PROTO(unsigned long offset, unsigned int flags),
+	TP_ARGS(offset, flags),
+	TP_STRUCT__entry(
+		__field(unsigned long, offset)
+		__field(unsigned int, flags)
+	),
+	TP_fast_assign(
+		__entry->offset = offset;
+		__entry->flags = flags;
+	),
+	TP_printk("offset=0x%lx flags=0x%x", __entry->offset, __entry->flags)
+);
+
+TRACE_EVENT(emgd_gmm_alloc,
+	TP_PROTO(unsigned long offset, unsigned long size, int ret),
+	TP_ARGS(offset, size, ret),
+	TP_STRUCT__entry(
+		__field(unsigned long, offset)
+		__field(unsigned long, size)
+		__field(int, ret)
+	),
+	TP_fast_assign(
+		__entry->offset = offset;
+		__entry->size = size;
+		__entry->ret = ret;
+	),
+	TP_printk("offset=0x%lx size=%lu ret=%d", __entry->offset,
+		__entry->size, __entry->ret)
+);
+
+#define EMGD_TRACE_ENGINE_MSVDX 0
+#define EMGD_TRACE_ENGINE_TOPAZ 1
+
+/*
+ * For MSVDX len is the number of MTX messages in the batch; for Topaz it
+ * is the size of the command buffer in bytes.
+ */
+TRACE_EVENT(emgd_video_submit,
+	TP_PROTO(unsigned int engine, unsigned long offset, unsigned long len),
+	TP_ARGS(engine, offset, len),
+	TP_STRUCT__entry(
+		__field(unsigned int, engine)
+		__field(unsigned long, offset)
+		__field(unsigned long, len)
+	),
+	TP_fast_assign(
+		__entry->engine = engine;
+		__entry->offset = offset;
+		__entry->len = len;
+	),
+	TP_printk("engine=%s offset=0x%lx len=%lu",
+		__entry->engine == EMGD_TRACE_ENGINE_TOPAZ ? "topaz" : "msvdx",
+		__entry->offset, __entry->len)
+);
+
+#endif /* _EMGD_TRACE_H */
+
+/* This part must be outside the header guard */
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE emgd_trace
+#include <trace/define_trace.h>
@@ -0,0 +1,91 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: emgd_vtnc.h
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Hooks into the virtual Atom E6xx device implemented in emgd_vtnc.c.
+ *  They only exist when the driver is built with VIRTUAL_TNC=1 and only
+ *  take effect when the "vtnc" module parameter is set; callers must
+ *  test emgd_vtnc first.
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef _EMGD_VTNC_H
+#define _EMGD_VTNC_H
+
+#ifdef EMGD_VIRTUAL_TNC
+
+#include <linux/interrupt.h>
+
+/* driver_data of the stand-in PCI function the virtual device binds to */
+#define EMGD_VTNC_CHIP			0x7e
+#define EMGD_VTNC_PCI_VENDOR	0x1234
+#define EMGD_VTNC_PCI_DEVICE	0x1111
+
+/* Resources of the virtual 0:2:0 function, as pci_resource_start/len */
+#define EMGD_VTNC_GATT_RESOURCE	2
+#define EMGD_VTNC_GTT_RESOURCE	3
+
+struct pci_dev;
+
+extern int emgd_vtnc;
+#define EMGD_VTNC_ACTIVE	(emgd_vtnc)
+
+extern int emgd_vtnc_init(struct pci_dev *pdev);
+extern void emgd_vtnc_cleanup(void);
+
+/* PCI configuration space of the virtual bridge, 0:2:0, 0:3:0 and LPC */
+extern int emgd_vtnc_pci_find(unsigned short vendor_id,
+	unsigned short device_id);
+extern int emgd_vtnc_pci_read(unsigned int slot, unsigned long offset,
+	void *val, unsigned int size);
+extern int emgd_vtnc_pci_write(unsigned int slot, unsigned long offset,
+	unsigned long val, unsigned int size);
+extern void emgd_vtnc_resource(int bar, unsigned long *start,
+	unsigned long *len);
+
+/* BAR mapping: returns the register file backing a virtual BAR, or NULL */
+extern void *emgd_vtnc_map(unsigned long base, unsigned long size);
+extern int emgd_vtnc_unmap(void *virt);
+
+/* GPIO_BAR of the LPC function, normally reached through port I/O */
+extern unsigned long emgd_vtnc_lpc_read(unsigned long reg);
+extern void emgd_vtnc_lpc_write(unsigned long reg, unsigned long value);
+
+/* DDC: returns 0 and the EDID bytes, or 1 if nothing answers */
+extern int emgd_vtnc_i2c_read(unsigned long dab, unsigned char reg,
+	unsigned char *buffer, unsigned long num_bytes);
+
+/* The vblank timer calls handler(0, arg) in place of the device interrupt */
+extern int emgd_vtnc_request_irq(irq_handler_t handler, void *arg);
+extern void emgd_vtnc_free_irq(void *arg);
+
+#else
+
+#define EMGD_VTNC_ACTIVE	0
+
+#endif
+
+#endif
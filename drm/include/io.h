@@ -34,6 +34,7 @@
 #include <asm/io.h>
 #include <config.h>
 #include <igd_debug.h>
+#include <emgd_trace.h>
 
 
 #ifndef _OAL_LINUX_KERNEL_IO_H
@@ -222,12 +223,19 @@ static __inline const char *os_get_funcname( const char *name )
  * All OAL implementations should result in EMGD_TRACE_ENTER messsages in the
  * following format:
  * <OPTIONAL OS PREFIX> function_name ENTER
+ *
+ * In all drivers EMGD_TRACE_ENTER also fires the emgd_func_enter
+ * tracepoint, which is a patched-out branch unless enabled at runtime.
  */
 #ifndef EMGD_TRACE_ENTER
 #ifdef DEBUG_BUILD_TYPE
-#define EMGD_TRACE_ENTER if(emgd_debug && emgd_debug->hal.trace) EMGD_DEBUG("ENTER")
+#define EMGD_TRACE_ENTER												\
+	do {																\
+		trace_emgd_func_enter(__FUNCTION__);							\
+		if(emgd_debug && emgd_debug->hal.trace) EMGD_DEBUG("ENTER")	\
+	} while(0)
 #else
-#define EMGD_TRACE_ENTER
+#define EMGD_TRACE_ENTER trace_emgd_func_enter(__FUNCTION__)
 #endif
 #endif
 
@@ -249,12 +257,18 @@ static __inline const char *os_get_funcname( const char *name )
  * All OAL implementations should result in EMGD_TRACE_EXIT messsages in the
  * following format:
  * <OPTIONAL OS PREFIX> function_name EXIT
+ *
+ * In all drivers EMGD_TRACE_EXIT also fires the emgd_func_exit tracepoint.
  */
 #ifndef EMGD_TRACE_EXIT
 #ifdef DEBUG_BUILD_TYPE
-#define EMGD_TRACE_EXIT if(emgd_debug && emgd_debug->hal.trace) EMGD_DEBUG("EXIT")
+#define EMGD_TRACE_EXIT													\
+	do {																\
+		trace_emgd_func_exit(__FUNCTION__);								\
+		if(emgd_debug && emgd_debug->hal.trace) EMGD_DEBUG("EXIT")	\
+	} while(0)
 #else
-#define EMGD_TRACE_EXIT
+#define EMGD_TRACE_EXIT trace_emgd_func_exit(__FUNCTION__)
 #endif
 #endif
 
@@ -283,10 +297,11 @@ static __inline const char *os_get_funcname( const char *name )
 #ifndef EMGD_ERROR_EXIT
 #ifdef DEBUG_BUILD_TYPE
 #define EMGD_ERROR_EXIT													\
+	trace_emgd_func_exit(__FUNCTION__);									\
 	if(emgd_debug && emgd_debug->hal.trace) EMGD_DEBUG("EXIT With Error..."); \
 	EMGD_ERROR
 #else
-#define EMGD_ERROR_EXIT(...)   do {} while(0)
+#define EMGD_ERROR_EXIT(...)   trace_emgd_func_exit(__FUNCTION__)
 #endif
 #endif
 
@@ -339,10 +354,50 @@ static __inline const char *os_get_funcname( const char *name )
 
 
 
+/*
+ * MMIO recording
+ * Building with MMIO_RECORD=1 routes EMGD_READ32/EMGD_WRITE32 through
+ * emgd_mmio.c, which logs every access (and EMGD_MMIO_MARK events placed
+ * at mode sets, flips and pans) into a ring buffer exported through debugfs.
+ * A backend may be installed to redirect the accesses to a simulated
+ * register file instead of the hardware.
+ */
+#define EMGD_MMIO_MARK_MODE_SET	1
+#define EMGD_MMIO_MARK_FLIP		2
+#define EMGD_MMIO_MARK_PAN		3
+
+#define EMGD_MMIO_REGION_D2		0
+#define EMGD_MMIO_REGION_D3		1
+
+#ifdef EMGD_MMIO_RECORD
+typedef struct _emgd_mmio_backend {
+	unsigned int (*read32)(volatile void *addr);
+	void (*write32)(unsigned long value, volatile void *addr);
+} emgd_mmio_backend_t;
+
+extern unsigned int emgd_mmio_read32(volatile void *addr);
+extern void emgd_mmio_write32(unsigned long value, volatile void *addr);
+extern void emgd_mmio_mark(unsigned int what);
+extern void emgd_mmio_add_region(unsigned int id, void *base,
+	unsigned long size);
+extern void emgd_mmio_set_backend(emgd_mmio_backend_t *backend);
+extern int emgd_mmio_init(void);
+extern void emgd_mmio_cleanup(void);
+
+#define EMGD_READ32(addr) emgd_mmio_read32((volatile void *)(addr))
+#define EMGD_WRITE32(value, addr) \
+		emgd_mmio_write32((unsigned long)(value), (volatile void *)(addr))
+#define EMGD_MMIO_MARK(what) emgd_mmio_mark(what)
+#define EMGD_MMIO_REGION(id, base, size) \
+		emgd_mmio_add_region(id, (void *)(base), size)
+#else
 #define EMGD_READ32(addr) *(volatile unsigned int *)(addr)
 #define EMGD_WRITE32(value, addr) \
-		(*(volatile unsigned long *)(addr) = (value))
+		(*(volatile unsigned int *)(addr) = (value))
 /*	EMGD_DEBUG ("EMGD_WRITE32: 0x%p=0x%lx\n", (addr), (value)); \*/
+#define EMGD_MMIO_MARK(what) do {} while(0)
+#define EMGD_MMIO_REGION(id, base, size) do {} while(0)
+#endif
 
 #define EMGD_READ8(addr) *(volatile unsigned char *)(addr)
 #define EMGD_WRITE8(value, addr) \
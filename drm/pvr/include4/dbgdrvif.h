@@ -59,6 +59,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define DEBUG_FLAGS_USE_NONPAGED_MEM	0x00000001UL
 #define DEBUG_FLAGS_NO_BUF_EXPANDSION	0x00000002UL
 #define DEBUG_FLAGS_ENABLESAMPLE		0x00000004UL
+#define DEBUG_FLAGS_OVERFLOW_DROP_OLDEST	0x00000008UL
 
 #define DEBUG_FLAGS_TEXTSTREAM			0x80000000UL
 
@@ -120,11 +121,15 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define DEBUG_SERVICE_WRITELF			CTL_CODE(FILE_DEVICE_UNKNOWN, DEBUG_SERVICE_IOCTL_BASE + 0x16, METHOD_BUFFERED, FILE_ANY_ACCESS)
 #define DEBUG_SERVICE_READLF			CTL_CODE(FILE_DEVICE_UNKNOWN, DEBUG_SERVICE_IOCTL_BASE + 0x17, METHOD_BUFFERED, FILE_ANY_ACCESS)
 #define DEBUG_SERVICE_WAITFOREVENT		CTL_CODE(FILE_DEVICE_UNKNOWN, DEBUG_SERVICE_IOCTL_BASE + 0x18, METHOD_BUFFERED, FILE_ANY_ACCESS)
+#define DEBUG_SERVICE_ACQUIREREAD		CTL_CODE(FILE_DEVICE_UNKNOWN, DEBUG_SERVICE_IOCTL_BASE + 0x19, METHOD_BUFFERED, FILE_ANY_ACCESS)
+#define DEBUG_SERVICE_RELEASEREAD		CTL_CODE(FILE_DEVICE_UNKNOWN, DEBUG_SERVICE_IOCTL_BASE + 0x1A, METHOD_BUFFERED, FILE_ANY_ACCESS)
+#define DEBUG_SERVICE_MAPSTREAM			CTL_CODE(FILE_DEVICE_UNKNOWN, DEBUG_SERVICE_IOCTL_BASE + 0x1B, METHOD_BUFFERED, FILE_ANY_ACCESS)
 
 
 typedef enum _DBG_EVENT_
 {
-	DBG_EVENT_STREAM_DATA = 1
+	DBG_EVENT_STREAM_DATA = 1,
+	DBG_EVENT_STREAM_SPACE = 2
 } DBG_EVENT;
 
 
@@ -234,6 +239,47 @@ typedef struct _DBG_IN_WRITE_LF_
 */
 #define WRITELF_FLAGS_RESETBUF		0x00000001UL
 
+/*
+	Zero-copy reads. MAPSTREAM returns a file descriptor whose mmap gives
+	read-only access to the stream buffer; ACQUIREREAD then returns where
+	the unread data starts in that buffer and how much there is, wrapping
+	at ui32Size. RELEASEREAD hands the same span back once it has been
+	consumed and returns IMG_FALSE if a drop oldest writer discarded it
+	in the meantime, in which case what was read must be thrown away.
+*/
+typedef struct _DBG_IN_MAPSTREAM_
+{
+	IMG_VOID *pvStream;
+	IMG_BOOL bReadInitBuffer;
+} DBG_IN_MAPSTREAM, *PDBG_IN_MAPSTREAM;
+
+typedef struct _DBG_OUT_MAPSTREAM_
+{
+	IMG_INT32 i32Fd;
+	IMG_UINT32 ui32Size;
+} DBG_OUT_MAPSTREAM, *PDBG_OUT_MAPSTREAM;
+
+typedef struct _DBG_IN_ACQUIREREAD_
+{
+	IMG_VOID *pvStream;
+	IMG_BOOL bReadInitBuffer;
+	IMG_UINT32 ui32Limit;
+} DBG_IN_ACQUIREREAD, *PDBG_IN_ACQUIREREAD;
+
+typedef struct _DBG_OUT_ACQUIREREAD_
+{
+	IMG_UINT32 ui32Offset;
+	IMG_UINT32 ui32Bytes;
+} DBG_OUT_ACQUIREREAD, *PDBG_OUT_ACQUIREREAD;
+
+typedef struct _DBG_IN_RELEASEREAD_
+{
+	IMG_VOID *pvStream;
+	IMG_BOOL bReadInitBuffer;
+	IMG_UINT32 ui32Offset;
+	IMG_UINT32 ui32Bytes;
+} DBG_IN_RELEASEREAD, *PDBG_IN_RELEASEREAD;
+
 typedef struct _DBG_STREAM_
 {
 	struct _DBG_STREAM_ *psNext;
@@ -257,6 +303,9 @@ typedef struct _DBG_STREAM_
 	IMG_UINT32 ui32Reserved;
 	IMG_UINT32 ui32Timeout;
 	IMG_UINT32 ui32Marker;
+	IMG_UINT32 ui32Reserve;
+	IMG_UINT32 ui32DataDropped;
+	IMG_BOOL   bReaderAttached;
 	IMG_CHAR szName[30];
 } DBG_STREAM,*PDBG_STREAM;
 
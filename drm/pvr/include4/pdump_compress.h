@@ -0,0 +1,104 @@
+/*************************************************************************/ /*!
+@Title          PDump compressed stream format
+@Copyright      Copyright (c) Imagination Technologies Ltd. All Rights Reserved
+@Description    Block and op encoding used by PDUMP_COMPRESS captures. Shared
+                by the kernel encoder and the userspace decoder.
+@License        Dual MIT/GPLv2
+
+The contents of this file are subject to the MIT license as set out below.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+Alternatively, the contents of this file may be used under the terms of
+the GNU General Public License Version 2 ("GPL") in which case the provisions
+of GPL are applicable instead of those above.
+
+If you wish to allow use of your version of this file only under the terms of
+GPL, and not to allow others to use your version of this file under the terms
+of the MIT license, indicate your decision by deleting the provisions above
+and replace them with the notice and other provisions required by GPL as set
+out in the file called "GPL-COPYING" included in this distribution. If you do
+not delete the provisions above, a recipient may use your version of this file
+under the terms of either the MIT license or GPL.
+
+This License is also included in this distribution in the file called
+"MIT-COPYING".
+
+EXCEPT AS OTHERWISE STATED IN A NEGOTIATED AGREEMENT: (A) THE SOFTWARE IS
+PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT; AND (B) IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/ /**************************************************************************/
+
+#ifndef _PDUMP_COMPRESS_H_
+#define _PDUMP_COMPRESS_H_
+
+/*
+	A compressed PDump stream is a sequence of self-contained blocks:
+
+		IMG_UINT8	block type
+		varint		decoded size in bytes
+		varint		payload size in bytes
+		payload
+
+	Varints are unsigned LEB128. The payload of an OPS block is an op
+	stream; the payload of an LZ_OPS block is an op stream compressed with
+	the LZ encoding below.
+
+	Ops:
+
+	DATA		varint n, n bytes			literal output
+	REGW		varint zz(reg delta), varint value
+											"WRW :SGXREG:0x%08X 0x%08X\r\n",
+											reg relative to the previous REGW
+											in the block (0 at block start)
+	REGW_REPEAT								the previous REGW line again
+	COPY		varint offset, varint n		n bytes of earlier output of this
+											stream, starting at offset
+
+	COPY offsets are stream offsets as seen by the script, i.e. offsets
+	into the decoded parameter file, so the decoder must be given the
+	stream from its start (init phase data followed by the main data).
+
+	LZ sequences:
+
+		token		literal count in the high nibble, match length - 4
+					in the low nibble; a nibble of 15 is followed by bytes
+					of 255 and a final byte < 255 that are added to it
+		literals
+		IMG_UINT16	match distance, little endian (absent after the
+					last literals of the payload)
+*/
+#define PDUMP_COMP_BLOCK_OPS			0xD1
+#define PDUMP_COMP_BLOCK_LZ_OPS			0xD2
+
+#define PDUMP_COMP_OP_DATA				0x01
+#define PDUMP_COMP_OP_REGW				0x02
+#define PDUMP_COMP_OP_REGW_REPEAT		0x03
+#define PDUMP_COMP_OP_COPY				0x04
+
+#define PDUMP_COMP_REGW_FORMAT			"WRW :SGXREG:0x%08X 0x%08X\r\n"
+#define PDUMP_COMP_REGW_PREFIX			"WRW :SGXREG:0x"
+#define PDUMP_COMP_REGW_LEN				35
+
+#define PDUMP_COMP_LZ_MIN_MATCH			4
+
+/* Largest decoded size of a block */
+#define PDUMP_COMP_BLOCK_SIZE			16384
+
+#endif /* _PDUMP_COMPRESS_H_ */
+
+/*****************************************************************************
+ End of file (PDUMP_COMPRESS.H)
+*****************************************************************************/
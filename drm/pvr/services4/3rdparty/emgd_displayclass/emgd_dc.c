@@ -678,6 +678,8 @@ static void free_swap_chain(emgddc_swapchain_t *swap_chain,
 	emgddc_buffer_t *buffers;
 	int i=0;
 
+	emgddc_telemetry_unregister(swap_chain);
+
 	/*
 	 * Free and unmap the buffers.  Must ensure that the HAL is running before
 	 * calling it, and ensure that we don't free/unmap the first buffer if is
@@ -1092,6 +1094,9 @@ static PVRSRV_ERROR CreateDCSwapChain(IMG_HANDLE device_h,
 
 	*swap_chain_id = ++devinfo->swap_chain_id_counter;
 	*swap_chain_h = (IMG_HANDLE) swap_chain;
+	if (flipable) {
+		emgddc_telemetry_register(swap_chain, *swap_chain_id);
+	}
 	EMGD_DEBUG("swap_chain_h = 0x%p, *swap_chain_id = %lu",
 		swap_chain_h, *swap_chain_id);
 
@@ -1485,6 +1490,7 @@ static void flush_flip_queue(emgddc_swapchain_t *swap_chain)
 			EMGD_DEBUG("Flipping to buffer offset=0x%lx",
 				flip_item->buffer->offset);
 			emgddc_flip(swap_chain, flip_item->buffer);
+			emgddc_telemetry_flipped(&flip_item->stamp);
 		}
 
 		if (flip_item->cmd_completed == EMGD_FALSE) {
@@ -1493,6 +1499,8 @@ static void flush_flip_queue(emgddc_swapchain_t *swap_chain)
 			EMGD_DEBUG("Calling pfnPVRSRVCmdComplete() for buffer offset=0x%lx",
 				flip_item->buffer->offset);
 			pvr_jtable->pfnPVRSRVCmdComplete(flip_item->cmd_complete, IMG_TRUE);
+			emgddc_telemetry_landed(swap_chain, &flip_item->stamp,
+				EMGD_FLIP_LOG_FLUSHED);
 		}
 
 		/* We're done with this item in the queue.  Prepare for processing the
@@ -1786,6 +1794,7 @@ emgd_bool emgddc_process_flip_queue_for_vblank(emgddc_swapchain_t *swap_chain)
 				pvr_jtable->pfnPVRSRVCmdComplete(flip_item->cmd_complete,
 					IMG_TRUE);
 				flip_item->cmd_completed = EMGD_TRUE;
+				emgddc_telemetry_landed(swap_chain, &flip_item->stamp, 0);
 			}
 
 			flip_item->swap_interval--;
@@ -1813,6 +1822,7 @@ emgd_bool emgddc_process_flip_queue_for_vblank(emgddc_swapchain_t *swap_chain)
 			EMGD_DEBUG("Flipping to buffer offset=0x%lx",
 				flip_item->buffer->offset);
 			emgddc_flip(swap_chain, flip_item->buffer);
+			emgddc_telemetry_flipped(&flip_item->stamp);
 			flip_item->flipped = EMGD_TRUE;
 			/* Wait for more vblanks before doing more queue processing: */
 			break;
@@ -1854,6 +1864,8 @@ static int emgddc_process_vblank(void* pdevinfo)
 
 	spin_lock_irqsave(&devinfo->swap_chain_lock, lock_flags);
 
+	devinfo->vblank_count++;
+
 	swap_chain = devinfo->flipable_swapchains;
 	while (swap_chain != NULL) {
 		(void) emgddc_process_flip_queue_for_vblank(swap_chain);
@@ -1893,6 +1905,7 @@ static IMG_BOOL emgddc_process_flip(IMG_HANDLE cmd_cookie_h,
 	int must_flip = 0;
 	int must_complete = 0;
 	igd_context_t *context;
+	emgddc_flip_stamp_t stamp;
 
 	EMGD_TRACE_ENTER;
 
@@ -2003,16 +2016,19 @@ static IMG_BOOL emgddc_process_flip(IMG_HANDLE cmd_cookie_h,
 	/*
 	 * Do what needs to be done:
 	 */
+	emgddc_telemetry_submit(swap_chain, &stamp, flip_cmd->ui32SwapInterval);
 	if (must_flip) {
 		/* Perform the flip now: */
 		EMGD_DEBUG("Flipping to buffer offset=0x%lx", buffers->offset);
 		emgddc_flip(swap_chain, buffers);
+		emgddc_telemetry_flipped(&stamp);
 	}
 	if (must_complete) {
 		/* Tell the PVR services that the flip occured: */
 		EMGD_DEBUG("Calling pfnPVRSRVCmdComplete() for buffer offset=0x%lx",
 			buffers->offset);
 		swap_chain->pvr_jtable->pfnPVRSRVCmdComplete(cmd_cookie_h,IMG_TRUE);
+		emgddc_telemetry_landed(swap_chain, &stamp, EMGD_FLIP_LOG_IMMEDIATE);
 	} else {
 		/* Queue the flip for later completion: */
 		EMGD_DEBUG("Queueing buffer offset=0x%lx", buffers->offset);
@@ -2023,6 +2039,7 @@ static IMG_BOOL emgddc_process_flip(IMG_HANDLE cmd_cookie_h,
 		flip_item->swap_interval = (unsigned long) flip_cmd->ui32SwapInterval;
 		flip_item->valid = EMGD_TRUE;
 		flip_item->buffer = buffers;
+		flip_item->stamp = stamp;
 
 		swap_chain->insert_index++;
 		if (swap_chain->insert_index > max_index) {
@@ -2632,6 +2649,7 @@ emgd_error_t emgddc_init(struct drm_device *dev)
 	/* Remember the devinfo, for other functions that aren't passed it: */
 	global_devinfo[0] = devinfo;
 
+	emgddc_telemetry_init();
 
 	EMGD_TRACE_EXIT;
 	return EMGD_OK;
@@ -2655,6 +2673,8 @@ emgd_error_t emgddc_deinit(void)
 	EMGD_TRACE_ENTER;
 
 
+	emgddc_telemetry_deinit();
+
 	for (i = 0 ; i < 2 ; i++) {
 		devinfo = global_devinfo[i];
 		if (devinfo == NULL) {
@@ -28,6 +28,7 @@
 #include "io.h"
 #include "emgd_shared.h"
 #include "kerneldisplay.h"
+#include "emgd_flip_log.h"
 
 
 #define EMGDDC_MAXFORMATS 20
@@ -117,6 +118,49 @@ typedef struct _emgddc_buffer
 } emgddc_buffer_t;
 
 
+/** Timing of one flip, from submission until it lands on the screen. */
+typedef struct _emgddc_flip_stamp
+{
+	unsigned long long submit_ns;
+	unsigned long long flip_ns;
+	unsigned long submit_vblank;
+	unsigned short queue_depth;
+	unsigned short swap_interval;
+} emgddc_flip_stamp_t;
+
+
+/** Number of recent flips each swap chain keeps for emgd_flip/stats. */
+#define EMGDDC_FLIP_WINDOW 64
+
+/**
+ * Flip telemetry for a swap chain, see emgd_dc_telemetry.c.  Updated with
+ * the telemetry lock held, so it can be read while the swap chain list is
+ * changing.
+ */
+typedef struct _emgddc_flip_telemetry
+{
+	/** Entry on the telemetry list; next is NULL until registered. */
+	struct list_head link;
+
+	unsigned long id;
+	int display;
+
+	unsigned long long flips;
+	unsigned long long immediate;
+	unsigned long long missed;
+	unsigned long long flushed;
+
+	/** Vblank and swap interval of the last flip that landed. */
+	emgd_bool have_last;
+	unsigned long last_vblank;
+	unsigned long last_interval;
+
+	/** The last EMGDDC_FLIP_WINDOW flips; window_count counts them all. */
+	emgd_flip_log_entry_t window[EMGDDC_FLIP_WINDOW];
+	unsigned long window_count;
+} emgddc_flip_telemetry_t;
+
+
 /** Information for queueing a flip for a given swap chain buffer. */
 typedef struct _emgddc_flip_queue_item
 {
@@ -154,6 +198,9 @@ typedef struct _emgddc_flip_queue_item
 	/** Which buffer is associated with this flip_item. */
 	emgddc_buffer_t *buffer;
 
+	/** When this flip was submitted and programmed. */
+	emgddc_flip_stamp_t stamp;
+
 } emgddc_flip_queue_item_t;
 
 
@@ -204,6 +251,9 @@ typedef struct _emgddc_swapchain
 
 	/** Next swap chain in the list */
 	struct _emgddc_swapchain *next;
+
+	/** Flip timing and missed deadline counts (flip-able chains only). */
+	emgddc_flip_telemetry_t telemetry;
 } emgddc_swapchain_t;
 
 
@@ -313,6 +363,9 @@ struct _emgddc_devinfo
 	/** This device's numeric ID, obtained when registering with PVR services */
 	unsigned long device_id;
 
+	/** Vblanks seen while a flip-able swap chain existed (for telemetry). */
+	unsigned long vblank_count;
+
 };
 
 
@@ -340,4 +393,15 @@ emgd_error_t emgddc_deinit(void);
 
 void emgddc_flip(emgddc_swapchain_t *swap_chain, emgddc_buffer_t *buffer);
 
+void emgddc_telemetry_init(void);
+void emgddc_telemetry_deinit(void);
+void emgddc_telemetry_register(emgddc_swapchain_t *swap_chain,
+	unsigned long id);
+void emgddc_telemetry_unregister(emgddc_swapchain_t *swap_chain);
+void emgddc_telemetry_submit(emgddc_swapchain_t *swap_chain,
+	emgddc_flip_stamp_t *stamp, unsigned long swap_interval);
+void emgddc_telemetry_flipped(emgddc_flip_stamp_t *stamp);
+void emgddc_telemetry_landed(emgddc_swapchain_t *swap_chain,
+	emgddc_flip_stamp_t *stamp, unsigned int flags);
+
 #endif
@@ -0,0 +1,434 @@
+/**********************************************************************
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*
+ * Flip telemetry for the display class driver.  Each flip-able swap chain
+ * records, for every flip, when it was submitted, when the surface was
+ * programmed, and the vblank at which PVR services was told it completed.
+ * A flip misses its deadline when the frame before it stayed on screen for
+ * more vblanks than its swap interval asked for; a pause in rendering
+ * therefore counts as one miss.
+ *
+ * Exported through debugfs:
+ *
+ *  emgd_flip/stats   - per swap chain counters and a summary of the last
+ *                      EMGDDC_FLIP_WINDOW flips
+ *  emgd_flip/events  - a stream of emgd_flip_log_entry_t, one per flip.
+ *                      Records are only kept while the file is open; if
+ *                      the reader falls behind, the oldest are dropped.
+ */
+#define MODULE_NAME hal.pvr3dd
+
+#include <linux/spinlock.h>
+#include <linux/list.h>
+#include <linux/ktime.h>
+#include <linux/wait.h>
+#include <linux/poll.h>
+#include <linux/sched.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/uaccess.h>
+#include <linux/err.h>
+
+#include "drm_emgd_private.h"
+
+#include "img_defs.h"
+#include "servicesext.h"
+#include "kerneldisplay.h"
+#include "emgd_dc.h"
+
+
+#define EMGDDC_FLIP_EVENTS 256
+
+static DEFINE_SPINLOCK(telemetry_lock);
+static LIST_HEAD(telemetry_list);
+
+static emgd_flip_log_entry_t flip_events[EMGDDC_FLIP_EVENTS];
+static unsigned long flip_events_head;		/* Total records ever added */
+static unsigned long flip_events_tail;		/* Next record to read */
+static unsigned long flip_events_dropped;
+static int flip_events_readers;
+static DECLARE_WAIT_QUEUE_HEAD(flip_events_wait);
+
+static struct dentry *telemetry_debugfs_dir;
+
+
+/**
+ * Starts collecting telemetry for a flip-able swap chain.
+ *
+ * @param swap_chain (IN) The new swap chain.
+ * @param id (IN) The ID reported to PVR services.
+ */
+void emgddc_telemetry_register(emgddc_swapchain_t *swap_chain,
+	unsigned long id)
+{
+	emgddc_flip_telemetry_t *telemetry = &swap_chain->telemetry;
+	unsigned long flags;
+
+	telemetry->id = id;
+	telemetry->display = swap_chain->devinfo->which_devinfo;
+
+	spin_lock_irqsave(&telemetry_lock, flags);
+	list_add_tail(&telemetry->link, &telemetry_list);
+	spin_unlock_irqrestore(&telemetry_lock, flags);
+}
+
+
+/**
+ * Stops collecting telemetry for a swap chain that is about to be freed.
+ * Safe to call for swap chains that were never registered.
+ *
+ * @param swap_chain (IN) The swap chain.
+ */
+void emgddc_telemetry_unregister(emgddc_swapchain_t *swap_chain)
+{
+	emgddc_flip_telemetry_t *telemetry = &swap_chain->telemetry;
+	unsigned long flags;
+
+	if (telemetry->link.next == NULL) {
+		return;
+	}
+
+	spin_lock_irqsave(&telemetry_lock, flags);
+	list_del(&telemetry->link);
+	spin_unlock_irqrestore(&telemetry_lock, flags);
+
+	telemetry->link.next = NULL;
+}
+
+
+/**
+ * Stamps a flip as it is received from PVR services.  Called with the swap
+ * chain lock held, before the flip is added to the queue.
+ *
+ * @param swap_chain (IN) The swap chain being flipped.
+ * @param stamp (OUT) The flip's stamp.
+ * @param swap_interval (IN) The swap interval requested for the flip.
+ */
+void emgddc_telemetry_submit(emgddc_swapchain_t *swap_chain,
+	emgddc_flip_stamp_t *stamp, unsigned long swap_interval)
+{
+	unsigned long i;
+	unsigned short depth = 0;
+
+	for (i = 0 ; i < swap_chain->buffer_count ; i++) {
+		if (swap_chain->flip_queue[i].valid) {
+			depth++;
+		}
+	}
+
+	stamp->submit_ns = ktime_to_ns(ktime_get());
+	stamp->flip_ns = 0;
+	stamp->submit_vblank = swap_chain->devinfo->vblank_count;
+	stamp->queue_depth = depth;
+	stamp->swap_interval = (unsigned short) swap_interval;
+}
+
+
+/**
+ * Stamps a flip as its surface is programmed.
+ *
+ * @param stamp (IN/OUT) The flip's stamp.
+ */
+void emgddc_telemetry_flipped(emgddc_flip_stamp_t *stamp)
+{
+	stamp->flip_ns = ktime_to_ns(ktime_get());
+}
+
+
+/**
+ * Records a flip once PVR services has been told it completed.  Called with
+ * the swap chain lock held.
+ *
+ * @param swap_chain (IN) The swap chain the flip belongs to.
+ * @param stamp (IN) The flip's stamp.
+ * @param flags (IN) EMGD_FLIP_LOG_IMMEDIATE or EMGD_FLIP_LOG_FLUSHED, if
+ *   the flip did not wait for a vblank.
+ */
+void emgddc_telemetry_landed(emgddc_swapchain_t *swap_chain,
+	emgddc_flip_stamp_t *stamp, unsigned int flags)
+{
+	emgddc_flip_telemetry_t *telemetry = &swap_chain->telemetry;
+	emgd_flip_log_entry_t entry;
+	unsigned long vblank = swap_chain->devinfo->vblank_count;
+	unsigned long lock_flags;
+	unsigned long shown = 0;
+	unsigned long deadline;
+
+	entry.submit_ns = stamp->submit_ns;
+	entry.flip_ns = stamp->flip_ns;
+	entry.landed_ns = ktime_to_ns(ktime_get());
+	entry.swap_chain = (unsigned int) telemetry->id;
+	entry.submit_vblank = (unsigned int) stamp->submit_vblank;
+	entry.landed_vblank = (unsigned int) vblank;
+	entry.queue_depth = stamp->queue_depth;
+	entry.swap_interval = stamp->swap_interval;
+	entry.display = (unsigned char) telemetry->display;
+	entry.reserved = 0;
+
+	spin_lock_irqsave(&telemetry_lock, lock_flags);
+
+	/*
+	 * Only vblank-paced flips have a deadline: both this one and the one
+	 * before it must have waited for vblanks.  The deadline is the later
+	 * of the end of the previous flip's swap interval and the first vblank
+	 * after this flip was submitted, so a client that submits late or sits
+	 * idle is not counted as missing.
+	 */
+	if (telemetry->have_last) {
+		shown = vblank - telemetry->last_vblank;
+		if (!flags && telemetry->last_interval) {
+			deadline = telemetry->last_vblank + telemetry->last_interval;
+			if ((long)(stamp->submit_vblank + 1 - deadline) > 0) {
+				deadline = stamp->submit_vblank + 1;
+			}
+			if ((long)(vblank - deadline) > 0) {
+				flags |= EMGD_FLIP_LOG_MISSED;
+				telemetry->missed++;
+			}
+		}
+	}
+	entry.prev_shown = (unsigned short) shown;
+	entry.flags = (unsigned char) flags;
+
+	telemetry->flips++;
+	if (flags & EMGD_FLIP_LOG_IMMEDIATE) {
+		telemetry->immediate++;
+	}
+	if (flags & EMGD_FLIP_LOG_FLUSHED) {
+		telemetry->flushed++;
+	}
+	telemetry->have_last = EMGD_TRUE;
+	telemetry->last_vblank = vblank;
+	telemetry->last_interval = (flags & (EMGD_FLIP_LOG_IMMEDIATE |
+		EMGD_FLIP_LOG_FLUSHED)) ? 0 : stamp->swap_interval;
+
+	telemetry->window[telemetry->window_count % EMGDDC_FLIP_WINDOW] = entry;
+	telemetry->window_count++;
+
+	if (flip_events_readers) {
+		if (flip_events_head - flip_events_tail == EMGDDC_FLIP_EVENTS) {
+			flip_events_tail++;
+			flip_events_dropped++;
+		}
+		flip_events[flip_events_head % EMGDDC_FLIP_EVENTS] = entry;
+		flip_events_head++;
+	}
+
+	spin_unlock_irqrestore(&telemetry_lock, lock_flags);
+
+	if (flip_events_readers) {
+		wake_up_interruptible(&flip_events_wait);
+	}
+}
+
+
+static int stats_show(struct seq_file *m, void *v)
+{
+	emgddc_flip_telemetry_t *telemetry;
+	emgd_flip_log_entry_t *entry;
+	unsigned long long latency, max_latency, depth, span;
+	unsigned long flags;
+	unsigned long count, missed, i;
+
+	spin_lock_irqsave(&telemetry_lock, flags);
+
+	list_for_each_entry(telemetry, &telemetry_list, link) {
+		seq_printf(m, "swap chain %lu (display %d): flips %llu immediate %llu "
+			"flushed %llu missed %llu\n", telemetry->id, telemetry->display,
+			telemetry->flips, telemetry->immediate, telemetry->flushed,
+			telemetry->missed);
+
+		count = telemetry->window_count < EMGDDC_FLIP_WINDOW ?
+			telemetry->window_count : EMGDDC_FLIP_WINDOW;
+		if (!count) {
+			continue;
+		}
+
+		latency = max_latency = depth = 0;
+		missed = 0;
+		for (i = telemetry->window_count - count ;
+			i < telemetry->window_count ; i++) {
+			entry = &telemetry->window[i % EMGDDC_FLIP_WINDOW];
+			latency += entry->landed_ns - entry->submit_ns;
+			if (entry->landed_ns - entry->submit_ns > max_latency) {
+				max_latency = entry->landed_ns - entry->submit_ns;
+			}
+			depth += entry->queue_depth;
+			if (entry->flags & EMGD_FLIP_LOG_MISSED) {
+				missed++;
+			}
+		}
+
+		/* Frames per second over the window, in hundredths */
+		span = telemetry->window[(telemetry->window_count - 1) %
+			EMGDDC_FLIP_WINDOW].landed_ns -
+			telemetry->window[(telemetry->window_count - count) %
+			EMGDDC_FLIP_WINDOW].landed_ns;
+
+		seq_printf(m, "  last %lu: latency avg %lluus max %lluus, "
+			"queue depth avg %llu.%02llu, missed %lu",
+			count, div_u64(latency, count * 1000), div_u64(max_latency, 1000),
+			div_u64(depth, count), div_u64(depth * 100, count) % 100, missed);
+		if (count > 1 && span) {
+			unsigned long long fps =
+				div64_u64((unsigned long long)(count - 1) * 100000000000ULL,
+				span);
+			seq_printf(m, ", %llu.%02llu fps", div_u64(fps, 100), fps % 100);
+		}
+		seq_putc(m, '\n');
+	}
+
+	spin_unlock_irqrestore(&telemetry_lock, flags);
+
+	seq_printf(m, "events dropped %lu\n", flip_events_dropped);
+
+	return 0;
+}
+
+static int stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, stats_show, NULL);
+}
+
+
+static int events_open(struct inode *inode, struct file *file)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&telemetry_lock, flags);
+	if (!flip_events_readers++) {
+		flip_events_tail = flip_events_head;
+	}
+	spin_unlock_irqrestore(&telemetry_lock, flags);
+
+	return 0;
+}
+
+static int events_release(struct inode *inode, struct file *file)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&telemetry_lock, flags);
+	flip_events_readers--;
+	spin_unlock_irqrestore(&telemetry_lock, flags);
+
+	return 0;
+}
+
+/*
+ * Readers share one queue: with more than one open, each record goes to
+ * whichever reader takes it first.
+ */
+static ssize_t events_read(struct file *file, char __user *buf,
+	size_t count, loff_t *ppos)
+{
+	emgd_flip_log_entry_t entry;
+	unsigned long flags;
+	size_t done = 0;
+	int ret;
+
+	if (count < sizeof(entry)) {
+		return -EINVAL;
+	}
+
+	for (;;) {
+		while (count - done >= sizeof(entry)) {
+			spin_lock_irqsave(&telemetry_lock, flags);
+			if (flip_events_head == flip_events_tail) {
+				spin_unlock_irqrestore(&telemetry_lock, flags);
+				break;
+			}
+			entry = flip_events[flip_events_tail % EMGDDC_FLIP_EVENTS];
+			flip_events_tail++;
+			spin_unlock_irqrestore(&telemetry_lock, flags);
+
+			if (copy_to_user(buf + done, &entry, sizeof(entry))) {
+				return done ? done : -EFAULT;
+			}
+			done += sizeof(entry);
+		}
+
+		if (done) {
+			return done;
+		}
+		if (file->f_flags & O_NONBLOCK) {
+			return -EAGAIN;
+		}
+
+		ret = wait_event_interruptible(flip_events_wait,
+			flip_events_head != flip_events_tail);
+		if (ret) {
+			return ret;
+		}
+	}
+}
+
+static unsigned int events_poll(struct file *file, poll_table *wait)
+{
+	poll_wait(file, &flip_events_wait, wait);
+
+	return (flip_events_head != flip_events_tail) ? (POLLIN | POLLRDNORM) : 0;
+}
+
+static const struct file_operations stats_fops = {
+	.owner = THIS_MODULE,
+	.open = stats_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static const struct file_operations events_fops = {
+	.owner = THIS_MODULE,
+	.open = events_open,
+	.release = events_release,
+	.read = events_read,
+	.poll = events_poll,
+};
+
+
+void emgddc_telemetry_init(void)
+{
+	if (telemetry_debugfs_dir) {
+		return;
+	}
+
+	telemetry_debugfs_dir = debugfs_create_dir("emgd_flip", NULL);
+	if (!telemetry_debugfs_dir || IS_ERR(telemetry_debugfs_dir)) {
+		/* Flips are still counted; they just cannot be read */
+		telemetry_debugfs_dir = NULL;
+		EMGD_ERROR("Cannot create the emgd_flip debugfs directory");
+		return;
+	}
+
+	debugfs_create_file("stats", S_IRUGO, telemetry_debugfs_dir, NULL,
+		&stats_fops);
+	debugfs_create_file("events", S_IRUSR, telemetry_debugfs_dir, NULL,
+		&events_fops);
+}
+
+void emgddc_telemetry_deinit(void)
+{
+	debugfs_remove_recursive(telemetry_debugfs_dir);
+	telemetry_debugfs_dir = NULL;
+}
@@ -63,6 +63,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define	PVR_DRM_UNPRIV_INIT_SUCCESFUL	0
 #define	PVR_DRM_UNPRIV_BUSID_TYPE	1
 #define	PVR_DRM_UNPRIV_BUSID_FIELD	2
+#define	PVR_DRM_UNPRIV_SYNC_FENCE	3
 
 #define	PVR_DRM_BUS_TYPE_PCI		0
 
@@ -1368,6 +1368,8 @@ typedef struct PVRSRV_BRIDGE_IN_EVENT_OBJECT_WAI_TAG
 {
 	IMG_UINT32 ui32BridgeFlags;
 	IMG_HANDLE	hOSEventKM;
+	/* Optional; wait for the operations pending on this sync object */
+	IMG_HANDLE	hKernelSyncInfo;
 } PVRSRV_BRIDGE_IN_EVENT_OBJECT_WAIT;
 
 typedef struct PVRSRV_BRIDGE_IN_EVENT_OBJECT_OPEN_TAG
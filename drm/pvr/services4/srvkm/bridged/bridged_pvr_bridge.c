@@ -66,6 +66,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "pdump_km.h"
 #include "sysconfig.h"
+#include "metrics.h"
 
 #include "bridged_pvr_bridge.h"
 #if defined(SUPPORT_SGX)
@@ -2288,6 +2289,7 @@ PVRSRVSwapToDCBufferBW(IMG_UINT32 ui32BridgeID,
 {
 	IMG_VOID *pvDispClassInfo;
 	IMG_VOID *pvSwapChainBuf;
+	IMG_UINT64 ui64FlipStart;
 
 	PVRSRV_BRIDGE_ASSERT_CMD(ui32BridgeID, PVRSRV_BRIDGE_SWAP_DISPCLASS_TO_BUFFER);
 
@@ -2312,6 +2314,7 @@ PVRSRVSwapToDCBufferBW(IMG_UINT32 ui32BridgeID,
 		return 0;
 	}
 
+	PVRSRV_TIME_START(ui64FlipStart);
 	psRetOUT->eError =
 		PVRSRVSwapToDCBufferKM(pvDispClassInfo,
 							   pvSwapChainBuf,
@@ -2319,6 +2322,7 @@ PVRSRVSwapToDCBufferBW(IMG_UINT32 ui32BridgeID,
 							   psSwapDispClassBufferIN->hPrivateTag,
 							   psSwapDispClassBufferIN->ui32ClipRectCount,
 							   psSwapDispClassBufferIN->sClipRect);
+	PVRSRV_TIME_STOP(PVRSRV_TIMER_DC_FLIP, ui64FlipStart);
 
 	return 0;
 }
@@ -2962,6 +2966,7 @@ PVRSRVEventObjectWaitBW(IMG_UINT32 ui32BridgeID,
 						  PVRSRV_PER_PROCESS_DATA *psPerProc)
 {
 	IMG_HANDLE hOSEventKM;
+	IMG_HANDLE hKernelSyncInfo;
 
 	PVRSRV_BRIDGE_ASSERT_CMD(ui32BridgeID, PVRSRV_BRIDGE_EVENT_OBJECT_WAIT);
 
@@ -2975,7 +2980,23 @@ PVRSRVEventObjectWaitBW(IMG_UINT32 ui32BridgeID,
 		return 0;
 	}
 
-	psRetOUT->eError = OSEventObjectWait(hOSEventKM);
+	if(psEventObjectWaitIN->hKernelSyncInfo == IMG_NULL)
+	{
+		psRetOUT->eError = OSEventObjectWait(hOSEventKM);
+		return 0;
+	}
+
+	psRetOUT->eError = PVRSRVLookupHandle(psPerProc->psHandleBase,
+						   &hKernelSyncInfo,
+						   psEventObjectWaitIN->hKernelSyncInfo,
+						   PVRSRV_HANDLE_TYPE_SYNC_INFO);
+
+	if(psRetOUT->eError != PVRSRV_OK)
+	{
+		return 0;
+	}
+
+	psRetOUT->eError = OSEventObjectWaitSync(hOSEventKM, hKernelSyncInfo);
 
 	return 0;
 }
@@ -3477,6 +3498,16 @@ IMG_INT BridgedDispatchKM(PVRSRV_PER_PROCESS_DATA * psPerProc,
 		psBridgeIn = ((ENV_DATA *)psSysData->pvEnvSpecificData)->pvBridgeData;
 		psBridgeOut = (IMG_PVOID)((IMG_PBYTE)psBridgeIn + PVRSRV_MAX_BRIDGE_IN_SIZE);
 
+		/*
+		 * EVENT_OBJECT_WAIT has an optional trailing sync object handle
+		 * that callers built against the shorter structure don't pass.
+		 */
+		if(ui32BridgeID == PVRSRV_GET_BRIDGE_ID(PVRSRV_BRIDGE_EVENT_OBJECT_WAIT) &&
+		   psBridgePackageKM->ui32InBufferSize < sizeof(PVRSRV_BRIDGE_IN_EVENT_OBJECT_WAIT))
+		{
+			OSMemSet(psBridgeIn, 0, sizeof(PVRSRV_BRIDGE_IN_EVENT_OBJECT_WAIT));
+		}
+
 		if(psBridgePackageKM->ui32InBufferSize > 0)
 		{
 			if(!OSAccessOK(PVR_VERIFY_READ,
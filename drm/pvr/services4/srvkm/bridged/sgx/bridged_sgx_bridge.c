@@ -66,6 +66,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "bridged_sgx_bridge.h"
 #include "sgxutils.h"
 #include "pdump_km.h"
+#include "metrics.h"
 
 static IMG_INT
 SGXGetClientInfoBW(IMG_UINT32 ui32BridgeID,
@@ -170,6 +171,7 @@ SGXDoKickBW(IMG_UINT32 ui32BridgeID,
 	IMG_INT ret = 0;
 	IMG_UINT32 ui32NumDstSyncs;
 	IMG_HANDLE *phKernelSyncInfoHandles = IMG_NULL;
+	IMG_UINT64 ui64KickStart;
 
 	PVRSRV_BRIDGE_ASSERT_CMD(ui32BridgeID, PVRSRV_BRIDGE_SGX_DOKICK);
 
@@ -435,9 +437,11 @@ SGXDoKickBW(IMG_UINT32 ui32BridgeID,
 		}
 	}
 
+	PVRSRV_TIME_START(ui64KickStart);
 	psRetOUT->eError =
 		SGXDoKickKM(hDevCookieInt,
 					&psDoKickIN->sCCBKick);
+	PVRSRV_TIME_STOP(PVRSRV_TIMER_SGX_KICK, ui64KickStart);
 
 PVRSRV_BRIDGE_SGX_DOKICK_RETURN_RESULT:
 
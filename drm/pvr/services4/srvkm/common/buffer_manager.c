@@ -53,16 +53,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "lists.h"
 
-DECLARE_LIST_ANY_VA(BM_HEAP);
 DECLARE_LIST_ANY_2(BM_HEAP, PVRSRV_ERROR, PVRSRV_OK);
-DECLARE_LIST_ANY_VA_2(BM_HEAP, PVRSRV_ERROR, PVRSRV_OK);
-DECLARE_LIST_FOR_EACH_VA(BM_HEAP);
 DECLARE_LIST_INSERT(BM_HEAP);
 DECLARE_LIST_REMOVE(BM_HEAP);
 
 DECLARE_LIST_FOR_EACH(BM_CONTEXT);
-DECLARE_LIST_ANY_VA(BM_CONTEXT);
-DECLARE_LIST_ANY_VA_2(BM_CONTEXT, IMG_HANDLE, IMG_NULL);
 DECLARE_LIST_INSERT(BM_CONTEXT);
 DECLARE_LIST_REMOVE(BM_CONTEXT);
 
@@ -860,11 +855,9 @@ BM_DestroyContext(IMG_HANDLE	hBMContext,
 }
 
 
-PVRSRV_ERROR BM_DestroyContextCallBack_AnyVaCb(BM_HEAP *psBMHeap, va_list va)
+static INLINE PVRSRV_ERROR BM_DestroyContextHeap(BM_HEAP *psBMHeap,
+												PVRSRV_DEVICE_NODE *psDeviceNode)
 {
-	PVRSRV_DEVICE_NODE *psDeviceNode;
-	psDeviceNode = va_arg(va, PVRSRV_DEVICE_NODE*);
-
 	/* Free up the import arenas */
 	if(psBMHeap->ui32Attribs
 	& 	(PVRSRV_BACKINGSTORE_SYSMEM_NONCONTIG
@@ -897,6 +890,7 @@ static PVRSRV_ERROR BM_DestroyContextCallBack(IMG_PVOID		pvParam,
 {
 	BM_CONTEXT *pBMContext = pvParam;
 	PVRSRV_DEVICE_NODE *psDeviceNode;
+	BM_HEAP *psBMHeap, *psNextBMHeap;
 	PVR_UNREFERENCED_PARAMETER(ui32Param);
 
 	/*
@@ -906,11 +900,12 @@ static PVRSRV_ERROR BM_DestroyContextCallBack(IMG_PVOID		pvParam,
 
 
 
-	if(List_BM_HEAP_PVRSRV_ERROR_Any_va(pBMContext->psBMHeap,
-										BM_DestroyContextCallBack_AnyVaCb,
-										psDeviceNode) != PVRSRV_OK)
+	LIST_FOR_EACH_SAFE(psBMHeap, psNextBMHeap, pBMContext->psBMHeap)
 	{
-		return PVRSRV_ERROR_GENERIC;
+		if (BM_DestroyContextHeap(psBMHeap, psDeviceNode) != PVRSRV_OK)
+		{
+			return PVRSRV_ERROR_GENERIC;
+		}
 	}
 
 
@@ -944,25 +939,10 @@ static PVRSRV_ERROR BM_DestroyContextCallBack(IMG_PVOID		pvParam,
 }
 
 
-IMG_HANDLE BM_CreateContext_IncRefCount_AnyVaCb(BM_CONTEXT *pBMContext, va_list va)
+static INLINE IMG_VOID BM_CreateContext_InsertHeap(BM_HEAP *psBMHeap,
+												   PVRSRV_DEVICE_NODE *psDeviceNode,
+												   BM_CONTEXT *pBMContext)
 {
-	PRESMAN_CONTEXT	hResManContext;
-	hResManContext = va_arg(va, PRESMAN_CONTEXT);
-	if(ResManFindResourceByPtr(hResManContext, pBMContext->hResItem) == PVRSRV_OK)
-	{
-
-		pBMContext->ui32RefCount++;
-		return pBMContext;
-	}
-	return IMG_NULL;
-}
-
-IMG_VOID BM_CreateContext_InsertHeap_ForEachVaCb(BM_HEAP *psBMHeap, va_list va)
-{
-	PVRSRV_DEVICE_NODE *psDeviceNode;
-	BM_CONTEXT *pBMContext;
-	psDeviceNode = va_arg(va, PVRSRV_DEVICE_NODE*);
-	pBMContext = va_arg(va, BM_CONTEXT*);
 	switch(psBMHeap->sDevArena.DevMemHeapType)
 	{
 		case DEVICE_MEMORY_HEAP_SHARED:
@@ -1021,12 +1001,14 @@ BM_CreateContext(PVRSRV_DEVICE_NODE			*psDeviceNode,
 
 	if (bKernelContext == IMG_FALSE)
 	{
-		IMG_HANDLE res = (IMG_HANDLE) List_BM_CONTEXT_Any_va(psDevMemoryInfo->pBMContext,
-															&BM_CreateContext_IncRefCount_AnyVaCb,
-															hResManContext);
-		if (res)
+		/* Reuse the context this process already has, if any */
+		LIST_FOR_EACH(pBMContext, psDevMemoryInfo->pBMContext)
 		{
-			return res;
+			if(ResManFindResourceByPtr(hResManContext, pBMContext->hResItem) == PVRSRV_OK)
+			{
+				pBMContext->ui32RefCount++;
+				return (IMG_HANDLE)pBMContext;
+			}
 		}
 	}
 
@@ -1096,10 +1078,14 @@ BM_CreateContext(PVRSRV_DEVICE_NODE			*psDeviceNode,
 			insert the shared heaps into the MMU page directory/table
 			for the new context
 		*/
-		List_BM_HEAP_ForEach_va(pBMContext->psBMSharedHeap,
-								BM_CreateContext_InsertHeap_ForEachVaCb,
-								psDeviceNode,
-								pBMContext);
+		{
+			BM_HEAP *psBMHeap;
+
+			LIST_FOR_EACH(psBMHeap, pBMContext->psBMSharedHeap)
+			{
+				BM_CreateContext_InsertHeap(psBMHeap, psDeviceNode, pBMContext);
+			}
+		}
 
 		/* Finally, insert the new context into the list of BM contexts	*/
 		List_BM_CONTEXT_Insert(&psDevMemoryInfo->pBMContext, pBMContext);
@@ -1133,21 +1119,6 @@ cleanup:
 }
 
 
-IMG_VOID *BM_CreateHeap_AnyVaCb(BM_HEAP *psBMHeap, va_list va)
-{
-	DEVICE_MEMORY_HEAP_INFO *psDevMemHeapInfo;
-	psDevMemHeapInfo = va_arg(va, DEVICE_MEMORY_HEAP_INFO*);
-	if (psBMHeap->sDevArena.ui32HeapID ==  psDevMemHeapInfo->ui32HeapID)
-	{
-		/* Match - just return already created heap */
-		return psBMHeap;
-	}
-	else
-	{
-		return IMG_NULL;
-	}
-}
-
 /*!
 ******************************************************************************
 
@@ -1187,13 +1158,13 @@ BM_CreateHeap (IMG_HANDLE hBMContext,
 	*/
 	if(pBMContext->ui32RefCount > 0)
 	{
-		psBMHeap = (BM_HEAP*)List_BM_HEAP_Any_va(pBMContext->psBMHeap,
-												 BM_CreateHeap_AnyVaCb,
-												 psDevMemHeapInfo);
-
-		if (psBMHeap)
+		LIST_FOR_EACH(psBMHeap, pBMContext->psBMHeap)
 		{
-			return psBMHeap;
+			if (psBMHeap->sDevArena.ui32HeapID == psDevMemHeapInfo->ui32HeapID)
+			{
+				/* Match - just return already created heap */
+				return psBMHeap;
+			}
 		}
 	}
 
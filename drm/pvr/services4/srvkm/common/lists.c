@@ -48,23 +48,16 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
   once are implemented locally).
   ===================================================================*/
 
-IMPLEMENT_LIST_ANY_VA(BM_HEAP)
 IMPLEMENT_LIST_ANY_2(BM_HEAP, PVRSRV_ERROR, PVRSRV_OK)
-IMPLEMENT_LIST_ANY_VA_2(BM_HEAP, PVRSRV_ERROR, PVRSRV_OK)
-IMPLEMENT_LIST_FOR_EACH_VA(BM_HEAP)
 IMPLEMENT_LIST_REMOVE(BM_HEAP)
 IMPLEMENT_LIST_INSERT(BM_HEAP)
 
-IMPLEMENT_LIST_ANY_VA(BM_CONTEXT)
-IMPLEMENT_LIST_ANY_VA_2(BM_CONTEXT, IMG_HANDLE, IMG_NULL)
-IMPLEMENT_LIST_ANY_VA_2(BM_CONTEXT, PVRSRV_ERROR, PVRSRV_OK)
 IMPLEMENT_LIST_FOR_EACH(BM_CONTEXT)
 IMPLEMENT_LIST_REMOVE(BM_CONTEXT)
 IMPLEMENT_LIST_INSERT(BM_CONTEXT)
 
 IMPLEMENT_LIST_ANY_2(PVRSRV_DEVICE_NODE, PVRSRV_ERROR, PVRSRV_OK)
 IMPLEMENT_LIST_ANY_VA(PVRSRV_DEVICE_NODE)
-IMPLEMENT_LIST_ANY_VA_2(PVRSRV_DEVICE_NODE, PVRSRV_ERROR, PVRSRV_OK)
 IMPLEMENT_LIST_FOR_EACH(PVRSRV_DEVICE_NODE)
 IMPLEMENT_LIST_FOR_EACH_VA(PVRSRV_DEVICE_NODE)
 IMPLEMENT_LIST_INSERT(PVRSRV_DEVICE_NODE)
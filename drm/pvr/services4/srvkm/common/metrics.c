@@ -39,6 +39,11 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */ /**************************************************************************/
 
+#include <linux/version.h>
+#include <linux/percpu.h>
+#include <linux/preempt.h>
+#include <linux/smp.h>
+
 #include "services_headers.h"
 #include "metrics.h"
 
@@ -52,116 +57,195 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "sgxapi_km.h"
 #endif
 
-#if defined(DEBUG) || defined(TIMING)
-
-static volatile IMG_UINT32 *pui32TimerRegister = 0;
-
-#define PVRSRV_TIMER_TOTAL_IN_TICKS(X)	asTimers[X].ui32Total
-#define PVRSRV_TIMER_TOTAL_IN_MS(X)		((1000*asTimers[X].ui32Total)/ui32TicksPerMS)
-#define PVRSRV_TIMER_COUNT(X)			asTimers[X].ui32Count
+#if defined(PVRSRV_METRICS)
 
+/*
+ * Samples are accumulated in per-CPU data so that timers on hot paths do not
+ * bounce a shared cache line or need a lock.  A CPU only ever updates its own
+ * copy, with preemption disabled; the timers are only run in process context,
+ * so nothing else on that CPU can update it at the same time.
+ */
+typedef struct _PVRSRV_METRICS_CPU_
+{
+	PVRSRV_METRIC_STATS	asTimers[PVRSRV_NUM_TIMERS];
+} PVRSRV_METRICS_CPU;
+
+static DEFINE_PER_CPU(PVRSRV_METRICS_CPU, sMetrics);
+
+/*
+ * per_cpu_ptr() and this_cpu_ptr() only take the address of a static
+ * per-CPU variable from 2.6.33; older kernels need per_cpu().
+ */
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,33)
+#define METRICS_CPU(iCPU)	per_cpu_ptr(&sMetrics, iCPU)
+#else
+#define METRICS_CPU(iCPU)	(&per_cpu(sMetrics, iCPU))
+#endif
 
-Temporal_Data asTimers[PVRSRV_NUM_TIMERS]; 
+static const IMG_CHAR *apszMetricNames[PVRSRV_NUM_TIMERS] =
+{
+	"bridge_dispatch",
+	"sgx_kick",
+	"mmu_map",
+	"dc_flip",
+};
 
 
 /***********************************************************************************
  Function Name      : PVRSRVTimeNow
  Inputs             : None
  Outputs            : None
- Returns            : Current timer register value
- Description        : Returns the current timer register value
+ Returns            : Current monotonic time in ns
+ Description        : Returns the timestamp used for all metric timers
 ************************************************************************************/
-IMG_UINT32 PVRSRVTimeNow(IMG_VOID)
+IMG_UINT64 PVRSRVTimeNow(IMG_VOID)
 {
-	if (!pui32TimerRegister)
-	{
-		static IMG_BOOL bFirstTime = IMG_TRUE;
+	return OSClockns64();
+}
 
-		if (bFirstTime)
-		{
-			PVR_DPF((PVR_DBG_ERROR,"PVRSRVTimeNow: No timer register set up"));
 
-			bFirstTime = IMG_FALSE;
-		}
+/***********************************************************************************
+ Function Name      : MetricBucket
+ Inputs             : ui64Ns
+ Outputs            : None
+ Returns            : Histogram bucket for a sample
+ Description        : log2 bucketing in units of 1024ns
+************************************************************************************/
+static IMG_UINT32 MetricBucket(IMG_UINT64 ui64Ns)
+{
+	IMG_UINT64 ui64Units = ui64Ns >> PVRSRV_METRIC_BUCKET_SHIFT;
+	IMG_UINT32 ui32Bucket = 0;
 
-		return 0;
+	while (ui64Units != 0 && ui32Bucket < (PVRSRV_METRIC_BUCKETS - 1))
+	{
+		ui64Units >>= 1;
+		ui32Bucket++;
 	}
 
-#if defined(__sh__)
-
-	return (0xffffffff-*pui32TimerRegister);
-
-#else /* defined(__sh__) */
-
-	return 0;
-
-#endif /* defined(__sh__) */
+	return ui32Bucket;
 }
 
 
 /***********************************************************************************
- Function Name      : PVRSRVGetCPUFreq
- Inputs             : None
+ Function Name      : PVRSRVMetricRecord
+ Inputs             : ui32Timer, ui64StartNs
  Outputs            : None
- Returns            : CPU timer frequency
- Description        : Returns the CPU timer frequency
+ Returns            : None
+ Description        : Accounts the time since ui64StartNs against a timer
 ************************************************************************************/
-static IMG_UINT32 PVRSRVGetCPUFreq(IMG_VOID)
+IMG_VOID PVRSRVMetricRecord(IMG_UINT32 ui32Timer, IMG_UINT64 ui64StartNs)
 {
-	IMG_UINT32 ui32Time1, ui32Time2;
-
-	ui32Time1 = PVRSRVTimeNow();
+	IMG_UINT64 ui64Elapsed = PVRSRVTimeNow() - ui64StartNs;
+	PVRSRV_METRIC_STATS *psStats;
 
-	OSWaitus(1000000);
+	PVR_ASSERT(ui32Timer < PVRSRV_NUM_TIMERS);
 
-	ui32Time2 = PVRSRVTimeNow();
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,33)
+	preempt_disable();
+	psStats = &this_cpu_ptr(&sMetrics)->asTimers[ui32Timer];
+#else
+	get_cpu();
+	psStats = &METRICS_CPU(smp_processor_id())->asTimers[ui32Timer];
+#endif
 
-	PVR_DPF((PVR_DBG_WARNING, "PVRSRVGetCPUFreq: timer frequency = %d Hz", ui32Time2 - ui32Time1));
+	psStats->ui32Count++;
+	psStats->ui64TotalNs += ui64Elapsed;
+	if (ui64Elapsed > psStats->ui64MaxNs)
+	{
+		psStats->ui64MaxNs = ui64Elapsed;
+	}
+	psStats->aui32Histogram[MetricBucket(ui64Elapsed)]++;
 
-	return (ui32Time2 - ui32Time1);
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,33)
+	preempt_enable();
+#else
+	put_cpu();
+#endif
 }
 
 
 /***********************************************************************************
- Function Name      : PVRSRVSetupMetricTimers
- Inputs             : pvDevInfo
- Outputs            : None
+ Function Name      : PVRSRVGetMetricStats
+ Inputs             : ui32Timer
+ Outputs            : psStats
  Returns            : None
- Description        : Resets metric timers and sets up the timer register
+ Description        : Sums the per-CPU samples of a timer.  Samples being
+                      recorded on other CPUs meanwhile may be missed.
 ************************************************************************************/
-IMG_VOID PVRSRVSetupMetricTimers(IMG_VOID *pvDevInfo)
+IMG_VOID PVRSRVGetMetricStats(IMG_UINT32 ui32Timer, PVRSRV_METRIC_STATS *psStats)
 {
-	IMG_UINT32 ui32Loop;
+	IMG_UINT32 ui32Bucket;
+	int iCPU;
 
-	PVR_UNREFERENCED_PARAMETER(pvDevInfo);
+	OSMemSet(psStats, 0, sizeof(*psStats));
 
-	for(ui32Loop=0; ui32Loop < (PVRSRV_NUM_TIMERS); ui32Loop++)
+	if (ui32Timer >= PVRSRV_NUM_TIMERS)
 	{
-		asTimers[ui32Loop].ui32Total = 0;
-		asTimers[ui32Loop].ui32Count = 0;
+		return;
 	}
 
-	#if defined(__sh__)
+	for_each_possible_cpu(iCPU)
+	{
+		PVRSRV_METRIC_STATS *psCPUStats = &METRICS_CPU(iCPU)->asTimers[ui32Timer];
 
-		/* timer control register */
-		// clock / 1024 when TIMER_DIVISOR = 4
-		// underflow int disabled
-		// we get approx 38 uS per timer tick 
-		*TCR_2 = TIMER_DIVISOR;
+		psStats->ui32Count += psCPUStats->ui32Count;
+		psStats->ui64TotalNs += psCPUStats->ui64TotalNs;
+		if (psCPUStats->ui64MaxNs > psStats->ui64MaxNs)
+		{
+			psStats->ui64MaxNs = psCPUStats->ui64MaxNs;
+		}
+		for (ui32Bucket = 0; ui32Bucket < PVRSRV_METRIC_BUCKETS; ui32Bucket++)
+		{
+			psStats->aui32Histogram[ui32Bucket] += psCPUStats->aui32Histogram[ui32Bucket];
+		}
+	}
+}
 
-		/* reset the timer counter to 0 */
-		*TCOR_2 = *TCNT_2 = (IMG_UINT)0xffffffff;
 
-		/* start timer 2 */
-		*TST_REG |= (IMG_UINT8)0x04;
+/***********************************************************************************
+ Function Name      : PVRSRVMetricName
+ Inputs             : ui32Timer
+ Outputs            : None
+ Returns            : Printable timer name
+ Description        : Used by the OS layer when reporting the metrics
+************************************************************************************/
+const IMG_CHAR *PVRSRVMetricName(IMG_UINT32 ui32Timer)
+{
+	return (ui32Timer < PVRSRV_NUM_TIMERS) ? apszMetricNames[ui32Timer] : "unknown";
+}
 
-		pui32TimerRegister = (IMG_UINT32 *)TCNT_2;
 
-	#else /* defined(__sh__) */
+/***********************************************************************************
+ Function Name      : PVRSRVResetMetrics
+ Inputs             : None
+ Outputs            : None
+ Returns            : None
+ Description        : Clears all timers.  Samples recorded concurrently with
+                      the reset may survive it.
+************************************************************************************/
+IMG_VOID PVRSRVResetMetrics(IMG_VOID)
+{
+	int iCPU;
 
-		pui32TimerRegister = 0;
+	for_each_possible_cpu(iCPU)
+	{
+		OSMemSet(METRICS_CPU(iCPU), 0, sizeof(PVRSRV_METRICS_CPU));
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : PVRSRVSetupMetricTimers
+ Inputs             : pvDevInfo
+ Outputs            : None
+ Returns            : None
+ Description        : Resets metric timers
+************************************************************************************/
+IMG_VOID PVRSRVSetupMetricTimers(IMG_VOID *pvDevInfo)
+{
+	PVR_UNREFERENCED_PARAMETER(pvDevInfo);
 
-	#endif /* defined(__sh__) */
+	PVRSRVResetMetrics();
 }
 
 
@@ -174,36 +258,22 @@ IMG_VOID PVRSRVSetupMetricTimers(IMG_VOID *pvDevInfo)
 ************************************************************************************/
 IMG_VOID PVRSRVOutputMetricTotals(IMG_VOID)
 {
-	IMG_UINT32 ui32TicksPerMS, ui32Loop;
-
-	ui32TicksPerMS = PVRSRVGetCPUFreq();
-
-	if (!ui32TicksPerMS)
-	{
-		PVR_DPF((PVR_DBG_ERROR,"PVRSRVOutputMetricTotals: Failed to get CPU Freq"));
-		return;
-	}
+	PVRSRV_METRIC_STATS sStats;
+	IMG_UINT32 ui32Loop;
 
 	for(ui32Loop=0; ui32Loop < (PVRSRV_NUM_TIMERS); ui32Loop++)
 	{
-		if (asTimers[ui32Loop].ui32Count & 0x80000000L)
-		{
-			PVR_DPF((PVR_DBG_WARNING,"PVRSRVOutputMetricTotals: Timer %u is still ON", ui32Loop));
-		}
+		PVRSRVGetMetricStats(ui32Loop, &sStats);
+
+		PVR_DPF((PVR_DBG_WARNING," Timer(%s): Count = %u, Total = %lluns, Max = %lluns",
+				 PVRSRVMetricName(ui32Loop), sStats.ui32Count,
+				 (unsigned long long)sStats.ui64TotalNs,
+				 (unsigned long long)sStats.ui64MaxNs));
 	}
-#if 0
-	/*
-	** EXAMPLE TIMER OUTPUT
-	*/
-	PVR_DPF((PVR_DBG_ERROR," Timer(%u): Total = %u",PVRSRV_TIMER_EXAMPLE_1, PVRSRV_TIMER_TOTAL_IN_TICKS(PVRSRV_TIMER_EXAMPLE_1)));
-	PVR_DPF((PVR_DBG_ERROR," Timer(%u): Time = %ums",PVRSRV_TIMER_EXAMPLE_1, PVRSRV_TIMER_TOTAL_IN_MS(PVRSRV_TIMER_EXAMPLE_1)));
-	PVR_DPF((PVR_DBG_ERROR," Timer(%u): Count = %u",PVRSRV_TIMER_EXAMPLE_1, PVRSRV_TIMER_COUNT(PVRSRV_TIMER_EXAMPLE_1)));
-#endif
 }
 
-#endif /* defined(DEBUG) || defined(TIMING) */
+#endif /* defined(PVRSRV_METRICS) */
 
 /******************************************************************************
  End of file (metrics.c)
 ******************************************************************************/
-
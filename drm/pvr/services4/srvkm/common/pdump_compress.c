@@ -0,0 +1,580 @@
+/*************************************************************************/ /*!
+@Title          PDump stream compression
+@Copyright      Copyright (c) Imagination Technologies Ltd. All Rights Reserved
+@Description    Delta, deduplicating and LZ encoder for PDUMP_COMPRESS captures
+@License        Dual MIT/GPLv2
+
+The contents of this file are subject to the MIT license as set out below.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+Alternatively, the contents of this file may be used under the terms of
+the GNU General Public License Version 2 ("GPL") in which case the provisions
+of GPL are applicable instead of those above.
+
+If you wish to allow use of your version of this file only under the terms of
+GPL, and not to allow others to use your version of this file under the terms
+of the MIT license, indicate your decision by deleting the provisions above
+and replace them with the notice and other provisions required by GPL as set
+out in the file called "GPL-COPYING" included in this distribution. If you do
+not delete the provisions above, a recipient may use your version of this file
+under the terms of either the MIT license or GPL.
+
+This License is also included in this distribution in the file called
+"MIT-COPYING".
+
+EXCEPT AS OTHERWISE STATED IN A NEGOTIATED AGREEMENT: (A) THE SOFTWARE IS
+PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT; AND (B) IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/ /**************************************************************************/
+
+#if defined(PDUMP) && defined(PDUMP_COMPRESS)
+
+#include "services_headers.h"
+#include "pdump_km.h"
+#include "pdump_compress_km.h"
+
+#define	MIN(x, y) (((x) < (y)) ? (x) : (y))
+
+/*
+	Room for the ops of a full block: a DATA op header per add plus the
+	data itself. Adds are refused once a block would exceed this.
+*/
+#define PDUMP_COMP_OP_MAX_HEADER	11
+#define PDUMP_COMP_OPS_SIZE			(PDUMP_COMP_BLOCK_SIZE + 64)
+
+/* Worst case LZ output for PDUMP_COMP_OPS_SIZE bytes, plus block header */
+#define PDUMP_COMP_BLOCK_HEADER		16
+#define PDUMP_COMP_BLOCK_BUF_SIZE	(PDUMP_COMP_BLOCK_HEADER + PDUMP_COMP_OPS_SIZE + \
+									 (PDUMP_COMP_OPS_SIZE / 255) + 16)
+
+#define PDUMP_COMP_LZ_HASH_BITS		12
+#define PDUMP_COMP_LZ_HASH_SIZE		(1UL << PDUMP_COMP_LZ_HASH_BITS)
+#define PDUMP_COMP_LZ_NO_POS		0xFFFF
+
+/* Parameter chunks smaller than this are not worth a hash lookup */
+#define PDUMP_COMP_DEDUP_MIN		256
+#define PDUMP_COMP_DEDUP_ENTRIES	1024
+#define PDUMP_COMP_MAX_CANDIDATES	4
+
+typedef struct _PDUMP_COMP_DEDUP_
+{
+	IMG_UINT64	ui64Hash;
+	IMG_UINT32	ui32Size;
+	IMG_UINT32	ui32Offset;
+} PDUMP_COMP_DEDUP;
+
+struct _PDUMP_COMP_CTX_
+{
+	IMG_UINT32			ui32AllocSize;
+
+	/* Op stream of the block being built */
+	IMG_UINT8			*pui8Ops;
+	IMG_UINT32			ui32OpsLen;
+	IMG_UINT32			ui32Decoded;
+
+	/* Last register write in the block, for REGW deltas */
+	IMG_BOOL			bRegW;
+	IMG_UINT32			ui32LastReg;
+	IMG_UINT32			ui32LastValue;
+
+	IMG_UINT8			*pui8Block;
+	IMG_UINT16			*pui16LZHash;
+
+	/*
+		Content hashes of parameter data known to be in the stream, and of
+		data in the current block which will be once it has been written.
+	*/
+	PDUMP_COMP_DEDUP	*psDedup;
+	PDUMP_COMP_DEDUP	asCandidate[PDUMP_COMP_MAX_CANDIDATES];
+	IMG_UINT32			ui32Candidates;
+};
+
+static IMG_UINT32 PutVarint(IMG_UINT8 *pui8Out, IMG_UINT32 ui32Value)
+{
+	IMG_UINT32 ui32Len = 0;
+
+	while (ui32Value >= 0x80)
+	{
+		pui8Out[ui32Len++] = (IMG_UINT8)(ui32Value | 0x80);
+		ui32Value >>= 7;
+	}
+	pui8Out[ui32Len++] = (IMG_UINT8)ui32Value;
+
+	return ui32Len;
+}
+
+static IMG_UINT64 HashData(IMG_UINT8 *pui8Data, IMG_UINT32 ui32Count)
+{
+	/* 64 bit FNV-1a */
+	IMG_UINT64 ui64Hash = 0xCBF29CE484222325ULL;
+	IMG_UINT32 i;
+
+	for (i = 0; i < ui32Count; i++)
+	{
+		ui64Hash ^= pui8Data[i];
+		ui64Hash *= 0x100000001B3ULL;
+	}
+
+	return ui64Hash;
+}
+
+static IMG_BOOL ParseHex(IMG_UINT8 *pui8Text, IMG_UINT32 *pui32Value)
+{
+	IMG_UINT32 ui32Value = 0;
+	IMG_UINT32 i;
+
+	for (i = 0; i < 8; i++)
+	{
+		IMG_UINT8 ui8Char = pui8Text[i];
+
+		if (ui8Char >= '0' && ui8Char <= '9')
+		{
+			ui32Value = (ui32Value << 4) | (ui8Char - '0');
+		}
+		else if (ui8Char >= 'A' && ui8Char <= 'F')
+		{
+			ui32Value = (ui32Value << 4) | (ui8Char - 'A' + 10);
+		}
+		else
+		{
+			return IMG_FALSE;
+		}
+	}
+
+	*pui32Value = ui32Value;
+	return IMG_TRUE;
+}
+
+/*
+	Recognise a line written by PDumpRegWithFlagsKM. Only the exact
+	fixed width form is accepted so the decoder reproduces it byte for byte.
+*/
+static IMG_BOOL ParseRegW(IMG_UINT8 *pui8Data, IMG_UINT32 ui32Count,
+						  IMG_UINT32 *pui32Reg, IMG_UINT32 *pui32Value)
+{
+	static const IMG_CHAR szPrefix[] = PDUMP_COMP_REGW_PREFIX;
+	IMG_UINT32 ui32PrefixLen = sizeof(szPrefix) - 1;
+	IMG_UINT32 i;
+
+	if (ui32Count != PDUMP_COMP_REGW_LEN)
+	{
+		return IMG_FALSE;
+	}
+
+	for (i = 0; i < ui32PrefixLen; i++)
+	{
+		if (pui8Data[i] != (IMG_UINT8)szPrefix[i])
+		{
+			return IMG_FALSE;
+		}
+	}
+
+	pui8Data += ui32PrefixLen;
+
+	return ParseHex(pui8Data, pui32Reg) &&
+		   pui8Data[8] == ' ' && pui8Data[9] == '0' && pui8Data[10] == 'x' &&
+		   ParseHex(&pui8Data[11], pui32Value) &&
+		   pui8Data[19] == '\r' && pui8Data[20] == '\n';
+}
+
+static IMG_UINT32 LZPutLength(IMG_UINT8 *pui8Out, IMG_UINT32 ui32Len)
+{
+	IMG_UINT32 ui32Out = 0;
+
+	while (ui32Len >= 255)
+	{
+		pui8Out[ui32Out++] = 255;
+		ui32Len -= 255;
+	}
+	pui8Out[ui32Out++] = (IMG_UINT8)ui32Len;
+
+	return ui32Out;
+}
+
+static IMG_UINT32 LZEmit(IMG_UINT8 *pui8Out, IMG_UINT8 *pui8Literals, IMG_UINT32 ui32Literals,
+						 IMG_UINT32 ui32Distance, IMG_UINT32 ui32Match)
+{
+	IMG_UINT32 ui32Out = 1;
+	IMG_UINT32 ui32MatchCode = (ui32Match != 0) ? ui32Match - PDUMP_COMP_LZ_MIN_MATCH : 0;
+
+	pui8Out[0] = (IMG_UINT8)((MIN(ui32Literals, 15) << 4) | MIN(ui32MatchCode, 15));
+
+	if (ui32Literals >= 15)
+	{
+		ui32Out += LZPutLength(&pui8Out[ui32Out], ui32Literals - 15);
+	}
+
+	OSMemCopy(&pui8Out[ui32Out], pui8Literals, ui32Literals);
+	ui32Out += ui32Literals;
+
+	if (ui32Match != 0)
+	{
+		pui8Out[ui32Out++] = (IMG_UINT8)(ui32Distance & 0xFF);
+		pui8Out[ui32Out++] = (IMG_UINT8)(ui32Distance >> 8);
+
+		if (ui32MatchCode >= 15)
+		{
+			ui32Out += LZPutLength(&pui8Out[ui32Out], ui32MatchCode - 15);
+		}
+	}
+
+	return ui32Out;
+}
+
+static IMG_UINT32 LZHash(IMG_UINT8 *pui8Data)
+{
+	IMG_UINT32 ui32Value = pui8Data[0] | (pui8Data[1] << 8) |
+						   (pui8Data[2] << 16) | ((IMG_UINT32)pui8Data[3] << 24);
+
+	return ((ui32Value * 2654435761UL) & 0xFFFFFFFFUL) >> (32 - PDUMP_COMP_LZ_HASH_BITS);
+}
+
+static IMG_UINT32 LZCompress(IMG_UINT16 *pui16Hash, IMG_UINT8 *pui8In, IMG_UINT32 ui32InLen, IMG_UINT8 *pui8Out)
+{
+	IMG_UINT32 ui32In = 0;
+	IMG_UINT32 ui32Anchor = 0;
+	IMG_UINT32 ui32Out = 0;
+
+	OSMemSet(pui16Hash, 0xFF, PDUMP_COMP_LZ_HASH_SIZE * sizeof(IMG_UINT16));
+
+	while (ui32In + PDUMP_COMP_LZ_MIN_MATCH <= ui32InLen)
+	{
+		IMG_UINT32 ui32Hash = LZHash(&pui8In[ui32In]);
+		IMG_UINT32 ui32Cand = pui16Hash[ui32Hash];
+		IMG_UINT32 ui32Match = 0;
+
+		pui16Hash[ui32Hash] = (IMG_UINT16)ui32In;
+
+		if (ui32Cand != PDUMP_COMP_LZ_NO_POS)
+		{
+			while ((ui32In + ui32Match) < ui32InLen &&
+				   pui8In[ui32Cand + ui32Match] == pui8In[ui32In + ui32Match])
+			{
+				ui32Match++;
+			}
+		}
+
+		if (ui32Match >= PDUMP_COMP_LZ_MIN_MATCH)
+		{
+			ui32Out += LZEmit(&pui8Out[ui32Out], &pui8In[ui32Anchor], ui32In - ui32Anchor,
+							  ui32In - ui32Cand, ui32Match);
+			ui32In += ui32Match;
+			ui32Anchor = ui32In;
+		}
+		else
+		{
+			ui32In++;
+		}
+	}
+
+	/* The payload always ends with a literal only sequence */
+	ui32Out += LZEmit(&pui8Out[ui32Out], &pui8In[ui32Anchor], ui32InLen - ui32Anchor, 0, 0);
+
+	return ui32Out;
+}
+
+/*!
+******************************************************************************
+
+ @Function	PDumpCompCreate
+
+ @Description	Allocates an encoder for one PDump stream
+
+ @Input		bDedup : IMG_TRUE to deduplicate repeated data by content hash
+ @Output	ppsCtx : the encoder
+
+ @Return	PVRSRV_ERROR
+
+******************************************************************************/
+PVRSRV_ERROR PDumpCompCreate(IMG_BOOL bDedup, PDUMP_COMP_CTX **ppsCtx)
+{
+	PDUMP_COMP_CTX	*psCtx;
+	IMG_UINT32		ui32Size;
+	IMG_UINT8		*pui8Mem;
+
+	ui32Size = sizeof(*psCtx) +
+			   PDUMP_COMP_OPS_SIZE +
+			   PDUMP_COMP_BLOCK_BUF_SIZE +
+			   PDUMP_COMP_LZ_HASH_SIZE * sizeof(IMG_UINT16);
+	if (bDedup)
+	{
+		ui32Size += PDUMP_COMP_DEDUP_ENTRIES * sizeof(PDUMP_COMP_DEDUP);
+	}
+
+	if (OSAllocMem(PVRSRV_OS_PAGEABLE_HEAP, ui32Size, (IMG_PVOID *)&pui8Mem, IMG_NULL,
+				   "PDump compression context") != PVRSRV_OK)
+	{
+		return PVRSRV_ERROR_OUT_OF_MEMORY;
+	}
+	OSMemSet(pui8Mem, 0, ui32Size);
+
+	/* The context comes first so the 64 bit hashes that follow stay aligned */
+	psCtx = (PDUMP_COMP_CTX *)pui8Mem;
+	pui8Mem += sizeof(*psCtx);
+
+	psCtx->ui32AllocSize = ui32Size;
+	if (bDedup)
+	{
+		psCtx->psDedup = (PDUMP_COMP_DEDUP *)pui8Mem;
+		pui8Mem += PDUMP_COMP_DEDUP_ENTRIES * sizeof(PDUMP_COMP_DEDUP);
+	}
+	psCtx->pui16LZHash = (IMG_UINT16 *)pui8Mem;
+	pui8Mem += PDUMP_COMP_LZ_HASH_SIZE * sizeof(IMG_UINT16);
+	psCtx->pui8Ops = pui8Mem;
+	pui8Mem += PDUMP_COMP_OPS_SIZE;
+	psCtx->pui8Block = pui8Mem;
+
+	*ppsCtx = psCtx;
+
+	return PVRSRV_OK;
+}
+
+IMG_VOID PDumpCompDestroy(PDUMP_COMP_CTX *psCtx)
+{
+	OSFreeMem(PVRSRV_OS_PAGEABLE_HEAP, psCtx->ui32AllocSize, psCtx, IMG_NULL);
+}
+
+/*!
+******************************************************************************
+
+ @Function	PDumpCompPending
+
+ @Return	Decoded size of the data waiting in the current block
+
+******************************************************************************/
+IMG_UINT32 PDumpCompPending(PDUMP_COMP_CTX *psCtx)
+{
+	return psCtx->ui32Decoded;
+}
+
+/*!
+******************************************************************************
+
+ @Function	PDumpCompAdd
+
+ @Description	Adds data to the current block. Register writes become REGW
+				ops; parameter data already in the stream becomes a COPY.
+
+ @Input		psCtx : encoder
+ @Input		pui8Data : data
+ @Input		ui32Count : size, at most PDUMP_COMP_BLOCK_SIZE
+ @Input		ui32Offset : stream offset the data will be written at, or
+						 PDUMP_COMP_NO_OFFSET to disable deduplication
+
+ @Return	IMG_FALSE if the block is full and must be finished first
+
+******************************************************************************/
+IMG_BOOL PDumpCompAdd(PDUMP_COMP_CTX *psCtx, IMG_UINT8 *pui8Data, IMG_UINT32 ui32Count, IMG_UINT32 ui32Offset)
+{
+	IMG_UINT8	*pui8Op;
+	IMG_UINT32	ui32Reg;
+	IMG_UINT32	ui32Value;
+
+	PVR_ASSERT(ui32Count <= PDUMP_COMP_BLOCK_SIZE);
+
+	if ((psCtx->ui32Decoded + ui32Count) > PDUMP_COMP_BLOCK_SIZE ||
+		(psCtx->ui32OpsLen + ui32Count + PDUMP_COMP_OP_MAX_HEADER) > PDUMP_COMP_OPS_SIZE)
+	{
+		return IMG_FALSE;
+	}
+
+	pui8Op = &psCtx->pui8Ops[psCtx->ui32OpsLen];
+
+	if (ParseRegW(pui8Data, ui32Count, &ui32Reg, &ui32Value))
+	{
+		if (psCtx->bRegW && ui32Reg == psCtx->ui32LastReg && ui32Value == psCtx->ui32LastValue)
+		{
+			*pui8Op++ = PDUMP_COMP_OP_REGW_REPEAT;
+		}
+		else
+		{
+			IMG_UINT32 ui32Delta = (ui32Reg - psCtx->ui32LastReg) & 0xFFFFFFFFUL;
+
+			*pui8Op++ = PDUMP_COMP_OP_REGW;
+			pui8Op += PutVarint(pui8Op, ((ui32Delta << 1) ^ (0 - (ui32Delta >> 31))) & 0xFFFFFFFFUL);
+			pui8Op += PutVarint(pui8Op, ui32Value);
+		}
+
+		psCtx->bRegW = IMG_TRUE;
+		psCtx->ui32LastReg = ui32Reg;
+		psCtx->ui32LastValue = ui32Value;
+	}
+	else if (psCtx->psDedup != IMG_NULL &&
+			 ui32Offset != PDUMP_COMP_NO_OFFSET &&
+			 ui32Count >= PDUMP_COMP_DEDUP_MIN)
+	{
+		IMG_UINT64 ui64Hash = HashData(pui8Data, ui32Count);
+		PDUMP_COMP_DEDUP *psEntry = &psCtx->psDedup[ui64Hash & (PDUMP_COMP_DEDUP_ENTRIES - 1)];
+
+		if (psEntry->ui32Size == ui32Count &&
+			psEntry->ui64Hash == ui64Hash &&
+			(psEntry->ui32Offset + ui32Count) <= ui32Offset)
+		{
+			*pui8Op++ = PDUMP_COMP_OP_COPY;
+			pui8Op += PutVarint(pui8Op, psEntry->ui32Offset);
+			pui8Op += PutVarint(pui8Op, ui32Count);
+		}
+		else
+		{
+			*pui8Op++ = PDUMP_COMP_OP_DATA;
+			pui8Op += PutVarint(pui8Op, ui32Count);
+			OSMemCopy(pui8Op, pui8Data, ui32Count);
+			pui8Op += ui32Count;
+
+			if (psCtx->ui32Candidates < PDUMP_COMP_MAX_CANDIDATES)
+			{
+				PDUMP_COMP_DEDUP *psCand = &psCtx->asCandidate[psCtx->ui32Candidates++];
+
+				psCand->ui64Hash = ui64Hash;
+				psCand->ui32Size = ui32Count;
+				psCand->ui32Offset = ui32Offset;
+			}
+		}
+	}
+	else
+	{
+		*pui8Op++ = PDUMP_COMP_OP_DATA;
+		pui8Op += PutVarint(pui8Op, ui32Count);
+		OSMemCopy(pui8Op, pui8Data, ui32Count);
+		pui8Op += ui32Count;
+	}
+
+	psCtx->ui32OpsLen = (IMG_UINT32)(pui8Op - psCtx->pui8Ops);
+	psCtx->ui32Decoded += ui32Count;
+
+	return IMG_TRUE;
+}
+
+/*!
+******************************************************************************
+
+ @Function	PDumpCompFinish
+
+ @Description	Closes the current block, LZ compressing it if that helps.
+				The returned buffer is valid until the next call.
+
+ @Input		psCtx : encoder
+ @Output	pui32Size : size of the encoded block
+ @Output	pui32Decoded : size of the data it decodes to
+
+ @Return	The encoded block
+
+******************************************************************************/
+IMG_UINT8 *PDumpCompFinish(PDUMP_COMP_CTX *psCtx, IMG_UINT32 *pui32Size, IMG_UINT32 *pui32Decoded)
+{
+	IMG_UINT8	*pui8Payload = &psCtx->pui8Block[PDUMP_COMP_BLOCK_HEADER];
+	IMG_UINT8	aui8Header[PDUMP_COMP_BLOCK_HEADER];
+	IMG_UINT32	ui32HeaderLen;
+	IMG_UINT32	ui32PayloadLen;
+
+	ui32PayloadLen = LZCompress(psCtx->pui16LZHash, psCtx->pui8Ops, psCtx->ui32OpsLen, pui8Payload);
+	if (ui32PayloadLen < psCtx->ui32OpsLen)
+	{
+		aui8Header[0] = PDUMP_COMP_BLOCK_LZ_OPS;
+	}
+	else
+	{
+		aui8Header[0] = PDUMP_COMP_BLOCK_OPS;
+		ui32PayloadLen = psCtx->ui32OpsLen;
+		OSMemCopy(pui8Payload, psCtx->pui8Ops, ui32PayloadLen);
+	}
+
+	ui32HeaderLen = 1;
+	ui32HeaderLen += PutVarint(&aui8Header[ui32HeaderLen], psCtx->ui32Decoded);
+	ui32HeaderLen += PutVarint(&aui8Header[ui32HeaderLen], ui32PayloadLen);
+
+	/* Place the header directly in front of the payload */
+	OSMemCopy(pui8Payload - ui32HeaderLen, aui8Header, ui32HeaderLen);
+
+	*pui32Size = ui32HeaderLen + ui32PayloadLen;
+	*pui32Decoded = psCtx->ui32Decoded;
+
+	psCtx->ui32OpsLen = 0;
+	psCtx->ui32Decoded = 0;
+	psCtx->bRegW = IMG_FALSE;
+	psCtx->ui32LastReg = 0;
+	psCtx->ui32LastValue = 0;
+
+	return pui8Payload - ui32HeaderLen;
+}
+
+/*!
+******************************************************************************
+
+ @Function	PDumpCompCommit
+
+ @Description	Called once the finished block has been handed to the debug
+				driver. Data in the block becomes a deduplication source only
+				if the block actually reached the stream.
+
+ @Input		psCtx : encoder
+ @Input		bWritten : whether the block was written
+
+******************************************************************************/
+IMG_VOID PDumpCompCommit(PDUMP_COMP_CTX *psCtx, IMG_BOOL bWritten)
+{
+	IMG_UINT32 i;
+
+	if (bWritten)
+	{
+		for (i = 0; i < psCtx->ui32Candidates; i++)
+		{
+			PDUMP_COMP_DEDUP *psCand = &psCtx->asCandidate[i];
+
+			psCtx->psDedup[psCand->ui64Hash & (PDUMP_COMP_DEDUP_ENTRIES - 1)] = *psCand;
+		}
+	}
+
+	psCtx->ui32Candidates = 0;
+}
+
+/*!
+******************************************************************************
+
+ @Function	PDumpCompInvalidate
+
+ @Description	Forgets data at or beyond ui32Offset, for when the stream has
+				been rewound (e.g. the capture tool reset it)
+
+ @Input		psCtx : encoder
+ @Input		ui32Offset : new end of the stream
+
+******************************************************************************/
+IMG_VOID PDumpCompInvalidate(PDUMP_COMP_CTX *psCtx, IMG_UINT32 ui32Offset)
+{
+	IMG_UINT32 i;
+
+	if (psCtx->psDedup == IMG_NULL)
+	{
+		return;
+	}
+
+	for (i = 0; i < PDUMP_COMP_DEDUP_ENTRIES; i++)
+	{
+		PDUMP_COMP_DEDUP *psEntry = &psCtx->psDedup[i];
+
+		if (psEntry->ui32Size != 0 && (psEntry->ui32Offset + psEntry->ui32Size) > ui32Offset)
+		{
+			psEntry->ui32Size = 0;
+		}
+	}
+}
+
+#endif /* defined(PDUMP) && defined(PDUMP_COMPRESS) */
+
+/******************************************************************************
+ End of file (pdump_compress.c)
+******************************************************************************/
@@ -50,19 +50,25 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 static HASH_TABLE *psHashTab = IMG_NULL;
 
+/* Process whose resources are being freed; it is no longer in psHashTab */
+static PVRSRV_PER_PROCESS_DATA *psTerminatingPerProc = IMG_NULL;
+
 /*!
 ******************************************************************************
 
- @Function	FreePerProcData
+ @Function	DetachPerProcessData
 
- @Description	Free a per-process data area
+ @Description	Remove a per-process data area from the hash table and
+ 				release its global handle, so that no other caller can find
+ 				it.  Its resources can then be freed without the bridge lock
+ 				being held throughout.
 
  @Input		psPerProc - pointer to per-process data area
 
  @Return	Error code, or PVRSRV_OK
 
 ******************************************************************************/
-static PVRSRV_ERROR FreePerProcessData(PVRSRV_PER_PROCESS_DATA *psPerProc)
+static PVRSRV_ERROR DetachPerProcessData(PVRSRV_PER_PROCESS_DATA *psPerProc)
 {
 	PVRSRV_ERROR eError;
 	IMG_UINTPTR_T uiPerProc;
@@ -71,14 +77,14 @@ static PVRSRV_ERROR FreePerProcessData(PVRSRV_PER_PROCESS_DATA *psPerProc)
 
 	if (psPerProc == IMG_NULL)
 	{
-		PVR_DPF((PVR_DBG_ERROR, "FreePerProcessData: invalid parameter"));
+		PVR_DPF((PVR_DBG_ERROR, "DetachPerProcessData: invalid parameter"));
 		return PVRSRV_ERROR_INVALID_PARAMS;
 	}
 
 	uiPerProc = HASH_Remove(psHashTab, (IMG_UINTPTR_T)psPerProc->ui32PID);
 	if (uiPerProc == 0)
 	{
-		PVR_DPF((PVR_DBG_ERROR, "FreePerProcessData: Couldn't find process in per-process data hash table"));
+		PVR_DPF((PVR_DBG_ERROR, "DetachPerProcessData: Couldn't find process in per-process data hash table"));
 		/*
 		 * We must have failed early in the per-process data area
 		 * creation, before the process ID was set.
@@ -91,25 +97,54 @@ static PVRSRV_ERROR FreePerProcessData(PVRSRV_PER_PROCESS_DATA *psPerProc)
 		PVR_ASSERT(((PVRSRV_PER_PROCESS_DATA *)uiPerProc)->ui32PID == psPerProc->ui32PID);
 	}
 
-	/* Free handle base for this process */
-	if (psPerProc->psHandleBase != IMG_NULL)
+	/* Release handle for per-process data area */
+	if (psPerProc->hPerProcData != IMG_NULL)
 	{
-		eError = PVRSRVFreeHandleBase(psPerProc->psHandleBase);
+		eError = PVRSRVReleaseHandle(KERNEL_HANDLE_BASE, psPerProc->hPerProcData, PVRSRV_HANDLE_TYPE_PERPROC_DATA);
+
 		if (eError != PVRSRV_OK)
 		{
-			PVR_DPF((PVR_DBG_ERROR, "FreePerProcessData: Couldn't free handle base for process (%d)", eError));
+			PVR_DPF((PVR_DBG_ERROR, "DetachPerProcessData: Couldn't release per-process data handle (%d)", eError));
 			return eError;
 		}
+		psPerProc->hPerProcData = IMG_NULL;
 	}
 
-	/* Release handle for per-process data area */
-	if (psPerProc->hPerProcData != IMG_NULL)
+	return PVRSRV_OK;
+}
+
+
+/*!
+******************************************************************************
+
+ @Function	FreePerProcData
+
+ @Description	Free a per-process data area, once detached
+
+ @Input		psPerProc - pointer to per-process data area
+
+ @Return	Error code, or PVRSRV_OK
+
+******************************************************************************/
+static PVRSRV_ERROR FreePerProcessData(PVRSRV_PER_PROCESS_DATA *psPerProc)
+{
+	PVRSRV_ERROR eError;
+
+	PVR_ASSERT(psPerProc != IMG_NULL);
+
+	if (psPerProc == IMG_NULL)
 	{
-		eError = PVRSRVReleaseHandle(KERNEL_HANDLE_BASE, psPerProc->hPerProcData, PVRSRV_HANDLE_TYPE_PERPROC_DATA);
+		PVR_DPF((PVR_DBG_ERROR, "FreePerProcessData: invalid parameter"));
+		return PVRSRV_ERROR_INVALID_PARAMS;
+	}
 
+	/* Free handle base for this process */
+	if (psPerProc->psHandleBase != IMG_NULL)
+	{
+		eError = PVRSRVFreeHandleBase(psPerProc->psHandleBase);
 		if (eError != PVRSRV_OK)
 		{
-			PVR_DPF((PVR_DBG_ERROR, "FreePerProcessData: Couldn't release per-process data handle (%d)", eError));
+			PVR_DPF((PVR_DBG_ERROR, "FreePerProcessData: Couldn't free handle base for process (%d)", eError));
 			return eError;
 		}
 	}
@@ -266,7 +301,10 @@ PVRSRV_ERROR PVRSRVPerProcessDataConnect(IMG_UINT32	ui32PID)
 	return eError;
 
 failure:
-	(IMG_VOID)FreePerProcessData(psPerProc);
+	if (DetachPerProcessData(psPerProc) == PVRSRV_OK)
+	{
+		(IMG_VOID)FreePerProcessData(psPerProc);
+	}
 	return eError;
 }
 
@@ -304,15 +342,18 @@ IMG_VOID PVRSRVPerProcessDataDisconnect(IMG_UINT32	ui32PID)
 			PVR_DPF((PVR_DBG_MESSAGE, "PVRSRVPerProcessDataDisconnect: "
 					"Last close from process 0x%x received", ui32PID));
 
-			/* Close the Resource Manager connection */
-			PVRSRVResManDisconnect(psPerProc->hResManContext, IMG_FALSE);
-
-
-			/* Free the per-process data */
-			eError = FreePerProcessData(psPerProc);
-			if (eError != PVRSRV_OK)
+			/*
+			 * Take the data out of the hash table now, so that a new
+			 * connection from this PID starts afresh, then free the
+			 * resources on the teardown worker a chunk at a time.
+			 */
+			if (DetachPerProcessData(psPerProc) != PVRSRV_OK)
 			{
-				PVR_DPF((PVR_DBG_ERROR, "PVRSRVPerProcessDataDisconnect: Error freeing per-process data"));
+				PVR_DPF((PVR_DBG_ERROR, "PVRSRVPerProcessDataDisconnect: Couldn't detach per-process data"));
+			}
+			else if (OSScheduleProcessTeardown(psPerProc) != PVRSRV_OK)
+			{
+				(IMG_VOID)PVRSRVPerProcessDataTeardown(psPerProc, 0xFFFFFFFFUL);
 			}
 		}
 	}
@@ -325,6 +366,76 @@ IMG_VOID PVRSRVPerProcessDataDisconnect(IMG_UINT32	ui32PID)
 }
 
 
+/*!
+******************************************************************************
+
+ @Function	PVRSRVPerProcessDataTeardown
+
+ @Description	Free some of the resources of a detached process whose last
+ 				connection has closed, and its per-process data once none
+ 				are left.  Called with the bridge lock held; the teardown
+ 				worker drops the lock between calls, so other clients are
+ 				only held off for one chunk at a time.
+
+ @Input		psPerProc - per-process data, detached by the last disconnect
+ @Input		ui32MaxResources - most resources to free in this call
+
+ @Return	IMG_TRUE once the per-process data has been freed
+
+******************************************************************************/
+IMG_BOOL PVRSRVPerProcessDataTeardown(PVRSRV_PER_PROCESS_DATA *psPerProc,
+									  IMG_UINT32 ui32MaxResources)
+{
+	PVRSRV_ERROR eError;
+
+	PVR_ASSERT(psPerProc->ui32RefCount == 0);
+
+	psTerminatingPerProc = psPerProc;
+
+	if (!PVRSRVResManFreeChunk(psPerProc->hResManContext, ui32MaxResources))
+	{
+		psTerminatingPerProc = IMG_NULL;
+		return IMG_FALSE;
+	}
+
+	/* Close the Resource Manager connection, now empty */
+	PVRSRVResManDisconnect(psPerProc->hResManContext, IMG_FALSE);
+
+	/* Free the per-process data */
+	if (FreePerProcessData(psPerProc) != PVRSRV_OK)
+	{
+		PVR_DPF((PVR_DBG_ERROR, "PVRSRVPerProcessDataTeardown: Error freeing per-process data"));
+	}
+
+	psTerminatingPerProc = IMG_NULL;
+
+	eError = PVRSRVPurgeHandles(KERNEL_HANDLE_BASE);
+	if (eError != PVRSRV_OK)
+	{
+		PVR_DPF((PVR_DBG_ERROR, "PVRSRVPerProcessDataTeardown: Purge of global handle pool failed (%d)", eError));
+	}
+
+	return IMG_TRUE;
+}
+
+
+/*!
+******************************************************************************
+
+ @Function	PVRSRVTerminatingPerProcessData
+
+ @Description	Return the per-process data of the process being torn down,
+ 				which can no longer be found by PID
+
+ @Return	Pointer to per-process data area, or IMG_NULL
+
+******************************************************************************/
+PVRSRV_PER_PROCESS_DATA *PVRSRVTerminatingPerProcessData(IMG_VOID)
+{
+	return psTerminatingPerProc;
+}
+
+
 /*!
 ******************************************************************************
 
@@ -53,21 +53,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "lists.h"
 
 
-DECLARE_LIST_ANY_VA_2(BM_CONTEXT, PVRSRV_ERROR, PVRSRV_OK);
-
-DECLARE_LIST_FOR_EACH_VA(BM_HEAP);
-
 DECLARE_LIST_ANY_2(PVRSRV_DEVICE_NODE, PVRSRV_ERROR, PVRSRV_OK);
-DECLARE_LIST_ANY_VA(PVRSRV_DEVICE_NODE);
-DECLARE_LIST_ANY_VA_2(PVRSRV_DEVICE_NODE, PVRSRV_ERROR, PVRSRV_OK);
-DECLARE_LIST_FOR_EACH_VA(PVRSRV_DEVICE_NODE);
 DECLARE_LIST_FOR_EACH(PVRSRV_DEVICE_NODE);
 DECLARE_LIST_INSERT(PVRSRV_DEVICE_NODE);
 DECLARE_LIST_REMOVE(PVRSRV_DEVICE_NODE);
 
-IMG_VOID* MatchDeviceKM_AnyVaCb(PVRSRV_DEVICE_NODE* psDeviceNode, va_list va);
-
-
 /*!
 ******************************************************************************
 
@@ -250,31 +240,31 @@ IMG_VOID WriteHWRegs(IMG_PVOID pvLinRegBaseAddr, IMG_UINT32 ui32Count, PVRSRV_HW
 
 /*!
 ******************************************************************************
- @Function	PVRSRVEnumerateDCKM_ForEachVaCb
+ @Function	MatchDeviceIndex
 
  @Description
 
- Enumerates the device node (if is of the same class as given).
+ Finds the device node with the given index in a device list.
 
- @Input psDeviceNode	- The device node to be enumerated
- 		va				- variable arguments list, with:
-							pui32DevCount	- The device count pointer (to be increased)
-							ppui32DevID		- The pointer to the device IDs pointer (to be updated and increased)
+ @Input psDeviceNodeList	- The list of device nodes to search
+ @Input ui32DevIndex		- Index of the device to match
+
+ @Return	The matching device node, or IMG_NULL
 ******************************************************************************/
-IMG_VOID PVRSRVEnumerateDevicesKM_ForEachVaCb(PVRSRV_DEVICE_NODE *psDeviceNode, va_list va)
+static INLINE PVRSRV_DEVICE_NODE *MatchDeviceIndex(PVRSRV_DEVICE_NODE *psDeviceNodeList,
+												   IMG_UINT32 ui32DevIndex)
 {
-	IMG_UINT *pui32DevCount;
-	PVRSRV_DEVICE_IDENTIFIER **ppsDevIdList;
-
-	pui32DevCount = va_arg(va, IMG_UINT*);
-	ppsDevIdList = va_arg(va, PVRSRV_DEVICE_IDENTIFIER**);
+	PVRSRV_DEVICE_NODE *psDeviceNode;
 
-	if (psDeviceNode->sDevId.eDeviceType != PVRSRV_DEVICE_TYPE_EXT)
+	LIST_FOR_EACH(psDeviceNode, psDeviceNodeList)
 	{
-		*(*ppsDevIdList) = psDeviceNode->sDevId;
-		(*ppsDevIdList)++;
-		(*pui32DevCount)++;
+		if (psDeviceNode->sDevId.ui32DeviceIndex == ui32DevIndex)
+		{
+			break;
+		}
 	}
+
+	return psDeviceNode;
 }
 
 
@@ -315,7 +305,7 @@ PVRSRV_ERROR IMG_CALLCONV PVRSRVEnumerateDevicesKM(IMG_UINT32 *pui32NumDevices,
 											 	   PVRSRV_DEVICE_IDENTIFIER *psDevIdList)
 {
 	SYS_DATA			*psSysData;
-/*	PVRSRV_DEVICE_NODE	*psDeviceNode; */
+	PVRSRV_DEVICE_NODE	*psDeviceNode;
 	IMG_UINT32 			i;
 
 	if (!pui32NumDevices || !psDevIdList)
@@ -342,10 +332,14 @@ PVRSRV_ERROR IMG_CALLCONV PVRSRVEnumerateDevicesKM(IMG_UINT32 *pui32NumDevices,
 		return id info for each device and the number of devices
 		available
 	*/
-	List_PVRSRV_DEVICE_NODE_ForEach_va(psSysData->psDeviceNodeList,
-									   PVRSRVEnumerateDevicesKM_ForEachVaCb,
-									   pui32NumDevices,
-									   &psDevIdList);
+	LIST_FOR_EACH(psDeviceNode, psSysData->psDeviceNodeList)
+	{
+		if (psDeviceNode->sDevId.eDeviceType != PVRSRV_DEVICE_TYPE_EXT)
+		{
+			*psDevIdList++ = psDeviceNode->sDevId;
+			(*pui32NumDevices)++;
+		}
+	}
 
 
 	return PVRSRV_OK;
@@ -571,11 +565,7 @@ PVRSRV_ERROR IMG_CALLCONV PVRSRVInitialiseDevice (IMG_UINT32 ui32DevIndex)
 	SysAcquireData(&psSysData);
 
 	/* Find device in the list */
-	psDeviceNode = (PVRSRV_DEVICE_NODE*)
-					 List_PVRSRV_DEVICE_NODE_Any_va(psSysData->psDeviceNodeList,
-													MatchDeviceKM_AnyVaCb,
-													ui32DevIndex,
-													IMG_TRUE);
+	psDeviceNode = MatchDeviceIndex(psSysData->psDeviceNodeList, ui32DevIndex);
 	if(!psDeviceNode)
 	{
 		/* Devinfo not in the list */
@@ -709,7 +699,7 @@ PVRSRV_ERROR PVRSRVDevInitCompatCheck(PVRSRV_DEVICE_NODE *psDeviceNode)
 /*!
 ******************************************************************************
 
- @Function	PVRSRVAcquireDeviceDataKM
+ @Function	PVRSRVAcquireDeviceDataKM_Match
 
  @Description
 
@@ -717,35 +707,23 @@ PVRSRV_ERROR PVRSRVDevInitCompatCheck(PVRSRV_DEVICE_NODE *psDeviceNode)
 
  @input	psDeviceNode :The device node to be matched.
 
- @Input	   va : Variable argument list with:
-			eDeviceType : Required device type. If type is unknown use ui32DevIndex
+ @Input	   eDeviceType : Required device type. If type is unknown use ui32DevIndex
 						 to locate device data
 
- 			ui32DevIndex : Index to the required device obtained from the
+ @Input	   ui32DevIndex : Index to the required device obtained from the
 						PVRSRVEnumerateDevice function
 
- @Return   PVRSRV_ERROR  :
+ @Return   IMG_BOOL  : IMG_TRUE if the device matches
 
 ******************************************************************************/
-IMG_VOID * PVRSRVAcquireDeviceDataKM_Match_AnyVaCb(PVRSRV_DEVICE_NODE *psDeviceNode, va_list va)
+static INLINE IMG_BOOL PVRSRVAcquireDeviceDataKM_Match(PVRSRV_DEVICE_NODE *psDeviceNode,
+													   PVRSRV_DEVICE_TYPE eDeviceType,
+													   IMG_UINT32 ui32DevIndex)
 {
-	PVRSRV_DEVICE_TYPE eDeviceType;
-	IMG_UINT32 ui32DevIndex;
-
-	eDeviceType = va_arg(va, PVRSRV_DEVICE_TYPE);
-	ui32DevIndex = va_arg(va, IMG_UINT32);
-
-	if ((eDeviceType != PVRSRV_DEVICE_TYPE_UNKNOWN &&
+	return (IMG_BOOL)((eDeviceType != PVRSRV_DEVICE_TYPE_UNKNOWN &&
 		psDeviceNode->sDevId.eDeviceType == eDeviceType) ||
 		(eDeviceType == PVRSRV_DEVICE_TYPE_UNKNOWN &&
-		 psDeviceNode->sDevId.ui32DeviceIndex == ui32DevIndex))
-	{
-		return psDeviceNode;
-	}
-	else
-	{
-		return IMG_NULL;
-	}
+		 psDeviceNode->sDevId.ui32DeviceIndex == ui32DevIndex));
 }
 
 /*!
@@ -782,10 +760,13 @@ PVRSRV_ERROR IMG_CALLCONV PVRSRVAcquireDeviceDataKM (IMG_UINT32			ui32DevIndex,
 	SysAcquireData(&psSysData);
 
 	/* Find device in the list */
-	psDeviceNode = List_PVRSRV_DEVICE_NODE_Any_va(psSysData->psDeviceNodeList,
-												PVRSRVAcquireDeviceDataKM_Match_AnyVaCb,
-												eDeviceType,
-												ui32DevIndex);
+	LIST_FOR_EACH(psDeviceNode, psSysData->psDeviceNodeList)
+	{
+		if (PVRSRVAcquireDeviceDataKM_Match(psDeviceNode, eDeviceType, ui32DevIndex))
+		{
+			break;
+		}
+	}
 
 
 	if (!psDeviceNode)
@@ -831,11 +812,7 @@ PVRSRV_ERROR IMG_CALLCONV PVRSRVDeinitialiseDevice(IMG_UINT32 ui32DevIndex)
 
 	SysAcquireData(&psSysData);
 
-	psDeviceNode = (PVRSRV_DEVICE_NODE*)
-					 List_PVRSRV_DEVICE_NODE_Any_va(psSysData->psDeviceNodeList,
-													MatchDeviceKM_AnyVaCb,
-													ui32DevIndex,
-													IMG_TRUE);
+	psDeviceNode = MatchDeviceIndex(psSysData->psDeviceNodeList, ui32DevIndex);
 
 	if (!psDeviceNode)
 	{
@@ -955,62 +932,53 @@ PVRSRV_ERROR PollForInterruptKM (IMG_UINT32 ui32Value,
 }
 #endif
 
-IMG_VOID PVRSRVGetMiscInfoKM_RA_GetStats_ForEachVaCb(BM_HEAP *psBMHeap, va_list va)
+static INLINE IMG_VOID PVRSRVGetMiscInfoKM_RA_GetStats(BM_HEAP *psBMHeapList,
+													   IMG_CHAR **ppszStr,
+													   IMG_UINT32 *pui32StrLen)
 {
-	IMG_CHAR **ppszStr;
-	IMG_UINT32 *pui32StrLen;
-
-	ppszStr = va_arg(va, IMG_CHAR**);
-	pui32StrLen = va_arg(va, IMG_UINT32*);
+	BM_HEAP *psBMHeap;
 
-	if(psBMHeap->pImportArena)
+	LIST_FOR_EACH(psBMHeap, psBMHeapList)
 	{
-		RA_GetStats(psBMHeap->pImportArena,
-					ppszStr,
-					pui32StrLen);
-	}
+		if(psBMHeap->pImportArena)
+		{
+			RA_GetStats(psBMHeap->pImportArena,
+						ppszStr,
+						pui32StrLen);
+		}
 
-	if(psBMHeap->pVMArena)
-	{
-		RA_GetStats(psBMHeap->pVMArena,
-					ppszStr,
-					pui32StrLen);
+		if(psBMHeap->pVMArena)
+		{
+			RA_GetStats(psBMHeap->pVMArena,
+						ppszStr,
+						pui32StrLen);
+		}
 	}
 }
 
-PVRSRV_ERROR PVRSRVGetMiscInfoKM_BMContext_AnyVaCb(BM_CONTEXT *psBMContext, va_list va)
+static PVRSRV_ERROR PVRSRVGetMiscInfoKM_BMContext(BM_CONTEXT *psBMContext,
+												  IMG_UINT32 *pui32StrLen,
+												  IMG_INT32 *pi32Count,
+												  IMG_CHAR **ppszStr)
 {
-
-	IMG_UINT32 *pui32StrLen;
-	IMG_INT32 *pi32Count;
-	IMG_CHAR **ppszStr;
-
-	pui32StrLen = va_arg(va, IMG_UINT32*);
-	pi32Count = va_arg(va, IMG_INT32*);
-	ppszStr = va_arg(va, IMG_CHAR**);
-
 	CHECK_SPACE(*pui32StrLen);
 	*pi32Count = OSSNPrintf(*ppszStr, 100, "\nApplication Context (hDevMemContext) 0x%08X:\n",
 							(IMG_HANDLE)psBMContext);
 	UPDATE_SPACE(*ppszStr, *pi32Count, *pui32StrLen);
 
-	List_BM_HEAP_ForEach_va(psBMContext->psBMHeap,
-							PVRSRVGetMiscInfoKM_RA_GetStats_ForEachVaCb,
-							ppszStr,
-							pui32StrLen);
+	PVRSRVGetMiscInfoKM_RA_GetStats(psBMContext->psBMHeap, ppszStr, pui32StrLen);
+
 	return PVRSRV_OK;
 }
 
 
-PVRSRV_ERROR PVRSRVGetMiscInfoKM_Device_AnyVaCb(PVRSRV_DEVICE_NODE *psDeviceNode, va_list va)
+static PVRSRV_ERROR PVRSRVGetMiscInfoKM_Device(PVRSRV_DEVICE_NODE *psDeviceNode,
+											   IMG_UINT32 *pui32StrLen,
+											   IMG_INT32 *pi32Count,
+											   IMG_CHAR **ppszStr)
 {
-	IMG_UINT32 *pui32StrLen;
-	IMG_INT32 *pi32Count;
-	IMG_CHAR **ppszStr;
-
-	pui32StrLen = va_arg(va, IMG_UINT32*);
-	pi32Count = va_arg(va, IMG_INT32*);
-	ppszStr = va_arg(va, IMG_CHAR**);
+	BM_CONTEXT *psBMContext;
+	PVRSRV_ERROR eError = PVRSRV_OK;
 
 	CHECK_SPACE(*pui32StrLen);
 	*pi32Count = OSSNPrintf(*ppszStr, 100, "\n\nDevice Type %d:\n", psDeviceNode->sDevId.eDeviceType);
@@ -1024,18 +992,22 @@ PVRSRV_ERROR PVRSRVGetMiscInfoKM_Device_AnyVaCb(PVRSRV_DEVICE_NODE *psDeviceNode
 		UPDATE_SPACE(*ppszStr, *pi32Count, *pui32StrLen);
 
 
-		List_BM_HEAP_ForEach_va(psDeviceNode->sDevMemoryInfo.pBMKernelContext->psBMHeap,
-								PVRSRVGetMiscInfoKM_RA_GetStats_ForEachVaCb,
-								ppszStr,
-								pui32StrLen);
+		PVRSRVGetMiscInfoKM_RA_GetStats(psDeviceNode->sDevMemoryInfo.pBMKernelContext->psBMHeap,
+										ppszStr,
+										pui32StrLen);
 	}
 
 
-	return List_BM_CONTEXT_PVRSRV_ERROR_Any_va(psDeviceNode->sDevMemoryInfo.pBMContext,
-												PVRSRVGetMiscInfoKM_BMContext_AnyVaCb,
-							 					pui32StrLen,
-												pi32Count,
-												ppszStr);
+	LIST_FOR_EACH(psBMContext, psDeviceNode->sDevMemoryInfo.pBMContext)
+	{
+		eError = PVRSRVGetMiscInfoKM_BMContext(psBMContext, pui32StrLen, pi32Count, ppszStr);
+		if (eError != PVRSRV_OK)
+		{
+			break;
+		}
+	}
+
+	return eError;
 }
 
 
@@ -1056,6 +1028,7 @@ IMG_EXPORT
 PVRSRV_ERROR IMG_CALLCONV PVRSRVGetMiscInfoKM(PVRSRV_MISC_INFO *psMiscInfo)
 {
 	SYS_DATA *psSysData;
+	PVRSRV_DEVICE_NODE *psDeviceNode;
 
 	if(!psMiscInfo)
 	{
@@ -1134,11 +1107,13 @@ PVRSRV_ERROR IMG_CALLCONV PVRSRVGetMiscInfoKM(PVRSRV_MISC_INFO *psMiscInfo)
 
 
 		/*triple loop; devices:contexts:heaps*/
-		List_PVRSRV_DEVICE_NODE_PVRSRV_ERROR_Any_va(psSysData->psDeviceNodeList,
-													PVRSRVGetMiscInfoKM_Device_AnyVaCb,
-													&ui32StrLen,
-													&i32Count,
-													&pszStr);
+		LIST_FOR_EACH(psDeviceNode, psSysData->psDeviceNodeList)
+		{
+			if (PVRSRVGetMiscInfoKM_Device(psDeviceNode, &ui32StrLen, &i32Count, &pszStr) != PVRSRV_OK)
+			{
+				break;
+			}
+		}
 
 
 		i32Count = OSSNPrintf(pszStr, 100, "\n\0");
@@ -1206,6 +1181,11 @@ PVRSRV_ERROR IMG_CALLCONV PVRSRVGetMiscInfoKM(PVRSRV_MISC_INFO *psMiscInfo)
 				PVR_DPF((PVR_DBG_MESSAGE,"                     using deferred flush all instead"));
 			}
 
+			/*
+			 * Start the flush now and only wait for its fence at the next
+			 * kick, so neither this call nor the kick normally blocks.
+			 */
+			psSysData->ui32FlushAllFence = OSFlushCPUCacheAsyncKM();
 			psSysData->bFlushAll = IMG_TRUE;
 		}
 		else
@@ -1303,21 +1283,14 @@ out:
 	return bStatus;
 }
 
-IMG_VOID PVRSRVSystemLISR_ForEachVaCb(PVRSRV_DEVICE_NODE *psDeviceNode, va_list va)
+static INLINE IMG_VOID PVRSRVSystemLISR_Device(PVRSRV_DEVICE_NODE *psDeviceNode,
+											   IMG_BOOL *pbStatus,
+											   IMG_UINT32 ui32InterruptSource,
+											   IMG_UINT32 *pui32ClearInterrupts)
 {
-
-	IMG_BOOL *pbStatus;
-	IMG_UINT32 *pui32InterruptSource;
-	IMG_UINT32 *pui32ClearInterrupts;
-
-	pbStatus = va_arg(va, IMG_BOOL*);
-	pui32InterruptSource = va_arg(va, IMG_UINT32*);
-	pui32ClearInterrupts = va_arg(va, IMG_UINT32*);
-
-
 	if(psDeviceNode->pfnDeviceISR != IMG_NULL)
 	{
-		if(*pui32InterruptSource & psDeviceNode->ui32SOCInterruptBit)
+		if(ui32InterruptSource & psDeviceNode->ui32SOCInterruptBit)
 		{
 			if((*psDeviceNode->pfnDeviceISR)(psDeviceNode->pvISRData))
 			{
@@ -1349,7 +1322,7 @@ IMG_BOOL IMG_CALLCONV PVRSRVSystemLISR(IMG_VOID *pvSysData)
 	IMG_BOOL			bStatus = IMG_FALSE;
 	IMG_UINT32			ui32InterruptSource;
 	IMG_UINT32			ui32ClearInterrupts = 0;
-/*	PVRSRV_DEVICE_NODE	*psDeviceNode;*/
+	PVRSRV_DEVICE_NODE	*psDeviceNode;
 
 	if(!psSysData)
 	{
@@ -1365,11 +1338,13 @@ IMG_BOOL IMG_CALLCONV PVRSRVSystemLISR(IMG_VOID *pvSysData)
 		if(ui32InterruptSource)
 		{
 			/* traverse the devices' ISR handlers */
-			List_PVRSRV_DEVICE_NODE_ForEach_va(psSysData->psDeviceNodeList,
-												PVRSRVSystemLISR_ForEachVaCb,
-												&bStatus,
-												&ui32InterruptSource,
-												&ui32ClearInterrupts);
+			LIST_FOR_EACH(psDeviceNode, psSysData->psDeviceNodeList)
+			{
+				PVRSRVSystemLISR_Device(psDeviceNode,
+										&bStatus,
+										ui32InterruptSource,
+										&ui32ClearInterrupts);
+			}
 
 			SysClearInterrupts(psSysData, ui32ClearInterrupts);
 		}
@@ -1410,9 +1410,10 @@ RA_TestDelete (RA_ARENA *pArena)
 
 	if (pArena != IMG_NULL)
 	{
-		while (pArena->pHeadSegment != IMG_NULL)
+		BT *pBT;
+
+		for (pBT = pArena->pHeadSegment; pBT != IMG_NULL; pBT = pBT->pNextSegment)
 		{
-			BT *pBT = pArena->pHeadSegment;
 			if (pBT->type != btt_free)
 			{
 				PVR_DPF ((PVR_DBG_ERROR,"RA_TestDelete: detected resource leak!"));
@@ -72,6 +72,12 @@ static DEFINE_MUTEX(lock);
 
 #define RESMAN_SIGNATURE 0x12345678
 
+/*
+ * Resource types are small consecutive integers, so each one gets its own
+ * list in the context.  Unknown types share list 0.
+ */
+#define RESMAN_TYPE_LIST_COUNT		(RESMAN_TYPE_KERNEL_DEVICEMEM_ALLOCATION + 1)
+
 /******************************************************************************
  * resman structures
  *****************************************************************************/
@@ -85,6 +91,8 @@ typedef struct _RESMAN_ITEM_
 	struct _RESMAN_ITEM_	**ppsThis;	/*!< list navigation */
 	struct _RESMAN_ITEM_	*psNext;	/*!< list navigation */
 
+	struct _RESMAN_CONTEXT_	*psContext;	/*!< owning context */
+
 	IMG_UINT32				ui32Flags;	/*!< flags */
 	IMG_UINT32				ui32ResType;/*!< res type */
 
@@ -106,7 +114,7 @@ typedef struct _RESMAN_CONTEXT_
 
 	PVRSRV_PER_PROCESS_DATA		*psPerProc; /* owner of resources */
 
-	RESMAN_ITEM					*psResItemList;/*!< res item list for context */
+	RESMAN_ITEM					*apsResItemList[RESMAN_TYPE_LIST_COUNT];/*!< res item lists for context, by type */
 
 } RESMAN_CONTEXT;
 
@@ -123,8 +131,6 @@ PRESMAN_LIST	gpsResList = IMG_NULL;
 
 #include "lists.h"	/* PRQA S 5087 */ /* include lists.h required here */
 
-static IMPLEMENT_LIST_ANY_VA(RESMAN_ITEM)
-static IMPLEMENT_LIST_ANY_VA_2(RESMAN_ITEM, IMG_BOOL, IMG_FALSE)
 static IMPLEMENT_LIST_INSERT(RESMAN_ITEM)
 static IMPLEMENT_LIST_REMOVE(RESMAN_ITEM)
 
@@ -143,6 +149,56 @@ static PVRSRV_ERROR FreeResourceByCriteria(PRESMAN_CONTEXT	psContext,
 										   IMG_UINT32		ui32Param,
 										   IMG_BOOL			bExecuteCallback);
 
+static PVRSRV_ERROR FreeResourceList(PRESMAN_CONTEXT	psContext,
+									 IMG_UINT32			ui32ResType);
+
+
+/*
+ * Order in which a process's resources are freed when it disconnects:
+ * users of memory before the memory, and memory before its context.
+ */
+static const IMG_UINT32 aui32ResManTeardownOrder[] =
+{
+	/* OS specific User-mode Mappings: */
+	RESMAN_TYPE_OS_USERMODE_MAPPING,
+
+	/* Event Object */
+	RESMAN_TYPE_EVENT_OBJECT,
+
+	RESMAN_TYPE_MODIFY_SYNC_OPS,
+
+	/* Sync fences hold sync objects allocated from the device memory context */
+	RESMAN_TYPE_SYNC_FENCE,
+
+	/* SGX types: */
+	RESMAN_TYPE_HW_RENDER_CONTEXT,
+	RESMAN_TYPE_HW_TRANSFER_CONTEXT,
+	RESMAN_TYPE_HW_2D_CONTEXT,
+	RESMAN_TYPE_TRANSFER_CONTEXT,
+	RESMAN_TYPE_SHARED_PB_DESC_CREATE_LOCK,
+	RESMAN_TYPE_SHARED_PB_DESC,
+
+	RESMAN_TYPE_DISPLAYCLASS_SWAPCHAIN_REF,
+	RESMAN_TYPE_DISPLAYCLASS_DEVICE,
+
+	RESMAN_TYPE_BUFFERCLASS_DEVICE,
+
+	RESMAN_TYPE_DEVICECLASSMEM_MAPPING,
+	RESMAN_TYPE_DEVICEMEM_WRAP,
+	RESMAN_TYPE_DEVICEMEM_MAPPING,
+	RESMAN_TYPE_KERNEL_DEVICEMEM_ALLOCATION,
+	RESMAN_TYPE_DEVICEMEM_ALLOCATION,
+	RESMAN_TYPE_DEVICEMEM_CONTEXT
+};
+
+#ifdef INLINE_IS_PRAGMA
+#pragma inline(ResManItemList)
+#endif
+static INLINE RESMAN_ITEM **ResManItemList(PRESMAN_CONTEXT psResManContext,
+										   IMG_UINT32 ui32ResType)
+{
+	return &psResManContext->apsResItemList[(ui32ResType < RESMAN_TYPE_LIST_COUNT) ? ui32ResType : 0];
+}
 
 #ifdef DEBUG
 	static IMG_VOID ValidateResList(PRESMAN_LIST psResList);
@@ -255,7 +311,7 @@ PVRSRV_ERROR PVRSRVResManConnect(IMG_HANDLE			hPerProc,
 #ifdef DEBUG
 	psResManContext->ui32Signature = RESMAN_SIGNATURE;
 #endif /* DEBUG */
-	psResManContext->psResItemList	= IMG_NULL;
+	OSMemSet(psResManContext->apsResItemList, 0, sizeof(psResManContext->apsResItemList));
 	psResManContext->psPerProc = hPerProc;
 
 	/* Insert new context struct after the dummy first entry */
@@ -289,6 +345,8 @@ PVRSRV_ERROR PVRSRVResManConnect(IMG_HANDLE			hPerProc,
 IMG_VOID PVRSRVResManDisconnect(PRESMAN_CONTEXT psResManContext,
 								IMG_BOOL		bKernelContext)
 {
+	IMG_UINT32 i;
+
 	/* Acquire resource list sync object */
 	ACQUIRE_SYNC_OBJ;
 
@@ -298,64 +356,96 @@ IMG_VOID PVRSRVResManDisconnect(PRESMAN_CONTEXT psResManContext,
 	/* Print and validate resource list */
 	PRINT_RESLIST(gpsResList, psResManContext, IMG_TRUE);
 
-	/* Free all auto-freed resources in order */
+	/* Free all auto-freed resources in order, one list per type */
 
 	if (!bKernelContext)
 	{
-		/* OS specific User-mode Mappings: */
-		FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, RESMAN_TYPE_OS_USERMODE_MAPPING, 0, 0, IMG_TRUE);
-
-		/* Event Object */
-		FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, RESMAN_TYPE_EVENT_OBJECT, 0, 0, IMG_TRUE);
+		for (i = 0; i < sizeof(aui32ResManTeardownOrder) / sizeof(aui32ResManTeardownOrder[0]); i++)
+		{
+			FreeResourceList(psResManContext, aui32ResManTeardownOrder[i]);
+		}
+	}
 
+	/* Ensure that there are no resources left */
+	for (i = 0; i < RESMAN_TYPE_LIST_COUNT; i++)
+	{
+		PVR_ASSERT(psResManContext->apsResItemList[i] == IMG_NULL);
+	}
 
-		FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, RESMAN_TYPE_MODIFY_SYNC_OPS, 0, 0, IMG_TRUE);
+	/* Remove the context struct from the list */
+	List_RESMAN_CONTEXT_Remove(psResManContext);
 
-		/* SGX types: */
-		FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, RESMAN_TYPE_HW_RENDER_CONTEXT, 0, 0, IMG_TRUE);
-		FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, RESMAN_TYPE_HW_TRANSFER_CONTEXT, 0, 0, IMG_TRUE);
-		FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, RESMAN_TYPE_HW_2D_CONTEXT, 0, 0, IMG_TRUE);
-		FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, RESMAN_TYPE_TRANSFER_CONTEXT, 0, 0, IMG_TRUE);
-		FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, RESMAN_TYPE_SHARED_PB_DESC_CREATE_LOCK, 0, 0, IMG_TRUE);
-		FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, RESMAN_TYPE_SHARED_PB_DESC, 0, 0, IMG_TRUE);
+	/* Free the context struct */
+	OSFreeMem(PVRSRV_OS_PAGEABLE_HEAP, sizeof(RESMAN_CONTEXT), psResManContext, IMG_NULL);
+	/*not nulling pointer, copy on stack*/
 
 
+	/* Check resource list */
+	VALIDATERESLIST();
 
+	/* Print and validate resource list */
+	PRINT_RESLIST(gpsResList, psResManContext, IMG_FALSE);
 
-		FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, RESMAN_TYPE_DISPLAYCLASS_SWAPCHAIN_REF, 0, 0, IMG_TRUE);
-		FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, RESMAN_TYPE_DISPLAYCLASS_DEVICE, 0, 0, IMG_TRUE);
+	/* Release resource list sync object */
+	RELEASE_SYNC_OBJ;
+}
 
 
-		FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, RESMAN_TYPE_BUFFERCLASS_DEVICE, 0, 0, IMG_TRUE);
+/*!
+******************************************************************************
 
+ @Function	PVRSRVResManFreeChunk
 
-		FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, RESMAN_TYPE_DEVICECLASSMEM_MAPPING, 0, 0, IMG_TRUE);
-		FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, RESMAN_TYPE_DEVICEMEM_WRAP, 0, 0, IMG_TRUE);
-		FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, RESMAN_TYPE_DEVICEMEM_MAPPING, 0, 0, IMG_TRUE);
-		FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, RESMAN_TYPE_KERNEL_DEVICEMEM_ALLOCATION, 0, 0, IMG_TRUE);
-		FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, RESMAN_TYPE_DEVICEMEM_ALLOCATION, 0, 0, IMG_TRUE);
-		FreeResourceByCriteria(psResManContext, RESMAN_CRITERIA_RESTYPE, RESMAN_TYPE_DEVICEMEM_CONTEXT, 0, 0, IMG_TRUE);
-	}
+ @Description Frees at most ui32MaxItems of a context's resources, in the
+ 				same order as PVRSRVResManDisconnect.  Lets a caller tear
+ 				down a large process a piece at a time, dropping the bridge
+ 				lock in between.  The context itself is left for
+ 				PVRSRVResManDisconnect.
 
-	/* Ensure that there are no resources left */
-	PVR_ASSERT(psResManContext->psResItemList == IMG_NULL);
+ @input 	hResManContext - Resman context
+ @input 	ui32MaxItems - most resources to free in this call
 
-	/* Remove the context struct from the list */
-	List_RESMAN_CONTEXT_Remove(psResManContext);
+ @Return	IMG_TRUE once the context holds no more resources
 
-	/* Free the context struct */
-	OSFreeMem(PVRSRV_OS_PAGEABLE_HEAP, sizeof(RESMAN_CONTEXT), psResManContext, IMG_NULL);
-	/*not nulling pointer, copy on stack*/
+******************************************************************************/
+IMG_BOOL PVRSRVResManFreeChunk(PRESMAN_CONTEXT	psResManContext,
+							   IMG_UINT32		ui32MaxItems)
+{
+	IMG_UINT32	i;
+	RESMAN_ITEM	**ppsList;
+	IMG_BOOL	bEmpty = IMG_TRUE;
 
+	/* Acquire resource list sync object */
+	ACQUIRE_SYNC_OBJ;
 
 	/* Check resource list */
 	VALIDATERESLIST();
 
-	/* Print and validate resource list */
-	PRINT_RESLIST(gpsResList, psResManContext, IMG_FALSE);
+	for (i = 0; i < sizeof(aui32ResManTeardownOrder) / sizeof(aui32ResManTeardownOrder[0]); i++)
+	{
+		ppsList = ResManItemList(psResManContext, aui32ResManTeardownOrder[i]);
+
+		/* The item is unlinked and freed even if its callback fails */
+		while (*ppsList != IMG_NULL && ui32MaxItems != 0)
+		{
+			(IMG_VOID)FreeResourceByPtr(*ppsList, IMG_TRUE);
+			ui32MaxItems--;
+		}
+
+		if (*ppsList != IMG_NULL)
+		{
+			bEmpty = IMG_FALSE;
+			break;
+		}
+	}
+
+	/* Check resource list */
+	VALIDATERESLIST();
 
 	/* Release resource list sync object */
 	RELEASE_SYNC_OBJ;
+
+	return bEmpty;
 }
 
 
@@ -431,8 +521,9 @@ PRESMAN_ITEM ResManRegisterRes(PRESMAN_CONTEXT	psResManContext,
 	psNewResItem->pfnFreeResource	= pfnFreeResource;
 	psNewResItem->ui32Flags		    = 0;
 
-	/* Insert new structure after dummy first entry */
-	List_RESMAN_ITEM_Insert(&psResManContext->psResItemList, psNewResItem);
+	/* Insert new structure at the head of the list for its type */
+	List_RESMAN_ITEM_Insert(ResManItemList(psResManContext, ui32ResType), psNewResItem);
+	psNewResItem->psContext = psResManContext;
 
 	/* Check resource list */
 	VALIDATERESLIST();
@@ -562,7 +653,8 @@ PVRSRV_ERROR ResManDissociateRes(RESMAN_ITEM		*psResItem,
 		List_RESMAN_ITEM_Remove(psResItem);
 
 		/* Re-insert into new list */
-		List_RESMAN_ITEM_Insert(&psNewResManContext->psResItemList, psResItem);
+		List_RESMAN_ITEM_Insert(ResManItemList(psNewResManContext, psResItem->ui32ResType), psResItem);
+		psResItem->psContext = psNewResManContext;
 
 	}
 	else
@@ -578,29 +670,6 @@ PVRSRV_ERROR ResManDissociateRes(RESMAN_ITEM		*psResItem,
 	return eError;
 }
 
-/*!
-******************************************************************************
- @Function	 	ResManFindResourceByPtr_AnyVaCb
-
- @Description
- 					Compares the resman item with a given pointer.
-
- @inputs	 	psCurItem - theThe item to check
- @inputs        va - Variable argument list with:
-					 psItem - pointer to resource item to find
-
- @Return   		IMG_BOOL
-**************************************************************************/
-IMG_BOOL ResManFindResourceByPtr_AnyVaCb(RESMAN_ITEM *psCurItem, va_list va)
-{
-	RESMAN_ITEM		*psItem;
-
-	psItem = va_arg(va, RESMAN_ITEM*);
-
-	return (IMG_BOOL)(psCurItem == psItem);
-}
-
-
 /*!
 ******************************************************************************
  @Function	 	ResManFindResourceByPtr
@@ -616,9 +685,8 @@ IMG_BOOL ResManFindResourceByPtr_AnyVaCb(RESMAN_ITEM *psCurItem, va_list va)
 IMG_INTERNAL PVRSRV_ERROR ResManFindResourceByPtr(PRESMAN_CONTEXT	psResManContext,
 												  RESMAN_ITEM		*psItem)
 {
-/*	RESMAN_ITEM		*psCurItem;*/
-
-	PVRSRV_ERROR	eResult;
+	RESMAN_ITEM		*psCurItem;
+	PVRSRV_ERROR	eResult = PVRSRV_ERROR_NOT_OWNER;
 
 	PVR_ASSERT(psResManContext != IMG_NULL);
 	PVR_ASSERT(psItem != IMG_NULL);
@@ -649,15 +717,14 @@ IMG_INTERNAL PVRSRV_ERROR ResManFindResourceByPtr(PRESMAN_CONTEXT	psResManContex
 			psItem->pfnFreeResource, psItem->ui32Flags));
 
 
-	if(List_RESMAN_ITEM_IMG_BOOL_Any_va(psResManContext->psResItemList,
-										ResManFindResourceByPtr_AnyVaCb,
-										psItem))
-	{
-		eResult = PVRSRV_OK;
-	}
-	else
+	/* Only the list for the item's type can contain it */
+	LIST_FOR_EACH(psCurItem, *ResManItemList(psResManContext, psItem->ui32ResType))
 	{
-		eResult = PVRSRV_ERROR_NOT_OWNER;
+		if (psCurItem == psItem)
+		{
+			eResult = PVRSRV_OK;
+			break;
+		}
 	}
 
 	/* Release resource list sync object */
@@ -739,39 +806,52 @@ static PVRSRV_ERROR FreeResourceByPtr(RESMAN_ITEM	*psItem,
 	return(eError);
 }
 
-IMG_VOID* FreeResourceByCriteria_AnyVaCb(RESMAN_ITEM *psCurItem, va_list va)
+/*!
+******************************************************************************
+ @Function	 	FindResourceByCriteria
+
+ @Description
+ 					Returns the first item in a resource list that matches
+					the given criteria.
+
+ @inputs        psItemList - head of the resource list to search
+ @inputs        ui32SearchCriteria - indicates which parameters should be used
+ @inputs        ui32ResType - resource type to match
+ @inputs        pvParam - address to match
+ @inputs        ui32Param - size to match
+
+ @Return   		RESMAN_ITEM * - matching item, or IMG_NULL
+**************************************************************************/
+static INLINE RESMAN_ITEM *FindResourceByCriteria(RESMAN_ITEM	*psItemList,
+												  IMG_UINT32	ui32SearchCriteria,
+												  IMG_UINT32	ui32ResType,
+												  IMG_PVOID		pvParam,
+												  IMG_UINT32	ui32Param)
 {
-	IMG_UINT32 ui32SearchCriteria;
-	IMG_UINT32 ui32ResType;
-	IMG_PVOID pvParam;
-	IMG_UINT32 ui32Param;
-
-	ui32SearchCriteria = va_arg(va, IMG_UINT32);
-	ui32ResType = va_arg(va, IMG_UINT32);
-	pvParam = va_arg(va, IMG_PVOID);
-	ui32Param = va_arg(va, IMG_UINT32);
-
-	/*check that for all conditions are either disabled or eval to true*/
-	if(
-	/* Check resource type */
-		(((ui32SearchCriteria & RESMAN_CRITERIA_RESTYPE) == 0UL) ||
-		(psCurItem->ui32ResType == ui32ResType))
-	&&
-	/* Check address */
-		(((ui32SearchCriteria & RESMAN_CRITERIA_PVOID_PARAM) == 0UL) ||
-			 (psCurItem->pvParam == pvParam))
-	&&
-	/* Check size */
-		(((ui32SearchCriteria & RESMAN_CRITERIA_UI32_PARAM) == 0UL) ||
-			 (psCurItem->ui32Param == ui32Param))
-		)
-	{
-		return psCurItem;
-	}
-	else
+	RESMAN_ITEM *psCurItem;
+
+	LIST_FOR_EACH(psCurItem, psItemList)
 	{
-		return IMG_NULL;
+		/*check that for all conditions are either disabled or eval to true*/
+		if(
+		/* Check resource type */
+			(((ui32SearchCriteria & RESMAN_CRITERIA_RESTYPE) == 0UL) ||
+			(psCurItem->ui32ResType == ui32ResType))
+		&&
+		/* Check address */
+			(((ui32SearchCriteria & RESMAN_CRITERIA_PVOID_PARAM) == 0UL) ||
+				 (psCurItem->pvParam == pvParam))
+		&&
+		/* Check size */
+			(((ui32SearchCriteria & RESMAN_CRITERIA_UI32_PARAM) == 0UL) ||
+				 (psCurItem->ui32Param == ui32Param))
+			)
+		{
+			break;
+		}
 	}
+
+	return psCurItem;
 }
 
 /*!
@@ -804,19 +884,65 @@ static PVRSRV_ERROR FreeResourceByCriteria(PRESMAN_CONTEXT	psResManContext,
 {
 	PRESMAN_ITEM	psCurItem;
 	PVRSRV_ERROR	eError = PVRSRV_OK;
+	IMG_UINT32		ui32List, ui32FirstList, ui32LastList;
+
+	/* A type match can only be found in the list for that type */
+	if ((ui32SearchCriteria & RESMAN_CRITERIA_RESTYPE) != 0UL)
+	{
+		ui32FirstList = (IMG_UINT32)(ResManItemList(psResManContext, ui32ResType) - psResManContext->apsResItemList);
+		ui32LastList = ui32FirstList;
+	}
+	else
+	{
+		ui32FirstList = 0;
+		ui32LastList = RESMAN_TYPE_LIST_COUNT - 1;
+	}
+
+	for (ui32List = ui32FirstList; ui32List <= ui32LastList && eError == PVRSRV_OK; ui32List++)
+	{
+		/* Search resource items starting at the head of the list */
+		/*while we get a match and not an error*/
+		while((psCurItem = FindResourceByCriteria(psResManContext->apsResItemList[ui32List],
+												  ui32SearchCriteria,
+												  ui32ResType,
+												  pvParam,
+												  ui32Param)) != IMG_NULL
+			  	&& eError == PVRSRV_OK)
+		{
+			eError = FreeResourceByPtr(psCurItem, bExecuteCallback);
+		}
+	}
+
+	return eError;
+}
+
+
+/*!
+******************************************************************************
+ @Function	 	FreeResourceList
+
+ @Description
+ 					Frees every resource of one type for the context, as
+					done on process exit.  Each item is taken from the head
+					of the list, so the cost is linear in the number of
+					resources.
+					NOTE : this function must be called with the resource
+					list sync object held
+
+ @inputs        psResManContext - pointer to resman context
+ @inputs        ui32ResType - type of resource to free
+
+ @Return   		PVRSRV_ERROR
+**************************************************************************/
+static PVRSRV_ERROR FreeResourceList(PRESMAN_CONTEXT	psResManContext,
+									 IMG_UINT32			ui32ResType)
+{
+	RESMAN_ITEM		**ppsList = ResManItemList(psResManContext, ui32ResType);
+	PVRSRV_ERROR	eError = PVRSRV_OK;
 
-	/* Search resource items starting at after the first dummy item */
-	/*while we get a match and not an error*/
-	while((psCurItem = (PRESMAN_ITEM)
-				List_RESMAN_ITEM_Any_va(psResManContext->psResItemList,
-										FreeResourceByCriteria_AnyVaCb,
-										ui32SearchCriteria,
-										ui32ResType,
-						 				pvParam,
-						 				ui32Param)) != IMG_NULL
-		  	&& eError == PVRSRV_OK)
+	while (*ppsList != IMG_NULL && eError == PVRSRV_OK)
 	{
-		eError = FreeResourceByPtr(psCurItem, bExecuteCallback);
+		eError = FreeResourceByPtr(*ppsList, IMG_TRUE);
 	}
 
 	return eError;
@@ -839,6 +965,7 @@ static IMG_VOID ValidateResList(PRESMAN_LIST psResList)
 {
 	PRESMAN_ITEM	psCurItem, *ppsThisItem;
 	PRESMAN_CONTEXT	psCurContext, *ppsThisContext;
+	IMG_UINT32		ui32List;
 
 	/* check we're initialised */
 	if (psResList == IMG_NULL)
@@ -864,24 +991,28 @@ static IMG_VOID ValidateResList(PRESMAN_LIST psResList)
 			PVR_ASSERT(psCurContext->ppsThis == ppsThisContext);
 		}
 
-		/* Walk the list for this context */
-		psCurItem = psCurContext->psResItemList;
-		ppsThisItem = &psCurContext->psResItemList;
-		while(psCurItem != IMG_NULL)
+		/* Walk the lists for this context */
+		for (ui32List = 0; ui32List < RESMAN_TYPE_LIST_COUNT; ui32List++)
 		{
-			/* Check current item */
-			PVR_ASSERT(psCurItem->ui32Signature == RESMAN_SIGNATURE);
-			if (psCurItem->ppsThis != ppsThisItem)
+			psCurItem = psCurContext->apsResItemList[ui32List];
+			ppsThisItem = &psCurContext->apsResItemList[ui32List];
+			while(psCurItem != IMG_NULL)
 			{
-				PVR_DPF((PVR_DBG_WARNING,
-						"psCurItem=%08X psCurItem->ppsThis=%08X psCurItem->psNext=%08X ppsThisItem=%08X",
-						psCurItem, psCurItem->ppsThis, psCurItem->psNext, ppsThisItem));
-				PVR_ASSERT(psCurItem->ppsThis == ppsThisItem);
+				/* Check current item */
+				PVR_ASSERT(psCurItem->ui32Signature == RESMAN_SIGNATURE);
+				PVR_ASSERT(psCurItem->psContext == psCurContext);
+				if (psCurItem->ppsThis != ppsThisItem)
+				{
+					PVR_DPF((PVR_DBG_WARNING,
+							"psCurItem=%08X psCurItem->ppsThis=%08X psCurItem->psNext=%08X ppsThisItem=%08X",
+							psCurItem, psCurItem->ppsThis, psCurItem->psNext, ppsThisItem));
+					PVR_ASSERT(psCurItem->ppsThis == ppsThisItem);
+				}
+
+				/* Move to next item */
+				ppsThisItem = &psCurItem->psNext;
+				psCurItem = psCurItem->psNext;
 			}
-
-			/* Move to next item */
-			ppsThisItem = &psCurItem->psNext;
-			psCurItem = psCurItem->psNext;
 		}
 
 		/* Move to next context */
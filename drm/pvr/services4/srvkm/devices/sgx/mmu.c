@@ -2136,9 +2136,12 @@ MMU_MapScatter (MMU_HEAP *pMMUHeap,
 #endif /*PDUMP*/
 	IMG_UINT32 uCount, i;
 	IMG_DEV_PHYADDR DevPAddr;
+	IMG_UINT64 ui64MapStart;
 
 	PVR_ASSERT (pMMUHeap != IMG_NULL);
 
+	PVRSRV_TIME_START(ui64MapStart);
+
 #if defined(PDUMP)
 	MapBaseDevVAddr = DevVAddr;
 #else
@@ -2168,6 +2171,8 @@ MMU_MapScatter (MMU_HEAP *pMMUHeap,
 #if defined(PDUMP)
 	MMU_PDumpPageTables (pMMUHeap, MapBaseDevVAddr, uSize, IMG_FALSE, hUniqueTag);
 #endif /* #if defined(PDUMP) */
+
+	PVRSRV_TIME_STOP(PVRSRV_TIMER_MMU_MAP, ui64MapStart);
 }
 
 /*!
@@ -2201,9 +2206,12 @@ MMU_MapPages (MMU_HEAP *pMMUHeap,
 	IMG_UINT32 uCount;
 	IMG_UINT32 ui32VAdvance;
 	IMG_UINT32 ui32PAdvance;
+	IMG_UINT64 ui64MapStart;
 
 	PVR_ASSERT (pMMUHeap != IMG_NULL);
 
+	PVRSRV_TIME_START(ui64MapStart);
+
 	PVR_DPF ((PVR_DBG_MESSAGE,
 		  "MMU_MapPages: mmu=%08X, devVAddr=%08X, SysPAddr=%08X, size=0x%x",
 		  pMMUHeap, DevVAddr.uiAddr, SysPAddr.uiAddr, uSize));
@@ -2248,6 +2256,8 @@ MMU_MapPages (MMU_HEAP *pMMUHeap,
 #if defined(PDUMP)
 	MMU_PDumpPageTables (pMMUHeap, MapBaseDevVAddr, uSize, IMG_FALSE, hUniqueTag);
 #endif
+
+	PVRSRV_TIME_STOP(PVRSRV_TIMER_MMU_MAP, ui64MapStart);
 }
 
 IMG_VOID
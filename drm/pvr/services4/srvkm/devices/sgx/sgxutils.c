@@ -336,7 +336,21 @@ PVRSRV_ERROR SGXScheduleCCBCommand(PVRSRV_SGXDEV_INFO 	*psDevInfo,
 
 		if (psSysData->bFlushAll)
 		{
-			OSFlushCPUCacheKM();
+			/*
+				ISR_ID callers include the MISR, which must not sleep: flush
+				synchronously unless the async flush has already finished.
+			*/
+			if (ui32CallerID == ISR_ID)
+			{
+				if (!OSCPUCacheFlushCompleteKM(psSysData->ui32FlushAllFence))
+				{
+					OSFlushCPUCacheKM();
+				}
+			}
+			else
+			{
+				OSWaitCPUCacheFlushKM(psSysData->ui32FlushAllFence);
+			}
 
 			psSysData->bFlushAll = IMG_FALSE;
 		}
@@ -63,6 +63,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <linux/timer.h>
 #include <linux/capability.h>
 #include <linux/sched.h>
+#include <linux/fs.h>
+#include <linux/poll.h>
+#include <linux/anon_inodes.h>
 #include <asm/uaccess.h>
 
 #include "img_types.h"
@@ -73,12 +76,17 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "env_data.h"
 #include "proc.h"
 #include "mutex.h"
+#include "event.h"
 #include "lock.h"
+#include "pvr_bridge_km.h"
 
 typedef struct PVRSRV_LINUX_EVENT_OBJECT_LIST_TAG
 {
    rwlock_t		sLock;
    struct list_head	sList;
+   struct list_head	sFenceList;
+   spinlock_t		sWaiterLock;
+   struct list_head	sWaiterList;
    
 } PVRSRV_LINUX_EVENT_OBJECT_LIST;
 
@@ -94,8 +102,41 @@ typedef struct PVRSRV_LINUX_EVENT_OBJECT_TAG
 	struct list_head        sList;
 	IMG_HANDLE		hResItem;
 	PVRSRV_LINUX_EVENT_OBJECT_LIST *psLinuxEventObjectList;
+	/*
+	 * Sync object the only sleeper depends on, if any.  While it is set,
+	 * signals that leave the sync object incomplete don't wake the
+	 * sleeper.  Protected by the list lock.
+	 */
+	IMG_UINT32		ui32Waiters;
+	PVRSRV_KERNEL_SYNC_INFO	*psWaitSyncInfo;
+	IMG_UINT32		ui32WaitReadOpsTarget;
+	IMG_UINT32		ui32WaitWriteOpsTarget;
 } PVRSRV_LINUX_EVENT_OBJECT;
 
+/*
+ * A sync fence is a file descriptor tied to one sync object.  It becomes
+ * readable once the read and write operations that were pending on the
+ * sync object when the fence was created have completed, so userspace can
+ * poll()/epoll() for it alongside its other descriptors.  Only the fences
+ * whose sync object has completed are woken when the event list is
+ * signalled.
+ *
+ * The sync object belongs to the creating process's device memory context,
+ * but the descriptor can outlive that process.  The fence is therefore
+ * registered with the creator's resman context, which detaches it from the
+ * sync object on teardown; a detached fence polls as an error.
+ */
+typedef struct PVRSRV_LINUX_SYNC_FENCE_TAG
+{
+	PVRSRV_KERNEL_SYNC_INFO	*psSyncInfo;
+	IMG_HANDLE		hResItem;
+	IMG_UINT32		ui32ReadOpsTarget;
+	IMG_UINT32		ui32WriteOpsTarget;
+	wait_queue_head_t	sWait;
+	struct list_head	sList;
+	PVRSRV_LINUX_EVENT_OBJECT_LIST *psLinuxEventObjectList;
+} PVRSRV_LINUX_SYNC_FENCE;
+
 /*!
 ******************************************************************************
 
@@ -123,6 +164,9 @@ PVRSRV_ERROR LinuxEventObjectListCreate(IMG_HANDLE *phEventObjectList)
 	}
 
     INIT_LIST_HEAD(&psEvenObjectList->sList);
+    INIT_LIST_HEAD(&psEvenObjectList->sFenceList);
+    INIT_LIST_HEAD(&psEvenObjectList->sWaiterList);
+	spin_lock_init(&psEvenObjectList->sWaiterLock);
 
 	rwlock_init(&psEvenObjectList->sLock);
 
@@ -152,7 +196,8 @@ PVRSRV_ERROR LinuxEventObjectListDestroy(IMG_HANDLE hEventObjectList)
 
 	if(psEvenObjectList)
 	{
-		if (!list_empty(&psEvenObjectList->sList))
+		if (!list_empty(&psEvenObjectList->sList) ||
+			!list_empty(&psEvenObjectList->sFenceList))
 		{
 			 PVR_DPF((PVR_DBG_ERROR, "LinuxEventObjectListDestroy: Event List is not empty"));
 			 return PVRSRV_ERROR_GENERIC;
@@ -285,6 +330,8 @@ PVRSRV_ERROR LinuxEventObjectAdd(IMG_HANDLE hOSEventObjectList, IMG_HANDLE *phOS
     init_waitqueue_head(&psLinuxEventObject->sWait);
 
 	psLinuxEventObject->psLinuxEventObjectList = psLinuxEventObjectList;
+	psLinuxEventObject->ui32Waiters = 0;
+	psLinuxEventObject->psWaitSyncInfo = IMG_NULL;
 
 	psLinuxEventObject->hResItem = ResManRegisterRes(psPerProc->hResManContext,
 													 RESMAN_TYPE_EVENT_OBJECT,
@@ -301,6 +348,337 @@ PVRSRV_ERROR LinuxEventObjectAdd(IMG_HANDLE hOSEventObjectList, IMG_HANDLE *phOS
 	return PVRSRV_OK;
 }
 
+/*!
+******************************************************************************
+
+ @Function	SyncOpsComplete
+
+ @Description
+
+ Whether the read and write operations up to the given targets have
+ completed on a sync object.  The counters wrap, so the comparison is done
+ on the signed difference.
+
+ @Input    psSyncInfo : Sync object
+ @Input    ui32ReadOpsTarget : Read operations to wait for
+ @Input    ui32WriteOpsTarget : Write operations to wait for
+
+ @Return   IMG_BOOL  :  IMG_TRUE if the operations have completed
+
+******************************************************************************/
+static INLINE IMG_BOOL SyncOpsComplete(PVRSRV_KERNEL_SYNC_INFO *psSyncInfo,
+									   IMG_UINT32 ui32ReadOpsTarget,
+									   IMG_UINT32 ui32WriteOpsTarget)
+{
+	PVRSRV_SYNC_DATA *psSyncData = psSyncInfo->psSyncData;
+
+	return (IMG_BOOL)((IMG_INT32)(psSyncData->ui32ReadOpsComplete - ui32ReadOpsTarget) >= 0 &&
+					  (IMG_INT32)(psSyncData->ui32WriteOpsComplete - ui32WriteOpsTarget) >= 0);
+}
+
+/*!
+******************************************************************************
+
+ @Function	SyncInfoRelease
+
+ @Description
+
+ Drop a reference on a sync object, freeing it with the last one.
+ Must be called with the services lock held.
+
+ @Input    psSyncInfo : Sync object
+
+******************************************************************************/
+static IMG_VOID SyncInfoRelease(PVRSRV_KERNEL_SYNC_INFO *psSyncInfo)
+{
+	psSyncInfo->ui32RefCount--;
+	if (psSyncInfo->ui32RefCount == 0)
+	{
+		if (PVRSRVFreeSyncInfoKM(psSyncInfo) != PVRSRV_OK)
+		{
+			PVR_DPF((PVR_DBG_ERROR, "SyncInfoRelease: Failed to free sync info"));
+		}
+	}
+}
+
+static INLINE IMG_BOOL SyncFenceSignalled(PVRSRV_LINUX_SYNC_FENCE *psFence)
+{
+	return SyncOpsComplete(psFence->psSyncInfo,
+						   psFence->ui32ReadOpsTarget,
+						   psFence->ui32WriteOpsTarget);
+}
+
+static unsigned int SyncFencePoll(struct file *psFile, poll_table *psPollTable)
+{
+	PVRSRV_LINUX_SYNC_FENCE *psFence = psFile->private_data;
+	PVRSRV_LINUX_EVENT_OBJECT_LIST *psLinuxEventObjectList = psFence->psLinuxEventObjectList;
+	unsigned int uiMask = 0;
+
+	poll_wait(psFile, &psFence->sWait, psPollTable);
+
+	/* The list lock keeps a detach from freeing the sync object under us */
+	read_lock_bh(&psLinuxEventObjectList->sLock);
+	if (psFence->psSyncInfo == IMG_NULL)
+	{
+		uiMask = POLLERR;
+	}
+	else if (SyncFenceSignalled(psFence))
+	{
+		uiMask = POLLIN | POLLRDNORM;
+	}
+	read_unlock_bh(&psLinuxEventObjectList->sLock);
+
+	return uiMask;
+}
+
+/*!
+******************************************************************************
+
+ @Function	SyncFenceDetachCallback
+
+ @Description
+
+ Resman callback detaching a sync fence from its sync object, either
+ because the descriptor was closed or because the process that created
+ the fence is being torn down.  The fence itself is freed on release.
+
+ @Input    pvParam : Sync fence
+
+ @Return   PVRSRV_ERROR  :  Error code
+
+******************************************************************************/
+static PVRSRV_ERROR SyncFenceDetachCallback(IMG_PVOID pvParam, IMG_UINT32 ui32Param)
+{
+	PVRSRV_LINUX_SYNC_FENCE *psFence = pvParam;
+	PVRSRV_LINUX_EVENT_OBJECT_LIST *psLinuxEventObjectList = psFence->psLinuxEventObjectList;
+	PVRSRV_KERNEL_SYNC_INFO *psSyncInfo = psFence->psSyncInfo;
+
+	PVR_UNREFERENCED_PARAMETER(ui32Param);
+
+	write_lock_bh(&psLinuxEventObjectList->sLock);
+	list_del_init(&psFence->sList);
+	psFence->psSyncInfo = IMG_NULL;
+	psFence->hResItem = IMG_NULL;
+	write_unlock_bh(&psLinuxEventObjectList->sLock);
+
+	wake_up_interruptible(&psFence->sWait);
+
+	SyncInfoRelease(psSyncInfo);
+
+	return PVRSRV_OK;
+}
+
+static int SyncFenceRelease(struct inode *psInode, struct file *psFile)
+{
+	PVRSRV_LINUX_SYNC_FENCE *psFence = psFile->private_data;
+
+	PVR_UNREFERENCED_PARAMETER(psInode);
+
+	/* Resman items are protected by the services lock */
+	mutex_lock(&gPVRSRVLock);
+	if (psFence->hResItem != IMG_NULL)
+	{
+		if (ResManFreeResByPtr(psFence->hResItem) != PVRSRV_OK)
+		{
+			PVR_DPF((PVR_DBG_ERROR, "SyncFenceRelease: Failed to detach fence"));
+		}
+	}
+	mutex_unlock(&gPVRSRVLock);
+
+	OSFreeMem(PVRSRV_OS_NON_PAGEABLE_HEAP, sizeof(PVRSRV_LINUX_SYNC_FENCE), psFence, IMG_NULL);
+
+	return 0;
+}
+
+static struct file_operations sSyncFenceFops =
+{
+	.owner = THIS_MODULE,
+	.poll = SyncFencePoll,
+	.release = SyncFenceRelease,
+};
+
+/*!
+******************************************************************************
+
+ @Function	LinuxSyncFenceCreate
+
+ @Description
+
+ Create a pollable file descriptor that signals once the operations
+ currently pending on a sync object have completed.  The fence holds a
+ reference on the sync object until the descriptor is closed or the
+ resman context is torn down, whichever comes first.
+ Must be called with the services lock held.
+
+ @Input    hOSEventObjectList : Event object list signalled on completion
+ @Input    hResManContext : Resman context of the process owning psSyncInfo
+ @Input    psSyncInfo : Sync object to wait on
+ @Output   piFd : The new file descriptor
+
+ @Return   PVRSRV_ERROR  :  Error code
+
+******************************************************************************/
+PVRSRV_ERROR LinuxSyncFenceCreate(IMG_HANDLE hOSEventObjectList,
+								  IMG_HANDLE hResManContext,
+								  PVRSRV_KERNEL_SYNC_INFO *psSyncInfo,
+								  IMG_INT *piFd)
+{
+	PVRSRV_LINUX_EVENT_OBJECT_LIST *psLinuxEventObjectList = (PVRSRV_LINUX_EVENT_OBJECT_LIST*)hOSEventObjectList;
+	PVRSRV_LINUX_SYNC_FENCE *psFence;
+	IMG_INT iFd;
+
+	if(OSAllocMem(PVRSRV_OS_NON_PAGEABLE_HEAP, sizeof(PVRSRV_LINUX_SYNC_FENCE),
+		(IMG_VOID **)&psFence, IMG_NULL,
+		"Linux Sync Fence") != PVRSRV_OK)
+	{
+		PVR_DPF((PVR_DBG_ERROR, "LinuxSyncFenceCreate: failed to allocate memory"));
+		return PVRSRV_ERROR_OUT_OF_MEMORY;
+	}
+
+	psFence->psSyncInfo = psSyncInfo;
+	psFence->ui32ReadOpsTarget = psSyncInfo->psSyncData->ui32ReadOpsPending;
+	psFence->ui32WriteOpsTarget = psSyncInfo->psSyncData->ui32WriteOpsPending;
+	psFence->psLinuxEventObjectList = psLinuxEventObjectList;
+	init_waitqueue_head(&psFence->sWait);
+
+	psFence->hResItem = ResManRegisterRes(hResManContext,
+										  RESMAN_TYPE_SYNC_FENCE,
+										  psFence,
+										  0,
+										  &SyncFenceDetachCallback);
+	if (psFence->hResItem == IMG_NULL)
+	{
+		PVR_DPF((PVR_DBG_ERROR, "LinuxSyncFenceCreate: failed to register fence"));
+		OSFreeMem(PVRSRV_OS_NON_PAGEABLE_HEAP, sizeof(PVRSRV_LINUX_SYNC_FENCE), psFence, IMG_NULL);
+		return PVRSRV_ERROR_OUT_OF_MEMORY;
+	}
+
+	psSyncInfo->ui32RefCount++;
+
+	write_lock_bh(&psLinuxEventObjectList->sLock);
+	list_add(&psFence->sList, &psLinuxEventObjectList->sFenceList);
+	write_unlock_bh(&psLinuxEventObjectList->sLock);
+
+	iFd = anon_inode_getfd("pvr_sync_fence", &sSyncFenceFops, psFence, O_RDONLY | O_CLOEXEC);
+	if (iFd < 0)
+	{
+		PVR_DPF((PVR_DBG_ERROR, "LinuxSyncFenceCreate: failed to create fd (%d)", iFd));
+
+		ResManFreeResByPtr(psFence->hResItem);
+		OSFreeMem(PVRSRV_OS_NON_PAGEABLE_HEAP, sizeof(PVRSRV_LINUX_SYNC_FENCE), psFence, IMG_NULL);
+		return PVRSRV_ERROR_OUT_OF_MEMORY;
+	}
+
+	*piFd = iFd;
+
+	return PVRSRV_OK;
+}
+
+/*!
+******************************************************************************
+
+ @Function	SyncWaiterSignalled
+
+ @Description
+
+ Whether the write operations a sync waiter waits for have completed.
+
+ @Input    psWaiter : Sync waiter
+
+ @Return   IMG_BOOL  :  IMG_TRUE if the waiter is signalled
+
+******************************************************************************/
+static INLINE IMG_BOOL SyncWaiterSignalled(PVRSRV_LINUX_SYNC_WAITER *psWaiter)
+{
+	PVRSRV_SYNC_DATA *psSyncData = psWaiter->psSyncInfo->psSyncData;
+
+	return (IMG_BOOL)((IMG_INT32)(psSyncData->ui32WriteOpsComplete - psWaiter->ui32WriteOpsTarget) >= 0);
+}
+
+/*!
+******************************************************************************
+
+ @Function	LinuxSyncWaiterInit
+
+ @Description
+
+ Prepare a sync waiter for its first LinuxSyncWaiterAdd.  The caller
+ fills in the other fields itself.
+
+ @Input    psWaiter : Sync waiter
+
+******************************************************************************/
+IMG_VOID LinuxSyncWaiterInit(PVRSRV_LINUX_SYNC_WAITER *psWaiter)
+{
+	INIT_LIST_HEAD(&psWaiter->sList);
+}
+
+/*!
+******************************************************************************
+
+ @Function	LinuxSyncWaiterAdd
+
+ @Description
+
+ Arm a sync waiter on an event list.  The completion check is repeated
+ after the waiter is queued, so a signal racing with the caller's own
+ check is not lost.  A waiter that is already armed is left as it is.
+
+ @Input    hOSEventObjectList : Event object list signalled on completion
+ @Input    psWaiter : Sync waiter
+
+ @Return   IMG_BOOL  :  IMG_TRUE if armed, IMG_FALSE if the operations have
+                        already completed and the callback won't be called
+
+******************************************************************************/
+IMG_BOOL LinuxSyncWaiterAdd(IMG_HANDLE hOSEventObjectList, PVRSRV_LINUX_SYNC_WAITER *psWaiter)
+{
+	PVRSRV_LINUX_EVENT_OBJECT_LIST *psLinuxEventObjectList = (PVRSRV_LINUX_EVENT_OBJECT_LIST*)hOSEventObjectList;
+	unsigned long ulFlags;
+	IMG_BOOL bArmed = IMG_TRUE;
+
+	spin_lock_irqsave(&psLinuxEventObjectList->sWaiterLock, ulFlags);
+	if (list_empty(&psWaiter->sList))
+	{
+		list_add_tail(&psWaiter->sList, &psLinuxEventObjectList->sWaiterList);
+
+		/* Pairs with the sync data update that precedes the signal */
+		smp_mb();
+		if (SyncWaiterSignalled(psWaiter))
+		{
+			list_del_init(&psWaiter->sList);
+			bArmed = IMG_FALSE;
+		}
+	}
+	spin_unlock_irqrestore(&psLinuxEventObjectList->sWaiterLock, ulFlags);
+
+	return bArmed;
+}
+
+/*!
+******************************************************************************
+
+ @Function	LinuxSyncWaiterRemove
+
+ @Description
+
+ Disarm a sync waiter.  Once this returns the callback is not running
+ and won't be called.
+
+ @Input    hOSEventObjectList : Event object list the waiter was added to
+ @Input    psWaiter : Sync waiter
+
+******************************************************************************/
+IMG_VOID LinuxSyncWaiterRemove(IMG_HANDLE hOSEventObjectList, PVRSRV_LINUX_SYNC_WAITER *psWaiter)
+{
+	PVRSRV_LINUX_EVENT_OBJECT_LIST *psLinuxEventObjectList = (PVRSRV_LINUX_EVENT_OBJECT_LIST*)hOSEventObjectList;
+	unsigned long ulFlags;
+
+	spin_lock_irqsave(&psLinuxEventObjectList->sWaiterLock, ulFlags);
+	list_del_init(&psWaiter->sList);
+	spin_unlock_irqrestore(&psLinuxEventObjectList->sWaiterLock, ulFlags);
+}
+
 /*!
 ******************************************************************************
 
@@ -318,8 +696,11 @@ PVRSRV_ERROR LinuxEventObjectAdd(IMG_HANDLE hOSEventObjectList, IMG_HANDLE *phOS
 PVRSRV_ERROR LinuxEventObjectSignal(IMG_HANDLE hOSEventObjectList)
 {
 	PVRSRV_LINUX_EVENT_OBJECT *psLinuxEventObject;
+	PVRSRV_LINUX_SYNC_FENCE *psFence;
+	PVRSRV_LINUX_SYNC_WAITER *psWaiter, *psWaiterTemp;
 	PVRSRV_LINUX_EVENT_OBJECT_LIST *psLinuxEventObjectList = (PVRSRV_LINUX_EVENT_OBJECT_LIST*)hOSEventObjectList;
 	struct list_head *psListEntry, *psListEntryTemp, *psList;
+	unsigned long ulFlags;
 	psList = &psLinuxEventObjectList->sList;
 
 	/*
@@ -332,11 +713,49 @@ PVRSRV_ERROR LinuxEventObjectSignal(IMG_HANDLE hOSEventObjectList)
 
 		psLinuxEventObject = (PVRSRV_LINUX_EVENT_OBJECT *)list_entry(psListEntry, PVRSRV_LINUX_EVENT_OBJECT, sList);
 
+		/* Leave a sleeper alone until the sync object it waits on completes */
+		if (psLinuxEventObject->psWaitSyncInfo != IMG_NULL &&
+			!SyncOpsComplete(psLinuxEventObject->psWaitSyncInfo,
+							 psLinuxEventObject->ui32WaitReadOpsTarget,
+							 psLinuxEventObject->ui32WaitWriteOpsTarget))
+		{
+			continue;
+		}
+
 		atomic_inc(&psLinuxEventObject->sTimeStamp);
-	 	wake_up_interruptible(&psLinuxEventObject->sWait);
+
+		/*
+		 * Order the time stamp update against the waitqueue check;
+		 * pairs with the barrier in prepare_to_wait().  Objects with
+		 * no sleeper pick up the new time stamp on their next wait.
+		 */
+		smp_mb();
+		if (waitqueue_active(&psLinuxEventObject->sWait))
+		{
+			wake_up_interruptible(&psLinuxEventObject->sWait);
+		}
+	}
+
+	list_for_each_entry(psFence, &psLinuxEventObjectList->sFenceList, sList)
+	{
+		if (SyncFenceSignalled(psFence) && waitqueue_active(&psFence->sWait))
+		{
+			wake_up_interruptible(&psFence->sWait);
+		}
 	}
 	read_unlock(&psLinuxEventObjectList->sLock);
 
+	spin_lock_irqsave(&psLinuxEventObjectList->sWaiterLock, ulFlags);
+	list_for_each_entry_safe(psWaiter, psWaiterTemp, &psLinuxEventObjectList->sWaiterList, sList)
+	{
+		if (SyncWaiterSignalled(psWaiter))
+		{
+			list_del_init(&psWaiter->sList);
+			psWaiter->pfnCallback(psWaiter);
+		}
+	}
+	spin_unlock_irqrestore(&psLinuxEventObjectList->sWaiterLock, ulFlags);
+
 	return 	PVRSRV_OK;
 
 }
@@ -348,23 +767,57 @@ PVRSRV_ERROR LinuxEventObjectSignal(IMG_HANDLE hOSEventObjectList)
  
  @Description 
  
- Linux wait object routine
+ Linux wait object routine.  With a sync object, the wait returns once
+ the operations pending on it at the time of the call have completed,
+ and signals that leave it incomplete don't wake the caller.  Must be
+ called with the services lock held.
  
  @Input    hOSEventObject : Event object handle 
  
  @Input   ui32MSTimeout : Time out value in msec
 
+ @Input   psSyncInfo : Sync object to wait on, or IMG_NULL for any signal
+
  @Return   PVRSRV_ERROR  :  Error code
 
 ******************************************************************************/
-PVRSRV_ERROR LinuxEventObjectWait(IMG_HANDLE hOSEventObject, IMG_UINT32 ui32MSTimeout)
+PVRSRV_ERROR LinuxEventObjectWait(IMG_HANDLE hOSEventObject, IMG_UINT32 ui32MSTimeout,
+								  PVRSRV_KERNEL_SYNC_INFO *psSyncInfo)
 {
 	IMG_UINT32 ui32TimeStamp;
+	IMG_UINT32 ui32ReadOpsTarget = 0;
+	IMG_UINT32 ui32WriteOpsTarget = 0;
 	DEFINE_WAIT(sWait);
 
 	PVRSRV_LINUX_EVENT_OBJECT *psLinuxEventObject = (PVRSRV_LINUX_EVENT_OBJECT *) hOSEventObject;
+	PVRSRV_LINUX_EVENT_OBJECT_LIST *psLinuxEventObjectList = psLinuxEventObject->psLinuxEventObjectList;
 
 	IMG_UINT32 ui32TimeOutJiffies = msecs_to_jiffies(ui32MSTimeout);
+
+	if (psSyncInfo != IMG_NULL)
+	{
+		/* Keep the sync object alive while the services lock is dropped */
+		psSyncInfo->ui32RefCount++;
+		ui32ReadOpsTarget = psSyncInfo->psSyncData->ui32ReadOpsPending;
+		ui32WriteOpsTarget = psSyncInfo->psSyncData->ui32WriteOpsPending;
+	}
+
+	/*
+	 * Signals can only be filtered for a single sleeper; once a second
+	 * thread waits on the same object, every signal wakes it again.
+	 */
+	write_lock_bh(&psLinuxEventObjectList->sLock);
+	if (psLinuxEventObject->ui32Waiters++ == 0 && psSyncInfo != IMG_NULL)
+	{
+		psLinuxEventObject->psWaitSyncInfo = psSyncInfo;
+		psLinuxEventObject->ui32WaitReadOpsTarget = ui32ReadOpsTarget;
+		psLinuxEventObject->ui32WaitWriteOpsTarget = ui32WriteOpsTarget;
+	}
+	else
+	{
+		psLinuxEventObject->psWaitSyncInfo = IMG_NULL;
+	}
+	write_unlock_bh(&psLinuxEventObjectList->sLock);
 	
 	do
 	{
@@ -376,6 +829,12 @@ PVRSRV_ERROR LinuxEventObjectWait(IMG_HANDLE hOSEventObject, IMG_UINT32 ui32MSTi
 			break;
 		}
 
+		if (psSyncInfo != IMG_NULL &&
+			SyncOpsComplete(psSyncInfo, ui32ReadOpsTarget, ui32WriteOpsTarget))
+		{
+			break;
+		}
+
 		mutex_unlock(&gPVRSRVLock);
 
 		ui32TimeOutJiffies = (IMG_UINT32)schedule_timeout((IMG_INT32)ui32TimeOutJiffies);
@@ -392,6 +851,18 @@ PVRSRV_ERROR LinuxEventObjectWait(IMG_HANDLE hOSEventObject, IMG_UINT32 ui32MSTi
 
 	psLinuxEventObject->ui32TimeStampPrevious = ui32TimeStamp;
 
+	write_lock_bh(&psLinuxEventObjectList->sLock);
+	if (--psLinuxEventObject->ui32Waiters == 0)
+	{
+		psLinuxEventObject->psWaitSyncInfo = IMG_NULL;
+	}
+	write_unlock_bh(&psLinuxEventObjectList->sLock);
+
+	if (psSyncInfo != IMG_NULL)
+	{
+		SyncInfoRelease(psSyncInfo);
+	}
+
 	return ui32TimeOutJiffies ? PVRSRV_OK : PVRSRV_ERROR_TIMEOUT;
 
 }
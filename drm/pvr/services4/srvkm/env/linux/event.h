@@ -45,4 +45,24 @@ PVRSRV_ERROR LinuxEventObjectListDestroy(IMG_HANDLE hEventObjectList);
 PVRSRV_ERROR LinuxEventObjectAdd(IMG_HANDLE hOSEventObjectList, IMG_HANDLE *phOSEventObject);
 PVRSRV_ERROR LinuxEventObjectDelete(IMG_HANDLE hOSEventObjectList, IMG_HANDLE hOSEventObject);
 PVRSRV_ERROR LinuxEventObjectSignal(IMG_HANDLE hOSEventObjectList);
-PVRSRV_ERROR LinuxEventObjectWait(IMG_HANDLE hOSEventObject, IMG_UINT32 ui32MSTimeout);
+PVRSRV_ERROR LinuxEventObjectWait(IMG_HANDLE hOSEventObject, IMG_UINT32 ui32MSTimeout, PVRSRV_KERNEL_SYNC_INFO *psSyncInfo);
+PVRSRV_ERROR LinuxSyncFenceCreate(IMG_HANDLE hOSEventObjectList, IMG_HANDLE hResManContext, PVRSRV_KERNEL_SYNC_INFO *psSyncInfo, IMG_INT *piFd);
+
+/*
+ * In-kernel counterpart of a sync fence.  Once the write operations on
+ * psSyncInfo reach ui32WriteOpsTarget, the signalling of the event list
+ * removes the waiter and calls pfnCallback from the MISR, with the list's
+ * waiter lock held and interrupts off: the callback may only queue work.
+ */
+typedef struct PVRSRV_LINUX_SYNC_WAITER_TAG
+{
+	PVRSRV_KERNEL_SYNC_INFO	*psSyncInfo;
+	IMG_UINT32		ui32WriteOpsTarget;
+	IMG_VOID		(*pfnCallback)(struct PVRSRV_LINUX_SYNC_WAITER_TAG *psWaiter);
+	IMG_VOID		*pvData;
+	struct list_head	sList;
+} PVRSRV_LINUX_SYNC_WAITER;
+
+IMG_VOID LinuxSyncWaiterInit(PVRSRV_LINUX_SYNC_WAITER *psWaiter);
+IMG_BOOL LinuxSyncWaiterAdd(IMG_HANDLE hOSEventObjectList, PVRSRV_LINUX_SYNC_WAITER *psWaiter);
+IMG_VOID LinuxSyncWaiterRemove(IMG_HANDLE hOSEventObjectList, PVRSRV_LINUX_SYNC_WAITER *psWaiter);
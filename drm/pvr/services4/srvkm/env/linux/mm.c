@@ -95,8 +95,6 @@ typedef struct _DEBUG_MEM_ALLOC_REC
 	struct _DEBUG_MEM_ALLOC_REC   **ppsThis;
 }DEBUG_MEM_ALLOC_REC;
 
-static IMPLEMENT_LIST_ANY_VA_2(DEBUG_MEM_ALLOC_REC, IMG_BOOL, IMG_FALSE)
-static IMPLEMENT_LIST_ANY_VA(DEBUG_MEM_ALLOC_REC)
 static IMPLEMENT_LIST_FOR_EACH(DEBUG_MEM_ALLOC_REC)
 static IMPLEMENT_LIST_INSERT(DEBUG_MEM_ALLOC_REC)
 static IMPLEMENT_LIST_REMOVE(DEBUG_MEM_ALLOC_REC)
@@ -152,7 +150,6 @@ typedef struct _DEBUG_LINUX_MEM_AREA_REC
 }DEBUG_LINUX_MEM_AREA_REC;
 
 
-static IMPLEMENT_LIST_ANY_VA(DEBUG_LINUX_MEM_AREA_REC)
 static IMPLEMENT_LIST_FOR_EACH(DEBUG_LINUX_MEM_AREA_REC)
 static IMPLEMENT_LIST_INSERT(DEBUG_LINUX_MEM_AREA_REC)
 static IMPLEMENT_LIST_REMOVE(DEBUG_LINUX_MEM_AREA_REC)
@@ -477,20 +474,26 @@ DebugMemAllocRecordAdd(DEBUG_MEM_ALLOC_TYPE eAllocType,
 }
 
 
-IMG_BOOL DebugMemAllocRecordRemove_AnyVaCb(DEBUG_MEM_ALLOC_REC *psCurrentRecord, va_list va)
+static IMG_VOID
+DebugMemAllocRecordRemove(DEBUG_MEM_ALLOC_TYPE eAllocType, IMG_VOID *pvKey, IMG_CHAR *pszFileName, IMG_UINT32 ui32Line)
 {
-	DEBUG_MEM_ALLOC_TYPE eAllocType;
-	IMG_VOID *pvKey;
-	
-	eAllocType = va_arg(va, DEBUG_MEM_ALLOC_TYPE);
-	pvKey = va_arg(va, IMG_VOID*);
-
-	if (psCurrentRecord->eAllocType == eAllocType
-		&& psCurrentRecord->pvKey == pvKey)
+    DEBUG_MEM_ALLOC_REC *psCurrentRecord;
+
+    mutex_lock(&g_sDebugMutex);
+
+	LIST_FOR_EACH(psCurrentRecord, g_MemoryRecords)
+	{
+		if (psCurrentRecord->eAllocType == eAllocType
+			&& psCurrentRecord->pvKey == pvKey)
+		{
+			break;
+		}
+	}
+
+	if (psCurrentRecord)
 	{
-		eAllocType = psCurrentRecord->eAllocType;
 		g_WaterMarkData[eAllocType] -= psCurrentRecord->ui32Bytes;
-		
+
 		if (eAllocType == DEBUG_MEM_ALLOC_TYPE_KMALLOC
 		   || eAllocType == DEBUG_MEM_ALLOC_TYPE_VMALLOC
 		   || eAllocType == DEBUG_MEM_ALLOC_TYPE_ALLOC_PAGES
@@ -503,29 +506,11 @@ IMG_BOOL DebugMemAllocRecordRemove_AnyVaCb(DEBUG_MEM_ALLOC_REC *psCurrentRecord,
 		{
 			g_IOMemWaterMark -= psCurrentRecord->ui32Bytes;
 		}
-		
+
 		List_DEBUG_MEM_ALLOC_REC_Remove(psCurrentRecord);
 		kfree(psCurrentRecord);
-
-		return IMG_TRUE;
 	}
 	else
-	{
-		return IMG_FALSE;
-	}
-}
-
-
-static IMG_VOID
-DebugMemAllocRecordRemove(DEBUG_MEM_ALLOC_TYPE eAllocType, IMG_VOID *pvKey, IMG_CHAR *pszFileName, IMG_UINT32 ui32Line)
-{
-    mutex_lock(&g_sDebugMutex);
-
-
-	if(!List_DEBUG_MEM_ALLOC_REC_IMG_BOOL_Any_va(g_MemoryRecords,
-												DebugMemAllocRecordRemove_AnyVaCb,
-												eAllocType,
-												pvKey))
 	{
 		PVR_DPF((PVR_DBG_ERROR, "%s: couldn't find an entry for type=%s with pvKey=%p (called from %s, line %d\n",
 		__FUNCTION__, DebugMemAllocRecordTypeToString(eAllocType), pvKey,
@@ -1383,20 +1368,20 @@ DebugLinuxMemAreaRecordAdd(LinuxMemArea *psLinuxMemArea, IMG_UINT32 ui32Flags)
 
 
 
-IMG_VOID* MatchLinuxMemArea_AnyVaCb(DEBUG_LINUX_MEM_AREA_REC *psCurrentRecord,
-												va_list va)
+static INLINE DEBUG_LINUX_MEM_AREA_REC *
+MatchLinuxMemArea(LinuxMemArea *psLinuxMemArea)
 {
-	LinuxMemArea *psLinuxMemArea;
-	
-	psLinuxMemArea = va_arg(va, LinuxMemArea*);
-	if(psCurrentRecord->psLinuxMemArea == psLinuxMemArea)
-	{
-		return psCurrentRecord;
-	}
-	else
+	DEBUG_LINUX_MEM_AREA_REC *psCurrentRecord;
+
+	LIST_FOR_EACH(psCurrentRecord, g_LinuxMemAreaRecords)
 	{
-		return IMG_NULL;
+		if(psCurrentRecord->psLinuxMemArea == psLinuxMemArea)
+		{
+			break;
+		}
 	}
+
+	return psCurrentRecord;
 }
 
 
@@ -1406,9 +1391,7 @@ DebugLinuxMemAreaRecordFind(LinuxMemArea *psLinuxMemArea)
     DEBUG_LINUX_MEM_AREA_REC *psCurrentRecord;
 
     mutex_lock(&g_sDebugMutex);
-	psCurrentRecord = List_DEBUG_LINUX_MEM_AREA_REC_Any_va(g_LinuxMemAreaRecords,
-														MatchLinuxMemArea_AnyVaCb,
-														psLinuxMemArea);
+	psCurrentRecord = MatchLinuxMemArea(psLinuxMemArea);
 
     mutex_unlock(&g_sDebugMutex);
 
@@ -1430,9 +1413,7 @@ DebugLinuxMemAreaRecordRemove(LinuxMemArea *psLinuxMemArea)
     g_LinuxMemAreaCount--;
 
     /* Locate the corresponding allocation entry */
-	psCurrentRecord = List_DEBUG_LINUX_MEM_AREA_REC_Any_va(g_LinuxMemAreaRecords,
-														MatchLinuxMemArea_AnyVaCb,
-														psLinuxMemArea);
+	psCurrentRecord = MatchLinuxMemArea(psLinuxMemArea);
 	if (psCurrentRecord)
 	{
 		/* Unlink the allocation record */
@@ -1651,17 +1632,20 @@ static void ProcSeqStartstopDebugMutex(struct seq_file *sfile, IMG_BOOL start)
 
 #if defined(DEBUG_LINUX_MEM_AREAS)
 
-IMG_VOID* DecOffMemAreaRec_AnyVaCb(DEBUG_LINUX_MEM_AREA_REC *psNode, va_list va)
+/* Returns the off'th (1-based) record, or IMG_NULL past the end */
+static INLINE DEBUG_LINUX_MEM_AREA_REC *DecOffMemAreaRec(loff_t off)
 {
-	off_t *pOff = va_arg(va, off_t*);
-	if (--(*pOff))
-	{
-		return IMG_NULL;
-	}
-	else
+	DEBUG_LINUX_MEM_AREA_REC *psNode;
+
+	LIST_FOR_EACH(psNode, g_LinuxMemAreaRecords)
 	{
-		return psNode;
+		if (!--off)
+		{
+			break;
+		}
 	}
+
+	return psNode;
 }
 
 #ifdef PVR_PROC_USE_SEQ_FILE
@@ -1669,10 +1653,7 @@ IMG_VOID* DecOffMemAreaRec_AnyVaCb(DEBUG_LINUX_MEM_AREA_REC *psNode, va_list va)
 static void* ProcSeqNextMemArea(struct seq_file *sfile,void* el,loff_t off)
 {
     DEBUG_LINUX_MEM_AREA_REC *psRecord;
-	psRecord = (DEBUG_LINUX_MEM_AREA_REC*)
-				List_DEBUG_LINUX_MEM_AREA_REC_Any_va(g_LinuxMemAreaRecords,
-													DecOffMemAreaRec_AnyVaCb,
-													&off);
+	psRecord = DecOffMemAreaRec(off);
 	return (void*)psRecord;
 }
 
@@ -1684,10 +1665,7 @@ static void* ProcSeqOff2ElementMemArea(struct seq_file * sfile, loff_t off)
 		return PVR_PROC_SEQ_START_TOKEN;
 	}
 
-	psRecord = (DEBUG_LINUX_MEM_AREA_REC*)
-				List_DEBUG_LINUX_MEM_AREA_REC_Any_va(g_LinuxMemAreaRecords,
-													DecOffMemAreaRec_AnyVaCb,
-													&off);
+	psRecord = DecOffMemAreaRec(off);
 	return (void*)psRecord;
 }
 
@@ -1808,10 +1786,7 @@ printLinuxMemAreaRecords(IMG_CHAR * buffer, size_t count, off_t off)
         goto unlock_and_return;
     }
 
-	psRecord = (DEBUG_LINUX_MEM_AREA_REC*)
-				List_DEBUG_LINUX_MEM_AREA_REC_Any_va(g_LinuxMemAreaRecords,
-													DecOffMemAreaRec_AnyVaCb,
-													&off);
+	psRecord = DecOffMemAreaRec(off);
 
     if(!psRecord)
     {
@@ -1861,17 +1836,20 @@ unlock_and_return:
 
 #if defined(DEBUG_LINUX_MEMORY_ALLOCATIONS)
 
-IMG_VOID* DecOffMemAllocRec_AnyVaCb(DEBUG_MEM_ALLOC_REC *psNode, va_list va)
+/* Returns the off'th (1-based) record, or IMG_NULL past the end */
+static INLINE DEBUG_MEM_ALLOC_REC *DecOffMemAllocRec(loff_t off)
 {
-	off_t *pOff = va_arg(va, off_t*);
-	if (--(*pOff))
-	{
-		return IMG_NULL;
-	}
-	else
+	DEBUG_MEM_ALLOC_REC *psNode;
+
+	LIST_FOR_EACH(psNode, g_MemoryRecords)
 	{
-		return psNode;
+		if (!--off)
+		{
+			break;
+		}
 	}
+
+	return psNode;
 }
 
 
@@ -1880,10 +1858,7 @@ IMG_VOID* DecOffMemAllocRec_AnyVaCb(DEBUG_MEM_ALLOC_REC *psNode, va_list va)
 static void* ProcSeqNextMemoryRecords(struct seq_file *sfile,void* el,loff_t off)
 {
     DEBUG_MEM_ALLOC_REC *psRecord;
-	psRecord = (DEBUG_MEM_ALLOC_REC*)
-		List_DEBUG_MEM_ALLOC_REC_Any_va(g_MemoryRecords,
-										DecOffMemAllocRec_AnyVaCb,
-										&off);
+	psRecord = DecOffMemAllocRec(off);
 #if defined(DEBUG_LINUX_XML_PROC_FILES)
 	if (!psRecord) 
 	{
@@ -1902,10 +1877,7 @@ static void* ProcSeqOff2ElementMemoryRecords(struct seq_file *sfile, loff_t off)
 		return PVR_PROC_SEQ_START_TOKEN;
 	}
 
-	psRecord = (DEBUG_MEM_ALLOC_REC*)
-		List_DEBUG_MEM_ALLOC_REC_Any_va(g_MemoryRecords,
-										DecOffMemAllocRec_AnyVaCb,
-										&off);
+	psRecord = DecOffMemAllocRec(off);
 
 #if defined(DEBUG_LINUX_XML_PROC_FILES)
 	if (!psRecord)
@@ -2260,10 +2232,7 @@ printMemoryRecords(IMG_CHAR * buffer, size_t count, off_t off)
         goto unlock_and_return;
     }
 
-	psRecord = (DEBUG_MEM_ALLOC_REC*)
-		List_DEBUG_MEM_ALLOC_REC_Any_va(g_MemoryRecords,
-										DecOffMemAllocRec_AnyVaCb,
-										&off);
+	psRecord = DecOffMemAllocRec(off);
     if(!psRecord)
     {
 #if defined(DEBUG_LINUX_XML_PROC_FILES)
@@ -518,6 +518,7 @@ static IMG_INT PVRSRVOpen(struct inode unref__ * pInode, struct file *pFile)
 	IMG_INT iRet = -ENOMEM;
 	PVRSRV_ERROR eError;
 	IMG_UINT32 ui32PID;
+	PVRSRV_PER_PROCESS_DATA *psPerProc;
 #if defined(SUPPORT_DRI_DRM) && defined(PVR_SECURE_DRM_AUTH_EXPORT)
 	PVRSRV_ENV_PER_PROCESS_DATA *psEnvPerProc;
 #endif
@@ -535,8 +536,12 @@ static IMG_INT PVRSRVOpen(struct inode unref__ * pInode, struct file *pFile)
 	if (PVRSRVProcessConnect(ui32PID) != PVRSRV_OK)
 		goto err_unlock;
 
+	/* The only PID hash lookup for this connection */
+	psPerProc = PVRSRVPerProcessData(ui32PID);
+	PVR_ASSERT(psPerProc != IMG_NULL);
+
 #if defined(SUPPORT_DRI_DRM) && defined(PVR_SECURE_DRM_AUTH_EXPORT)
-	psEnvPerProc = PVRSRVPerProcessPrivateData(ui32PID);
+	psEnvPerProc = (PVRSRV_ENV_PER_PROCESS_DATA *)PVRSRVProcessPrivateData(psPerProc);
 	if (psEnvPerProc == IMG_NULL)
 	{
 		PVR_DPF((PVR_DBG_ERROR, "%s: No per-process private data", __FUNCTION__));
@@ -562,6 +567,7 @@ static IMG_INT PVRSRVOpen(struct inode unref__ * pInode, struct file *pFile)
 	list_add_tail(&psPrivateData->sDRMAuthListItem, &psEnvPerProc->sDRMAuthListHead);
 #endif
 	psPrivateData->ui32OpenPID = ui32PID;
+	psPrivateData->psPerProc = psPerProc;
 	psPrivateData->hBlockAlloc = hBlockAlloc;
 	PRIVATE_DATA(pFile) = psPrivateData;
 	iRet = 0;
@@ -878,6 +884,9 @@ static IMG_VOID __exit PVRCore_Cleanup(IMG_VOID)
 
 	PVR_TRACE(("PVRCore_Cleanup"));
 
+	/* Finish tearing down processes that have already closed */
+	OSFlushProcessTeardown();
+
 	SysAcquireData(&psSysData);
 
 #if defined(PVR_LDM_MODULE)
@@ -66,13 +66,18 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <linux/interrupt.h>
 #include <asm/hardirq.h>
 #include <linux/timer.h>
+#include <linux/ktime.h>
 #include <linux/capability.h>
 #include <asm/uaccess.h>
 #include <linux/spinlock.h>
+#include <linux/highmem.h>
+#include <linux/wait.h>
+#include <asm/atomic.h>
 #if defined(PVR_LINUX_MISR_USING_WORKQUEUE) || \
 	defined(PVR_LINUX_MISR_USING_PRIVATE_WORKQUEUE) || \
 	defined(PVR_LINUX_TIMERS_USING_WORKQUEUES) || \
-	defined(PVR_LINUX_USING_WORKQUEUES)
+	defined(PVR_LINUX_USING_WORKQUEUES) || \
+	defined(SUPPORT_CPU_CACHED_BUFFERS)
 #include <linux/workqueue.h>
 #endif
 
@@ -86,6 +91,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "mutex.h"
 #include "event.h"
 #include "linkage.h"
+#include "lock.h"
+#include "perproc.h"
 
 /* 
  VM_RESERVED has disappeared starting from Linux 3.7 and has been
@@ -100,7 +107,13 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #if defined(SUPPORT_CPU_CACHED_BUFFERS) || \
 	defined(SUPPORT_CACHEFLUSH_ON_ALLOC)
 
-#if defined(__i386__)
+static atomic_t sCacheFlushFullCount = ATOMIC_INIT(0);
+static atomic_t sCacheFlushRangeCount = ATOMIC_INIT(0);
+static atomic_t sCacheFlushAsyncCount = ATOMIC_INIT(0);
+static atomic64_t sCacheFlushRangeBytes = ATOMIC64_INIT(0);
+static unsigned long ulCacheFlushStatsStart;
+
+#if defined(__i386__) || defined(__x86_64__)
 static void per_cpu_cache_flush(void *arg)
 {
     PVR_UNREFERENCED_PARAMETER(arg);
@@ -113,9 +126,11 @@ static
 #endif
 IMG_VOID OSFlushCPUCacheKM(IMG_VOID)
 {
+    atomic_inc(&sCacheFlushFullCount);
+
 #if defined(__arm__)
     flush_cache_all();
-#elif defined(__i386__)
+#elif defined(__i386__) || defined(__x86_64__)
 
     on_each_cpu(per_cpu_cache_flush, NULL, 1);
 #else
@@ -126,14 +141,203 @@ IMG_VOID OSFlushCPUCacheKM(IMG_VOID)
 #endif
 #if defined(SUPPORT_CPU_CACHED_BUFFERS)
 
+static struct workqueue_struct *psCacheFlushWorkQueue;
+static struct work_struct sCacheFlushWork;
+static DECLARE_WAIT_QUEUE_HEAD(sCacheFlushWaitQueue);
+static atomic_t sCacheFlushSubmitted = ATOMIC_INIT(0);
+static atomic_t sCacheFlushCompleted = ATOMIC_INIT(0);
+
+/*
+ * Ranged flushes use clflush, so they are only done on x86, 32 and 64 bit.
+ * Other CPUs (ARM) always take the full flush for now.
+ */
+#if defined(__i386__) || defined(__x86_64__)
+#define PVR_CACHE_FLUSH_RANGES
+#endif
+
+#if defined(PVR_CACHE_FLUSH_RANGES)
+/*
+ * clflush the user pages backing [ulStart, ulEnd) through their kernel
+ * mapping.  x86 caches are physically tagged so flushing the alias is
+ * sufficient.  Returns IMG_FALSE if any page could not be pinned, in which
+ * case the caller falls back to a full flush.
+ */
+static IMG_BOOL FlushUserRange(unsigned long ulStart, unsigned long ulEnd)
+{
+    struct page *apsPages[16];
+    unsigned long ulAddr = ulStart & PAGE_MASK;
+    IMG_BOOL bOK = IMG_TRUE;
+
+    while (bOK && ulAddr < ulEnd)
+    {
+        IMG_INT iNumPages = (IMG_INT)min_t(unsigned long, (ulEnd - ulAddr + PAGE_SIZE - 1) >> PAGE_SHIFT,
+                                           ARRAY_SIZE(apsPages));
+        IMG_INT iNumPinned;
+        IMG_INT i;
+
+        down_read(&current->mm->mmap_sem);
+        iNumPinned = get_user_pages(current, current->mm, ulAddr, iNumPages, 0, 0, apsPages, NULL);
+        up_read(&current->mm->mmap_sem);
+
+        if (iNumPinned != iNumPages)
+        {
+            bOK = IMG_FALSE;
+        }
+
+        for (i = 0; i < iNumPinned; i++)
+        {
+            unsigned long ulPageStart = max_t(unsigned long, ulStart, ulAddr + ((unsigned long)i << PAGE_SHIFT));
+            unsigned long ulPageEnd = min_t(unsigned long, ulEnd, ulAddr + ((unsigned long)(i + 1) << PAGE_SHIFT));
+            IMG_UINT8 *pui8Page;
+
+            if (bOK)
+            {
+                pui8Page = kmap(apsPages[i]);
+                clflush_cache_range(pui8Page + (ulPageStart & ~PAGE_MASK), (IMG_UINT)(ulPageEnd - ulPageStart));
+                kunmap(apsPages[i]);
+            }
+            page_cache_release(apsPages[i]);
+        }
+
+        ulAddr += (unsigned long)iNumPages << PAGE_SHIFT;
+    }
+
+    return bOK;
+}
+#endif
+
+/*
+ * Flush a batch of ranges as a single operation: one wbinvd if the batch
+ * is large enough for that to be cheaper, otherwise clflush of each range
+ * (kernel ranges directly, user ranges through their pinned pages).
+ */
+IMG_VOID OSFlushCPUCacheRangesKM(PVRSRV_CACHE_RANGE *psRanges,
+								 IMG_UINT32 ui32NumRanges)
+{
+    IMG_SIZE_T uTotal = 0;
+    IMG_UINT32 i;
+
+    for (i = 0; i < ui32NumRanges; i++)
+    {
+        if (psRanges[i].pvEnd > psRanges[i].pvStart)
+        {
+            uTotal += (IMG_SIZE_T)((IMG_UINT8 *)psRanges[i].pvEnd - (IMG_UINT8 *)psRanges[i].pvStart);
+        }
+    }
+
+    if (uTotal == 0)
+    {
+        return;
+    }
+
+#if defined(PVR_CACHE_FLUSH_RANGES)
+    if (uTotal < PVR_CACHE_FLUSH_RANGE_THRESHOLD && boot_cpu_has(X86_FEATURE_CLFLUSH))
+    {
+        for (i = 0; i < ui32NumRanges; i++)
+        {
+            unsigned long ulStart = (unsigned long)psRanges[i].pvStart;
+            unsigned long ulEnd = (unsigned long)psRanges[i].pvEnd;
+
+            if (ulEnd <= ulStart)
+            {
+                continue;
+            }
+
+            if (ulStart >= PAGE_OFFSET)
+            {
+                clflush_cache_range(psRanges[i].pvStart, (IMG_UINT)(ulEnd - ulStart));
+            }
+            else if (!FlushUserRange(ulStart, ulEnd))
+            {
+                PVR_DPF((PVR_DBG_MESSAGE, "OSFlushCPUCacheRangesKM: range 0x%lx-0x%lx not pinnable, flushing all", ulStart, ulEnd));
+                OSFlushCPUCacheKM();
+                return;
+            }
+        }
+
+        atomic_inc(&sCacheFlushRangeCount);
+        atomic64_add((long)uTotal, &sCacheFlushRangeBytes);
+        return;
+    }
+#endif
+
+    OSFlushCPUCacheKM();
+}
+
 IMG_VOID OSFlushCPUCacheRangeKM(IMG_VOID *pvRangeAddrStart,
 								IMG_VOID *pvRangeAddrEnd)
 {
-	PVR_UNREFERENCED_PARAMETER(pvRangeAddrStart);
-	PVR_UNREFERENCED_PARAMETER(pvRangeAddrEnd);
+	PVRSRV_CACHE_RANGE sRange;
+
+	sRange.pvStart = pvRangeAddrStart;
+	sRange.pvEnd = pvRangeAddrEnd;
+
+	OSFlushCPUCacheRangesKM(&sRange, 1);
+}
+
+static IMG_VOID CacheFlushWorker(struct work_struct *psWork)
+{
+    /* Everything submitted before this point is covered by this flush */
+    IMG_UINT32 ui32Fence = (IMG_UINT32)atomic_read(&sCacheFlushSubmitted);
+
+    PVR_UNREFERENCED_PARAMETER(psWork);
+
+    OSFlushCPUCacheKM();
+
+    atomic_set(&sCacheFlushCompleted, (IMG_INT)ui32Fence);
+    wake_up_all(&sCacheFlushWaitQueue);
+}
+
+/*
+ * Start a full flush on the cache flush workqueue and return a fence that
+ * OSWaitCPUCacheFlushKM can later wait on.  Requests arriving while a flush
+ * is pending are merged into it.
+ */
+IMG_UINT32 OSFlushCPUCacheAsyncKM(IMG_VOID)
+{
+    IMG_UINT32 ui32Fence = (IMG_UINT32)atomic_inc_return(&sCacheFlushSubmitted);
 
+    atomic_inc(&sCacheFlushAsyncCount);
 
-	OSFlushCPUCacheKM();
+    if (psCacheFlushWorkQueue == NULL)
+    {
+        OSFlushCPUCacheKM();
+        atomic_set(&sCacheFlushCompleted, (IMG_INT)ui32Fence);
+        return ui32Fence;
+    }
+
+    queue_work(psCacheFlushWorkQueue, &sCacheFlushWork);
+
+    return ui32Fence;
+}
+
+IMG_BOOL OSCPUCacheFlushCompleteKM(IMG_UINT32 ui32Fence)
+{
+    return (IMG_INT32)((IMG_UINT32)atomic_read(&sCacheFlushCompleted) - ui32Fence) >= 0;
+}
+
+/* Sleeps; process context only. */
+IMG_VOID OSWaitCPUCacheFlushKM(IMG_UINT32 ui32Fence)
+{
+    wait_event(sCacheFlushWaitQueue, OSCPUCacheFlushCompleteKM(ui32Fence));
+}
+
+IMG_VOID OSGetCPUCacheFlushStats(PVRSRV_CACHE_FLUSH_STATS *psStats)
+{
+    psStats->ui32FullFlushes = (IMG_UINT32)atomic_read(&sCacheFlushFullCount);
+    psStats->ui32RangeFlushes = (IMG_UINT32)atomic_read(&sCacheFlushRangeCount);
+    psStats->ui32AsyncFlushes = (IMG_UINT32)atomic_read(&sCacheFlushAsyncCount);
+    psStats->ui64RangeBytes = (IMG_UINT64)atomic64_read(&sCacheFlushRangeBytes);
+    psStats->ui32ElapsedMs = jiffies_to_msecs(jiffies - ulCacheFlushStatsStart);
+}
+
+IMG_VOID OSResetCPUCacheFlushStats(IMG_VOID)
+{
+    atomic_set(&sCacheFlushFullCount, 0);
+    atomic_set(&sCacheFlushRangeCount, 0);
+    atomic_set(&sCacheFlushAsyncCount, 0);
+    atomic64_set(&sCacheFlushRangeBytes, 0);
+    ulCacheFlushStatsStart = jiffies;
 }
 
 #endif
@@ -667,6 +871,96 @@ IMG_VOID OSReleaseThreadQuanta(IMG_VOID)
 }
 
 
+/* Most resources freed per bridge lock hold when tearing down a process */
+#define PVR_TEARDOWN_CHUNK	256
+
+typedef struct _PVR_TEARDOWN_WORK_
+{
+    struct work_struct sWork;
+    PVRSRV_PER_PROCESS_DATA *psPerProc;
+} PVR_TEARDOWN_WORK;
+
+static struct workqueue_struct *psTeardownWorkQueue;
+
+static IMG_VOID ProcessTeardownWorker(struct work_struct *psWork)
+{
+    PVR_TEARDOWN_WORK *psTeardown = container_of(psWork, PVR_TEARDOWN_WORK, sWork);
+    IMG_BOOL bDone;
+
+    do
+    {
+        mutex_lock(&gPVRSRVLock);
+        bDone = PVRSRVPerProcessDataTeardown(psTeardown->psPerProc, PVR_TEARDOWN_CHUNK);
+        mutex_unlock(&gPVRSRVLock);
+
+        cond_resched();
+    } while (!bDone);
+
+    kfree(psTeardown);
+}
+
+
+/*!
+******************************************************************************
+
+ @Function OSScheduleProcessTeardown
+
+ @Description
+    Queues the teardown of a process whose last connection has closed and
+    whose per-process data has been detached.  The worker frees the
+    resources PVR_TEARDOWN_CHUNK at a time, taking gPVRSRVLock for each
+    chunk only, so that neither close() nor other clients wait for it.
+
+ @Input hPerProc : detached per-process data
+
+ @Return PVRSRV_OK, or an error if the caller must tear down itself
+
+******************************************************************************/
+PVRSRV_ERROR OSScheduleProcessTeardown(IMG_HANDLE hPerProc)
+{
+    PVR_TEARDOWN_WORK *psTeardown;
+
+    if (psTeardownWorkQueue == NULL)
+    {
+        return PVRSRV_ERROR_GENERIC;
+    }
+
+    psTeardown = kmalloc(sizeof(*psTeardown), GFP_KERNEL);
+    if (psTeardown == NULL)
+    {
+        return PVRSRV_ERROR_OUT_OF_MEMORY;
+    }
+
+    INIT_WORK(&psTeardown->sWork, ProcessTeardownWorker);
+    psTeardown->psPerProc = (PVRSRV_PER_PROCESS_DATA *)hPerProc;
+
+    queue_work(psTeardownWorkQueue, &psTeardown->sWork);
+
+    return PVRSRV_OK;
+}
+
+
+/*!
+******************************************************************************
+
+ @Function OSFlushProcessTeardown
+
+ @Description
+    Waits for all queued process teardowns.  Must not be called with
+    gPVRSRVLock held.
+
+ @Return nothing
+
+******************************************************************************/
+IMG_VOID OSFlushProcessTeardown(IMG_VOID)
+{
+    if (psTeardownWorkQueue != NULL)
+    {
+        flush_workqueue(psTeardownWorkQueue);
+    }
+}
+
+
 /*!
 ******************************************************************************
 
@@ -690,6 +984,27 @@ IMG_UINT32 OSClockus(IMG_VOID)
 }
 
 
+/*!
+******************************************************************************
+
+ @Function OSClockns64
+
+ @Description
+    Returns a monotonic timestamp in nanoseconds, suitable for measuring
+    short intervals.  Unlike OSClockus it is not limited to jiffy
+    resolution.
+
+ @Input void
+
+ @Return - clock (ns)
+
+******************************************************************************/
+IMG_UINT64 OSClockns64(IMG_VOID)
+{
+    return (IMG_UINT64)ktime_to_ns(ktime_get());
+}
+
+
 
 IMG_VOID OSWaitus(IMG_UINT32 ui32Timeus)
 {
@@ -2785,7 +3100,7 @@ PVRSRV_ERROR OSEventObjectWait(IMG_HANDLE hOSEventKM)
     
     if(hOSEventKM)
     {
-        eError = LinuxEventObjectWait(hOSEventKM, EVENT_OBJECT_TIMEOUT_MS);
+        eError = LinuxEventObjectWait(hOSEventKM, EVENT_OBJECT_TIMEOUT_MS, IMG_NULL);
     }
     else
     {
@@ -2796,6 +3111,40 @@ PVRSRV_ERROR OSEventObjectWait(IMG_HANDLE hOSEventKM)
     return eError;
 }
 
+/*!
+******************************************************************************
+
+ @Function	OSEventObjectWaitSync
+ 
+ @Description 
+ 
+ OS specific function to wait for an event object until the operations
+ pending on a sync object have completed.  Called from client
+ 
+ @Input    hOSEventKM : OS and kernel specific handle to event object
+ @Input    hKernelSyncInfo : Kernel sync object to wait on
+
+ @Return   PVRSRV_ERROR  : 
+
+******************************************************************************/
+PVRSRV_ERROR OSEventObjectWaitSync(IMG_HANDLE hOSEventKM, IMG_HANDLE hKernelSyncInfo)
+{
+    PVRSRV_ERROR eError;
+    
+    if(hOSEventKM && hKernelSyncInfo)
+    {
+        eError = LinuxEventObjectWait(hOSEventKM, EVENT_OBJECT_TIMEOUT_MS,
+                                      (PVRSRV_KERNEL_SYNC_INFO *)hKernelSyncInfo);
+    }
+    else
+    {
+        PVR_DPF((PVR_DBG_ERROR, "OSEventObjectWaitSync: invalid handle"));
+        eError = PVRSRV_ERROR_INVALID_PARAMS;
+    }
+
+    return eError;
+}
+
 /*!
 ******************************************************************************
 
@@ -3452,12 +3801,39 @@ PVRSRV_ERROR PVROSFuncInit(IMG_VOID)
 	    INIT_WORK(&psTimerCBData->sWork, OSTimerWorkQueueCallBack);
         }
     }
+#endif
+    psTeardownWorkQueue = create_singlethread_workqueue("pvr_teardown");
+    if (psTeardownWorkQueue == NULL)
+    {
+	PVR_DPF((PVR_DBG_WARNING, "%s: couldn't create teardown workqueue, process exit will tear down in close()", __FUNCTION__));
+    }
+#if defined(SUPPORT_CPU_CACHED_BUFFERS)
+    ulCacheFlushStatsStart = jiffies;
+    INIT_WORK(&sCacheFlushWork, CacheFlushWorker);
+
+    psCacheFlushWorkQueue = create_singlethread_workqueue("pvr_cacheflush");
+    if (psCacheFlushWorkQueue == NULL)
+    {
+	PVR_DPF((PVR_DBG_WARNING, "%s: couldn't create cache flush workqueue, async flushes will be synchronous", __FUNCTION__));
+    }
 #endif
     return PVRSRV_OK;
 }
 
 IMG_VOID PVROSFuncDeInit(IMG_VOID)
 {
+    if (psTeardownWorkQueue != NULL)
+    {
+	destroy_workqueue(psTeardownWorkQueue);
+	psTeardownWorkQueue = NULL;
+    }
+#if defined(SUPPORT_CPU_CACHED_BUFFERS)
+    if (psCacheFlushWorkQueue != NULL)
+    {
+	destroy_workqueue(psCacheFlushWorkQueue);
+	psCacheFlushWorkQueue = NULL;
+    }
+#endif
 #if defined(PVR_LINUX_TIMERS_USING_WORKQUEUES)
     if (psTimerWorkQueue != NULL)
     {
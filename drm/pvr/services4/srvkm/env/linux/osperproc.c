@@ -122,6 +122,9 @@ PVRSRV_ERROR OSPerProcessSetHandleOptions(PVRSRV_HANDLE_BASE *psHandleBase)
 
 IMG_HANDLE LinuxTerminatingProcessPrivateData(IMG_VOID)
 {
+	/* A process being torn down is no longer found by its PID */
+	if (PVRSRVTerminatingPerProcessData() != IMG_NULL)
+		return PVRSRVProcessPrivateData(PVRSRVTerminatingPerProcessData());
 	if(!gui32ReleasePID)
 		return NULL;
 	return PVRSRVPerProcessPrivateData(gui32ReleasePID);
@@ -55,11 +55,15 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "sgxmmu.h"
 #include "mm.h"
 #include "pdump_km.h"
+#if defined(PDUMP_COMPRESS)
+#include "pdump_compress_km.h"
+#endif
 
 #include <linux/tty.h>
 
 static IMG_BOOL PDumpWriteString2		(IMG_CHAR * pszString, IMG_UINT32 ui32Flags);
 static IMG_BOOL PDumpWriteILock			(PDBG_STREAM psStream, IMG_UINT8 *pui8Data, IMG_UINT32 ui32Count, IMG_UINT32 ui32Flags);
+static IMG_BOOL PDumpWriteStream		(PDBG_STREAM psStream, IMG_UINT8 *pui8Data, IMG_UINT32 ui32Count, IMG_UINT32 ui32Flags);
 static IMG_VOID DbgSetFrame				(PDBG_STREAM psStream, IMG_UINT32 ui32Frame);
 static IMG_UINT32 DbgGetFrame			(PDBG_STREAM psStream);
 static IMG_VOID DbgSetMarker			(PDBG_STREAM psStream, IMG_UINT32 ui32Marker);
@@ -94,6 +98,28 @@ typedef struct PDBG_PDUMP_STATE_TAG
 
 static PDBG_PDUMP_STATE gsDBGPdumpState = {{IMG_NULL}, 0, IMG_NULL, IMG_NULL, IMG_NULL};
 
+#if defined(PDUMP_COMPRESS)
+/*
+	Per stream encoders. Script lines are batched into blocks which are
+	flushed when full, when the write flags change and before anything
+	that changes whether the debug driver captures (frame and init phase
+	changes). Parameter and driver info data is flushed on every write so
+	that stream offsets handed to the script are always current.
+*/
+typedef struct _PDUMP_COMP_STATE_
+{
+	PDUMP_COMP_CTX	*apsCtx[PDUMP_NUM_STREAMS];
+	IMG_UINT32		aui32Flags[PDUMP_NUM_STREAMS];
+	IMG_UINT32		aui32Offset[PDUMP_NUM_STREAMS];
+} PDUMP_COMP_STATE;
+
+static PDUMP_COMP_STATE gsPDumpCompState;
+
+static IMG_BOOL PDumpCompWrite(PDBG_STREAM psStream, IMG_UINT8 *pui8Data, IMG_UINT32 ui32Count, IMG_UINT32 ui32Flags);
+static IMG_BOOL PDumpCompFlush(IMG_UINT32 ui32Stream);
+static IMG_BOOL PDumpCompFlushAll(IMG_VOID);
+#endif
+
 #define SZ_MSG_SIZE_MAX			PVRSRV_PDUMP_MAX_COMMENT_SIZE-1
 #define SZ_SCRIPT_SIZE_MAX		PVRSRV_PDUMP_MAX_COMMENT_SIZE-1
 #define SZ_FILENAME_SIZE_MAX	PVRSRV_PDUMP_MAX_COMMENT_SIZE-1
@@ -477,6 +503,14 @@ IMG_VOID PDumpInit(IMG_VOID)
 
 			gpfnDbgDrv->pfnSetCaptureMode(gsDBGPdumpState.psStream[i],DEBUG_CAPMODE_FRAMED,0xFFFFFFFF, 0xFFFFFFFF, 1);
 			gpfnDbgDrv->pfnSetFrame(gsDBGPdumpState.psStream[i],0);
+
+#if defined(PDUMP_COMPRESS)
+			if (PDumpCompCreate((i == PDUMP_STREAM_PARAM2) ? IMG_TRUE : IMG_FALSE,
+								&gsPDumpCompState.apsCtx[i]) != PVRSRV_OK)
+			{
+				goto init_failed;
+			}
+#endif
 		}
 
 		PDUMPCOMMENT("Driver Product Name: %s", VS_PRODUCT_NAME);
@@ -488,6 +522,17 @@ IMG_VOID PDumpInit(IMG_VOID)
 
 init_failed:
 
+#if defined(PDUMP_COMPRESS)
+	for(i=0; i < PDUMP_NUM_STREAMS; i++)
+	{
+		if (gsPDumpCompState.apsCtx[i])
+		{
+			PDumpCompDestroy(gsPDumpCompState.apsCtx[i]);
+			gsPDumpCompState.apsCtx[i] = IMG_NULL;
+		}
+	}
+#endif
+
 	if(gsDBGPdumpState.pszFile)
 	{
 		OSFreeMem(PVRSRV_OS_PAGEABLE_HEAP, SZ_FILENAME_SIZE_MAX, (IMG_PVOID) gsDBGPdumpState.pszFile, 0);
@@ -514,6 +559,19 @@ IMG_VOID PDumpDeInit(IMG_VOID)
 {
 	IMG_UINT32 i;
 
+#if defined(PDUMP_COMPRESS)
+	PDumpCompFlushAll();
+
+	for(i=0; i < PDUMP_NUM_STREAMS; i++)
+	{
+		if (gsPDumpCompState.apsCtx[i])
+		{
+			PDumpCompDestroy(gsPDumpCompState.apsCtx[i]);
+			gsPDumpCompState.apsCtx[i] = IMG_NULL;
+		}
+	}
+#endif
+
 	for(i=0; i < PDUMP_NUM_STREAMS; i++)
 	{
 		gpfnDbgDrv->pfnDestroyStream(gsDBGPdumpState.psStream[i]);
@@ -554,6 +612,9 @@ PVRSRV_ERROR PDumpStartInitPhaseKM(IMG_VOID)
 	if (gpfnDbgDrv)
 	{
 		PDUMPCOMMENT("Start Init Phase");
+#if defined(PDUMP_COMPRESS)
+		PDumpCompFlushAll();
+#endif
 		for(i=0; i < PDUMP_NUM_STREAMS; i++)
 		{
 			gpfnDbgDrv->pfnStartInitPhase(gsDBGPdumpState.psStream[i]);
@@ -576,6 +637,9 @@ PVRSRV_ERROR PDumpStopInitPhaseKM(IMG_VOID)
 	if (gpfnDbgDrv)
 	{
 		PDUMPCOMMENT("Stop Init Phase");
+#if defined(PDUMP_COMPRESS)
+		PDumpCompFlushAll();
+#endif
 
 		for(i=0; i < PDUMP_NUM_STREAMS; i++)
 		{
@@ -625,6 +689,11 @@ PVRSRV_ERROR PDumpSetFrameKM(IMG_UINT32 ui32Frame)
 {
 	IMG_UINT32	ui32Stream;
 
+#if defined(PDUMP_COMPRESS)
+	/* Batched data belongs to the frame it was written in */
+	PDumpCompFlushAll();
+#endif
+
 	for	(ui32Stream = 0; ui32Stream < PDUMP_NUM_STREAMS; ui32Stream++)
 	{
 		if	(gsDBGPdumpState.psStream[ui32Stream])
@@ -671,17 +740,38 @@ static IMG_BOOL PDumpWriteString2(IMG_CHAR * pszString, IMG_UINT32 ui32Flags)
 *****************************************************************************/
 static IMG_BOOL PDumpWriteILock(PDBG_STREAM psStream, IMG_UINT8 *pui8Data, IMG_UINT32 ui32Count, IMG_UINT32 ui32Flags)
 {
-	IMG_UINT32 ui32Written = 0;
-	IMG_UINT32 ui32Off = 0;
-
 	if ((psStream == IMG_NULL) || PDumpSuspended() || ((ui32Flags & PDUMP_FLAGS_NEVER) != 0))
 	{
 		return IMG_TRUE;
 	}
 
+#if defined(PDUMP_COMPRESS)
+	return PDumpCompWrite(psStream, pui8Data, ui32Count, ui32Flags);
+#else
+	return PDumpWriteStream(psStream, pui8Data, ui32Count, ui32Flags);
+#endif
+}
+
+/*****************************************************************************
+ FUNCTION	: PDumpWriteStream
 
+ PURPOSE	: Writes data to a debug driver stream, retrying until it has
+			  all been accepted
+
+ PARAMETERS	:
+
+ RETURNS	:
+*****************************************************************************/
+static IMG_BOOL PDumpWriteStream(PDBG_STREAM psStream, IMG_UINT8 *pui8Data, IMG_UINT32 ui32Count, IMG_UINT32 ui32Flags)
+{
+	IMG_UINT32 ui32Written = 0;
+	IMG_UINT32 ui32Off = 0;
+
+#if !defined(PDUMP_COMPRESS)
 	/*
-		Set the stream marker to split output files
+		Set the stream marker to split output files. Compressed parameter
+		streams are not split: the marker is a decoded offset and the
+		capture tool would apply it to the encoded data.
 	*/
 
 	if (psStream == gsDBGPdumpState.psStream[PDUMP_STREAM_PARAM2])
@@ -697,6 +787,7 @@ static IMG_BOOL PDumpWriteILock(PDBG_STREAM psStream, IMG_UINT8 *pui8Data, IMG_U
 			}
 		}
 	}
+#endif
 
 
 	while (((IMG_UINT32) ui32Count > 0) && (ui32Written != 0xFFFFFFFF))
@@ -726,6 +817,154 @@ static IMG_BOOL PDumpWriteILock(PDBG_STREAM psStream, IMG_UINT8 *pui8Data, IMG_U
 	return IMG_TRUE;
 }
 
+#if defined(PDUMP_COMPRESS)
+/*****************************************************************************
+ FUNCTION	: PDumpCompFlush
+
+ PURPOSE	: Encodes the pending data of a stream and writes it out as one
+			  block
+
+ PARAMETERS	: ui32Stream - PDUMP_STREAM_*
+
+ RETURNS	: IMG_FALSE if the debug driver rejected the block
+*****************************************************************************/
+static IMG_BOOL PDumpCompFlush(IMG_UINT32 ui32Stream)
+{
+	PDBG_STREAM psStream = gsDBGPdumpState.psStream[ui32Stream];
+	PDUMP_COMP_CTX *psCtx = gsPDumpCompState.apsCtx[ui32Stream];
+	IMG_UINT32 ui32Flags = gsPDumpCompState.aui32Flags[ui32Stream];
+	IMG_UINT8 *pui8Block;
+	IMG_UINT32 ui32Size;
+	IMG_UINT32 ui32Decoded;
+	IMG_UINT32 ui32Before;
+	IMG_UINT32 ui32After;
+	IMG_BOOL bRet;
+
+	if ((psCtx == IMG_NULL) || (PDumpCompPending(psCtx) == 0))
+	{
+		return IMG_TRUE;
+	}
+
+	pui8Block = PDumpCompFinish(psCtx, &ui32Size, &ui32Decoded);
+
+	ui32Before = gpfnDbgDrv->pfnGetStreamOffset(psStream);
+	bRet = PDumpWriteStream(psStream, pui8Block, ui32Size, ui32Flags);
+	ui32After = gpfnDbgDrv->pfnGetStreamOffset(psStream);
+
+	/*
+		The debug driver counts encoded bytes. Keep the stream offset in
+		decoded bytes, as that is what the script refers to. The offset
+		does not move if the block was dropped outside the capture range.
+	*/
+	if (ui32After != ui32Before)
+	{
+		gpfnDbgDrv->pfnSetStreamOffset(psStream, ui32Before + ui32Decoded);
+	}
+
+	PDumpCompCommit(psCtx, (ui32After != ui32Before) ? IMG_TRUE : IMG_FALSE);
+	gsPDumpCompState.aui32Offset[ui32Stream] = gpfnDbgDrv->pfnGetStreamOffset(psStream);
+
+	return bRet;
+}
+
+static IMG_BOOL PDumpCompFlushAll(IMG_VOID)
+{
+	IMG_UINT32 ui32Stream;
+	IMG_BOOL bRet = IMG_TRUE;
+
+	for (ui32Stream = 0; ui32Stream < PDUMP_NUM_STREAMS; ui32Stream++)
+	{
+		if (gsDBGPdumpState.psStream[ui32Stream] && !PDumpCompFlush(ui32Stream))
+		{
+			bRet = IMG_FALSE;
+		}
+	}
+
+	return bRet;
+}
+
+/*****************************************************************************
+ FUNCTION	: PDumpCompWrite
+
+ PURPOSE	: Compressed replacement for PDumpWriteStream
+
+ PARAMETERS	:
+
+ RETURNS	:
+*****************************************************************************/
+static IMG_BOOL PDumpCompWrite(PDBG_STREAM psStream, IMG_UINT8 *pui8Data, IMG_UINT32 ui32Count, IMG_UINT32 ui32Flags)
+{
+	IMG_UINT32 ui32Stream;
+	PDUMP_COMP_CTX *psCtx;
+	IMG_BOOL bBatch;
+
+	for (ui32Stream = 0; ui32Stream < PDUMP_NUM_STREAMS; ui32Stream++)
+	{
+		if (gsDBGPdumpState.psStream[ui32Stream] == psStream)
+		{
+			break;
+		}
+	}
+
+	if ((ui32Stream == PDUMP_NUM_STREAMS) || (gsPDumpCompState.apsCtx[ui32Stream] == IMG_NULL))
+	{
+		return PDumpWriteStream(psStream, pui8Data, ui32Count, ui32Flags);
+	}
+	psCtx = gsPDumpCompState.apsCtx[ui32Stream];
+
+	/* Last frame data is replayed later by the debug driver; never batch it */
+	bBatch = (ui32Stream == PDUMP_STREAM_SCRIPT2) &&
+			 ((ui32Flags & PDUMP_FLAGS_LASTFRAME) == 0);
+
+	if (PDumpCompPending(psCtx) && (gsPDumpCompState.aui32Flags[ui32Stream] != ui32Flags))
+	{
+		if (!PDumpCompFlush(ui32Stream))
+		{
+			return IMG_FALSE;
+		}
+	}
+
+	while (ui32Count > 0)
+	{
+		IMG_UINT32 ui32Chunk = MIN(ui32Count, PDUMP_COMP_BLOCK_SIZE);
+		IMG_UINT32 ui32Offset = PDUMP_COMP_NO_OFFSET;
+
+		if ((ui32Flags & PDUMP_FLAGS_LASTFRAME) == 0)
+		{
+			ui32Offset = gpfnDbgDrv->pfnGetStreamOffset(psStream);
+
+			/* Forget data the capture tool has thrown away */
+			if (ui32Offset != gsPDumpCompState.aui32Offset[ui32Stream])
+			{
+				PDumpCompInvalidate(psCtx, ui32Offset);
+				gsPDumpCompState.aui32Offset[ui32Stream] = ui32Offset;
+			}
+			ui32Offset += PDumpCompPending(psCtx);
+		}
+
+		if (!PDumpCompAdd(psCtx, pui8Data, ui32Chunk, ui32Offset))
+		{
+			if (!PDumpCompFlush(ui32Stream))
+			{
+				return IMG_FALSE;
+			}
+			continue;
+		}
+		gsPDumpCompState.aui32Flags[ui32Stream] = ui32Flags;
+
+		pui8Data += ui32Chunk;
+		ui32Count -= ui32Chunk;
+
+		if (!bBatch && !PDumpCompFlush(ui32Stream))
+		{
+			return IMG_FALSE;
+		}
+	}
+
+	return IMG_TRUE;
+}
+#endif /* defined(PDUMP_COMPRESS) */
+
 /*****************************************************************************
  FUNCTION	:	DbgSetFrame
 
@@ -63,6 +63,13 @@ typedef struct
 	/* PID that created this services connection */
 	IMG_UINT32 ui32OpenPID;
 
+	/*
+	 * Per-process data of the opening process, looked up once at open so
+	 * that bridge calls on this connection do not go through the PID hash.
+	 * The connection holds a reference on it until release.
+	 */
+	struct _PVRSRV_PER_PROCESS_DATA_ *psPerProc;
+
 #if defined(PVR_SECURE_FD_EXPORT)
 
 	IMG_HANDLE hKernelMemInfo;
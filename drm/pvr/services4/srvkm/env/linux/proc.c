@@ -48,6 +48,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <linux/fs.h>
 #include <linux/proc_fs.h>
 #include <linux/seq_file.h>
+#include <asm/div64.h>
 #if LINUX_VERSION_CODE > KERNEL_VERSION(3,8,0)
 #include <linux/slab.h>
 #endif
@@ -130,6 +131,24 @@ static struct proc_dir_entry* g_pProcDebugLevel;
 static struct proc_dir_entry* g_pProcPowerLevel;
 #endif
 
+#if defined(PVR_PROC_USE_SEQ_FILE) && defined(SUPPORT_CPU_CACHED_BUFFERS)
+static struct proc_dir_entry* g_pProcCacheFlush;
+#if LINUX_VERSION_CODE >= PATCH_SEQ_HANDLERS
+static PVR_PROC_SEQ_HANDLERS *g_pProcCacheFlushHandlers;
+#endif
+static void ProcSeqShowCacheFlush(struct seq_file *sfile,void* el);
+static int ProcSetCacheFlush(struct file *file, const char __user *buffer, unsigned long count, void *data);
+#endif
+
+#if defined(PVR_PROC_USE_SEQ_FILE) && defined(PVRSRV_METRICS)
+static struct proc_dir_entry* g_pProcMetrics;
+#if LINUX_VERSION_CODE >= PATCH_SEQ_HANDLERS
+static PVR_PROC_SEQ_HANDLERS *g_pProcMetricsHandlers;
+#endif
+static void ProcSeqShowMetrics(struct seq_file *sfile,void* el);
+static int ProcSetMetrics(struct file *file, const char __user *buffer, unsigned long count, void *data);
+#endif
+
 
 static void ProcSeqShowVersion(struct seq_file *sfile,void* el);
 
@@ -1154,6 +1173,42 @@ IMG_INT CreateProcEntries(IMG_VOID)
     }
 
 
+#if defined(PVR_PROC_USE_SEQ_FILE) && defined(SUPPORT_CPU_CACHED_BUFFERS)
+	g_pProcCacheFlush = CreateProcEntrySeq("cache_flush", NULL, NULL,
+											ProcSeqShowCacheFlush,
+											ProcSeq1ElementOff2Element, NULL,
+#if LINUX_VERSION_CODE >= PATCH_SEQ_HANDLERS
+											ProcSetCacheFlush,
+											&g_pProcCacheFlushHandlers);
+#else
+											ProcSetCacheFlush);
+#endif
+	if(!g_pProcCacheFlush)
+	{
+		PVR_DPF((PVR_DBG_ERROR, "CreateProcEntries: couldn't make /proc/%s/cache_flush", PVRProcDirRoot));
+
+		return -ENOMEM;
+	}
+#endif
+
+#if defined(PVR_PROC_USE_SEQ_FILE) && defined(PVRSRV_METRICS)
+	g_pProcMetrics = CreateProcEntrySeq("metrics", NULL, NULL,
+										ProcSeqShowMetrics,
+										ProcSeq1ElementOff2Element, NULL,
+#if LINUX_VERSION_CODE >= PATCH_SEQ_HANDLERS
+										ProcSetMetrics,
+										&g_pProcMetricsHandlers);
+#else
+										ProcSetMetrics);
+#endif
+	if(!g_pProcMetrics)
+	{
+		PVR_DPF((PVR_DBG_ERROR, "CreateProcEntries: couldn't make /proc/%s/metrics", PVRProcDirRoot));
+
+		return -ENOMEM;
+	}
+#endif
+
 #ifdef DEBUG
 
 #ifdef PVR_PROC_USE_SEQ_FILE
@@ -1323,6 +1378,22 @@ IMG_VOID RemoveProcEntries(IMG_VOID)
 
 #endif
 
+#if defined(PVR_PROC_USE_SEQ_FILE) && defined(SUPPORT_CPU_CACHED_BUFFERS)
+#if LINUX_VERSION_CODE >= PATCH_SEQ_HANDLERS
+    RemoveProcEntrySeq(g_pProcCacheFlush, "cache_flush", g_pProcCacheFlushHandlers);
+#else
+    RemoveProcEntrySeq(g_pProcCacheFlush);
+#endif
+#endif
+
+#if defined(PVR_PROC_USE_SEQ_FILE) && defined(PVRSRV_METRICS)
+#if LINUX_VERSION_CODE >= PATCH_SEQ_HANDLERS
+    RemoveProcEntrySeq(g_pProcMetrics, "metrics", g_pProcMetricsHandlers);
+#else
+    RemoveProcEntrySeq(g_pProcMetrics);
+#endif
+#endif
+
 #ifdef PVR_PROC_USE_SEQ_FILE
 #if LINUX_VERSION_CODE >= PATCH_SEQ_HANDLERS
     RemoveProcEntrySeq(g_pProcQueue, "queue", g_pProcQueueHandlers);
@@ -1353,6 +1424,106 @@ IMG_VOID RemoveProcEntries(IMG_VOID)
 }
 
 
+#if defined(PVR_PROC_USE_SEQ_FILE) && defined(SUPPORT_CPU_CACHED_BUFFERS)
+
+static void ProcSeqShowCacheFlush(struct seq_file *sfile,void* el)
+{
+	PVRSRV_CACHE_FLUSH_STATS sStats;
+	IMG_UINT64 ui64BytesPerSec = 0;
+
+	PVR_UNREFERENCED_PARAMETER(el);
+
+	OSGetCPUCacheFlushStats(&sStats);
+
+	if (sStats.ui32ElapsedMs != 0)
+	{
+		ui64BytesPerSec = sStats.ui64RangeBytes * 1000;
+		do_div(ui64BytesPerSec, sStats.ui32ElapsedMs);
+	}
+
+	seq_printf(sfile,
+				"Full flushes:      %u\n"
+				"Range flushes:     %u\n"
+				"Async flushes:     %u\n"
+				"Range bytes:       %llu\n"
+				"Range bytes/sec:   %llu\n"
+				"Sample period ms:  %u\n",
+				sStats.ui32FullFlushes,
+				sStats.ui32RangeFlushes,
+				sStats.ui32AsyncFlushes,
+				(unsigned long long)sStats.ui64RangeBytes,
+				(unsigned long long)ui64BytesPerSec,
+				sStats.ui32ElapsedMs);
+}
+
+/* Any write resets the counters and restarts the sample period */
+static int ProcSetCacheFlush(struct file *file, const char __user *buffer, unsigned long count, void *data)
+{
+	PVR_UNREFERENCED_PARAMETER(file);
+	PVR_UNREFERENCED_PARAMETER(buffer);
+	PVR_UNREFERENCED_PARAMETER(data);
+
+	OSResetCPUCacheFlushStats();
+
+	return (int)count;
+}
+
+#endif
+
+#if defined(PVR_PROC_USE_SEQ_FILE) && defined(PVRSRV_METRICS)
+
+static void ProcSeqShowMetrics(struct seq_file *sfile,void* el)
+{
+	PVRSRV_METRIC_STATS sStats;
+	IMG_UINT32 ui32Timer, ui32Bucket;
+
+	PVR_UNREFERENCED_PARAMETER(el);
+
+	seq_printf(sfile, "# histogram bucket N counts samples < %u << N ns\n",
+				1U << PVRSRV_METRIC_BUCKET_SHIFT);
+
+	for (ui32Timer = 0; ui32Timer < PVRSRV_NUM_TIMERS; ui32Timer++)
+	{
+		IMG_UINT64 ui64AvgNs = 0;
+
+		PVRSRVGetMetricStats(ui32Timer, &sStats);
+
+		if (sStats.ui32Count != 0)
+		{
+			ui64AvgNs = sStats.ui64TotalNs;
+			do_div(ui64AvgNs, sStats.ui32Count);
+		}
+
+		seq_printf(sfile, "%-16s count %u total_ns %llu avg_ns %llu max_ns %llu\n",
+					PVRSRVMetricName(ui32Timer),
+					sStats.ui32Count,
+					(unsigned long long)sStats.ui64TotalNs,
+					(unsigned long long)ui64AvgNs,
+					(unsigned long long)sStats.ui64MaxNs);
+
+		seq_printf(sfile, "%-16s", "");
+		for (ui32Bucket = 0; ui32Bucket < PVRSRV_METRIC_BUCKETS; ui32Bucket++)
+		{
+			seq_printf(sfile, " %u", sStats.aui32Histogram[ui32Bucket]);
+		}
+		seq_printf(sfile, "\n");
+	}
+}
+
+/* Any write clears all timers */
+static int ProcSetMetrics(struct file *file, const char __user *buffer, unsigned long count, void *data)
+{
+	PVR_UNREFERENCED_PARAMETER(file);
+	PVR_UNREFERENCED_PARAMETER(buffer);
+	PVR_UNREFERENCED_PARAMETER(data);
+
+	PVRSRVResetMetrics();
+
+	return (int)count;
+}
+
+#endif
+
 #ifdef PVR_PROC_USE_SEQ_FILE
 
 static void ProcSeqShowVersion(struct seq_file *sfile,void* el)
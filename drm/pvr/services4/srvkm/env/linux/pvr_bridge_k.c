@@ -52,6 +52,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "private_data.h"
 #include "linkage.h"
 #include "pvr_bridge_km.h"
+#include "metrics.h"
 
 #if defined(SUPPORT_DRI_DRM)
 #include <drm/drmP.h>
@@ -327,6 +328,7 @@ PVRSRV_BridgeDispatchKM(struct file *pFile, IMG_UINT unref__ ioctlCmd, IMG_UINT3
 	IMG_UINT32 ui32PID = OSGetCurrentProcessIDKM();
 	PVRSRV_PER_PROCESS_DATA *psPerProc;
 	IMG_INT err = -EFAULT;
+	IMG_UINT64 ui64DispatchStart;
 
 	mutex_lock(&gPVRSRVLock);
 
@@ -509,19 +511,31 @@ PVRSRV_BridgeDispatchKM(struct file *pFile, IMG_UINT unref__ ioctlCmd, IMG_UINT3
 	}
 #endif
 
+	/*
+	 * The per-process data of the process that opened this connection
+	 * was cached in the file private data at open, so the common case
+	 * needs neither the PID hash nor a handle lookup.
+	 */
+	psPerProc = (PRIVATE_DATA(pFile) != IMG_NULL) ?
+		((PVRSRV_FILE_PRIVATE_DATA *)PRIVATE_DATA(pFile))->psPerProc : IMG_NULL;
+
 	if(cmd != PVRSRV_BRIDGE_CONNECT_SERVICES)
 	{
-		PVRSRV_ERROR eError;
-
-		eError = PVRSRVLookupHandle(KERNEL_HANDLE_BASE,
-									(IMG_PVOID *)&psPerProc,
-									psBridgePackageKM->hKernelServices,
-									PVRSRV_HANDLE_TYPE_PERPROC_DATA);
-		if(eError != PVRSRV_OK)
+		if(psPerProc == IMG_NULL ||
+		   psPerProc->hPerProcData != psBridgePackageKM->hKernelServices)
 		{
-			PVR_DPF((PVR_DBG_ERROR, "%s: Invalid kernel services handle (%d)",
-					 __FUNCTION__, eError));
-			goto unlock_and_return;
+			PVRSRV_ERROR eError;
+
+			eError = PVRSRVLookupHandle(KERNEL_HANDLE_BASE,
+										(IMG_PVOID *)&psPerProc,
+										psBridgePackageKM->hKernelServices,
+										PVRSRV_HANDLE_TYPE_PERPROC_DATA);
+			if(eError != PVRSRV_OK)
+			{
+				PVR_DPF((PVR_DBG_ERROR, "%s: Invalid kernel services handle (%d)",
+						 __FUNCTION__, eError));
+				goto unlock_and_return;
+			}
 		}
 
 		if(psPerProc->ui32PID != ui32PID)
@@ -534,8 +548,14 @@ PVRSRV_BridgeDispatchKM(struct file *pFile, IMG_UINT unref__ ioctlCmd, IMG_UINT3
 	}
 	else
 	{
-		/* lookup per-process data for this process */
-		psPerProc = PVRSRVPerProcessData(ui32PID);
+		if(psPerProc == IMG_NULL || psPerProc->ui32PID != ui32PID)
+		{
+			/*
+			 * Connection inherited across fork(): fall back to the
+			 * per-process data for the calling process.
+			 */
+			psPerProc = PVRSRVPerProcessData(ui32PID);
+		}
 		if(psPerProc == IMG_NULL)
 		{
 			PVR_DPF((PVR_DBG_ERROR, "PVRSRV_BridgeDispatchKM: "
@@ -652,7 +672,9 @@ PVRSRV_BridgeDispatchKM(struct file *pFile, IMG_UINT unref__ ioctlCmd, IMG_UINT3
 	}
 #endif
 
+	PVRSRV_TIME_START(ui64DispatchStart);
 	err = BridgedDispatchKM(psPerProc, psBridgePackageKM);
+	PVRSRV_TIME_STOP(PVRSRV_TIMER_BRIDGE_DISPATCH, ui64DispatchStart);
 	if(err != PVRSRV_OK)
 		goto unlock_and_return;
 
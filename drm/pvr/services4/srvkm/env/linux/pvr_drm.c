@@ -71,6 +71,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "linkage.h"
 #include "pvr_drm_shared.h"
 #include "pvr_drm.h"
+#include "private_data.h"
+#include "lock.h"
+#include "event.h"
 
 #define	MAKENAME_HELPER(x, y) x ## y
 #define	MAKENAME(x, y) MAKENAME_HELPER(x, y)
@@ -217,6 +220,65 @@ PVRDRMPCIBusIDField(struct drm_device *dev, IMG_UINT32 *pui32Field, IMG_UINT32 u
 	return 0;
 }
 
+/*
+ * Create a pollable fence fd for a sync object of the calling process.
+ * The fence becomes readable when the operations pending on the sync
+ * object at creation time have completed.
+ */
+static IMG_INT
+PVRDRMSyncFence(struct drm_file *pFile, IMG_UINT32 *pui32Fd, IMG_UINT32 ui32SyncInfoHandle)
+{
+	PVRSRV_FILE_PRIVATE_DATA *psPrivateData = pFile->driver_priv;
+	PVRSRV_PER_PROCESS_DATA *psPerProc;
+	PVRSRV_KERNEL_SYNC_INFO *psSyncInfo;
+	SYS_DATA *psSysData;
+	IMG_INT iFd;
+	IMG_INT iRet = -EINVAL;
+
+	mutex_lock(&gPVRSRVLock);
+
+	if (psPrivateData == IMG_NULL || psPrivateData->psPerProc == IMG_NULL)
+	{
+		goto unlock_and_return;
+	}
+	psPerProc = psPrivateData->psPerProc;
+
+	if (psPerProc->ui32PID != OSGetCurrentProcessIDKM())
+	{
+		iRet = -EPERM;
+		goto unlock_and_return;
+	}
+
+	SysAcquireData(&psSysData);
+	if (psSysData->psGlobalEventObject == IMG_NULL)
+	{
+		goto unlock_and_return;
+	}
+
+	if (PVRSRVLookupHandle(psPerProc->psHandleBase,
+						   (IMG_PVOID *)&psSyncInfo,
+						   (IMG_HANDLE)(IMG_UINTPTR_T)ui32SyncInfoHandle,
+						   PVRSRV_HANDLE_TYPE_SYNC_INFO) != PVRSRV_OK)
+	{
+		goto unlock_and_return;
+	}
+
+	if (LinuxSyncFenceCreate(psSysData->psGlobalEventObject->hOSEventKM,
+							 psPerProc->hResManContext,
+							 psSyncInfo, &iFd) != PVRSRV_OK)
+	{
+		iRet = -ENOMEM;
+		goto unlock_and_return;
+	}
+
+	*pui32Fd = (IMG_UINT32)iFd;
+	iRet = 0;
+
+unlock_and_return:
+	mutex_unlock(&gPVRSRVLock);
+	return iRet;
+}
+
 DRI_DRM_STATIC IMG_INT
 PVRDRMUnprivCmd(struct drm_device *dev, IMG_VOID *arg, struct drm_file *pFile)
 {
@@ -238,6 +300,9 @@ PVRDRMUnprivCmd(struct drm_device *dev, IMG_VOID *arg, struct drm_file *pFile)
 		case PVR_DRM_UNPRIV_BUSID_FIELD:
 			return PVRDRMPCIBusIDField(dev, pui32OutArg, ui32Arg1);
 
+		case PVR_DRM_UNPRIV_SYNC_FENCE:
+			return PVRDRMSyncFence(pFile, pui32OutArg, ui32Arg1);
+
 		default:
 			return -EFAULT;
 	}
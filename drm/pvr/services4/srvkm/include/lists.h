@@ -303,6 +303,41 @@ IMG_VOID List_##TYPE##_Reverse(TYPE **ppsHead)\
 
 #define IS_LAST_ELEMENT(x) ((x)->psNext == IMG_NULL)
 
+/*!
+******************************************************************************
+    @Function       LIST_FOR_EACH
+
+    @Description    Typed loop over all the elements of a list.  Unlike the
+                    ForEach and Any functions above the loop body is written
+                    in place, so there is no call through a function pointer
+                    and no va_list to re-parse for every element, and the
+                    compiler can inline the work done per node.  An Any
+                    style search is written as a loop that breaks out on a
+                    match.
+
+    @Input          psNode - loop variable, of the list element pointer type.
+    @Input          psHead - the head of the list to be processed.
+******************************************************************************/
+#define LIST_FOR_EACH(psNode, psHead) \
+	for ((psNode) = (psHead); (psNode) != IMG_NULL; (psNode) = (psNode)->psNext)
+
+/*!
+******************************************************************************
+    @Function       LIST_FOR_EACH_SAFE
+
+    @Description    As LIST_FOR_EACH, but the next element is fetched before
+                    the loop body runs, so the body may remove or free the
+                    current node.
+
+    @Input          psNode - loop variable, of the list element pointer type.
+    @Input          psNextNode - temporary of the same type.
+    @Input          psHead - the head of the list to be processed.
+******************************************************************************/
+#define LIST_FOR_EACH_SAFE(psNode, psNextNode, psHead) \
+	for ((psNode) = (psHead); \
+		 ((psNode) != IMG_NULL) && (((psNextNode) = (psNode)->psNext), IMG_TRUE); \
+		 (psNode) = (psNextNode))
+
 #endif
 
 /* re-enable warnings */
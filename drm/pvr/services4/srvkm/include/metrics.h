@@ -48,91 +48,71 @@ extern "C" {
 #endif
 
 
-#if defined(DEBUG) || defined(TIMING)
-
-
-typedef struct
-{
-	IMG_UINT32 ui32Start;
-	IMG_UINT32 ui32Stop;
-	IMG_UINT32 ui32Total;
-	IMG_UINT32 ui32Count;
-} Temporal_Data;
-
-extern Temporal_Data asTimers[];
-
-extern IMG_UINT32 PVRSRVTimeNow(IMG_VOID);
-extern IMG_VOID   PVRSRVSetupMetricTimers(IMG_VOID *pvDevInfo);
-extern IMG_VOID   PVRSRVOutputMetricTotals(IMG_VOID);
-
-
-#define PVRSRV_TIMER_DUMMY				0
-
-#define PVRSRV_TIMER_EXAMPLE_1			1
-#define PVRSRV_TIMER_EXAMPLE_2			2
-
-
-#define PVRSRV_NUM_TIMERS		(PVRSRV_TIMER_EXAMPLE_2 + 1)
-
-#define PVRSRV_TIME_START(X)	{ \
-									asTimers[X].ui32Count += 1; \
-									asTimers[X].ui32Count |= 0x80000000L; \
-									asTimers[X].ui32Start = PVRSRVTimeNow(); \
-									asTimers[X].ui32Stop  = 0; \
-								}
-
-#define PVRSRV_TIME_SUSPEND(X)	{ \
-									asTimers[X].ui32Stop += PVRSRVTimeNow() - asTimers[X].ui32Start; \
-								}
-
-#define PVRSRV_TIME_RESUME(X)	{ \
-									asTimers[X].ui32Start = PVRSRVTimeNow(); \
-								}
-
-#define PVRSRV_TIME_STOP(X)		{ \
-									asTimers[X].ui32Stop  += PVRSRVTimeNow() - asTimers[X].ui32Start; \
-									asTimers[X].ui32Total += asTimers[X].ui32Stop; \
-									asTimers[X].ui32Count &= 0x7FFFFFFFL; \
-								}
-
-#define PVRSRV_TIME_RESET(X)	{ \
-									asTimers[X].ui32Start = 0; \
-									asTimers[X].ui32Stop  = 0; \
-									asTimers[X].ui32Total = 0; \
-									asTimers[X].ui32Count = 0; \
-								}
-
+/* Debug and timing builds always carry the metrics */
+#if (defined(DEBUG) || defined(TIMING)) && !defined(PVRSRV_METRICS)
+#define PVRSRV_METRICS
+#endif
 
-#if defined(__sh__)
+#if defined(PVRSRV_METRICS)
 
-#define TST_REG   ((volatile IMG_UINT8 *) (psDevInfo->pvSOCRegsBaseKM)) 	// timer start register
 
-#define TCOR_2    ((volatile IMG_UINT *)  (psDevInfo->pvSOCRegsBaseKM+28))	// timer constant register_2
-#define TCNT_2    ((volatile IMG_UINT *)  (psDevInfo->pvSOCRegsBaseKM+32))	// timer counter register_2
-#define TCR_2     ((volatile IMG_UINT16 *)(psDevInfo->pvSOCRegsBaseKM+36))	// timer control register_2
+#define PVRSRV_TIMER_BRIDGE_DISPATCH	0
+#define PVRSRV_TIMER_SGX_KICK			1
+#define PVRSRV_TIMER_MMU_MAP			2
+#define PVRSRV_TIMER_DC_FLIP			3
 
-#define TIMER_DIVISOR  4
+#define PVRSRV_NUM_TIMERS		(PVRSRV_TIMER_DC_FLIP + 1)
 
-#endif /* defined(__sh__) */
+/*
+ * Histogram bucket N counts samples shorter than 1024 << N ns (roughly
+ * 2^N us); the last bucket also takes everything longer.
+ */
+#define PVRSRV_METRIC_BUCKETS			16
+#define PVRSRV_METRIC_BUCKET_SHIFT		10
 
+typedef struct _PVRSRV_METRIC_STATS_
+{
+	IMG_UINT32	ui32Count;
+	IMG_UINT64	ui64TotalNs;
+	IMG_UINT64	ui64MaxNs;
+	IMG_UINT32	aui32Histogram[PVRSRV_METRIC_BUCKETS];
+} PVRSRV_METRIC_STATS;
+
+extern IMG_UINT64 PVRSRVTimeNow(IMG_VOID);
+extern IMG_VOID   PVRSRVMetricRecord(IMG_UINT32 ui32Timer, IMG_UINT64 ui64StartNs);
+extern IMG_VOID   PVRSRVGetMetricStats(IMG_UINT32 ui32Timer, PVRSRV_METRIC_STATS *psStats);
+extern const IMG_CHAR *PVRSRVMetricName(IMG_UINT32 ui32Timer);
+extern IMG_VOID   PVRSRVResetMetrics(IMG_VOID);
+extern IMG_VOID   PVRSRVSetupMetricTimers(IMG_VOID *pvDevInfo);
+extern IMG_VOID   PVRSRVOutputMetricTotals(IMG_VOID);
 
+/*
+ * The start time lives in a caller local, so the same timer may be running
+ * in any number of threads at once:
+ *
+ *	IMG_UINT64 ui64Start;
+ *
+ *	PVRSRV_TIME_START(ui64Start);
+ *	...
+ *	PVRSRV_TIME_STOP(PVRSRV_TIMER_SGX_KICK, ui64Start);
+ */
+#define PVRSRV_TIME_START(S)	((S) = PVRSRVTimeNow())
+#define PVRSRV_TIME_STOP(X, S)	PVRSRVMetricRecord((X), (S))
+#define PVRSRV_TIME_RESET()		PVRSRVResetMetrics()
 
-#else /* defined(DEBUG) || defined(TIMING) */
 
+#else /* defined(PVRSRV_METRICS) */
 
 
-#define PVRSRV_TIME_START(X)
-#define PVRSRV_TIME_SUSPEND(X)
-#define PVRSRV_TIME_RESUME(X)
-#define PVRSRV_TIME_STOP(X)
-#define PVRSRV_TIME_RESET(X)
+#define PVRSRV_TIME_START(S)	((S) = 0)
+#define PVRSRV_TIME_STOP(X, S)	PVR_UNREFERENCED_PARAMETER(S)
+#define PVRSRV_TIME_RESET()
 
 #define PVRSRVSetupMetricTimers(X)
 #define PVRSRVOutputMetricTotals()
 
 
-
-#endif /* defined(DEBUG) || defined(TIMING) */
+#endif /* defined(PVRSRV_METRICS) */
 
 #if defined(__cplusplus)
 }
@@ -80,6 +80,7 @@ extern "C" {
 
 
 IMG_UINT32 OSClockus(IMG_VOID);
+IMG_UINT64 OSClockns64(IMG_VOID);
 IMG_SIZE_T OSGetPageSize(IMG_VOID);
 PVRSRV_ERROR OSInstallDeviceLISR(IMG_VOID *pvSysData,
 								 IMG_UINT32 ui32Irq,
@@ -99,9 +100,40 @@ PVRSRV_ERROR OSReservePhys(IMG_CPU_PHYADDR BasePAddr, IMG_SIZE_T ui32Bytes, IMG_
 PVRSRV_ERROR OSUnReservePhys(IMG_VOID *pvCpuVAddr, IMG_SIZE_T ui32Bytes, IMG_UINT32 ui32Flags, IMG_HANDLE hOSMemHandle);
 
 #if defined(SUPPORT_CPU_CACHED_BUFFERS)
+/*
+ * Above this many bytes a single wbinvd on each CPU is cheaper than walking
+ * the ranges a cache line at a time with clflush.  Only x86 flushes ranges;
+ * elsewhere every ranged flush is a full flush.
+ */
+#if !defined(PVR_CACHE_FLUSH_RANGE_THRESHOLD)
+#define PVR_CACHE_FLUSH_RANGE_THRESHOLD		(512 * 1024)
+#endif
+
+typedef struct _PVRSRV_CACHE_RANGE_
+{
+	IMG_VOID	*pvStart;
+	IMG_VOID	*pvEnd;
+} PVRSRV_CACHE_RANGE;
+
+typedef struct _PVRSRV_CACHE_FLUSH_STATS_
+{
+	IMG_UINT32	ui32FullFlushes;
+	IMG_UINT32	ui32RangeFlushes;
+	IMG_UINT32	ui32AsyncFlushes;
+	IMG_UINT64	ui64RangeBytes;
+	IMG_UINT32	ui32ElapsedMs;
+} PVRSRV_CACHE_FLUSH_STATS;
+
 IMG_VOID OSFlushCPUCacheKM(IMG_VOID);
 IMG_VOID OSFlushCPUCacheRangeKM(IMG_VOID *pvRangeAddrStart,
 						 	IMG_VOID *pvRangeAddrEnd);
+IMG_VOID OSFlushCPUCacheRangesKM(PVRSRV_CACHE_RANGE *psRanges,
+								 IMG_UINT32 ui32NumRanges);
+IMG_UINT32 OSFlushCPUCacheAsyncKM(IMG_VOID);
+IMG_BOOL OSCPUCacheFlushCompleteKM(IMG_UINT32 ui32Fence);
+IMG_VOID OSWaitCPUCacheFlushKM(IMG_UINT32 ui32Fence);
+IMG_VOID OSGetCPUCacheFlushStats(PVRSRV_CACHE_FLUSH_STATS *psStats);
+IMG_VOID OSResetCPUCacheFlushStats(IMG_VOID);
 #endif
 
 #if defined(__linux__)
@@ -374,6 +406,7 @@ PVRSRV_ERROR OSEventObjectCreate(const IMG_CHAR *pszName,
 PVRSRV_ERROR OSEventObjectDestroy(PVRSRV_EVENTOBJECT *psEventObject);
 PVRSRV_ERROR OSEventObjectSignal(IMG_HANDLE hOSEventKM);
 PVRSRV_ERROR OSEventObjectWait(IMG_HANDLE hOSEventKM);
+PVRSRV_ERROR OSEventObjectWaitSync(IMG_HANDLE hOSEventKM, IMG_HANDLE hKernelSyncInfo);
 PVRSRV_ERROR OSEventObjectOpen(PVRSRV_EVENTOBJECT *psEventObject,
 											IMG_HANDLE *phOSEvent);
 PVRSRV_ERROR OSEventObjectClose(PVRSRV_EVENTOBJECT *psEventObject,
@@ -409,6 +442,8 @@ PVRSRV_ERROR OSDestroyResource(PVRSRV_RESOURCE *psResource);
 IMG_VOID OSBreakResourceLock(PVRSRV_RESOURCE *psResource, IMG_UINT32 ui32ID);
 IMG_VOID OSWaitus(IMG_UINT32 ui32Timeus);
 IMG_VOID OSReleaseThreadQuanta(IMG_VOID);
+PVRSRV_ERROR OSScheduleProcessTeardown(IMG_HANDLE hPerProc);
+IMG_VOID OSFlushProcessTeardown(IMG_VOID);
 IMG_UINT32 OSPCIReadDword(IMG_UINT32 ui32Bus, IMG_UINT32 ui32Dev, IMG_UINT32 ui32Func, IMG_UINT32 ui32Reg);
 IMG_VOID OSPCIWriteDword(IMG_UINT32 ui32Bus, IMG_UINT32 ui32Dev, IMG_UINT32 ui32Func, IMG_UINT32 ui32Reg, IMG_UINT32 ui32Value);
 
@@ -0,0 +1,74 @@
+/*************************************************************************/ /*!
+@Title          PDump stream compression
+@Copyright      Copyright (c) Imagination Technologies Ltd. All Rights Reserved
+@Description    Encoder for PDUMP_COMPRESS captures
+@License        Dual MIT/GPLv2
+
+The contents of this file are subject to the MIT license as set out below.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+Alternatively, the contents of this file may be used under the terms of
+the GNU General Public License Version 2 ("GPL") in which case the provisions
+of GPL are applicable instead of those above.
+
+If you wish to allow use of your version of this file only under the terms of
+GPL, and not to allow others to use your version of this file under the terms
+of the MIT license, indicate your decision by deleting the provisions above
+and replace them with the notice and other provisions required by GPL as set
+out in the file called "GPL-COPYING" included in this distribution. If you do
+not delete the provisions above, a recipient may use your version of this file
+under the terms of either the MIT license or GPL.
+
+This License is also included in this distribution in the file called
+"MIT-COPYING".
+
+EXCEPT AS OTHERWISE STATED IN A NEGOTIATED AGREEMENT: (A) THE SOFTWARE IS
+PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT; AND (B) IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/ /**************************************************************************/
+
+#ifndef _PDUMP_COMPRESS_KM_H_
+#define _PDUMP_COMPRESS_KM_H_
+
+#include "pdump_compress.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/* Stream offset to pass for data that must never be deduplicated */
+#define PDUMP_COMP_NO_OFFSET		0xFFFFFFFFUL
+
+typedef struct _PDUMP_COMP_CTX_ PDUMP_COMP_CTX;
+
+PVRSRV_ERROR PDumpCompCreate(IMG_BOOL bDedup, PDUMP_COMP_CTX **ppsCtx);
+IMG_VOID PDumpCompDestroy(PDUMP_COMP_CTX *psCtx);
+
+IMG_UINT32 PDumpCompPending(PDUMP_COMP_CTX *psCtx);
+IMG_BOOL PDumpCompAdd(PDUMP_COMP_CTX *psCtx, IMG_UINT8 *pui8Data, IMG_UINT32 ui32Count, IMG_UINT32 ui32Offset);
+IMG_UINT8 *PDumpCompFinish(PDUMP_COMP_CTX *psCtx, IMG_UINT32 *pui32Size, IMG_UINT32 *pui32Decoded);
+IMG_VOID PDumpCompCommit(PDUMP_COMP_CTX *psCtx, IMG_BOOL bWritten);
+IMG_VOID PDumpCompInvalidate(PDUMP_COMP_CTX *psCtx, IMG_UINT32 ui32Offset);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _PDUMP_COMPRESS_KM_H_ */
+
+/******************************************************************************
+ End of file (pdump_compress_km.h)
+******************************************************************************/
@@ -75,6 +75,9 @@ PVRSRV_PER_PROCESS_DATA *PVRSRVPerProcessData(IMG_UINT32 ui32PID);
 
 PVRSRV_ERROR PVRSRVPerProcessDataConnect(IMG_UINT32	ui32PID);
 IMG_VOID PVRSRVPerProcessDataDisconnect(IMG_UINT32	ui32PID);
+IMG_BOOL PVRSRVPerProcessDataTeardown(PVRSRV_PER_PROCESS_DATA *psPerProc,
+									  IMG_UINT32 ui32MaxResources);
+PVRSRV_PER_PROCESS_DATA *PVRSRVTerminatingPerProcessData(IMG_VOID);
 
 PVRSRV_ERROR PVRSRVPerProcessDataInit(IMG_VOID);
 PVRSRV_ERROR PVRSRVPerProcessDataDeInit(IMG_VOID);
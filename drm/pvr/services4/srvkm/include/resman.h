@@ -82,6 +82,7 @@ enum {
 	RESMAN_TYPE_EVENT_OBJECT,
     RESMAN_TYPE_SHARED_MEM_INFO,
     RESMAN_TYPE_MODIFY_SYNC_OPS,
+	RESMAN_TYPE_SYNC_FENCE,
 
 
 	RESMAN_TYPE_KERNEL_DEVICEMEM_ALLOCATION
@@ -136,6 +137,8 @@ PVRSRV_ERROR PVRSRVResManConnect(IMG_HANDLE			hPerProc,
 								 PRESMAN_CONTEXT	*phResManContext);
 IMG_VOID PVRSRVResManDisconnect(PRESMAN_CONTEXT hResManContext,
 								IMG_BOOL		bKernelContext);
+IMG_BOOL PVRSRVResManFreeChunk(PRESMAN_CONTEXT hResManContext,
+							   IMG_UINT32		ui32MaxItems);
 
 #if defined (__cplusplus)
 }
@@ -84,6 +84,7 @@ typedef struct _SYS_DATA_TAG_
 	PVRSRV_EVENTOBJECT		*psGlobalEventObject;
 
 	IMG_BOOL				bFlushAll;
+	IMG_UINT32				ui32FlushAllFence;
 
 } SYS_DATA;
 
@@ -88,8 +88,6 @@ extern IMG_BOOL			g_bHotKeyRegistered;
 IMG_BOOL				gbDumpThisFrame = IMG_FALSE;
 
 
-IMG_UINT32 SpaceInStream(PDBG_STREAM psStream);
-IMG_BOOL ExpandStreamBuffer(PDBG_STREAM psStream, IMG_UINT32 ui32NewSize);
 PDBG_LASTFRAME_BUFFER FindLFBuf(PDBG_STREAM psStream);
 
 /***************************************************************************
@@ -191,14 +189,9 @@ IMG_UINT32 IMG_CALLCONV ExtDBGDrivWriteString(PDBG_STREAM psStream,IMG_CHAR * ps
 {
 	IMG_UINT32	ui32Ret;
 
-	/* Aquire API Mutex */
-	HostAquireMutex(g_pvAPIMutex);
-
+	/* Stream data is written and read without the API mutex */
 	ui32Ret=DBGDrivWriteString(psStream, pszString, ui32Level);
 
-	/* Release API Mutex */
-	HostReleaseMutex(g_pvAPIMutex);
-
 	return ui32Ret;
 }
 
@@ -209,14 +202,9 @@ IMG_UINT32 IMG_CALLCONV ExtDBGDrivReadString(PDBG_STREAM psStream,IMG_CHAR * psz
 {
 	IMG_UINT32 ui32Ret;
 
-	/* Aquire API Mutex */
-	HostAquireMutex(g_pvAPIMutex);
-
+	/* Stream data is written and read without the API mutex */
 	ui32Ret=DBGDrivReadString(psStream, pszString, ui32Limit);
 
-	/* Release API Mutex */
-	HostReleaseMutex(g_pvAPIMutex);
-
 	return ui32Ret;
 }
 
@@ -227,14 +215,9 @@ IMG_UINT32 IMG_CALLCONV ExtDBGDrivWrite(PDBG_STREAM psStream,IMG_UINT8 * pui8InB
 {
 	IMG_UINT32	ui32Ret;
 
-	/* Aquire API Mutex */
-	HostAquireMutex(g_pvAPIMutex);
-
+	/* Stream data is written and read without the API mutex */
 	ui32Ret=DBGDrivWrite(psStream, pui8InBuf, ui32InBuffSize, ui32Level);
 
-	/* Release API Mutex */
-	HostReleaseMutex(g_pvAPIMutex);
-
 	return ui32Ret;
 }
 
@@ -245,15 +228,49 @@ IMG_UINT32 IMG_CALLCONV ExtDBGDrivRead(PDBG_STREAM psStream, IMG_BOOL bReadInitB
 {
 	IMG_UINT32 ui32Ret;
 
+	/* Stream data is written and read without the API mutex */
+	ui32Ret=DBGDrivRead(psStream, bReadInitBuffer, ui32OutBuffSize, pui8OutBuf);
+
+	return ui32Ret;
+}
+
+/*!
+ @name	ExtDBGDrivAcquireRead
+ */
+IMG_UINT32 IMG_CALLCONV ExtDBGDrivAcquireRead(PDBG_STREAM psStream, IMG_BOOL bReadInitBuffer, IMG_UINT32 ui32Limit, IMG_UINT32 *pui32Offset)
+{
+	/* Stream data is written and read without the API mutex */
+	return DBGDrivAcquireRead(psStream, bReadInitBuffer, ui32Limit, pui32Offset);
+}
+
+/*!
+ @name	ExtDBGDrivReleaseRead
+ */
+IMG_BOOL IMG_CALLCONV ExtDBGDrivReleaseRead(PDBG_STREAM psStream, IMG_BOOL bReadInitBuffer, IMG_UINT32 ui32Offset, IMG_UINT32 ui32Len)
+{
+	return DBGDrivReleaseRead(psStream, bReadInitBuffer, ui32Offset, ui32Len);
+}
+
+/*!
+ @name	ExtDBGDrivMapStream
+ */
+IMG_INT32 IMG_CALLCONV ExtDBGDrivMapStream(PDBG_STREAM psStream, IMG_BOOL bReadInitBuffer, IMG_UINT32 *pui32Size)
+{
+	IMG_INT32 i32Fd = -1;
+
 	/* Aquire API Mutex */
 	HostAquireMutex(g_pvAPIMutex);
 
-	ui32Ret=DBGDrivRead(psStream, bReadInitBuffer, ui32OutBuffSize, pui8OutBuf);
+	if (StreamValid(psStream))
+	{
+		*pui32Size = bReadInitBuffer ? psStream->psInitStream->ui32Size : psStream->ui32Size;
+		i32Fd = HostMapStream(psStream, bReadInitBuffer);
+	}
 
 	/* Release API Mutex */
 	HostReleaseMutex(g_pvAPIMutex);
 
-	return ui32Ret;
+	return i32Fd;
 }
 
 /*!
@@ -413,14 +430,9 @@ IMG_UINT32 IMG_CALLCONV ExtDBGDrivWrite2(PDBG_STREAM psStream,IMG_UINT8 * pui8In
 {
 	IMG_UINT32	ui32Ret;
 
-	/* Aquire API Mutex */
-	HostAquireMutex(g_pvAPIMutex);
-
+	/* Stream data is written and read without the API mutex */
 	ui32Ret=DBGDrivWrite2(psStream, pui8InBuf, ui32InBuffSize, ui32Level);
 
-
-	HostReleaseMutex(g_pvAPIMutex);
-
 	return ui32Ret;
 }
 
@@ -431,14 +443,9 @@ IMG_UINT32 IMG_CALLCONV ExtDBGDrivWriteStringCM(PDBG_STREAM psStream,IMG_CHAR *
 {
 	IMG_UINT32	ui32Ret;
 
-	/* Aquire API Mutex */
-	HostAquireMutex(g_pvAPIMutex);
-
+	/* Stream data is written and read without the API mutex */
 	ui32Ret=DBGDrivWriteStringCM(psStream, pszString, ui32Level);
 
-	/* Release API Mutex */
-	HostReleaseMutex(g_pvAPIMutex);
-
 	return ui32Ret;
 }
 
@@ -448,15 +455,10 @@ IMG_UINT32 IMG_CALLCONV ExtDBGDrivWriteStringCM(PDBG_STREAM psStream,IMG_CHAR *
 IMG_UINT32 IMG_CALLCONV ExtDBGDrivWriteCM(PDBG_STREAM psStream,IMG_UINT8 * pui8InBuf,IMG_UINT32 ui32InBuffSize,IMG_UINT32 ui32Level)
 {
 	IMG_UINT32	ui32Ret;
-	
-	/* Aquire API Mutex */
-	HostAquireMutex(g_pvAPIMutex);
-	
+
+	/* Stream data is written and read without the API mutex */
 	ui32Ret=DBGDrivWriteCM(psStream, pui8InBuf, ui32InBuffSize, ui32Level);
-	
-	/* Release API Mutex */
-	HostReleaseMutex(g_pvAPIMutex);
-	
+
 	return ui32Ret;
 }
 
@@ -703,43 +705,398 @@ IMG_BOOL StreamValid(PDBG_STREAM psStream)
 }
 
 
-void Write(PDBG_STREAM psStream,IMG_UINT8 * pui8Data,IMG_UINT32 ui32InBuffSize)
+/*
+	Stream ring protocol.
+
+	Writers do not take the API mutex. Each one reserves space by moving
+	ui32Reserve forward with a compare-and-swap, copies its data without
+	holding anything and then publishes it by moving ui32WPtr, in
+	reservation order. A writer waiting for an earlier reservation to be
+	committed yields the CPU rather than spinning, as the earlier writer
+	may have been preempted part way through its copy.
+
+	The reader only consumes [ui32RPtr, ui32WPtr) and releases space by
+	moving ui32RPtr with a compare-and-swap. A writer using the drop oldest
+	policy moves ui32RPtr the same way, so a reader that loses that race
+	throws its copy away and reads again.
+
+	The buffer is never reallocated. A writer that finds the stream full
+	applies the stream's overflow policy instead:
+
+	DEBUG_FLAGS_OVERFLOW_DROP_OLDEST	discard the oldest committed records
+	DEBUG_FLAGS_NO_BUF_EXPANDSION		truncate or drop the new data
+	otherwise							wait once for the reader to drain
+										the stream, then truncate
+
+	A drop oldest stream holds nothing but records: every write, not just
+	DBGDrivWrite, is stored behind a 4 byte length, and ui32RPtr only ever
+	moves from one record boundary to another. Writers drop whole records
+	and the readers consume whole records, so the stream cannot be left
+	pointing into the middle of one. If a length is ever found to run past
+	ui32WPtr the stream resyncs by discarding everything committed.
+*/
+#define DBG_STREAM_SLACK	4
+#define DBG_RECORD_HEADER	4
+#define DBG_RECORD_BAD		0xFFFFFFFFUL
+
+#define StreamIsFramed(psStream)	(((psStream)->ui32Flags & DEBUG_FLAGS_OVERFLOW_DROP_OLDEST) != 0)
+
+static IMG_UINT32 StreamUsed(PDBG_STREAM psStream, IMG_UINT32 ui32From, IMG_UINT32 ui32To)
 {
+	if (ui32From <= ui32To)
+	{
+		return ui32To - ui32From;
+	}
 
+	return ui32To + (psStream->ui32Size - ui32From);
+}
+
+static IMG_VOID AtomicAdd(IMG_UINT32 *pui32Addr, IMG_UINT32 ui32Value)
+{
+	IMG_UINT32 ui32Old;
 
-	if ((psStream->ui32WPtr + ui32InBuffSize) > psStream->ui32Size)
+	do
 	{
-		/* Yes we need two bits, calculate their sizes */
-		IMG_UINT32 ui32B1 = psStream->ui32Size - psStream->ui32WPtr;
-		IMG_UINT32 ui32B2 = ui32InBuffSize - ui32B1;
+		ui32Old = *(volatile IMG_UINT32 *)pui32Addr;
+	} while (HostAtomicCmpXchg(pui32Addr, ui32Old, ui32Old + ui32Value) != ui32Old);
+}
+
+static IMG_VOID StreamDropped(PDBG_STREAM psStream, IMG_UINT32 ui32Bytes)
+{
+	if (psStream->ui32DataDropped == 0)
+	{
+		PVR_DPF((PVR_DBG_WARNING, "DBGDriv: Stream %s overflowed, dropping data", psStream->szName));
+	}
 
+	AtomicAdd(&psStream->ui32DataDropped, ui32Bytes);
+}
 
-		HostMemCopy((IMG_VOID *)(psStream->ui32Base + psStream->ui32WPtr),
-				(IMG_VOID *) pui8Data,
-				ui32B1);
+/*!****************************************************************************
+ @name		ReadFromStream
+ @brief		Copy data out of a stream, wrapping as needed
+ @param		psStream - stream
+ @param		ui32Offset - offset in the stream buffer
+ @param		pui8Data - destination
+ @param		ui32Len - bytes to copy
+ @return	none
+*****************************************************************************/
+static IMG_VOID ReadFromStream(PDBG_STREAM psStream, IMG_UINT32 ui32Offset, IMG_UINT8 *pui8Data, IMG_UINT32 ui32Len)
+{
+	if ((ui32Offset + ui32Len) > psStream->ui32Size)
+	{
+		IMG_UINT32 ui32B1 = psStream->ui32Size - ui32Offset;
+		IMG_UINT32 ui32B2 = ui32Len - ui32B1;
 
+		HostMemCopy((IMG_VOID *) pui8Data,
+				(IMG_VOID *)(psStream->ui32Base + ui32Offset),
+				ui32B1);
 
-		HostMemCopy((IMG_VOID *)psStream->ui32Base,
-				(IMG_VOID *)((IMG_UINT32) pui8Data + ui32B1),
+		HostMemCopy((IMG_VOID *)(pui8Data + ui32B1),
+				(IMG_VOID *)psStream->ui32Base,
 				ui32B2);
+	}
+	else
+	{
+		HostMemCopy((IMG_VOID *) pui8Data,
+				(IMG_VOID *)(psStream->ui32Base + ui32Offset),
+				ui32Len);
+	}
+}
+
+/*!****************************************************************************
+ @name		RecordSpan
+ @brief		Measure whole records of a drop oldest stream, starting at a
+ 			record boundary
+ @param		psStream - stream
+ @param		ui32RPtr - record boundary to start from
+ @param		ui32Avail - committed bytes following ui32RPtr
+ @param		ui32Want - stop once at least this many bytes are spanned
+ @param		ui32Limit - never span more than this many bytes
+ @return	bytes spanned, DBG_RECORD_BAD if a length runs past ui32Avail
+*****************************************************************************/
+static IMG_UINT32 RecordSpan(PDBG_STREAM psStream, IMG_UINT32 ui32RPtr, IMG_UINT32 ui32Avail,
+							 IMG_UINT32 ui32Want, IMG_UINT32 ui32Limit)
+{
+	IMG_UINT32 ui32Span = 0;
+	IMG_UINT32 ui32Record;
+
+	while ((ui32Span < ui32Want) && (ui32Span < ui32Avail))
+	{
+		if ((ui32Avail - ui32Span) < DBG_RECORD_HEADER)
+		{
+			return DBG_RECORD_BAD;
+		}
+
+		ui32Record = 0;
+		ReadFromStream(psStream, (ui32RPtr + ui32Span) % psStream->ui32Size,
+					   (IMG_UINT8 *) &ui32Record, DBG_RECORD_HEADER);
 
+		if (ui32Record > (ui32Avail - ui32Span - DBG_RECORD_HEADER))
+		{
+			return DBG_RECORD_BAD;
+		}
+
+		ui32Record += DBG_RECORD_HEADER;
+		if ((ui32Span + ui32Record) > ui32Limit)
+		{
+			break;
+		}
 
-		psStream->ui32WPtr = ui32B2;
+		ui32Span += ui32Record;
 	}
-	else
+
+	return ui32Span;
+}
+
+/*!****************************************************************************
+ @name		DropRecords
+ @brief		Discard committed records from the tail of a drop oldest stream
+ @param		psStream - stream
+ @param		ui32RPtr - ui32RPtr as last read by the caller
+ @param		ui32WPtr - ui32WPtr as last read by the caller
+ @param		ui32Bytes - bytes to discard, rounded up to whole records
+ @return	none; the caller re-reads the pointers either way
+*****************************************************************************/
+static IMG_VOID DropRecords(PDBG_STREAM psStream, IMG_UINT32 ui32RPtr, IMG_UINT32 ui32WPtr, IMG_UINT32 ui32Bytes)
+{
+	IMG_UINT32 ui32Avail = StreamUsed(psStream, ui32RPtr, ui32WPtr);
+	IMG_UINT32 ui32Drop;
+	IMG_BOOL bResync;
+
+	/* Don't read the lengths before the WPtr that published them */
+	HostMemoryBarrier();
+
+	/*
+		A bad length means either a reader or another writer moved RPtr
+		and the length came from reused space, in which case the
+		compare-and-swap below fails, or the stream is corrupt and has
+		to resync.
+	*/
+	ui32Drop = RecordSpan(psStream, ui32RPtr, ui32Avail, ui32Bytes, ui32Avail);
+	bResync = (ui32Drop == DBG_RECORD_BAD);
+	if (bResync)
 	{
-		HostMemCopy((IMG_VOID *)(psStream->ui32Base + psStream->ui32WPtr),
-				(IMG_VOID *) pui8Data,
-				ui32InBuffSize);
+		ui32Drop = ui32Avail;
+	}
 
-		psStream->ui32WPtr += ui32InBuffSize;
+	if (HostAtomicCmpXchg(&psStream->ui32RPtr, ui32RPtr,
+						  (ui32RPtr + ui32Drop) % psStream->ui32Size) == ui32RPtr)
+	{
+		if (bResync)
+		{
+			PVR_DPF((PVR_DBG_ERROR, "DBGDriv: Stream %s lost its record framing, resyncing", psStream->szName));
+		}
+
+		StreamDropped(psStream, ui32Drop);
+	}
+}
+
+/*!****************************************************************************
+ @name		ReserveStream
+ @brief		Reserve space at the head of a stream, applying the overflow
+ 			policy if the stream is full
+ @param		psStream - stream
+ @param		ui32Len - bytes wanted
+ @param		ui32Min - smallest write worth making when truncating
+ @param		pui32Offset - receives the offset of the reservation
+ @return	bytes reserved, 0 if the data was dropped
+*****************************************************************************/
+static IMG_UINT32 ReserveStream(PDBG_STREAM psStream, IMG_UINT32 ui32Len, IMG_UINT32 ui32Min, IMG_UINT32 *pui32Offset)
+{
+	IMG_UINT32	ui32Head;
+	IMG_UINT32	ui32RPtr;
+	IMG_UINT32	ui32Space;
+	IMG_UINT32	ui32Want;
+#if defined(SUPPORT_DBGDRV_EVENT_OBJECTS)
+	IMG_BOOL	bWaited = IMG_FALSE;
+#endif
+
+	for (;;)
+	{
+		ui32Want = ui32Len;
+		ui32RPtr = *(volatile IMG_UINT32 *)&psStream->ui32RPtr;
+		ui32Head = *(volatile IMG_UINT32 *)&psStream->ui32Reserve;
+		ui32Space = psStream->ui32Size - StreamUsed(psStream, ui32RPtr, ui32Head);
+
+		if (ui32Space <= (ui32Want + DBG_STREAM_SLACK))
+		{
+			if ((psStream->ui32Flags & DEBUG_FLAGS_OVERFLOW_DROP_OLDEST) &&
+				(ui32Want + DBG_STREAM_SLACK) < psStream->ui32Size)
+			{
+				/*
+					Only committed data can be discarded; anything between
+					ui32WPtr and ui32Reserve is still being copied in.
+				*/
+				IMG_UINT32 ui32WPtr = *(volatile IMG_UINT32 *)&psStream->ui32WPtr;
+
+				if (ui32WPtr == ui32RPtr)
+				{
+					HostYield();
+					continue;
+				}
+
+				DropRecords(psStream, ui32RPtr, ui32WPtr,
+							ui32Want + DBG_STREAM_SLACK + 1 - ui32Space);
+				continue;
+			}
+
+#if defined(SUPPORT_DBGDRV_EVENT_OBJECTS)
+			if (((psStream->ui32Flags & DEBUG_FLAGS_NO_BUF_EXPANDSION) == 0) &&
+				psStream->bReaderAttached &&
+				!bWaited &&
+				(ui32Want + DBG_STREAM_SLACK) < psStream->ui32Size)
+			{
+				HostWaitForEvent(DBG_EVENT_STREAM_SPACE);
+				bWaited = IMG_TRUE;
+				continue;
+			}
+#endif
+
+			if (ui32Space <= (ui32Min + DBG_STREAM_SLACK))
+			{
+				StreamDropped(psStream, ui32Len);
+				return 0;
+			}
 
-		if (psStream->ui32WPtr == psStream->ui32Size)
+			ui32Want = ui32Space - DBG_STREAM_SLACK - 1;
+		}
+
+		if (HostAtomicCmpXchg(&psStream->ui32Reserve, ui32Head,
+							  (ui32Head + ui32Want) % psStream->ui32Size) == ui32Head)
 		{
-			psStream->ui32WPtr = 0;
+			if (ui32Want < ui32Len)
+			{
+				StreamDropped(psStream, ui32Len - ui32Want);
+			}
+
+			*pui32Offset = ui32Head;
+			return ui32Want;
 		}
 	}
-	psStream->ui32DataWritten += ui32InBuffSize;
+}
+
+/*!****************************************************************************
+ @name		CopyToStream
+ @brief		Copy data into a reserved region of a stream, wrapping as needed
+ @param		psStream - stream
+ @param		ui32Offset - offset in the stream buffer
+ @param		pui8Data - data to copy
+ @param		ui32Len - bytes to copy
+ @return	offset following the copied data
+*****************************************************************************/
+static IMG_UINT32 CopyToStream(PDBG_STREAM psStream, IMG_UINT32 ui32Offset, IMG_UINT8 *pui8Data, IMG_UINT32 ui32Len)
+{
+	if ((ui32Offset + ui32Len) > psStream->ui32Size)
+	{
+		/* Yes we need two bits, calculate their sizes */
+		IMG_UINT32 ui32B1 = psStream->ui32Size - ui32Offset;
+		IMG_UINT32 ui32B2 = ui32Len - ui32B1;
+
+		HostMemCopy((IMG_VOID *)(psStream->ui32Base + ui32Offset),
+				(IMG_VOID *) pui8Data,
+				ui32B1);
+
+		HostMemCopy((IMG_VOID *)psStream->ui32Base,
+				(IMG_VOID *)(pui8Data + ui32B1),
+				ui32B2);
+
+		return ui32B2;
+	}
+
+	HostMemCopy((IMG_VOID *)(psStream->ui32Base + ui32Offset),
+			(IMG_VOID *) pui8Data,
+			ui32Len);
+
+	ui32Offset += ui32Len;
+
+	return (ui32Offset == psStream->ui32Size) ? 0 : ui32Offset;
+}
+
+/*!****************************************************************************
+ @name		CommitStream
+ @brief		Publish a reservation to the reader once every earlier
+ 			reservation has been published
+ @param		psStream - stream
+ @param		ui32Offset - offset returned by ReserveStream
+ @param		ui32Len - bytes reserved
+ @return	none
+*****************************************************************************/
+static IMG_VOID CommitStream(PDBG_STREAM psStream, IMG_UINT32 ui32Offset, IMG_UINT32 ui32Len)
+{
+	while (*(volatile IMG_UINT32 *)&psStream->ui32WPtr != ui32Offset)
+	{
+		HostYield();
+	}
+
+	/* The data must be visible before the reader can see the new WPtr */
+	HostMemoryBarrier();
+
+	psStream->ui32WPtr = (ui32Offset + ui32Len) % psStream->ui32Size;
+	AtomicAdd(&psStream->ui32DataWritten, ui32Len);
+}
+
+/*!****************************************************************************
+ @name		WriteRecord
+ @brief		Write a block of data to a stream behind its length
+ @param		psStream - stream
+ @param		pui8Data - data to write
+ @param		ui32InBuffSize - size
+ @param		ui32Min - smallest write worth making if the stream is full
+ @return	bytes of data written, not counting the length
+*****************************************************************************/
+static IMG_UINT32 WriteRecord(PDBG_STREAM psStream, IMG_UINT8 *pui8Data, IMG_UINT32 ui32InBuffSize, IMG_UINT32 ui32Min)
+{
+	IMG_UINT32 ui32Len;
+	IMG_UINT32 ui32Offset;
+	IMG_UINT32 ui32Next;
+
+	/*
+		The length and the data are reserved together so that records
+		from concurrent writers cannot interleave.
+	*/
+	ui32Len = ReserveStream(psStream, ui32InBuffSize + DBG_RECORD_HEADER,
+							ui32Min + DBG_RECORD_HEADER, &ui32Offset);
+	if (ui32Len == 0)
+	{
+		return 0;
+	}
+
+	ui32InBuffSize = ui32Len - DBG_RECORD_HEADER;
+	ui32Next = CopyToStream(psStream, ui32Offset, (IMG_UINT8 *) &ui32InBuffSize, DBG_RECORD_HEADER);
+	CopyToStream(psStream, ui32Next, pui8Data, ui32InBuffSize);
+	CommitStream(psStream, ui32Offset, ui32Len);
+
+	return ui32InBuffSize;
+}
+
+/*!****************************************************************************
+ @name		Write
+ @brief		Write a block of data to a stream as a single record
+ @param		psStream - stream
+ @param		pui8Data - data to write
+ @param		ui32InBuffSize - size
+ @param		ui32Min - smallest write worth making if the stream is full
+ @return	bytes written
+*****************************************************************************/
+IMG_UINT32 Write(PDBG_STREAM psStream,IMG_UINT8 * pui8Data,IMG_UINT32 ui32InBuffSize,IMG_UINT32 ui32Min)
+{
+	IMG_UINT32 ui32Offset;
+
+	if (StreamIsFramed(psStream))
+	{
+		return WriteRecord(psStream, pui8Data, ui32InBuffSize, ui32Min);
+	}
+
+	ui32InBuffSize = ReserveStream(psStream, ui32InBuffSize, ui32Min, &ui32Offset);
+	if (ui32InBuffSize == 0)
+	{
+		return 0;
+	}
+
+	CopyToStream(psStream, ui32Offset, pui8Data, ui32InBuffSize);
+	CommitStream(psStream, ui32Offset, ui32InBuffSize);
+
+	return ui32InBuffSize;
 }
 
 
@@ -903,7 +1260,10 @@ IMG_VOID * IMG_CALLCONV DBGDrivCreateStream(IMG_CHAR *		pszName,
 	psStream->ui32Size = ui32Size * 4096UL;
 	psStream->ui32RPtr = 0;
 	psStream->ui32WPtr = 0;
+	psStream->ui32Reserve = 0;
 	psStream->ui32DataWritten = 0;
+	psStream->ui32DataDropped = 0;
+	psStream->bReaderAttached = IMG_FALSE;
 	psStream->ui32CapMode = ui32CapMode;
 	psStream->ui32OutMode = ui32OutMode;
 	psStream->ui32DebugLevel = DEBUG_LEVEL_0;
@@ -950,7 +1310,10 @@ IMG_VOID * IMG_CALLCONV DBGDrivCreateStream(IMG_CHAR *		pszName,
 	psInitStream->ui32Size = ui32Size * 4096UL;
 	psInitStream->ui32RPtr = 0;
 	psInitStream->ui32WPtr = 0;
+	psInitStream->ui32Reserve = 0;
 	psInitStream->ui32DataWritten = 0;
+	psInitStream->ui32DataDropped = 0;
+	psInitStream->bReaderAttached = IMG_FALSE;
 	psInitStream->ui32CapMode = ui32CapMode;
 	psInitStream->ui32OutMode = ui32OutMode;
 	psInitStream->ui32DebugLevel = DEBUG_LEVEL_0;
@@ -1167,6 +1530,7 @@ IMG_VOID * IMG_CALLCONV DBGDrivFindStream(IMG_CHAR * pszName, IMG_BOOL bResetStr
 		psStream->psInitStream->ui32RPtr = 0;
 		psStream->ui32RPtr = 0;
 		psStream->ui32WPtr = 0;
+		psStream->ui32Reserve = 0;
 		psStream->ui32DataWritten = psStream->psInitStream->ui32DataWritten;
 		if (psStream->bInitPhaseComplete == IMG_FALSE)
 		{
@@ -1187,7 +1551,6 @@ IMG_UINT32 IMG_CALLCONV DBGDrivWriteStringCM(PDBG_STREAM psStream,IMG_CHAR * psz
 	/*
 		Validate buffer.
 	*/
-	/*
 	if (!StreamValid(psStream))
 	{
 		return(0xFFFFFFFFUL);
@@ -1230,9 +1593,6 @@ IMG_UINT32 IMG_CALLCONV DBGDrivWriteStringCM(PDBG_STREAM psStream,IMG_CHAR * psz
 IMG_UINT32 IMG_CALLCONV DBGDrivWriteString(PDBG_STREAM psStream,IMG_CHAR * pszString,IMG_UINT32 ui32Level)
 {
 	IMG_UINT32	ui32Len;
-	IMG_UINT32	ui32Space;
-	IMG_UINT32	ui32WPtr;
-	IMG_UINT8 *	pui8Buffer;
 
 
 
@@ -1282,49 +1642,10 @@ IMG_UINT32 IMG_CALLCONV DBGDrivWriteString(PDBG_STREAM psStream,IMG_CHAR * pszSt
 	}
 
 	/*
-		How much space have we got in the buffer ?
+		The string and its terminator go in whole or not at all.
 	*/
-	ui32Space=SpaceInStream(psStream);
-
-	/* Make sure there's space for termination character */
-	if(ui32Space > 0)
-	{
-		ui32Space--;
-	}
-
-	ui32Len		= 0;
-	ui32WPtr	= psStream->ui32WPtr;
-	pui8Buffer	= (IMG_UINT8 *) psStream->ui32Base;
-
-	while((pszString[ui32Len] != 0) && (ui32Len < ui32Space))
-	{
-		pui8Buffer[ui32WPtr] = (IMG_UINT8)pszString[ui32Len];
-		ui32Len++;
-		ui32WPtr++;
-		if (ui32WPtr == psStream->ui32Size)
-		{
-			ui32WPtr = 0;
-		}
-	}
-
-	if (ui32Len < ui32Space)
-	{
-		/* copy terminator */
-		pui8Buffer[ui32WPtr] = (IMG_UINT8)pszString[ui32Len];
-		ui32Len++;
-		ui32WPtr++;
-		if (ui32WPtr == psStream->ui32Size)
-		{
-			ui32WPtr = 0;
-		}
-
-		/* Write pointer, and length */
-		psStream->ui32WPtr = ui32WPtr;
-		psStream->ui32DataWritten+= ui32Len;
-	} else
-	{
-		ui32Len = 0;
-	}
+	ui32Len = strlen(pszString) + 1;
+	ui32Len = Write(psStream, (IMG_UINT8 *)pszString, ui32Len, ui32Len);
 
 #if defined(SUPPORT_DBGDRV_EVENT_OBJECTS)
 	if (ui32Len)
@@ -1351,6 +1672,8 @@ IMG_UINT32 IMG_CALLCONV DBGDrivReadString(PDBG_STREAM psStream,IMG_CHAR * pszStr
 	IMG_UINT32				ui32OutLen;
 	IMG_UINT32				ui32Len;
 	IMG_UINT32				ui32Offset;
+	IMG_UINT32				ui32RPtr;
+	IMG_UINT32				ui32WPtr;
 	IMG_UINT8				*pui8Buff;
 
 
@@ -1363,70 +1686,109 @@ IMG_UINT32 IMG_CALLCONV DBGDrivReadString(PDBG_STREAM psStream,IMG_CHAR * pszStr
 
 
 	pui8Buff = (IMG_UINT8 *) psStream->ui32Base;
-	ui32Offset = psStream->ui32RPtr;
-
-	if (psStream->ui32RPtr == psStream->ui32WPtr)
-	{
-		return(0);
-	}
 
-	/*
-		Find length of string.
-	*/
-	ui32Len = 0;
-	while((pui8Buff[ui32Offset] != 0) && (ui32Offset != psStream->ui32WPtr))
+	do
 	{
-		ui32Offset++;
-		ui32Len++;
+		ui32RPtr = *(volatile IMG_UINT32 *)&psStream->ui32RPtr;
+		ui32WPtr = *(volatile IMG_UINT32 *)&psStream->ui32WPtr;
 
-		/*
-			Reset offset if buffer wrapped.
-		*/
-		if (ui32Offset == psStream->ui32Size)
+		if (ui32RPtr == ui32WPtr)
 		{
-			ui32Offset = 0;
+			return(0);
 		}
-	}
 
-	ui32OutLen = ui32Len + 1;
+		HostMemoryBarrier();
 
-	/*
-		Only copy string if target has enough space.
-	*/
-	if (ui32Len > ui32Limit)
-	{
-		return(0);
-	}
+		if (StreamIsFramed(psStream))
+		{
+			/*
+				The string and its terminator make up one record, which is
+				left in the stream if it is too long for the caller.
+			*/
+			ui32Len = RecordSpan(psStream, ui32RPtr, StreamUsed(psStream, ui32RPtr, ui32WPtr),
+								 1, ui32Limit + 1 + DBG_RECORD_HEADER);
+			if (ui32Len == DBG_RECORD_BAD)
+			{
+				DropRecords(psStream, ui32RPtr, ui32WPtr, 1);
+				return(0);
+			}
 
-	/*
-		Copy it.
-	*/
-	ui32Offset = psStream->ui32RPtr;
-	ui32Len = 0;
+			if (ui32Len == 0)
+			{
+				return(0);
+			}
 
-	while ((pui8Buff[ui32Offset] != 0) && (ui32Len < ui32Limit))
-	{
-		pszString[ui32Len] = (IMG_CHAR)pui8Buff[ui32Offset];
-		ui32Offset++;
-		ui32Len++;
+			ui32OutLen = ui32Len - DBG_RECORD_HEADER;
+			ReadFromStream(psStream, (ui32RPtr + DBG_RECORD_HEADER) % psStream->ui32Size,
+						   (IMG_UINT8 *) pszString, ui32OutLen);
+			pszString[ui32OutLen ? ui32OutLen - 1 : 0] = 0;
 
-		/*
-			If wrap as necessary
-		*/
-		if (ui32Offset == psStream->ui32Size)
+			ui32Offset = (ui32RPtr + ui32Len - 1) % psStream->ui32Size;
+		}
+		else
 		{
-			ui32Offset = 0;
+			/*
+				Find length of string.
+			*/
+			ui32Offset = ui32RPtr;
+			ui32Len = 0;
+			while((pui8Buff[ui32Offset] != 0) && (ui32Offset != ui32WPtr))
+			{
+				ui32Offset++;
+				ui32Len++;
+
+				/*
+					Reset offset if buffer wrapped.
+				*/
+				if (ui32Offset == psStream->ui32Size)
+				{
+					ui32Offset = 0;
+				}
+			}
+
+			ui32OutLen = ui32Len + 1;
+
+			/*
+				Only copy string if target has enough space.
+			*/
+			if (ui32Len > ui32Limit)
+			{
+				return(0);
+			}
+
+			/*
+				Copy it.
+			*/
+			ui32Offset = ui32RPtr;
+			ui32Len = 0;
+
+			while ((pui8Buff[ui32Offset] != 0) && (ui32Len < ui32Limit))
+			{
+				pszString[ui32Len] = (IMG_CHAR)pui8Buff[ui32Offset];
+				ui32Offset++;
+				ui32Len++;
+
+				/*
+					If wrap as necessary
+				*/
+				if (ui32Offset == psStream->ui32Size)
+				{
+					ui32Offset = 0;
+				}
+			}
+
+			pszString[ui32Len] = (IMG_CHAR)pui8Buff[ui32Offset];
 		}
-	}
 
-	pszString[ui32Len] = (IMG_CHAR)pui8Buff[ui32Offset];
+		HostMemoryBarrier();
 
-	psStream->ui32RPtr = ui32Offset + 1;
+		/* Retry if a drop oldest writer overwrote the string under us */
+	} while (HostAtomicCmpXchg(&psStream->ui32RPtr, ui32RPtr,
+							   (ui32Offset + 1) % psStream->ui32Size) != ui32RPtr);
 
-	if (psStream->ui32RPtr == psStream->ui32Size)
-	{
-		psStream->ui32RPtr = 0;
-	}
+#if defined(SUPPORT_DBGDRV_EVENT_OBJECTS)
+	HostSignalEvent(DBG_EVENT_STREAM_SPACE);
+#endif
 
 	return(ui32OutLen);
 }
@@ -1442,7 +1804,6 @@ IMG_UINT32 IMG_CALLCONV DBGDrivReadString(PDBG_STREAM psStream,IMG_CHAR * pszStr
 *****************************************************************************/
 IMG_UINT32 IMG_CALLCONV DBGDrivWrite(PDBG_STREAM psMainStream,IMG_UINT8 * pui8InBuf,IMG_UINT32 ui32InBuffSize,IMG_UINT32 ui32Level)
 {
-	IMG_UINT32				ui32Space;
 	DBG_STREAM *psStream;
 
 
@@ -1483,37 +1844,12 @@ IMG_UINT32 IMG_CALLCONV DBGDrivWrite(PDBG_STREAM psMainStream,IMG_UINT8 * pui8In
 		psStream = psMainStream->psInitStream;
 	}
 
-	/*
-		How much space have we got in the buffer ?
-	*/
-	ui32Space=SpaceInStream(psStream);
-
-
-
 	if ((psStream->ui32OutMode & DEBUG_OUTMODE_STREAMENABLE) == 0)
 	{
 		return(0);
 	}
 
-	if (ui32Space < 8)
-	{
-		return(0);
-	}
-
-	/*
-		Only copy what we can..
-	*/
-	if (ui32Space <= (ui32InBuffSize + 4))
-	{
-		ui32InBuffSize = ui32Space - 8;
-	}
-
-	/*
-		Write the stuff...
-	*/
-	Write(psStream,(IMG_UINT8 *) &ui32InBuffSize,4);
-	Write(psStream,pui8InBuf,ui32InBuffSize);
-
+	ui32InBuffSize = WriteRecord(psStream, pui8InBuf, ui32InBuffSize, 4);
 #if defined(SUPPORT_DBGDRV_EVENT_OBJECTS)
 	if (ui32InBuffSize)
 	{
@@ -1566,7 +1902,6 @@ IMG_UINT32 IMG_CALLCONV DBGDrivWriteCM(PDBG_STREAM psStream,IMG_UINT8 * pui8InBu
 
 IMG_UINT32 IMG_CALLCONV DBGDrivWrite2(PDBG_STREAM psMainStream,IMG_UINT8 * pui8InBuf,IMG_UINT32 ui32InBuffSize,IMG_UINT32 ui32Level)
 {
-	IMG_UINT32	ui32Space;
 	DBG_STREAM	*psStream;
 
 
@@ -1594,76 +1929,125 @@ IMG_UINT32 IMG_CALLCONV DBGDrivWrite2(PDBG_STREAM psMainStream,IMG_UINT8 * pui8I
 
 
 
-	ui32Space=SpaceInStream(psStream);
-
-
-
 	if ((psStream->ui32OutMode & DEBUG_OUTMODE_STREAMENABLE) == 0)
 	{
 		return(0);
 	}
 
+	ui32InBuffSize = Write(psStream, pui8InBuf, ui32InBuffSize, 32);
 
+#if defined(SUPPORT_DBGDRV_EVENT_OBJECTS)
+	if (ui32InBuffSize)
+	{
+		HostSignalEvent(DBG_EVENT_STREAM_DATA);
+	}
+#endif
+	return(ui32InBuffSize);
+}
 
-	if (psStream->ui32Flags & DEBUG_FLAGS_NO_BUF_EXPANDSION)
+/*!****************************************************************************
+ @name		ReadStream
+ @brief		Pick the stream a read refers to
+ @param		psMainStream - stream
+ @param		bReadInitBuffer - whether to read from the init stream or the main stream
+ @return	the stream, IMG_NULL if psMainStream is not a stream
+*****************************************************************************/
+static PDBG_STREAM ReadStream(PDBG_STREAM psMainStream, IMG_BOOL bReadInitBuffer)
+{
+	if (!StreamValid(psMainStream))
 	{
+		return IMG_NULL;
+	}
 
+	return bReadInitBuffer ? psMainStream->psInitStream : psMainStream;
+}
 
+/*!****************************************************************************
+ @name		AcquireStream
+ @brief		Find the unread data at the tail of a stream
+ @param		psStream - stream
+ @param		ui32Limit - most bytes the caller can take
+ @param		pui32Offset - receives the offset of the data in the stream buffer
+ @return	bytes from *pui32Offset on, wrapping at the end of the buffer;
+ 			0 if there are none
+*****************************************************************************/
+static IMG_UINT32 AcquireStream(PDBG_STREAM psStream, IMG_UINT32 ui32Limit, IMG_UINT32 *pui32Offset)
+{
+	IMG_UINT32 ui32Data;
+	IMG_UINT32 ui32RPtr;
+	IMG_UINT32 ui32WPtr;
 
-		if (ui32Space < 32)
+	psStream->bReaderAttached = IMG_TRUE;
+
+	for (;;)
+	{
+		ui32RPtr = *(volatile IMG_UINT32 *)&psStream->ui32RPtr;
+		ui32WPtr = *(volatile IMG_UINT32 *)&psStream->ui32WPtr;
+
+		if (ui32RPtr == ui32WPtr)
 		{
 			return(0);
 		}
-	}
-	else
-	{
-		if ((ui32Space < 32) || (ui32Space <= (ui32InBuffSize + 4)))
-		{
-			IMG_UINT32	ui32NewBufSize;
-
-
-
-			ui32NewBufSize = 2 * psStream->ui32Size;
 
-			if (ui32InBuffSize > psStream->ui32Size)
-			{
-				ui32NewBufSize += ui32InBuffSize;
-			}
+		/* Don't read the data before the WPtr that published it */
+		HostMemoryBarrier();
 
+		/*
+			Get amount of data in buffer.
+		*/
+		ui32Data = StreamUsed(psStream, ui32RPtr, ui32WPtr);
 
+		/*
+			Only transfer what target buffer can handle. A drop oldest
+			stream is only ever read in whole records; one too big for
+			the target buffer is dropped, as it could never be read.
+		*/
+		if (StreamIsFramed(psStream))
+		{
+			IMG_UINT32 ui32Avail = ui32Data;
 
-			if (!ExpandStreamBuffer(psStream,ui32NewBufSize))
+			ui32Data = RecordSpan(psStream, ui32RPtr, ui32Avail, ui32Avail, ui32Limit);
+			if ((ui32Data == 0) || (ui32Data == DBG_RECORD_BAD))
 			{
-				if (ui32Space < 32)
-				{
-					return(0);
-				}
+				DropRecords(psStream, ui32RPtr, ui32WPtr, 1);
+				continue;
 			}
-
-
-
-			ui32Space = SpaceInStream(psStream);
 		}
-	}
+		else if (ui32Data > ui32Limit)
+		{
+			ui32Data = ui32Limit;
+		}
 
+		*pui32Offset = ui32RPtr;
+		return ui32Data;
+	}
+}
 
+/*!****************************************************************************
+ @name		ReleaseStream
+ @brief		Release data returned by AcquireStream once it has been read
+ @param		psStream - stream
+ @param		ui32Offset - offset returned by AcquireStream
+ @param		ui32Len - bytes read
+ @return	IMG_FALSE if a drop oldest writer discarded the data while it
+ 			was being read, in which case it may have been overwritten
+*****************************************************************************/
+static IMG_BOOL ReleaseStream(PDBG_STREAM psStream, IMG_UINT32 ui32Offset, IMG_UINT32 ui32Len)
+{
+	/* The reads of the data must complete before the space is reused */
+	HostMemoryBarrier();
 
-	if (ui32Space <= (ui32InBuffSize + 4))
+	if (HostAtomicCmpXchg(&psStream->ui32RPtr, ui32Offset,
+						  (ui32Offset + ui32Len) % psStream->ui32Size) != ui32Offset)
 	{
-		ui32InBuffSize = ui32Space - 4;
+		return IMG_FALSE;
 	}
 
-
-
-	Write(psStream,pui8InBuf,ui32InBuffSize);
-
 #if defined(SUPPORT_DBGDRV_EVENT_OBJECTS)
-	if (ui32InBuffSize)
-	{
-		HostSignalEvent(DBG_EVENT_STREAM_DATA);
-	}
+	HostSignalEvent(DBG_EVENT_STREAM_SPACE);
 #endif
-	return(ui32InBuffSize);
+
+	return IMG_TRUE;
 }
 
 /*!****************************************************************************
@@ -1678,89 +2062,78 @@ IMG_UINT32 IMG_CALLCONV DBGDrivWrite2(PDBG_STREAM psMainStream,IMG_UINT8 * pui8I
 IMG_UINT32 IMG_CALLCONV DBGDrivRead(PDBG_STREAM psMainStream, IMG_BOOL bReadInitBuffer, IMG_UINT32 ui32OutBuffSize,IMG_UINT8 * pui8OutBuf)
 {
 	IMG_UINT32 ui32Data;
+	IMG_UINT32 ui32Offset;
 	DBG_STREAM *psStream;
 
-
-
-	if (!StreamValid(psMainStream))
+	psStream = ReadStream(psMainStream, bReadInitBuffer);
+	if (!psStream)
 	{
 		return(0);
 	}
 
-	if(bReadInitBuffer)
-	{
-		psStream = psMainStream->psInitStream;
-	}
-	else
-	{
-		psStream = psMainStream;
-	}
-
-	if (psStream->ui32RPtr == psStream->ui32WPtr)
-	{
-		return(0);
-	}
-
-	/*
-		Get amount of data in buffer.
-	*/
-	if (psStream->ui32RPtr <= psStream->ui32WPtr)
-	{
-		ui32Data = psStream->ui32WPtr - psStream->ui32RPtr;
-	}
-	else
-	{
-		ui32Data = psStream->ui32WPtr + (psStream->ui32Size - psStream->ui32RPtr);
-	}
-
-
 	/*
-		Only transfer what target buffer can handle.
+		If a drop oldest writer moved RPtr while we were copying, part of
+		what we copied may have been overwritten; read it again.
 	*/
-	if (ui32Data > ui32OutBuffSize)
+	do
 	{
-		ui32Data = ui32OutBuffSize;
-	}
+		ui32Data = AcquireStream(psStream, ui32OutBuffSize, &ui32Offset);
+		if (ui32Data == 0)
+		{
+			return(0);
+		}
 
+		ReadFromStream(psStream, ui32Offset, pui8OutBuf, ui32Data);
+	} while (!ReleaseStream(psStream, ui32Offset, ui32Data));
 
-	/*
-		Split copy into two bits as necessay.
-	*/
-	if ((psStream->ui32RPtr + ui32Data) > psStream->ui32Size)
-	{	/* Calc block 1 and block 2 sizes */
-		IMG_UINT32 ui32B1 = psStream->ui32Size - psStream->ui32RPtr;
-		IMG_UINT32 ui32B2 = ui32Data - ui32B1;
-
-		/* Copy up to end of circular buffer */
-		HostMemCopy((IMG_VOID *) pui8OutBuf,
-				(IMG_VOID *)(psStream->ui32Base + psStream->ui32RPtr),
-				ui32B1);
+	return(ui32Data);
+}
 
-		/* Copy from start of circular buffer */
-		HostMemCopy((IMG_VOID *)(pui8OutBuf + ui32B1),
-				psStream->pvBase,
-				ui32B2);
+/*!****************************************************************************
+ @name		DBGDrivAcquireRead
+ @brief		Find the unread data in a stream, for a reader that has the
+ 			stream buffer mapped and reads it in place
+ @param		psMainStream - stream
+ @param		bReadInitBuffer - whether to read from the init stream or the main stream
+ @param		ui32Limit - most bytes the caller will take
+ @param		pui32Offset - receives the offset of the data in the stream buffer
+ @return	bytes from *pui32Offset on, wrapping at the end of the buffer;
+ 			0 if there are none
+*****************************************************************************/
+IMG_UINT32 IMG_CALLCONV DBGDrivAcquireRead(PDBG_STREAM psMainStream, IMG_BOOL bReadInitBuffer, IMG_UINT32 ui32Limit, IMG_UINT32 *pui32Offset)
+{
+	DBG_STREAM *psStream;
 
-		/* Update read pointer now that we've copied the data out */
-		psStream->ui32RPtr = ui32B2;
+	psStream = ReadStream(psMainStream, bReadInitBuffer);
+	if (!psStream)
+	{
+		return(0);
 	}
-	else
-	{	/* Copy data from wherever */
-		HostMemCopy((IMG_VOID *) pui8OutBuf,
-				(IMG_VOID *)(psStream->ui32Base + psStream->ui32RPtr),
-				ui32Data);
 
-		/* Update read pointer now that we've copied the data out */
-		psStream->ui32RPtr += ui32Data;
+	return AcquireStream(psStream, ui32Limit, pui32Offset);
+}
 
-		/* Check for wrapping */
-		if (psStream->ui32RPtr == psStream->ui32Size)
-		{
-			psStream->ui32RPtr = 0;
-		}
+/*!****************************************************************************
+ @name		DBGDrivReleaseRead
+ @brief		Hand back data found by DBGDrivAcquireRead once it has been read
+ @param		psMainStream - stream
+ @param		bReadInitBuffer - whether to read from the init stream or the main stream
+ @param		ui32Offset - offset returned by DBGDrivAcquireRead
+ @param		ui32Len - bytes read, at most what DBGDrivAcquireRead returned
+ @return	IMG_FALSE if the data was discarded while it was being read and
+ 			has to be thrown away
+*****************************************************************************/
+IMG_BOOL IMG_CALLCONV DBGDrivReleaseRead(PDBG_STREAM psMainStream, IMG_BOOL bReadInitBuffer, IMG_UINT32 ui32Offset, IMG_UINT32 ui32Len)
+{
+	DBG_STREAM *psStream;
+
+	psStream = ReadStream(psMainStream, bReadInitBuffer);
+	if (!psStream || (ui32Offset >= psStream->ui32Size) || (ui32Len > psStream->ui32Size))
+	{
+		return IMG_FALSE;
 	}
 
-	return(ui32Data);
+	return ReleaseStream(psStream, ui32Offset, ui32Len);
 }
 
 /*!****************************************************************************
@@ -2309,125 +2682,6 @@ IMG_VOID IMG_CALLCONV DBGDrivWaitForEvent(DBG_EVENT eEvent)
 }
 #endif
 
-/*!****************************************************************************
- @name		ExpandStreamBuffer
- @brief		allocates a new buffer when the current one is full
- @param		psStream - stream
- @param		ui32NewSize - new size
- @return	IMG_TRUE - if allocation succeeded, IMG_FALSE - if not
-*****************************************************************************/
-IMG_BOOL ExpandStreamBuffer(PDBG_STREAM psStream, IMG_UINT32 ui32NewSize)
-{
-	IMG_VOID *	pvNewBuf;
-	IMG_UINT32	ui32NewSizeInPages;
-	IMG_UINT32	ui32NewWOffset;
-	IMG_UINT32	ui32SpaceInOldBuf;
-
-	/* 
-		First check new size is bigger than existing size 
-	*/
-	if (psStream->ui32Size >= ui32NewSize)
-	{
-		return IMG_FALSE;
-	}
-
-	/*
-		Calc space in old buffer 
-	*/
-	ui32SpaceInOldBuf = SpaceInStream(psStream);
-
-	/*
-		Allocate new buffer 
-	*/
-	ui32NewSizeInPages = ((ui32NewSize + 0xfffUL) & ~0xfffUL) / 4096UL;
-
-	if ((psStream->ui32Flags & DEBUG_FLAGS_USE_NONPAGED_MEM) != 0)
-	{
-		pvNewBuf = HostNonPageablePageAlloc(ui32NewSizeInPages);
-	}
-	else
-	{
-		pvNewBuf = HostPageablePageAlloc(ui32NewSizeInPages);
-	}
-
-	if (pvNewBuf == IMG_NULL)
-	{
-		return IMG_FALSE;
-	}
-
-
-
-
-	if (psStream->ui32RPtr <= psStream->ui32WPtr)
-	{
-
-
-		HostMemCopy((IMG_VOID *)pvNewBuf, (IMG_VOID *)(psStream->ui32Base + psStream->ui32RPtr), psStream->ui32WPtr - psStream->ui32RPtr);
-	}
-	else
-	{
-		IMG_UINT32	ui32FirstCopySize;
-
-
-
-		ui32FirstCopySize = psStream->ui32Size - psStream->ui32RPtr;
-
-		HostMemCopy((IMG_VOID *)pvNewBuf, (IMG_VOID *)(psStream->ui32Base + psStream->ui32RPtr), ui32FirstCopySize);
-
-
-
-		HostMemCopy((IMG_VOID *)((IMG_UINT32)pvNewBuf + ui32FirstCopySize), (IMG_VOID *)psStream->ui32Base, psStream->ui32WPtr);
-	}
-
-	/*
-		New Write offset is at end of data 
-	*/                                                        
-	ui32NewWOffset = psStream->ui32Size - ui32SpaceInOldBuf;
-
-
-
-	if ((psStream->ui32Flags & DEBUG_FLAGS_USE_NONPAGED_MEM) != 0)
-	{
-		HostNonPageablePageFree((IMG_VOID *)psStream->ui32Base);
-	}
-	else
-	{
-		HostPageablePageFree((IMG_VOID *)psStream->ui32Base);
-	}
-
-
-
-	psStream->ui32Base = (IMG_UINT32)pvNewBuf;
-	psStream->ui32RPtr = 0;
-	psStream->ui32WPtr = ui32NewWOffset;
-	psStream->ui32Size = ui32NewSizeInPages * 4096;
-
-	return IMG_TRUE;
-}
-
-/*!****************************************************************************
- @name		SpaceInStream
- @brief		remaining space in stream
- @param		psStream - stream
- @return	bytes remaining
-*****************************************************************************/
-IMG_UINT32 SpaceInStream(PDBG_STREAM psStream)
-{
-	IMG_UINT32	ui32Space;
-
-	if (psStream->ui32RPtr > psStream->ui32WPtr)
-	{
-		ui32Space = psStream->ui32RPtr - psStream->ui32WPtr;
-	}
-	else
-	{
-		ui32Space = psStream->ui32RPtr + (psStream->ui32Size - psStream->ui32WPtr);
-	}
-
-	return ui32Space;
-}
-
-
 /*!****************************************************************************
  @name		DestroyAllStreams
  @brief		delete all streams in list
@@ -61,6 +61,8 @@ IMG_VOID HostNonPageablePageFree(IMG_VOID * pvBase);
 IMG_VOID * HostMapKrnBufIntoUser(IMG_VOID * pvKrnAddr, IMG_UINT32 ui32Size, IMG_VOID * *ppvMdl);
 IMG_VOID HostUnMapKrnBufFromUser(IMG_VOID * pvUserAddr, IMG_VOID * pvMdl, IMG_VOID * pvProcess);
 
+IMG_INT32 HostMapStream(PDBG_STREAM psStream, IMG_BOOL bReadInitBuffer);
+
 IMG_VOID HostCreateRegDeclStreams(IMG_VOID);
 
 IMG_VOID * HostCreateMutex(IMG_VOID);
@@ -68,6 +70,10 @@ IMG_VOID HostAquireMutex(IMG_VOID * pvMutex);
 IMG_VOID HostReleaseMutex(IMG_VOID * pvMutex);
 IMG_VOID HostDestroyMutex(IMG_VOID * pvMutex);
 
+IMG_UINT32 HostAtomicCmpXchg(IMG_UINT32 *pui32Addr, IMG_UINT32 ui32Old, IMG_UINT32 ui32New);
+IMG_VOID HostMemoryBarrier(IMG_VOID);
+IMG_VOID HostYield(IMG_VOID);
+
 #if defined(SUPPORT_DBGDRV_EVENT_OBJECTS)
 IMG_INT32 HostCreateEventObjects(IMG_VOID);
 IMG_VOID HostWaitForEvent(DBG_EVENT eEvent);
@@ -383,3 +383,52 @@ IMG_UINT32 DBGDIOCDrivWaitForEvent(IMG_VOID * pvInBuffer, IMG_VOID * pvOutBuffer
 
 	return(IMG_TRUE);
 }
+
+IMG_UINT32 DBGDIOCDrivAcquireRead(IMG_VOID * pvInBuffer, IMG_VOID * pvOutBuffer)
+{
+	PDBG_IN_ACQUIREREAD		psInParams;
+	PDBG_OUT_ACQUIREREAD	psOutParams;
+
+	psInParams = (PDBG_IN_ACQUIREREAD) pvInBuffer;
+	psOutParams = (PDBG_OUT_ACQUIREREAD) pvOutBuffer;
+
+	psOutParams->ui32Offset = 0;
+	psOutParams->ui32Bytes = ExtDBGDrivAcquireRead((PDBG_STREAM) psInParams->pvStream,
+												   psInParams->bReadInitBuffer,
+												   psInParams->ui32Limit,
+												   &psOutParams->ui32Offset);
+
+	return(IMG_TRUE);
+}
+
+IMG_UINT32 DBGDIOCDrivReleaseRead(IMG_VOID * pvInBuffer, IMG_VOID * pvOutBuffer)
+{
+	PDBG_IN_RELEASEREAD	psInParams;
+	IMG_BOOL *			pbIntact;
+
+	psInParams = (PDBG_IN_RELEASEREAD) pvInBuffer;
+	pbIntact = (IMG_BOOL *) pvOutBuffer;
+
+	*pbIntact = ExtDBGDrivReleaseRead((PDBG_STREAM) psInParams->pvStream,
+									  psInParams->bReadInitBuffer,
+									  psInParams->ui32Offset,
+									  psInParams->ui32Bytes);
+
+	return(IMG_TRUE);
+}
+
+IMG_UINT32 DBGDIOCDrivMapStream(IMG_VOID * pvInBuffer, IMG_VOID * pvOutBuffer)
+{
+	PDBG_IN_MAPSTREAM	psInParams;
+	PDBG_OUT_MAPSTREAM	psOutParams;
+
+	psInParams = (PDBG_IN_MAPSTREAM) pvInBuffer;
+	psOutParams = (PDBG_OUT_MAPSTREAM) pvOutBuffer;
+
+	psOutParams->ui32Size = 0;
+	psOutParams->i32Fd = ExtDBGDrivMapStream((PDBG_STREAM) psInParams->pvStream,
+											 psInParams->bReadInitBuffer,
+											 &psOutParams->ui32Size);
+
+	return(IMG_TRUE);
+}
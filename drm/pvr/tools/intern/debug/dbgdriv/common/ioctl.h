@@ -48,6 +48,9 @@ IMG_UINT32 DBGDIOCDrivIsCaptureFrame(IMG_VOID *, IMG_VOID *);
 IMG_UINT32 DBGDIOCDrivWriteLF(IMG_VOID *, IMG_VOID *);
 IMG_UINT32 DBGDIOCDrivReadLF(IMG_VOID *, IMG_VOID *);
 IMG_UINT32 DBGDIOCDrivWaitForEvent(IMG_VOID*, IMG_VOID *);
+IMG_UINT32 DBGDIOCDrivAcquireRead(IMG_VOID *, IMG_VOID *);
+IMG_UINT32 DBGDIOCDrivReleaseRead(IMG_VOID *, IMG_VOID *);
+IMG_UINT32 DBGDIOCDrivMapStream(IMG_VOID *, IMG_VOID *);
 
 IMG_UINT32 (*g_DBGDrivProc[])(IMG_VOID *, IMG_VOID *) =
 {
@@ -74,7 +77,10 @@ IMG_UINT32 (*g_DBGDrivProc[])(IMG_VOID *, IMG_VOID *) =
 	DBGDIOCDrivIsCaptureFrame,
 	DBGDIOCDrivWriteLF,
 	DBGDIOCDrivReadLF,
-	DBGDIOCDrivWaitForEvent
+	DBGDIOCDrivWaitForEvent,
+	DBGDIOCDrivAcquireRead,
+	DBGDIOCDrivReleaseRead,
+	DBGDIOCDrivMapStream
 };
 
 #define MAX_DBGVXD_W32_API (sizeof(g_DBGDrivProc)/sizeof(IMG_UINT32))
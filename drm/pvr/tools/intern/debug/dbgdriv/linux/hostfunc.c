@@ -53,21 +53,23 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <asm/semaphore.h>
 #endif
 #include <linux/hardirq.h>
+#include <linux/sched.h>
 
 #if defined(SUPPORT_DBGDRV_EVENT_OBJECTS)
-#include <linux/sched.h>
 #include <linux/wait.h>
 #include <linux/jiffies.h>
 #include <linux/delay.h>
 #endif
 
 #include <linux/slab.h>
+#include <linux/anon_inodes.h>
 
 #include "img_types.h"
 #include "pvr_debug.h"
 
 #include "dbgdrvif.h"
 #include "dbgdriv/common/hostfunc.h"
+#include "dbgdriv/common/dbgdriv.h"
 
 #if !defined(SUPPORT_DRI_DRM)
 IMG_UINT32	gPVRDebugLevel = DBGPRIV_WARNING;
@@ -270,6 +272,118 @@ IMG_VOID HostUnMapKrnBufFromUser(IMG_VOID * pvUserAddr, IMG_VOID * pvMdl, IMG_VO
     /* FIXME: Not yet implemented */
 }
 
+/*
+	A file through which a reader maps one stream buffer read-only. It
+	holds the stream by handle: the stream is looked up again on every
+	mmap, and pages already mapped keep their own reference, so
+	destroying the stream cannot leave a mapping pointing at freed memory.
+*/
+typedef struct _DBG_STREAM_MAP_
+{
+	PDBG_STREAM psStream;
+	IMG_BOOL bReadInitBuffer;
+} DBG_STREAM_MAP;
+
+static int StreamMapMmap(struct file *psFile, struct vm_area_struct *psVMA)
+{
+	DBG_STREAM_MAP *psMap = psFile->private_data;
+	PDBG_STREAM psStream;
+	unsigned long ulSize = psVMA->vm_end - psVMA->vm_start;
+	unsigned long ulOffset;
+	int iErr = 0;
+
+	/* The reader only ever consumes; writers own the buffer */
+	if ((psVMA->vm_pgoff != 0) || (psVMA->vm_flags & VM_WRITE))
+	{
+		return -EINVAL;
+	}
+	psVMA->vm_flags &= ~VM_MAYWRITE;
+	psVMA->vm_flags |= VM_DONTEXPAND;
+
+	HostAquireMutex(g_pvAPIMutex);
+
+	if (!StreamValid(psMap->psStream))
+	{
+		iErr = -ENODEV;
+		goto ExitUnlock;
+	}
+
+	psStream = psMap->bReadInitBuffer ? psMap->psStream->psInitStream : psMap->psStream;
+	if (ulSize > psStream->ui32Size)
+	{
+		iErr = -EINVAL;
+		goto ExitUnlock;
+	}
+
+	/* The buffer comes from vmalloc, so it is mapped a page at a time */
+	for (ulOffset = 0; ulOffset < ulSize; ulOffset += PAGE_SIZE)
+	{
+		iErr = vm_insert_page(psVMA, psVMA->vm_start + ulOffset,
+							  vmalloc_to_page((IMG_VOID *)(psStream->ui32Base + ulOffset)));
+		if (iErr)
+		{
+			break;
+		}
+	}
+
+ExitUnlock:
+	HostReleaseMutex(g_pvAPIMutex);
+
+	return iErr;
+}
+
+static int StreamMapRelease(struct inode *psInode, struct file *psFile)
+{
+	kfree(psFile->private_data);
+
+	return 0;
+}
+
+static const struct file_operations sStreamMapFops =
+{
+	.owner		= THIS_MODULE,
+	.mmap		= StreamMapMmap,
+	.release	= StreamMapRelease,
+};
+
+/*!
+******************************************************************************
+
+ @Function     HostMapStream
+
+ @Description  Create a file descriptor whose mmap gives read-only access
+               to a stream buffer, for readers that consume the stream in
+               place. Called with the API mutex held.
+
+ @Input psStream:        The stream
+ @Input bReadInitBuffer: Map the init stream rather than the main stream
+
+ @Return the file descriptor, or a negative error code
+******************************************************************************/
+IMG_INT32 HostMapStream(PDBG_STREAM psStream, IMG_BOOL bReadInitBuffer)
+{
+	DBG_STREAM_MAP *psMap;
+	int iFd;
+
+	psMap = kmalloc(sizeof(*psMap), GFP_KERNEL);
+	if (!psMap)
+	{
+		return -ENOMEM;
+	}
+
+	psMap->psStream = psStream;
+	psMap->bReadInitBuffer = bReadInitBuffer;
+
+	iFd = anon_inode_getfd("dbgdrv_stream", &sStreamMapFops, psMap, O_RDONLY | O_CLOEXEC);
+	if (iFd < 0)
+	{
+		PVR_DPF((PVR_DBG_ERROR, "HostMapStream: failed to create fd (%d)", iFd));
+		kfree(psMap);
+	}
+
+	return iFd;
+}
+
 IMG_VOID HostCreateRegDeclStreams(IMG_VOID)
 {
     /* FIXME: Not yet implemented */
@@ -316,6 +430,37 @@ IMG_VOID HostDestroyMutex(IMG_VOID * pvMutex)
 	}
 }
 
+/*!
+******************************************************************************
+
+ @Function		HostAtomicCmpXchg
+
+ @Description	Atomically replaces *pui32Addr with ui32New if it still
+				holds ui32Old. Used by the lock-free stream ring.
+
+ @Input    pui32Addr - location to update
+ @Input    ui32Old - expected value
+ @Input    ui32New - replacement value
+
+ @Return   value of *pui32Addr before the operation
+
+******************************************************************************/
+IMG_UINT32 HostAtomicCmpXchg(IMG_UINT32 *pui32Addr, IMG_UINT32 ui32Old, IMG_UINT32 ui32New)
+{
+	return cmpxchg((u32 *)pui32Addr, (u32)ui32Old, (u32)ui32New);
+}
+
+IMG_VOID HostMemoryBarrier(IMG_VOID)
+{
+	smp_mb();
+}
+
+IMG_VOID HostYield(IMG_VOID)
+{
+	cpu_relax();
+	cond_resched();
+}
+
 #if defined(SUPPORT_DBGDRV_EVENT_OBJECTS)
 
 #define	EVENT_WAIT_TIMEOUT_MS	500
@@ -324,9 +469,13 @@ IMG_VOID HostDestroyMutex(IMG_VOID * pvMutex)
 static int iStreamData;
 static wait_queue_head_t sStreamDataEvent;
 
+static int iStreamSpace;
+static wait_queue_head_t sStreamSpaceEvent;
+
 IMG_INT32 HostCreateEventObjects(IMG_VOID)
 {
 	init_waitqueue_head(&sStreamDataEvent);
+	init_waitqueue_head(&sStreamSpaceEvent);
 
 	return 0;
 }
@@ -344,6 +493,16 @@ IMG_VOID HostWaitForEvent(DBG_EVENT eEvent)
 			wait_event_interruptible_timeout(sStreamDataEvent, iStreamData != 0, EVENT_WAIT_TIMEOUT_JIFFIES);
 			iStreamData = 0;
 			break;
+		case DBG_EVENT_STREAM_SPACE:
+			/*
+			 * A writer waiting for the reader to drain a full
+			 * stream. The reader signals after every read, so
+			 * discard any stale signal and wait for the next one;
+			 * the writer re-checks the space itself.
+			 */
+			iStreamSpace = 0;
+			wait_event_interruptible_timeout(sStreamSpaceEvent, iStreamSpace != 0, EVENT_WAIT_TIMEOUT_JIFFIES);
+			break;
 		default:
 			/*
 			 * For unknown events, enter an interruptible sleep.
@@ -361,6 +520,10 @@ IMG_VOID HostSignalEvent(DBG_EVENT eEvent)
 			iStreamData = 1;
 			wake_up_interruptible(&sStreamDataEvent);
 			break;
+		case DBG_EVENT_STREAM_SPACE:
+			iStreamSpace = 1;
+			wake_up_interruptible(&sStreamSpaceEvent);
+			break;
 		default:
 			break;
 	}
@@ -0,0 +1,315 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: emgd_cursor_bench.c
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Measures cursor image updates per second for the loaders in
+ *  display/mode/cmn/cursor.c (linked unchanged) against the per-pixel
+ *  igd_fb_to_screen() loops igd_alter_cursor() used before, for each of
+ *  the 8 rotate/flip combinations:
+ *   - old:     clear the cursor, then transform every pixel,
+ *   - new:     hash the image and load it into the back image,
+ *   - cached:  cycle through two images, as an animated cursor does;
+ *              after the first two loads both are found by hash.
+ *  Every combination's output is compared with the old loops' (ARGB at
+ *  64x64 and 48x40, and 2bpp); a mismatch makes the exit status non-zero.
+ *
+ *  Usage:
+ *   emgd_cursor_bench [-n updates]
+ *-----------------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cursor.h"
+
+/* The rotation/flip part of igd_fb_to_screen() */
+static void fb_to_screen(unsigned short rotation, unsigned char do_flip,
+	unsigned short front_width, unsigned short front_height,
+	unsigned short *x, unsigned short *y)
+{
+	unsigned short x_temp = *x;
+	unsigned short y_temp = *y;
+
+	switch(rotation) {
+	case 0:
+	default:
+		if(do_flip) {
+			*x = front_width-1 - x_temp;
+		}
+		break;
+	case 90:
+		*x = y_temp;
+		*y = (front_height - 1) - x_temp;
+		if(do_flip) {
+			*y = front_height-1 - *y ;
+		}
+		break;
+	case 180:
+		*x = (front_width -1) -  x_temp;
+		*y = (front_height-1) - y_temp;
+		if(do_flip) {
+			*x = (front_width -1) - *x;
+		}
+		break;
+	case 270:
+		*x = (front_width - 1) - y_temp;
+		*y=  x_temp;
+		if(do_flip) {
+			*y = (front_height -1) - *y;
+		}
+		break;
+	}
+}
+
+/* igd_alter_cursor()'s ARGB load before cursor.c, including the clear */
+static void old_load_argb(unsigned int *cursor, unsigned int *image,
+	int rotate, int flip, int width, int height)
+{
+	int w = width > 64 ? 64 : width;
+	int h = height > 64 ? 64 : height;
+	unsigned short nx, ny;
+	unsigned int *i;
+	int x, y;
+
+	memset(cursor, 0, CURSOR_ARGB_SIZE);
+	for (y = 0; y < h; y++) {
+		i = image;
+		image += width;
+		for (x = 0; x < w; x++) {
+			nx = (unsigned short) x;
+			ny = (unsigned short) y;
+			fb_to_screen((unsigned short) rotate, (unsigned char) flip,
+				64, 64, &nx, &ny);
+			cursor[nx + (64 * ny)] = *i++;
+		}
+	}
+}
+
+/* load_xor_cursor_image() before cursor.c, for a 64x64 image */
+static void old_load_xor(unsigned char *cursor, unsigned char *image,
+	int rotate, int flip)
+{
+	int j, x, y;
+	int pixel_num, byte_num, line_num;
+	int npixel_num, nbyte_num, nline_num, nbit_num;
+	unsigned short nx, ny;
+	unsigned char b_val, sbit, mask, pixel;
+
+	for (j = 0; j < 2; j++) {
+		cursor += (j * 8);
+		image += (j * 8);
+		for (y = 0; y < 64; y++) {
+			for (x = 0; x < 64; x++) {
+				pixel_num = x + (y * 64);
+				line_num = pixel_num / 64;
+				byte_num = (pixel_num & 63) / 8;
+				b_val = *(image + (16 * line_num) + byte_num);
+				pixel = (b_val >> ( 7 - (pixel_num & 7))) & 0x01;
+
+				nx = (unsigned short) x;
+				ny = (unsigned short) y;
+				fb_to_screen((unsigned short) rotate, (unsigned char) flip,
+					64, 64, &nx, &ny);
+				npixel_num = nx + (ny * 64);
+				nline_num = npixel_num / 64;
+				nbyte_num = (npixel_num & 63) / 8;
+				nbit_num = 7 - (npixel_num & 7);
+				b_val = *(cursor + (16 * nline_num) + nbyte_num);
+
+				sbit = pixel << nbit_num;
+				mask = 0x01 << nbit_num;
+				b_val = (b_val & ~mask) | sbit;
+				*(cursor + (16 * nline_num) + nbyte_num) = b_val;
+			}
+		}
+	}
+}
+
+/* The ARGB double buffering igd_alter_cursor() does around cursor.c */
+typedef struct _cursor_sim {
+	unsigned int *front;
+	unsigned int *back;
+	unsigned long long front_hash;
+	unsigned long long back_hash;
+	unsigned long loads;
+} cursor_sim_t;
+
+static void new_alter(cursor_sim_t *c, unsigned int *image, int rotate,
+	int flip, int width, int height)
+{
+	unsigned long long hash;
+	unsigned int *tmp;
+
+	hash = cursor_argb_hash(image, rotate, flip, width, height);
+	if (hash != c->front_hash && hash != c->back_hash) {
+		cursor_load_argb(c->back, image, rotate, flip, width, height);
+		c->back_hash = hash;
+		c->loads++;
+	}
+	if (hash == c->back_hash) {
+		tmp = c->front;
+		c->front = c->back;
+		c->back = tmp;
+		c->back_hash = c->front_hash;
+		c->front_hash = hash;
+	}
+}
+
+static double now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+static unsigned int image[2][64 * 64];
+static unsigned int small[48 * 40];
+static unsigned char xor_image[CURSOR_XOR_SIZE];
+static unsigned int argb_a[64 * 64], argb_b[64 * 64];
+static unsigned char xor_a[CURSOR_XOR_SIZE], xor_b[CURSOR_XOR_SIZE];
+
+static int check(int rotate, int flip)
+{
+	int failed = 0;
+
+	old_load_argb(argb_a, image[0], rotate, flip, 64, 64);
+	memset(argb_b, 0xa5, sizeof(argb_b));
+	cursor_load_argb(argb_b, image[0], rotate, flip, 64, 64);
+	failed |= memcmp(argb_a, argb_b, sizeof(argb_a)) != 0;
+
+	old_load_argb(argb_a, small, rotate, flip, 48, 40);
+	memset(argb_b, 0xa5, sizeof(argb_b));
+	cursor_load_argb(argb_b, small, rotate, flip, 48, 40);
+	failed |= memcmp(argb_a, argb_b, sizeof(argb_a)) != 0;
+
+	memset(xor_a, 0x5a, sizeof(xor_a));
+	old_load_xor(xor_a, xor_image, rotate, flip);
+	memset(xor_b, 0xa5, sizeof(xor_b));
+	cursor_load_xor(xor_b, xor_image, rotate, flip);
+	failed |= memcmp(xor_a, xor_b, sizeof(xor_a)) != 0;
+
+	return failed;
+}
+
+int main(int argc, char *argv[])
+{
+	static unsigned int cursor_mem[2][64 * 64];
+	unsigned long updates = 20000, n, i;
+	cursor_sim_t sim;
+	double t, old_ups, new_ups, cached_ups, xor_old, xor_new;
+	int rotate, flip, opt, failed = 0;
+
+	while ((opt = getopt(argc, argv, "n:")) != -1) {
+		switch (opt) {
+		case 'n':
+			updates = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			fprintf(stderr, "Usage: %s [-n updates]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (!updates) {
+		updates = 1;
+	}
+
+	srand(1);
+	for (i = 0; i < 64 * 64; i++) {
+		image[0][i] = (unsigned int)rand();
+		image[1][i] = (unsigned int)rand();
+	}
+	for (i = 0; i < 48 * 40; i++) {
+		small[i] = (unsigned int)rand();
+	}
+	for (i = 0; i < CURSOR_XOR_SIZE; i++) {
+		xor_image[i] = (unsigned char)rand();
+	}
+
+	printf("%lu updates per measurement, updates per second\n\n", updates);
+	printf("%-8s %10s %10s %10s %8s %10s %10s %6s\n", "rot/flip", "old",
+		"new", "cached", "loads", "xor old", "xor new", "match");
+
+	for (rotate = 0; rotate < 360; rotate += 90) {
+		for (flip = 0; flip < 2; flip++) {
+			t = now_us();
+			for (n = 0; n < updates; n++) {
+				/* Alternate images so nothing can be skipped */
+				image[0][0] = (unsigned int)n;
+				old_load_argb(cursor_mem[n & 1], image[0], rotate, flip,
+					64, 64);
+			}
+			old_ups = updates / ((now_us() - t) / 1000000.0);
+
+			memset(&sim, 0, sizeof(sim));
+			sim.front = cursor_mem[0];
+			sim.back = cursor_mem[1];
+			t = now_us();
+			for (n = 0; n < updates; n++) {
+				image[0][0] = (unsigned int)n;
+				new_alter(&sim, image[0], rotate, flip, 64, 64);
+			}
+			new_ups = updates / ((now_us() - t) / 1000000.0);
+
+			memset(&sim, 0, sizeof(sim));
+			sim.front = cursor_mem[0];
+			sim.back = cursor_mem[1];
+			t = now_us();
+			for (n = 0; n < updates; n++) {
+				new_alter(&sim, image[n & 1], rotate, flip, 64, 64);
+			}
+			cached_ups = updates / ((now_us() - t) / 1000000.0);
+
+			t = now_us();
+			for (n = 0; n < updates; n++) {
+				xor_image[0] = (unsigned char)n;
+				old_load_xor((unsigned char *)cursor_mem[0], xor_image,
+					rotate, flip);
+			}
+			xor_old = updates / ((now_us() - t) / 1000000.0);
+
+			t = now_us();
+			for (n = 0; n < updates; n++) {
+				xor_image[0] = (unsigned char)n;
+				cursor_load_xor((unsigned char *)cursor_mem[0], xor_image,
+					rotate, flip);
+			}
+			xor_new = updates / ((now_us() - t) / 1000000.0);
+
+			i = check(rotate, flip);
+			failed |= i;
+			printf("%3d/%-4d %10.0f %10.0f %10.0f %8lu %10.0f %10.0f %6s\n",
+				rotate, flip, old_ups, new_ups, cached_ups, sim.loads,
+				xor_old, xor_new, i ? "NO" : "yes");
+		}
+	}
+
+	return failed;
+}
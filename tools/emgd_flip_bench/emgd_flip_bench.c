@@ -0,0 +1,419 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: emgd_flip_bench.c
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Measures page flip throughput and latency through the KMS page flip
+ *  ioctl. It is meant to run against the virtual Atom E6xx (driver built
+ *  with VIRTUAL_TNC=1 and loaded with vtnc=1), but works on hardware too.
+ *
+ *  The tool wraps the framebuffer scanned out by the first active CRTC in
+ *  a second framebuffer object, then flips between the two with completion
+ *  events, one flip in flight at a time. Both objects share the initial
+ *  framebuffer (handle 0), so no PVR services are needed.
+ *
+ *  For each flip it records the time from the ioctl to the event being
+ *  read, and from the ioctl to the vblank the event was stamped with.
+ *  Flips that completed more than one frame after the previous one count
+ *  as missed frames.
+ *
+ *  Usage:
+ *   emgd_flip_bench [flips] [refresh-hz] [device]
+ *
+ *  flips defaults to 600, device to /dev/dri/card0 and refresh-hz to the
+ *  refresh rate of the CRTC's mode; pass the vtnc_refresh value when the
+ *  virtual device runs at another rate than its panel mode.
+ *-----------------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <stdint.h>
+#include <sys/ioctl.h>
+
+/*
+ * The subset of the DRM/KMS userspace interface used here, so the tool
+ * does not depend on libdrm or the kernel headers being installed.
+ */
+#define DRM_IOCTL_BASE                'd'
+#define DRM_IOWR(nr, type)            _IOWR(DRM_IOCTL_BASE, nr, type)
+
+struct drm_mode_card_res {
+	uint64_t fb_id_ptr;
+	uint64_t crtc_id_ptr;
+	uint64_t connector_id_ptr;
+	uint64_t encoder_id_ptr;
+	uint32_t count_fbs;
+	uint32_t count_crtcs;
+	uint32_t count_connectors;
+	uint32_t count_encoders;
+	uint32_t min_width, max_width;
+	uint32_t min_height, max_height;
+};
+
+struct drm_mode_modeinfo {
+	uint32_t clock;
+	uint16_t hdisplay, hsync_start, hsync_end, htotal, hskew;
+	uint16_t vdisplay, vsync_start, vsync_end, vtotal, vscan;
+	uint32_t vrefresh;
+	uint32_t flags;
+	uint32_t type;
+	char name[32];
+};
+
+struct drm_mode_crtc {
+	uint64_t set_connectors_ptr;
+	uint32_t count_connectors;
+	uint32_t crtc_id;
+	uint32_t fb_id;
+	uint32_t x, y;
+	uint32_t gamma_size;
+	uint32_t mode_valid;
+	struct drm_mode_modeinfo mode;
+};
+
+struct drm_mode_fb_cmd {
+	uint32_t fb_id;
+	uint32_t width, height;
+	uint32_t pitch;
+	uint32_t bpp;
+	uint32_t depth;
+	uint32_t handle;
+};
+
+struct drm_mode_crtc_page_flip {
+	uint32_t crtc_id;
+	uint32_t fb_id;
+	uint32_t flags;
+	uint32_t reserved;
+	uint64_t user_data;
+};
+
+struct drm_event {
+	uint32_t type;
+	uint32_t length;
+};
+
+struct drm_event_vblank {
+	struct drm_event base;
+	uint64_t user_data;
+	uint32_t tv_sec;
+	uint32_t tv_usec;
+	uint32_t sequence;
+	uint32_t reserved;
+};
+
+#define DRM_IOCTL_MODE_GETRESOURCES   DRM_IOWR(0xA0, struct drm_mode_card_res)
+#define DRM_IOCTL_MODE_GETCRTC        DRM_IOWR(0xA1, struct drm_mode_crtc)
+#define DRM_IOCTL_MODE_GETFB          DRM_IOWR(0xAD, struct drm_mode_fb_cmd)
+#define DRM_IOCTL_MODE_ADDFB          DRM_IOWR(0xAE, struct drm_mode_fb_cmd)
+#define DRM_IOCTL_MODE_RMFB           DRM_IOWR(0xAF, unsigned int)
+#define DRM_IOCTL_MODE_PAGE_FLIP      DRM_IOWR(0xB0, struct drm_mode_crtc_page_flip)
+
+#define DRM_MODE_PAGE_FLIP_EVENT      0x01
+#define DRM_EVENT_FLIP_COMPLETE       0x02
+
+/* Handle of the initial framebuffer, see EMGD_INITIAL_FRAMEBUFFER */
+#define INITIAL_FRAMEBUFFER           0
+
+#define MAX_CRTCS                     8
+#define EVENT_TIMEOUT_MS              1000
+
+typedef struct _lat_stats {
+	unsigned long count;
+	double min_us;
+	double max_us;
+	double total_us;
+} lat_stats_t;
+
+static double now_us(clockid_t clock)
+{
+	struct timespec ts;
+
+	clock_gettime(clock, &ts);
+	return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+static void lat_add(lat_stats_t *s, double us)
+{
+	if (!s->count || us < s->min_us) {
+		s->min_us = us;
+	}
+	if (!s->count || us > s->max_us) {
+		s->max_us = us;
+	}
+	s->total_us += us;
+	s->count++;
+}
+
+static void lat_print(const char *name, const lat_stats_t *s)
+{
+	if (!s->count) {
+		printf("%-20s no samples\n", name);
+		return;
+	}
+	printf("%-20s min %9.1f  avg %9.1f  max %9.1f us\n", name,
+		s->min_us, s->total_us / s->count, s->max_us);
+}
+
+static int do_ioctl(int fd, unsigned long request, void *arg)
+{
+	int ret;
+
+	do {
+		ret = ioctl(fd, request, arg);
+	} while (ret == -1 && (errno == EINTR || errno == EAGAIN));
+	return ret;
+}
+
+/* Returns the id of the first CRTC that scans out a framebuffer, or 0. */
+static uint32_t find_crtc(int fd, struct drm_mode_crtc *crtc)
+{
+	struct drm_mode_card_res res;
+	uint32_t crtc_ids[MAX_CRTCS];
+	uint32_t i;
+
+	memset(&res, 0, sizeof(res));
+	if (do_ioctl(fd, DRM_IOCTL_MODE_GETRESOURCES, &res)) {
+		perror("DRM_IOCTL_MODE_GETRESOURCES");
+		return 0;
+	}
+	if (res.count_crtcs > MAX_CRTCS) {
+		res.count_crtcs = MAX_CRTCS;
+	}
+
+	/* Second call fills in only the CRTC ids */
+	res.fb_id_ptr = 0;
+	res.connector_id_ptr = 0;
+	res.encoder_id_ptr = 0;
+	res.count_fbs = 0;
+	res.count_connectors = 0;
+	res.count_encoders = 0;
+	res.crtc_id_ptr = (uint64_t)(unsigned long)crtc_ids;
+	if (do_ioctl(fd, DRM_IOCTL_MODE_GETRESOURCES, &res)) {
+		perror("DRM_IOCTL_MODE_GETRESOURCES");
+		return 0;
+	}
+
+	for (i = 0; i < res.count_crtcs && i < MAX_CRTCS; i++) {
+		memset(crtc, 0, sizeof(*crtc));
+		crtc->crtc_id = crtc_ids[i];
+		if (do_ioctl(fd, DRM_IOCTL_MODE_GETCRTC, crtc)) {
+			continue;
+		}
+		if (crtc->fb_id && crtc->mode_valid) {
+			return crtc->crtc_id;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Waits for the flip completion event. Returns 0 and the vblank stamp in
+ * microseconds, or -1 on timeout or error.
+ */
+static int wait_flip(int fd, double *vblank_us)
+{
+	char buf[1024];
+	struct pollfd pfd;
+	struct drm_event *e;
+	struct drm_event_vblank *vbl;
+	ssize_t len, i;
+
+	pfd.fd = fd;
+	pfd.events = POLLIN;
+
+	for (;;) {
+		if (poll(&pfd, 1, EVENT_TIMEOUT_MS) <= 0) {
+			fprintf(stderr, "No flip completion event within %dms\n",
+				EVENT_TIMEOUT_MS);
+			return -1;
+		}
+		len = read(fd, buf, sizeof(buf));
+		if (len < (ssize_t)sizeof(struct drm_event)) {
+			continue;
+		}
+		for (i = 0; i + (ssize_t)sizeof(*e) <= len; i += e->length) {
+			e = (struct drm_event *)&buf[i];
+			if (e->length < sizeof(*e)) {
+				break;
+			}
+			if (e->type == DRM_EVENT_FLIP_COMPLETE) {
+				vbl = (struct drm_event_vblank *)e;
+				*vblank_us = vbl->tv_sec * 1000000.0 + vbl->tv_usec;
+				return 0;
+			}
+		}
+	}
+}
+
+static int flip(int fd, uint32_t crtc_id, uint32_t fb_id)
+{
+	struct drm_mode_crtc_page_flip pf;
+
+	memset(&pf, 0, sizeof(pf));
+	pf.crtc_id = crtc_id;
+	pf.fb_id = fb_id;
+	pf.flags = DRM_MODE_PAGE_FLIP_EVENT;
+	pf.user_data = fb_id;
+	if (do_ioctl(fd, DRM_IOCTL_MODE_PAGE_FLIP, &pf)) {
+		perror("DRM_IOCTL_MODE_PAGE_FLIP");
+		return -1;
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *device = "/dev/dri/card0";
+	unsigned long flips = 600, i, missed = 0;
+	double refresh = 0, frame_us;
+	struct drm_mode_crtc crtc;
+	struct drm_mode_fb_cmd fb;
+	uint32_t crtc_id, fb_ids[2];
+	lat_stats_t to_event, to_vblank, interval;
+	double submit_mono, submit_real, vblank, last_vblank = 0;
+	double start, elapsed;
+	clockid_t stamp_clock = CLOCK_REALTIME;
+	int fd, ret = 1;
+
+	if (argc > 1) {
+		flips = strtoul(argv[1], NULL, 0);
+	}
+	if (argc > 2) {
+		refresh = strtod(argv[2], NULL);
+	}
+	if (argc > 3) {
+		device = argv[3];
+	}
+	if (!flips) {
+		fprintf(stderr, "Usage: %s [flips] [refresh-hz] [device]\n", argv[0]);
+		return 1;
+	}
+
+	fd = open(device, O_RDWR);
+	if (fd < 0) {
+		perror(device);
+		return 1;
+	}
+
+	crtc_id = find_crtc(fd, &crtc);
+	if (!crtc_id) {
+		fprintf(stderr, "No active CRTC on %s\n", device);
+		goto out_close;
+	}
+	if (!refresh) {
+		refresh = crtc.mode.vrefresh;
+		if (!refresh && crtc.mode.htotal && crtc.mode.vtotal) {
+			refresh = crtc.mode.clock * 1000.0 /
+				(crtc.mode.htotal * crtc.mode.vtotal);
+		}
+	}
+	frame_us = refresh > 0 ? 1000000.0 / refresh : 0;
+
+	/* Wrap the scanned out framebuffer in a second object to flip to */
+	memset(&fb, 0, sizeof(fb));
+	fb.fb_id = crtc.fb_id;
+	if (do_ioctl(fd, DRM_IOCTL_MODE_GETFB, &fb)) {
+		perror("DRM_IOCTL_MODE_GETFB");
+		goto out_close;
+	}
+	fb_ids[0] = crtc.fb_id;
+	fb.fb_id = 0;
+	fb.handle = INITIAL_FRAMEBUFFER;
+	if (do_ioctl(fd, DRM_IOCTL_MODE_ADDFB, &fb)) {
+		perror("DRM_IOCTL_MODE_ADDFB");
+		goto out_close;
+	}
+	fb_ids[1] = fb.fb_id;
+
+	printf("CRTC %u: %ux%u@%.1fHz, fb %u/%u (%ux%u, %u bpp), %lu flips\n",
+		crtc_id, crtc.mode.hdisplay, crtc.mode.vdisplay, refresh,
+		fb_ids[0], fb_ids[1], fb.width, fb.height, fb.bpp, flips);
+
+	memset(&to_event, 0, sizeof(to_event));
+	memset(&to_vblank, 0, sizeof(to_vblank));
+	memset(&interval, 0, sizeof(interval));
+
+	start = now_us(CLOCK_MONOTONIC);
+	for (i = 0; i < flips; i++) {
+		submit_mono = now_us(CLOCK_MONOTONIC);
+		submit_real = now_us(stamp_clock);
+		if (flip(fd, crtc_id, fb_ids[(i + 1) & 1])) {
+			goto out_rmfb;
+		}
+		if (wait_flip(fd, &vblank)) {
+			goto out_rmfb;
+		}
+		lat_add(&to_event, now_us(CLOCK_MONOTONIC) - submit_mono);
+
+		/*
+		 * The driver stamps events with the wall clock; fall back to the
+		 * monotonic clock if the first stamp is nowhere near it.
+		 */
+		if (i == 0 && (vblank < submit_real - 1000000.0 ||
+			vblank > submit_real + 1000000.0)) {
+			stamp_clock = CLOCK_MONOTONIC;
+			submit_real = submit_mono;
+		}
+		lat_add(&to_vblank, vblank - submit_real);
+
+		if (i > 0) {
+			lat_add(&interval, vblank - last_vblank);
+			if (frame_us > 0 && vblank - last_vblank > frame_us * 1.5) {
+				missed += (unsigned long)
+					((vblank - last_vblank) / frame_us + 0.5) - 1;
+			}
+		}
+		last_vblank = vblank;
+	}
+	elapsed = now_us(CLOCK_MONOTONIC) - start;
+
+	printf("%.1f flips/s over %.3fs, %lu missed frames\n",
+		flips * 1000000.0 / elapsed, elapsed / 1000000.0, missed);
+	lat_print("submit to event", &to_event);
+	lat_print("submit to vblank", &to_vblank);
+	lat_print("vblank interval", &interval);
+	ret = 0;
+
+out_rmfb:
+	/* Leave the original framebuffer on screen */
+	if (i & 1) {
+		if (!flip(fd, crtc_id, fb_ids[0])) {
+			wait_flip(fd, &vblank);
+		}
+	}
+	do_ioctl(fd, DRM_IOCTL_MODE_RMFB, &fb_ids[1]);
+out_close:
+	close(fd);
+	return ret;
+}
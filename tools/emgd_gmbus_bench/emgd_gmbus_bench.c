@@ -0,0 +1,278 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: emgd_gmbus_bench.c
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Benchmarks the Atom E6xx GMBUS I2C code (i2c_gmbus_tnc.c, linked
+ *  unchanged) against the register model in gmbus_user.c. For each
+ *  operation it reports the wall clock latency, the CPU time spent, and
+ *  the number of GMBUS register reads and sleeps:
+ *   - EDID fetch: 128 bytes from 0xA0 through the sDVO DDC bus switch,
+ *   - sDVO register read: one byte from 0x70,
+ *   - sDVO register list write: 8 registers to 0x70,
+ *   - the same write as one burst (IGD_I2C_SERIAL_WRITE), the way an sDVO
+ *     command's arguments and opcode go out,
+ *   - sDVO burst read: status and 8 return registers in one transfer.
+ *  The EDID read back is compared with the model's, and a burst write is
+ *  read back with a burst read before timing starts; a mismatch makes the
+ *  exit status non-zero.
+ *
+ *  Usage:
+ *   emgd_gmbus_bench [-n rounds] [-l read-latency-ns] [-a]
+ *
+ *  -a leaves out IGD_I2C_CAN_SLEEP, as callers that may be in atomic
+ *  context do, so the driver polls instead of sleeping.
+ *-----------------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <igd_mode.h>
+#include <context.h>
+#include <mode.h>
+#include <pd.h>
+#include <tnc/regs.h>
+#include "i2c_dispatch.h"
+#include "gmbus_user.h"
+
+extern i2c_dispatch_t i2c_dispatch_tnc;
+extern igd_display_port_t dvob_port_tnc;
+
+#define EDID_BYTES   128
+#define SDVO_ADDR    0x70
+#define DDC_ADDR     0xA0
+
+/* IGD_I2C_CAN_SLEEP unless -a asks for the paths atomic callers take */
+static unsigned long i2c_flags = IGD_I2C_CAN_SLEEP;
+
+typedef struct _op_stats {
+	const char *name;
+	unsigned long count;
+	unsigned long failed;
+	double wall_us;
+	double max_wall_us;
+	double cpu_us;
+	unsigned long reads;
+	unsigned long sleeps;
+} op_stats_t;
+
+static double now_us(clockid_t clock)
+{
+	struct timespec ts;
+
+	clock_gettime(clock, &ts);
+	return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+static unsigned char edid[EDID_BYTES];
+
+static int op_edid(void)
+{
+	memset(edid, 0, sizeof(edid));
+	if (i2c_dispatch_tnc.i2c_read_regs(NULL, GMBUS_DVOB_DDC, 100, DDC_ADDR,
+			0, edid, EDID_BYTES, i2c_flags)) {
+		return 1;
+	}
+	return memcmp(edid, gmbus_user_edid, EDID_BYTES) != 0;
+}
+
+static int op_sdvo_read(void)
+{
+	unsigned char value;
+
+	return i2c_dispatch_tnc.i2c_read_regs(NULL, GMBUS_DVO_REG, 1000,
+		SDVO_ADDR, 0x09, &value, 1, i2c_flags);
+}
+
+static int op_sdvo_write(void)
+{
+	pd_reg_t list[9];
+	int i;
+
+	for (i = 0; i < 8; i++) {
+		list[i].reg = i;
+		list[i].value = 0x10 + i;
+	}
+	list[8].reg = PD_REG_LIST_END;
+
+	return i2c_dispatch_tnc.i2c_write_reg_list(NULL, GMBUS_DVO_REG, 1000,
+		SDVO_ADDR, list, i2c_flags);
+}
+
+static int op_sdvo_burst_write(void)
+{
+	pd_reg_t list[10];
+	int i;
+
+	for (i = 0; i < 9; i++) {
+		list[i].reg = i;
+		list[i].value = 0x10 + i;
+	}
+	list[9].reg = PD_REG_LIST_END;
+
+	return i2c_dispatch_tnc.i2c_write_reg_list(NULL, GMBUS_DVO_REG, 1000,
+		SDVO_ADDR, list, IGD_I2C_SERIAL_WRITE | i2c_flags);
+}
+
+static int op_sdvo_burst_read(void)
+{
+	unsigned char value[9];
+
+	return i2c_dispatch_tnc.i2c_read_regs(NULL, GMBUS_DVO_REG, 1000,
+		SDVO_ADDR, 0x09, value, 9, i2c_flags);
+}
+
+/* Writes 8 registers in one burst and reads them back in one burst */
+static int check_burst(void)
+{
+	pd_reg_t list[9];
+	unsigned char value[8];
+	int i;
+
+	gmbus_user_reset();
+	for (i = 0; i < 8; i++) {
+		list[i].reg = 0x20 + i;
+		list[i].value = 0x5a ^ i;
+	}
+	list[8].reg = PD_REG_LIST_END;
+
+	if (i2c_dispatch_tnc.i2c_write_reg_list(NULL, GMBUS_DVO_REG, 1000,
+			SDVO_ADDR, list, IGD_I2C_SERIAL_WRITE | i2c_flags) ||
+		i2c_dispatch_tnc.i2c_read_regs(NULL, GMBUS_DVO_REG, 1000,
+			SDVO_ADDR, 0x20, value, 8, i2c_flags)) {
+		return 1;
+	}
+	for (i = 0; i < 8; i++) {
+		if (value[i] != list[i].value) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static void run(op_stats_t *s, int (*op)(void))
+{
+	double wall, cpu;
+
+	gmbus_user_reset();
+	wall = now_us(CLOCK_MONOTONIC);
+	cpu = now_us(CLOCK_PROCESS_CPUTIME_ID);
+	if (op()) {
+		s->failed++;
+	}
+	cpu = now_us(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+	wall = now_us(CLOCK_MONOTONIC) - wall;
+
+	s->count++;
+	s->wall_us += wall;
+	s->cpu_us += cpu;
+	if (wall > s->max_wall_us) {
+		s->max_wall_us = wall;
+	}
+	s->reads += gmbus_user_reads;
+	s->sleeps += gmbus_user_sleeps;
+}
+
+static void report(const op_stats_t *s)
+{
+	if (!s->count) {
+		return;
+	}
+	printf("%-24s %9.1f %9.1f %9.1f %5.1f%% %8.1f %7.1f %6lu\n", s->name,
+		s->wall_us / s->count, s->max_wall_us, s->cpu_us / s->count,
+		s->wall_us ? 100.0 * s->cpu_us / s->wall_us : 0.0,
+		(double)s->reads / s->count, (double)s->sleeps / s->count,
+		s->failed);
+}
+
+int main(int argc, char *argv[])
+{
+	op_stats_t stats[5] = {
+		{ "EDID fetch (sDVO DDC)" },
+		{ "sDVO register read" },
+		{ "sDVO register write x8" },
+		{ "sDVO burst write x9" },
+		{ "sDVO burst read x9" },
+	};
+	unsigned long rounds = 50, i;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:l:a")) != -1) {
+		switch (opt) {
+		case 'n':
+			rounds = strtoul(optarg, NULL, 0);
+			break;
+		case 'l':
+			gmbus_user_read_ns = strtoul(optarg, NULL, 0);
+			break;
+		case 'a':
+			i2c_flags = 0;
+			break;
+		default:
+			fprintf(stderr, "Usage: %s [-n rounds] [-l read-latency-ns] "
+				"[-a]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	for (i = 0; i < EDID_BYTES; i++) {
+		gmbus_user_edid[i] = (unsigned char)(i * 7 + 3);
+	}
+	dvob_port_tnc.dab = SDVO_ADDR;
+
+	if (check_burst()) {
+		fprintf(stderr, "Burst write did not read back\n");
+		return 1;
+	}
+
+	for (i = 0; i < rounds; i++) {
+		run(&stats[0], op_edid);
+		run(&stats[1], op_sdvo_read);
+		run(&stats[2], op_sdvo_write);
+		run(&stats[3], op_sdvo_burst_write);
+		run(&stats[4], op_sdvo_burst_read);
+	}
+
+	printf("%lu rounds, %lu ns per GMBUS register read, %s context\n\n",
+		rounds, gmbus_user_read_ns,
+		(i2c_flags & IGD_I2C_CAN_SLEEP) ? "process" : "atomic");
+	printf("%-24s %9s %9s %9s %6s %8s %7s %6s\n", "operation", "avg us",
+		"max us", "cpu us", "cpu", "reads", "sleeps", "failed");
+	for (i = 0; i < 5; i++) {
+		report(&stats[i]);
+	}
+
+	for (i = 0; i < 5; i++) {
+		if (stats[i].failed) {
+			return 1;
+		}
+	}
+	return 0;
+}
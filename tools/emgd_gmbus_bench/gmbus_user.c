@@ -0,0 +1,314 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: gmbus_user.c
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Userspace replacements for what i2c_gmbus_tnc.c reaches outside itself:
+ *  the 0:3:0 register file, holding a model of the GMBUS controller, the
+ *  sDVO port descriptor, the GPIO bit-bash entry points and the kernel
+ *  delay/sleep primitives.
+ *
+ *  The controller runs one cycle at a time. A cycle moves the address and
+ *  index bytes, then the data in chunks of up to 4 bytes; each chunk sets
+ *  HW_RDY once its bus time has passed, and GMBUS3 hands it over. The last
+ *  chunk ends in a STOP (GA drops) or leaves the bus waiting (HW_WAIT).
+ *-----------------------------------------------------------------------------
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include <igd_mode.h>
+#include <context.h>
+#include <mode.h>
+#include <utils.h>
+#include <tnc/regs.h>
+#include "i2c_dispatch.h"
+#include "gmbus_user.h"
+
+#define SDVO_ADDR         0x70
+#define DDC_ADDR          0xA0
+#define SDVO_INDEX_OPCODE 0x08
+#define SDVO_INDEX_STATUS 0x09
+#define SDVO_STATUS_OK    0x01
+
+unsigned long jiffies;
+
+unsigned char gmbus_user_edid[GMBUS_USER_EDID_SIZE];
+unsigned long gmbus_user_read_ns = 500;
+unsigned long gmbus_user_reads;
+unsigned long gmbus_user_sleeps;
+
+igd_display_port_t dvob_port_tnc;
+
+typedef struct _gmbus_model {
+	unsigned long gmbus0;
+	unsigned long status;       /* GMBUS2 */
+	unsigned long data_out;     /* Last GMBUS3 write */
+	unsigned long data_in;      /* Chunk read from the slave */
+	int active;
+	int read;
+	int stop;
+	unsigned long slave;
+	unsigned long index;
+	unsigned long total;
+	unsigned long done;
+	unsigned long chunk;
+	unsigned long long chunk_at;  /* Current chunk completes, 0 if none */
+	unsigned long long stop_at;   /* STOP completes, 0 if none */
+} gmbus_model_t;
+
+static gmbus_model_t gmbus;
+static unsigned char sdvo_regs[256];
+
+static unsigned long long now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void spin_ns(unsigned long long ns)
+{
+	unsigned long long end = now_ns() + ns;
+
+	while (now_ns() < end) {
+		;
+	}
+}
+
+/* 9 clocks per byte at the GMBUS0 speed */
+static unsigned long long byte_ns(void)
+{
+	switch (gmbus.gmbus0 & 0x0300) {
+	case 0x0100:
+		return 180000;
+	case 0x0200:
+		return 22500;
+	case 0x0300:
+		return 9000;
+	default:
+		return 90000;
+	}
+}
+
+void gmbus_user_reset(void)
+{
+	memset(&gmbus, 0, sizeof(gmbus));
+	memset(sdvo_regs, 0, sizeof(sdvo_regs));
+	gmbus_user_reads = 0;
+	gmbus_user_sleeps = 0;
+}
+
+static unsigned char slave_read(unsigned long offset)
+{
+	if (gmbus.slave == DDC_ADDR) {
+		return gmbus_user_edid[offset % GMBUS_USER_EDID_SIZE];
+	}
+	return sdvo_regs[offset & 0xff];
+}
+
+static void slave_write(unsigned long offset, unsigned char value)
+{
+	if (gmbus.slave != SDVO_ADDR) {
+		return;
+	}
+	sdvo_regs[offset & 0xff] = value;
+	if ((offset & 0xff) == SDVO_INDEX_OPCODE) {
+		sdvo_regs[SDVO_INDEX_STATUS] = SDVO_STATUS_OK;
+	}
+}
+
+static void next_chunk(unsigned long long start, unsigned long overhead)
+{
+	gmbus.chunk = gmbus.total - gmbus.done;
+	if (gmbus.chunk > 4) {
+		gmbus.chunk = 4;
+	}
+	gmbus.chunk_at = start + (overhead + gmbus.chunk) * byte_ns();
+}
+
+/* Moves the model up to the current time */
+static void update(void)
+{
+	unsigned long long now = now_ns();
+	unsigned long i;
+
+	if (gmbus.chunk_at && now >= gmbus.chunk_at) {
+		gmbus.data_in = 0;
+		for (i = 0; i < gmbus.chunk; i++) {
+			if (gmbus.read) {
+				gmbus.data_in |= (unsigned long)
+					slave_read(gmbus.index + gmbus.done + i) << (i * 8);
+			} else {
+				slave_write(gmbus.index + gmbus.done + i,
+					(unsigned char)(gmbus.data_out >> (i * 8)));
+			}
+		}
+		gmbus.done += gmbus.chunk;
+		gmbus.chunk_at = 0;
+		gmbus.status |= HW_RDY;
+
+		if (gmbus.done == gmbus.total) {
+			if (gmbus.stop) {
+				gmbus.stop_at = now + byte_ns();
+			} else {
+				gmbus.status |= HW_WAIT;
+			}
+		}
+	}
+
+	if (gmbus.stop_at && now >= gmbus.stop_at) {
+		gmbus.stop_at = 0;
+		gmbus.active = 0;
+		gmbus.status &= ~(GA | HW_WAIT);
+		gmbus.status |= HW_RDY;
+	}
+}
+
+static void gmbus1_write(unsigned long value)
+{
+	unsigned long long now = now_ns();
+
+	if (value & SW_CLR_INT) {
+		gmbus.status = 0;
+		gmbus.active = 0;
+		gmbus.chunk_at = 0;
+		gmbus.stop_at = 0;
+		return;
+	}
+
+	if (value & STA) {
+		/* Start, address, index (and a repeated start to read) */
+		gmbus.active = 1;
+		gmbus.read = value & 1;
+		gmbus.stop = (value & STO) != 0;
+		gmbus.slave = value & 0xfe;
+		gmbus.index = (value >> 8) & 0xff;
+		gmbus.total = (value >> 16) & 0x1ff;
+		gmbus.done = 0;
+		gmbus.stop_at = 0;
+		gmbus.status = GA;
+		next_chunk(now, gmbus.read ? 3 : 2);
+		return;
+	}
+
+	if ((value & STO) && gmbus.active) {
+		gmbus.status &= ~(HW_WAIT | HW_RDY);
+		gmbus.chunk_at = 0;
+		gmbus.stop_at = now + byte_ns();
+	}
+}
+
+unsigned long read_mmio_reg_tnc(unsigned long port_type, unsigned long reg)
+{
+	unsigned long value = 0;
+
+	spin_ns(gmbus_user_read_ns);
+	gmbus_user_reads++;
+	update();
+
+	switch (reg) {
+	case GMBUS0:
+		value = gmbus.gmbus0;
+		break;
+	case GMBUS2:
+		value = gmbus.status;
+		break;
+	case GMBUS3:
+		value = gmbus.data_in;
+		if (gmbus.active && gmbus.read && (gmbus.status & HW_RDY)) {
+			gmbus.status &= ~HW_RDY;
+			if (gmbus.done < gmbus.total) {
+				next_chunk(now_ns(), 0);
+			}
+		}
+		break;
+	}
+	return value;
+}
+
+void write_mmio_reg_tnc(unsigned long port_type, unsigned long reg,
+	unsigned long value)
+{
+	update();
+
+	switch (reg) {
+	case GMBUS0:
+		gmbus.gmbus0 = value;
+		break;
+	case GMBUS1:
+		gmbus1_write(value);
+		break;
+	case GMBUS3:
+		gmbus.data_out = value;
+		if (gmbus.active && !gmbus.read && (gmbus.status & HW_RDY) &&
+			gmbus.done < gmbus.total) {
+			gmbus.status &= ~HW_RDY;
+			next_chunk(now_ns(), 0);
+		}
+		break;
+	}
+}
+
+void gmbus_user_udelay(unsigned long us)
+{
+	spin_ns(us * 1000ULL);
+}
+
+void gmbus_user_usleep(unsigned long min_us, unsigned long max_us)
+{
+	struct timespec ts;
+
+	ts.tv_sec = min_us / 1000000;
+	ts.tv_nsec = (min_us % 1000000) * 1000;
+	nanosleep(&ts, NULL);
+	gmbus_user_sleeps++;
+}
+
+/* The internal LVDS DDC is bit-bashed; not part of this benchmark */
+int i2c_read_regs_gpio(igd_context_t *context,
+	unsigned long i2c_bus,
+	unsigned long i2c_speed,
+	unsigned long dab,
+	unsigned char reg,
+	unsigned char FAR *buffer,
+	unsigned long num_bytes,
+	unsigned long flags)
+{
+	return 1;
+}
+
+int i2c_write_reg_list_gpio(igd_context_t *context,
+	unsigned long i2c_bus,
+	unsigned long i2c_speed,
+	unsigned long dab,
+	pd_reg_t *reg_list,
+	unsigned long flags)
+{
+	return 1;
+}
@@ -0,0 +1,53 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: gmbus_user.h
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Userspace model of the Atom E6xx GMBUS controller (0:3:0 GMBUS0-5) and
+ *  the devices behind it: an sDVO encoder at 0x70 and a monitor whose EDID
+ *  is at 0xA0. Transfers take the bus time of the programmed speed on the
+ *  wall clock, and every GMBUS register read costs the configured MMIO
+ *  read latency, so polling shows up as CPU time.
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef _GMBUS_USER_H
+#define _GMBUS_USER_H
+
+#define GMBUS_USER_EDID_SIZE  256
+
+extern unsigned char gmbus_user_edid[GMBUS_USER_EDID_SIZE];
+
+/* Cost of one GMBUS register read, in nanoseconds */
+extern unsigned long gmbus_user_read_ns;
+
+/* Counters since the last gmbus_user_reset() */
+extern unsigned long gmbus_user_reads;
+extern unsigned long gmbus_user_sleeps;
+
+/* Returns the model to an idle bus and clears the counters */
+extern void gmbus_user_reset(void);
+
+#endif
@@ -0,0 +1,21 @@
+/*
+ * Userspace stand-in for <linux/bitops.h>; pd.h supplies BIT() itself.
+ * The benchmark is single threaded, so the bit locks need no atomics.
+ */
+#ifndef _STUB_LINUX_BITOPS_H
+#define _STUB_LINUX_BITOPS_H
+
+static inline int test_and_set_bit_lock(int nr, unsigned long *addr)
+{
+	int old = (*addr >> nr) & 1;
+
+	*addr |= 1UL << nr;
+	return old;
+}
+
+static inline void clear_bit_unlock(int nr, unsigned long *addr)
+{
+	*addr &= ~(1UL << nr);
+}
+
+#endif
@@ -0,0 +1,14 @@
+/*
+ * Userspace stand-in for <linux/delay.h>. Unlike the emgd_mode_bench stub,
+ * delays take real time: the GMBUS model runs on the wall clock.
+ */
+#define msecs_to_jiffies(ms)	((unsigned long)(ms))
+#define usecs_to_jiffies(us)	((unsigned long)(us) / 1000)
+
+extern void gmbus_user_udelay(unsigned long us);
+extern void gmbus_user_usleep(unsigned long min_us, unsigned long max_us);
+
+#define udelay(us)			gmbus_user_udelay(us)
+#define mdelay(ms)			gmbus_user_udelay((ms) * 1000)
+#define msleep(ms)			gmbus_user_usleep((ms) * 1000, (ms) * 1000)
+#define usleep_range(min, max)	gmbus_user_usleep(min, max)
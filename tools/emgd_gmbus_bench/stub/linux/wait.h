@@ -0,0 +1,13 @@
+/*
+ * Userspace stand-in for <linux/wait.h>. The benchmark is single threaded,
+ * so nothing can be waited for: a wait whose condition is false is a bug.
+ */
+#include <stdlib.h>
+
+typedef struct {
+	int unused;
+} wait_queue_head_t;
+
+#define DECLARE_WAIT_QUEUE_HEAD(name)	wait_queue_head_t name = { 0 }
+#define wait_event(wq, cond)	do { (void)(wq); if (!(cond)) abort(); } while (0)
+#define wake_up(wq)				((void)(wq))
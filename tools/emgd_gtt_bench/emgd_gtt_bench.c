@@ -0,0 +1,330 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: emgd_gtt_bench.c
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Measures GTT save and restore across a simulated suspend, the way
+ *  reg_tnc.c did it before the GTT shadow (read every entry on suspend,
+ *  write every entry back on resume) and with the shadow in gtt_shadow.c
+ *  (linked unchanged).  The GTT is an array in memory; each access is
+ *  charged an uncached MMIO latency.
+ *
+ *  The table starts out as the firmware leaves it: stolen memory at the
+ *  bottom, zero above.  The driver then maps buffers until the requested
+ *  amount is in use and unmaps every third one, as gtt.c does.  Suspend
+ *  loses the table back to the firmware state; after resume it must match
+ *  what the driver had, otherwise the exit status is non-zero.
+ *
+ *  Usage:
+ *   emgd_gtt_bench [-n rounds] [-a aperture-MB] [-s stolen-MB]
+ *                  [-u used-MB] [-r read-ns] [-w write-ns]
+ *-----------------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <asm/io.h>
+#include <gtt_shadow.h>
+
+#define PTE_VALID      0x0001
+#define PAGES_PER_MB   256
+#define STOLEN_BASE    0x3f800   /* page frame of stolen memory */
+#define SCRATCH_PFN    0x1000
+
+static unsigned long *gtt;
+static unsigned long gtt_entries;
+static unsigned long read_ns = 500;
+static unsigned long write_ns = 100;
+static unsigned long reads;
+static unsigned long writes;
+
+static double now_us(clockid_t clock)
+{
+	struct timespec ts;
+
+	clock_gettime(clock, &ts);
+	return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+static void mmio_delay(unsigned long ns)
+{
+	struct timespec ts;
+	unsigned long long end;
+
+	if (!ns) {
+		return;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	end = ts.tv_sec * 1000000000ULL + ts.tv_nsec + ns;
+	do {
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+	} while (ts.tv_sec * 1000000000ULL + ts.tv_nsec < end);
+}
+
+static unsigned long gtt_index(const volatile void *addr)
+{
+	unsigned long i = (const volatile unsigned long *)addr - gtt;
+
+	if (i >= gtt_entries) {
+		fprintf(stderr, "GTT access out of range: %p\n", (void *)addr);
+		exit(2);
+	}
+	return i;
+}
+
+unsigned int gtt_user_readl(const volatile void *addr)
+{
+	unsigned long i = gtt_index(addr);
+
+	reads++;
+	mmio_delay(read_ns);
+	return (unsigned int)gtt[i];
+}
+
+void gtt_user_writel(unsigned int value, volatile void *addr)
+{
+	unsigned long i = gtt_index(addr);
+
+	writes++;
+	mmio_delay(write_ns);
+	gtt[i] = value;
+}
+
+/* emgd_gtt_insert()/emgd_gtt_remove() minus the cache maintenance */
+static void gtt_map(gtt_shadow_t *shadow, unsigned long start,
+	unsigned long pages, unsigned long pfn)
+{
+	unsigned long i;
+	unsigned int pte;
+
+	for (i = start; i < start + pages; i++) {
+		pte = ((pfn + i - start) << 12) | PTE_VALID;
+		writel(pte, gtt + i);
+		(void)readl(gtt + i);
+		emgd_gtt_shadow_set(shadow, i, pte);
+	}
+}
+
+static void gtt_unmap(gtt_shadow_t *shadow, unsigned long start,
+	unsigned long pages)
+{
+	unsigned long i;
+
+	for (i = start; i < start + pages; i++) {
+		writel(shadow->scratch_pte, gtt + i);
+		(void)readl(gtt + i);
+		emgd_gtt_shadow_set(shadow, i, shadow->scratch_pte);
+	}
+}
+
+/* The loops reg_save_gtt_tnc()/reg_restore_gtt_tnc() ran without a shadow */
+static void save_all(unsigned long *saved)
+{
+	unsigned long i;
+
+	for (i = 0; i < gtt_entries; i++) {
+		saved[i] = readl(gtt + i);
+	}
+}
+
+static void restore_all(const unsigned long *saved)
+{
+	unsigned long i;
+
+	if (0 == saved[0]) {
+		return;
+	}
+	for (i = 0; i < gtt_entries; i++) {
+		writel(saved[i], gtt + i);
+	}
+}
+
+typedef struct _result {
+	const char *name;
+	double suspend_us;
+	double resume_us;
+	unsigned long reads;
+	unsigned long writes;
+	unsigned long failed;
+} result_t;
+
+static void report(const result_t *r, unsigned long rounds)
+{
+	printf("%-10s %12.1f %12.1f %10lu %10lu %6lu\n", r->name,
+		r->suspend_us / rounds, r->resume_us / rounds,
+		r->reads / rounds, r->writes / rounds, r->failed);
+}
+
+int main(int argc, char *argv[])
+{
+	result_t full = { "full" };
+	result_t shadowed = { "shadow" };
+	unsigned long rounds = 10, aperture_mb = 256, stolen_mb = 8;
+	unsigned long used_mb = 64;
+	unsigned long stolen, used, start, pages, n, i;
+	unsigned long *boot, *before, *saved;
+	gtt_shadow_t *shadow;
+	gtt_shadow_t *snapshot;
+	double t;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:a:s:u:r:w:")) != -1) {
+		switch (opt) {
+		case 'n':
+			rounds = strtoul(optarg, NULL, 0);
+			break;
+		case 'a':
+			aperture_mb = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			stolen_mb = strtoul(optarg, NULL, 0);
+			break;
+		case 'u':
+			used_mb = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			read_ns = strtoul(optarg, NULL, 0);
+			break;
+		case 'w':
+			write_ns = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			fprintf(stderr, "Usage: %s [-n rounds] [-a aperture-MB] "
+				"[-s stolen-MB] [-u used-MB] [-r read-ns] [-w write-ns]\n",
+				argv[0]);
+			return 1;
+		}
+	}
+	if (!rounds || stolen_mb + used_mb > aperture_mb) {
+		fprintf(stderr, "Stolen and used memory must fit the aperture\n");
+		return 1;
+	}
+
+	gtt_entries = aperture_mb * PAGES_PER_MB;
+	stolen = stolen_mb * PAGES_PER_MB;
+	gtt = calloc(gtt_entries, sizeof(unsigned long));
+	boot = calloc(gtt_entries, sizeof(unsigned long));
+	before = calloc(gtt_entries, sizeof(unsigned long));
+	saved = calloc(gtt_entries, sizeof(unsigned long));
+	shadow = emgd_gtt_shadow_alloc(gtt_entries,
+		(SCRATCH_PFN << 12) | PTE_VALID);
+	snapshot = emgd_gtt_shadow_alloc(gtt_entries,
+		(SCRATCH_PFN << 12) | PTE_VALID);
+	if (!gtt || !boot || !before || !saved || !shadow || !snapshot) {
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	/* Firmware: stolen memory at the bottom of the aperture */
+	for (i = 0; i < stolen; i++) {
+		gtt[i] = ((STOLEN_BASE + i) << 12) | PTE_VALID;
+	}
+	memcpy(boot, gtt, gtt_entries * sizeof(unsigned long));
+
+	/* gtt_init_tnc() rewrites the stolen entries */
+	for (i = 0; i < stolen; i++) {
+		writel(boot[i], gtt + i);
+		emgd_gtt_shadow_set(shadow, i, boot[i]);
+	}
+
+	/*
+	 * Map buffers from 16K up to 8MB above stolen memory, then unmap
+	 * every third one.
+	 */
+	start = stolen;
+	used = used_mb * PAGES_PER_MB;
+	for (n = 0; used; n++) {
+		pages = 4 << (n % 10);
+		if (pages > used) {
+			pages = used;
+		}
+		gtt_map(shadow, start, pages, 0x20000 + start * 3);
+		if (n % 3 == 2) {
+			gtt_unmap(shadow, start, pages);
+		}
+		start += pages;
+		used -= pages;
+	}
+	memcpy(before, gtt, gtt_entries * sizeof(unsigned long));
+
+	for (n = 0; n < rounds; n++) {
+		reads = writes = 0;
+		t = now_us(CLOCK_MONOTONIC);
+		save_all(saved);
+		full.suspend_us += now_us(CLOCK_MONOTONIC) - t;
+		memcpy(gtt, boot, gtt_entries * sizeof(unsigned long));
+		t = now_us(CLOCK_MONOTONIC);
+		restore_all(saved);
+		full.resume_us += now_us(CLOCK_MONOTONIC) - t;
+		full.reads += reads;
+		full.writes += writes;
+		if (memcmp(gtt, before, gtt_entries * sizeof(unsigned long))) {
+			full.failed++;
+		}
+
+		/*
+		 * With the shadow, suspend only snapshots it.  Mapping more
+		 * after the save must not leak into the restored table.
+		 */
+		t = now_us(CLOCK_MONOTONIC);
+		emgd_gtt_shadow_copy(snapshot, shadow);
+		shadowed.suspend_us += now_us(CLOCK_MONOTONIC) - t;
+		if (start + 16 <= gtt_entries) {
+			gtt_map(shadow, start, 16, 0x80000 + n * 16);
+		}
+		reads = writes = 0;
+		memcpy(gtt, boot, gtt_entries * sizeof(unsigned long));
+		t = now_us(CLOCK_MONOTONIC);
+		emgd_gtt_shadow_restore(snapshot, gtt);
+		shadowed.resume_us += now_us(CLOCK_MONOTONIC) - t;
+		shadowed.reads += reads;
+		shadowed.writes += writes;
+		if (memcmp(gtt, before, gtt_entries * sizeof(unsigned long))) {
+			shadowed.failed++;
+		}
+		emgd_gtt_shadow_copy(shadow, snapshot);
+	}
+
+	printf("%lu rounds, %luMB aperture (%lu entries), %luMB stolen, "
+		"%luMB mapped, %lu/%lu ns per read/write\n\n", rounds, aperture_mb,
+		gtt_entries, stolen_mb, used_mb, read_ns, write_ns);
+	printf("%-10s %12s %12s %10s %10s %6s\n", "GTT save", "suspend us",
+		"resume us", "reads", "writes", "failed");
+	report(&full, rounds);
+	report(&shadowed, rounds);
+
+	emgd_gtt_shadow_free(snapshot);
+	emgd_gtt_shadow_free(shadow);
+	free(saved);
+	free(before);
+	free(boot);
+	free(gtt);
+
+	return (full.failed || shadowed.failed) ? 1 : 0;
+}
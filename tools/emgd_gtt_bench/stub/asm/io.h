@@ -0,0 +1,9 @@
+/*
+ * Userspace stand-in for <asm/io.h>. GTT accesses go to the simulated
+ * table in emgd_gtt_bench.c, which charges each one an MMIO latency.
+ */
+extern unsigned int gtt_user_readl(const volatile void *addr);
+extern void gtt_user_writel(unsigned int value, volatile void *addr);
+
+#define readl(addr)			gtt_user_readl(addr)
+#define writel(value, addr)	gtt_user_writel(value, addr)
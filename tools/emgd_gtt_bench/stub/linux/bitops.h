@@ -0,0 +1,41 @@
+/*
+ * Userspace stand-in for the <linux/bitops.h> and <linux/bitmap.h>
+ * helpers the GTT shadow uses.
+ */
+#define BITS_PER_LONG		(8 * sizeof(unsigned long))
+#define BITS_TO_LONGS(n)	(((n) + BITS_PER_LONG - 1) / BITS_PER_LONG)
+
+static inline void __set_bit(unsigned long nr, unsigned long *map)
+{
+	map[nr / BITS_PER_LONG] |= 1UL << (nr % BITS_PER_LONG);
+}
+
+static inline void __clear_bit(unsigned long nr, unsigned long *map)
+{
+	map[nr / BITS_PER_LONG] &= ~(1UL << (nr % BITS_PER_LONG));
+}
+
+static inline int test_bit(unsigned long nr, const unsigned long *map)
+{
+	return (map[nr / BITS_PER_LONG] >> (nr % BITS_PER_LONG)) & 1;
+}
+
+static inline unsigned long _find_next(const unsigned long *map,
+	unsigned long size, unsigned long start, unsigned long invert)
+{
+	unsigned long word;
+
+	while (start < size) {
+		word = (map[start / BITS_PER_LONG] ^ invert) >>
+			(start % BITS_PER_LONG);
+		if (word) {
+			start += __builtin_ctzl(word);
+			return start < size ? start : size;
+		}
+		start = (start / BITS_PER_LONG + 1) * BITS_PER_LONG;
+	}
+	return size;
+}
+
+#define find_next_bit(map, size, start)		_find_next(map, size, start, 0)
+#define find_next_zero_bit(map, size, start) _find_next(map, size, start, ~0UL)
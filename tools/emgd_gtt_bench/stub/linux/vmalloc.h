@@ -0,0 +1,5 @@
+/* Userspace stand-in for <linux/vmalloc.h> */
+#include <stdlib.h>
+
+#define vmalloc(size)	malloc(size)
+#define vfree(p)		free(p)
@@ -0,0 +1,211 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: emgd_mmio_replay.c
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Replays an MMIO log captured from debugfs (emgd_mmio/log, driver built
+ *  with MMIO_RECORD=1) against a simulated register file.
+ *
+ *  The log is split at the mode set, flip and pan marks. For each kind of
+ *  operation the tool reports how many register reads and writes it takes
+ *  and how long they take, from the mark to the operation's last access. It also reports the most accessed registers, and
+ *  reads whose value differs from the simulated register file. Those are
+ *  registers the hardware changes on its own (status, scanline, ...), which
+ *  a simulator has to model.
+ *
+ *  Usage:
+ *   echo 0 > /sys/kernel/debug/emgd_mmio/enable
+ *   cat /sys/kernel/debug/emgd_mmio/log > mmio.log
+ *   emgd_mmio_replay mmio.log [top-n]
+ *-----------------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <emgd_mmio_log.h>
+
+#define NUM_OPS        4	/* startup, mode set, flip, pan */
+#define REG_HASH_SIZE  65536
+
+static const char *op_names[NUM_OPS] = { "startup", "mode set", "flip",
+	"pan" };
+
+typedef struct _op_stats {
+	unsigned long count;
+	unsigned long reads;
+	unsigned long writes;
+	unsigned long long ns;
+} op_stats_t;
+
+typedef struct _sim_reg {
+	int used;
+	unsigned char region;
+	unsigned int offset;
+	unsigned int value;
+	int known;
+	unsigned long reads;
+	unsigned long writes;
+	unsigned long volatile_reads;
+} sim_reg_t;
+
+static sim_reg_t regs[REG_HASH_SIZE];
+static op_stats_t ops[NUM_OPS];
+
+static sim_reg_t *lookup_reg(unsigned char region, unsigned int offset)
+{
+	unsigned int hash = (offset >> 2) ^ ((unsigned int)region << 14);
+	unsigned int i;
+
+	for (i = 0; i < REG_HASH_SIZE; i++) {
+		sim_reg_t *r = &regs[(hash + i) % REG_HASH_SIZE];
+
+		if (!r->used) {
+			r->used = 1;
+			r->region = region;
+			r->offset = offset;
+			return r;
+		}
+		if (r->region == region && r->offset == offset) {
+			return r;
+		}
+	}
+	return NULL;
+}
+
+static int compare_accesses(const void *a, const void *b)
+{
+	const sim_reg_t *ra = *(const sim_reg_t * const *)a;
+	const sim_reg_t *rb = *(const sim_reg_t * const *)b;
+	unsigned long na = ra->reads + ra->writes;
+	unsigned long nb = rb->reads + rb->writes;
+
+	return (na == nb) ? 0 : ((na < nb) ? 1 : -1);
+}
+
+static void print_region(const sim_reg_t *r)
+{
+	if (r->region == EMGD_MMIO_LOG_NO_REGION) {
+		printf("   ?:0x%08x", r->offset);
+	} else {
+		printf("  %2u:0x%06x  ", r->region, r->offset);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	emgd_mmio_log_entry_t entry;
+	sim_reg_t **sorted;
+	unsigned long long op_start = 0, op_last = 0;
+	unsigned long total = 0;
+	int op = 0, top = 20, n = 0, i;
+	FILE *in;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s <mmio log> [top-n]\n", argv[0]);
+		return 1;
+	}
+	if (argc > 2) {
+		top = atoi(argv[2]);
+	}
+	if (!(in = fopen(argv[1], "rb"))) {
+		perror(argv[1]);
+		return 1;
+	}
+
+	while (fread(&entry, sizeof(entry), 1, in) == 1) {
+		sim_reg_t *r;
+
+		if (total++ == 0) {
+			op_start = entry.timestamp;
+			ops[0].count = 1;
+		}
+
+		if (entry.type == EMGD_MMIO_LOG_MARK) {
+			ops[op].ns += op_last - op_start;
+			op = (entry.offset < NUM_OPS) ? entry.offset : 0;
+			ops[op].count++;
+			op_start = op_last = entry.timestamp;
+			continue;
+		}
+		op_last = entry.timestamp;
+
+		if (!(r = lookup_reg(entry.region, entry.offset))) {
+			fprintf(stderr, "register table full\n");
+			break;
+		}
+
+		if (entry.type == EMGD_MMIO_LOG_WRITE) {
+			ops[op].writes++;
+			r->writes++;
+			r->value = entry.value;
+			r->known = 1;
+		} else {
+			ops[op].reads++;
+			r->reads++;
+			if (r->known && r->value != entry.value) {
+				r->volatile_reads++;
+			}
+			r->value = entry.value;
+			r->known = 1;
+		}
+	}
+	fclose(in);
+	ops[op].ns += op_last - op_start;
+
+	printf("%lu log entries\n\n", total);
+	printf("%-10s %8s %12s %12s %12s\n", "operation", "count",
+		"reads/op", "writes/op", "us/op");
+	for (i = 0; i < NUM_OPS; i++) {
+		if (!ops[i].count) {
+			continue;
+		}
+		printf("%-10s %8lu %12lu %12lu %12.1f\n", op_names[i], ops[i].count,
+			ops[i].reads / ops[i].count, ops[i].writes / ops[i].count,
+			(double)ops[i].ns / ops[i].count / 1000);
+	}
+
+	sorted = malloc(sizeof(*sorted) * REG_HASH_SIZE);
+	if (!sorted) {
+		return 1;
+	}
+	for (i = 0; i < REG_HASH_SIZE; i++) {
+		if (regs[i].used) {
+			sorted[n++] = &regs[i];
+		}
+	}
+	qsort(sorted, n, sizeof(*sorted), compare_accesses);
+
+	printf("\n%d registers touched; top %d:\n", n, top);
+	printf("  region:offset      reads     writes  hw-changed\n");
+	for (i = 0; i < n && i < top; i++) {
+		print_region(sorted[i]);
+		printf(" %10lu %10lu %11lu\n", sorted[i]->reads, sorted[i]->writes,
+			sorted[i]->volatile_reads);
+	}
+
+	free(sorted);
+	return 0;
+}
@@ -0,0 +1,740 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: emgd_mmio_sim.c
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Runs the Atom E6xx KMS mode code (kms_mode_tnc.c, micro_mode_tnc.c),
+ *  the clock code (clocks_tnc.c) and the overlay code (ovl_tnc.c) in
+ *  userspace against a simulated register file. The driver is built with
+ *  EMGD_MMIO_RECORD, so every EMGD_READ32/EMGD_WRITE32 lands in
+ *  emgd_mmio_read32()/emgd_mmio_write32() below instead of emgd_mmio.c.
+ *
+ *  The 0:2:0 (D2) and 0:3:0 (D3) register files are plain memory. A few
+ *  registers the hardware changes on its own are modelled so the driver's
+ *  polling loops finish at once: the pipe state bit follows the pipe
+ *  enable bit, the DPLL reads back locked, the CDVO reset reads back done
+ *  and the overlay register update reads back complete. Every vblank wait
+ *  sees a vblank immediately and is counted instead.
+ *
+ *  For pipe A (LVDS) and pipe B (SDVO) the tool runs
+ *   - mode set: plane and pipe off, pipe and plane programming, plane on,
+ *     alternating between two modes, as emgd_crtc.c does,
+ *   - flip: kms_flip_plane() between two buffers,
+ *   - pan: kms_flip_plane() moving the visible offset of one buffer,
+ *   - overlay: alter_ovl() of a YUY2 surface with a moving destination,
+ *  and reports the register reads, writes (and writes that did not change
+ *  the register), vblank waits and time of each. The port drivers are not
+ *  part of the simulation; their traffic goes over I2C, not MMIO.
+ *
+ *  The register state is checked after each operation: the pipe and plane
+ *  must be enabled, and the surface and overlay address registers must
+ *  hold what was asked for. Failures make the exit status non-zero.
+ *
+ *  Usage:
+ *   emgd_mmio_sim [-n iterations] [-t top-n] [-v]
+ *-----------------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <drm/drmP.h>
+#include <igd_mode.h>
+#include <igd_render.h>
+#include <igd_ovl.h>
+#include <igd_pwr.h>
+#include <context.h>
+#include <mode.h>
+#include <utils.h>
+#include <pd.h>
+#include <pi.h>
+#include <pci.h>
+#include <tnc/regs.h>
+#include <tnc/context.h>
+#include <drm_emgd_private.h>
+#include <mode_dispatch.h>
+#include <dsp_dispatch.h>
+#include <ovl_dispatch.h>
+#include <ovl_virt.h>
+
+#define SIM_MMIO_SIZE   0x80000
+#define REG_HASH_SIZE   4096
+
+#define SIM_PIPEA_CONF  0x70008
+#define SIM_PIPEB_CONF  0x71008
+#define SIM_DSPASURF    0x7019C
+#define SIM_DSPBSURF    0x7119C
+#define SIM_DSPALINOFF  0x70184
+#define SIM_DSPBLINOFF  0x71184
+#define SIM_VGACNTRL    0x71400
+#define SIM_OVADD       0x30000
+#define SIM_OVSTATUS    0x30008
+#define SIM_DPLL_STATUS 0x606C
+#define SIM_CDVO_RESET  0x7000
+
+#define FB_BASE0        0x00100000
+#define FB_BASE1        0x00900000
+#define OVL_SURF_BASE   0x01200000
+#define OVL_REG_OFFSET  0x01f00000
+
+enum {
+	OP_MODE_SET,
+	OP_FLIP,
+	OP_PAN,
+	OP_OVERLAY,
+	NUM_OPS
+};
+
+static const char *op_names[NUM_OPS] = { "mode set", "flip", "pan",
+	"overlay update" };
+
+typedef struct _stat {
+	double min;
+	double max;
+	double sum;
+	unsigned long count;
+} stat_t;
+
+typedef struct _op_stats {
+	stat_t time;
+	unsigned long reads;
+	unsigned long writes;
+	unsigned long same_writes;
+	unsigned long vblanks;
+} op_stats_t;
+
+typedef struct _sim_reg {
+	int used;
+	unsigned char region;
+	unsigned int offset;
+	unsigned long reads;
+	unsigned long writes;
+} sim_reg_t;
+
+typedef struct _sim_pipe {
+	const char *name;
+	igd_display_context_t display;
+	emgd_crtc_t crtc;
+	emgd_encoder_t encoder;
+	pd_driver_t driver;
+	unsigned long surf_reg;
+	unsigned long linoff_reg;
+	op_stats_t ops[NUM_OPS];
+} sim_pipe_t;
+
+extern mode_dispatch_t mode_dispatch_tnc;
+extern mode_kms_dispatch_t mode_kms_dispatch_tnc;
+extern dsp_dispatch_t dsp_dispatch_tnc;
+extern ovl_dispatch_t ovl_dispatch_tnc[];
+extern igd_timing_info_t crt_timing_table[];
+
+/* What the linked driver code expects from the rest of the driver */
+unsigned long jiffies;
+os_pci_dev_t bridge_dev;
+unsigned short io_base;
+unsigned short io_base_lvds;
+unsigned short io_base_sdvo;
+unsigned short io_base_sdvo_st;
+unsigned short io_base_lpc;
+mode_context_t mode_context[1];
+ovl_context_t ovl_context[1];
+igd_framebuffer_info_t fb_info_cmn[2];
+
+static unsigned char mmio_d2[SIM_MMIO_SIZE];
+static unsigned char mmio_d3[SIM_MMIO_SIZE];
+static unsigned char ovl_regs[0x1000] __attribute__((aligned(4096)));
+
+static igd_context_t context;
+static platform_context_tnc_t platform_context;
+static drm_emgd_priv_t priv;
+static struct drm_device drm_dev;
+static unsigned long current_dc = IGD_DISPLAY_CONFIG_SINGLE;
+
+static sim_pipe_t sim_pipes[2];
+static op_stats_t *cur_op;
+static sim_reg_t regs[REG_HASH_SIZE];
+static unsigned long untracked;
+static unsigned long errors;
+static int verbose;
+
+static double now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void stat_add(stat_t *s, double v)
+{
+	if (!s->count || v < s->min) {
+		s->min = v;
+	}
+	if (!s->count || v > s->max) {
+		s->max = v;
+	}
+	s->sum += v;
+	s->count++;
+}
+
+#define CHECK(cond, ...)							\
+	do {											\
+		if (!(cond)) {								\
+			fprintf(stderr, "FAIL: " __VA_ARGS__);	\
+			fputc('\n', stderr);					\
+			errors++;								\
+		}											\
+	} while (0)
+
+
+/*
+ * Simulated register file.
+ */
+
+static unsigned int *sim_reg(volatile void *addr, unsigned char *region,
+	unsigned int *offset)
+{
+	unsigned char *a = (unsigned char *)addr;
+
+	if (a >= mmio_d2 && a < mmio_d2 + SIM_MMIO_SIZE) {
+		*region = EMGD_MMIO_REGION_D2;
+		*offset = (unsigned int)(a - mmio_d2);
+	} else if (a >= mmio_d3 && a < mmio_d3 + SIM_MMIO_SIZE) {
+		*region = EMGD_MMIO_REGION_D3;
+		*offset = (unsigned int)(a - mmio_d3);
+	} else {
+		return NULL;
+	}
+	return (unsigned int *)a;
+}
+
+static void count_reg(unsigned char region, unsigned int offset, int write)
+{
+	unsigned int hash = ((offset >> 2) ^ ((unsigned int)region << 11)) &
+		(REG_HASH_SIZE - 1);
+	unsigned int i;
+
+	for (i = 0; i < REG_HASH_SIZE; i++) {
+		sim_reg_t *r = &regs[(hash + i) & (REG_HASH_SIZE - 1)];
+
+		if (!r->used) {
+			r->used = 1;
+			r->region = region;
+			r->offset = offset;
+		} else if (r->region != region || r->offset != offset) {
+			continue;
+		}
+		if (write) {
+			r->writes++;
+		} else {
+			r->reads++;
+		}
+		return;
+	}
+}
+
+unsigned int emgd_mmio_read32(volatile void *addr)
+{
+	unsigned char region;
+	unsigned int offset, value;
+	unsigned int *reg = sim_reg(addr, &region, &offset);
+
+	if (!reg) {
+		untracked++;
+		return *(volatile unsigned int *)addr;
+	}
+	value = *reg;
+
+	/* Registers the hardware updates on its own */
+	if (offset == SIM_PIPEA_CONF || offset == SIM_PIPEB_CONF) {
+		value = (value & ~0x40000000) | ((value >> 1) & 0x40000000);
+	} else if (region == EMGD_MMIO_REGION_D2 && offset == SIM_OVSTATUS) {
+		value |= 0x80000000;
+	} else if (region == EMGD_MMIO_REGION_D3 && offset == SIM_DPLL_STATUS) {
+		value |= 0x10000;
+	} else if (region == EMGD_MMIO_REGION_D3 && offset == SIM_CDVO_RESET) {
+		value = 0x50;
+	}
+
+	if (cur_op) {
+		cur_op->reads++;
+	}
+	count_reg(region, offset, 0);
+	return value;
+}
+
+void emgd_mmio_write32(unsigned long value, volatile void *addr)
+{
+	unsigned char region;
+	unsigned int offset;
+	unsigned int *reg = sim_reg(addr, &region, &offset);
+
+	if (!reg) {
+		untracked++;
+		*(volatile unsigned int *)addr = (unsigned int)value;
+		return;
+	}
+
+	if (cur_op) {
+		cur_op->writes++;
+		if (*reg == (unsigned int)value) {
+			cur_op->same_writes++;
+		}
+	}
+	*reg = (unsigned int)value;
+	count_reg(region, offset, 1);
+}
+
+
+/*
+ * Stand-ins for the rest of the driver.
+ */
+
+/* Every vblank wait sees its vblank at once */
+static int sim_request_vblanks(unsigned long request_for, unsigned char *mmio)
+{
+	if (cur_op) {
+		cur_op->vblanks++;
+	}
+	return 0;
+}
+
+static int sim_end_request(unsigned long request_for, unsigned char *mmio)
+{
+	return 0;
+}
+
+static int sim_vblank_occured(unsigned long request_for)
+{
+	return 1;
+}
+
+mode_full_dispatch_t mode_full_dispatch_tnc = {
+	.request_vblanks = sim_request_vblanks,
+	.end_request = sim_end_request,
+	.vblank_occured = sim_vblank_occured,
+};
+
+static int sim_get_pixelformats(igd_display_h display_handle,
+	unsigned long **fb_list_pfs, unsigned long **cu_list_pfs,
+	unsigned long **overlay_pfs, unsigned long **render_pfs,
+	unsigned long **texture_pfs)
+{
+	if (overlay_pfs) {
+		*overlay_pfs = dsp_dispatch_tnc.overlay_pfs;
+	}
+	return 0;
+}
+
+int os_pci_read_config_8(os_pci_dev_t pci_dev, unsigned long offset,
+	unsigned char *val)
+{
+	*val = 0;
+	return 0;
+}
+
+int os_pci_read_config_32(os_pci_dev_t pci_dev, unsigned long offset,
+	unsigned long *val)
+{
+	*val = 0;
+	return 0;
+}
+
+int os_pci_write_config_8(os_pci_dev_t pci_dev, unsigned long offset,
+	unsigned char val)
+{
+	return 0;
+}
+
+int os_pci_write_config_32(os_pci_dev_t pci_dev, unsigned long offset,
+	unsigned long val)
+{
+	return 0;
+}
+
+void pd_usleep(unsigned long usec)
+{
+}
+
+/* The simulated ports carry no port driver attributes or timing index */
+int pi_pd_find_attr_and_value(igd_display_port_t *port,
+	unsigned long attr_id,
+	unsigned long flag,
+	pd_attr_t **caller_pd_attr,
+	unsigned long *attr_value)
+{
+	return -IGD_ERROR_INVAL;
+}
+
+igd_timing_info_t *pi_find_timing(igd_display_port_t *port,
+	unsigned short width, unsigned short height, unsigned short refresh,
+	unsigned long flags)
+{
+	return NULL;
+}
+
+
+/*
+ * Setup.
+ */
+
+static igd_timing_info_t *find_mode(unsigned short width,
+	unsigned short height, unsigned short refresh)
+{
+	igd_timing_info_t *t;
+
+	for (t = crt_timing_table; t->width != IGD_TIMING_TABLE_END; t++) {
+		if (t->width == width && t->height == height &&
+				t->refresh == refresh) {
+			return t;
+		}
+	}
+	return NULL;
+}
+
+static void setup_pipe(sim_pipe_t *sp, int index)
+{
+	igd_display_pipe_t *pipe = dsp_dispatch_tnc.pipes[index];
+	igd_display_port_t *port = dsp_dispatch_tnc.ports[index];
+	igd_framebuffer_info_t *fb = &fb_info_cmn[index];
+
+	sp->name = index ? "pipe B (SDVO)" : "pipe A (LVDS)";
+	sp->surf_reg = index ? SIM_DSPBSURF : SIM_DSPASURF;
+	sp->linoff_reg = index ? SIM_DSPBLINOFF : SIM_DSPALINOFF;
+
+	sp->display.context = &context;
+	sp->display.pipe = pipe;
+	sp->display.plane = pipe->plane;
+	sp->display.port_number = port->port_number;
+	sp->display.port[port->port_number - 1] = port;
+	sp->driver.type = index ? PD_DISPLAY_FP : PD_DISPLAY_LVDS_INT;
+	port->pd_driver = &sp->driver;
+	pipe->owner = &sp->display;
+	pipe->inuse = 1;
+
+	fb->width = 1024;
+	fb->height = 768;
+	fb->screen_pitch = 4096;
+	fb->pixel_format = IGD_PF_ARGB32;
+	fb->fb_base_offset = FB_BASE0;
+
+	sp->crtc.crtc_id = index ? IGD_KMS_PIPEB : IGD_KMS_PIPEA;
+	sp->crtc.igd_pipe = pipe;
+	sp->crtc.base.dev = &drm_dev;
+	list_add_tail(&sp->crtc.base.head, &drm_dev.mode_config.crtc_list);
+
+	sp->encoder.igd_port = port;
+	sp->encoder.base.dev = &drm_dev;
+	sp->encoder.base.crtc = &sp->crtc.base;
+	list_add_tail(&sp->encoder.base.head, &drm_dev.mode_config.encoder_list);
+}
+
+static void setup(void)
+{
+	int i;
+
+	context.device_context.virt_mmadr = mmio_d2;
+	context.device_context.virt_mmadr_sdvo = mmio_d3;
+	context.device_context.power_state = IGD_POWERSTATE_D0;
+	context.device_context.core_freq = 200;
+	context.platform_context = &platform_context;
+	context.mod_dispatch.dsp_current_dc = &current_dc;
+	context.dispatch.get_pixelformats = sim_get_pixelformats;
+
+	mode_context->context = &context;
+	mode_context->dispatch = &mode_dispatch_tnc;
+	mode_context->kms_dispatch = &mode_kms_dispatch_tnc;
+
+	ovl_context->reg_update_phys = (unsigned long)ovl_regs;
+	ovl_context->reg_update_offset = OVL_REG_OFFSET;
+
+	priv.context = &context;
+	drm_dev.dev_private = &priv;
+	INIT_LIST_HEAD(&drm_dev.mode_config.crtc_list);
+	INIT_LIST_HEAD(&drm_dev.mode_config.encoder_list);
+
+	/* Post-boot state: VGA plane off */
+	*(unsigned int *)&mmio_d2[SIM_VGACNTRL] = 0x80000000;
+
+	for (i = 0; i < 2; i++) {
+		setup_pipe(&sim_pipes[i], i);
+	}
+}
+
+
+/*
+ * Operations, in the order emgd_crtc.c issues them.
+ */
+
+static unsigned int reg_d2(unsigned long offset)
+{
+	return *(unsigned int *)&mmio_d2[offset];
+}
+
+static void begin(sim_pipe_t *sp, int op, double *start)
+{
+	cur_op = &sp->ops[op];
+	*start = now_us();
+}
+
+static void end(sim_pipe_t *sp, int op, double start)
+{
+	stat_add(&sp->ops[op].time, now_us() - start);
+	cur_op = NULL;
+}
+
+static void mode_set(sim_pipe_t *sp, igd_timing_info_t *timing)
+{
+	mode_kms_dispatch_t *kms = mode_context->kms_dispatch;
+	igd_display_pipe_t *pipe = sp->crtc.igd_pipe;
+	igd_framebuffer_info_t *fb = PLANE(&sp->display)->fb_info;
+	double start;
+
+	fb->width = timing->width;
+	fb->height = timing->height;
+	fb->fb_base_offset = FB_BASE0;
+	fb->visible_offset = 0;
+
+	begin(sp, OP_MODE_SET, &start);
+	kms->kms_set_plane_pwr(&sp->crtc, FALSE);
+	kms->kms_set_pipe_pwr(&sp->crtc, FALSE);
+	pipe->timing = timing;
+	kms->kms_program_pipe(&sp->crtc);
+	kms->kms_program_plane(&sp->crtc, TRUE);
+	kms->kms_set_plane_pwr(&sp->crtc, TRUE);
+	end(sp, OP_MODE_SET, start);
+
+	CHECK(reg_d2(pipe->pipe_reg) & 0x80000000, "%s: pipe off after mode set",
+		sp->name);
+	CHECK(reg_d2(PLANE(&sp->display)->plane_reg) & 0x80000000,
+		"%s: plane off after mode set", sp->name);
+	CHECK(reg_d2(sp->surf_reg) == FB_BASE0,
+		"%s: surface 0x%x after mode set", sp->name, reg_d2(sp->surf_reg));
+}
+
+static void flip(sim_pipe_t *sp, int op, unsigned long base,
+	unsigned long visible)
+{
+	igd_framebuffer_info_t fb_info = *PLANE(&sp->display)->fb_info;
+	double start;
+	int ret;
+
+	fb_info.fb_base_offset = base;
+	fb_info.visible_offset = visible;
+
+	begin(sp, op, &start);
+	ret = mode_context->kms_dispatch->kms_flip_plane(&sp->crtc, &fb_info);
+	end(sp, op, start);
+
+	CHECK(!ret, "%s: %s took the full plane reprogram", sp->name,
+		op_names[op]);
+	CHECK(reg_d2(sp->surf_reg) == base && reg_d2(sp->linoff_reg) == visible,
+		"%s: surface 0x%x/0x%x after %s", sp->name, reg_d2(sp->surf_reg),
+		reg_d2(sp->linoff_reg), op_names[op]);
+}
+
+static void overlay(sim_pipe_t *sp, unsigned int frame)
+{
+	igd_surface_t surf;
+	igd_rect_t src, dest;
+	igd_ovl_info_t info;
+	double start;
+	int ret;
+
+	memset(&surf, 0, sizeof(surf));
+	surf.offset = OVL_SURF_BASE + (frame & 1) * 0x100000;
+	surf.width = 720;
+	surf.height = 480;
+	surf.pitch = 1440;
+	surf.pixel_format = IGD_PF_YUV422_PACKED_YUY2;
+
+	src.x1 = 0;
+	src.y1 = 0;
+	src.x2 = surf.width;
+	src.y2 = surf.height;
+	dest.x1 = (frame * 8) % 256;
+	dest.y1 = (frame * 4) % 128;
+	dest.x2 = dest.x1 + 640;
+	dest.y2 = dest.y1 + 400;
+
+	memset(&info, 0, sizeof(info));
+	info.video_quality.contrast = 0x8000;
+	info.video_quality.brightness = 0x8000;
+	info.video_quality.saturation = 0x8000;
+	info.video_quality.hue = 0x8000;
+
+	begin(sp, OP_OVERLAY, &start);
+	ret = ovl_dispatch_tnc[0].alter_ovl(&sp->display, &surf, &src, &dest,
+		&info, IGD_OVL_ALTER_ON | IGD_OVL_ALTER_PROGRESSIVE);
+	end(sp, OP_OVERLAY, start);
+
+	CHECK(!ret, "%s: overlay update failed (%d)", sp->name, ret);
+	CHECK(reg_d2(SIM_OVADD) == (OVL_REG_OFFSET | 1),
+		"%s: OVADD 0x%x after overlay update", sp->name, reg_d2(SIM_OVADD));
+}
+
+static void overlay_off(sim_pipe_t *sp)
+{
+	igd_surface_t surf;
+	igd_rect_t rect;
+	igd_ovl_info_t info;
+
+	memset(&surf, 0, sizeof(surf));
+	memset(&rect, 0, sizeof(rect));
+	memset(&info, 0, sizeof(info));
+	ovl_dispatch_tnc[0].alter_ovl(&sp->display, &surf, &rect, &rect, &info,
+		IGD_OVL_ALTER_OFF);
+}
+
+
+/*
+ * Report.
+ */
+
+static void report(sim_pipe_t *sp)
+{
+	int op;
+
+	printf("%s\n", sp->name);
+	printf("  %-16s %8s %8s %8s %8s %9s %9s %9s\n", "", "reads", "writes",
+		"same", "vblanks", "min us", "avg us", "max us");
+	for (op = 0; op < NUM_OPS; op++) {
+		op_stats_t *s = &sp->ops[op];
+		unsigned long n = s->time.count;
+
+		if (!n) {
+			continue;
+		}
+		printf("  %-16s %8.1f %8.1f %8.1f %8.1f %9.2f %9.2f %9.2f\n",
+			op_names[op], (double)s->reads / n, (double)s->writes / n,
+			(double)s->same_writes / n, (double)s->vblanks / n,
+			s->time.min, s->time.sum / n, s->time.max);
+	}
+}
+
+static int cmp_reg(const void *a, const void *b)
+{
+	const sim_reg_t *ra = a, *rb = b;
+	unsigned long ta = ra->reads + ra->writes;
+	unsigned long tb = rb->reads + rb->writes;
+
+	return (ta < tb) - (ta > tb);
+}
+
+static void report_regs(int top)
+{
+	int i;
+
+	qsort(regs, REG_HASH_SIZE, sizeof(sim_reg_t), cmp_reg);
+	printf("most accessed registers\n");
+	for (i = 0; i < top && i < REG_HASH_SIZE && regs[i].used; i++) {
+		printf("  %s 0x%05x %8lu reads %8lu writes\n",
+			regs[i].region == EMGD_MMIO_REGION_D2 ? "D2" : "D3",
+			regs[i].offset, regs[i].reads, regs[i].writes);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	igd_timing_info_t *modes[2];
+	int iterations = 100, top = 10;
+	int opt, i, p;
+
+	while ((opt = getopt(argc, argv, "n:t:v")) != -1) {
+		switch (opt) {
+		case 'n':
+			iterations = atoi(optarg);
+			break;
+		case 't':
+			top = atoi(optarg);
+			break;
+		case 'v':
+			verbose = 1;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-n iterations] [-t top-n] [-v]\n",
+				argv[0]);
+			return 2;
+		}
+	}
+	if (iterations < 1) {
+		iterations = 1;
+	}
+
+	modes[0] = find_mode(1024, 768, 60);
+	modes[1] = find_mode(800, 600, 60);
+	if (!modes[0] || !modes[1]) {
+		fprintf(stderr, "1024x768@60 or 800x600@60 missing from the CRT "
+			"mode table\n");
+		return 1;
+	}
+
+	setup();
+
+	for (p = 0; p < 2; p++) {
+		sim_pipe_t *sp = &sim_pipes[p];
+
+		for (i = 0; i < iterations; i++) {
+			igd_timing_info_t *timing = modes[i & 1];
+			igd_framebuffer_info_t *fb = PLANE(&sp->display)->fb_info;
+			unsigned long pan = (unsigned long)(i % 64) * fb->screen_pitch;
+
+			mode_set(sp, timing);
+			flip(sp, OP_FLIP, FB_BASE1, 0);
+			flip(sp, OP_FLIP, FB_BASE0, 0);
+			flip(sp, OP_PAN, FB_BASE0, pan);
+			overlay(sp, (unsigned int)i);
+			overlay(sp, (unsigned int)i + 1);
+			overlay_off(sp);
+
+			if (verbose) {
+				printf("%s %ux%u: %lu reads, %lu writes so far\n", sp->name,
+					timing->width, timing->height,
+					sp->ops[OP_MODE_SET].reads, sp->ops[OP_MODE_SET].writes);
+			}
+		}
+	}
+
+	printf("%d iterations, per operation:\n", iterations);
+	for (p = 0; p < 2; p++) {
+		report(&sim_pipes[p]);
+	}
+	if (top > 0) {
+		report_regs(top);
+	}
+	if (untracked) {
+		printf("%lu accesses outside the simulated register files\n",
+			untracked);
+	}
+
+	if (errors) {
+		printf("%lu check(s) failed\n", errors);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,14 @@
+/*
+ * Adds what the overlay code takes from <linux/kernel.h> and friends to
+ * the emgd_mode_bench stand-in.
+ */
+#include_next <linux/kernel.h>
+
+#ifndef _STUB_SIM_KERNEL_H
+#define _STUB_SIM_KERNEL_H
+
+#include <errno.h>
+
+#define EXPORT_SYMBOL(sym)	extern int __sim_export_##sym
+
+#endif
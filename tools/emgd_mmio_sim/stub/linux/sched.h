@@ -0,0 +1,18 @@
+/*
+ * Adds the mutex the Atom E6xx platform context embeds to the
+ * emgd_mode_bench stand-in for <linux/sched.h>. The simulator is single
+ * threaded, so locking always succeeds.
+ */
+#include_next <linux/sched.h>
+
+#ifndef _STUB_SIM_SCHED_H
+#define _STUB_SIM_SCHED_H
+
+struct mutex { int locked; };
+
+#define mutex_init(m)			((m)->locked = 0)
+#define mutex_lock(m)			((m)->locked = 1)
+#define mutex_lock_interruptible(m)	((m)->locked = 1, 0)
+#define mutex_unlock(m)			((m)->locked = 0)
+
+#endif
@@ -0,0 +1,1085 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: emgd_mode_bench.c
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Benchmarks the display mode code of the driver in userspace. The EDID
+ *  and DisplayID parsers, the mode tables, pi.c, the common port driver
+ *  filter, match.c and the Atom E6xx clock code are linked unchanged; the
+ *  rest of the driver is replaced by mode_user.c.
+ *
+ *  For every monitor in the corpus, and for both an LVDS (pipe A) and an
+ *  SDVO (pipe B) port, the tool measures:
+ *   - mode list build: pi_pd_init() reading the EDID over (simulated) DDC,
+ *     parsing it and filtering the result through the port driver,
+ *   - mode match: kms_match_mode() for every mode in the list, plus a few
+ *     resolutions that are not in it,
+ *   - PLL solve: kms_program_clock_tnc() for every mode in the list.
+ *
+ *  It then matches every mode of a -l entry table built from the CRT and
+ *  CEA mode tables, once through the port's sorted timing index and once
+ *  walking the table as the driver does without one.
+ *
+ *  The corpus is every file in the -d directory (raw EDID/DisplayID blobs,
+ *  e.g. copies of /sys/class/drm/card0-<connector>/edid), a monitor with no EDID,
+ *  and -n synthetic monitors generated from the seed. Synthetic EDIDs mix
+ *  panel and VESA DTDs, standard and established timings, range limits
+ *  and CEA extensions; some monitors are DisplayID instead.
+ *
+ *  Results are checked while measuring: every mode in the list must match
+ *  itself exactly, a synthetic monitor's native DTD must be in the list
+ *  when the port can drive it, and an SDVO clock that is accepted must be
+ *  within the driver's error budget. Failures make the exit status
+ *  non-zero.
+ *
+ *  Usage:
+ *   emgd_mode_bench [-n monitors] [-s seed] [-r rounds] [-d dir]
+ *                   [-l entries] [-v]
+ *-----------------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+
+#include <drm/drmP.h>
+#include <igd_mode.h>
+#include <igd_init.h>
+#include <context.h>
+#include <memory.h>
+#include <mode.h>
+#include <pd.h>
+#include <pi.h>
+#include <intelpci.h>
+#include <match.h>
+#include <drm_emgd_private.h>
+#include "mode_user.h"
+
+extern int pi_init(igd_context_t *context);
+extern int pi_pd_init(igd_display_port_t *port, unsigned long port_feature,
+	unsigned long second_port_feature, int drm_load_time);
+extern int kms_program_clock_tnc(emgd_crtc_t *emgd_crtc,
+	igd_clock_t *clock, unsigned long dclk);
+
+#define MAX_MONITORS   4096
+#define NUM_PORTS      2
+#define EDID_BLOCK     128
+
+/* Same budget as TARGET_ERROR in clocks_tnc.c plus rounding, per 10000 */
+#define SDVO_MAX_ERROR 50
+
+typedef struct _monitor {
+	char name[64];
+	unsigned char data[256];
+	unsigned long size;
+	/* Only known for synthetic monitors */
+	unsigned long firmware_type;
+	pd_timing_t native;
+} monitor_t;
+
+typedef struct _stat {
+	double min;
+	double max;
+	double sum;
+	unsigned long count;
+} stat_t;
+
+typedef struct _bench_port {
+	const char *name;
+	igd_display_port_t port;
+	pd_driver_t driver;
+	pd_dvo_info_t dvo_info;
+	igd_clock_t clock;
+	igd_display_pipe_t pipe;
+	igd_display_info_t pt_info;
+	emgd_crtc_t crtc;
+	emgd_encoder_t encoder;
+
+	/* Microseconds per monitor */
+	stat_t build;
+	/* Microseconds per call */
+	stat_t match;
+	stat_t solve;
+	/* Microseconds per call, -l table with and without the timing index */
+	stat_t large;
+	stat_t large_linear;
+	unsigned long modes;
+	unsigned long ddc_bytes;         /* read by all mode list builds */
+	unsigned long clock_fail;
+	unsigned long max_clock_error;   /* per 10000, accepted clocks */
+} bench_port_t;
+
+static monitor_t *monitors;
+static int num_monitors;
+static bench_port_t bench_ports[NUM_PORTS];
+static igd_context_t context;
+static igd_param_t init_params;
+static drm_emgd_priv_t priv;
+static struct drm_device drm_dev;
+static unsigned int seed = 1;
+static unsigned long errors;
+static int verbose;
+
+static unsigned int rnd(void)
+{
+	/* xorshift32, so runs do not depend on the libc rand() */
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+static double now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void stat_add(stat_t *s, double v)
+{
+	if (!s->count || v < s->min) {
+		s->min = v;
+	}
+	if (!s->count || v > s->max) {
+		s->max = v;
+	}
+	s->sum += v;
+	s->count++;
+}
+
+#define CHECK(cond, ...)							\
+	do {											\
+		if (!(cond)) {								\
+			fprintf(stderr, "FAIL: " __VA_ARGS__);	\
+			fputc('\n', stderr);					\
+			errors++;								\
+		}											\
+	} while (0)
+
+
+/*
+ * Corpus generation.
+ *
+ * Timings are built as pd_timing_t, in the driver's convention (totals and
+ * blank/sync positions are "minus 1" values), then encoded into the EDID
+ * or DisplayID layout that the parsers turn back into the same numbers.
+ */
+
+static void make_panel_timing(pd_timing_t *t)
+{
+	static const unsigned short widths[] =
+		{ 800, 1024, 1280, 1280, 1366, 1440, 1600, 1680, 1920 };
+	static const unsigned short refreshes[] = { 50, 56, 60, 60, 60, 70, 75 };
+	unsigned short w = widths[rnd() % (sizeof(widths)/sizeof(widths[0]))];
+	unsigned short h, hb, vb;
+	unsigned long refresh, total;
+
+	switch (rnd() % 4) {
+	case 0: h = (w * 3) / 4; break;
+	case 1: h = (w * 10) / 16; break;
+	case 2: h = (w * 9) / 16; break;
+	default: h = (w * 4) / 5; break;
+	}
+	refresh = refreshes[rnd() % (sizeof(refreshes)/sizeof(refreshes[0]))];
+
+	/* Reduced blanking or something closer to CVT */
+	hb = (rnd() & 1) ? 160 : (unsigned short)(w / 5) & ~7;
+	vb = (unsigned short)(h / 30 + 3 + rnd() % 16);
+
+	memset(t, 0, sizeof(*t));
+	t->width = w;
+	t->height = h;
+	t->htotal = w + hb - 1;
+	t->hblank_start = w - 1;
+	t->hblank_end = t->htotal;
+	t->hsync_start = t->hblank_start + 48;
+	t->hsync_end = t->hsync_start + 32;
+	t->vtotal = h + vb - 1;
+	t->vblank_start = h - 1;
+	t->vblank_end = t->vtotal;
+	t->vsync_start = t->vblank_start + 3;
+	t->vsync_end = t->vsync_start + 6;
+
+	/* EDID and DisplayID store the clock in 10KHz units */
+	total = (unsigned long)(w + hb) * (h + vb);
+	t->dclk = ((total * refresh / 1000 + 9) / 10) * 10;
+	t->refresh = (unsigned short)((t->dclk * 1000) / ((unsigned long)t->htotal * t->vtotal));
+	t->mode_info_flags = (rnd() & 1) ? PD_HSYNC_HIGH : PD_VSYNC_HIGH;
+}
+
+/* A progressive table timing that survives the EDID encoding. */
+static pd_timing_t *pick_table_timing(igd_timing_info_t *table, int size)
+{
+	int count = size / sizeof(igd_timing_info_t);
+	int tries;
+
+	for (tries = 0; tries < 64; tries++) {
+		pd_timing_t *t = &table[rnd() % count];
+
+		if (t->width == IGD_TIMING_TABLE_END || !t->width || !t->height ||
+			(t->mode_info_flags & (PD_SCAN_INTERLACE | IGD_PIXEL_DOUBLE |
+				IGD_LINE_DOUBLE))) {
+			continue;
+		}
+		if (t->hsync_start < t->width || t->vsync_start < t->height ||
+			t->hsync_end <= t->hsync_start || t->vsync_end <= t->vsync_start ||
+			t->vsync_start - t->height + 1 > 63 ||
+			t->vsync_end - t->vsync_start > 15) {
+			continue;
+		}
+		return t;
+	}
+	return NULL;
+}
+
+static void edid_encode_dtd(unsigned char *b, const pd_timing_t *t)
+{
+	unsigned long dclk = t->dclk / 10;
+	unsigned int hblank = t->htotal + 1 - t->width;
+	unsigned int vblank = t->vtotal + 1 - t->height;
+	unsigned int hso = t->hsync_start - (t->width - 1);
+	unsigned int hsw = t->hsync_end - t->hsync_start;
+	unsigned int vso = t->vsync_start - (t->height - 1);
+	unsigned int vsw = t->vsync_end - t->vsync_start;
+
+	memset(b, 0, 18);
+	b[0] = dclk & 0xff;
+	b[1] = (dclk >> 8) & 0xff;
+	b[2] = t->width & 0xff;
+	b[3] = hblank & 0xff;
+	b[4] = ((t->width >> 8) << 4) | ((hblank >> 8) & 0xf);
+	b[5] = t->height & 0xff;
+	b[6] = vblank & 0xff;
+	b[7] = ((t->height >> 8) << 4) | ((vblank >> 8) & 0xf);
+	b[8] = hso & 0xff;
+	b[9] = hsw & 0xff;
+	b[10] = ((vso & 0xf) << 4) | (vsw & 0xf);
+	b[11] = (((hso >> 8) & 3) << 6) | (((hsw >> 8) & 3) << 4) |
+		(((vso >> 4) & 3) << 2) | ((vsw >> 4) & 3);
+	b[12] = 0x40;	/* 320 x 240 mm */
+	b[13] = 0xf0;
+	b[14] = 0x10;
+	/* Digital separate sync */
+	b[17] = 0x18;
+	if (t->mode_info_flags & PD_VSYNC_HIGH) {
+		b[17] |= 0x04;
+	}
+	if (t->mode_info_flags & PD_HSYNC_HIGH) {
+		b[17] |= 0x02;
+	}
+}
+
+/* Returns the two byte EDID standard timing id, or 0x0101 (unused). */
+static unsigned short edid_std_id(const pd_timing_t *t)
+{
+	int aspect;
+
+	if (t->width < 256 || t->width > 2288 || (t->width & 7) ||
+		t->refresh < 60 || t->refresh > 123) {
+		return 0x0101;
+	}
+	/* Same ratios as edid_mark_standard_timings() */
+	if (t->height == ((t->width * 10) >> 4)) {
+		aspect = 0;
+	} else if (t->height == ((t->width * 3) >> 2)) {
+		aspect = 1;
+	} else if (t->height == ((t->width << 2) / 5)) {
+		aspect = 2;
+	} else if (t->height == ((t->width * 9) >> 4)) {
+		aspect = 3;
+	} else {
+		return 0x0101;
+	}
+	return ((t->width / 8 - 31) & 0xff) |
+		(((aspect << 6) | (t->refresh - 60)) << 8);
+}
+
+static void checksum_block(unsigned char *b, int size)
+{
+	unsigned char sum = 0;
+	int i;
+
+	for (i = 0; i < size - 1; i++) {
+		sum += b[i];
+	}
+	b[size - 1] = (unsigned char)(0x100 - sum);
+}
+
+static void make_cea_block(unsigned char *b)
+{
+	static const unsigned char audio[] = { 0x23, 0x09, 0x07, 0x07 };
+	static const unsigned char speaker[] = { 0x83, 0x01, 0x00, 0x00 };
+	static const unsigned char vendor[] = { 0x65, 0x03, 0x0c, 0x00, 0x10, 0x00 };
+	int count = cea_timing_table_size / sizeof(igd_timing_info_t);
+	int offset = 4, nvic, i, ndtd;
+
+	memset(b, 0, EDID_BLOCK);
+	b[0] = 0x02;
+	b[1] = 0x03;
+	b[3] = 0x70 | 1;	/* audio, YCbCr 4:4:4 and 4:2:2, one native */
+
+	/* Video data block: VICs are the mode numbers of cea_timing_table */
+	nvic = 2 + rnd() % 7;
+	b[offset++] = CEA_VIDEO_DATA_BLOCK | nvic;
+	for (i = 0; i < nvic; i++) {
+		pd_timing_t *t = &cea_timing_table[rnd() % count];
+
+		if (t->width == IGD_TIMING_TABLE_END || t->mode_number <= 0) {
+			t = &cea_timing_table[0];
+		}
+		b[offset++] = (t->mode_number & 0x7f) | (i ? 0 : 0x80);
+	}
+	memcpy(&b[offset], audio, sizeof(audio));
+	offset += sizeof(audio);
+	memcpy(&b[offset], speaker, sizeof(speaker));
+	offset += sizeof(speaker);
+	memcpy(&b[offset], vendor, sizeof(vendor));
+	offset += sizeof(vendor);
+
+	/* DTDs follow the data block collection */
+	b[2] = (unsigned char)offset;
+	ndtd = rnd() % 3;
+	for (i = 0; i < ndtd && offset + 18 < EDID_BLOCK - 1; i++) {
+		pd_timing_t *t = pick_table_timing(crt_timing_table,
+			crt_timing_table_size);
+
+		if (t) {
+			edid_encode_dtd(&b[offset], t);
+			offset += 18;
+		}
+	}
+	checksum_block(b, EDID_BLOCK);
+}
+
+static void make_edid(monitor_t *m, int index)
+{
+	static const unsigned char header[] =
+		{ 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00 };
+	unsigned char *b = m->data;
+	unsigned long hrate;
+	int i, offset;
+
+	memset(m->data, 0, sizeof(m->data));
+	memcpy(b, header, sizeof(header));
+	/* "EMB" */
+	b[8] = (('E' - '@') << 2) | (('M' - '@') >> 3);
+	b[9] = ((('M' - '@') & 7) << 5) | ('B' - '@');
+	b[10] = index & 0xff;
+	b[11] = (index >> 8) & 0xff;
+	b[16] = 1;
+	b[17] = 20;
+	b[18] = 1;
+	b[19] = 3;
+	b[20] = 0x80;
+	b[21] = 32;
+	b[22] = 24;
+	b[23] = 120;
+	b[24] = 0x0a;	/* RGB, preferred timing is the first DTD */
+
+	/* Established timings */
+	b[35] = rnd() & 0xff;
+	b[36] = rnd() & 0xff;
+	b[37] = rnd() & 0x80;
+
+	/* Standard timings */
+	for (i = 0; i < 8; i++) {
+		pd_timing_t *t = NULL;
+		unsigned short id = 0x0101;
+
+		if (rnd() % 3) {
+			t = pick_table_timing(crt_timing_table, crt_timing_table_size);
+		}
+		if (t) {
+			id = edid_std_id(t);
+		}
+		b[38 + i * 2] = id & 0xff;
+		b[39 + i * 2] = id >> 8;
+	}
+
+	/* Descriptor 1: the native panel timing */
+	make_panel_timing(&m->native);
+	edid_encode_dtd(&b[54], &m->native);
+	offset = 72;
+
+	/* Descriptor 2: another DTD half of the time */
+	if (rnd() & 1) {
+		pd_timing_t *t = pick_table_timing(crt_timing_table,
+			crt_timing_table_size);
+		if (t) {
+			edid_encode_dtd(&b[offset], t);
+			offset += 18;
+		}
+	}
+
+	/* Monitor name */
+	b[offset + 3] = 0xfc;
+	snprintf((char *)&b[offset + 5], 14, "EMB-%04d\n    ", index % 10000);
+	offset += 18;
+
+	/* Range limits, always wide enough for the native timing */
+	hrate = m->native.dclk / (m->native.htotal + 1);
+	b[offset + 3] = 0xfd;
+	b[offset + 5] = 48;
+	b[offset + 6] = 76 + rnd() % 10;
+	b[offset + 7] = 28;
+	b[offset + 8] = (unsigned char)(hrate + 1 + rnd() % 30);
+	b[offset + 9] = (unsigned char)((m->native.dclk + 9999) / 10000 +
+		rnd() % 10);
+	b[offset + 11] = 0x0a;
+	memset(&b[offset + 12], 0x20, 6);
+
+	if (rnd() & 1) {
+		b[126] = 1;
+		make_cea_block(&b[EDID_BLOCK]);
+		m->size = 2 * EDID_BLOCK;
+	} else {
+		m->size = EDID_BLOCK;
+	}
+	checksum_block(b, EDID_BLOCK);
+
+	m->firmware_type = PI_FIRMWARE_EDID;
+	snprintf(m->name, sizeof(m->name), "edid-%d", index);
+}
+
+static void displayid_encode_dtd(unsigned char *b, const pd_timing_t *t,
+	int preferred)
+{
+	unsigned long dclk = t->dclk / 10;
+	unsigned short f[8];
+	int i;
+
+	/* DisplayID fields are 0 based, see convert_type1_to_pd() */
+	f[0] = t->width - 1;
+	f[1] = t->htotal - t->width;
+	f[2] = (t->hsync_start - t->width) |
+		((t->mode_info_flags & PD_HSYNC_HIGH) ? 0x8000 : 0);
+	f[3] = t->hsync_end - t->hsync_start - 1;
+	f[4] = t->height - 1;
+	f[5] = t->vtotal - t->height;
+	f[6] = (t->vsync_start - t->height) |
+		((t->mode_info_flags & PD_VSYNC_HIGH) ? 0x8000 : 0);
+	f[7] = t->vsync_end - t->vsync_start - 1;
+
+	b[0] = dclk & 0xff;
+	b[1] = (dclk >> 8) & 0xff;
+	b[2] = (dclk >> 16) & 0xff;
+	b[3] = preferred ? 0x80 : 0;
+	for (i = 0; i < 8; i++) {
+		b[4 + i * 2] = f[i] & 0xff;
+		b[5 + i * 2] = f[i] >> 8;
+	}
+}
+
+static void make_displayid(monitor_t *m, int index)
+{
+	unsigned char *b = m->data;
+	int ndtd = 1 + rnd() % 3;
+	int offset = 4, i;
+
+	memset(m->data, 0, sizeof(m->data));
+	b[0] = 0x10;	/* version 1, revision 0 */
+
+	/* Type I detailed timings, the first one preferred (native) */
+	make_panel_timing(&m->native);
+	b[offset++] = DATABLOCK_TIMING_1_DETAIL;
+	b[offset++] = 0;
+	b[offset++] = (unsigned char)(20 * ndtd);
+	displayid_encode_dtd(&b[offset], &m->native, 1);
+	offset += 20;
+	for (i = 1; i < ndtd; i++) {
+		pd_timing_t t;
+
+		make_panel_timing(&t);
+		displayid_encode_dtd(&b[offset], &t, 0);
+		offset += 20;
+	}
+
+	/* VESA standard timings bitmap */
+	b[offset++] = DATABLOCK_VESA_TIMING_STD;
+	b[offset++] = 0;
+	b[offset++] = 10;
+	for (i = 0; i < 10; i++) {
+		b[offset++] = rnd() & 0xff;
+	}
+
+	b[1] = (unsigned char)(offset - 4);
+	checksum_block(b, offset + 1);
+	m->size = EDID_BLOCK;
+
+	m->firmware_type = PI_FIRMWARE_DISPLAYID;
+	snprintf(m->name, sizeof(m->name), "displayid-%d", index);
+}
+
+static int load_dir(const char *dir)
+{
+	DIR *d = opendir(dir);
+	struct dirent *de;
+
+	if (!d) {
+		perror(dir);
+		return -1;
+	}
+	while ((de = readdir(d)) != NULL && num_monitors < MAX_MONITORS) {
+		monitor_t *m = &monitors[num_monitors];
+		char path[1024];
+		FILE *f;
+		size_t size;
+
+		if (de->d_name[0] == '.') {
+			continue;
+		}
+		snprintf(path, sizeof(path), "%s/%s", dir, de->d_name);
+		f = fopen(path, "rb");
+		if (!f) {
+			continue;
+		}
+		memset(m, 0, sizeof(*m));
+		size = fread(m->data, 1, sizeof(m->data), f);
+		fclose(f);
+		if (size < EDID_BLOCK) {
+			fprintf(stderr, "%s: %lu bytes, skipped\n", path,
+				(unsigned long)size);
+			continue;
+		}
+		m->size = size;
+		snprintf(m->name, sizeof(m->name), "%.63s", de->d_name);
+		num_monitors++;
+	}
+	closedir(d);
+	return 0;
+}
+
+
+/*
+ * The bench port driver. pd_context is the bench_port_t; the mode list
+ * comes from the same common filter the real port drivers use.
+ */
+
+static int bench_get_attrs(void *context, unsigned long *num,
+	pd_attr_t **list)
+{
+	*num = 0;
+	*list = NULL;
+	return 0;
+}
+
+static int bench_set_attrs(void *context, unsigned long num, pd_attr_t *list)
+{
+	return 0;
+}
+
+static int bench_get_timing_list(void *context, pd_timing_t *in_list,
+	pd_timing_t **list)
+{
+	bench_port_t *bp = (bench_port_t *)context;
+	pd_display_info_t display_info;
+
+	memset(&display_info, 0, sizeof(display_info));
+	return pd_filter_timings(&bp->port, in_list, list, &bp->dvo_info,
+		&display_info);
+}
+
+static void filter_modes(igd_context_t *context, igd_display_port_t *port,
+	pd_timing_t *in_list)
+{
+}
+
+static void setup_port(bench_port_t *bp, const char *name, int crtc_id,
+	unsigned long port_type, unsigned long pd_type, unsigned long dpll,
+	unsigned long mnp, unsigned long p_shift, unsigned long min_dclk,
+	unsigned long max_dclk)
+{
+	bp->name = name;
+
+	bp->driver.type = pd_type;
+	bp->driver.get_attrs = bench_get_attrs;
+	bp->driver.set_attrs = bench_set_attrs;
+	bp->driver.get_timing_list = bench_get_timing_list;
+	bp->dvo_info.min_dclk = min_dclk;
+	bp->dvo_info.max_dclk = max_dclk;
+
+	bp->port.port_type = port_type;
+	bp->port.port_number = (unsigned long)(bp - bench_ports) + 1;
+	bp->port.pd_driver = &bp->driver;
+	bp->port.pd_context = bp;
+	bp->port.pd_type = pd_type;
+	bp->port.pt_info = &bp->pt_info;
+
+	bp->clock.dpll_control = dpll;
+	bp->clock.mnp = mnp;
+	bp->clock.p_shift = p_shift;
+	bp->pipe.pipe_num = (unsigned long)(bp - bench_ports);
+	bp->pipe.pipe_reg = bp->pipe.pipe_num ? 0x71008 : 0x70008;
+	bp->pipe.clock_reg = &bp->clock;
+
+	bp->crtc.base.dev = &drm_dev;
+	bp->crtc.crtc_id = crtc_id;
+	bp->crtc.igd_pipe = &bp->pipe;
+	list_add_tail(&bp->crtc.base.head, &drm_dev.mode_config.crtc_list);
+
+	bp->encoder.base.dev = &drm_dev;
+	bp->encoder.base.crtc = &bp->crtc.base;
+	bp->encoder.igd_port = &bp->port;
+	list_add_tail(&bp->encoder.base.head, &drm_dev.mode_config.encoder_list);
+}
+
+static void setup(void)
+{
+	int i;
+
+	context.device_context.did = PCI_DEVICE_ID_VGA_TNC;
+	context.device_context.core_freq = 200;
+	context.device_context.virt_mmadr = mode_user_mmio_lvds;
+	context.device_context.virt_mmadr_sdvo = mode_user_mmio_sdvo;
+	context.mod_dispatch.init_params = &init_params;
+	context.mod_dispatch.filter_modes = filter_modes;
+	/* No display params match a bench port: always read the EDID */
+	for (i = 0; i < 5; i++) {
+		init_params.display_params[i].port_number = 0xff;
+	}
+
+	priv.context = &context;
+	drm_dev.dev_private = &priv;
+	INIT_LIST_HEAD(&drm_dev.mode_config.crtc_list);
+	INIT_LIST_HEAD(&drm_dev.mode_config.encoder_list);
+
+	pi_init(&context);
+
+	/* Clock registers as in the Atom E6xx mode tables */
+	setup_port(&bench_ports[0], "lvds", IGD_KMS_PIPEA, IGD_PORT_LVDS,
+		PD_DISPLAY_LVDS_INT, 0x0F014, 0x0F040, 17, 20000, 120000);
+	setup_port(&bench_ports[1], "sdvo", IGD_KMS_PIPEB, IGD_PORT_SDVO,
+		PD_DISPLAY_FP, 0x06018, 0x06048, 16, 20000, 200000);
+	mode_user_reset_mmio();
+}
+
+static void release_port(igd_display_port_t *port)
+{
+	pi_free_timing_index(port);
+	if (port->timing_table) {
+		OS_FREE(port->timing_table);
+	}
+	if (port->firmware_type == PI_FIRMWARE_EDID && port->edid->cea) {
+		cea_extension_t *cea = port->edid->cea;
+
+		if (cea->short_video_desc) {
+			OS_FREE(cea->short_video_desc);
+		}
+		if (cea->short_audio_desc) {
+			OS_FREE(cea->short_audio_desc);
+		}
+		if (cea->vendor_data_block) {
+			OS_FREE(cea->vendor_data_block);
+		}
+		OS_FREE(cea);
+	}
+	if (port->displayid) {
+		OS_FREE(port->displayid);
+	}
+	port->displayid = NULL;
+	port->firmware_type = 0;
+	port->timing_table = NULL;
+	port->num_timing = 0;
+	port->fp_native_dtd = NULL;
+}
+
+
+/* Benchmarks */
+
+static void build_list(bench_port_t *bp, monitor_t *m, int rounds)
+{
+	igd_display_port_t *port = &bp->port;
+	double start, total = 0;
+	int r, ret = 0;
+
+	for (r = 0; r < rounds; r++) {
+		release_port(port);
+		mode_user_set_ddc(m ? m->data : NULL, m ? m->size : 0);
+
+		start = now_us();
+		ret = pi_pd_init(port, 0, 0, 0);
+		total += now_us() - start;
+		bp->ddc_bytes += mode_user_ddc_bytes;
+	}
+	stat_add(&bp->build, total / rounds);
+
+	CHECK(ret == 0 && port->timing_table && port->num_timing,
+		"%s/%s: no mode list (ret %d)", m ? m->name : "none", bp->name, ret);
+	if (!m || !m->firmware_type || !port->timing_table) {
+		return;
+	}
+
+	CHECK(port->firmware_type == m->firmware_type,
+		"%s/%s: parsed as firmware type %lu", m->name, bp->name,
+		(unsigned long)port->firmware_type);
+
+	/* The native DTD must survive unless the port cannot clock it */
+	if (m->native.dclk >= bp->dvo_info.min_dclk &&
+		m->native.dclk <= bp->dvo_info.max_dclk) {
+		pd_timing_t *t = port->timing_table;
+
+		while (t->width != PD_TIMING_LIST_END) {
+			if (t->width == m->native.width &&
+				t->height == m->native.height &&
+				t->dclk == m->native.dclk &&
+				t->htotal == m->native.htotal &&
+				t->vtotal == m->native.vtotal) {
+				break;
+			}
+			t++;
+		}
+		CHECK(t->width != PD_TIMING_LIST_END,
+			"%s/%s: native %ux%u dclk %lu missing from the mode list",
+			m->name, bp->name, m->native.width, m->native.height,
+			m->native.dclk);
+	}
+}
+
+static int match_one(bench_port_t *bp, unsigned short width,
+	unsigned short height, unsigned short refresh, unsigned long flags,
+	igd_timing_info_t **timing)
+{
+	igd_framebuffer_info_t fb_info;
+
+	memset(&bp->pt_info, 0, sizeof(bp->pt_info));
+	bp->pt_info.width = width;
+	bp->pt_info.height = height;
+	bp->pt_info.refresh = refresh;
+	bp->pt_info.flags = flags;
+
+	memset(&fb_info, 0, sizeof(fb_info));
+	fb_info.width = width;
+	fb_info.height = height;
+	fb_info.pixel_format = IGD_PF_ARGB32;
+
+	return kms_match_mode(&bp->encoder, &fb_info, timing);
+}
+
+static void match_list(bench_port_t *bp, monitor_t *m, int rounds)
+{
+	static const unsigned short off_list[][3] = {
+		{ 1000, 700, 60 },	/* centered in a bigger mode */
+		{ 720, 400, 70 },
+		{ 4096, 2160, 60 },	/* bigger than anything */
+	};
+	const unsigned long mode_flags =
+		IGD_SCAN_INTERLACE | IGD_PIXEL_DOUBLE | IGD_LINE_DOUBLE;
+	pd_timing_t *t;
+	igd_timing_info_t *timing;
+	unsigned long calls = 0;
+	double start;
+	int r, ret;
+	unsigned int i;
+
+	if (!bp->port.timing_table) {
+		return;
+	}
+
+	start = now_us();
+	for (r = 0; r < rounds; r++) {
+		for (t = bp->port.timing_table; t->width != PD_TIMING_LIST_END; t++) {
+			unsigned short w = t->width, h = t->height, rf = t->refresh;
+
+			timing = NULL;
+			ret = match_one(bp, w, h, rf, t->mode_info_flags & mode_flags,
+				&timing);
+			calls++;
+			CHECK(ret == 0 && timing && timing->width == w &&
+				timing->height == h && timing->refresh == rf,
+				"%s/%s: %ux%u@%u matched %ux%u@%u (ret %d)",
+				m ? m->name : "none", bp->name, w, h, rf,
+				timing ? timing->width : 0, timing ? timing->height : 0,
+				timing ? timing->refresh : 0, ret);
+		}
+		for (i = 0; i < sizeof(off_list)/sizeof(off_list[0]); i++) {
+			match_one(bp, off_list[i][0], off_list[i][1], off_list[i][2], 0,
+				&timing);
+			calls++;
+		}
+	}
+	if (calls) {
+		stat_add(&bp->match, (now_us() - start) / calls);
+	}
+}
+
+static void solve_list(bench_port_t *bp, monitor_t *m, int rounds)
+{
+	pd_timing_t *t;
+	unsigned long calls = 0;
+	double start;
+	int r;
+
+	if (!bp->port.timing_table) {
+		return;
+	}
+
+	start = now_us();
+	for (r = 0; r < rounds; r++) {
+		for (t = bp->port.timing_table; t->width != PD_TIMING_LIST_END; t++) {
+			unsigned long err;
+
+			bp->clock.actual_dclk = 0;
+			calls++;
+			if (kms_program_clock_tnc(&bp->crtc, &bp->clock, t->dclk)) {
+				if (!r) {
+					bp->clock_fail++;
+				}
+				continue;
+			}
+			if (r || !bp->clock.actual_dclk) {
+				continue;
+			}
+			err = (bp->clock.actual_dclk > t->dclk) ?
+				bp->clock.actual_dclk - t->dclk :
+				t->dclk - bp->clock.actual_dclk;
+			err = err * 10000 / t->dclk;
+			if (err > bp->max_clock_error) {
+				bp->max_clock_error = err;
+			}
+			CHECK(bp->port.port_type != IGD_PORT_SDVO ||
+				err <= SDVO_MAX_ERROR,
+				"%s/%s: dclk %lu programmed as %lu", m ? m->name : "none",
+				bp->name, t->dclk, bp->clock.actual_dclk);
+		}
+	}
+	if (calls) {
+		stat_add(&bp->solve, (now_us() - start) / calls);
+	}
+	if (bp->port.port_type != IGD_PORT_LVDS) {
+		mode_user_reset_mmio();
+	}
+}
+
+/*
+ * Mode match against a port table far bigger than any monitor's, the size
+ * of what a DisplayID or CEA heavy EDID plus the built-in modes could give:
+ * entries timings cycled from the CRT and CEA tables, each pass through
+ * them at a different refresh so every mode is distinct.  Measured with
+ * the port's timing index and again walking the table.
+ */
+static void match_large(bench_port_t *bp, int entries, int rounds)
+{
+	igd_display_port_t *port = &bp->port;
+	igd_timing_info_t *table, *timing, **indexed;
+	int crt = crt_timing_table_size / sizeof(igd_timing_info_t) - 1;
+	int cea = cea_timing_table_size / sizeof(igd_timing_info_t) - 1;
+	unsigned long calls;
+	double start;
+	int linear, r, i;
+
+	release_port(port);
+	/* release_port() frees it like a port driver's table */
+	table = OS_ALLOC((entries + 1) * sizeof(igd_timing_info_t));
+	if (!table) {
+		return;
+	}
+	memset(table, 0, (entries + 1) * sizeof(igd_timing_info_t));
+	indexed = calloc(entries, sizeof(igd_timing_info_t *));
+	if (!indexed) {
+		OS_FREE(table);
+		return;
+	}
+	for (i = 0; i < entries; i++) {
+		int k = i % (crt + cea);
+
+		table[i] = (k < crt) ? crt_timing_table[k] : cea_timing_table[k - crt];
+		table[i].refresh += (unsigned short)(i / (crt + cea));
+		table[i].mode_info_flags |= PD_MODE_SUPPORTED;
+		table[i].extn_ptr = NULL;
+	}
+	table[entries].width = IGD_TIMING_TABLE_END;
+	port->timing_table = table;
+	port->num_timing = entries;
+
+	for (linear = 0; linear < 2; linear++) {
+		if (linear) {
+			pi_free_timing_index(port);
+		} else {
+			pi_index_timings(port);
+		}
+
+		calls = 0;
+		start = now_us();
+		for (r = 0; r < rounds; r++) {
+			for (i = 0; i < entries; i++) {
+				igd_timing_info_t *t = &table[i];
+
+				timing = NULL;
+				match_one(bp, t->width, t->height, t->refresh,
+					t->mode_info_flags &
+					(IGD_SCAN_INTERLACE | IGD_PIXEL_DOUBLE | IGD_LINE_DOUBLE),
+					&timing);
+				calls++;
+				CHECK(timing && timing->width == t->width &&
+					timing->height == t->height &&
+					timing->refresh == t->refresh,
+					"large/%s: %ux%u@%u matched %ux%u@%u", bp->name,
+					t->width, t->height, t->refresh,
+					timing ? timing->width : 0, timing ? timing->height : 0,
+					timing ? timing->refresh : 0);
+
+				/* Both ways have to pick the same entry */
+				if (!linear) {
+					indexed[i] = timing;
+				}
+				CHECK(!linear || timing == indexed[i],
+					"large/%s: %ux%u@%u matched entry %d indexed, %d walking",
+					bp->name, t->width, t->height, t->refresh,
+					indexed[i] ? (int)(indexed[i] - table) : -1,
+					timing ? (int)(timing - table) : -1);
+			}
+		}
+		stat_add(linear ? &bp->large_linear : &bp->large,
+			(now_us() - start) / calls);
+	}
+	free(indexed);
+	release_port(port);
+}
+
+static void report(const char *what, stat_t *s)
+{
+	if (!s->count) {
+		return;
+	}
+	printf("  %-22s %9.2f %9.2f %9.2f us\n", what, s->min,
+		s->sum / s->count, s->max);
+}
+
+int main(int argc, char **argv)
+{
+	const char *dir = NULL;
+	unsigned int first_seed;
+	int count = 200, rounds = 3, large = 1024;
+	int opt, i, p;
+
+	while ((opt = getopt(argc, argv, "n:s:r:d:l:v")) != -1) {
+		switch (opt) {
+		case 'n':
+			count = atoi(optarg);
+			break;
+		case 's':
+			seed = (unsigned int)strtoul(optarg, NULL, 0);
+			if (!seed) {
+				seed = 1;
+			}
+			break;
+		case 'r':
+			rounds = atoi(optarg);
+			break;
+		case 'd':
+			dir = optarg;
+			break;
+		case 'l':
+			large = atoi(optarg);
+			break;
+		case 'v':
+			verbose = 1;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-n monitors] [-s seed] [-r rounds] "
+				"[-d dir] [-l entries] [-v]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (rounds < 1) {
+		rounds = 1;
+	}
+	first_seed = seed;
+	if (count < 0) {
+		count = 0;
+	}
+
+	monitors = calloc(MAX_MONITORS, sizeof(monitor_t));
+	if (!monitors) {
+		return 1;
+	}
+	if (dir && load_dir(dir)) {
+		return 1;
+	}
+	for (i = 0; i < count && num_monitors < MAX_MONITORS; i++) {
+		if (rnd() % 5) {
+			make_edid(&monitors[num_monitors++], i);
+		} else {
+			make_displayid(&monitors[num_monitors++], i);
+		}
+	}
+
+	setup();
+
+	/* Monitor -1 is "nothing connected" */
+	for (i = -1; i < num_monitors; i++) {
+		monitor_t *m = (i < 0) ? NULL : &monitors[i];
+
+		for (p = 0; p < NUM_PORTS; p++) {
+			bench_port_t *bp = &bench_ports[p];
+			double build = bp->build.sum;
+
+			build_list(bp, m, rounds);
+			match_list(bp, m, rounds);
+			solve_list(bp, m, rounds);
+			bp->modes += bp->port.num_timing;
+
+			if (verbose) {
+				printf("%-24s %s %4lu modes, build %8.2f us\n",
+					m ? m->name : "none", bp->name, bp->port.num_timing,
+					bp->build.sum - build);
+			}
+		}
+	}
+	for (p = 0; p < NUM_PORTS; p++) {
+		if (large > 0) {
+			match_large(&bench_ports[p], large, rounds);
+		}
+		release_port(&bench_ports[p].port);
+	}
+
+	printf("%d monitors, %d rounds, seed %u\n", num_monitors + 1, rounds,
+		first_seed);
+	for (p = 0; p < NUM_PORTS; p++) {
+		bench_port_t *bp = &bench_ports[p];
+
+		printf("%s: %lu modes, %lu clocks not programmable, "
+			"max accepted clock error %lu/10000\n", bp->name, bp->modes,
+			bp->clock_fail, bp->max_clock_error);
+		printf("  %lu DDC bytes read building mode lists\n", bp->ddc_bytes);
+		printf("  %-22s %9s %9s %9s\n", "", "min", "avg", "max");
+		report("mode list build", &bp->build);
+		report("mode match (per call)", &bp->match);
+		report("PLL solve (per call)", &bp->solve);
+		report("large table match", &bp->large);
+		report("  walking the table", &bp->large_linear);
+	}
+
+	if (errors) {
+		printf("%lu check(s) failed\n", errors);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,165 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: mode_user.c
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Userspace replacements for the functions and globals that edid.c,
+ *  displayid.c, pi.c, pd.c, match.c and clocks_tnc.c expect from the rest
+ *  of the driver. See mode_user.h.
+ *
+ *  The register files are plain memory. DPLL lock (0x606C bit 16) and
+ *  the CDVO reset state (0x7000) read back as already done, so the clock
+ *  code never waits on the simulated hardware.
+ *-----------------------------------------------------------------------------
+ */
+
+#include <string.h>
+
+#include <igd_mode.h>
+#include <context.h>
+#include <mode.h>
+#include <utils.h>
+#include <user_config.h>
+#include "i2c_dispatch.h"
+#include "mode_user.h"
+
+unsigned long jiffies;
+
+emgd_drm_config_t config_drm;
+
+unsigned char mode_user_mmio_lvds[MODE_USER_MMIO_SIZE];
+unsigned char mode_user_mmio_sdvo[MODE_USER_MMIO_SIZE];
+
+unsigned long mode_user_ddc_bytes;
+
+static const unsigned char *ddc_data;
+static unsigned long ddc_size;
+
+void mode_user_set_ddc(const unsigned char *data, unsigned long size)
+{
+	ddc_data = data;
+	ddc_size = size;
+	mode_user_ddc_bytes = 0;
+}
+
+void mode_user_reset_mmio(void)
+{
+	*(unsigned int *)&mode_user_mmio_sdvo[0x606C] = 0x10000;
+	*(unsigned int *)&mode_user_mmio_sdvo[0x7000] = 0x50;
+}
+
+static unsigned char *mmio_for_port(unsigned long port_type)
+{
+	if (port_type == IGD_PORT_LVDS) {
+		return mode_user_mmio_lvds;
+	}
+	return mode_user_mmio_sdvo;
+}
+
+unsigned long read_mmio_reg_tnc(unsigned long port_type, unsigned long reg)
+{
+	if (reg > MODE_USER_MMIO_SIZE - 4) {
+		return 0;
+	}
+	return *(unsigned int *)(mmio_for_port(port_type) + reg);
+}
+
+void write_mmio_reg_tnc(unsigned long port_type, unsigned long reg,
+	unsigned long value)
+{
+	if (reg > MODE_USER_MMIO_SIZE - 4) {
+		return;
+	}
+	/* Keep the reset/lock state sticky, like the real hardware after boot */
+	if (port_type != IGD_PORT_LVDS && (reg == 0x606C || reg == 0x7000)) {
+		return;
+	}
+	*(unsigned int *)(mmio_for_port(port_type) + reg) = (unsigned int)value;
+}
+
+/* Same mapping as micro_mode_tnc.c */
+unsigned long get_port_type(int crtc_id)
+{
+	if (crtc_id == IGD_KMS_PIPEA) {
+		return IGD_PORT_LVDS;
+	}
+	if (crtc_id == IGD_KMS_PIPEB) {
+		return IGD_PORT_SDVO;
+	}
+	return 0;
+}
+
+/* The harness registers its own port driver; nothing to probe. */
+int pi_init_all(void *handle)
+{
+	return 0;
+}
+
+/* No display configuration list in the harness. */
+void dsp_dc_init(igd_context_t *context)
+{
+}
+
+static int ddc_read_regs(igd_context_t *context,
+	unsigned long i2c_bus,
+	unsigned long i2c_speed,
+	unsigned long dab,
+	unsigned char reg,
+	unsigned char FAR *buffer,
+	unsigned long num_bytes,
+	unsigned long flags)
+{
+	unsigned long i;
+
+	if (!ddc_data) {
+		return -IGD_ERROR_INVAL;
+	}
+	for (i = 0; i < num_bytes; i++) {
+		buffer[i] = (reg + i < ddc_size) ? ddc_data[reg + i] : 0;
+	}
+	mode_user_ddc_bytes += num_bytes;
+
+	return 0;
+}
+
+static int ddc_write_reg_list(igd_context_t *context,
+	unsigned long i2c_bus,
+	unsigned long i2c_speed,
+	unsigned long dab,
+	pd_reg_t *reg_list,
+	unsigned long flags)
+{
+	return 0;
+}
+
+i2c_dispatch_t i2c_dispatch_tnc = {
+	ddc_read_regs,
+	ddc_write_reg_list,
+};
+
+i2c_dispatch_t i2c_dispatch_plb = {
+	ddc_read_regs,
+	ddc_write_reg_list,
+};
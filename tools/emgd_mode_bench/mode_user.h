@@ -0,0 +1,55 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: mode_user.h
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Userspace replacements for the parts of the driver that the mode-list,
+ *  match and clock code reach outside the files emgd_mode_bench links:
+ *  the register files of the 0:2:0 (LVDS) and 0:3:0 (SDVO) devices, the
+ *  DDC bus and the few globals normally defined by other modules.
+ *-----------------------------------------------------------------------------
+ */
+
+#ifndef _MODE_USER_H
+#define _MODE_USER_H
+
+#define MODE_USER_MMIO_SIZE  0x80000
+
+extern unsigned char mode_user_mmio_lvds[MODE_USER_MMIO_SIZE];
+extern unsigned char mode_user_mmio_sdvo[MODE_USER_MMIO_SIZE];
+
+/* DDC bytes transferred since the last mode_user_set_ddc() */
+extern unsigned long mode_user_ddc_bytes;
+
+/*
+ * Makes data the EDID/DisplayID the "monitor" returns on every DDC read.
+ * A NULL blob behaves like a disconnected monitor: DDC reads fail.
+ */
+extern void mode_user_set_ddc(const unsigned char *data, unsigned long size);
+
+/* Puts the registers the clock code polls into their "done" state. */
+extern void mode_user_reset_mmio(void);
+
+#endif
@@ -0,0 +1,10 @@
+/*
+ * Userspace stand-in for <asm/io.h>; the harness never touches hardware.
+ * Port I/O is only reached from the VGA paths, which are not benchmarked.
+ */
+#define inb(port)		0
+#define inw(port)		0
+#define inl(port)		0
+#define outb(value, port)	do {} while (0)
+#define outw(value, port)	do {} while (0)
+#define outl(value, port)	do {} while (0)
@@ -0,0 +1 @@
+/* Userspace stand-in for <drm/drm.h>; see drmP.h. */
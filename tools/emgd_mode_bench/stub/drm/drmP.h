@@ -0,0 +1,63 @@
+/*
+ * Userspace stand-in for <drm/drmP.h>. mode.h embeds the DRM KMS objects
+ * in the emgd_* wrappers; match.c and clocks_tnc.c only follow ->dev and walk
+ * the CRTC and encoder lists, so only those members exist here.
+ */
+#ifndef _STUB_DRMP_H
+#define _STUB_DRMP_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <linux/list.h>
+#include <linux/workqueue.h>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+typedef struct { int lock; } spinlock_t;
+typedef int irqreturn_t;
+typedef struct { int event; } pm_message_t;
+
+#define DECLARE_BITMAP(name, bits) \
+	unsigned long name[((bits) + 8 * sizeof(long) - 1) / (8 * sizeof(long))]
+
+struct drm_mode_config {
+	struct list_head crtc_list;
+	struct list_head encoder_list;
+};
+
+struct drm_device {
+	void *dev_private;
+	struct drm_mode_config mode_config;
+};
+
+struct drm_crtc {
+	struct drm_device *dev;
+	struct list_head head;
+};
+
+struct drm_encoder {
+	struct drm_device *dev;
+	struct list_head head;
+	struct drm_crtc *crtc;
+};
+
+struct drm_framebuffer { int id; };
+struct drm_mode_set { int id; };
+struct drm_display_mode { int id; };
+struct drm_connector { int id; };
+struct drm_fb_helper { int id; };
+struct drm_property;
+struct drm_pending_vblank_event;
+struct page;
+struct drm_file;
+struct drm_ioctl_desc;
+struct file;
+struct vm_area_struct;
+
+#define DRM_IRQ_ARGS	int irq, void *arg
+
+#endif
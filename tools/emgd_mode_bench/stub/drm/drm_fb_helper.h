@@ -0,0 +1 @@
+/* Userspace stand-in for <drm/drm_fb_helper.h>; see drmP.h. */
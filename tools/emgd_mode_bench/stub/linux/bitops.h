@@ -0,0 +1 @@
+/* Userspace stand-in for <linux/bitops.h>; pd.h supplies BIT() itself. */
@@ -0,0 +1,6 @@
+/* Userspace stand-in for <linux/delay.h>; delays return immediately. */
+#define msecs_to_jiffies(ms)	((unsigned long)(ms))
+#define usecs_to_jiffies(us)	((unsigned long)(us) / 1000)
+#define udelay(us)		do {} while (0)
+#define mdelay(ms)		do {} while (0)
+#define msleep(ms)		do {} while (0)
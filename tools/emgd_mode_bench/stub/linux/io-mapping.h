@@ -0,0 +1 @@
+/* Userspace stand-in for <linux/io-mapping.h>; nothing is needed from it. */
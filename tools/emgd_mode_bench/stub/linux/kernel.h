@@ -0,0 +1,9 @@
+/* Userspace stand-in for <linux/kernel.h> */
+#include <stdio.h>
+
+#define KERN_ERR	""
+#define KERN_WARNING	""
+#define KERN_INFO	""
+#define KERN_DEBUG	""
+
+#define printk printf
@@ -0,0 +1,19 @@
+/* Userspace stand-in for <linux/ktime.h>, backed by CLOCK_MONOTONIC. */
+#ifndef _STUB_KTIME_H
+#define _STUB_KTIME_H
+
+#include <time.h>
+
+typedef long long ktime_t;
+
+static inline ktime_t ktime_get(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ktime_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+#define ktime_us_delta(later, earlier)	(((later) - (earlier)) / 1000)
+
+#endif
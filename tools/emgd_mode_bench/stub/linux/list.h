@@ -0,0 +1,32 @@
+/* Userspace stand-in for <linux/list.h>, covering what the EMGD headers use. */
+#ifndef _STUB_LIST_H
+#define _STUB_LIST_H
+
+#include <stddef.h>
+
+struct list_head { struct list_head *next, *prev; };
+
+#define container_of(ptr, type, member) \
+	((type *)((char *)(ptr) - offsetof(type, member)))
+
+#define list_for_each_entry(pos, list, member) \
+	for (pos = container_of((list)->next, __typeof__(*pos), member); \
+		&pos->member != (list); \
+		pos = container_of(pos->member.next, __typeof__(*pos), member))
+
+static inline void INIT_LIST_HEAD(struct list_head *list)
+{
+	list->next = list;
+	list->prev = list;
+}
+
+static inline void list_add_tail(struct list_head *entry,
+	struct list_head *list)
+{
+	entry->next = list;
+	entry->prev = list->prev;
+	list->prev->next = entry;
+	list->prev = entry;
+}
+
+#endif
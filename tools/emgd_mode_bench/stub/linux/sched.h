@@ -0,0 +1,11 @@
+/*
+ * Userspace stand-in for <linux/sched.h>. Time only moves when the code
+ * sleeps, so polling loops bounded by OS_SET_ALARM still terminate.
+ */
+extern unsigned long jiffies;
+
+#define TASK_INTERRUPTIBLE	1
+#define TASK_KILLABLE		2
+
+#define __set_current_state(state)	do {} while (0)
+#define schedule_timeout(timeout)	(jiffies += (timeout) ? (timeout) : 1)
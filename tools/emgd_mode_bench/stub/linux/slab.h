@@ -0,0 +1,11 @@
+/*
+ * Userspace stand-in for <linux/slab.h>. The kernel header also pulls in
+ * the string functions memory.h's OS_MEMSET/OS_MEMCPY rely on.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#define GFP_KERNEL		0
+#define kmalloc(size, flags)	malloc(size)
+#define kzalloc(size, flags)	calloc(1, size)
+#define kfree(p)		free(p)
@@ -0,0 +1,13 @@
+/*
+ * Userspace stand-in for <linux/tracepoint.h>. Every tracepoint in
+ * emgd_trace.h becomes an empty inline, as in a kernel built without
+ * CONFIG_TRACEPOINTS.
+ */
+#define TP_PROTO(args...)	args
+#define TP_ARGS(args...)	args
+
+#define DECLARE_EVENT_CLASS(name, proto, args, tstruct, assign, print)
+#define DEFINE_EVENT(template, name, proto, args) \
+	static inline void trace_##name(proto) {}
+#define TRACE_EVENT(name, proto, args, tstruct, assign, print) \
+	static inline void trace_##name(proto) {}
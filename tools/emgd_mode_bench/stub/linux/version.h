@@ -0,0 +1,3 @@
+/* Userspace stand-in for <linux/version.h>; pretends to be 2.6.32. */
+#define KERNEL_VERSION(a, b, c)	(((a) << 16) + ((b) << 8) + (c))
+#define LINUX_VERSION_CODE	KERNEL_VERSION(2, 6, 32)
@@ -0,0 +1,24 @@
+/*
+ * Userspace stand-in for <linux/workqueue.h>; work runs synchronously when
+ * it is scheduled.
+ */
+#ifndef _STUB_WORKQUEUE_H
+#define _STUB_WORKQUEUE_H
+
+#include <linux/list.h>
+
+struct work_struct;
+typedef void (*work_func_t)(struct work_struct *work);
+
+struct work_struct { work_func_t func; };
+
+#define INIT_WORK(work, fn)	((work)->func = (fn))
+#define flush_work(work)	do {} while (0)
+
+static inline int schedule_work(struct work_struct *work)
+{
+	work->func(work);
+	return 1;
+}
+
+#endif
@@ -0,0 +1,315 @@
+/*
+ *-----------------------------------------------------------------------------
+ * Filename: emgd_trace_hist.c
+ * $Revision: 1.0 $
+ *-----------------------------------------------------------------------------
+ * Copyright (c) 2002-2010, Intel Corporation.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *-----------------------------------------------------------------------------
+ * Description:
+ *  Converts the text output of the emgd_func_enter/emgd_func_exit
+ *  tracepoints (tracing/trace, trace_pipe or "trace-cmd report") into
+ *  per-function latency histograms.
+ *
+ *  Usage:
+ *   echo 1 > /sys/kernel/debug/tracing/events/emgd/enable
+ *   ... run the workload ...
+ *   emgd_trace_hist < /sys/kernel/debug/tracing/trace
+ *
+ *  Entries and exits are matched per thread. An exit pops the innermost
+ *  matching entry; entries without an exit (early returns that do not use
+ *  EMGD_TRACE_EXIT) are discarded when an outer function exits.
+ *-----------------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_FUNCS      2048
+#define MAX_THREADS    256
+#define MAX_DEPTH      64
+#define MAX_NAME       64
+#define NUM_BUCKETS    20
+
+typedef struct _func_stats {
+	char name[MAX_NAME];
+	unsigned long count;
+	unsigned long long total_ns;
+	unsigned long long max_ns;
+	unsigned long hist[NUM_BUCKETS];
+} func_stats_t;
+
+typedef struct _frame {
+	func_stats_t *func;
+	unsigned long long start_ns;
+} frame_t;
+
+typedef struct _thread {
+	int pid;
+	int depth;
+	frame_t stack[MAX_DEPTH];
+} thread_t;
+
+static func_stats_t funcs[MAX_FUNCS];
+static int num_funcs;
+static thread_t threads[MAX_THREADS];
+static int num_threads;
+
+/*
+ * Linear probing on a string hash; the set of traced functions is small
+ * and fixed, so the table never needs to grow.
+ */
+static func_stats_t *lookup_func(const char *name)
+{
+	unsigned int hash = 5381;
+	const char *c;
+	int i;
+
+	for (c = name; *c; c++) {
+		hash = hash * 33 + (unsigned char)*c;
+	}
+
+	for (i = 0; i < MAX_FUNCS; i++) {
+		func_stats_t *f = &funcs[(hash + i) % MAX_FUNCS];
+
+		if (f->name[0] == '\0') {
+			if (num_funcs == MAX_FUNCS - 1) {
+				return NULL;
+			}
+			strncpy(f->name, name, MAX_NAME - 1);
+			num_funcs++;
+			return f;
+		}
+		if (strncmp(f->name, name, MAX_NAME - 1) == 0) {
+			return f;
+		}
+	}
+	return NULL;
+}
+
+static thread_t *lookup_thread(int pid)
+{
+	int i;
+
+	for (i = 0; i < num_threads; i++) {
+		if (threads[i].pid == pid) {
+			return &threads[i];
+		}
+	}
+	if (num_threads == MAX_THREADS) {
+		return NULL;
+	}
+	threads[num_threads].pid = pid;
+	threads[num_threads].depth = 0;
+	return &threads[num_threads++];
+}
+
+/* Bucket N holds samples shorter than 2^N us */
+static int bucket(unsigned long long ns)
+{
+	unsigned long long us = ns / 1000;
+	int b = 0;
+
+	while (us && b < NUM_BUCKETS - 1) {
+		us >>= 1;
+		b++;
+	}
+	return b;
+}
+
+static void record(func_stats_t *f, unsigned long long ns)
+{
+	f->count++;
+	f->total_ns += ns;
+	if (ns > f->max_ns) {
+		f->max_ns = ns;
+	}
+	f->hist[bucket(ns)]++;
+}
+
+/* "12345.678901" or "12345.678901234" to nanoseconds */
+static int parse_timestamp(const char *s, unsigned long long *ns)
+{
+	unsigned long long sec = 0, frac = 0;
+	int digits = 0;
+
+	if (*s < '0' || *s > '9') {
+		return 0;
+	}
+	while (*s >= '0' && *s <= '9') {
+		sec = sec * 10 + (*s++ - '0');
+	}
+	if (*s == '.') {
+		s++;
+		while (*s >= '0' && *s <= '9') {
+			if (digits < 9) {
+				frac = frac * 10 + (*s - '0');
+				digits++;
+			}
+			s++;
+		}
+	}
+	while (digits++ < 9) {
+		frac *= 10;
+	}
+	*ns = sec * 1000000000ULL + frac;
+	return 1;
+}
+
+/*
+ * Parses one ftrace line of the form
+ *   <comm>-<pid> [cpu] <flags> <timestamp>: emgd_func_enter: <function>
+ * Returns 1 for an enter event, 2 for an exit event and 0 otherwise.
+ */
+static int parse_line(char *line, int *pid, unsigned long long *ns,
+	char **name)
+{
+	char *event, *cpu, *dash, *ts, *end;
+	int type;
+
+	if ((event = strstr(line, ": emgd_func_enter: ")) != NULL) {
+		type = 1;
+	} else if ((event = strstr(line, ": emgd_func_exit: ")) != NULL) {
+		type = 2;
+	} else {
+		return 0;
+	}
+
+	/* The timestamp is the last field before the event name */
+	*event = '\0';
+	ts = strrchr(line, ' ');
+	if (!ts || !parse_timestamp(ts + 1, ns)) {
+		return 0;
+	}
+
+	/* The pid is the number after the last '-' before the cpu field */
+	cpu = strstr(line, " [");
+	if (!cpu) {
+		return 0;
+	}
+	*cpu = '\0';
+	dash = strrchr(line, '-');
+	if (!dash) {
+		return 0;
+	}
+	*pid = atoi(dash + 1);
+
+	*name = strchr(event + 2, ':') + 2;
+	end = *name + strcspn(*name, " \t\r\n");
+	*end = '\0';
+
+	return type;
+}
+
+static int compare_total(const void *a, const void *b)
+{
+	const func_stats_t *fa = *(const func_stats_t * const *)a;
+	const func_stats_t *fb = *(const func_stats_t * const *)b;
+
+	if (fa->total_ns == fb->total_ns) {
+		return 0;
+	}
+	return (fa->total_ns < fb->total_ns) ? 1 : -1;
+}
+
+static void print_report(void)
+{
+	func_stats_t *sorted[MAX_FUNCS];
+	int n = 0, i, b, last;
+
+	for (i = 0; i < MAX_FUNCS; i++) {
+		if (funcs[i].name[0] && funcs[i].count) {
+			sorted[n++] = &funcs[i];
+		}
+	}
+	qsort(sorted, n, sizeof(sorted[0]), compare_total);
+
+	for (i = 0; i < n; i++) {
+		func_stats_t *f = sorted[i];
+
+		printf("%s: count %lu total %llu us avg %llu us max %llu us\n",
+			f->name, f->count, f->total_ns / 1000,
+			f->total_ns / f->count / 1000, f->max_ns / 1000);
+
+		for (last = NUM_BUCKETS - 1; last > 0 && !f->hist[last]; last--) {
+		}
+		for (b = 0; b <= last; b++) {
+			printf("    < %8lu us: %lu\n", 1UL << b, f->hist[b]);
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	char line[1024];
+	FILE *in = stdin;
+
+	if (argc > 1) {
+		in = fopen(argv[1], "r");
+		if (!in) {
+			perror(argv[1]);
+			return 1;
+		}
+	}
+
+	while (fgets(line, sizeof(line), in)) {
+		unsigned long long ns;
+		thread_t *thread;
+		func_stats_t *func;
+		char *name;
+		int pid, type, depth;
+
+		type = parse_line(line, &pid, &ns, &name);
+		if (!type) {
+			continue;
+		}
+		if (!(thread = lookup_thread(pid)) || !(func = lookup_func(name))) {
+			continue;
+		}
+
+		if (type == 1) {
+			if (thread->depth < MAX_DEPTH) {
+				thread->stack[thread->depth].func = func;
+				thread->stack[thread->depth].start_ns = ns;
+				thread->depth++;
+			}
+			continue;
+		}
+
+		for (depth = thread->depth - 1; depth >= 0; depth--) {
+			if (thread->stack[depth].func == func) {
+				break;
+			}
+		}
+		if (depth >= 0) {
+			record(func, ns - thread->stack[depth].start_ns);
+			thread->depth = depth;
+		}
+	}
+
+	if (in != stdin) {
+		fclose(in);
+	}
+
+	print_report();
+	return 0;
+}
@@ -0,0 +1,347 @@
+/*************************************************************************/ /*!
+@Title          PDump stream decoder
+@Copyright      Copyright (c) Imagination Technologies Ltd. All Rights Reserved
+@Description    Expands streams captured with PDUMP_COMPRESS=1 back into the
+                script and parameter files the PDump tools expect.
+@License        Dual MIT/GPLv2
+
+The contents of this file are subject to the MIT license as set out below.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+Alternatively, the contents of this file may be used under the terms of
+the GNU General Public License Version 2 ("GPL") in which case the provisions
+of GPL are applicable instead of those above.
+
+If you wish to allow use of your version of this file only under the terms of
+GPL, and not to allow others to use your version of this file under the terms
+of the MIT license, indicate your decision by deleting the provisions above
+and replace them with the notice and other provisions required by GPL as set
+out in the file called "GPL-COPYING" included in this distribution. If you do
+not delete the provisions above, a recipient may use your version of this file
+under the terms of either the MIT license or GPL.
+
+This License is also included in this distribution in the file called
+"MIT-COPYING".
+
+EXCEPT AS OTHERWISE STATED IN A NEGOTIATED AGREEMENT: (A) THE SOFTWARE IS
+PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT; AND (B) IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/ /**************************************************************************/
+
+/*
+	Usage:
+		pdump_decode <compressed stream> <output file>
+
+	Each stream (script, parameters, driver info) is decoded on its own.
+	The parameter stream must be decoded from its start, as the encoder
+	refers back to parameter data it has already written.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pdump_compress.h>
+
+typedef struct _BUF_
+{
+	unsigned char	*pData;
+	size_t			uLen;
+	size_t			uAlloc;
+} BUF;
+
+static int BufReserve(BUF *psBuf, size_t uExtra)
+{
+	if (psBuf->uLen + uExtra > psBuf->uAlloc)
+	{
+		size_t uAlloc = psBuf->uAlloc ? psBuf->uAlloc : 65536;
+		unsigned char *pData;
+
+		while (psBuf->uLen + uExtra > uAlloc)
+		{
+			uAlloc *= 2;
+		}
+
+		pData = realloc(psBuf->pData, uAlloc);
+		if (pData == NULL)
+		{
+			return -1;
+		}
+		psBuf->pData = pData;
+		psBuf->uAlloc = uAlloc;
+	}
+
+	return 0;
+}
+
+static int GetVarint(const unsigned char **ppIn, const unsigned char *pEnd, unsigned int *puValue)
+{
+	const unsigned char *pIn = *ppIn;
+	unsigned int uValue = 0;
+	unsigned int uShift = 0;
+
+	do
+	{
+		if (pIn == pEnd || uShift > 28)
+		{
+			return -1;
+		}
+		uValue |= (unsigned int)(*pIn & 0x7F) << uShift;
+		uShift += 7;
+	} while (*pIn++ & 0x80);
+
+	*ppIn = pIn;
+	*puValue = uValue;
+
+	return 0;
+}
+
+static int LZGetLength(const unsigned char **ppIn, const unsigned char *pEnd, size_t *puLen)
+{
+	unsigned char uByte;
+
+	do
+	{
+		if (*ppIn == pEnd)
+		{
+			return -1;
+		}
+		uByte = *(*ppIn)++;
+		*puLen += uByte;
+	} while (uByte == 255);
+
+	return 0;
+}
+
+static int LZDecompress(const unsigned char *pIn, size_t uInLen, BUF *psOut)
+{
+	const unsigned char *pEnd = pIn + uInLen;
+
+	psOut->uLen = 0;
+
+	while (pIn < pEnd)
+	{
+		unsigned char uToken = *pIn++;
+		size_t uLiterals = uToken >> 4;
+		size_t uMatch = uToken & 0xF;
+		size_t uDistance;
+
+		if (uLiterals == 15 && LZGetLength(&pIn, pEnd, &uLiterals) != 0)
+		{
+			return -1;
+		}
+		if ((size_t)(pEnd - pIn) < uLiterals || BufReserve(psOut, uLiterals) != 0)
+		{
+			return -1;
+		}
+		memcpy(psOut->pData + psOut->uLen, pIn, uLiterals);
+		psOut->uLen += uLiterals;
+		pIn += uLiterals;
+
+		if (pIn == pEnd)
+		{
+			break;
+		}
+
+		if (pEnd - pIn < 2)
+		{
+			return -1;
+		}
+		uDistance = pIn[0] | (pIn[1] << 8);
+		pIn += 2;
+
+		if (uMatch == 15 && LZGetLength(&pIn, pEnd, &uMatch) != 0)
+		{
+			return -1;
+		}
+		uMatch += PDUMP_COMP_LZ_MIN_MATCH;
+
+		if (uDistance == 0 || uDistance > psOut->uLen || BufReserve(psOut, uMatch) != 0)
+		{
+			return -1;
+		}
+
+		/* Matches may overlap their own output */
+		while (uMatch--)
+		{
+			psOut->pData[psOut->uLen] = psOut->pData[psOut->uLen - uDistance];
+			psOut->uLen++;
+		}
+	}
+
+	return 0;
+}
+
+static int DecodeOps(const unsigned char *pIn, size_t uInLen, BUF *psOut)
+{
+	const unsigned char *pEnd = pIn + uInLen;
+	unsigned int uLastReg = 0;
+	unsigned int uLastValue = 0;
+	int bRegW = 0;
+	char szLine[PDUMP_COMP_REGW_LEN + 1];
+
+	while (pIn < pEnd)
+	{
+		unsigned char uOp = *pIn++;
+		unsigned int uA, uB;
+
+		switch (uOp)
+		{
+			case PDUMP_COMP_OP_DATA:
+				if (GetVarint(&pIn, pEnd, &uA) != 0 || (size_t)(pEnd - pIn) < uA ||
+					BufReserve(psOut, uA) != 0)
+				{
+					return -1;
+				}
+				memcpy(psOut->pData + psOut->uLen, pIn, uA);
+				psOut->uLen += uA;
+				pIn += uA;
+				break;
+
+			case PDUMP_COMP_OP_REGW:
+				if (GetVarint(&pIn, pEnd, &uA) != 0 || GetVarint(&pIn, pEnd, &uB) != 0)
+				{
+					return -1;
+				}
+				uLastReg += (uA >> 1) ^ (0U - (uA & 1));
+				uLastValue = uB;
+				bRegW = 1;
+				/* Fall through */
+			case PDUMP_COMP_OP_REGW_REPEAT:
+				if (!bRegW || BufReserve(psOut, PDUMP_COMP_REGW_LEN) != 0)
+				{
+					return -1;
+				}
+				snprintf(szLine, sizeof(szLine), PDUMP_COMP_REGW_FORMAT, uLastReg, uLastValue);
+				memcpy(psOut->pData + psOut->uLen, szLine, PDUMP_COMP_REGW_LEN);
+				psOut->uLen += PDUMP_COMP_REGW_LEN;
+				break;
+
+			case PDUMP_COMP_OP_COPY:
+				if (GetVarint(&pIn, pEnd, &uA) != 0 || GetVarint(&pIn, pEnd, &uB) != 0 ||
+					(size_t)uA + uB > psOut->uLen || BufReserve(psOut, uB) != 0)
+				{
+					return -1;
+				}
+				memcpy(psOut->pData + psOut->uLen, psOut->pData + uA, uB);
+				psOut->uLen += uB;
+				break;
+
+			default:
+				return -1;
+		}
+	}
+
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	FILE *psIn;
+	FILE *psOut;
+	BUF sIn = {NULL, 0, 0};
+	BUF sOut = {NULL, 0, 0};
+	BUF sOps = {NULL, 0, 0};
+	const unsigned char *pIn;
+	const unsigned char *pEnd;
+	unsigned long ulBlocks = 0;
+	size_t uRead;
+
+	if (argc != 3)
+	{
+		fprintf(stderr, "Usage: %s <compressed stream> <output file>\n", argv[0]);
+		return 1;
+	}
+
+	psIn = fopen(argv[1], "rb");
+	if (psIn == NULL)
+	{
+		perror(argv[1]);
+		return 1;
+	}
+
+	do
+	{
+		if (BufReserve(&sIn, 65536) != 0)
+		{
+			fprintf(stderr, "Out of memory\n");
+			return 1;
+		}
+		uRead = fread(sIn.pData + sIn.uLen, 1, 65536, psIn);
+		sIn.uLen += uRead;
+	} while (uRead != 0);
+	fclose(psIn);
+
+	pIn = sIn.pData;
+	pEnd = sIn.pData + sIn.uLen;
+
+	while (pIn < pEnd)
+	{
+		size_t uBlockStart = pIn - sIn.pData;
+		size_t uOutStart = sOut.uLen;
+		unsigned char uType = *pIn++;
+		unsigned int uDecoded;
+		unsigned int uPayload;
+		int iErr;
+
+		if ((uType != PDUMP_COMP_BLOCK_OPS && uType != PDUMP_COMP_BLOCK_LZ_OPS) ||
+			GetVarint(&pIn, pEnd, &uDecoded) != 0 ||
+			GetVarint(&pIn, pEnd, &uPayload) != 0 ||
+			(size_t)(pEnd - pIn) < uPayload)
+		{
+			fprintf(stderr, "%s: bad block header at offset %lu\n", argv[1], (unsigned long)uBlockStart);
+			return 1;
+		}
+
+		if (uType == PDUMP_COMP_BLOCK_LZ_OPS)
+		{
+			iErr = LZDecompress(pIn, uPayload, &sOps);
+			if (iErr == 0)
+			{
+				iErr = DecodeOps(sOps.pData, sOps.uLen, &sOut);
+			}
+		}
+		else
+		{
+			iErr = DecodeOps(pIn, uPayload, &sOut);
+		}
+
+		if (iErr != 0 || sOut.uLen - uOutStart != uDecoded)
+		{
+			fprintf(stderr, "%s: corrupt block at offset %lu\n", argv[1], (unsigned long)uBlockStart);
+			return 1;
+		}
+
+		pIn += uPayload;
+		ulBlocks++;
+	}
+
+	psOut = fopen(argv[2], "wb");
+	if (psOut == NULL)
+	{
+		perror(argv[2]);
+		return 1;
+	}
+	if (fwrite(sOut.pData, 1, sOut.uLen, psOut) != sOut.uLen || fclose(psOut) != 0)
+	{
+		perror(argv[2]);
+		return 1;
+	}
+
+	fprintf(stderr, "%lu blocks, %lu bytes -> %lu bytes\n",
+			ulBlocks, (unsigned long)sIn.uLen, (unsigned long)sOut.uLen);
+
+	return 0;
+}
@@ -0,0 +1,204 @@
+/*************************************************************************/ /*!
+@Title          Userspace host layer for the debug driver benchmark
+@Copyright      Copyright (c) Imagination Technologies Ltd. All Rights Reserved
+@Description    The Host functions dbgdriv.c needs, on top of libc and pthreads.
+@License        Dual MIT/GPLv2
+
+The contents of this file are subject to the MIT license as set out below.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+Alternatively, the contents of this file may be used under the terms of
+the GNU General Public License Version 2 ("GPL") in which case the provisions
+of GPL are applicable instead of those above.
+
+If you wish to allow use of your version of this file only under the terms of
+GPL, and not to allow others to use your version of this file under the terms
+of the MIT license, indicate your decision by deleting the provisions above
+and replace them with the notice and other provisions required by GPL as set
+out in the file called "GPL-COPYING" included in this distribution. If you do
+not delete the provisions above, a recipient may use your version of this file
+under the terms of either the MIT license or GPL.
+
+This License is also included in this distribution in the file called
+"MIT-COPYING".
+
+EXCEPT AS OTHERWISE STATED IN A NEGOTIATED AGREEMENT: (A) THE SOFTWARE IS
+PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT; AND (B) IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/ /**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include "img_types.h"
+#include "pvr_debug.h"
+#include "dbgdrvif.h"
+#include "dbgdriv.h"
+#include "hotkey.h"
+#include "hostfunc.h"
+
+/* hotkey.c is not built; nothing here ever presses the hot key */
+IMG_UINT32 g_ui32HotKeyFrame = 0xFFFFFFFF;
+IMG_BOOL g_bHotKeyPressed = IMG_FALSE;
+IMG_BOOL g_bHotKeyRegistered = IMG_FALSE;
+
+/* Errors dbgdriv.c reported through PVR_DPF, checked by the benchmark */
+IMG_UINT32 gui32HostErrors;
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVDebugPrintf(IMG_UINT32 ui32DebugLevel, const IMG_CHAR *pszFileName,
+												   IMG_UINT32 ui32Line, const IMG_CHAR *pszFormat, ...)
+{
+	va_list vaArgs;
+
+	/* Overflow warnings are expected; the benchmark overflows on purpose */
+	if ((ui32DebugLevel & (DBGPRIV_FATAL | DBGPRIV_ERROR)) == 0)
+	{
+		return;
+	}
+
+	__sync_fetch_and_add(&gui32HostErrors, 1);
+
+	va_start(vaArgs, pszFormat);
+	fprintf(stderr, "%s:%lu: ", pszFileName, (unsigned long)ui32Line);
+	vfprintf(stderr, pszFormat, vaArgs);
+	fputc('\n', stderr);
+	va_end(vaArgs);
+}
+
+IMG_VOID ActivateHotKeys(PDBG_STREAM psStream)
+{
+	PVR_UNREFERENCED_PARAMETER(psStream);
+}
+
+IMG_VOID DeactivateHotKeys(IMG_VOID)
+{
+}
+
+/*
+	DBG_STREAM keeps its buffer address in an IMG_UINT32, so on a 64 bit
+	host the pages have to come from the bottom 4GB.
+*/
+static IMG_VOID *PageAlloc(IMG_UINT32 ui32Pages)
+{
+	IMG_SIZE_T uiSize = (IMG_SIZE_T)ui32Pages * HOST_PAGESIZE;
+	IMG_UINT8 *pui8Base;
+
+	pui8Base = mmap(NULL, uiSize + HOST_PAGESIZE, PROT_READ | PROT_WRITE,
+					MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+	if (pui8Base == MAP_FAILED)
+	{
+		return IMG_NULL;
+	}
+
+	/* The size goes in a page of its own in front, for PageFree */
+	*(IMG_SIZE_T *)pui8Base = uiSize + HOST_PAGESIZE;
+
+	return pui8Base + HOST_PAGESIZE;
+}
+
+static IMG_VOID PageFree(IMG_VOID *pvBase)
+{
+	IMG_UINT8 *pui8Base = (IMG_UINT8 *)pvBase - HOST_PAGESIZE;
+
+	munmap(pui8Base, *(IMG_SIZE_T *)pui8Base);
+}
+
+IMG_VOID *HostPageablePageAlloc(IMG_UINT32 ui32Pages)
+{
+	return PageAlloc(ui32Pages);
+}
+
+IMG_VOID HostPageablePageFree(IMG_VOID *pvBase)
+{
+	PageFree(pvBase);
+}
+
+IMG_VOID *HostNonPageablePageAlloc(IMG_UINT32 ui32Pages)
+{
+	return PageAlloc(ui32Pages);
+}
+
+IMG_VOID HostNonPageablePageFree(IMG_VOID *pvBase)
+{
+	PageFree(pvBase);
+}
+
+IMG_VOID HostMemSet(IMG_VOID *pvDest, IMG_UINT8 ui8Value, IMG_UINT32 ui32Size)
+{
+	memset(pvDest, ui8Value, ui32Size);
+}
+
+IMG_VOID HostMemCopy(IMG_VOID *pvDst, IMG_VOID *pvSrc, IMG_UINT32 ui32Size)
+{
+	memcpy(pvDst, pvSrc, ui32Size);
+}
+
+IMG_VOID *HostCreateMutex(IMG_VOID)
+{
+	pthread_mutex_t *psMutex = malloc(sizeof(*psMutex));
+
+	if (psMutex)
+	{
+		pthread_mutex_init(psMutex, NULL);
+	}
+
+	return psMutex;
+}
+
+IMG_VOID HostAquireMutex(IMG_VOID *pvMutex)
+{
+	pthread_mutex_lock(pvMutex);
+}
+
+IMG_VOID HostReleaseMutex(IMG_VOID *pvMutex)
+{
+	pthread_mutex_unlock(pvMutex);
+}
+
+IMG_VOID HostDestroyMutex(IMG_VOID *pvMutex)
+{
+	pthread_mutex_destroy(pvMutex);
+	free(pvMutex);
+}
+
+IMG_UINT32 HostAtomicCmpXchg(IMG_UINT32 *pui32Addr, IMG_UINT32 ui32Old, IMG_UINT32 ui32New)
+{
+	return __sync_val_compare_and_swap(pui32Addr, ui32Old, ui32New);
+}
+
+IMG_VOID HostMemoryBarrier(IMG_VOID)
+{
+	__sync_synchronize();
+}
+
+IMG_VOID HostYield(IMG_VOID)
+{
+	sched_yield();
+}
+
+/* The harness reads its streams in place without going through a file */
+IMG_INT32 HostMapStream(PDBG_STREAM psStream, IMG_BOOL bReadInitBuffer)
+{
+	PVR_UNREFERENCED_PARAMETER(psStream);
+	PVR_UNREFERENCED_PARAMETER(bReadInitBuffer);
+
+	return -1;
+}
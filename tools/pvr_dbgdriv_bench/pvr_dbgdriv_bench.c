@@ -0,0 +1,532 @@
+/*************************************************************************/ /*!
+@Title          Debug driver stream stress test
+@Copyright      Copyright (c) Imagination Technologies Ltd. All Rights Reserved
+@Description    Drives dbgdriv.c streams from several writer threads at once
+                while a reader checks that every record comes out whole, in
+                order per writer, and that every byte is accounted for.
+@License        Dual MIT/GPLv2
+
+The contents of this file are subject to the MIT license as set out below.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+Alternatively, the contents of this file may be used under the terms of
+the GNU General Public License Version 2 ("GPL") in which case the provisions
+of GPL are applicable instead of those above.
+
+If you wish to allow use of your version of this file only under the terms of
+GPL, and not to allow others to use your version of this file under the terms
+of the MIT license, indicate your decision by deleting the provisions above
+and replace them with the notice and other provisions required by GPL as set
+out in the file called "GPL-COPYING" included in this distribution. If you do
+not delete the provisions above, a recipient may use your version of this file
+under the terms of either the MIT license or GPL.
+
+This License is also included in this distribution in the file called
+"MIT-COPYING".
+
+EXCEPT AS OTHERWISE STATED IN A NEGOTIATED AGREEMENT: (A) THE SOFTWARE IS
+PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT; AND (B) IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/ /**************************************************************************/
+
+/*
+	Usage:
+		pvr_dbgdriv_bench [-t writers] [-n records] [-p pages] [-s seed]
+
+	Each writer thread writes -n records of random length to a stream of
+	-p pages, which is far too small to hold them, so the overflow policy
+	runs constantly. Every record carries its writer and sequence number
+	and a pattern derived from them, so the reader can tell a misframed,
+	torn or reordered record from a dropped one. Any mismatch is reported
+	and makes the exit status non-zero.
+
+	Each stream is read twice over: once with DBGDrivRead and once in
+	place, as a reader with the stream buffer mapped does, through
+	DBGDrivAcquireRead and DBGDrivReleaseRead.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include "img_types.h"
+#include "pvr_debug.h"
+#include "dbgdrvif.h"
+#include "dbgdriv.h"
+#include "hostfunc.h"
+
+#define MAX_WRITERS			64
+/* Smallest record that still holds its tag */
+#define RECORD_MIN			4
+#define RECORD_MAX			1024
+/* Big enough for any record, so the reader never has to drop one */
+#define READ_SIZE			4096
+
+typedef struct _WRITER_
+{
+	pthread_t		sThread;
+	PDBG_STREAM		psStream;
+	IMG_UINT32		ui32Writer;
+	IMG_UINT32		ui32Count;
+	IMG_UINT32		ui32Seed;
+	IMG_BOOL		bMixWrite2;
+} WRITER;
+
+typedef struct _READER_
+{
+	IMG_UINT32		ui32Writers;
+	IMG_UINT32		aui32Next[MAX_WRITERS];
+	IMG_UINT32		ui32Records;
+	IMG_UINT32		ui32Bytes;
+	IMG_UINT32		ui32Pending;
+	IMG_BOOL		bLost;
+	IMG_UINT8		aui8Pending[READ_SIZE + RECORD_MAX + 4];
+} READER;
+
+static IMG_UINT32 gui32Seed = 1;
+static IMG_UINT32 gui32Errors;
+static IMG_UINT32 gui32WritersDone;
+
+/* From hostfunc_user.c */
+extern IMG_UINT32 gui32HostErrors;
+
+static IMG_UINT32 Random(IMG_UINT32 *pui32State)
+{
+	/* xorshift32, so runs do not depend on the libc rand() */
+	IMG_UINT32 ui32X = *pui32State;
+
+	ui32X = (ui32X ^ (ui32X << 13)) & 0xFFFFFFFFUL;
+	ui32X ^= ui32X >> 17;
+	ui32X = (ui32X ^ (ui32X << 5)) & 0xFFFFFFFFUL;
+
+	return *pui32State = ui32X;
+}
+
+static double Now(IMG_VOID)
+{
+	struct timespec sTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &sTime);
+
+	return sTime.tv_sec + sTime.tv_nsec / 1e9;
+}
+
+static IMG_VOID Report(const IMG_CHAR *pszName, IMG_UINT32 ui32Ops, double dStart)
+{
+	double dSecs = Now() - dStart;
+
+	printf("%-28s %10lu ops %9.3f ms %12.0f ops/s\n", pszName, (unsigned long)ui32Ops,
+		   dSecs * 1e3, dSecs > 0 ? ui32Ops / dSecs : 0.0);
+}
+
+#define CHECK(cond, ...)							\
+	do {											\
+		if (!(cond))								\
+		{											\
+			fprintf(stderr, "FAIL: " __VA_ARGS__);	\
+			fputc('\n', stderr);					\
+			gui32Errors++;							\
+		}											\
+	} while (0)
+
+
+static IMG_UINT8 Pattern(IMG_UINT32 ui32Tag, IMG_UINT32 i)
+{
+	return (IMG_UINT8)((ui32Tag * 2654435761UL + i * 7) >> 8);
+}
+
+static IMG_VOID *WriterThread(IMG_VOID *pvArg)
+{
+	WRITER *psWriter = pvArg;
+	IMG_UINT8 aui8Record[RECORD_MAX];
+	IMG_UINT32 ui32Seq;
+	IMG_UINT32 i;
+
+	for (ui32Seq = 0; ui32Seq < psWriter->ui32Count; ui32Seq++)
+	{
+		IMG_UINT32 ui32Len = RECORD_MIN + Random(&psWriter->ui32Seed) % (RECORD_MAX - RECORD_MIN);
+		IMG_UINT32 ui32Tag = (psWriter->ui32Writer << 24) | ui32Seq;
+
+		/* Records carry 32 bit little endian values, as on the target */
+		memcpy(aui8Record, &ui32Tag, 4);
+		for (i = 4; i < ui32Len; i++)
+		{
+			aui8Record[i] = Pattern(ui32Tag, i);
+		}
+
+		/* On a drop oldest stream DBGDrivWrite2 writes records too */
+		if (psWriter->bMixWrite2 && (ui32Seq & 1))
+		{
+			DBGDrivWrite2(psWriter->psStream, aui8Record, ui32Len, DEBUG_LEVEL_0);
+		}
+		else
+		{
+			DBGDrivWrite(psWriter->psStream, aui8Record, ui32Len, DEBUG_LEVEL_0);
+		}
+	}
+
+	__sync_fetch_and_add(&gui32WritersDone, 1);
+
+	return IMG_NULL;
+}
+
+/*
+	Parses whatever has arrived so far. A record whose length or contents
+	do not check out means framing is lost for good, so it is reported
+	once and nothing more is parsed.
+*/
+static IMG_VOID ReaderParse(READER *psReader)
+{
+	IMG_UINT8 *pui8Data = psReader->aui8Pending;
+	IMG_UINT32 ui32Used = 0;
+
+	while (!psReader->bLost && (psReader->ui32Pending - ui32Used) >= 4)
+	{
+		IMG_UINT32 ui32Len = 0;
+		IMG_UINT32 ui32Tag = 0;
+		IMG_UINT32 ui32Writer;
+		IMG_UINT32 ui32Seq;
+		IMG_UINT32 i;
+
+		memcpy(&ui32Len, pui8Data + ui32Used, 4);
+		if ((ui32Len < RECORD_MIN) || (ui32Len > RECORD_MAX))
+		{
+			CHECK(0, "record %lu has length %lu, framing lost",
+				  (unsigned long)psReader->ui32Records, (unsigned long)ui32Len);
+			psReader->bLost = IMG_TRUE;
+			break;
+		}
+
+		if ((psReader->ui32Pending - ui32Used - 4) < ui32Len)
+		{
+			break;
+		}
+
+		memcpy(&ui32Tag, pui8Data + ui32Used + 4, 4);
+		ui32Writer = ui32Tag >> 24;
+		ui32Seq = ui32Tag & 0xFFFFFF;
+
+		if (ui32Writer >= psReader->ui32Writers)
+		{
+			CHECK(0, "record %lu names writer %lu, framing lost",
+				  (unsigned long)psReader->ui32Records, (unsigned long)ui32Writer);
+			psReader->bLost = IMG_TRUE;
+			break;
+		}
+
+		CHECK(ui32Seq >= psReader->aui32Next[ui32Writer],
+			  "writer %lu record %lu arrived after record %lu",
+			  (unsigned long)ui32Writer, (unsigned long)ui32Seq,
+			  (unsigned long)psReader->aui32Next[ui32Writer] - 1);
+		psReader->aui32Next[ui32Writer] = ui32Seq + 1;
+
+		for (i = 4; i < ui32Len; i++)
+		{
+			if (pui8Data[ui32Used + 4 + i] != Pattern(ui32Tag, i))
+			{
+				CHECK(0, "writer %lu record %lu torn at byte %lu of %lu",
+					  (unsigned long)ui32Writer, (unsigned long)ui32Seq,
+					  (unsigned long)i, (unsigned long)ui32Len);
+				break;
+			}
+		}
+
+		psReader->ui32Records++;
+		ui32Used += 4 + ui32Len;
+	}
+
+	psReader->ui32Pending -= ui32Used;
+	memmove(pui8Data, pui8Data + ui32Used, psReader->ui32Pending);
+}
+
+/*
+	Reads the way a reader with the stream buffer mapped does: straight
+	out of the buffer, handing the span back afterwards. A span a drop
+	oldest writer discarded meanwhile may have been overwritten, so it is
+	thrown away, which the reader's checks would catch if it were not.
+*/
+static IMG_UINT32 ReadInPlace(PDBG_STREAM psStream, IMG_UINT8 *pui8Out, IMG_UINT32 *pui32Discarded)
+{
+	const IMG_UINT8 *pui8Base = (const IMG_UINT8 *)psStream->ui32Base;
+	IMG_UINT32 ui32Offset;
+	IMG_UINT32 ui32Bytes;
+	IMG_UINT32 ui32First;
+
+	for (;;)
+	{
+		ui32Bytes = DBGDrivAcquireRead(psStream, IMG_FALSE, READ_SIZE, &ui32Offset);
+		if (ui32Bytes == 0)
+		{
+			return 0;
+		}
+
+		ui32First = psStream->ui32Size - ui32Offset;
+		if (ui32First > ui32Bytes)
+		{
+			ui32First = ui32Bytes;
+		}
+
+		memcpy(pui8Out, pui8Base + ui32Offset, ui32First);
+		memcpy(pui8Out + ui32First, pui8Base, ui32Bytes - ui32First);
+
+		if (DBGDrivReleaseRead(psStream, IMG_FALSE, ui32Offset, ui32Bytes))
+		{
+			return ui32Bytes;
+		}
+
+		(*pui32Discarded)++;
+	}
+}
+
+static IMG_VOID StressStream(const IMG_CHAR *pszName, IMG_UINT32 ui32Flags, IMG_BOOL bInPlace,
+							 IMG_UINT32 ui32Writers, IMG_UINT32 ui32Count, IMG_UINT32 ui32Pages)
+{
+	static WRITER asWriters[MAX_WRITERS];
+	static READER sReader;
+	PDBG_STREAM psStream;
+	IMG_BOOL bFramed = (ui32Flags & DEBUG_FLAGS_OVERFLOW_DROP_OLDEST) != 0;
+	IMG_UINT32 ui32Live;
+	IMG_UINT32 ui32Read;
+	IMG_UINT32 ui32Discarded = 0;
+	IMG_UINT32 i;
+	double dStart;
+
+	psStream = DBGDrivCreateStream((IMG_CHAR *)pszName, DEBUG_CAPMODE_CONTINUOUS,
+								   DEBUG_OUTMODE_STREAMENABLE, ui32Flags, ui32Pages);
+	if (!psStream)
+	{
+		CHECK(0, "%s: couldn't create stream", pszName);
+		return;
+	}
+	DBGDrivStopInitPhase(psStream);
+
+	memset(&sReader, 0, sizeof(sReader));
+	sReader.ui32Writers = ui32Writers;
+	gui32WritersDone = 0;
+
+	dStart = Now();
+
+	ui32Live = ui32Writers;
+	for (i = 0; i < ui32Writers; i++)
+	{
+		asWriters[i].psStream = psStream;
+		asWriters[i].ui32Writer = i;
+		asWriters[i].ui32Count = ui32Count;
+		asWriters[i].ui32Seed = gui32Seed + i * 0x9E3779B9UL;
+		if (asWriters[i].ui32Seed == 0)
+		{
+			asWriters[i].ui32Seed = 1;
+		}
+		asWriters[i].bMixWrite2 = bFramed;
+
+		if (pthread_create(&asWriters[i].sThread, IMG_NULL, WriterThread, &asWriters[i]) != 0)
+		{
+			CHECK(0, "%s: couldn't start writer %lu", pszName, (unsigned long)i);
+			ui32Live = i;
+			break;
+		}
+	}
+
+	/*
+		Read until the writers have finished and the stream is empty. The
+		writers only finish once they have committed everything, so an
+		empty read after that means the stream is drained.
+	*/
+	for (;;)
+	{
+		IMG_BOOL bDone = __sync_fetch_and_add(&gui32WritersDone, 0) == ui32Live;
+
+		if (bInPlace)
+		{
+			ui32Read = ReadInPlace(psStream, sReader.aui8Pending + sReader.ui32Pending,
+								   &ui32Discarded);
+		}
+		else
+		{
+			ui32Read = DBGDrivRead(psStream, IMG_FALSE, READ_SIZE,
+								   sReader.aui8Pending + sReader.ui32Pending);
+		}
+		if (ui32Read)
+		{
+			sReader.ui32Bytes += ui32Read;
+			sReader.ui32Pending += ui32Read;
+			ReaderParse(&sReader);
+
+			if (bFramed)
+			{
+				CHECK(sReader.bLost || sReader.ui32Pending == 0,
+					  "%s: read ended part way through a record", pszName);
+			}
+			continue;
+		}
+
+		if (bDone)
+		{
+			break;
+		}
+
+		sched_yield();
+	}
+
+	for (i = 0; i < ui32Live; i++)
+	{
+		pthread_join(asWriters[i].sThread, IMG_NULL);
+	}
+
+	Report(pszName, ui32Writers * ui32Count, dStart);
+
+	CHECK(sReader.ui32Pending == 0, "%s: %lu bytes left over at the end",
+		  pszName, (unsigned long)sReader.ui32Pending);
+
+	/*
+		A drop oldest stream only ever loses whole committed records, so
+		what was read and what was dropped add up to what was written.
+		Otherwise dropped counts data that never made it in.
+	*/
+	if (bFramed)
+	{
+		CHECK(sReader.ui32Bytes + psStream->ui32DataDropped == psStream->ui32DataWritten,
+			  "%s: read %lu + dropped %lu != written %lu", pszName,
+			  (unsigned long)sReader.ui32Bytes, (unsigned long)psStream->ui32DataDropped,
+			  (unsigned long)psStream->ui32DataWritten);
+	}
+	else
+	{
+		CHECK(sReader.ui32Bytes == psStream->ui32DataWritten,
+			  "%s: read %lu != written %lu", pszName,
+			  (unsigned long)sReader.ui32Bytes, (unsigned long)psStream->ui32DataWritten);
+	}
+
+	printf("%-28s %10lu records read, %lu bytes dropped\n", "",
+		   (unsigned long)sReader.ui32Records, (unsigned long)psStream->ui32DataDropped);
+	if (bInPlace)
+	{
+		printf("%-28s %10lu spans discarded while being read\n", "",
+			   (unsigned long)ui32Discarded);
+	}
+
+	DBGDrivDestroyStream(psStream);
+}
+
+static IMG_VOID CheckStrings(IMG_UINT32 ui32Pages)
+{
+	PDBG_STREAM psStream;
+	IMG_CHAR szOut[64];
+	IMG_CHAR szIn[64];
+	IMG_UINT32 ui32Written = 0;
+	IMG_UINT32 ui32Next = 0;
+	IMG_UINT32 i;
+
+	psStream = DBGDrivCreateStream("strings", DEBUG_CAPMODE_CONTINUOUS, DEBUG_OUTMODE_STREAMENABLE,
+								   DEBUG_FLAGS_OVERFLOW_DROP_OLDEST, ui32Pages);
+	if (!psStream)
+	{
+		CHECK(0, "strings: couldn't create stream");
+		return;
+	}
+	DBGDrivStopInitPhase(psStream);
+
+	/* Write enough to wrap several times, so the oldest strings drop */
+	for (i = 0; ui32Written < ui32Pages * HOST_PAGESIZE * 4; i++)
+	{
+		sprintf(szOut, "string %lu", (unsigned long)i);
+		ui32Written += DBGDrivWriteString(psStream, szOut, DEBUG_LEVEL_0);
+	}
+
+	/* A string too long for the caller stays in the stream */
+	CHECK(DBGDrivReadString(psStream, szIn, 4) == 0, "strings: short read consumed a string");
+
+	while (DBGDrivReadString(psStream, szIn, sizeof(szIn) - 1) != 0)
+	{
+		unsigned long ulNum;
+
+		if (sscanf(szIn, "string %lu", &ulNum) != 1)
+		{
+			CHECK(0, "strings: read back \"%s\"", szIn);
+			break;
+		}
+
+		CHECK(ulNum >= ui32Next, "strings: %lu after %lu", ulNum, (unsigned long)ui32Next);
+		ui32Next = ulNum + 1;
+	}
+
+	CHECK(ui32Next == i, "strings: last string read was %lu of %lu",
+		  (unsigned long)ui32Next, (unsigned long)i);
+
+	DBGDrivDestroyStream(psStream);
+}
+
+int main(int argc, char **argv)
+{
+	IMG_UINT32 ui32Writers = 4;
+	IMG_UINT32 ui32Count = 100000;
+	IMG_UINT32 ui32Pages = 4;
+	int iOpt;
+
+	while ((iOpt = getopt(argc, argv, "t:n:p:s:")) != -1)
+	{
+		switch (iOpt)
+		{
+			case 't':
+				ui32Writers = strtoul(optarg, IMG_NULL, 0);
+				break;
+			case 'n':
+				ui32Count = strtoul(optarg, IMG_NULL, 0);
+				break;
+			case 'p':
+				ui32Pages = strtoul(optarg, IMG_NULL, 0);
+				break;
+			case 's':
+				gui32Seed = strtoul(optarg, IMG_NULL, 0);
+				break;
+			default:
+				fprintf(stderr, "Usage: %s [-t writers] [-n records] [-p pages] [-s seed]\n", argv[0]);
+				return 1;
+		}
+	}
+
+	if (ui32Writers < 1 || ui32Writers > MAX_WRITERS || ui32Count > 0xFFFFFF ||
+		ui32Pages < 1 || gui32Seed == 0)
+	{
+		fprintf(stderr, "writers must be 1 to %d, records below 2^24, pages at least 1 and seed non-zero\n",
+				MAX_WRITERS);
+		return 1;
+	}
+
+	printf("%lu writers, %lu pages, seed 0x%lx\n", (unsigned long)ui32Writers,
+		   (unsigned long)ui32Pages, (unsigned long)gui32Seed);
+
+	StressStream("drop oldest", DEBUG_FLAGS_OVERFLOW_DROP_OLDEST, IMG_FALSE, ui32Writers, ui32Count, ui32Pages);
+	StressStream("no expansion", DEBUG_FLAGS_NO_BUF_EXPANDSION, IMG_FALSE, ui32Writers, ui32Count, ui32Pages);
+	StressStream("drop oldest, in place", DEBUG_FLAGS_OVERFLOW_DROP_OLDEST, IMG_TRUE, ui32Writers, ui32Count, ui32Pages);
+	StressStream("no expansion, in place", DEBUG_FLAGS_NO_BUF_EXPANDSION, IMG_TRUE, ui32Writers, ui32Count, ui32Pages);
+	CheckStrings(ui32Pages);
+
+	/* A stream that had to resync lost its framing at some point */
+	CHECK(gui32HostErrors == 0, "dbgdriv.c reported %lu errors", (unsigned long)gui32HostErrors);
+
+	if (gui32Errors)
+	{
+		fprintf(stderr, "%lu errors\n", (unsigned long)gui32Errors);
+		return 1;
+	}
+
+	return 0;
+}
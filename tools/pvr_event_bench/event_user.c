@@ -0,0 +1,325 @@
+/*************************************************************************/ /*!
+@Title          Userspace kernel and services layer for the event benchmark
+@Copyright      Copyright (c) Imagination Technologies Ltd. All Rights Reserved
+@Description    Wait queues, tasks and the services functions event.c calls,
+                on top of pthreads. Wake ups and sleeps are counted here.
+@License        Dual MIT/GPLv2
+
+The contents of this file are subject to the MIT license as set out below.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+Alternatively, the contents of this file may be used under the terms of
+the GNU General Public License Version 2 ("GPL") in which case the provisions
+of GPL are applicable instead of those above.
+
+If you wish to allow use of your version of this file only under the terms of
+GPL, and not to allow others to use your version of this file under the terms
+of the MIT license, indicate your decision by deleting the provisions above
+and replace them with the notice and other provisions required by GPL as set
+out in the file called "GPL-COPYING" included in this distribution. If you do
+not delete the provisions above, a recipient may use your version of this file
+under the terms of either the MIT license or GPL.
+
+This License is also included in this distribution in the file called
+"MIT-COPYING".
+
+EXCEPT AS OTHERWISE STATED IN A NEGOTIATED AGREEMENT: (A) THE SOFTWARE IS
+PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT; AND (B) IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/ /**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <linux/mutex.h>
+#include <linux/sched.h>
+
+#include "services_headers.h"
+#include "resman.h"
+#include "perproc.h"
+#include "lock.h"
+#include "event_user.h"
+
+/* The services lock; LinuxEventObjectWait drops it while it sleeps */
+struct mutex gPVRSRVLock = { PTHREAD_MUTEX_INITIALIZER };
+
+EVENT_USER_STATS gsEventUserStats;
+
+struct task_struct
+{
+	pthread_mutex_t	sLock;
+	pthread_cond_t	sCond;
+	IMG_BOOL		bWoken;
+	IMG_UINT32		ui32Wakeups;
+};
+
+static __thread struct task_struct *gpsCurrent;
+
+struct task_struct *get_current(void)
+{
+	if (gpsCurrent == IMG_NULL)
+	{
+		pthread_condattr_t sAttr;
+
+		gpsCurrent = calloc(1, sizeof(*gpsCurrent));
+		if (gpsCurrent == IMG_NULL)
+		{
+			abort();
+		}
+		pthread_mutex_init(&gpsCurrent->sLock, IMG_NULL);
+		pthread_condattr_init(&sAttr);
+		pthread_condattr_setclock(&sAttr, CLOCK_MONOTONIC);
+		pthread_cond_init(&gpsCurrent->sCond, &sAttr);
+		pthread_condattr_destroy(&sAttr);
+	}
+
+	return gpsCurrent;
+}
+
+IMG_UINT32 EventUserTaskWakeups(IMG_VOID)
+{
+	return get_current()->ui32Wakeups;
+}
+
+IMG_VOID EventUserTaskExit(IMG_VOID)
+{
+	if (gpsCurrent != IMG_NULL)
+	{
+		pthread_cond_destroy(&gpsCurrent->sCond);
+		pthread_mutex_destroy(&gpsCurrent->sLock);
+		free(gpsCurrent);
+		gpsCurrent = IMG_NULL;
+	}
+}
+
+void init_waitqueue_head(wait_queue_head_t *q)
+{
+	pthread_mutex_init(&q->lock, IMG_NULL);
+	INIT_LIST_HEAD(&q->task_list);
+}
+
+/* Unlocked, like the kernel's; callers order it with smp_mb() */
+int waitqueue_active(wait_queue_head_t *q)
+{
+	return !list_empty(&q->task_list);
+}
+
+void prepare_to_wait(wait_queue_head_t *q, wait_queue_t *w, int state)
+{
+	PVR_UNREFERENCED_PARAMETER(state);
+
+	pthread_mutex_lock(&q->lock);
+	if (list_empty(&w->entry))
+	{
+		list_add_tail(&w->entry, &q->task_list);
+	}
+	pthread_mutex_lock(&w->task->sLock);
+	w->task->bWoken = IMG_FALSE;
+	pthread_mutex_unlock(&w->task->sLock);
+	pthread_mutex_unlock(&q->lock);
+
+	/* set_current_state() implies a full barrier */
+	smp_mb();
+}
+
+void finish_wait(wait_queue_head_t *q, wait_queue_t *w)
+{
+	pthread_mutex_lock(&q->lock);
+	if (!list_empty(&w->entry))
+	{
+		list_del_init(&w->entry);
+	}
+	pthread_mutex_unlock(&q->lock);
+}
+
+void wake_up_interruptible(wait_queue_head_t *q)
+{
+	wait_queue_t *w;
+
+	pthread_mutex_lock(&q->lock);
+	list_for_each_entry(w, &q->task_list, entry)
+	{
+		pthread_mutex_lock(&w->task->sLock);
+		if (!w->task->bWoken)
+		{
+			w->task->bWoken = IMG_TRUE;
+			pthread_cond_signal(&w->task->sCond);
+		}
+		pthread_mutex_unlock(&w->task->sLock);
+	}
+	pthread_mutex_unlock(&q->lock);
+}
+
+long schedule_timeout(long timeout)
+{
+	struct task_struct *psTask = get_current();
+	struct timespec sStart, sDeadline, sNow;
+	IMG_BOOL bSlept = IMG_FALSE;
+	long lRemaining;
+	int iErr = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &sStart);
+	sDeadline = sStart;
+	sDeadline.tv_sec += timeout / HZ;
+	sDeadline.tv_nsec += (timeout % HZ) * (1000000000 / HZ);
+	if (sDeadline.tv_nsec >= 1000000000)
+	{
+		sDeadline.tv_sec++;
+		sDeadline.tv_nsec -= 1000000000;
+	}
+
+	pthread_mutex_lock(&psTask->sLock);
+	while (!psTask->bWoken && iErr == 0)
+	{
+		bSlept = IMG_TRUE;
+		iErr = pthread_cond_timedwait(&psTask->sCond, &psTask->sLock, &sDeadline);
+	}
+	/* Being woken counts as running again, as in the kernel */
+	if (psTask->bWoken)
+	{
+		if (bSlept)
+		{
+			psTask->ui32Wakeups++;
+			__sync_fetch_and_add(&gsEventUserStats.ui32Wakeups, 1);
+		}
+		else
+		{
+			__sync_fetch_and_add(&gsEventUserStats.ui32EarlyWakeups, 1);
+		}
+		iErr = 0;
+	}
+	pthread_mutex_unlock(&psTask->sLock);
+
+	if (iErr != 0)
+	{
+		__sync_fetch_and_add(&gsEventUserStats.ui32Timeouts, 1);
+		return 0;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &sNow);
+	lRemaining = timeout - ((sNow.tv_sec - sStart.tv_sec) * HZ +
+							(sNow.tv_nsec - sStart.tv_nsec) / (1000000000 / HZ));
+
+	return lRemaining > 0 ? lRemaining : 1;
+}
+
+/* Sync fences need an anonymous inode, which userspace can't have */
+int anon_inode_getfd(const char *name, const struct file_operations *fops, void *priv, int flags)
+{
+	PVR_UNREFERENCED_PARAMETER(name);
+	PVR_UNREFERENCED_PARAMETER(fops);
+	PVR_UNREFERENCED_PARAMETER(priv);
+	PVR_UNREFERENCED_PARAMETER(flags);
+
+	return -ENOSYS;
+}
+
+PVRSRV_ERROR OSAllocMem_Impl(IMG_UINT32 ui32Flags, IMG_SIZE_T ui32Size, IMG_PVOID *ppvLinAddr, IMG_HANDLE *phBlockAlloc)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32Flags);
+
+	*ppvLinAddr = malloc(ui32Size ? ui32Size : 1);
+	if (phBlockAlloc)
+	{
+		*phBlockAlloc = IMG_NULL;
+	}
+
+	return *ppvLinAddr ? PVRSRV_OK : PVRSRV_ERROR_OUT_OF_MEMORY;
+}
+
+PVRSRV_ERROR OSFreeMem_Impl(IMG_UINT32 ui32Flags, IMG_SIZE_T ui32Size, IMG_PVOID pvLinAddr, IMG_HANDLE hBlockAlloc)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32Flags);
+	PVR_UNREFERENCED_PARAMETER(ui32Size);
+	PVR_UNREFERENCED_PARAMETER(hBlockAlloc);
+
+	free(pvLinAddr);
+
+	return PVRSRV_OK;
+}
+
+IMG_UINT32 OSGetCurrentProcessIDKM(IMG_VOID)
+{
+	return (IMG_UINT32)getpid();
+}
+
+/* Every client thread is in the one process */
+static PVRSRV_PER_PROCESS_DATA gsPerProc;
+
+PVRSRV_PER_PROCESS_DATA *PVRSRVPerProcessData(IMG_UINT32 ui32PID)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32PID);
+
+	return &gsPerProc;
+}
+
+/* A resource is only its free callback; nothing tears the context down */
+struct _RESMAN_ITEM_
+{
+	IMG_PVOID		pvParam;
+	IMG_UINT32		ui32Param;
+	RESMAN_FREE_FN	pfnFreeResource;
+};
+
+PRESMAN_ITEM ResManRegisterRes(PRESMAN_CONTEXT	hResManContext,
+							   IMG_UINT32		ui32ResType,
+							   IMG_PVOID		pvParam,
+							   IMG_UINT32		ui32Param,
+							   RESMAN_FREE_FN	pfnFreeResource)
+{
+	PRESMAN_ITEM psResItem = malloc(sizeof(*psResItem));
+
+	PVR_UNREFERENCED_PARAMETER(hResManContext);
+	PVR_UNREFERENCED_PARAMETER(ui32ResType);
+
+	if (psResItem != IMG_NULL)
+	{
+		psResItem->pvParam = pvParam;
+		psResItem->ui32Param = ui32Param;
+		psResItem->pfnFreeResource = pfnFreeResource;
+	}
+
+	return psResItem;
+}
+
+PVRSRV_ERROR ResManFreeResByPtr(PRESMAN_ITEM psResItem)
+{
+	PVRSRV_ERROR eError;
+
+	if (psResItem == IMG_NULL)
+	{
+		return PVRSRV_ERROR_INVALID_PARAMS;
+	}
+
+	eError = psResItem->pfnFreeResource(psResItem->pvParam, psResItem->ui32Param);
+	free(psResItem);
+
+	return eError;
+}
+
+/* The benchmark owns its sync objects and never drops the last reference */
+PVRSRV_ERROR IMG_CALLCONV PVRSRVFreeSyncInfoKM(PVRSRV_KERNEL_SYNC_INFO *psKernelSyncInfo)
+{
+	PVR_UNREFERENCED_PARAMETER(psKernelSyncInfo);
+
+	fprintf(stderr, "PVRSRVFreeSyncInfoKM: unexpected last reference\n");
+	abort();
+
+	return PVRSRV_ERROR_GENERIC;
+}
@@ -0,0 +1,390 @@
+/*************************************************************************/ /*!
+@Title          Event object wake up benchmark
+@Copyright      Copyright (c) Imagination Technologies Ltd. All Rights Reserved
+@Description    Runs env/linux/event.c with several clients waiting for their
+                own frames, and measures the wake ups and context switches
+                each frame costs when the waits take any signal and when
+                they name the sync object they wait for.
+@License        Dual MIT/GPLv2
+
+The contents of this file are subject to the MIT license as set out below.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+Alternatively, the contents of this file may be used under the terms of
+the GNU General Public License Version 2 ("GPL") in which case the provisions
+of GPL are applicable instead of those above.
+
+If you wish to allow use of your version of this file only under the terms of
+GPL, and not to allow others to use your version of this file under the terms
+of the MIT license, indicate your decision by deleting the provisions above
+and replace them with the notice and other provisions required by GPL as set
+out in the file called "GPL-COPYING" included in this distribution. If you do
+not delete the provisions above, a recipient may use your version of this file
+under the terms of either the MIT license or GPL.
+
+This License is also included in this distribution in the file called
+"MIT-COPYING".
+
+EXCEPT AS OTHERWISE STATED IN A NEGOTIATED AGREEMENT: (A) THE SOFTWARE IS
+PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT; AND (B) IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/ /**************************************************************************/
+
+/*
+	Usage:
+		pvr_event_bench [-c clients] [-f frames] [-w work_us] [-r rounds]
+
+	Each client thread submits a frame by raising the pending write
+	operations of its own sync object, and then calls LinuxEventObjectWait
+	on its own event object, under the services lock, until the frame has
+	completed. A "GPU" thread completes the frames in submission order
+	after work_us of busy work each, and signals the event list after
+	every frame, as the MISR does.
+
+	The broadcast pass waits without a sync object, so every signal wakes
+	every sleeping client. The targeted pass passes the client's sync
+	object, so a signal only wakes the client whose frame completed.
+
+	For each pass the benchmark prints, per frame:
+		wakeups		returns from a sleep in schedule_timeout
+		wasted		wakeups after which the frame was still incomplete
+		csw			voluntary/involuntary context switches of the client
+					threads, and of the GPU thread
+		us			wall time
+
+	Sync fences (LinuxSyncFenceCreate and poll) need an anonymous inode
+	and are not measured. A wait that times out means a wake up was lost;
+	it is reported and makes the exit status non-zero.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include <linux/list.h>
+#include <linux/mutex.h>
+
+#include "services_headers.h"
+#include "lock.h"
+#include "event.h"
+#include "event_user.h"
+
+/* Long enough that only a lost wake up can run it out */
+#define EVENT_WAIT_TIMEOUT_MS	1000
+
+typedef struct _BENCH_CLIENT_
+{
+	pthread_t				hThread;
+	PVRSRV_SYNC_DATA		sSyncData;
+	PVRSRV_KERNEL_SYNC_INFO	sSyncInfo;
+	IMG_BOOL				bTargeted;
+
+	/* Results */
+	IMG_UINT32				ui32Waits;
+	IMG_UINT32				ui32Wakeups;
+	IMG_UINT32				ui32Wasted;
+	long					lVoluntary;
+	long					lInvoluntary;
+} BENCH_CLIENT;
+
+static IMG_HANDLE ghEventList;
+static IMG_UINT32 gui32Frames = 2000;
+static IMG_UINT32 gui32WorkUs = 20;
+static IMG_UINT32 gui32Errors;
+
+/* Context switches of the GPU thread in the last pass */
+static long glGPUVoluntary;
+static long glGPUInvoluntary;
+
+/* Submitted frames, in order; each client has at most one outstanding */
+static pthread_mutex_t gsQueueLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t gsQueueCond = PTHREAD_COND_INITIALIZER;
+static BENCH_CLIENT **gppsQueue;
+static IMG_UINT32 gui32QueueSize;
+static IMG_UINT32 gui32QueueHead;
+static IMG_UINT32 gui32QueueTail;
+
+static double Now(IMG_VOID)
+{
+	struct timespec sTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &sTime);
+
+	return sTime.tv_sec + sTime.tv_nsec * 1e-9;
+}
+
+static IMG_VOID ThreadSwitches(long *plVoluntary, long *plInvoluntary)
+{
+	struct rusage sUsage;
+
+	getrusage(RUSAGE_THREAD, &sUsage);
+	*plVoluntary = sUsage.ru_nvcsw;
+	*plInvoluntary = sUsage.ru_nivcsw;
+}
+
+static IMG_VOID QueuePush(BENCH_CLIENT *psClient)
+{
+	pthread_mutex_lock(&gsQueueLock);
+	gppsQueue[gui32QueueTail++ % gui32QueueSize] = psClient;
+	pthread_cond_signal(&gsQueueCond);
+	pthread_mutex_unlock(&gsQueueLock);
+}
+
+static BENCH_CLIENT *QueuePop(IMG_VOID)
+{
+	BENCH_CLIENT *psClient;
+
+	pthread_mutex_lock(&gsQueueLock);
+	while (gui32QueueHead == gui32QueueTail)
+	{
+		pthread_cond_wait(&gsQueueCond, &gsQueueLock);
+	}
+	psClient = gppsQueue[gui32QueueHead++ % gui32QueueSize];
+	pthread_mutex_unlock(&gsQueueLock);
+
+	return psClient;
+}
+
+static IMG_VOID *ClientThread(IMG_VOID *pvArg)
+{
+	BENCH_CLIENT *psClient = pvArg;
+	PVRSRV_SYNC_DATA *psSyncData = &psClient->sSyncData;
+	IMG_HANDLE hOSEventObject;
+	long lVoluntary, lInvoluntary;
+	IMG_UINT32 i;
+
+	mutex_lock(&gPVRSRVLock);
+	if (LinuxEventObjectAdd(ghEventList, &hOSEventObject) != PVRSRV_OK)
+	{
+		mutex_unlock(&gPVRSRVLock);
+		fprintf(stderr, "LinuxEventObjectAdd failed\n");
+		exit(1);
+	}
+	mutex_unlock(&gPVRSRVLock);
+
+	ThreadSwitches(&lVoluntary, &lInvoluntary);
+
+	for (i = 0; i < gui32Frames; i++)
+	{
+		IMG_UINT32 ui32Target;
+		IMG_UINT32 ui32Wakeups = EventUserTaskWakeups();
+
+		mutex_lock(&gPVRSRVLock);
+		ui32Target = ++psSyncData->ui32WriteOpsPending;
+		QueuePush(psClient);
+
+		while ((IMG_INT32)(psSyncData->ui32WriteOpsComplete - ui32Target) < 0)
+		{
+			LinuxEventObjectWait(hOSEventObject, EVENT_WAIT_TIMEOUT_MS,
+								 psClient->bTargeted ? &psClient->sSyncInfo : IMG_NULL);
+			psClient->ui32Waits++;
+		}
+		mutex_unlock(&gPVRSRVLock);
+
+		/* Only the last wake up of a frame was needed */
+		ui32Wakeups = EventUserTaskWakeups() - ui32Wakeups;
+		psClient->ui32Wakeups += ui32Wakeups;
+		if (ui32Wakeups > 1)
+		{
+			psClient->ui32Wasted += ui32Wakeups - 1;
+		}
+	}
+
+	ThreadSwitches(&psClient->lVoluntary, &psClient->lInvoluntary);
+	psClient->lVoluntary -= lVoluntary;
+	psClient->lInvoluntary -= lInvoluntary;
+
+	mutex_lock(&gPVRSRVLock);
+	LinuxEventObjectDelete(ghEventList, hOSEventObject);
+	mutex_unlock(&gPVRSRVLock);
+
+	EventUserTaskExit();
+
+	return IMG_NULL;
+}
+
+static IMG_VOID *GPUThread(IMG_VOID *pvArg)
+{
+	IMG_UINT32 ui32Total = *(IMG_UINT32 *)pvArg;
+	long lVoluntary, lInvoluntary;
+	IMG_UINT32 i;
+
+	ThreadSwitches(&lVoluntary, &lInvoluntary);
+
+	for (i = 0; i < ui32Total; i++)
+	{
+		BENCH_CLIENT *psClient = QueuePop();
+		double fEnd = Now() + gui32WorkUs * 1e-6;
+
+		while (Now() < fEnd)
+		{
+		}
+
+		/* The completion must be visible before the signal looks at it */
+		__sync_fetch_and_add(&psClient->sSyncData.ui32WriteOpsComplete, 1);
+		LinuxEventObjectSignal(ghEventList);
+	}
+
+	ThreadSwitches(&glGPUVoluntary, &glGPUInvoluntary);
+	glGPUVoluntary -= lVoluntary;
+	glGPUInvoluntary -= lInvoluntary;
+
+	return IMG_NULL;
+}
+
+static IMG_VOID BenchPass(IMG_UINT32 ui32Clients, IMG_BOOL bTargeted)
+{
+	BENCH_CLIENT *psClients;
+	pthread_t hGPUThread;
+	IMG_UINT32 ui32Total = ui32Clients * gui32Frames;
+	IMG_UINT32 ui32Waits = 0, ui32Wakeups = 0, ui32Wasted = 0;
+	long lVoluntary = 0, lInvoluntary = 0;
+	double fStart, fTime;
+	IMG_UINT32 ui32Timeouts = gsEventUserStats.ui32Timeouts;
+	IMG_UINT32 i;
+
+	psClients = calloc(ui32Clients, sizeof(*psClients));
+	gppsQueue = calloc(ui32Clients, sizeof(*gppsQueue));
+	if (psClients == IMG_NULL || gppsQueue == IMG_NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+	gui32QueueSize = ui32Clients;
+	gui32QueueHead = gui32QueueTail = 0;
+
+	fStart = Now();
+	pthread_create(&hGPUThread, IMG_NULL, GPUThread, &ui32Total);
+	for (i = 0; i < ui32Clients; i++)
+	{
+		psClients[i].sSyncInfo.psSyncData = &psClients[i].sSyncData;
+		/* The benchmark's own reference; waits never drop the last one */
+		psClients[i].sSyncInfo.ui32RefCount = 1;
+		psClients[i].bTargeted = bTargeted;
+		pthread_create(&psClients[i].hThread, IMG_NULL, ClientThread, &psClients[i]);
+	}
+
+	for (i = 0; i < ui32Clients; i++)
+	{
+		pthread_join(psClients[i].hThread, IMG_NULL);
+
+		if (psClients[i].sSyncData.ui32WriteOpsComplete != gui32Frames ||
+			psClients[i].sSyncInfo.ui32RefCount != 1)
+		{
+			fprintf(stderr, "client %lu: %lu of %lu frames, %lu references\n",
+					(unsigned long)i,
+					(unsigned long)psClients[i].sSyncData.ui32WriteOpsComplete,
+					(unsigned long)gui32Frames,
+					(unsigned long)psClients[i].sSyncInfo.ui32RefCount);
+			gui32Errors++;
+		}
+		ui32Waits += psClients[i].ui32Waits;
+		ui32Wakeups += psClients[i].ui32Wakeups;
+		ui32Wasted += psClients[i].ui32Wasted;
+		lVoluntary += psClients[i].lVoluntary;
+		lInvoluntary += psClients[i].lInvoluntary;
+	}
+	pthread_join(hGPUThread, IMG_NULL);
+	fTime = Now() - fStart;
+
+	ui32Timeouts = gsEventUserStats.ui32Timeouts - ui32Timeouts;
+	if (ui32Timeouts)
+	{
+		fprintf(stderr, "%s: %lu waits timed out\n",
+				bTargeted ? "targeted" : "broadcast", (unsigned long)ui32Timeouts);
+		gui32Errors++;
+	}
+
+	printf("%-9s %2lu clients: %6.3f waits %6.3f wakeups %6.3f wasted %6.3f/%.3f csw (GPU %.3f/%.3f) %7.2f us per frame\n",
+		   bTargeted ? "targeted" : "broadcast",
+		   (unsigned long)ui32Clients,
+		   (double)ui32Waits / ui32Total,
+		   (double)ui32Wakeups / ui32Total,
+		   (double)ui32Wasted / ui32Total,
+		   (double)lVoluntary / ui32Total,
+		   (double)lInvoluntary / ui32Total,
+		   (double)glGPUVoluntary / ui32Total,
+		   (double)glGPUInvoluntary / ui32Total,
+		   fTime * 1e6 / ui32Total);
+
+	free(gppsQueue);
+	free(psClients);
+}
+
+int main(int argc, char **argv)
+{
+	IMG_UINT32 ui32Clients = 4;
+	IMG_UINT32 ui32Rounds = 1;
+	IMG_UINT32 i;
+	int iOpt;
+
+	while ((iOpt = getopt(argc, argv, "c:f:w:r:")) != -1)
+	{
+		switch (iOpt)
+		{
+			case 'c':
+				ui32Clients = strtoul(optarg, IMG_NULL, 0);
+				break;
+			case 'f':
+				gui32Frames = strtoul(optarg, IMG_NULL, 0);
+				break;
+			case 'w':
+				gui32WorkUs = strtoul(optarg, IMG_NULL, 0);
+				break;
+			case 'r':
+				ui32Rounds = strtoul(optarg, IMG_NULL, 0);
+				break;
+			default:
+				fprintf(stderr, "Usage: %s [-c clients] [-f frames] [-w work_us] [-r rounds]\n", argv[0]);
+				return 1;
+		}
+	}
+
+	if (ui32Clients == 0 || gui32Frames == 0)
+	{
+		fprintf(stderr, "clients and frames must be non-zero\n");
+		return 1;
+	}
+
+	if (LinuxEventObjectListCreate(&ghEventList) != PVRSRV_OK)
+	{
+		fprintf(stderr, "LinuxEventObjectListCreate failed\n");
+		return 1;
+	}
+
+	for (i = 0; i < ui32Rounds; i++)
+	{
+		printf("round %lu, %lu frames per client, %lu us per frame on the GPU\n",
+			   (unsigned long)i, (unsigned long)gui32Frames, (unsigned long)gui32WorkUs);
+		BenchPass(ui32Clients, IMG_FALSE);
+		BenchPass(ui32Clients, IMG_TRUE);
+	}
+
+	LinuxEventObjectListDestroy(ghEventList);
+
+	if (gui32Errors)
+	{
+		fprintf(stderr, "%lu errors\n", (unsigned long)gui32Errors);
+		return 1;
+	}
+
+	return 0;
+}
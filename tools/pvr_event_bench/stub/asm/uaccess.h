@@ -0,0 +1,2 @@
+/* Userspace stand-in for <asm/uaccess.h>; see kernel_user.h. */
+#include "../kernel_user.h"
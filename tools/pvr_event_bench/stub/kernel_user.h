@@ -0,0 +1,168 @@
+/*
+ * Userspace stand-in for the kernel headers event.c and the PVR Linux
+ * headers it includes. Locks map onto pthreads; there are no interrupts or
+ * bottom halves, so the _bh and _irqsave variants are the plain locks.
+ * The wait queue and task functions are in event_user.c.
+ */
+#ifndef KERNEL_USER_H
+#define KERNEL_USER_H
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <pthread.h>
+
+/* Before 3.4, so event.c takes <asm/system.h> */
+#define KERNEL_VERSION(a, b, c)	(((a) << 16) + ((b) << 8) + (c))
+#define LINUX_VERSION_CODE		KERNEL_VERSION(2, 6, 35)
+
+#define PAGE_SHIFT				12
+#define PAGE_SIZE				(1UL << PAGE_SHIFT)
+#define DEVICE_COUNT_RESOURCE	12
+#define THIS_MODULE				NULL
+#define __user
+
+#define container_of(ptr, type, member) \
+	((type *)((char *)(ptr) - offsetof(type, member)))
+
+struct list_head {
+	struct list_head *next, *prev;
+};
+
+#define INIT_LIST_HEAD(l)		((l)->next = (l)->prev = (l))
+#define list_empty(l)			((l)->next == (l))
+#define list_entry(p, t, m)		container_of(p, t, m)
+
+static inline void __list_add(struct list_head *n, struct list_head *prev, struct list_head *next)
+{
+	next->prev = n;
+	n->next = next;
+	n->prev = prev;
+	prev->next = n;
+}
+#define list_add(n, h)			__list_add(n, h, (h)->next)
+#define list_add_tail(n, h)		__list_add(n, (h)->prev, h)
+
+static inline void list_del(struct list_head *e)
+{
+	e->next->prev = e->prev;
+	e->prev->next = e->next;
+}
+
+static inline void list_del_init(struct list_head *e)
+{
+	list_del(e);
+	INIT_LIST_HEAD(e);
+}
+
+#define list_for_each_safe(p, n, h) \
+	for ((p) = (h)->next, (n) = (p)->next; (p) != (h); (p) = (n), (n) = (p)->next)
+#define list_for_each_entry(p, h, m) \
+	for ((p) = list_entry((h)->next, typeof(*(p)), m); &(p)->m != (h); \
+		 (p) = list_entry((p)->m.next, typeof(*(p)), m))
+#define list_for_each_entry_safe(p, n, h, m) \
+	for ((p) = list_entry((h)->next, typeof(*(p)), m), \
+		 (n) = list_entry((p)->m.next, typeof(*(p)), m); &(p)->m != (h); \
+		 (p) = (n), (n) = list_entry((n)->m.next, typeof(*(n)), m))
+
+typedef pthread_mutex_t spinlock_t;
+#define spin_lock_init(l)				pthread_mutex_init(l, NULL)
+#define spin_lock_irqsave(l, f)			((void)(f), pthread_mutex_lock(l))
+#define spin_unlock_irqrestore(l, f)	((void)(f), pthread_mutex_unlock(l))
+
+typedef pthread_rwlock_t rwlock_t;
+#define rwlock_init(l)			pthread_rwlock_init(l, NULL)
+#define read_lock(l)			pthread_rwlock_rdlock(l)
+#define read_unlock(l)			pthread_rwlock_unlock(l)
+#define read_lock_bh(l)			pthread_rwlock_rdlock(l)
+#define read_unlock_bh(l)		pthread_rwlock_unlock(l)
+#define write_lock_bh(l)		pthread_rwlock_wrlock(l)
+#define write_unlock_bh(l)		pthread_rwlock_unlock(l)
+
+struct mutex {
+	pthread_mutex_t m;
+};
+#define mutex_lock(l)			pthread_mutex_lock(&(l)->m)
+#define mutex_unlock(l)			pthread_mutex_unlock(&(l)->m)
+
+typedef struct {
+	volatile int counter;
+} atomic_t;
+#define atomic_set(a, v)		((a)->counter = (v))
+#define atomic_read(a)			((a)->counter)
+#define atomic_inc(a)			((void)__sync_fetch_and_add(&(a)->counter, 1))
+#define smp_mb()				__sync_synchronize()
+
+/*
+ * A waiter is queued by prepare_to_wait(), which also clears its task's
+ * woken flag the way the kernel sets TASK_INTERRUPTIBLE. A wake up sets
+ * the flag of every queued task, and schedule_timeout() sleeps until the
+ * flag is set or the timeout runs out.
+ */
+struct task_struct;
+
+typedef struct {
+	struct task_struct *task;
+	struct list_head entry;
+} wait_queue_t;
+
+typedef struct {
+	pthread_mutex_t lock;
+	struct list_head task_list;
+} wait_queue_head_t;
+
+#define TASK_INTERRUPTIBLE		1
+#define HZ						1000
+#define msecs_to_jiffies(ms)	(ms)
+
+struct task_struct *get_current(void);
+#define current					get_current()
+
+#define DEFINE_WAIT(name) \
+	wait_queue_t name = { current, { &(name).entry, &(name).entry } }
+
+void init_waitqueue_head(wait_queue_head_t *q);
+int waitqueue_active(wait_queue_head_t *q);
+void prepare_to_wait(wait_queue_head_t *q, wait_queue_t *w, int state);
+void finish_wait(wait_queue_head_t *q, wait_queue_t *w);
+void wake_up_interruptible(wait_queue_head_t *q);
+long schedule_timeout(long timeout);
+
+/* Enough of the file layer for the sync fence code to build */
+struct inode;
+struct module;
+struct file {
+	void *private_data;
+};
+typedef struct poll_table_struct poll_table;
+#define poll_wait(f, q, p)		((void)(f), (void)(q), (void)(p))
+
+struct file_operations {
+	struct module *owner;
+	unsigned int (*poll)(struct file *, poll_table *);
+	int (*release)(struct inode *, struct file *);
+};
+
+int anon_inode_getfd(const char *name, const struct file_operations *fops, void *priv, int flags);
+
+/* Named by the PVR Linux headers, never used by event.c */
+struct page;
+struct vm_area_struct;
+struct seq_file;
+struct proc_dir_entry;
+struct pci_dev;
+struct tasklet_struct {
+	int unused;
+};
+typedef unsigned long pgprot_t;
+typedef unsigned int gfp_t;
+#define page_to_phys(p)			((unsigned long)(p))
+#define vmalloc_to_page(v)		((struct page *)(v))
+typedef int (read_proc_t)(char *, char **, off_t, int, int *, void *);
+typedef int (write_proc_t)(struct file *, const char __user *, unsigned long, void *);
+
+#endif
@@ -0,0 +1,1154 @@
+/*************************************************************************/ /*!
+@Title          Services core benchmark
+@Copyright      Copyright (c) Imagination Technologies Ltd. All Rights Reserved
+@Description    Measures the hash table, resource arena, handle, resource
+                manager, command queue, buffer manager and per-process data
+                code from services4/srvkm/common in userspace, and checks
+                their results against a simple model while doing so.
+@License        Dual MIT/GPLv2
+
+The contents of this file are subject to the MIT license as set out below.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+Alternatively, the contents of this file may be used under the terms of
+the GNU General Public License Version 2 ("GPL") in which case the provisions
+of GPL are applicable instead of those above.
+
+If you wish to allow use of your version of this file only under the terms of
+GPL, and not to allow others to use your version of this file under the terms
+of the MIT license, indicate your decision by deleting the provisions above
+and replace them with the notice and other provisions required by GPL as set
+out in the file called "GPL-COPYING" included in this distribution. If you do
+not delete the provisions above, a recipient may use your version of this file
+under the terms of either the MIT license or GPL.
+
+This License is also included in this distribution in the file called
+"MIT-COPYING".
+
+EXCEPT AS OTHERWISE STATED IN A NEGOTIATED AGREEMENT: (A) THE SOFTWARE IS
+PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT; AND (B) IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/ /**************************************************************************/
+
+/*
+	Usage:
+		pvr_services_bench [-n count] [-s seed] [-r rounds]
+
+	Each benchmark runs a random operation mix seeded by -s, so a failing
+	run can be repeated exactly. Any mismatch against the model is
+	reported and makes the exit status non-zero.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdarg.h>
+
+#include "services_headers.h"
+#include "hash.h"
+#include "ra.h"
+#include "handle.h"
+#include "resman.h"
+#include "queue.h"
+#include "buffer_manager.h"
+#include "perproc.h"
+#include "lists.h"
+
+/* pvr_bridge_km.h names struct page, which the kernel headers declare */
+struct page;
+#include "pvr_bridge_km.h"
+
+#define RA_QUANTUM			4096
+#define RA_ARENA_PAGES		(256 * 1024)
+/* Keeps the arena about a third full, so failures stay rare */
+#define RA_MAX_LIVE			(RA_ARENA_PAGES / 32)
+
+static IMG_UINT32 gui32Seed = 1;
+static IMG_UINT32 gui32Errors;
+
+static IMG_UINT32 Random(IMG_VOID)
+{
+	/* xorshift32, so runs do not depend on the libc rand() */
+	gui32Seed = (gui32Seed ^ (gui32Seed << 13)) & 0xFFFFFFFFUL;
+	gui32Seed ^= gui32Seed >> 17;
+	gui32Seed = (gui32Seed ^ (gui32Seed << 5)) & 0xFFFFFFFFUL;
+
+	return gui32Seed;
+}
+
+static double Now(IMG_VOID)
+{
+	struct timespec sTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &sTime);
+
+	return sTime.tv_sec + sTime.tv_nsec / 1e9;
+}
+
+static IMG_VOID ReportSecs(const IMG_CHAR *pszName, IMG_UINT32 ui32Ops, double dSecs)
+{
+	printf("%-28s %10lu ops %9.3f ms %12.0f ops/s\n", pszName, (unsigned long)ui32Ops,
+		   dSecs * 1e3, dSecs > 0 ? ui32Ops / dSecs : 0.0);
+}
+
+static IMG_VOID Report(const IMG_CHAR *pszName, IMG_UINT32 ui32Ops, double dStart)
+{
+	ReportSecs(pszName, ui32Ops, Now() - dStart);
+}
+
+#define CHECK(cond, ...)							\
+	do {											\
+		if (!(cond))								\
+		{											\
+			fprintf(stderr, "FAIL: " __VA_ARGS__);	\
+			fputc('\n', stderr);					\
+			gui32Errors++;							\
+		}											\
+	} while (0)
+
+
+static IMG_VOID BenchHash(IMG_UINT32 ui32Count)
+{
+	HASH_TABLE *psHash;
+	IMG_UINTPTR_T *puiKeys;
+	IMG_UINT32 i;
+	double dStart;
+
+	psHash = HASH_Create(16);
+	puiKeys = malloc(ui32Count * sizeof(*puiKeys));
+	if (!psHash || !puiKeys)
+	{
+		CHECK(IMG_FALSE, "hash: out of memory");
+		return;
+	}
+
+	/* Page aligned keys, like the device virtual addresses ra.c stores */
+	for (i = 0; i < ui32Count; i++)
+	{
+		puiKeys[i] = (IMG_UINTPTR_T)(i + 1) << 12;
+	}
+
+	dStart = Now();
+	for (i = 0; i < ui32Count; i++)
+	{
+		if (!HASH_Insert(psHash, puiKeys[i], i + 1))
+		{
+			CHECK(IMG_FALSE, "hash: insert %lu failed", (unsigned long)i);
+		}
+	}
+	Report("hash insert", ui32Count, dStart);
+
+	dStart = Now();
+	for (i = 0; i < ui32Count; i++)
+	{
+		IMG_UINT32 j = Random() % ui32Count;
+		IMG_UINTPTR_T uValue = HASH_Retrieve(psHash, puiKeys[j]);
+
+		CHECK(uValue == j + 1, "hash: key %lu retrieved %lu", (unsigned long)j, (unsigned long)uValue);
+	}
+	Report("hash retrieve", ui32Count, dStart);
+
+	dStart = Now();
+	for (i = 0; i < ui32Count; i++)
+	{
+		IMG_UINTPTR_T uValue = HASH_Remove(psHash, puiKeys[i]);
+
+		CHECK(uValue == i + 1, "hash: key %lu removed %lu", (unsigned long)i, (unsigned long)uValue);
+	}
+	Report("hash remove", ui32Count, dStart);
+
+	CHECK(HASH_Retrieve(psHash, puiKeys[0]) == 0, "hash: removed key still present");
+
+	HASH_Delete(psHash);
+	free(puiKeys);
+}
+
+
+typedef struct _RA_MODEL_
+{
+	IMG_UINTPTR_T	uBase;
+	IMG_SIZE_T		uSize;
+} RA_MODEL;
+
+static IMG_VOID RACheckPages(IMG_UINT8 *pui8Pages, RA_MODEL *psAlloc, IMG_UINT8 ui8Mark)
+{
+	IMG_UINTPTR_T uPage = psAlloc->uBase / RA_QUANTUM;
+	IMG_UINTPTR_T uEnd = uPage + psAlloc->uSize / RA_QUANTUM;
+
+	CHECK(uEnd <= RA_ARENA_PAGES, "ra: allocation 0x%lx+0x%lx outside the arena",
+		  (unsigned long)psAlloc->uBase, (unsigned long)psAlloc->uSize);
+
+	for (; uPage < uEnd && uPage < RA_ARENA_PAGES; uPage++)
+	{
+		CHECK(pui8Pages[uPage] != ui8Mark, "ra: page 0x%lx %s twice", (unsigned long)uPage,
+			  ui8Mark ? "allocated" : "freed");
+		pui8Pages[uPage] = ui8Mark;
+	}
+}
+
+static IMG_VOID BenchRA(IMG_UINT32 ui32Count)
+{
+	RA_ARENA *psArena;
+	RA_MODEL *psAllocs;
+	IMG_UINT8 *pui8Pages;
+	IMG_UINT32 ui32MaxLive = (ui32Count < RA_MAX_LIVE) ? ui32Count : RA_MAX_LIVE;
+	IMG_UINT32 ui32Live = 0;
+	IMG_UINT32 ui32Ops = 0;
+	IMG_UINT32 ui32Failed = 0;
+	IMG_UINT32 i;
+	IMG_UINTPTR_T uBase;
+	double dStart;
+
+	psArena = RA_Create("bench", 0, RA_ARENA_PAGES * RA_QUANTUM, IMG_NULL, RA_QUANTUM,
+						IMG_NULL, IMG_NULL, IMG_NULL, IMG_NULL);
+	psAllocs = malloc(ui32MaxLive * sizeof(*psAllocs));
+	pui8Pages = calloc(RA_ARENA_PAGES, 1);
+	if (!psArena || !psAllocs || !pui8Pages)
+	{
+		CHECK(IMG_FALSE, "ra: out of memory");
+		return;
+	}
+
+	/*
+		Mostly small allocations with the odd large one, freed in random
+		order, roughly like the GMM and MMU page table heaps see.
+	*/
+	dStart = Now();
+	for (i = 0; i < ui32Count * 2; i++)
+	{
+		if (ui32Live < ui32MaxLive && (ui32Live == 0 || (Random() % 3) != 0))
+		{
+			IMG_SIZE_T uSize = ((Random() % 16) == 0 ? (Random() % 256) + 1 : (Random() % 4) + 1) * RA_QUANTUM;
+			IMG_UINT32 ui32Align = (Random() % 4 == 0) ? 16 * RA_QUANTUM : 0;
+			IMG_SIZE_T uActual;
+
+			if (RA_Alloc(psArena, uSize, &uActual, IMG_NULL, 0, ui32Align, 0, &uBase))
+			{
+				CHECK(uActual >= uSize, "ra: short allocation");
+				CHECK(ui32Align == 0 || (uBase % ui32Align) == 0, "ra: 0x%lx not aligned", (unsigned long)uBase);
+				psAllocs[ui32Live].uBase = uBase;
+				psAllocs[ui32Live].uSize = uSize;
+				RACheckPages(pui8Pages, &psAllocs[ui32Live], 1);
+				ui32Live++;
+			}
+			else
+			{
+				ui32Failed++;
+			}
+		}
+		else
+		{
+			IMG_UINT32 j = Random() % ui32Live;
+
+			RACheckPages(pui8Pages, &psAllocs[j], 0);
+			RA_Free(psArena, psAllocs[j].uBase, IMG_FALSE);
+			psAllocs[j] = psAllocs[--ui32Live];
+		}
+		ui32Ops++;
+	}
+	Report("ra alloc/free mix", ui32Ops, dStart);
+
+	dStart = Now();
+	for (i = 0; i < ui32Live; i++)
+	{
+		RACheckPages(pui8Pages, &psAllocs[i], 0);
+		RA_Free(psArena, psAllocs[i].uBase, IMG_FALSE);
+	}
+	Report("ra free all", ui32Live, dStart);
+
+	/* Everything must have coalesced back into one span */
+	CHECK(RA_Alloc(psArena, RA_ARENA_PAGES * RA_QUANTUM, IMG_NULL, IMG_NULL, 0, 0, 0, &uBase),
+		  "ra: arena fragmented after freeing everything");
+	RA_Free(psArena, uBase, IMG_FALSE);
+	CHECK(RA_TestDelete(psArena), "ra: arena not empty");
+
+	if (ui32Failed)
+	{
+		printf("%-28s %10lu\n", "ra allocations failed", (unsigned long)ui32Failed);
+	}
+
+	RA_Delete(psArena);
+	free(psAllocs);
+	free(pui8Pages);
+}
+
+
+static IMG_VOID BenchHandles(IMG_UINT32 ui32Count)
+{
+	PVRSRV_HANDLE_BASE *psBase;
+	IMG_HANDLE *phHandles;
+	IMG_UINT32 i;
+	double dStart;
+
+	if (PVRSRVAllocHandleBase(&psBase) != PVRSRV_OK)
+	{
+		CHECK(IMG_FALSE, "handle: cannot allocate a handle base");
+		return;
+	}
+	phHandles = malloc(ui32Count * sizeof(*phHandles));
+	if (!phHandles)
+	{
+		CHECK(IMG_FALSE, "handle: out of memory");
+		return;
+	}
+
+	/* The data pointers only need to be unique; index + 1 will do */
+	dStart = Now();
+	for (i = 0; i < ui32Count; i++)
+	{
+		CHECK(PVRSRVAllocHandle(psBase, &phHandles[i], (IMG_VOID *)(IMG_UINTPTR_T)(i + 1),
+								PVRSRV_HANDLE_TYPE_MEM_INFO, PVRSRV_HANDLE_ALLOC_FLAG_NONE) == PVRSRV_OK,
+			  "handle: alloc %lu failed", (unsigned long)i);
+	}
+	Report("handle alloc", ui32Count, dStart);
+
+	dStart = Now();
+	for (i = 0; i < ui32Count; i++)
+	{
+		IMG_UINT32 j = Random() % ui32Count;
+		IMG_PVOID pvData = IMG_NULL;
+
+		CHECK(PVRSRVLookupHandle(psBase, &pvData, phHandles[j], PVRSRV_HANDLE_TYPE_MEM_INFO) == PVRSRV_OK &&
+			  pvData == (IMG_VOID *)(IMG_UINTPTR_T)(j + 1),
+			  "handle: lookup %lu returned %p", (unsigned long)j, pvData);
+	}
+	Report("handle lookup", ui32Count, dStart);
+
+	/* Wrong type lookups must fail */
+	{
+		IMG_PVOID pvData;
+
+		CHECK(PVRSRVLookupHandle(psBase, &pvData, phHandles[0], PVRSRV_HANDLE_TYPE_SYNC_INFO) != PVRSRV_OK,
+			  "handle: lookup with the wrong type succeeded");
+	}
+
+	/* Release in random order, then reuse the freed slots */
+	for (i = ui32Count - 1; i > 0; i--)
+	{
+		IMG_UINT32 j = Random() % (i + 1);
+		IMG_HANDLE hTmp = phHandles[i];
+
+		phHandles[i] = phHandles[j];
+		phHandles[j] = hTmp;
+	}
+
+	dStart = Now();
+	for (i = 0; i < ui32Count; i++)
+	{
+		CHECK(PVRSRVReleaseHandle(psBase, phHandles[i], PVRSRV_HANDLE_TYPE_MEM_INFO) == PVRSRV_OK,
+			  "handle: release %lu failed", (unsigned long)i);
+	}
+	Report("handle release", ui32Count, dStart);
+
+	{
+		IMG_PVOID pvData;
+
+		CHECK(PVRSRVLookupHandle(psBase, &pvData, phHandles[0], PVRSRV_HANDLE_TYPE_MEM_INFO) != PVRSRV_OK,
+			  "handle: released handle still valid");
+	}
+
+	dStart = Now();
+	for (i = 0; i < ui32Count; i++)
+	{
+		CHECK(PVRSRVAllocHandle(psBase, &phHandles[i], (IMG_VOID *)(IMG_UINTPTR_T)(i + 1),
+								PVRSRV_HANDLE_TYPE_MEM_INFO, PVRSRV_HANDLE_ALLOC_FLAG_NONE) == PVRSRV_OK,
+			  "handle: realloc %lu failed", (unsigned long)i);
+	}
+	Report("handle realloc", ui32Count, dStart);
+
+	CHECK(PVRSRVFreeHandleBase(psBase) == PVRSRV_OK, "handle: cannot free the handle base");
+	free(phHandles);
+}
+
+
+/* Types a process typically holds on exit; teardown frees them in this order */
+static const IMG_UINT32 aui32ResManTypes[] =
+{
+	RESMAN_TYPE_OS_USERMODE_MAPPING,
+	RESMAN_TYPE_EVENT_OBJECT,
+	RESMAN_TYPE_MODIFY_SYNC_OPS,
+	RESMAN_TYPE_HW_RENDER_CONTEXT,
+	RESMAN_TYPE_DISPLAYCLASS_DEVICE,
+	RESMAN_TYPE_DEVICEMEM_MAPPING,
+	RESMAN_TYPE_DEVICEMEM_ALLOCATION,
+	RESMAN_TYPE_DEVICEMEM_CONTEXT
+};
+#define RESMAN_NUM_TYPES	(sizeof(aui32ResManTypes) / sizeof(aui32ResManTypes[0]))
+
+static IMG_UINT32 gui32ResManFreed;
+static IMG_UINT32 gui32ResManLastRank;
+
+static PVRSRV_ERROR ResManFree(IMG_PVOID pvParam, IMG_UINT32 ui32Param)
+{
+	PVR_UNREFERENCED_PARAMETER(pvParam);
+
+	/* ui32Param is the rank of the item's type in aui32ResManTypes */
+	CHECK(ui32Param >= gui32ResManLastRank, "resman: type %lu freed after type %lu",
+		  (unsigned long)aui32ResManTypes[ui32Param],
+		  (unsigned long)aui32ResManTypes[gui32ResManLastRank]);
+	gui32ResManLastRank = ui32Param;
+	gui32ResManFreed++;
+
+	return PVRSRV_OK;
+}
+
+/* Resources freed per chunk by the chunked teardown pass */
+#define RESMAN_CHUNK	256
+
+/*
+	Process exit: register ui32Count resources of random types in one
+	context and time the disconnect that frees them all. Run at a quarter
+	of the count as well, so the two rates show how the cost scales. A
+	third pass frees the full count RESMAN_CHUNK at a time, as the teardown
+	worker does between bridge lock holds, and reports the longest chunk.
+*/
+static IMG_VOID BenchResMan(IMG_UINT32 ui32Count)
+{
+	IMG_UINT32 ui32Size, ui32Pass, ui32Chunks, i;
+	PRESMAN_CONTEXT psContext;
+	IMG_CHAR szName[32];
+	double dStart, dChunk, dWorst;
+	IMG_BOOL bDone;
+
+	for (ui32Pass = 0; ui32Pass < 3; ui32Pass++)
+	{
+		ui32Size = ui32Pass ? ui32Count : ui32Count / 4;
+
+		if (PVRSRVResManConnect(IMG_NULL, &psContext) != PVRSRV_OK)
+		{
+			CHECK(IMG_FALSE, "resman: cannot connect");
+			return;
+		}
+
+		for (i = 0; i < ui32Size; i++)
+		{
+			IMG_UINT32 ui32Rank = Random() % RESMAN_NUM_TYPES;
+
+			CHECK(ResManRegisterRes(psContext, aui32ResManTypes[ui32Rank],
+									(IMG_PVOID)(IMG_UINTPTR_T)(i + 1), ui32Rank,
+									ResManFree) != IMG_NULL,
+				  "resman: cannot register item %lu", (unsigned long)i);
+		}
+
+		gui32ResManFreed = 0;
+		gui32ResManLastRank = 0;
+
+		if (ui32Pass < 2)
+		{
+			dStart = Now();
+			PVRSRVResManDisconnect(psContext, IMG_FALSE);
+			OSSNPrintf(szName, sizeof(szName), "resman teardown %lu", (unsigned long)ui32Size);
+			Report(szName, ui32Size, dStart);
+		}
+		else
+		{
+			ui32Chunks = 0;
+			dWorst = 0.0;
+			dStart = Now();
+			do
+			{
+				dChunk = Now();
+				bDone = PVRSRVResManFreeChunk(psContext, RESMAN_CHUNK);
+				dChunk = Now() - dChunk;
+				if (dChunk > dWorst)
+				{
+					dWorst = dChunk;
+				}
+				ui32Chunks++;
+
+				CHECK(bDone || gui32ResManFreed == ui32Chunks * RESMAN_CHUNK,
+					  "resman: chunk %lu freed %lu items in all",
+					  (unsigned long)ui32Chunks, (unsigned long)gui32ResManFreed);
+			} while (!bDone);
+			PVRSRVResManDisconnect(psContext, IMG_FALSE);
+			OSSNPrintf(szName, sizeof(szName), "resman chunked %lu", (unsigned long)ui32Size);
+			Report(szName, ui32Size, dStart);
+			printf("  %lu chunks of %u, longest %.1f us\n",
+				   (unsigned long)ui32Chunks, RESMAN_CHUNK, dWorst * 1e6);
+		}
+
+		CHECK(gui32ResManFreed == ui32Size, "resman: freed %lu of %lu items",
+			  (unsigned long)gui32ResManFreed, (unsigned long)ui32Size);
+	}
+}
+
+
+/*
+	queue.c and pvrsrv.c reach the system data and the display class state
+	directly. The rest of the system layer is only used on paths the
+	benchmark never takes.
+*/
+static SYS_DATA gsSysData;
+SYS_DATA *gpsSysData = &gsSysData;
+
+IMG_VOID IMG_CALLCONV PVRSRVSetDCState(IMG_UINT32 ui32State)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32State);
+}
+
+IMG_VOID IMG_CALLCONV PVRSRVReleasePrintf(const IMG_CHAR *pszFormat, ...)
+{
+	va_list argList;
+
+	va_start(argList, pszFormat);
+	vfprintf(stderr, pszFormat, argList);
+	va_end(argList);
+	fputc('\n', stderr);
+}
+
+IMG_VOID SysClearInterrupts(SYS_DATA *psSysData, IMG_UINT32 ui32ClearBits)
+{
+	PVR_UNREFERENCED_PARAMETER(psSysData);
+	PVR_UNREFERENCED_PARAMETER(ui32ClearBits);
+}
+
+IMG_UINT32 SysGetInterruptSource(SYS_DATA *psSysData, PVRSRV_DEVICE_NODE *psDeviceNode)
+{
+	PVR_UNREFERENCED_PARAMETER(psSysData);
+	PVR_UNREFERENCED_PARAMETER(psDeviceNode);
+
+	return 0;
+}
+
+IMG_SYS_PHYADDR SysCpuPAddrToSysPAddr(IMG_CPU_PHYADDR sCpuPAddr)
+{
+	IMG_SYS_PHYADDR sSysPAddr;
+
+	sSysPAddr.uiAddr = sCpuPAddr.uiAddr;
+
+	return sSysPAddr;
+}
+
+IMG_CPU_PHYADDR SysSysPAddrToCpuPAddr(IMG_SYS_PHYADDR sSysPAddr)
+{
+	IMG_CPU_PHYADDR sCpuPAddr;
+
+	sCpuPAddr.uiAddr = sSysPAddr.uiAddr;
+
+	return sCpuPAddr;
+}
+
+PVRSRV_ERROR SysFinalise(IMG_VOID)
+{
+	return PVRSRV_OK;
+}
+
+PVRSRV_ERROR PVRSRVSetDevicePowerStateKM(IMG_UINT32 ui32DeviceIndex,
+										 PVRSRV_DEV_POWER_STATE eNewPowerState,
+										 IMG_UINT32 ui32CallerID,
+										 IMG_BOOL bRetainMutex)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32DeviceIndex);
+	PVR_UNREFERENCED_PARAMETER(eNewPowerState);
+	PVR_UNREFERENCED_PARAMETER(ui32CallerID);
+	PVR_UNREFERENCED_PARAMETER(bRetainMutex);
+
+	return PVRSRV_OK;
+}
+
+#define QUEUE_SIZE			(64 * 1024)
+#define QUEUE_DATA_SIZE		32
+
+static IMG_UINT32 gui32QueueDone;
+
+/* A software command: checks it runs in order, then completes at once */
+static IMG_BOOL QueueCmdProc(IMG_HANDLE hCmdCookie, IMG_UINT32 ui32DataSize, IMG_VOID *pvData)
+{
+	IMG_UINT32 *pui32Data = pvData;
+
+	CHECK(ui32DataSize == QUEUE_DATA_SIZE && pui32Data[0] == gui32QueueDone,
+		  "queue: command %lu processed in place of %lu",
+		  (unsigned long)pui32Data[0], (unsigned long)gui32QueueDone);
+	gui32QueueDone++;
+
+	PVRSRVCommandCompleteKM(hCmdCookie, IMG_FALSE);
+
+	return IMG_TRUE;
+}
+
+/*
+	Fill the command queue with commands that each write one sync object
+	and read another, then process them one PVRSRVProcessQueues() call at
+	a time, as the MISR does. Each command depends on the one before it
+	through the syncs, so they must complete in insertion order.
+*/
+static IMG_VOID BenchQueue(IMG_UINT32 ui32Count)
+{
+	PFN_CMD_PROC apfnCmdProc[1] = { QueueCmdProc };
+	IMG_UINT32 aui32MaxSyncs[1][2] = { { 1, 1 } };
+	PVRSRV_SYNC_DATA sDstData, sSrcData;
+	PVRSRV_KERNEL_SYNC_INFO sDstSync, sSrcSync;
+	PVRSRV_KERNEL_SYNC_INFO *apsDstSync[1] = { &sDstSync };
+	PVRSRV_KERNEL_SYNC_INFO *apsSrcSync[1] = { &sSrcSync };
+	PVRSRV_QUEUE_INFO *psQueue;
+	PVRSRV_COMMAND *psCommand;
+	IMG_UINT32 ui32Batch, ui32Done, ui32Num, i;
+	double dStart, dInsert = 0.0, dProcess = 0.0;
+
+	memset(&sDstData, 0, sizeof(sDstData));
+	memset(&sSrcData, 0, sizeof(sSrcData));
+	memset(&sDstSync, 0, sizeof(sDstSync));
+	memset(&sSrcSync, 0, sizeof(sSrcSync));
+	sDstSync.psSyncData = &sDstData;
+	sSrcSync.psSyncData = &sSrcData;
+	gui32QueueDone = 0;
+
+	if (PVRSRVRegisterCmdProcListKM(0, apfnCmdProc, aui32MaxSyncs, 1) != PVRSRV_OK)
+	{
+		CHECK(IMG_FALSE, "queue: cannot register the command processor");
+		return;
+	}
+	if (PVRSRVCreateCommandQueueKM(QUEUE_SIZE, &psQueue) != PVRSRV_OK)
+	{
+		CHECK(IMG_FALSE, "queue: cannot create a queue");
+		PVRSRVRemoveCmdProcListKM(0, 1);
+		return;
+	}
+
+	/* As many commands as fit without waiting for queue space */
+	ui32Batch = QUEUE_SIZE / (sizeof(PVRSRV_COMMAND) + 2 * sizeof(PVRSRV_SYNC_OBJECT) + QUEUE_DATA_SIZE) - 1;
+
+	for (ui32Done = 0; ui32Done < ui32Count; ui32Done += ui32Num)
+	{
+		ui32Num = (ui32Count - ui32Done < ui32Batch) ? ui32Count - ui32Done : ui32Batch;
+
+		dStart = Now();
+		for (i = 0; i < ui32Num; i++)
+		{
+			if (PVRSRVInsertCommandKM(psQueue, &psCommand, 0, 0, 1, apsDstSync, 1, apsSrcSync,
+									  QUEUE_DATA_SIZE) != PVRSRV_OK)
+			{
+				CHECK(IMG_FALSE, "queue: insert %lu failed", (unsigned long)(ui32Done + i));
+				ui32Num = i;
+				break;
+			}
+			((IMG_UINT32 *)psCommand->pvData)[0] = ui32Done + i;
+			PVRSRVSubmitCommandKM(psQueue, psCommand);
+		}
+		dInsert += Now() - dStart;
+
+		dStart = Now();
+		for (i = 0; i < ui32Num; i++)
+		{
+			PVRSRVProcessQueues(KERNEL_ID, IMG_FALSE);
+		}
+		dProcess += Now() - dStart;
+
+		CHECK(gui32QueueDone == ui32Done + ui32Num, "queue: %lu of %lu commands processed",
+			  (unsigned long)gui32QueueDone, (unsigned long)(ui32Done + ui32Num));
+		if (ui32Num == 0 || gui32QueueDone != ui32Done + ui32Num)
+		{
+			break;
+		}
+	}
+
+	ReportSecs("queue insert", ui32Done, dInsert);
+	ReportSecs("queue process", ui32Done, dProcess);
+
+	CHECK(psQueue->ui32ReadOffset == psQueue->ui32WriteOffset, "queue: not empty after processing");
+	CHECK(sDstData.ui32WriteOpsComplete == ui32Done && sSrcData.ui32ReadOpsComplete == ui32Done,
+		  "queue: %lu writes and %lu reads completed for %lu commands",
+		  (unsigned long)sDstData.ui32WriteOpsComplete, (unsigned long)sSrcData.ui32ReadOpsComplete,
+		  (unsigned long)ui32Done);
+
+	CHECK(PVRSRVDestroyCommandQueueKM(psQueue) == PVRSRV_OK, "queue: cannot destroy the queue");
+	PVRSRVRemoveCmdProcListKM(0, 1);
+}
+
+
+#define BM_SHARED_HEAPS			6
+#define BM_CONTEXT_HEAPS		2
+/* One process context per this many operations, so the list grows with -n */
+#define BM_OPS_PER_CONTEXT		1000
+#define BM_HEAP_STATS_SIZE		2048
+
+static DEVICE_MEMORY_HEAP_INFO gasBMHeapInfo[BM_SHARED_HEAPS + BM_CONTEXT_HEAPS];
+static IMG_UINT32 gui32BMMMUContexts;
+static IMG_UINT32 gui32BMInsertedHeaps;
+static IMG_UINT8 gui8BMDummy;
+
+/* The MMU is not simulated: contexts and heaps are counted, not built */
+static PVRSRV_ERROR BMMMUInitialise(PVRSRV_DEVICE_NODE *psDeviceNode, MMU_CONTEXT **ppsMMUContext,
+									IMG_DEV_PHYADDR *psPDDevPAddr)
+{
+	PVR_UNREFERENCED_PARAMETER(psDeviceNode);
+	PVR_UNREFERENCED_PARAMETER(psPDDevPAddr);
+
+	*ppsMMUContext = (MMU_CONTEXT *)&gui8BMDummy;
+	gui32BMMMUContexts++;
+
+	return PVRSRV_OK;
+}
+
+static IMG_VOID BMMMUFinalise(MMU_CONTEXT *psMMUContext)
+{
+	PVR_UNREFERENCED_PARAMETER(psMMUContext);
+
+	gui32BMMMUContexts--;
+}
+
+static IMG_VOID BMMMUInsertHeap(MMU_CONTEXT *psMMUContext, MMU_HEAP *psMMUHeap)
+{
+	PVR_UNREFERENCED_PARAMETER(psMMUContext);
+	PVR_UNREFERENCED_PARAMETER(psMMUHeap);
+
+	gui32BMInsertedHeaps++;
+}
+
+static MMU_HEAP *BMMMUCreate(MMU_CONTEXT *psMMUContext, DEV_ARENA_DESCRIPTOR *psDevArena,
+							 RA_ARENA **ppsVMArena)
+{
+	PVR_UNREFERENCED_PARAMETER(psMMUContext);
+	PVR_UNREFERENCED_PARAMETER(psDevArena);
+
+	*ppsVMArena = IMG_NULL;
+
+	return (MMU_HEAP *)&gui8BMDummy;
+}
+
+static IMG_VOID BMMMUDelete(MMU_HEAP *psMMUHeap)
+{
+	PVR_UNREFERENCED_PARAMETER(psMMUHeap);
+}
+
+/* The context lookup in BM_CreateContext, as it was written before lists.h had typed loops */
+IMPLEMENT_LIST_ANY_VA(BM_CONTEXT)
+
+static IMG_VOID *BMFindContext_AnyVaCb(BM_CONTEXT *pBMContext, va_list va)
+{
+	PRESMAN_CONTEXT hResManContext = va_arg(va, PRESMAN_CONTEXT);
+
+	if (ResManFindResourceByPtr(hResManContext, pBMContext->hResItem) == PVRSRV_OK)
+	{
+		return pBMContext;
+	}
+
+	return IMG_NULL;
+}
+
+/* The same lookup as it is written now */
+static BM_CONTEXT *BMFindContext(BM_CONTEXT *psHead, PRESMAN_CONTEXT hResManContext)
+{
+	BM_CONTEXT *pBMContext;
+
+	LIST_FOR_EACH(pBMContext, psHead)
+	{
+		if (ResManFindResourceByPtr(hResManContext, pBMContext->hResItem) == PVRSRV_OK)
+		{
+			return pBMContext;
+		}
+	}
+
+	return IMG_NULL;
+}
+
+/* As PVRSRVCreateDeviceMemContextKM: the context, then its own heaps */
+static IMG_HANDLE BMCreateProcessContext(PVRSRV_DEVICE_NODE *psDeviceNode,
+										 PVRSRV_PER_PROCESS_DATA *psPerProc,
+										 IMG_BOOL *pbCreated)
+{
+	IMG_DEV_PHYADDR sPDDevPAddr;
+	IMG_HANDLE hContext;
+	IMG_UINT32 i;
+
+	hContext = BM_CreateContext(psDeviceNode, &sPDDevPAddr, psPerProc, pbCreated);
+	if (hContext != IMG_NULL && *pbCreated)
+	{
+		for (i = BM_SHARED_HEAPS; i < BM_SHARED_HEAPS + BM_CONTEXT_HEAPS; i++)
+		{
+			CHECK(BM_CreateHeap(hContext, &gasBMHeapInfo[i]) != IMG_NULL,
+				  "bm: cannot create context heap %lu", (unsigned long)i);
+		}
+	}
+
+	return hContext;
+}
+
+/*
+	A device with a kernel context of BM_SHARED_HEAPS shared heaps and one
+	context per process, each with BM_CONTEXT_HEAPS heaps of its own.
+	Time the lookup BM_CreateContext does when a process asks for its
+	context again, walked with the old va_list callback and with the typed
+	loop; then creating and destroying a context for a new process, which
+	inserts every shared heap; then PVRSRVGetMiscInfoKM memory stats,
+	which walk every heap of every context.
+*/
+static IMG_VOID BenchBufferManager(IMG_UINT32 ui32Count)
+{
+	PVRSRV_DEVICE_NODE sDeviceNode;
+	PVRSRV_PER_PROCESS_DATA *psPerProc, sNewProc;
+	PVRSRV_MISC_INFO sMiscInfo;
+	IMG_DEV_PHYADDR sPDDevPAddr;
+	IMG_HANDLE hKernelContext, hContext, *phContexts;
+	IMG_UINT32 *pui32Order;
+	IMG_UINT32 ui32Procs, ui32Creates, ui32Calls, ui32StrLen, i;
+	IMG_CHAR *pszStr;
+	IMG_BOOL bCreated, bDestroyed;
+	IMG_CHAR szName[32];
+	double dStart;
+
+	ui32Procs = ui32Count / BM_OPS_PER_CONTEXT + 2;
+	ui32Creates = ui32Count / 10 + 1;
+	ui32Calls = ui32Count / 100 + 1;
+
+	OSMemSet(&sDeviceNode, 0, sizeof(sDeviceNode));
+	sDeviceNode.sDevId.eDeviceType = PVRSRV_DEVICE_TYPE_SGX;
+	sDeviceNode.pfnMMUInitialise = BMMMUInitialise;
+	sDeviceNode.pfnMMUFinalise = BMMMUFinalise;
+	sDeviceNode.pfnMMUInsertHeap = BMMMUInsertHeap;
+	sDeviceNode.pfnMMUCreate = BMMMUCreate;
+	sDeviceNode.pfnMMUDelete = BMMMUDelete;
+	sPDDevPAddr.uiAddr = 0;
+
+	for (i = 0; i < BM_SHARED_HEAPS + BM_CONTEXT_HEAPS; i++)
+	{
+		gasBMHeapInfo[i].ui32HeapID = i;
+		gasBMHeapInfo[i].pszName = (IMG_CHAR *)"Bench Heap";
+		gasBMHeapInfo[i].pszBSName = (IMG_CHAR *)"Bench Heap BS";
+		gasBMHeapInfo[i].sDevVAddrBase.uiAddr = i << 28;
+		gasBMHeapInfo[i].ui32HeapSize = 1 << 28;
+		gasBMHeapInfo[i].ui32Attribs = PVRSRV_BACKINGSTORE_SYSMEM_NONCONTIG;
+		gasBMHeapInfo[i].DevMemHeapType = (i < BM_SHARED_HEAPS) ?
+			DEVICE_MEMORY_HEAP_SHARED : DEVICE_MEMORY_HEAP_PERCONTEXT;
+		gasBMHeapInfo[i].ui32DataPageSize = 4096;
+	}
+
+	psPerProc = calloc(ui32Procs, sizeof(*psPerProc));
+	phContexts = calloc(ui32Procs, sizeof(*phContexts));
+	pui32Order = malloc(ui32Count * sizeof(*pui32Order));
+	ui32StrLen = (ui32Procs * BM_CONTEXT_HEAPS + BM_SHARED_HEAPS) * BM_HEAP_STATS_SIZE;
+	pszStr = malloc(ui32StrLen);
+	if (!psPerProc || !phContexts || !pui32Order || !pszStr ||
+		PVRSRVResManConnect(IMG_NULL, &sDeviceNode.hResManContext) != PVRSRV_OK)
+	{
+		CHECK(IMG_FALSE, "bm: out of memory");
+		goto Exit;
+	}
+	gsSysData.psDeviceNodeList = &sDeviceNode;
+
+	hKernelContext = BM_CreateContext(&sDeviceNode, &sPDDevPAddr, IMG_NULL, IMG_NULL);
+	if (hKernelContext == IMG_NULL)
+	{
+		CHECK(IMG_FALSE, "bm: cannot create the kernel context");
+		goto Disconnect;
+	}
+	for (i = 0; i < BM_SHARED_HEAPS; i++)
+	{
+		CHECK(BM_CreateHeap(hKernelContext, &gasBMHeapInfo[i]) != IMG_NULL,
+			  "bm: cannot create shared heap %lu", (unsigned long)i);
+	}
+
+	for (i = 0; i < ui32Procs; i++)
+	{
+		psPerProc[i].ui32PID = i + 1;
+		CHECK(PVRSRVResManConnect(&psPerProc[i], &psPerProc[i].hResManContext) == PVRSRV_OK,
+			  "bm: cannot connect process %lu", (unsigned long)i);
+		phContexts[i] = BMCreateProcessContext(&sDeviceNode, &psPerProc[i], &bCreated);
+		CHECK(phContexts[i] != IMG_NULL && bCreated,
+			  "bm: cannot create the context of process %lu", (unsigned long)i);
+	}
+
+	for (i = 0; i < ui32Count; i++)
+	{
+		pui32Order[i] = Random() % ui32Procs;
+	}
+
+	dStart = Now();
+	for (i = 0; i < ui32Count; i++)
+	{
+		hContext = BM_CreateContext(&sDeviceNode, &sPDDevPAddr, &psPerProc[pui32Order[i]], &bCreated);
+		CHECK(hContext == phContexts[pui32Order[i]] && !bCreated,
+			  "bm: process %lu got a new context", (unsigned long)pui32Order[i]);
+		BM_DestroyContext(hContext, &bDestroyed);
+		CHECK(!bDestroyed, "bm: process %lu lost its context", (unsigned long)pui32Order[i]);
+	}
+	OSSNPrintf(szName, sizeof(szName), "bm context reuse %lu", (unsigned long)ui32Procs);
+	Report(szName, ui32Count, dStart);
+
+	dStart = Now();
+	for (i = 0; i < ui32Count; i++)
+	{
+		hContext = List_BM_CONTEXT_Any_va(sDeviceNode.sDevMemoryInfo.pBMContext,
+										  BMFindContext_AnyVaCb,
+										  psPerProc[pui32Order[i]].hResManContext);
+		CHECK(hContext == phContexts[pui32Order[i]],
+			  "bm: va walk missed process %lu", (unsigned long)pui32Order[i]);
+	}
+	Report("bm lookup va_list walk", ui32Count, dStart);
+
+	dStart = Now();
+	for (i = 0; i < ui32Count; i++)
+	{
+		hContext = BMFindContext(sDeviceNode.sDevMemoryInfo.pBMContext,
+								 psPerProc[pui32Order[i]].hResManContext);
+		CHECK(hContext == phContexts[pui32Order[i]],
+			  "bm: typed walk missed process %lu", (unsigned long)pui32Order[i]);
+	}
+	Report("bm lookup typed loop", ui32Count, dStart);
+
+	OSMemSet(&sNewProc, 0, sizeof(sNewProc));
+	sNewProc.ui32PID = ui32Procs + 1;
+	gui32BMInsertedHeaps = 0;
+	dStart = Now();
+	for (i = 0; i < ui32Creates; i++)
+	{
+		if (PVRSRVResManConnect(&sNewProc, &sNewProc.hResManContext) != PVRSRV_OK)
+		{
+			CHECK(IMG_FALSE, "bm: cannot connect a new process");
+			break;
+		}
+		hContext = BMCreateProcessContext(&sDeviceNode, &sNewProc, &bCreated);
+		CHECK(hContext != IMG_NULL && bCreated, "bm: cannot create a new context");
+		if (hContext != IMG_NULL)
+		{
+			BM_DestroyContext(hContext, &bDestroyed);
+			CHECK(bDestroyed, "bm: new context not destroyed");
+		}
+		PVRSRVResManDisconnect(sNewProc.hResManContext, IMG_FALSE);
+	}
+	Report("bm context create/destroy", ui32Creates, dStart);
+	CHECK(gui32BMInsertedHeaps == ui32Creates * BM_SHARED_HEAPS,
+		  "bm: %lu shared heaps inserted for %lu contexts",
+		  (unsigned long)gui32BMInsertedHeaps, (unsigned long)ui32Creates);
+
+	dStart = Now();
+	for (i = 0; i < ui32Calls; i++)
+	{
+		OSMemSet(&sMiscInfo, 0, sizeof(sMiscInfo));
+		sMiscInfo.ui32StateRequest = PVRSRV_MISC_INFO_MEMSTATS_PRESENT;
+		sMiscInfo.pszMemoryStr = pszStr;
+		sMiscInfo.ui32MemoryStrLen = ui32StrLen;
+		CHECK(PVRSRVGetMiscInfoKM(&sMiscInfo) == PVRSRV_OK &&
+			  (sMiscInfo.ui32StatePresent & PVRSRV_MISC_INFO_MEMSTATS_PRESENT),
+			  "bm: no memory stats from PVRSRVGetMiscInfoKM");
+	}
+	OSSNPrintf(szName, sizeof(szName), "misc info memstats %lu", (unsigned long)ui32Procs);
+	Report(szName, ui32Calls, dStart);
+	CHECK(strstr(pszStr, "Kernel Context:") != IMG_NULL, "bm: memory stats miss the kernel context");
+
+	for (i = 0; i < ui32Procs; i++)
+	{
+		if (phContexts[i] != IMG_NULL)
+		{
+			BM_DestroyContext(phContexts[i], &bDestroyed);
+			CHECK(bDestroyed, "bm: context of process %lu not destroyed", (unsigned long)i);
+		}
+		PVRSRVResManDisconnect(psPerProc[i].hResManContext, IMG_FALSE);
+	}
+	BM_DestroyContext(hKernelContext, &bDestroyed);
+	CHECK(bDestroyed, "bm: kernel context not destroyed");
+	CHECK(gui32BMMMUContexts == 0, "bm: %lu MMU contexts left", (unsigned long)gui32BMMMUContexts);
+
+Disconnect:
+	gsSysData.psDeviceNodeList = IMG_NULL;
+	PVRSRVResManDisconnect(sDeviceNode.hResManContext, IMG_FALSE);
+Exit:
+	free(pszStr);
+	free(pui32Order);
+	free(phContexts);
+	free(psPerProc);
+}
+
+#define BRIDGE_PROCS			64
+#define BRIDGE_PID_BASE			1000
+
+/* Bridge entry before the file private data cache: a kernel handle lookup */
+static PVRSRV_PER_PROCESS_DATA *BridgePerProcByHandle(IMG_HANDLE hKernelServices, IMG_UINT32 ui32PID)
+{
+	PVRSRV_PER_PROCESS_DATA *psPerProc;
+
+	if (PVRSRVLookupHandle(KERNEL_HANDLE_BASE, (IMG_PVOID *)&psPerProc, hKernelServices,
+						   PVRSRV_HANDLE_TYPE_PERPROC_DATA) != PVRSRV_OK ||
+		psPerProc->ui32PID != ui32PID)
+	{
+		return IMG_NULL;
+	}
+
+	return psPerProc;
+}
+
+/* Bridge entry now: the data cached at open, checked against the handle */
+static PVRSRV_PER_PROCESS_DATA *BridgePerProcCached(PVRSRV_PER_PROCESS_DATA *psPerProc,
+													IMG_HANDLE hKernelServices, IMG_UINT32 ui32PID)
+{
+	if (psPerProc == IMG_NULL || psPerProc->hPerProcData != hKernelServices)
+	{
+		return BridgePerProcByHandle(hKernelServices, ui32PID);
+	}
+
+	return (psPerProc->ui32PID == ui32PID) ? psPerProc : IMG_NULL;
+}
+
+/*
+	BRIDGE_PROCS processes connect, as many clients of a compositor do, and
+	each one's per-process data is cached as PVRSRVOpen caches it. Time how
+	PVRSRV_BridgeDispatchKM finds the caller's data for a random run of
+	calls: the PID hash used by CONNECT_SERVICES, the kernel handle lookup
+	used by every other call, and the cached pointer that replaces both.
+	The lookups stand in for the dispatch prologue; the bridge itself
+	needs the Linux file layer.
+*/
+static IMG_VOID BenchBridgeEntry(IMG_UINT32 ui32Count)
+{
+	PVRSRV_PER_PROCESS_DATA *apsPerProc[BRIDGE_PROCS], *psPerProc;
+	IMG_UINT32 *pui32Order;
+	IMG_UINT32 ui32PID, i;
+	double dStart;
+
+	pui32Order = malloc(ui32Count * sizeof(*pui32Order));
+	if (pui32Order == IMG_NULL)
+	{
+		CHECK(IMG_FALSE, "bridge: out of memory");
+		return;
+	}
+
+	for (i = 0; i < BRIDGE_PROCS; i++)
+	{
+		CHECK(PVRSRVPerProcessDataConnect(BRIDGE_PID_BASE + i) == PVRSRV_OK,
+			  "bridge: cannot connect process %lu", (unsigned long)i);
+		apsPerProc[i] = PVRSRVPerProcessData(BRIDGE_PID_BASE + i);
+		if (apsPerProc[i] == IMG_NULL)
+		{
+			CHECK(IMG_FALSE, "bridge: no data for process %lu", (unsigned long)i);
+			goto Disconnect;
+		}
+	}
+
+	for (i = 0; i < ui32Count; i++)
+	{
+		pui32Order[i] = Random() % BRIDGE_PROCS;
+	}
+
+	dStart = Now();
+	for (i = 0; i < ui32Count; i++)
+	{
+		ui32PID = BRIDGE_PID_BASE + pui32Order[i];
+		psPerProc = PVRSRVPerProcessData(ui32PID);
+		CHECK(psPerProc == apsPerProc[pui32Order[i]], "bridge: hash missed PID %lu", (unsigned long)ui32PID);
+	}
+	Report("bridge entry PID hash", ui32Count, dStart);
+
+	dStart = Now();
+	for (i = 0; i < ui32Count; i++)
+	{
+		ui32PID = BRIDGE_PID_BASE + pui32Order[i];
+		psPerProc = BridgePerProcByHandle(apsPerProc[pui32Order[i]]->hPerProcData, ui32PID);
+		CHECK(psPerProc == apsPerProc[pui32Order[i]], "bridge: handle missed PID %lu", (unsigned long)ui32PID);
+	}
+	Report("bridge entry handle lookup", ui32Count, dStart);
+
+	dStart = Now();
+	for (i = 0; i < ui32Count; i++)
+	{
+		ui32PID = BRIDGE_PID_BASE + pui32Order[i];
+		psPerProc = BridgePerProcCached(apsPerProc[pui32Order[i]],
+										apsPerProc[pui32Order[i]]->hPerProcData, ui32PID);
+		CHECK(psPerProc == apsPerProc[pui32Order[i]], "bridge: cache missed PID %lu", (unsigned long)ui32PID);
+	}
+	Report("bridge entry cached", ui32Count, dStart);
+
+	/* A connection inherited across fork() carries the parent's data */
+	psPerProc = BridgePerProcCached(apsPerProc[0], apsPerProc[1]->hPerProcData, BRIDGE_PID_BASE + 1);
+	CHECK(psPerProc == apsPerProc[1], "bridge: inherited connection not resolved by handle");
+	psPerProc = BridgePerProcCached(apsPerProc[0], apsPerProc[0]->hPerProcData, BRIDGE_PID_BASE + 1);
+	CHECK(psPerProc == IMG_NULL, "bridge: PID check passed for the wrong process");
+
+Disconnect:
+	for (i = 0; i < BRIDGE_PROCS; i++)
+	{
+		PVRSRVPerProcessDataDisconnect(BRIDGE_PID_BASE + i);
+		CHECK(PVRSRVPerProcessData(BRIDGE_PID_BASE + i) == IMG_NULL,
+			  "bridge: process %lu still connected", (unsigned long)i);
+	}
+	free(pui32Order);
+}
+
+int main(int argc, char **argv)
+{
+	IMG_UINT32 ui32Count = 100000;
+	IMG_UINT32 ui32Rounds = 1;
+	IMG_UINT32 i;
+	int iOpt;
+
+	while ((iOpt = getopt(argc, argv, "n:s:r:")) != -1)
+	{
+		switch (iOpt)
+		{
+			case 'n':
+				ui32Count = strtoul(optarg, IMG_NULL, 0);
+				break;
+			case 's':
+				gui32Seed = strtoul(optarg, IMG_NULL, 0);
+				break;
+			case 'r':
+				ui32Rounds = strtoul(optarg, IMG_NULL, 0);
+				break;
+			default:
+				fprintf(stderr, "Usage: %s [-n count] [-s seed] [-r rounds]\n", argv[0]);
+				return 1;
+		}
+	}
+
+	if (ui32Count < 2 || gui32Seed == 0)
+	{
+		fprintf(stderr, "count must be at least 2 and seed non-zero\n");
+		return 1;
+	}
+
+	if (PVRSRVHandleInit() != PVRSRV_OK)
+	{
+		fprintf(stderr, "PVRSRVHandleInit failed\n");
+		return 1;
+	}
+
+	if (ResManInit() != PVRSRV_OK)
+	{
+		fprintf(stderr, "ResManInit failed\n");
+		return 1;
+	}
+
+	if (PVRSRVPerProcessDataInit() != PVRSRV_OK)
+	{
+		fprintf(stderr, "PVRSRVPerProcessDataInit failed\n");
+		return 1;
+	}
+
+	for (i = 0; i < ui32Rounds; i++)
+	{
+		printf("round %lu, seed 0x%lx\n", (unsigned long)i, (unsigned long)gui32Seed);
+		BenchHash(ui32Count);
+		BenchRA(ui32Count);
+		BenchHandles(ui32Count);
+		BenchResMan(ui32Count);
+		BenchQueue(ui32Count);
+		BenchBufferManager(ui32Count);
+		BenchBridgeEntry(ui32Count);
+	}
+
+	PVRSRVPerProcessDataDeInit();
+	ResManDeInit();
+	PVRSRVHandleDeInit();
+
+	if (gui32Errors)
+	{
+		fprintf(stderr, "%lu errors\n", (unsigned long)gui32Errors);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1 @@
+/* Userspace stand-in for <linux/hardirq.h>; nothing is needed from it. */
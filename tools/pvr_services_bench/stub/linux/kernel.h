@@ -0,0 +1 @@
+/* Userspace stand-in for <linux/kernel.h>; nothing is needed from it. */
@@ -0,0 +1,13 @@
+/*
+ * Userspace stand-in for <linux/sched.h>, for resman.c. The benchmark is
+ * single threaded, so the resource list mutex does nothing.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#define DEFINE_MUTEX(m)		int m
+#define mutex_lock(m)		((void)(m))
+#define mutex_unlock(m)		((void)(m))
+#define in_interrupt()		0
+#define printk				printf
+#define BUG()				abort()
@@ -0,0 +1,2 @@
+/* Userspace stand-in for <linux/slab.h>; pvrsrv.c includes it but allocates
+   through OSAllocMem. */
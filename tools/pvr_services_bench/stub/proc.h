@@ -0,0 +1,2 @@
+/* Userspace stand-in for the Linux /proc helpers; ra.c only uses them
+   with CONFIG_PROC_FS, which is never set here. */